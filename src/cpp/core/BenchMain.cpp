@@ -0,0 +1,358 @@
+/*
+ * BenchMain.cpp
+ *
+ * Copyright (C) 2022 by RStudio, PBC
+ *
+ * Unless you have received this program directly from RStudio pursuant
+ * to the terms of a commercial license agreement with RStudio, then
+ * this program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ *
+ */
+
+// micro-benchmark driver for core hot paths (rstudio-benchmarks target).
+// each benchmark runs a fixed amount of work per iteration; we time a
+// handful of repetitions after a warmup pass and report the median so the
+// numbers are stable enough to trend across versions. results are written
+// to stdout as a single JSON document.
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
+
+#include <shared_core/Error.hpp>
+#include <shared_core/FilePath.hpp>
+#include <shared_core/SafeConvert.hpp>
+#include <shared_core/json/Json.hpp>
+
+#include <core/Base64.hpp>
+#include <core/FileSerializer.hpp>
+#include <core/StringUtils.hpp>
+#include <core/http/Request.hpp>
+#include <core/http/RequestParser.hpp>
+#include <core/r_util/RTokenizer.hpp>
+#include <core/system/FileScanner.hpp>
+#include <core/system/System.hpp>
+
+using namespace rstudio;
+using namespace rstudio::core;
+
+namespace {
+
+// number of timed repetitions per benchmark (median is reported)
+const int kRepetitions = 9;
+
+double timeOnce(const boost::function<void()>& work)
+{
+   using namespace std::chrono;
+   steady_clock::time_point start = steady_clock::now();
+   work();
+   steady_clock::time_point end = steady_clock::now();
+   return duration_cast<duration<double, std::micro>>(end - start).count();
+}
+
+void runBenchmark(const std::string& name,
+                  int iterations,
+                  const boost::function<void()>& work,
+                  json::Array* pResults)
+{
+   // warmup pass (touch caches, fault in pages)
+   work();
+
+   // timed repetitions
+   std::vector<double> timings;
+   for (int i = 0; i < kRepetitions; i++)
+      timings.push_back(timeOnce(work));
+   std::sort(timings.begin(), timings.end());
+
+   double median = timings[timings.size() / 2];
+   double min = timings.front();
+   double max = timings.back();
+
+   json::Object resultJson;
+   resultJson["name"] = name;
+   resultJson["iterations"] = iterations;
+   resultJson["repetitions"] = kRepetitions;
+   resultJson["median_us"] = median;
+   resultJson["min_us"] = min;
+   resultJson["max_us"] = max;
+   resultJson["median_us_per_iteration"] = median / iterations;
+   pResults->push_back(resultJson);
+
+   // progress on stderr so stdout stays pure JSON
+   std::cerr << name << ": " << median << " us (median of "
+             << kRepetitions << ")" << std::endl;
+}
+
+std::string buildJsonPayload()
+{
+   // representative document: an array of objects similar in shape to
+   // the source index / client event payloads we serialize in practice
+   json::Array entriesJson;
+   for (int i = 0; i < 500; i++)
+   {
+      json::Object entryJson;
+      entryJson["id"] = i;
+      entryJson["name"] = "entry-" + safe_convert::numberToString(i);
+      entryJson["path"] = "/home/user/projects/example/R/module-" +
+                          safe_convert::numberToString(i) + ".R";
+      entryJson["active"] = (i % 2) == 0;
+      json::Array tagsJson;
+      tagsJson.push_back("one");
+      tagsJson.push_back("two");
+      tagsJson.push_back("three");
+      entryJson["tags"] = tagsJson;
+      entriesJson.push_back(entryJson);
+   }
+   json::Object docJson;
+   docJson["version"] = 1;
+   docJson["entries"] = entriesJson;
+   return docJson.write();
+}
+
+void benchJsonParse(const std::string& payload)
+{
+   for (int i = 0; i < 100; i++)
+   {
+      json::Value value;
+      Error error = value.parse(payload);
+      if (error)
+         LOG_ERROR(error);
+   }
+}
+
+void benchJsonSerialize(const json::Value& value)
+{
+   std::size_t total = 0;
+   for (int i = 0; i < 100; i++)
+      total += value.write().size();
+   if (total == 0)
+      std::cerr << "unexpected empty serialization" << std::endl;
+}
+
+std::string buildHttpRequest()
+{
+   std::string body = "{\"method\":\"list_files\",\"params\":[\"~/projects\"]}";
+   std::ostringstream ostr;
+   ostr << "POST /rpc/list_files HTTP/1.1\r\n"
+        << "Host: localhost:8787\r\n"
+        << "User-Agent: benchmark/1.0\r\n"
+        << "Accept: application/json\r\n"
+        << "Content-Type: application/json\r\n"
+        << "Content-Length: " << body.size() << "\r\n"
+        << "\r\n"
+        << body;
+   return ostr.str();
+}
+
+void benchRequestParser(const std::string& requestStr)
+{
+   for (int i = 0; i < 1000; i++)
+   {
+      http::Request request;
+      http::RequestParser parser;
+      http::RequestParser::status status = parser.parse(
+               request,
+               requestStr.c_str(),
+               requestStr.c_str() + requestStr.size());
+      if (status == http::RequestParser::headers_parsed)
+      {
+         status = parser.parse(request,
+                               requestStr.c_str(),
+                               requestStr.c_str() + requestStr.size());
+      }
+      if (status != http::RequestParser::complete)
+         std::cerr << "unexpected parser status: " << status << std::endl;
+   }
+}
+
+void benchFilePathOperations(const FilePath& rootPath)
+{
+   for (int i = 0; i < 1000; i++)
+   {
+      FilePath childPath = rootPath.completeChildPath(
+               "dir-" + safe_convert::numberToString(i % 20));
+      FilePath filePath = childPath.completePath("file.R");
+      std::size_t length = filePath.getAbsolutePath().size() +
+                           filePath.getExtensionLowerCase().size() +
+                           filePath.getStem().size();
+      if (length == 0 || !filePath.isWithin(rootPath))
+         std::cerr << "unexpected path result" << std::endl;
+   }
+}
+
+Error populateScanTree(const FilePath& rootPath)
+{
+   for (int dir = 0; dir < 20; dir++)
+   {
+      FilePath dirPath = rootPath.completeChildPath(
+               "dir-" + safe_convert::numberToString(dir));
+      Error error = dirPath.ensureDirectory();
+      if (error)
+         return error;
+
+      for (int file = 0; file < 25; file++)
+      {
+         FilePath filePath = dirPath.completePath(
+                  "file-" + safe_convert::numberToString(file) + ".R");
+         error = core::writeStringToFile(filePath, "# benchmark fixture\n");
+         if (error)
+            return error;
+      }
+   }
+   return Success();
+}
+
+void benchScanFiles(const FilePath& rootPath)
+{
+   tree<FileInfo> scannedFiles;
+   core::system::FileScannerOptions options;
+   options.recursive = true;
+   Error error = core::system::scanFiles(FileInfo(rootPath),
+                                         options,
+                                         &scannedFiles);
+   if (error)
+      LOG_ERROR(error);
+}
+
+std::wstring buildRSource()
+{
+   std::string code;
+   for (int i = 0; i < 200; i++)
+   {
+      code += "compute <- function(x, y = 10) {\n"
+              "   total <- x + y * 2\n"
+              "   if (total > 100) {\n"
+              "      message(\"large total: \", total)\n"
+              "   }\n"
+              "   lapply(seq_len(total), function(i) i ^ 2)\n"
+              "}\n";
+   }
+   return string_utils::utf8ToWide(code);
+}
+
+void benchRTokenizer(const std::wstring& rCode)
+{
+   std::size_t count = 0;
+   for (int i = 0; i < 10; i++)
+   {
+      r_util::RTokenizer tokenizer(rCode);
+      r_util::RToken token = tokenizer.nextToken();
+      while (token)
+      {
+         count++;
+         token = tokenizer.nextToken();
+      }
+   }
+   if (count == 0)
+      std::cerr << "unexpected empty token stream" << std::endl;
+}
+
+void benchBase64(const std::string& data)
+{
+   for (int i = 0; i < 10; i++)
+   {
+      std::string encoded, decoded;
+      Error error = base64::encode(data, &encoded);
+      if (!error)
+         error = base64::decode(encoded, &decoded);
+      if (error)
+         LOG_ERROR(error);
+   }
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv)
+{
+   Error error = core::system::initializeStderrLog("rstudio-benchmarks",
+                                                   core::log::LogLevel::WARN);
+   if (error)
+   {
+      std::cerr << error.getSummary() << std::endl;
+      return EXIT_FAILURE;
+   }
+
+   json::Array resultsJson;
+
+   // json parse / serialize
+   std::string jsonPayload = buildJsonPayload();
+   runBenchmark("json_parse",
+                100,
+                boost::bind(benchJsonParse, jsonPayload),
+                &resultsJson);
+
+   json::Value parsedValue;
+   error = parsedValue.parse(jsonPayload);
+   if (error)
+      LOG_ERROR(error);
+   runBenchmark("json_serialize",
+                100,
+                boost::bind(benchJsonSerialize, parsedValue),
+                &resultsJson);
+
+   // http request parsing
+   std::string requestStr = buildHttpRequest();
+   runBenchmark("http_request_parser",
+                1000,
+                boost::bind(benchRequestParser, requestStr),
+                &resultsJson);
+
+   // file path operations and directory scanning (against a scratch tree)
+   FilePath scratchPath;
+   error = FilePath::tempFilePath(scratchPath);
+   if (error)
+      LOG_ERROR(error);
+   error = scratchPath.ensureDirectory();
+   if (error)
+      LOG_ERROR(error);
+   error = populateScanTree(scratchPath);
+   if (error)
+      LOG_ERROR(error);
+
+   runBenchmark("filepath_operations",
+                1000,
+                boost::bind(benchFilePathOperations, scratchPath),
+                &resultsJson);
+
+   runBenchmark("scan_files",
+                1,
+                boost::bind(benchScanFiles, scratchPath),
+                &resultsJson);
+
+   error = scratchPath.removeIfExists();
+   if (error)
+      LOG_ERROR(error);
+
+   // R tokenizer
+   std::wstring rCode = buildRSource();
+   runBenchmark("r_tokenizer",
+                10,
+                boost::bind(benchRTokenizer, rCode),
+                &resultsJson);
+
+   // base64 encode + decode of a 1MB buffer
+   std::string binaryData(1024 * 1024, '\x7f');
+   for (std::size_t i = 0; i < binaryData.size(); i++)
+      binaryData[i] = static_cast<char>(i % 256);
+   runBenchmark("base64_roundtrip",
+                10,
+                boost::bind(benchBase64, binaryData),
+                &resultsJson);
+
+   // emit results as a single JSON document on stdout
+   json::Object reportJson;
+   reportJson["benchmarks"] = resultsJson;
+   std::cout << reportJson.writeFormatted() << std::endl;
+
+   return EXIT_SUCCESS;
+}
@@ -0,0 +1,157 @@
+/*
+ * Compression.cpp
+ *
+ * Copyright (C) 2020 by RStudio, PBC
+ *
+ * Unless you have received this program directly from RStudio pursuant
+ * to the terms of a commercial license agreement with RStudio, then
+ * this program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ *
+ */
+
+#include <core/Compression.hpp>
+
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+#include <boost/thread.hpp>
+
+#include "zlib.h"
+
+namespace rstudio {
+namespace core {
+namespace compression {
+
+namespace {
+
+// blocks large enough to compress well, small enough to bound the
+// memory held by a wave of concurrent compressions
+const std::size_t kBlockSize = 4 * 1024 * 1024;
+
+// compress a block of input as a complete gzip member
+Error gzipCompressBlock(const std::vector<char>& input,
+                        std::vector<char>* pOutput)
+{
+   z_stream stream;
+   std::memset(&stream, 0, sizeof(stream));
+
+   // windowBits > 15 requests a gzip (rather than zlib) wrapper
+   int result = ::deflateInit2(&stream,
+                               Z_DEFAULT_COMPRESSION,
+                               Z_DEFLATED,
+                               15 + 16,
+                               8,
+                               Z_DEFAULT_STRATEGY);
+   if (result != Z_OK)
+   {
+      Error error = systemError(boost::system::errc::not_enough_memory,
+                                ERROR_LOCATION);
+      error.addProperty("zlib-result", result);
+      return error;
+   }
+
+   pOutput->resize(::deflateBound(&stream, input.size()));
+
+   stream.next_in = (Bytef*)input.data();
+   stream.avail_in = (uInt)input.size();
+   stream.next_out = (Bytef*)pOutput->data();
+   stream.avail_out = (uInt)pOutput->size();
+
+   result = ::deflate(&stream, Z_FINISH);
+   if (result == Z_STREAM_END)
+      pOutput->resize(stream.total_out);
+   ::deflateEnd(&stream);
+
+   if (result != Z_STREAM_END)
+   {
+      Error error = systemError(boost::system::errc::io_error,
+                                ERROR_LOCATION);
+      error.addProperty("zlib-result", result);
+      return error;
+   }
+
+   return Success();
+}
+
+} // anonymous namespace
+
+Error gzipCompressFile(const FilePath& sourceFilePath,
+                       const FilePath& destinationFilePath,
+                       int threads)
+{
+   if (threads < 1)
+      threads = 1;
+
+   std::shared_ptr<std::istream> pInput;
+   Error error = sourceFilePath.openForRead(pInput);
+   if (error)
+      return error;
+
+   std::shared_ptr<std::ostream> pOutput;
+   error = destinationFilePath.openForWrite(pOutput);
+   if (error)
+      return error;
+
+   // process the input in waves of up to `threads` blocks: read the
+   // blocks, compress them concurrently (each as an independent gzip
+   // member), then write the results in order
+   while (*pInput)
+   {
+      std::vector<std::vector<char> > inputs;
+      for (int i = 0; i < threads && *pInput; i++)
+      {
+         std::vector<char> block(kBlockSize);
+         pInput->read(block.data(), block.size());
+         block.resize(pInput->gcount());
+         if (!block.empty())
+            inputs.push_back(std::move(block));
+      }
+      if (inputs.empty())
+         break;
+
+      std::vector<std::vector<char> > outputs(inputs.size());
+      std::vector<Error> errors(inputs.size());
+
+      // compress the first block on this thread and the rest on workers
+      boost::thread_group workers;
+      for (std::size_t i = 1; i < inputs.size(); i++)
+      {
+         workers.create_thread([&, i]()
+         {
+            errors[i] = gzipCompressBlock(inputs[i], &outputs[i]);
+         });
+      }
+      errors[0] = gzipCompressBlock(inputs[0], &outputs[0]);
+      workers.join_all();
+
+      for (std::size_t i = 0; i < inputs.size(); i++)
+      {
+         if (errors[i])
+            return errors[i];
+
+         pOutput->write(outputs[i].data(), outputs[i].size());
+         if (!*pOutput)
+            return systemError(boost::system::errc::io_error, ERROR_LOCATION);
+      }
+   }
+
+   // reading may stop on either eof or a hard error
+   if (pInput->bad())
+      return systemError(boost::system::errc::io_error, ERROR_LOCATION);
+
+   pOutput->flush();
+   if (!*pOutput)
+      return systemError(boost::system::errc::io_error, ERROR_LOCATION);
+
+   return Success();
+}
+
+} // namespace compression
+} // namespace core
+} // namespace rstudio
@@ -174,14 +174,14 @@ private:
 
 Query::Query(const std::string& sqlStatement,
              soci::session& session) :
-   statement_(session)
+   statement_(new soci::statement(session))
 {
    // it's possible that prepare can throw a database exception, but we
    // do not want to surface errors until execute() is called
    try
    {
-      statement_.alloc();
-      statement_.prepare(sqlStatement);
+      statement_->alloc();
+      statement_->prepare(sqlStatement);
    }
    catch (soci::soci_error& error)
    {
@@ -189,10 +189,15 @@ Query::Query(const std::string& sqlStatement,
    }
 }
 
+Query::Query(const boost::shared_ptr<soci::statement>& statement) :
+   statement_(statement)
+{
+}
+
 RowsetIterator Rowset::begin()
 {
    if (query_)
-      return RowsetIterator(query_.get().statement_, row_);
+      return RowsetIterator(*query_.get().statement_, row_);
 
    return end();
 }
@@ -202,15 +207,78 @@ RowsetIterator Rowset::end()
    return RowsetIterator();
 }
 
+Error IConnection::executeBatch(std::vector<Query>& queries)
+{
+   try
+   {
+      // perform all of the writes within one transaction so the work is
+      // committed (and fsynced / round tripped) once instead of per query
+      soci::transaction transaction(session());
+
+      for (Query& query : queries)
+      {
+         Error error = execute(query);
+         if (error)
+         {
+            // the transaction rolls back when it goes out of scope
+            return error;
+         }
+      }
+
+      transaction.commit();
+      return Success();
+   }
+   catch (soci::soci_error& error)
+   {
+      return DatabaseError(error);
+   }
+}
+
 Connection::Connection(const soci::backend_factory& factory,
                        const std::string& connectionStr) :
    session_(factory, connectionStr)
 {
 }
 
+namespace {
+
+// upper bound on prepared statements cached per connection - when hit,
+// the cache is simply discarded (entries still referenced by in-flight
+// queries remain alive through their shared pointers)
+constexpr std::size_t kMaxCachedStatements = 32;
+
+} // anonymous namespace
+
 Query Connection::query(const std::string& sqlStatement)
 {
-   return Query(sqlStatement, session_);
+   // reuse a previously prepared statement for this sql when possible,
+   // skipping statement allocation and preparation (for backends like
+   // postgresql, preparation is a server round trip)
+   auto it = statementCache_.find(sqlStatement);
+   if (it != statementCache_.end())
+   {
+      // only reuse the statement when no other query still holds it
+      // (e.g. a rowset that is still being iterated)
+      if (it->second.use_count() == 1)
+      {
+         // clear the bindings left behind by the previous use
+         it->second->bind_clean_up();
+         return Query(it->second);
+      }
+
+      return Query(sqlStatement, session_);
+   }
+
+   Query query(sqlStatement, session_);
+   if (!query.prepareError_)
+   {
+      if (statementCache_.size() >= kMaxCachedStatements)
+         statementCache_.clear();
+
+      statementCache_[sqlStatement] = query.statement_;
+   }
+
+   return query;
 }
 
 Error Connection::execute(Query& query,
@@ -221,13 +289,13 @@ Error Connection::execute(Query& query,
 
    try
    {
-      query.statement_.define_and_bind();
-      bool result = query.statement_.execute(true);
+      query.statement_->define_and_bind();
+      bool result = query.statement_->execute(true);
 
       if (pDataReturned)
          *pDataReturned = result;
 
-      query.statement_.bind_clean_up();
+      query.statement_->bind_clean_up();
 
       return Success();
    }
@@ -245,9 +313,9 @@ Error Connection::execute(Query& query,
 
    try
    {
-      query.statement_.define_and_bind();
-      query.statement_.exchange_for_rowset(soci::into(rowset.row_));
-      query.statement_.execute(false);
+      query.statement_->define_and_bind();
+      query.statement_->exchange_for_rowset(soci::into(rowset.row_));
+      query.statement_->execute(false);
 
       rowset.query_ = query;
 
@@ -329,19 +397,35 @@ std::string PooledConnection::driverName() const
    return connection_->driverName();
 }
 
+namespace {
+
+// connections that have sat idle in the pool for at least this long are
+// health checked before being handed out - checking on every checkout
+// would add a database round trip to every query
+constexpr int kConnectionHealthCheckIdleSeconds = 60;
+
+} // anonymous namespace
+
+ConnectionPool::PooledEntry::PooledEntry(const boost::shared_ptr<Connection>& connection) :
+   connection(connection),
+   returnTime(boost::posix_time::microsec_clock::universal_time())
+{
+}
+
 boost::shared_ptr<IConnection> ConnectionPool::getConnection()
 {
    // block until a connection is available, but log an error
    // if this takes a long time, because we want to ensure that if we are in a hang
    // condition (i.e. threads are not properly returning connections to the pool) we
    // let the users/developers know that something is fishy
-   boost::shared_ptr<Connection> connection;
+   PooledEntry entry;
    while (true)
    {
-      if (connections_.deque(&connection, boost::posix_time::seconds(30)))
+      if (connections_.deque(&entry, boost::posix_time::seconds(30)))
       {
          // create wrapper PooledConnection around retrieved Connection
-         return boost::shared_ptr<IConnection>(new PooledConnection(shared_from_this(), connection));
+         return boost::shared_ptr<IConnection>(
+                  new PooledConnection(shared_from_this(), checkConnection(entry)));
       }
       else
       {
@@ -354,17 +438,75 @@ boost::shared_ptr<IConnection> ConnectionPool::getConnection()
 bool ConnectionPool::getConnection(const boost::posix_time::time_duration& maxWait,
                                    boost::shared_ptr<IConnection>* pConnection)
 {
-   boost::shared_ptr<Connection> connection;
-   if (!connections_.deque(&connection, maxWait))
+   PooledEntry entry;
+   if (!connections_.deque(&entry, maxWait))
       return false;
 
-   pConnection->reset(new PooledConnection(shared_from_this(), connection));
+   pConnection->reset(new PooledConnection(shared_from_this(), checkConnection(entry)));
    return true;
 }
 
+std::future<Error> ConnectionPool::executeAsync(
+      const boost::function<Error(const boost::shared_ptr<IConnection>&)>& work)
+{
+   auto pPromise = std::make_shared<std::promise<Error>>();
+   std::future<Error> future = pPromise->get_future();
+
+   boost::shared_ptr<ConnectionPool> pool = shared_from_this();
+   thread::backgroundThreadPool().enque([=]()
+   {
+      Error error;
+      try
+      {
+         error = work(pool->getConnection());
+      }
+      catch (soci::soci_error& sociError)
+      {
+         error = DatabaseError(sociError);
+      }
+      pPromise->set_value(error);
+   });
+
+   return future;
+}
+
+boost::shared_ptr<Connection> ConnectionPool::checkConnection(const PooledEntry& entry)
+{
+   using namespace boost::posix_time;
+
+   // recently used connections are presumed healthy
+   if (microsec_clock::universal_time() - entry.returnTime <
+       seconds(kConnectionHealthCheckIdleSeconds))
+   {
+      return entry.connection;
+   }
+
+   // run a trivial query to verify the connection is still usable
+   Error error = entry.connection->executeStr("SELECT 1");
+   if (!error)
+      return entry.connection;
+
+   // the connection has gone stale (the database server may have been
+   // restarted or dropped the idle session) - establish a replacement
+   LOG_WARNING_MESSAGE("Database connection failed health check - reconnecting: " +
+                       error.getSummary());
+
+   boost::shared_ptr<IConnection> connection;
+   Error connectError = connect(options_, &connection);
+   if (connectError)
+   {
+      // could not reconnect - hand out the original connection so the
+      // caller surfaces the underlying database error
+      LOG_ERROR(connectError);
+      return entry.connection;
+   }
+
+   return boost::static_pointer_cast<Connection>(connection);
+}
+
 void ConnectionPool::returnConnection(const boost::shared_ptr<Connection>& connection)
 {
-   connections_.enque(connection);
+   connections_.enque(PooledEntry(connection));
 }
 
 Transaction::Transaction(const boost::shared_ptr<IConnection>& connection) :
@@ -643,6 +785,10 @@ Error createConnectionPool(size_t poolSize,
 {
    pPool->reset(new ConnectionPool());
 
+   // remember the options so stale connections can be re-established
+   // when they fail a health check
+   (*pPool)->options_ = options;
+
    for (size_t i = 0; i < poolSize; ++i)
    {
       boost::shared_ptr<IConnection> connection;
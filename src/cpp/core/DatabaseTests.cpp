@@ -15,6 +15,8 @@
 
 #include <tests/TestThat.hpp>
 
+#include <chrono>
+
 #include <core/Database.hpp>
 #include <core/FileSerializer.hpp>
 #include <core/system/System.hpp>
@@ -97,6 +99,55 @@ TEST_CASE("Database", "[.database]")
       CHECK(row.get<1>() == text);
    }
 
+   test_that("Connection pool can execute queries asynchronously")
+   {
+      boost::shared_ptr<ConnectionPool> pool;
+      REQUIRE_FALSE(createConnectionPool(2, sqliteConnectionOptions(), &pool));
+
+      std::future<Error> future = pool->executeAsync(
+         [](const boost::shared_ptr<IConnection>& connection)
+         {
+            return connection->executeStr(
+               "create table AsyncTest(id int);"
+               "insert into AsyncTest(id) values(1);");
+         });
+
+      REQUIRE(future.wait_for(std::chrono::seconds(30)) == std::future_status::ready);
+      REQUIRE_FALSE(future.get());
+
+      int id = 0;
+      boost::shared_ptr<IConnection> connection = pool->getConnection();
+      Query query = connection->query("select id from AsyncTest")
+            .withOutput(id);
+      REQUIRE_FALSE(connection->execute(query));
+      CHECK(id == 1);
+   }
+
+   test_that("Batched queries execute within one transaction")
+   {
+      boost::shared_ptr<IConnection> connection;
+      REQUIRE_FALSE(connect(sqliteConnectionOptions(), &connection));
+
+      REQUIRE_FALSE(connection->executeStr("create table BatchTest(id int)"));
+
+      // note: input values must outlive executeBatch since queries bind
+      // their parameters by reference
+      std::vector<int> ids = {1, 2, 3};
+      std::vector<Query> queries;
+      for (int& id : ids)
+      {
+         queries.push_back(connection->query("insert into BatchTest(id) values(:id)")
+               .withInput(id));
+      }
+      REQUIRE_FALSE(connection->executeBatch(queries));
+
+      int count = 0;
+      Query query = connection->query("select count(*) from BatchTest")
+            .withOutput(count);
+      REQUIRE_FALSE(connection->execute(query));
+      CHECK(count == 3);
+   }
+
    test_that("Can create PostgreSQL database")
    {
       boost::shared_ptr<IConnection> connection;
@@ -0,0 +1,486 @@
+/*
+ * Diff.cpp
+ *
+ * Copyright (C) 2020 by RStudio, PBC
+ *
+ * Unless you have received this program directly from RStudio pursuant
+ * to the terms of a commercial license agreement with RStudio, then
+ * this program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ *
+ */
+
+#include <core/Diff.hpp>
+
+#include <algorithm>
+#include <map>
+#include <sstream>
+
+#include <boost/noncopyable.hpp>
+
+#include <core/Hash.hpp>
+
+namespace rstudio {
+namespace core {
+namespace diff {
+namespace {
+
+// intern lines as small integer identifiers so the diff core compares
+// integers rather than strings. lines are bucketed by hash, with an
+// exact string comparison to confirm membership (so a hash collision
+// cannot cause two distinct lines to compare equal)
+class LineInterner : boost::noncopyable
+{
+public:
+   void intern(const std::vector<std::string>& lines, std::vector<int>* pIds)
+   {
+      pIds->reserve(lines.size());
+      for (const std::string& line : lines)
+      {
+         boost::uint64_t hash = hash::hash64(line.data(), line.length());
+         std::vector<int>& bucket = buckets_[hash];
+
+         int id = -1;
+         for (int bucketId : bucket)
+         {
+            if (*lines_[bucketId] == line)
+            {
+               id = bucketId;
+               break;
+            }
+         }
+
+         if (id == -1)
+         {
+            id = static_cast<int>(lines_.size());
+            lines_.push_back(&line);
+            bucket.push_back(id);
+         }
+
+         pIds->push_back(id);
+      }
+   }
+
+private:
+   std::map<boost::uint64_t, std::vector<int> > buckets_;
+   std::vector<const std::string*> lines_;
+};
+
+// cap on the cost (edit distance) explored while searching for an
+// optimal split point -- when two inputs differ wildly a minimal edit
+// script isn't worth quadratic running time, so past this point we
+// divide at the furthest-reaching position found so far and accept a
+// (still correct) non-minimal script
+const int kMaxCost = 1024;
+
+// divide-and-conquer implementation of Myers' O(ND) difference
+// algorithm ("An O(ND) Difference Algorithm and Its Variations"); the
+// forward and backward furthest-reaching diagonal vectors are allocated
+// once and shared across the recursion
+class MyersDiff : boost::noncopyable
+{
+public:
+   MyersDiff(const std::vector<int>& a,
+             const std::vector<int>& b,
+             std::vector<Edit>* pEdits)
+      : a_(a),
+        b_(b),
+        pEdits_(pEdits),
+        // diagonals reach |k| <= max(N, M) + (N + M) / 2 + 1 in the
+        // worst case (the backward search is centered on delta = N - M)
+        offset_(2 * static_cast<int>(a.size() + b.size()) + 4)
+   {
+      vf_.resize(2 * offset_ + 1);
+      vb_.resize(2 * offset_ + 1);
+   }
+
+   void run()
+   {
+      diffRange(0, static_cast<int>(a_.size()),
+                0, static_cast<int>(b_.size()));
+   }
+
+private:
+   void diffRange(int a0, int a1, int b0, int b1)
+   {
+      // trim common prefix and suffix (matched lines produce no edits)
+      while (a0 < a1 && b0 < b1 && a_[a0] == b_[b0])
+      {
+         a0++;
+         b0++;
+      }
+      while (a1 > a0 && b1 > b0 && a_[a1 - 1] == b_[b1 - 1])
+      {
+         a1--;
+         b1--;
+      }
+
+      if (a0 == a1 && b0 == b1)
+         return;
+
+      // one side exhausted: the remainder of the other side is a pure
+      // insertion or deletion
+      if (a0 == a1 || b0 == b1)
+      {
+         addEdit(a0, a1 - a0, b0, b1 - b0);
+         return;
+      }
+
+      // find a point on an optimal (or, past the cost cap, best-effort)
+      // edit path and recurse on the two halves
+      int midX, midY;
+      middleSnake(a0, a1, b0, b1, &midX, &midY);
+
+      // validate the midpoint before recursing: it must lie within the
+      // subproblem, and both halves must be strictly smaller than the
+      // whole for the recursion to make progress
+      int N = a1 - a0;
+      int M = b1 - b0;
+      midX = (std::max)(0, (std::min)(midX, N));
+      midY = (std::max)(0, (std::min)(midY, M));
+      if (midX == 0 && midY == 0)
+         midX = 1;
+      else if (midX == N && midY == M)
+         midX--;
+
+      diffRange(a0, a0 + midX, b0, b0 + midY);
+      diffRange(a0 + midX, a1, b0 + midY, b1);
+   }
+
+   void middleSnake(int a0, int a1, int b0, int b1, int* pMidX, int* pMidY)
+   {
+      int N = a1 - a0;
+      int M = b1 - b0;
+      int delta = N - M;
+      bool odd = (delta & 1) != 0;
+
+      // index the diagonal vectors as vf[offset_ + k]; vf_[k] holds the
+      // furthest x reached along diagonal k (y == x - k) going forward,
+      // vb_[k] the smallest x reached going backward from (N, M)
+      int* vf = &vf_[0] + offset_;
+      int* vb = &vb_[0] + offset_;
+      vf[1] = 0;
+      vb[delta + 1] = N + 1;
+
+      // track the most productive endpoints seen in case we hit the
+      // cost cap before the forward and backward searches meet
+      int bestForwardX = 0, bestForwardY = 0;
+      int bestBackwardX = N, bestBackwardY = M;
+
+      int maxCost = (std::min)(kMaxCost, (N + M + 1) / 2 + 1);
+      for (int d = 0; ; d++)
+      {
+         // forward search; clamp the diagonals explored to the feasible
+         // band (points must satisfy x <= N and y <= M, so -M <= k <= N;
+         // without the clamp the furthest-reaching values escape the
+         // subproblem and later yield out-of-range midpoints). the clamp
+         // preserves the parity of k (always that of d)
+         int kMin = (std::max)(-d, -M + (((d + M) & 1) != 0 ? 1 : 0));
+         int kMax = (std::min)(d, N - (((d + N) & 1) != 0 ? 1 : 0));
+         for (int k = kMin; k <= kMax; k += 2)
+         {
+            // candidate moves: right from diagonal k - 1, down from
+            // diagonal k + 1; discard a neighbor that is stale at this
+            // cost or whose move would leave the subproblem
+            int x = -1;
+            if (k != -d && k - 1 >= -M)
+            {
+               int t = vf[k - 1] + 1;
+               if (t <= N && t - k >= 0 && t - k <= M)
+                  x = t;
+            }
+            if ((k != d || k == -d) && k + 1 <= N)
+            {
+               // k == -d reads the vf[1] seed on the first iteration
+               int t = vf[k + 1];
+               if (t > x && t <= N && t - k >= 0 && t - k <= M)
+                  x = t;
+            }
+            if (x < 0)
+               continue;
+
+            int y = x - k;
+            while (x < N && y < M && a_[a0 + x] == b_[b0 + y])
+            {
+               x++;
+               y++;
+            }
+            vf[k] = x;
+
+            if (x + y > bestForwardX + bestForwardY)
+            {
+               bestForwardX = x;
+               bestForwardY = y;
+            }
+
+            if (odd && k >= delta - (d - 1) && k <= delta + (d - 1) &&
+                vf[k] >= vb[k])
+            {
+               *pMidX = x;
+               *pMidY = y;
+               return;
+            }
+         }
+
+         // backward search, clamped to the same feasible band
+         kMin = (std::max)(delta - d,
+                           -M + (((delta + d + M) & 1) != 0 ? 1 : 0));
+         kMax = (std::min)(delta + d,
+                           N - (((delta + d + N) & 1) != 0 ? 1 : 0));
+         for (int k = kMin; k <= kMax; k += 2)
+         {
+            // candidate moves: left from diagonal k + 1, up from
+            // diagonal k - 1
+            int x = N + 1;
+            if ((k != delta + d || k == delta - d) && k + 1 <= N)
+            {
+               // k == delta - d reads the vb[delta + 1] seed on the
+               // first iteration
+               int t = vb[k + 1] - 1;
+               if (t >= 0 && t - k >= 0 && t - k <= M)
+                  x = t;
+            }
+            if (k != delta - d && k - 1 >= -M)
+            {
+               int t = vb[k - 1];
+               if (t < x && t >= 0 && t - k >= 0 && t - k <= M)
+                  x = t;
+            }
+            if (x > N)
+               continue;
+
+            int y = x - k;
+            while (x > 0 && y > 0 && a_[a0 + x - 1] == b_[b0 + y - 1])
+            {
+               x--;
+               y--;
+            }
+            vb[k] = x;
+
+            if (x + y < bestBackwardX + bestBackwardY)
+            {
+               bestBackwardX = x;
+               bestBackwardY = y;
+            }
+
+            if (!odd && k >= -d && k <= d && vb[k] <= vf[k])
+            {
+               *pMidX = x;
+               *pMidY = y;
+               return;
+            }
+         }
+
+         if (d >= maxCost)
+            break;
+      }
+
+      // cost cap reached without the searches meeting: split at
+      // whichever search made more progress (the caller validates the
+      // midpoint and guarantees recursion progress)
+      if (bestForwardX + bestForwardY >= (N - bestBackwardX) + (M - bestBackwardY))
+      {
+         *pMidX = bestForwardX;
+         *pMidY = bestForwardY;
+      }
+      else
+      {
+         *pMidX = bestBackwardX;
+         *pMidY = bestBackwardY;
+      }
+   }
+
+   void addEdit(int fromStart, int fromCount, int toStart, int toCount)
+   {
+      // coalesce with the previous edit when contiguous (a best-effort
+      // split can land between two halves of the same changed region)
+      if (!pEdits_->empty())
+      {
+         Edit& last = pEdits_->back();
+         if (last.fromStart + last.fromCount ==
+                static_cast<std::size_t>(fromStart) &&
+             last.toStart + last.toCount ==
+                static_cast<std::size_t>(toStart))
+         {
+            last.fromCount += fromCount;
+            last.toCount += toCount;
+            return;
+         }
+      }
+
+      pEdits_->push_back(Edit(fromStart, fromCount, toStart, toCount));
+   }
+
+private:
+   const std::vector<int>& a_;
+   const std::vector<int>& b_;
+   std::vector<Edit>* pEdits_;
+   int offset_;
+   std::vector<int> vf_;
+   std::vector<int> vb_;
+};
+
+void writeHunkRange(std::ostream& ostr, std::size_t start, std::size_t count)
+{
+   // unified format ranges are 1-based; an empty range reports the line
+   // before it (which is just the 0-based start), and a count of one is
+   // conventionally omitted
+   ostr << (count == 0 ? start : start + 1);
+   if (count != 1)
+      ostr << ',' << count;
+}
+
+} // anonymous namespace
+
+std::vector<std::string> splitDiffLines(const std::string& text)
+{
+   std::vector<std::string> lines;
+   std::size_t pos = 0;
+   while (pos < text.length())
+   {
+      std::size_t newline = text.find('\n', pos);
+      if (newline == std::string::npos)
+      {
+         lines.push_back(text.substr(pos));
+         break;
+      }
+      lines.push_back(text.substr(pos, newline - pos));
+      pos = newline + 1;
+   }
+   return lines;
+}
+
+std::vector<Edit> diffLines(const std::vector<std::string>& fromLines,
+                            const std::vector<std::string>& toLines)
+{
+   LineInterner interner;
+   std::vector<int> fromIds, toIds;
+   interner.intern(fromLines, &fromIds);
+   interner.intern(toLines, &toIds);
+
+   std::vector<Edit> edits;
+   MyersDiff(fromIds, toIds, &edits).run();
+   return edits;
+}
+
+std::string unifiedDiff(const std::string& fromFile,
+                        const std::string& fromText,
+                        const std::string& toFile,
+                        const std::string& toText,
+                        int contextLines)
+{
+   std::vector<std::string> fromLines = splitDiffLines(fromText);
+   std::vector<std::string> toLines = splitDiffLines(toText);
+
+   bool fromMissingNewline =
+         !fromText.empty() && fromText[fromText.length() - 1] != '\n';
+   bool toMissingNewline =
+         !toText.empty() && toText[toText.length() - 1] != '\n';
+
+   // a final line with no trailing newline only matches another final
+   // line that also lacks one (it must carry a "\ No newline at end of
+   // file" marker, which can't attach to an ordinary context line).
+   // encode that in the diffed keys by appending a newline -- which
+   // cannot occur within a line -- to an unterminated final line
+   std::vector<Edit> edits;
+   if (fromMissingNewline || toMissingNewline)
+   {
+      std::vector<std::string> fromKeys(fromLines);
+      std::vector<std::string> toKeys(toLines);
+      if (fromMissingNewline)
+         fromKeys.back() += '\n';
+      if (toMissingNewline)
+         toKeys.back() += '\n';
+      edits = diffLines(fromKeys, toKeys);
+   }
+   else
+   {
+      edits = diffLines(fromLines, toLines);
+   }
+
+   if (edits.empty())
+      return std::string();
+
+   std::size_t context = contextLines > 0 ? contextLines : 0;
+
+   std::ostringstream ostr;
+   ostr << "--- " << fromFile << "\n"
+        << "+++ " << toFile << "\n";
+
+   std::size_t i = 0;
+   while (i < edits.size())
+   {
+      // group subsequent edits into this hunk while the gap between
+      // them is covered by (shared) context
+      std::size_t j = i + 1;
+      while (j < edits.size() &&
+             edits[j].fromStart -
+                (edits[j - 1].fromStart + edits[j - 1].fromCount) <=
+                2 * context)
+      {
+         j++;
+      }
+
+      const Edit& first = edits[i];
+      const Edit& last = edits[j - 1];
+
+      std::size_t hunkFromStart =
+            first.fromStart > context ? first.fromStart - context : 0;
+      std::size_t hunkFromEnd =
+            (std::min)(fromLines.size(),
+                       last.fromStart + last.fromCount + context);
+      std::size_t hunkToStart =
+            first.toStart - (first.fromStart - hunkFromStart);
+      std::size_t hunkToEnd =
+            last.toStart + last.toCount +
+            (hunkFromEnd - (last.fromStart + last.fromCount));
+
+      ostr << "@@ -";
+      writeHunkRange(ostr, hunkFromStart, hunkFromEnd - hunkFromStart);
+      ostr << " +";
+      writeHunkRange(ostr, hunkToStart, hunkToEnd - hunkToStart);
+      ostr << " @@\n";
+
+      std::size_t pos = hunkFromStart;
+      for (std::size_t k = i; k < j; k++)
+      {
+         const Edit& edit = edits[k];
+         for (; pos < edit.fromStart; pos++)
+         {
+            ostr << ' ' << fromLines[pos] << '\n';
+            if (fromMissingNewline && pos + 1 == fromLines.size())
+               ostr << "\\ No newline at end of file\n";
+         }
+         for (std::size_t n = 0; n < edit.fromCount; n++, pos++)
+         {
+            ostr << '-' << fromLines[pos] << '\n';
+            if (fromMissingNewline && pos + 1 == fromLines.size())
+               ostr << "\\ No newline at end of file\n";
+         }
+         for (std::size_t n = 0; n < edit.toCount; n++)
+         {
+            std::size_t toPos = edit.toStart + n;
+            ostr << '+' << toLines[toPos] << '\n';
+            if (toMissingNewline && toPos + 1 == toLines.size())
+               ostr << "\\ No newline at end of file\n";
+         }
+      }
+      for (; pos < hunkFromEnd; pos++)
+      {
+         ostr << ' ' << fromLines[pos] << '\n';
+         if (fromMissingNewline && pos + 1 == fromLines.size())
+            ostr << "\\ No newline at end of file\n";
+      }
+
+      i = j;
+   }
+
+   return ostr.str();
+}
+
+} // namespace diff
+} // namespace core
+} // namespace rstudio
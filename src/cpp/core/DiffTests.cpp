@@ -0,0 +1,189 @@
+/*
+ * DiffTests.cpp
+ *
+ * Copyright (C) 2020 by RStudio, PBC
+ *
+ * Unless you have received this program directly from RStudio pursuant
+ * to the terms of a commercial license agreement with RStudio, then
+ * this program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ *
+ */
+
+#include <tests/TestThat.hpp>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include <core/Diff.hpp>
+
+namespace rstudio {
+namespace core {
+namespace diff {
+
+namespace {
+
+// apply an edit script to reproduce the target line vector
+std::vector<std::string> applyEdits(const std::vector<std::string>& fromLines,
+                                    const std::vector<std::string>& toLines,
+                                    const std::vector<Edit>& edits)
+{
+   std::vector<std::string> result;
+   std::size_t pos = 0;
+   for (const Edit& edit : edits)
+   {
+      for (; pos < edit.fromStart; pos++)
+         result.push_back(fromLines[pos]);
+      pos += edit.fromCount;
+      for (std::size_t i = 0; i < edit.toCount; i++)
+         result.push_back(toLines[edit.toStart + i]);
+   }
+   for (; pos < fromLines.size(); pos++)
+      result.push_back(fromLines[pos]);
+   return result;
+}
+
+} // anonymous namespace
+
+test_context("Diff")
+{
+   test_that("Lines are split without a trailing empty line")
+   {
+      std::vector<std::string> lines = splitDiffLines("a\nb\nc\n");
+      expect_true(lines.size() == 3);
+      expect_true(lines[2] == "c");
+
+      lines = splitDiffLines("a\nb\nc");
+      expect_true(lines.size() == 3);
+      expect_true(lines[2] == "c");
+
+      expect_true(splitDiffLines("").empty());
+   }
+
+   test_that("Identical inputs produce no edits")
+   {
+      std::vector<std::string> lines;
+      lines.push_back("a");
+      lines.push_back("b");
+      expect_true(diffLines(lines, lines).empty());
+      expect_true(unifiedDiff("a", "a\nb\n", "b", "a\nb\n").empty());
+   }
+
+   test_that("Edit scripts are minimal and transform from into to")
+   {
+      std::vector<std::string> fromLines, toLines;
+      const char* from[] = { "a", "b", "c", "a", "b", "b", "a" };
+      const char* to[] = { "c", "b", "a", "b", "a", "c" };
+      fromLines.assign(from, from + 7);
+      toLines.assign(to, to + 6);
+
+      std::vector<Edit> edits = diffLines(fromLines, toLines);
+      expect_true(applyEdits(fromLines, toLines, edits) == toLines);
+
+      // the classic example from Myers' paper has edit distance 5
+      std::size_t cost = 0;
+      for (const Edit& edit : edits)
+         cost += edit.fromCount + edit.toCount;
+      expect_true(cost == 5);
+   }
+
+   test_that("Unified diffs have the expected shape")
+   {
+      std::string diff = unifiedDiff(
+               "a/test.R", "a\nb\nc\nd\ne\nf\ng\n",
+               "b/test.R", "a\nb\nc\nD\ne\nf\ng\n",
+               1);
+      expect_true(diff ==
+            "--- a/test.R\n"
+            "+++ b/test.R\n"
+            "@@ -3,3 +3,3 @@\n"
+            " c\n"
+            "-d\n"
+            "+D\n"
+            " e\n");
+   }
+
+   test_that("New files diff against empty text")
+   {
+      std::string diff = unifiedDiff("/dev/null", "", "b/new.R", "x\ny\n");
+      expect_true(diff ==
+            "--- /dev/null\n"
+            "+++ b/new.R\n"
+            "@@ -0,0 +1,2 @@\n"
+            "+x\n"
+            "+y\n");
+   }
+
+   test_that("Missing trailing newlines are marked")
+   {
+      std::string diff = unifiedDiff("a/x", "a\nb\n", "b/x", "a\nb", 3);
+      expect_true(diff ==
+            "--- a/x\n"
+            "+++ b/x\n"
+            "@@ -1,2 +1,2 @@\n"
+            " a\n"
+            "-b\n"
+            "+b\n"
+            "\\ No newline at end of file\n");
+   }
+
+   test_that("Random inputs yield in-range scripts that reconstruct to")
+   {
+      // cross-check the diff engine against randomly generated inputs,
+      // including dissimilar pairs large enough to exercise the cost-cap
+      // (best-effort split) path: every emitted edit must stay within
+      // both inputs and the script must reconstruct "to" exactly
+      std::mt19937 rng(9);
+      std::uniform_int_distribution<int> lineChar('a', 'z');
+      for (int iteration = 0; iteration < 20; iteration++)
+      {
+         std::uniform_int_distribution<int> length(
+                  0, iteration < 2 ? 5000 : 200);
+         std::vector<std::string> fromLines, toLines;
+         int fromLength = length(rng);
+         int toLength = length(rng);
+         for (int i = 0; i < fromLength; i++)
+            fromLines.push_back(std::string(1, static_cast<char>(lineChar(rng))));
+         for (int i = 0; i < toLength; i++)
+            toLines.push_back(std::string(1, static_cast<char>(lineChar(rng))));
+
+         std::vector<Edit> edits = diffLines(fromLines, toLines);
+
+         std::size_t pos = 0;
+         for (const Edit& edit : edits)
+         {
+            expect_true(edit.fromStart >= pos);
+            expect_true(edit.fromStart + edit.fromCount >= edit.fromStart);
+            expect_true(edit.fromStart + edit.fromCount <= fromLines.size());
+            expect_true(edit.toStart + edit.toCount >= edit.toStart);
+            expect_true(edit.toStart + edit.toCount <= toLines.size());
+            pos = edit.fromStart + edit.fromCount;
+         }
+
+         expect_true(applyEdits(fromLines, toLines, edits) == toLines);
+      }
+   }
+
+   test_that("Distant edits are reported as separate hunks")
+   {
+      std::string fromText, toText;
+      for (int i = 0; i < 30; i++)
+      {
+         std::string line = "line " + std::to_string(i) + "\n";
+         fromText += line;
+         toText += (i == 2 || i == 27) ? "changed\n" : line;
+      }
+
+      std::string diff = unifiedDiff("a/x", fromText, "b/x", toText, 3);
+      expect_true(diff.find("@@ -1,6 +1,6 @@") != std::string::npos);
+      expect_true(diff.find("@@ -25,6 +25,6 @@") != std::string::npos);
+   }
+}
+
+} // namespace diff
+} // namespace core
+} // namespace rstudio
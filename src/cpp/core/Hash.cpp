@@ -15,17 +15,20 @@
 
 #include <core/Hash.hpp>
 
+#include <cstring>
+#include <istream>
 #include <sstream>
 #include <iomanip>
 
 #include <boost/crc.hpp>
 #include <boost/lexical_cast.hpp>
 
+#include <shared_core/FilePath.hpp>
 #include <shared_core/SafeConvert.hpp>
 
 namespace rstudio {
 namespace core {
-namespace hash {   
+namespace hash {
 
 std::string crc32Hash(const std::string& content)
 {
@@ -46,7 +49,212 @@ std::string crc32HexHash(const std::string& content)
           << std::hex << result.checksum();
    return output.str();
 }
-   
+
+namespace {
+
+// xxHash64 (https://cyan4973.github.io/xxHash/) -- a fast non-cryptographic
+// hash whose throughput is limited by memory bandwidth rather than by the
+// arithmetic itself (the crc32 implementation above processes one byte per
+// table lookup). note that the canonical algorithm is defined over
+// little-endian reads; on big-endian hosts this implementation produces
+// different (but still well-distributed and internally consistent) values,
+// which is fine for the fingerprinting use cases it serves
+const boost::uint64_t kPrime1 = 11400714785074694791ULL;
+const boost::uint64_t kPrime2 = 14029467366897019727ULL;
+const boost::uint64_t kPrime3 = 1609587929392839161ULL;
+const boost::uint64_t kPrime4 = 9650029242287828579ULL;
+const boost::uint64_t kPrime5 = 2870177450012600261ULL;
+
+inline boost::uint64_t rotl64(boost::uint64_t value, int count)
+{
+   return (value << count) | (value >> (64 - count));
+}
+
+inline boost::uint64_t read64(const unsigned char* pData)
+{
+   boost::uint64_t value;
+   std::memcpy(&value, pData, sizeof(value));
+   return value;
+}
+
+inline boost::uint32_t read32(const unsigned char* pData)
+{
+   boost::uint32_t value;
+   std::memcpy(&value, pData, sizeof(value));
+   return value;
+}
+
+inline boost::uint64_t round64(boost::uint64_t acc, boost::uint64_t input)
+{
+   acc += input * kPrime2;
+   acc = rotl64(acc, 31);
+   acc *= kPrime1;
+   return acc;
+}
+
+inline boost::uint64_t mergeRound64(boost::uint64_t acc, boost::uint64_t val)
+{
+   val = round64(0, val);
+   acc ^= val;
+   acc = acc * kPrime1 + kPrime4;
+   return acc;
+}
+
+// mix in the final (less than 32 byte) tail of the input and scramble the
+// accumulated bits so every input bit affects every output bit
+boost::uint64_t finalize64(boost::uint64_t h,
+                           const unsigned char* pData,
+                           std::size_t n)
+{
+   while (n >= 8)
+   {
+      h ^= round64(0, read64(pData));
+      h = rotl64(h, 27) * kPrime1 + kPrime4;
+      pData += 8;
+      n -= 8;
+   }
+
+   if (n >= 4)
+   {
+      h ^= static_cast<boost::uint64_t>(read32(pData)) * kPrime1;
+      h = rotl64(h, 23) * kPrime2 + kPrime3;
+      pData += 4;
+      n -= 4;
+   }
+
+   while (n > 0)
+   {
+      h ^= *pData * kPrime5;
+      h = rotl64(h, 11) * kPrime1;
+      pData++;
+      n--;
+   }
+
+   h ^= h >> 33;
+   h *= kPrime2;
+   h ^= h >> 29;
+   h *= kPrime3;
+   h ^= h >> 32;
+   return h;
+}
+
+} // anonymous namespace
+
+Hash64::Hash64(boost::uint64_t seed)
+   : v1_(seed + kPrime1 + kPrime2),
+     v2_(seed + kPrime2),
+     v3_(seed),
+     v4_(seed - kPrime1),
+     totalLength_(0),
+     seed_(seed),
+     bufferSize_(0)
+{
+}
+
+void Hash64::append(const void* pData, std::size_t n)
+{
+   const unsigned char* pBytes = static_cast<const unsigned char*>(pData);
+   totalLength_ += n;
+
+   // if the buffered remainder plus this input doesn't fill a block,
+   // just accumulate it
+   if (bufferSize_ + n < sizeof(buffer_))
+   {
+      std::memcpy(buffer_ + bufferSize_, pBytes, n);
+      bufferSize_ += n;
+      return;
+   }
+
+   // complete (and consume) any partially buffered block
+   if (bufferSize_ > 0)
+   {
+      std::size_t fill = sizeof(buffer_) - bufferSize_;
+      std::memcpy(buffer_ + bufferSize_, pBytes, fill);
+      v1_ = round64(v1_, read64(buffer_));
+      v2_ = round64(v2_, read64(buffer_ + 8));
+      v3_ = round64(v3_, read64(buffer_ + 16));
+      v4_ = round64(v4_, read64(buffer_ + 24));
+      pBytes += fill;
+      n -= fill;
+      bufferSize_ = 0;
+   }
+
+   // consume whole blocks directly from the input
+   while (n >= sizeof(buffer_))
+   {
+      v1_ = round64(v1_, read64(pBytes));
+      v2_ = round64(v2_, read64(pBytes + 8));
+      v3_ = round64(v3_, read64(pBytes + 16));
+      v4_ = round64(v4_, read64(pBytes + 24));
+      pBytes += sizeof(buffer_);
+      n -= sizeof(buffer_);
+   }
+
+   // buffer whatever remains
+   std::memcpy(buffer_, pBytes, n);
+   bufferSize_ = n;
+}
+
+void Hash64::append(const std::string& content)
+{
+   append(content.data(), content.length());
+}
+
+boost::uint64_t Hash64::digest() const
+{
+   boost::uint64_t h;
+   if (totalLength_ >= sizeof(buffer_))
+   {
+      h = rotl64(v1_, 1) + rotl64(v2_, 7) + rotl64(v3_, 12) + rotl64(v4_, 18);
+      h = mergeRound64(h, v1_);
+      h = mergeRound64(h, v2_);
+      h = mergeRound64(h, v3_);
+      h = mergeRound64(h, v4_);
+   }
+   else
+   {
+      h = seed_ + kPrime5;
+   }
+
+   h += totalLength_;
+   return finalize64(h, buffer_, bufferSize_);
+}
+
+boost::uint64_t hash64(const void* pData, std::size_t n, boost::uint64_t seed)
+{
+   Hash64 hash(seed);
+   hash.append(pData, n);
+   return hash.digest();
+}
+
+std::string hash64Hash(const std::string& content)
+{
+   return safe_convert::numberToString(
+            hash64(content.data(), content.length()));
+}
+
+Error hashFile64(const FilePath& filePath, boost::uint64_t* pHash)
+{
+   std::shared_ptr<std::istream> pStream;
+   Error error = filePath.openForRead(pStream);
+   if (error)
+      return error;
+
+   Hash64 hash;
+   char buffer[65536];
+   while (*pStream)
+   {
+      pStream->read(buffer, sizeof(buffer));
+      hash.append(buffer, pStream->gcount());
+   }
+
+   if (pStream->bad())
+      return systemError(boost::system::errc::io_error, ERROR_LOCATION);
+
+   *pHash = hash.digest();
+   return Success();
+}
+
 } // namespace hash
 } // namespace core 
 } // namespace rstudio
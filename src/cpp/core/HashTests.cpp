@@ -0,0 +1,86 @@
+/*
+ * HashTests.cpp
+ *
+ * Copyright (C) 2020 by RStudio, PBC
+ *
+ * Unless you have received this program directly from RStudio pursuant
+ * to the terms of a commercial license agreement with RStudio, then
+ * this program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ *
+ */
+
+#include <tests/TestThat.hpp>
+
+#include <algorithm>
+#include <string>
+
+#include <core/Hash.hpp>
+
+namespace rstudio {
+namespace core {
+namespace hash {
+
+test_context("Hashing")
+{
+   test_that("hash64 matches the xxHash64 reference vectors")
+   {
+      // reference values produced by the canonical xxHash64
+      // implementation (little-endian hosts)
+      expect_true(hash64("", 0) == 0xEF46DB3751D8E999ULL);
+      expect_true(hash64("abc", 3) == 0x44BC2CF5AD770999ULL);
+
+      std::string spam("Nobody inspects the spammish repetition");
+      expect_true(hash64(spam.data(), spam.length()) ==
+                  0xFBCEA83C8A378BF1ULL);
+
+      // exercise the >= 32 byte (striped accumulator) path
+      std::string longer("0123456789abcdef0123456789abcdef0123456789abcdef");
+      expect_true(hash64(longer.data(), longer.length()) ==
+                  0xE35216444A3C253BULL);
+   }
+
+   test_that("streaming Hash64 is equivalent to one-shot hash64")
+   {
+      std::string input;
+      for (int i = 0; i < 100; i++)
+         input += "The quick brown fox jumps over the lazy dog. ";
+
+      boost::uint64_t expected = hash64(input.data(), input.length());
+
+      // append in chunk sizes chosen to straddle the 32-byte internal
+      // block boundary in different ways
+      std::size_t chunkSizes[] = { 1, 7, 31, 32, 33, 100, 4096 };
+      for (std::size_t chunkSize : chunkSizes)
+      {
+         Hash64 hash;
+         for (std::size_t offset = 0;
+              offset < input.length();
+              offset += chunkSize)
+         {
+            hash.append(input.data() + offset,
+                        std::min(chunkSize, input.length() - offset));
+         }
+         expect_true(hash.digest() == expected);
+      }
+   }
+
+   test_that("seeds produce distinct hashes")
+   {
+      std::string input("hello, world");
+      expect_true(hash64(input.data(), input.length(), 0) !=
+                  hash64(input.data(), input.length(), 1));
+   }
+
+   test_that("hash64Hash returns the hash in decimal string form")
+   {
+      expect_true(hash64Hash("abc") == "4952883123889572249");
+   }
+}
+
+} // namespace hash
+} // namespace core
+} // namespace rstudio
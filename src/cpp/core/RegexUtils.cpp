@@ -15,6 +15,9 @@
 
 #include <core/RegexUtils.hpp>
 
+#include <list>
+#include <map>
+#include <utility>
 #include <vector>
 #include <sstream>
 
@@ -26,11 +29,102 @@
 #include <boost/iostreams/filtering_stream.hpp>
 
 #include <core/StringUtils.hpp>
+#include <core/Thread.hpp>
 
 namespace rstudio {
 namespace core {
 namespace regex_utils {
 
+namespace {
+
+// bounded LRU of compiled patterns keyed by (pattern, flags)
+class RegexCache : boost::noncopyable
+{
+public:
+   bool lookup(const std::string& pattern,
+               boost::regex::flag_type flags,
+               boost::regex* pRegex)
+   {
+      LOCK_MUTEX(mutex_)
+      {
+         std::map<Key,Entry>::iterator it = cache_.find(Key(pattern, flags));
+         if (it == cache_.end())
+            return false;
+
+         // move to the front of the LRU list
+         lru_.splice(lru_.begin(), lru_, it->second.lruPos);
+         *pRegex = it->second.regex;
+         return true;
+      }
+      END_LOCK_MUTEX
+
+      return false;
+   }
+
+   void store(const std::string& pattern,
+              boost::regex::flag_type flags,
+              const boost::regex& regex)
+   {
+      LOCK_MUTEX(mutex_)
+      {
+         Key key(pattern, flags);
+         if (cache_.find(key) != cache_.end())
+            return;
+
+         // evict the least recently used entry when full
+         if (cache_.size() >= kMaxEntries)
+         {
+            cache_.erase(lru_.back());
+            lru_.pop_back();
+         }
+
+         lru_.push_front(key);
+         Entry entry;
+         entry.regex = regex;
+         entry.lruPos = lru_.begin();
+         cache_[key] = entry;
+      }
+      END_LOCK_MUTEX
+   }
+
+private:
+   typedef std::pair<std::string, boost::regex::flag_type> Key;
+
+   struct Entry
+   {
+      boost::regex regex;
+      std::list<Key>::iterator lruPos;
+   };
+
+   static const std::size_t kMaxEntries = 128;
+
+   boost::mutex mutex_;
+   std::map<Key,Entry> cache_;
+   std::list<Key> lru_;
+};
+
+RegexCache& regexCache()
+{
+   static RegexCache instance;
+   return instance;
+}
+
+} // anonymous namespace
+
+boost::regex cachedRegex(const std::string& pattern,
+                         boost::regex::flag_type flags)
+{
+   boost::regex regex;
+   if (regexCache().lookup(pattern, flags, &regex))
+      return regex;
+
+   // compile outside the lock (an invalid pattern throws here, before
+   // the cache is touched)
+   regex = boost::regex(pattern, flags);
+   regexCache().store(pattern, flags, regex);
+   return regex;
+}
+
 boost::regex wildcardPatternToRegex(const std::string& pattern)
 {
    // split into componenents
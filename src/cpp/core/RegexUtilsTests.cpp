@@ -0,0 +1,68 @@
+/*
+ * RegexUtilsTests.cpp
+ *
+ * Copyright (C) 2020 by RStudio, PBC
+ *
+ * Unless you have received this program directly from RStudio pursuant
+ * to the terms of a commercial license agreement with RStudio, then
+ * this program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ *
+ */
+
+#include <tests/TestThat.hpp>
+
+#include <string>
+
+#include <core/RegexUtils.hpp>
+
+namespace rstudio {
+namespace core {
+namespace regex_utils {
+
+test_context("RegexUtils")
+{
+   test_that("Cached regexes behave like freshly compiled ones")
+   {
+      boost::regex regex = cachedRegex("^a+b$");
+      expect_true(boost::regex_match(std::string("aaab"), regex));
+      expect_false(boost::regex_match(std::string("abc"), regex));
+
+      // a second request for the same pattern (served from the cache)
+      // matches identically
+      boost::regex again = cachedRegex("^a+b$");
+      expect_true(boost::regex_match(std::string("aaab"), again));
+   }
+
+   test_that("Cache entries are distinguished by flags")
+   {
+      boost::regex sensitive = cachedRegex("abc");
+      boost::regex insensitive = cachedRegex("abc", boost::regex::icase);
+      expect_false(boost::regex_match(std::string("ABC"), sensitive));
+      expect_true(boost::regex_match(std::string("ABC"), insensitive));
+   }
+
+   test_that("Invalid patterns throw without polluting the cache")
+   {
+      REQUIRE_THROWS(cachedRegex("(unterminated"));
+      REQUIRE_THROWS(cachedRegex("(unterminated"));
+   }
+
+   test_that("Eviction keeps the cache usable")
+   {
+      // compile well over the cache bound worth of distinct patterns
+      for (int i = 0; i < 300; i++)
+         cachedRegex("pattern" + std::to_string(i));
+
+      // early (evicted) patterns still work when re-requested
+      boost::regex regex = cachedRegex("pattern0");
+      expect_true(boost::regex_match(std::string("pattern0"), regex));
+   }
+}
+
+} // namespace regex_utils
+} // namespace core
+} // namespace rstudio
@@ -25,7 +25,8 @@ namespace core {
 
 Settings::Settings()
    : updatePending_(false),
-     isDirty_(false)
+     isDirty_(false),
+     logEntries_(0)
 {
 }
 
@@ -33,22 +34,44 @@ Settings::~Settings()
 {
 }
 
-Error Settings::initialize(const FilePath& filePath) 
+Error Settings::initialize(const FilePath& filePath)
 {
    settingsFile_ = filePath;
    settingsMap_.clear();
-   Error error = core::readStringMapFromFile(settingsFile_, &settingsMap_);
+   logEntries_ = 0;
+
+   // the settings file is an append log: set() appends name=value lines
+   // and later entries supersede earlier ones, so replay the lines in
+   // order rather than relying on (first-wins) map insertion
+   std::vector<std::string> lines;
+   Error error = core::readStringVectorFromFile(settingsFile_, &lines);
    if (error)
    {
-      // we don't consider file-not-found and error because it is a 
+      // we don't consider file-not-found and error because it is a
       // common initialization case
       if (error != systemError(boost::system::errc::no_such_file_or_directory, ErrorLocation()))
       {
          error.addProperty("settings-file", settingsFile_);
          return error;
       }
+
+      return Success();
    }
-   
+
+   for (const std::string& line : lines)
+   {
+      std::pair<const std::string, std::string> entry;
+      if (core::parseStringPair(line, &entry) == ReadCollectionAddLine)
+      {
+         settingsMap_[entry.first] = entry.second;
+         ++logEntries_;
+      }
+   }
+
+   // compact on startup when superseded entries dominate the file
+   if (logEntries_ > compactionThreshold())
+      writeSettings();
+
    return Success();
 }
 
@@ -58,9 +81,9 @@ void Settings::set(const std::string& name, const std::string& value)
    {
       settingsMap_[name] = value;
       isDirty_ = true;
-      
+
       if (!updatePending_)
-         writeSettings();
+         appendSetting(name, value);
    }
 }
    
@@ -146,9 +169,45 @@ void Settings::endUpdate()
       writeSettings();
 }
 
-void Settings::writeSettings() 
+void Settings::appendSetting(const std::string& name, const std::string& value)
+{
+   // compact once superseded entries dominate the log
+   if (logEntries_ + 1 > compactionThreshold())
+   {
+      writeSettings();
+      return;
+   }
+
+   std::shared_ptr<std::ostream> pOfs;
+   Error error = settingsFile_.openForWrite(pOfs, false);
+   if (error)
+   {
+      LOG_ERROR(error);
+      return;
+   }
+
+   try
+   {
+      pOfs->exceptions(std::ostream::failbit | std::ostream::badbit);
+      pOfs->seekp(0, std::ios::end);
+      *pOfs << core::stringifyStringPair(std::make_pair(name, value)) << std::endl;
+
+      isDirty_ = false;
+      ++logEntries_;
+   }
+   catch(const std::exception& e)
+   {
+      Error error = systemError(boost::system::errc::io_error, ERROR_LOCATION);
+      error.addProperty("what", e.what());
+      error.addProperty("path", settingsFile_.getAbsolutePath());
+      LOG_ERROR(error);
+   }
+}
+
+void Settings::writeSettings()
 {
    isDirty_ = false;
+   logEntries_ = settingsMap_.size();
    Error error = core::writeStringMapToFile(settingsFile_, settingsMap_);
    if (error)
      LOG_ERROR(error);
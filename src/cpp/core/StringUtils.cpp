@@ -16,6 +16,8 @@
 #include <core/StringUtils.hpp>
 
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <map>
 #include <ostream>
 #include <gsl/gsl>
@@ -27,6 +29,8 @@
 #include <boost/algorithm/string/split.hpp>
 #include <boost/regex.hpp>
 
+#include <core/RegexUtils.hpp>
+
 #include <core/Algorithm.hpp>
 #include <core/Log.hpp>
 #include <shared_core/SafeConvert.hpp>
@@ -177,6 +181,61 @@ std::string getExtension(std::string const& x)
       return std::string();
 }
 
+namespace {
+
+// word-at-a-time byte test -- yields a non-zero value iff any byte of
+// 'word' equals the byte replicated through 'pattern'
+inline uint64_t hasByte(uint64_t word, uint64_t pattern)
+{
+   uint64_t match = word ^ pattern;
+   return (match - UINT64_C(0x0101010101010101)) & ~match &
+          UINT64_C(0x8080808080808080);
+}
+
+// scan for the next byte that can begin a line-ending sequence ('\r',
+// '\n', or 0xE2, the lead byte of U+2028 / U+2029), consuming eight
+// bytes per iteration until a candidate word is found
+const char* findLineEndingStart(const char* it, const char* end)
+{
+   const uint64_t kCR = UINT64_C(0x0D0D0D0D0D0D0D0D);
+   const uint64_t kLF = UINT64_C(0x0A0A0A0A0A0A0A0A);
+   const uint64_t kE2 = UINT64_C(0xE2E2E2E2E2E2E2E2);
+
+   for ( ; end - it >= 8; it += 8)
+   {
+      uint64_t word;
+      ::memcpy(&word, it, sizeof(word));
+      if (hasByte(word, kCR) | hasByte(word, kLF) | hasByte(word, kE2))
+         break;
+   }
+
+   for ( ; it != end; ++it)
+   {
+      char ch = *it;
+      if (ch == '\r' || ch == '\n' || ch == '\xE2')
+         break;
+   }
+
+   return it;
+}
+
+// the length of the line-ending sequence beginning at 'it', or 0 if an
+// 0xE2 candidate turns out not to be a U+2028 / U+2029 separator
+std::size_t lineEndingLength(const char* it, const char* end)
+{
+   if (*it == '\n')
+      return 1;
+   else if (*it == '\r')
+      return (end - it >= 2 && it[1] == '\n') ? 2 : 1;
+   else if (end - it >= 3 && it[1] == '\x80' &&
+            (it[2] == '\xA8' || it[2] == '\xA9'))
+      return 3;
+   else
+      return 0;
+}
+
+} // anonymous namespace
+
 void convertLineEndings(std::string* pStr, LineEnding type)
 {
    std::string replacement;
@@ -200,7 +259,62 @@ void convertLineEndings(std::string* pStr, LineEnding type)
       return;
    }
 
-   *pStr = boost::regex_replace(*pStr, boost::regex("\\r?\\n|\\r|\\xE2\\x80[\\xA8\\xA9]"), replacement);
+   const char* begin = pStr->data();
+   const char* end = begin + pStr->size();
+
+   // first pass: look for a line ending that differs from the requested
+   // convention; most documents are already consistent and can be left
+   // in place without any copying
+   bool needsConversion = false;
+   for (const char* it = begin; it != end; )
+   {
+      const char* match = findLineEndingStart(it, end);
+      if (match == end)
+         break;
+
+      std::size_t length = lineEndingLength(match, end);
+      if (length == 0)
+      {
+         it = match + 1;
+         continue;
+      }
+
+      if (replacement.compare(0, replacement.size(), match, length) != 0)
+      {
+         needsConversion = true;
+         break;
+      }
+
+      it = match + length;
+   }
+
+   if (!needsConversion)
+      return;
+
+   // second pass: rebuild the string, copying the spans between line
+   // endings in bulk
+   std::string result;
+   result.reserve(pStr->size());
+   for (const char* it = begin; it != end; )
+   {
+      const char* match = findLineEndingStart(it, end);
+      result.append(it, match);
+      if (match == end)
+         break;
+
+      std::size_t length = lineEndingLength(match, end);
+      if (length == 0)
+      {
+         result.push_back(*match);
+         it = match + 1;
+         continue;
+      }
+
+      result.append(replacement);
+      it = match + length;
+   }
+
+   *pStr = std::move(result);
 }
 
 bool detectLineEndings(const FilePath& filePath, LineEnding* pType)
@@ -256,6 +370,41 @@ bool detectLineEndings(const FilePath& filePath, LineEnding* pType)
    return false;
 }
 
+bool isValidUtf8(const std::string& str)
+{
+   const char* it = str.data();
+   const char* end = it + str.size();
+
+   while (it != end)
+   {
+      // skip over runs of ASCII eight bytes at a time
+      for ( ; end - it >= 8; it += 8)
+      {
+         uint64_t word;
+         ::memcpy(&word, it, sizeof(word));
+         if (word & UINT64_C(0x8080808080808080))
+            break;
+      }
+
+      if (it == end)
+         break;
+
+      if (static_cast<unsigned char>(*it) < 0x80)
+      {
+         ++it;
+         continue;
+      }
+
+      // validate the multi-byte sequence with the standard advance, so
+      // this check agrees exactly with what utf8Clean would accept
+      Error error = utf8Advance(it, 1, end, &it);
+      if (error)
+         return false;
+   }
+
+   return true;
+}
+
 std::string utf8ToSystem(const std::string& str,
                          bool escapeInvalidChars)
 {
@@ -474,9 +623,10 @@ std::string filterControlChars(const std::string& str)
 {
    // Delete control chars, which can cause errors in JSON parsing (especially
    // \0003)
-   return boost::regex_replace(str,
-                               boost::regex("[\\0000-\\0010\\0016-\\0037]+"),
-                               "");
+   return boost::regex_replace(
+            str,
+            regex_utils::cachedRegex("[\\0000-\\0010\\0016-\\0037]+"),
+            "");
 }
 
 namespace {
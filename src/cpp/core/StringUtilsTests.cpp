@@ -155,6 +155,56 @@ test_context("Comment extraction")
    }
 }
 
+test_context("Line ending conversion")
+{
+   test_that("mixed line endings are normalized")
+   {
+      std::string text("one\r\ntwo\rthree\nfour\xE2\x80\xA8" "five\xE2\x80\xA9");
+      convertLineEndings(&text, LineEndingPosix);
+      expect_true(text == "one\ntwo\nthree\nfour\nfive\n");
+
+      text = "one\ntwo\rthree";
+      convertLineEndings(&text, LineEndingWindows);
+      expect_true(text == "one\r\ntwo\r\nthree");
+   }
+
+   test_that("consistent documents are left unchanged")
+   {
+      std::string text("one\ntwo\nthree\n");
+      convertLineEndings(&text, LineEndingPosix);
+      expect_true(text == "one\ntwo\nthree\n");
+
+      text = "one\r\ntwo\r\n";
+      convertLineEndings(&text, LineEndingWindows);
+      expect_true(text == "one\r\ntwo\r\n");
+   }
+
+   test_that("stray 0xE2 bytes are not treated as separators")
+   {
+      std::string text("caf\xC3\xA9\xE2\x82\xAC\nend");
+      std::string expected("caf\xC3\xA9\xE2\x82\xAC\r\nend");
+      convertLineEndings(&text, LineEndingWindows);
+      expect_true(text == expected);
+   }
+}
+
+test_context("UTF-8 validation")
+{
+   test_that("valid strings are accepted")
+   {
+      expect_true(isValidUtf8(""));
+      expect_true(isValidUtf8("plain ascii, long enough for the word-wise path"));
+      expect_true(isValidUtf8("caf\xC3\xA9 na\xC3\xAFve \xE2\x82\xAC \xF0\x9F\x98\x80"));
+   }
+
+   test_that("malformed sequences are rejected")
+   {
+      expect_false(isValidUtf8("dangling continuation \x80"));
+      expect_false(isValidUtf8("truncated \xC3"));
+      expect_false(isValidUtf8("bad lead byte \xFF here"));
+   }
+}
+
 } // end namespace string_utils
 } // end namespace core
 } // end namespace rstudio
@@ -16,12 +16,75 @@
 #include <core/Thread.hpp>
 #include <core/Macros.hpp>
 
+#include <algorithm>
+
+#include <boost/bind.hpp>
+
 #include <core/system/System.hpp>
 
 namespace rstudio {
 namespace core {
 namespace thread {
 
+ThreadPool::ThreadPool(std::size_t numThreads)
+   : numThreads_(numThreads),
+     started_(false)
+{
+}
+
+void ThreadPool::enque(const boost::function<void()>& task)
+{
+   LOCK_MUTEX(mutex_)
+   {
+      if (!started_)
+      {
+         for (std::size_t i = 0; i < numThreads_; i++)
+            safeLaunchThread(boost::bind(&ThreadPool::workerMain, this));
+         started_ = true;
+      }
+   }
+   END_LOCK_MUTEX
+
+   tasks_.enque(task);
+}
+
+void ThreadPool::workerMain()
+{
+   while (true)
+   {
+      // deque with a timeout (rather than waiting on the queue's
+      // condition directly) so a notification which races our last
+      // empty check is only delayed, never lost
+      boost::function<void()> task;
+      if (!tasks_.deque(&task, boost::posix_time::milliseconds(100)))
+         continue;
+
+      try
+      {
+         task();
+      }
+      catch(const std::exception& e)
+      {
+         LOG_ERROR_MESSAGE(std::string("Unexpected exception: ") + e.what());
+      }
+      catch(...)
+      {
+         LOG_ERROR_MESSAGE("Unknown exception running thread pool task");
+      }
+   }
+}
+
+ThreadPool& backgroundThreadPool()
+{
+   // allocated on the heap and never freed so the pool's synchronization
+   // objects remain valid while workers wind down at shutdown
+   static ThreadPool* pInstance = new ThreadPool(
+      std::min<std::size_t>(
+         std::max<std::size_t>(boost::thread::hardware_concurrency(), 2),
+         8));
+   return *pInstance;
+}
+
 void safeLaunchThread(boost::function<void()> threadMain,
                       boost::thread* pThread)
 {
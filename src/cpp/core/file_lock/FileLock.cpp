@@ -36,8 +36,9 @@ namespace core {
 
 namespace {
 
-const char * const kLockTypeAdvisory  = "advisory";
-const char * const kLockTypeLinkBased = "linkbased";
+const char * const kLockTypeAdvisory   = "advisory";
+const char * const kLockTypeLinkBased  = "linkbased";
+const char * const kLockTypeLeaseBased = "leasebased";
 
 // use advisory locks on Windows by default; link-based elsewhere
 #ifdef _WIN32
@@ -56,8 +57,9 @@ std::string lockTypeToString(FileLock::LockType type)
 {
    switch (type)
    {
-   case FileLock::LOCKTYPE_ADVISORY:  return kLockTypeAdvisory;
-   case FileLock::LOCKTYPE_LINKBASED: return kLockTypeLinkBased;
+   case FileLock::LOCKTYPE_ADVISORY:   return kLockTypeAdvisory;
+   case FileLock::LOCKTYPE_LINKBASED:  return kLockTypeLinkBased;
+   case FileLock::LOCKTYPE_LEASEBASED: return kLockTypeLeaseBased;
    }
    
    // not reached
@@ -73,6 +75,8 @@ FileLock::LockType stringToLockType(const std::string& lockType,
       return FileLock::LOCKTYPE_ADVISORY;
    else if (boost::iequals(lockType, kLockTypeLinkBased))
       return FileLock::LOCKTYPE_LINKBASED;
+   else if (boost::iequals(lockType, kLockTypeLeaseBased))
+      return FileLock::LOCKTYPE_LEASEBASED;
    
    LOG_WARNING_MESSAGE("unrecognized lock type '" + lockType + "'");
    return defaultLockType;
@@ -234,8 +238,9 @@ boost::shared_ptr<FileLock> FileLock::create(LockType type)
    
    switch (type)
    {
-   case LOCKTYPE_ADVISORY:  return boost::shared_ptr<FileLock>(new AdvisoryFileLock());
-   case LOCKTYPE_LINKBASED: return boost::shared_ptr<FileLock>(new LinkBasedFileLock());
+   case LOCKTYPE_ADVISORY:   return boost::shared_ptr<FileLock>(new AdvisoryFileLock());
+   case LOCKTYPE_LINKBASED:  return boost::shared_ptr<FileLock>(new LinkBasedFileLock());
+   case LOCKTYPE_LEASEBASED: return boost::shared_ptr<FileLock>(new LeaseBasedFileLock());
    }
    
    // shouldn't be reached
@@ -253,6 +258,7 @@ void FileLock::refresh()
    verifyInitialized();
    AdvisoryFileLock::refresh();
    LinkBasedFileLock::refresh();
+   LeaseBasedFileLock::refresh();
 }
 
 void FileLock::cleanUp()
@@ -260,6 +266,7 @@ void FileLock::cleanUp()
    verifyInitialized();
    AdvisoryFileLock::cleanUp();
    LinkBasedFileLock::cleanUp();
+   LeaseBasedFileLock::cleanUp();
 }
 
 namespace {
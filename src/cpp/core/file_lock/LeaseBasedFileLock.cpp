@@ -0,0 +1,417 @@
+/*
+ * LeaseBasedFileLock.cpp
+ *
+ * Copyright (C) 2020 by RStudio, PBC
+ *
+ * Unless you have received this program directly from RStudio pursuant
+ * to the terms of a commercial license agreement with RStudio, then
+ * this program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ *
+ */
+
+#include <core/FileLock.hpp>
+
+#include <errno.h>
+#include <stdio.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+
+#ifdef _MSC_VER
+# include <io.h>
+#else
+# include <unistd.h>
+#endif
+
+#include <map>
+#include <vector>
+
+#include <boost/algorithm/string.hpp>
+
+#include <shared_core/Error.hpp>
+#include <shared_core/FilePath.hpp>
+#include <shared_core/SafeConvert.hpp>
+#include <core/DateTime.hpp>
+#include <core/FileSerializer.hpp>
+#include <core/Log.hpp>
+#include <core/Thread.hpp>
+#include <core/system/System.hpp>
+
+#define LOG(__X__)                                                             \
+   do                                                                          \
+   {                                                                           \
+      std::stringstream ss;                                                    \
+      ss << "(PID " << ::getpid() << "): " << __X__ << std::endl;              \
+      ::rstudio::core::FileLock::log(ss.str());                                \
+   } while (0)
+
+namespace rstudio {
+namespace core {
+
+namespace {
+
+// the lock is a single file holding the current lease:
+//
+//    <epoch>|<owner uuid>|<hostname>|<pid>|<expiry ms since epoch>
+//
+// the epoch increments monotonically with each change of ownership, so a
+// delayed write from a previous owner can never be mistaken for a live
+// lease. staleness is a constant-time comparison against the embedded
+// expiry -- no process liveness probes and no directory scans
+
+struct Lease
+{
+   Lease() : epoch(0), pid(0), expiryMs(0) {}
+
+   boost::uint64_t epoch;
+   std::string uuid;
+   std::string hostName;
+   long pid;
+   double expiryMs;
+};
+
+std::string hostName()
+{
+   char buffer[256];
+   int status = ::gethostname(buffer, 255);
+   if (status)
+      LOG_ERROR(systemError(errno, ERROR_LOCATION));
+   return std::string(buffer);
+}
+
+std::string formatLease(const Lease& lease)
+{
+   std::stringstream ss;
+   ss << lease.epoch << "|"
+      << lease.uuid << "|"
+      << lease.hostName << "|"
+      << lease.pid << "|"
+      << static_cast<boost::uint64_t>(lease.expiryMs);
+   return ss.str();
+}
+
+bool parseLease(const std::string& contents, Lease* pLease)
+{
+   std::vector<std::string> fields;
+   boost::algorithm::split(fields,
+                           contents,
+                           boost::algorithm::is_any_of("|"));
+   if (fields.size() != 5)
+      return false;
+
+   pLease->epoch = safe_convert::stringTo<boost::uint64_t>(fields[0], 0);
+   pLease->uuid = fields[1];
+   pLease->hostName = fields[2];
+   pLease->pid = safe_convert::stringTo<long>(fields[3], 0);
+   pLease->expiryMs = safe_convert::stringTo<double>(fields[4], 0);
+
+   return pLease->epoch != 0 && !pLease->uuid.empty();
+}
+
+bool readLease(const FilePath& lockFilePath, Lease* pLease)
+{
+   std::string contents;
+   Error error = core::readStringFromFile(lockFilePath, &contents);
+   if (error)
+      return false;
+
+   return parseLease(string_utils::trimWhitespace(contents), pLease);
+}
+
+double nowMs()
+{
+   return date_time::millisecondsSinceEpoch();
+}
+
+double leaseDurationMs()
+{
+   return FileLock::getTimeoutInterval().total_seconds() * 1000.0;
+}
+
+// write the lease by renaming a uniquely named sibling over the lock
+// file (atomic on POSIX, including NFS), then read it back to verify
+// ownership: when several processes race to claim an expired lease the
+// last rename wins, and everyone else sees a foreign uuid here
+bool writeLease(const FilePath& lockFilePath, const Lease& lease)
+{
+#ifndef _WIN32
+
+   FilePath tempPath = lockFilePath.getParent().completePath(
+            ".rstudio-lease-" + lease.uuid);
+   Error error = core::writeStringToFile(tempPath, formatLease(lease));
+   if (error)
+   {
+      LOG_ERROR(error);
+      return false;
+   }
+
+   int status = ::rename(tempPath.getAbsolutePathNative().c_str(),
+                         lockFilePath.getAbsolutePathNative().c_str());
+   if (status == -1)
+   {
+      int errorNumber = errno;
+      LOG("ERROR: ::rename() failed (errno " << errorNumber << ")" <<
+          std::endl << "Attempted to rename:" << std::endl << " - " <<
+          "'" << tempPath.getAbsolutePathNative() << "'" <<
+          " => " <<
+          "'" << lockFilePath.getAbsolutePathNative() << "'");
+      error = tempPath.removeIfExists();
+      if (error)
+         LOG_ERROR(error);
+      return false;
+   }
+
+   // verify that our write won the race
+   Lease onDisk;
+   return readLease(lockFilePath, &onDisk) && onDisk.uuid == lease.uuid;
+
+#else
+
+   return false;
+
+#endif
+}
+
+class LeaseRegistration : boost::noncopyable
+{
+public:
+
+   void registerLease(const FilePath& lockFilePath, const Lease& lease)
+   {
+      LOCK_MUTEX(mutex_)
+      {
+         leases_[lockFilePath] = lease;
+      }
+      END_LOCK_MUTEX
+   }
+
+   void deregisterLease(const FilePath& lockFilePath)
+   {
+      LOCK_MUTEX(mutex_)
+      {
+         leases_.erase(lockFilePath);
+      }
+      END_LOCK_MUTEX
+   }
+
+   void refreshLeases()
+   {
+      LOCK_MUTEX(mutex_)
+      {
+         for (std::map<FilePath, Lease>::iterator
+                 it = leases_.begin(); it != leases_.end(); ++it)
+         {
+            LOG("Renewing lease: " << it->first.getAbsolutePath());
+            it->second.expiryMs = nowMs() + leaseDurationMs();
+            if (!writeLease(it->first, it->second))
+            {
+               // our lease expired and someone else claimed the lock;
+               // log loudly (this implies the refresh period was longer
+               // than the lease, or the process was suspended)
+               LOG("WARNING: Lost lease: " << it->first.getAbsolutePath());
+            }
+         }
+      }
+      END_LOCK_MUTEX
+   }
+
+   void clearLeases()
+   {
+      LOCK_MUTEX(mutex_)
+      {
+         for (std::map<FilePath, Lease>::iterator
+                 it = leases_.begin(); it != leases_.end(); ++it)
+         {
+            Error error = it->first.removeIfExists();
+            if (error)
+               LOG_ERROR(error);
+            LOG("Clearing lease: " << it->first.getAbsolutePath());
+         }
+         leases_.clear();
+      }
+      END_LOCK_MUTEX
+   }
+
+private:
+
+   boost::mutex mutex_;
+   std::map<FilePath, Lease> leases_;
+};
+
+LeaseRegistration& leaseRegistration()
+{
+   static LeaseRegistration instance;
+   return instance;
+}
+
+} // end anonymous namespace
+
+bool LeaseBasedFileLock::isLockFileStale(const FilePath& lockFilePath)
+{
+   Lease lease;
+   if (readLease(lockFilePath, &lease))
+      return nowMs() >= lease.expiryMs;
+
+   // an unparsable lock file (e.g. written by another lock type, or a
+   // partial write from a crashed process) falls back to the mtime check
+   // used by link-based locks
+   double seconds = static_cast<double>(s_timeoutInterval.total_seconds());
+   double diff = ::difftime(::time(nullptr), lockFilePath.getLastWriteTime());
+   return diff >= seconds;
+}
+
+struct LeaseBasedFileLock::Impl
+{
+   FilePath lockFilePath;
+};
+
+LeaseBasedFileLock::LeaseBasedFileLock()
+   : pImpl_(new Impl())
+{
+}
+
+LeaseBasedFileLock::~LeaseBasedFileLock()
+{
+}
+
+FilePath LeaseBasedFileLock::lockFilePath() const
+{
+   return pImpl_->lockFilePath;
+}
+
+bool LeaseBasedFileLock::isLocked(const FilePath& lockFilePath) const
+{
+   if (!lockFilePath.exists())
+      return false;
+
+   return !isLockFileStale(lockFilePath);
+}
+
+Error LeaseBasedFileLock::acquire(const FilePath& lockFilePath)
+{
+   using namespace boost::system;
+
+#ifndef _WIN32
+
+   // ensure the parent directory exists
+   Error error = lockFilePath.getParent().ensureDirectory();
+   if (error)
+      return error;
+
+   Lease lease;
+   lease.epoch = 1;
+   lease.uuid = core::system::generateUuid(false);
+   lease.hostName = hostName();
+   lease.pid = (long) ::getpid();
+   lease.expiryMs = nowMs() + leaseDurationMs();
+
+   // fast path: exclusive create of the lock file -- when there's no
+   // competing lease, acquisition is this single write
+   std::string contents = formatLease(lease);
+   int fd = ::open(lockFilePath.getAbsolutePathNative().c_str(),
+                   O_WRONLY | O_CREAT | O_EXCL,
+                   0755);
+   if (fd != -1)
+   {
+      int status = ::write(fd, contents.c_str(), contents.size());
+      int errorNumber = errno;
+      ::close(fd);
+      if (status == -1)
+      {
+         Error error = systemError(errorNumber, ERROR_LOCATION);
+         error.addProperty("lock-file", lockFilePath);
+         return error;
+      }
+
+      pImpl_->lockFilePath = lockFilePath;
+      leaseRegistration().registerLease(lockFilePath, lease);
+      LOG("Acquired lease: " << lockFilePath.getAbsolutePath());
+      return Success();
+   }
+
+   if (errno != EEXIST)
+   {
+      Error error = systemError(errno, ERROR_LOCATION);
+      error.addProperty("lock-file", lockFilePath);
+      return error;
+   }
+
+   // a lock file exists -- read the current lease and check it for
+   // staleness (constant time: just a comparison against the expiry)
+   Lease current;
+   bool haveLease = readLease(lockFilePath, &current);
+   if (haveLease && nowMs() < current.expiryMs)
+   {
+      LOG("No lease available: " << lockFilePath.getAbsolutePath());
+      Error error = systemError(errc::no_lock_available, ERROR_LOCATION);
+      error.addProperty("lock-file", lockFilePath);
+      return error;
+   }
+
+   if (!haveLease && !isLockFileStale(lockFilePath))
+   {
+      // unparsable but recently written -- treat as held
+      LOG("No lease available: " << lockFilePath.getAbsolutePath());
+      Error error = systemError(errc::no_lock_available, ERROR_LOCATION);
+      error.addProperty("lock-file", lockFilePath);
+      return error;
+   }
+
+   // the lease is stale: claim it at the next epoch. the atomic rename
+   // plus read-back in writeLease arbitrates competing claimants
+   lease.epoch = current.epoch + 1;
+   LOG("Claiming stale lease (epoch " << lease.epoch << "): "
+       << lockFilePath.getAbsolutePath());
+   if (!writeLease(lockFilePath, lease))
+   {
+      LOG("Failed to acquire lease: " << lockFilePath.getAbsolutePath());
+      Error error = systemError(errc::no_lock_available, ERROR_LOCATION);
+      error.addProperty("lock-file", lockFilePath);
+      return error;
+   }
+
+   pImpl_->lockFilePath = lockFilePath;
+   leaseRegistration().registerLease(lockFilePath, lease);
+   LOG("Acquired lease: " << lockFilePath.getAbsolutePath());
+   return Success();
+
+#else
+
+   // lease-based locks are not supported on Windows (advisory locks are
+   // the default there)
+   return systemError(errc::function_not_supported, ERROR_LOCATION);
+
+#endif
+}
+
+Error LeaseBasedFileLock::release()
+{
+   const FilePath& lockFilePath = pImpl_->lockFilePath;
+   LOG("Released lease: " << lockFilePath.getAbsolutePath());
+
+   Error error = lockFilePath.remove();
+   if (error)
+      LOG_ERROR(error);
+
+   leaseRegistration().deregisterLease(lockFilePath);
+   pImpl_->lockFilePath = FilePath();
+   return error;
+}
+
+void LeaseBasedFileLock::refresh()
+{
+   leaseRegistration().refreshLeases();
+}
+
+void LeaseBasedFileLock::cleanUp()
+{
+   leaseRegistration().clearLeases();
+}
+
+} // namespace core
+} // namespace rstudio
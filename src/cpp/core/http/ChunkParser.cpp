@@ -13,8 +13,9 @@
  *
  */
 
-#include <ios>
-#include <sstream>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
 
 #include <boost/make_shared.hpp>
 
@@ -32,15 +33,31 @@ bool ChunkParser::parse(const char* buffer, size_t len,
 
    while (buffer != end)
    {
-      char curChar = *buffer;
-
       switch (state_)
       {
          case HeaderSize:
-            if (curChar == '\r')
+         {
+            // bulk-scan for the end of the chunk-size line rather than
+            // stepping through it a byte at a time
+            const char* cr = static_cast<const char*>(
+                     ::memchr(buffer, '\r', end - buffer));
+            size_t span = (cr ? cr : end) - buffer;
+
+            // a bare LF in the size line is malformed
+            if (::memchr(buffer, '\n', span) != nullptr)
+            {
+               state_ = Invalid;
+               break;
+            }
+
+            chunkHeader_.append(buffer, span);
+            buffer += span;
+
+            if (cr)
             {
-               // calculate the chunk size
-               std::istringstream(chunkHeader_) >> std::hex >> chunkSize_;
+               // calculate the chunk size (strtoull stops at any chunk
+               // extension, like the stream extraction it replaces)
+               chunkSize_ = ::strtoull(chunkHeader_.c_str(), nullptr, 16);
                if (chunkSize_ == 0)
                {
                   state_ = Complete;
@@ -49,49 +66,70 @@ bool ChunkParser::parse(const char* buffer, size_t len,
                {
                   state_ = HeaderCRLF;
                }
-            }
-            else if (curChar == '\n')
-            {
-               state_ = Invalid;
-            }
-            else
-            {
-               chunkHeader_.append(1, curChar);
+
+               // consume the CR
+               buffer++;
             }
             break;
+         }
 
          case HeaderCRLF:
-            if (curChar != '\n')
+            if (*buffer != '\n')
             {
                state_ = Invalid;
             }
             else
             {
                state_ = Chunk;
+               buffer++;
             }
             break;
 
          case Chunk:
+         {
             if (!chunk_)
+            {
                chunk_ = boost::make_shared<std::string>();
 
-            chunk_->append(1, curChar);
+               // reserve no more than the bytes actually in hand so a
+               // malicious chunk size can't trigger a huge allocation
+               chunk_->reserve(std::min(chunkSize_,
+                                        static_cast<size_t>(end - buffer)));
+            }
+
+            // copy as much of the chunk as this buffer holds in one go
+            size_t take = std::min(chunkSize_ - chunk_->size(),
+                                   static_cast<size_t>(end - buffer));
+            chunk_->append(buffer, take);
+            buffer += take;
+
             if (chunk_->size() == chunkSize_)
             {
                pOutChunks->push_back(chunk_);
                state_ = ChunkCRLF;
             }
             break;
+         }
 
          case ChunkCRLF:
-            if (curChar == '\n')
+         {
+            // skip ahead to the LF terminating the chunk
+            const char* lf = static_cast<const char*>(
+                     ::memchr(buffer, '\n', end - buffer));
+            if (lf == nullptr)
             {
+               buffer = end;
+            }
+            else
+            {
+               buffer = lf + 1;
                state_ = HeaderSize;
                chunkHeader_.clear();
                chunk_.reset();
                chunkSize_ = 0;
             }
             break;
+         }
 
          // invalid and complete cases signify that we are done parsing chunks
          case Invalid:
@@ -100,8 +138,6 @@ bool ChunkParser::parse(const char* buffer, size_t len,
          case Complete:
             return true;
       }
-
-      buffer++;
    }
 
    // more chunks to come
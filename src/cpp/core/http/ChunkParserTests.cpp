@@ -132,6 +132,33 @@ test_context("ChunkParserTests")
       CHECK(chunks.size() == 3);
       CHECK(*(chunks.at(2)) == chunk3);
    }
+
+   test_that("Can parse chunk data containing CRLF bytes")
+   {
+      std::string chunk = "data: line one\r\n\r\ndata: line two\r\n\r\n";
+
+      std::stringstream payload;
+      payload << std::hex << chunk.size() << "\r\n" << chunk << "\r\n" << chunkEnd;
+      std::string payloadStr = payload.str();
+
+      ChunkParser chunkParser;
+      std::deque<boost::shared_ptr<std::string> > chunks;
+
+      CHECK(chunkParser.parse(payloadStr.c_str(), payloadStr.size(), &chunks));
+      CHECK(chunks.size() == 1);
+      CHECK(*(chunks.at(0)) == chunk);
+   }
+
+   test_that("Stops parsing on a bare LF in the size line")
+   {
+      std::string payloadStr = "d\nHello, world!\r\n";
+
+      ChunkParser chunkParser;
+      std::deque<boost::shared_ptr<std::string> > chunks;
+
+      CHECK(chunkParser.parse(payloadStr.c_str(), payloadStr.size(), &chunks));
+      CHECK(chunks.size() == 0);
+   }
 }
 
 } // end namespace tests
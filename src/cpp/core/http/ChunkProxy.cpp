@@ -16,15 +16,24 @@
 #include <core/http/ChunkProxy.hpp>
 #include <core/http/Util.hpp>
 
+#include <sstream>
+#include <vector>
+
 namespace rstudio {
 namespace core {
 namespace http {
 
 namespace {
 
-bool isLastChunk(const std::string& chunk)
+// terminating CRLF shared by every chunk write
+const char kCrlf[] = "\r\n";
+
+std::string formatChunkHeader(std::size_t size)
 {
-   return chunk == "0\r\n\r\n";
+   // the chunk framing format is <Chunk size (hex)>CRLF
+   std::stringstream sstr;
+   sstr << std::hex << size << "\r\n";
+   return sstr.str();
 }
 
 } // anonymous namespace
@@ -47,11 +56,11 @@ void ChunkProxy::proxy(const boost::shared_ptr<IAsyncClient>& pServerConnection)
 }
 
 bool ChunkProxy::queueChunk(const http::Response& response,
-                            const std::string& chunk)
+                            const boost::shared_ptr<std::string>& chunk)
 {
    LOCK_MUTEX(mutex_)
    {
-      if (currentBufferSize_ + chunk.size() > maxBufferSize_)
+      if (currentBufferSize_ + chunk->size() > maxBufferSize_)
       {
          bufferFull_ = true;
 
@@ -62,10 +71,14 @@ bool ChunkProxy::queueChunk(const http::Response& response,
          return false;
       }
 
-      // queue the chunk
-      std::string formattedChunk = http::util::formatMessageAsHttpChunk(chunk);
-      currentBufferSize_ += formattedChunk.size();
-      writeBuffer_.emplace(std::move(formattedChunk));
+      // queue the chunk - only the framing header is generated here; the
+      // payload buffer is shared with the upstream connection rather than
+      // re-serialized into an intermediate string
+      QueuedChunk queuedChunk;
+      queuedChunk.header = formatChunkHeader(chunk->size());
+      queuedChunk.payload = chunk;
+      currentBufferSize_ += queuedChunk.header.size() + chunk->size() + 2;
+      writeBuffer_.emplace(std::move(queuedChunk));
 
       if (!wroteHeaders_)
       {
@@ -120,10 +133,17 @@ void ChunkProxy::writeChunk()
       return;
    }
 
-   const std::string& chunk = writeBuffer_.front();
+   const QueuedChunk& chunk = writeBuffer_.front();
 
-   boost::asio::const_buffers_1 buffer(chunk.c_str(), chunk.size());
-   pClientConnection_->asyncWrite(buffer,
+   // scatter/gather write - the framing and the shared payload buffer go
+   // out in a single write without being coalesced into one buffer
+   std::vector<boost::asio::const_buffer> buffers;
+   buffers.push_back(boost::asio::buffer(chunk.header));
+   if (!chunk.payload->empty())
+      buffers.push_back(boost::asio::buffer(*chunk.payload));
+   buffers.push_back(boost::asio::buffer(kCrlf, 2));
+
+   pClientConnection_->asyncWrite(buffers,
                                   boost::bind(&ChunkProxy::onChunkWrote,
                                               shared_from_this(),
                                               boost::asio::placeholders::error));
@@ -136,9 +156,11 @@ void ChunkProxy::onChunkWrote(const boost::system::error_code& ec)
 
    LOCK_MUTEX(mutex_)
    {
-      const std::string& chunk = writeBuffer_.front();
-      bool lastChunk = isLastChunk(chunk);
-      currentBufferSize_ -= writeBuffer_.front().size();
+      const QueuedChunk& chunk = writeBuffer_.front();
+
+      // an empty payload is the terminating chunk ("0\r\n\r\n")
+      bool lastChunk = chunk.payload->empty();
+      currentBufferSize_ -= chunk.header.size() + chunk.payload->size() + 2;
       writeBuffer_.pop();
 
       if (lastChunk)
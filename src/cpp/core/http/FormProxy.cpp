@@ -48,7 +48,7 @@ void FormProxy::onDownstreamConnected()
    END_LOCK_MUTEX
 }
 
-bool FormProxy::queueData(const std::string& data)
+bool FormProxy::queueData(std::string& data)
 {
    LOCK_MUTEX(mutex_)
    {
@@ -63,9 +63,9 @@ bool FormProxy::queueData(const std::string& data)
          return false;
       }
 
-      // queue the data
+      // queue the data - take ownership of the buffer rather than copying it
       currentBufferSize_ += data.size();
-      writeBuffer_.push(data);
+      writeBuffer_.push(std::move(data));
 
       if (writeBuffer_.size() == 1 && connectedDownstream_)
       {
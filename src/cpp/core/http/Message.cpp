@@ -40,6 +40,9 @@ void Message::setHttpVersion(int httpVersionMajor, int httpVersionMinor)
 {
    httpVersionMajor_ = httpVersionMajor;
    httpVersionMinor_ = httpVersionMinor;
+
+   // invalidate the cached version string (rebuilt lazily on write)
+   httpVersion_.clear();
 }
 
 void Message::setContentType(const std::string& contentType) 
@@ -184,14 +187,13 @@ void appendHeader(const Header& header,
 
 std::vector<boost::asio::const_buffer> Message::toBuffers(
                                           const Header& overrideHeader) const
-{  
-   // buffers to return
+{
+   // buffers to return; build the header sequence in place (rather than
+   // through an intermediate vector) and reference the body directly, so
+   // no contiguous join of the message is ever made
    std::vector<boost::asio::const_buffer> buffers;
-
-   // headers
-   std::vector<boost::asio::const_buffer> headerBuffs =
-         headerBuffers(overrideHeader);
-   buffers.insert(buffers.end(), headerBuffs.begin(), headerBuffs.end());
+   buffers.reserve(4 * headers_.size() + 12);
+   appendHeaderBuffers(buffers, overrideHeader);
 
    // body
    buffers.push_back(boost::asio::buffer(body_));
@@ -205,7 +207,15 @@ std::vector<boost::asio::const_buffer> Message::headerBuffers(
 {
    // buffers to return
    std::vector<boost::asio::const_buffer> buffers;
+   buffers.reserve(4 * headers_.size() + 11);
+   appendHeaderBuffers(buffers, overrideHeader);
+   return buffers;
+}
 
+void Message::appendHeaderBuffers(
+      std::vector<boost::asio::const_buffer>& buffers,
+      const Header& overrideHeader) const
+{
    // call subclass to append first line
    appendFirstLineBuffers(buffers);
    buffers.push_back(boost::asio::buffer(CrLf));
@@ -228,9 +238,6 @@ std::vector<boost::asio::const_buffer> Message::headerBuffers(
 
    // empty line
    buffers.push_back(boost::asio::buffer(CrLf));
-
-   // return the buffers
-   return buffers;
 }
 
    
@@ -243,9 +250,15 @@ void Message::appendSpaceBuffer(
 void Message::appendHttpVersionBuffers(
       std::vector<boost::asio::const_buffer>& buffers) const
 {
-   std::ostringstream httpVersionStream;
-   httpVersionStream << "HTTP/" << httpVersionMajor_ << "." << httpVersionMinor_;
-   httpVersion_ = httpVersionStream.str();
+   // rebuild the cached version string only when needed (setHttpVersion
+   // invalidates it); this runs for every message written
+   if (httpVersion_.empty())
+   {
+      httpVersion_ = "HTTP/" +
+                     safe_convert::numberToString(httpVersionMajor_) +
+                     "." +
+                     safe_convert::numberToString(httpVersionMinor_);
+   }
    buffers.push_back(boost::asio::buffer(httpVersion_));
 }
 
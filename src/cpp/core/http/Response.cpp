@@ -16,6 +16,7 @@
 #include <core/http/Response.hpp>
 
 #include <algorithm>
+#include <map>
 #include <gsl/gsl>
 
 #include <boost/regex.hpp>
@@ -26,12 +27,15 @@
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/asio/buffer.hpp>
 
+#include <shared_core/SafeConvert.hpp>
+
 #include <core/http/URL.hpp>
 #include <core/http/Util.hpp>
 #include <core/http/Cookie.hpp>
 #include <core/Hash.hpp>
 #include <core/RegexUtils.hpp>
 #include <core/FileSerializer.hpp>
+#include <core/Thread.hpp>
 
 #ifndef _WIN32
 #include "zlib.h"
@@ -47,6 +51,35 @@ namespace {
 #define kDeflateWindow 15
 #define kDefaultMemoryUsage 8
 
+// bodies smaller than this are sent as-is; compressing them costs more
+// cpu than the handful of bytes saved on the wire
+#define kMinimumCompressibleSize 1024
+
+// cache of file content hashes used for eTag revalidation - keyed by
+// absolute path and invalidated when the file's size or mtime changes,
+// so repeated downloads of an unchanged file don't re-hash it
+struct FileETag
+{
+   std::time_t lastWriteTime;
+   uintmax_t size;
+   std::string eTag;
+};
+
+boost::mutex s_eTagCacheMutex;
+std::map<std::string, FileETag> s_eTagCache;
+
+bool isCompressibleContentType(const std::string& contentType)
+{
+   // media types that are not already compressed and so benefit from
+   // content encoding (images, archives, etc. gain nothing)
+   return boost::algorithm::starts_with(contentType, "text/") ||
+          boost::algorithm::starts_with(contentType, "application/json") ||
+          boost::algorithm::starts_with(contentType, "application/javascript") ||
+          boost::algorithm::starts_with(contentType, "application/x-javascript") ||
+          boost::algorithm::starts_with(contentType, "application/xml") ||
+          boost::algorithm::starts_with(contentType, "image/svg+xml");
+}
+
 std::shared_ptr<StreamBuffer> makePaddingBuffer(size_t numPadding)
 {
    // create a padding buffer
@@ -453,6 +486,44 @@ Error Response::setCacheableBody(const FilePath& filePath,
    return setCacheableBody(content, request);
 }
 
+void Response::negotiateContentEncoding(const Request& request)
+{
+#ifndef _WIN32
+   // nothing to do if the handler already chose an encoding, or if the
+   // body streams to the client (streaming paths negotiate on their own)
+   if (!contentEncoding().empty() || isStreamResponse())
+      return;
+
+   // only compress bodies that are large enough to benefit and whose
+   // media type is not already compressed
+   if (body().length() < kMinimumCompressibleSize)
+      return;
+
+   if (!isCompressibleContentType(contentType()))
+      return;
+
+   if (!request.acceptsEncoding(kGzipEncoding))
+      return;
+
+   // re-encode the existing body with gzip (setBody compresses when the
+   // Content-Encoding header is set)
+   std::string uncompressed;
+   uncompressed.swap(body_);
+   setContentEncoding(kGzipEncoding);
+   Error error = setBody(uncompressed);
+   if (error)
+   {
+      // compression failed - fall back to the uncompressed body
+      LOG_ERROR(error);
+      setBodyUnencoded(uncompressed);
+      return;
+   }
+
+   // let intermediaries know the body varies with the requested encoding
+   setHeader("Vary", "Accept-Encoding");
+#endif
+}
+
 void Response::setDynamicHtml(const std::string& html,
                               const Request& request)
 {
@@ -471,6 +542,19 @@ void Response::setDynamicHtml(const std::string& html,
 void Response::setRangeableFile(const FilePath& filePath,
                                 const Request& request)
 {
+   // use the (cached) content hash for revalidation so repeated fetches
+   // of unchanged content can be answered with a 304
+   std::string eTag = eTagForFile(filePath);
+   if (!eTag.empty())
+   {
+      setHeader("ETag", eTag);
+      if (eTag == request.headerValue("If-None-Match"))
+      {
+         setStatusCode(status::NotModified);
+         return;
+      }
+   }
+
    // read the file in from disk
    std::string contents;
    Error error = core::readStringFromFile(filePath, &contents);
@@ -480,6 +564,17 @@ void Response::setRangeableFile(const FilePath& filePath,
       return;
    }
 
+   // if the client is resuming from a stale copy of the file then ignore
+   // the range and respond with the full entity
+   std::string ifRange = request.headerValue("If-Range");
+   if (!ifRange.empty() && ifRange != eTag)
+   {
+      setContentType(filePath.getMimeContentType());
+      setHeader("Accept-Ranges", "bytes");
+      setBody(std::move(contents));
+      return;
+   }
+
    setRangeableFile(contents, filePath.getMimeContentType(), request);
 }
 
@@ -490,8 +585,22 @@ void Response::setRangeableFile(const std::string& contents,
    // set content type
    setContentType(mimeType);
 
-   // parse the range field
+   // let clients know that interrupted downloads can be resumed
+   setHeader("Accept-Ranges", "bytes");
+
+   // no range requested - serve the full entity
    std::string range = request.headerValue("Range");
+   if (range.empty())
+   {
+      // always attempt gzip
+      if (request.acceptsEncoding(http::kGzipEncoding))
+         setContentEncoding(http::kGzipEncoding);
+
+      setBody(contents);
+      return;
+   }
+
+   // parse the range field
    boost::regex re("bytes=(\\d*)\\-(\\d*)");
    boost::smatch match;
    if (regex_utils::match(range, match, re))
@@ -516,7 +625,6 @@ void Response::setRangeableFile(const std::string& contents,
       }
 
       // set the byte range
-      addHeader("Accept-Ranges", "bytes");
       boost::format fmt("bytes %1%-%2%/%3%");
       std::string range = boost::str(fmt % begin % end % contents.length());
       addHeader("Content-Range", range);
@@ -634,16 +742,62 @@ void Response::removeCachingHeaders()
 std::string Response::eTagForContent(const std::string& content)
 {
    return core::hash::crc32Hash(content);
-}   
+}
+
+std::string Response::eTagForFile(const FilePath& filePath)
+{
+   if (!filePath.exists())
+      return std::string();
+
+   std::time_t lastWriteTime = filePath.getLastWriteTime();
+   uintmax_t size = filePath.getSize();
+
+   // check for a cached hash for this version of the file
+   LOCK_MUTEX(s_eTagCacheMutex)
+   {
+      std::map<std::string, FileETag>::const_iterator it =
+            s_eTagCache.find(filePath.getAbsolutePath());
+      if (it != s_eTagCache.end() &&
+          it->second.lastWriteTime == lastWriteTime &&
+          it->second.size == size)
+      {
+         return it->second.eTag;
+      }
+   }
+   END_LOCK_MUTEX
+
+   // hash the file contents (outside the lock - hashing can be slow)
+   std::string contents;
+   Error error = core::readStringFromFile(filePath, &contents);
+   if (error)
+   {
+      LOG_ERROR(error);
+      return std::string();
+   }
+   std::string eTag = eTagForContent(contents);
+
+   LOCK_MUTEX(s_eTagCacheMutex)
+   {
+      // keep the cache from growing without bound
+      if (s_eTagCache.size() >= 100)
+         s_eTagCache.clear();
+
+      FileETag& entry = s_eTagCache[filePath.getAbsolutePath()];
+      entry.lastWriteTime = lastWriteTime;
+      entry.size = size;
+      entry.eTag = eTag;
+   }
+   END_LOCK_MUTEX
+
+   return eTag;
+}
 
 void Response::appendFirstLineBuffers(
       std::vector<boost::asio::const_buffer>& buffers) const 
 {
    // create status code string (needs to be a member so memory is still valid
    // for use of buffers)
-   std::ostringstream statusCodeStream;
-   statusCodeStream << statusCode_;
-   statusCodeStr_ = statusCodeStream.str();
+   statusCodeStr_ = safe_convert::numberToString(statusCode_);
 
    // status line 
    appendHttpVersionBuffers(buffers);
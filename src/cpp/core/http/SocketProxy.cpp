@@ -44,46 +44,92 @@ namespace http {
 
 void SocketProxy::readClient()
 {
-   ptrClient_->asyncReadSome(
-        boost::asio::buffer(clientBuffer_),
+   LOCK_MUTEX(socketMutex_)
+   {
+      startRead(clientToServer_);
+   }
+   END_LOCK_MUTEX
+}
+
+void SocketProxy::readServer()
+{
+   LOCK_MUTEX(socketMutex_)
+   {
+      startRead(serverToClient_);
+   }
+   END_LOCK_MUTEX
+}
+
+void SocketProxy::startRead(Direction& direction)
+{
+   // read into the next free buffer in the ring (one past the filled
+   // buffers, wrapping)
+   std::size_t target = (direction.writeIndex + direction.filledCount) %
+                        Direction::kNumBuffers;
+   direction.reading = true;
+   direction.ptrSource->asyncReadSome(
+        boost::asio::buffer(direction.buffers[target]),
          boost::bind(
-            &SocketProxy::handleClientRead,
+            direction.readHandler,
             SocketProxy::shared_from_this(),
             boost::asio::placeholders::error,
             boost::asio::placeholders::bytes_transferred));
 }
 
-void SocketProxy::readServer()
+void SocketProxy::startWrite(Direction& direction)
 {
-   ptrServer_->asyncReadSome(
-        boost::asio::buffer(serverBuffer_),
+   // drain every filled buffer in a single vectored write (chunks
+   // accumulate whenever the destination is slower than the source)
+   direction.writeBuffers.clear();
+   direction.writingCount = direction.filledCount;
+   for (std::size_t i = 0; i < direction.writingCount; i++)
+   {
+      std::size_t index = (direction.writeIndex + i) %
+                          Direction::kNumBuffers;
+      direction.writeBuffers.push_back(
+            boost::asio::buffer(direction.buffers[index].data(),
+                                direction.lengths[index]));
+   }
+
+   direction.ptrDest->asyncWrite(
+         direction.writeBuffers,
          boost::bind(
-            &SocketProxy::handleServerRead,
+            direction.writeHandler,
             SocketProxy::shared_from_this(),
             boost::asio::placeholders::error,
             boost::asio::placeholders::bytes_transferred));
 }
 
-void SocketProxy::handleClientRead(const boost::system::error_code& e,
-                                   std::size_t bytesTransferred)
+void SocketProxy::handleRead(Direction& direction,
+                             const boost::system::error_code& e,
+                             std::size_t bytesTransferred)
 {
    // client and server reads can happen simultaneously on two threads; a race
    // condition during close can lead to the socket not getting properly
    // shut down. use a simple mutex to prevent the threads from simultaneously
-   // writing to the socket state.
+   // writing to the socket state (it also guards the buffer ring).
    LOCK_MUTEX(socketMutex_)
    {
       if (!e)
       {
-         std::vector<boost::asio::const_buffer> buffers;
-         buffers.push_back(boost::asio::buffer(clientBuffer_.data(),
-                                               bytesTransferred));
-         ptrServer_->asyncWrite(buffers,
-                                boost::bind(
-                                   &SocketProxy::handleServerWrite,
-                                   SocketProxy::shared_from_this(),
-                                   boost::asio::placeholders::error,
-                                   boost::asio::placeholders::bytes_transferred));
+         // mark the buffer we just read into as filled
+         std::size_t target = (direction.writeIndex +
+                               direction.filledCount) %
+                              Direction::kNumBuffers;
+         direction.lengths[target] = bytesTransferred;
+         direction.filledCount++;
+         direction.reading = false;
+
+         // kick off a write unless one is already in flight (in which
+         // case its completion will pick this chunk up)
+         if (direction.writingCount == 0)
+            startWrite(direction);
+
+         // keep reading while a free buffer remains; otherwise the
+         // pending write completion restarts the read, which exerts
+         // natural backpressure on a fast source
+         if (direction.filledCount < Direction::kNumBuffers)
+            startRead(direction);
       }
       else
       {
@@ -93,22 +139,28 @@ void SocketProxy::handleClientRead(const boost::system::error_code& e,
    END_LOCK_MUTEX
 }
 
-void SocketProxy::handleServerRead(const boost::system::error_code& e,
-                                   std::size_t bytesTransferred)
+void SocketProxy::handleWrite(Direction& direction,
+                              const boost::system::error_code& e)
 {
    LOCK_MUTEX(socketMutex_)
    {
       if (!e)
       {
-         std::vector<boost::asio::const_buffer> buffers;
-         buffers.push_back(boost::asio::buffer(serverBuffer_.data(),
-                                               bytesTransferred));
-         ptrClient_->asyncWrite(buffers,
-                                boost::bind(
-                                   &SocketProxy::handleClientWrite,
-                                   SocketProxy::shared_from_this(),
-                                   boost::asio::placeholders::error,
-                                   boost::asio::placeholders::bytes_transferred));
+         // retire the buffers covered by the completed write
+         direction.writeIndex = (direction.writeIndex +
+                                 direction.writingCount) %
+                                Direction::kNumBuffers;
+         direction.filledCount -= direction.writingCount;
+         direction.writingCount = 0;
+
+         // flush anything which arrived while we were writing
+         if (direction.filledCount > 0)
+            startWrite(direction);
+
+         // restart the read if it stalled waiting for a free buffer
+         if (!direction.reading &&
+             direction.filledCount < Direction::kNumBuffers)
+            startRead(direction);
       }
       else
       {
@@ -118,30 +170,28 @@ void SocketProxy::handleServerRead(const boost::system::error_code& e,
    END_LOCK_MUTEX
 }
 
+void SocketProxy::handleClientRead(const boost::system::error_code& e,
+                                   std::size_t bytesTransferred)
+{
+   handleRead(clientToServer_, e, bytesTransferred);
+}
+
+void SocketProxy::handleServerRead(const boost::system::error_code& e,
+                                   std::size_t bytesTransferred)
+{
+   handleRead(serverToClient_, e, bytesTransferred);
+}
+
 void SocketProxy::handleClientWrite(const boost::system::error_code& e,
                                     std::size_t bytesTransferred)
 {
-   if (!e)
-   {
-      readServer();
-   }
-   else
-   {
-      handleError(e, ERROR_LOCATION);
-   }
+   handleWrite(serverToClient_, e);
 }
 
 void SocketProxy::handleServerWrite(const boost::system::error_code& e,
                                     std::size_t bytesTransferred)
 {
-   if (!e)
-   {
-      readClient();
-   }
-   else
-   {
-      handleError(e, ERROR_LOCATION);
-   }
+   handleWrite(clientToServer_, e);
 }
 
 void SocketProxy::handleError(const boost::system::error_code& e,
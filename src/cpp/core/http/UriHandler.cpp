@@ -127,20 +127,50 @@ void UriHandler::operator()(const Request& request,
    boost::apply_visitor(visitor, function_);
 }
    
-void UriHandlers::add(const UriHandler& handler) 
+void UriHandlers::add(const UriHandler& handler)
 {
    uriHandlers_.push_back(handler);
+
+   // index the handler's prefix into the dispatch trie. when prefixes
+   // nest, the first registered handler must win (as it did under the
+   // linear scan), so a terminal node keeps its earliest index
+   std::size_t node = 0;
+   for (char ch : handler.prefix())
+   {
+      std::map<char, std::size_t>::iterator it = trie_[node].children.find(ch);
+      if (it == trie_[node].children.end())
+      {
+         trie_.push_back(TrieNode());
+         it = trie_[node].children.insert(
+                  std::make_pair(ch, trie_.size() - 1)).first;
+      }
+      node = it->second;
+   }
+   if (trie_[node].handlerIndex == TrieNode::kNoHandler)
+      trie_[node].handlerIndex = uriHandlers_.size() - 1;
 }
 
 boost::optional<UriAsyncHandlerFunctionVariant> UriHandlers::handlerFor(const std::string& uri) const
 {
-   std::vector<UriHandler>::const_iterator handler = std::find_if(
-                              uriHandlers_.begin(), 
-                              uriHandlers_.end(), 
-                              boost::bind(&UriHandler::matches, _1, uri));
-   if ( handler != uriHandlers_.end() )
+   // walk the uri through the trie, tracking the earliest-registered
+   // handler among all of the prefixes it matches
+   std::size_t best = trie_[0].handlerIndex; // an empty prefix matches all
+   std::size_t node = 0;
+   for (char ch : uri)
+   {
+      std::map<char, std::size_t>::const_iterator it =
+                                                trie_[node].children.find(ch);
+      if (it == trie_[node].children.end())
+         break;
+
+      node = it->second;
+      if (trie_[node].handlerIndex < best)
+         best = trie_[node].handlerIndex;
+   }
+
+   if (best != TrieNode::kNoHandler)
    {
-      return handler->function();
+      return uriHandlers_[best].function();
    }
    else
    {
@@ -0,0 +1,38 @@
+/*
+ * Compression.hpp
+ *
+ * Copyright (C) 2020 by RStudio, PBC
+ *
+ * Unless you have received this program directly from RStudio pursuant
+ * to the terms of a commercial license agreement with RStudio, then
+ * this program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ *
+ */
+
+#ifndef CORE_COMPRESSION_HPP
+#define CORE_COMPRESSION_HPP
+
+#include <shared_core/Error.hpp>
+#include <shared_core/FilePath.hpp>
+
+namespace rstudio {
+namespace core {
+namespace compression {
+
+// compress a file into gzip format. when more than one thread is
+// requested the input is divided into blocks which are compressed
+// concurrently and emitted as concatenated gzip members (a valid gzip
+// stream, readable by any gzip decompressor)
+core::Error gzipCompressFile(const core::FilePath& sourceFilePath,
+                             const core::FilePath& destinationFilePath,
+                             int threads = 1);
+
+} // namespace compression
+} // namespace core
+} // namespace rstudio
+
+#endif // CORE_COMPRESSION_HPP
@@ -19,6 +19,11 @@
 #include <core/Thread.hpp>
 #include <shared_core/FilePath.hpp>
 
+#include <future>
+#include <map>
+#include <vector>
+
+#include <boost/function.hpp>
 #include <boost/optional.hpp>
 #include <boost/shared_ptr.hpp>
 #include <boost/variant.hpp>
@@ -75,28 +80,28 @@ public:
    template <typename T>
    Query& withInput(const T& val)
    {
-      statement_.exchange(soci::use(val));
+      statement_->exchange(soci::use(val));
       return *this;
    }
 
    template <typename T>
    Query& withInput(const T& val, const std::string& varName)
    {
-      statement_.exchange(soci::use(val, varName));
+      statement_->exchange(soci::use(val, varName));
       return *this;
    }
 
    template <typename T>
    Query& withOutput(T& out)
    {
-      statement_.exchange(soci::into(out));
+      statement_->exchange(soci::into(out));
       return *this;
    }
 
    template <typename T>
    Query& withOutput(T& out, const std::string& varName)
    {
-      statement_.exchange(soci::into(out, varName));
+      statement_->exchange(soci::into(out, varName));
       return *this;
    }
 
@@ -104,7 +109,10 @@ private:
    friend class Connection;
    friend class Rowset;
 
-   soci::statement statement_;
+   // construct a query around a previously prepared (cached) statement
+   explicit Query(const boost::shared_ptr<soci::statement>& statement);
+
+   boost::shared_ptr<soci::statement> statement_;
    boost::optional<soci::soci_error> prepareError_;
 };
 
@@ -137,6 +145,12 @@ public:
 
    virtual Error executeStr(const std::string& queryStr) = 0;
 
+   // execute a group of queries as one unit of work within a single
+   // transaction, committing once at the end (or rolling back on the
+   // first error) rather than paying a commit per statement - use for
+   // batched writes such as multi-row upserts
+   Error executeBatch(std::vector<Query>& queries);
+
    Driver driver() const
    {
       std::string driverStr = driverName();
@@ -181,6 +195,11 @@ private:
               const std::string& connectionStr);
 
    soci::session session_;
+
+   // cache of prepared statements keyed by sql text, letting repeated
+   // queries skip statement allocation and preparation. declared after
+   // the session so the statements are destroyed before it
+   std::map<std::string, boost::shared_ptr<soci::statement>> statementCache_;
 };
 
 class PooledConnection : public IConnection
@@ -225,15 +244,39 @@ public:
    bool getConnection(const boost::posix_time::time_duration& maxWait,
                       boost::shared_ptr<IConnection>* pConnection);
 
+   // execute database work against a pool connection on a background
+   // thread, returning a future for its result. use this for queries
+   // whose round trip must not stall the calling thread - wait on the
+   // future with wait_for to bound how long the caller will block
+   std::future<Error> executeAsync(
+         const boost::function<Error(const boost::shared_ptr<IConnection>&)>& work);
+
 private:
    friend class PooledConnection;
    friend Error createConnectionPool(size_t poolSize,
                                      const ConnectionOptions& options,
                                      boost::shared_ptr<ConnectionPool>* pPool);
 
+   // pool entries remember when they were returned so that connections
+   // which sat idle long enough to go stale (e.g. dropped by a database
+   // server restart or an idle timeout) are health checked on checkout
+   struct PooledEntry
+   {
+      PooledEntry() {}
+      explicit PooledEntry(const boost::shared_ptr<Connection>& connection);
+
+      boost::shared_ptr<Connection> connection;
+      boost::posix_time::ptime returnTime;
+   };
+
    void returnConnection(const boost::shared_ptr<Connection>& connection);
 
-   thread::ThreadsafeQueue<boost::shared_ptr<Connection>> connections_;
+   // validate a connection dequed from the pool, replacing it with a
+   // freshly established one when the health check fails
+   boost::shared_ptr<Connection> checkConnection(const PooledEntry& entry);
+
+   ConnectionOptions options_;
+   thread::ThreadsafeQueue<PooledEntry> connections_;
 };
 
 class Transaction
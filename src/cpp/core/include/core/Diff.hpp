@@ -0,0 +1,77 @@
+/*
+ * Diff.hpp
+ *
+ * Copyright (C) 2020 by RStudio, PBC
+ *
+ * Unless you have received this program directly from RStudio pursuant
+ * to the terms of a commercial license agreement with RStudio, then
+ * this program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ *
+ */
+
+#ifndef CORE_DIFF_HPP
+#define CORE_DIFF_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace rstudio {
+namespace core {
+namespace diff {
+
+// a single contiguous line-level edit: lines
+// [fromStart, fromStart + fromCount) of the original text are replaced
+// by lines [toStart, toStart + toCount) of the new text (fromCount is 0
+// for a pure insertion, toCount is 0 for a pure deletion). edits are
+// reported in ascending order and never overlap
+struct Edit
+{
+   Edit(std::size_t fromStart,
+        std::size_t fromCount,
+        std::size_t toStart,
+        std::size_t toCount)
+      : fromStart(fromStart),
+        fromCount(fromCount),
+        toStart(toStart),
+        toCount(toCount)
+   {
+   }
+
+   std::size_t fromStart;
+   std::size_t fromCount;
+   std::size_t toStart;
+   std::size_t toCount;
+};
+
+// split text into lines for diffing (a trailing newline terminates the
+// final line rather than beginning an empty one)
+std::vector<std::string> splitDiffLines(const std::string& text);
+
+// compute a line-level edit script transforming fromLines into toLines
+// (Myers' O(ND) algorithm over interned line identifiers, with a cost
+// cap which trades minimality for bounded running time on inputs with
+// very large edit distances)
+std::vector<Edit> diffLines(const std::vector<std::string>& fromLines,
+                            const std::vector<std::string>& toLines);
+
+// render a unified-format diff of the given texts (the same format
+// produced by diff -u, so the result is suitable both for display and
+// for patch application). fromFile and toFile are used verbatim in the
+// --- and +++ header lines. returns an empty string when the texts are
+// identical
+std::string unifiedDiff(const std::string& fromFile,
+                        const std::string& fromText,
+                        const std::string& toFile,
+                        const std::string& toText,
+                        int contextLines = 3);
+
+} // namespace diff
+} // namespace core
+} // namespace rstudio
+
+#endif // CORE_DIFF_HPP
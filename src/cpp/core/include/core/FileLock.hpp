@@ -43,7 +43,7 @@ class FileLock : boost::noncopyable
 {
 public:
    
-   enum LockType { LOCKTYPE_ADVISORY, LOCKTYPE_LINKBASED };
+   enum LockType { LOCKTYPE_ADVISORY, LOCKTYPE_LINKBASED, LOCKTYPE_LEASEBASED };
    
    // initialize (read configuration)
    static void initialize();
@@ -145,6 +145,31 @@ private:
    boost::scoped_ptr<Impl> pImpl_;
 };
 
+// lease-based locks hold the lock as a single file carrying a monotonic
+// epoch and a lease expiry, refreshed by heartbeat. staleness is detected
+// in constant time from the lease expiry (no process liveness probes and
+// no per-acquire directory scans), so acquisition on shared storage is a
+// bounded number of file operations. select with 'lock-type=leasebased'
+class LeaseBasedFileLock : public FileLock
+{
+public:
+   static bool isLockFileStale(const FilePath& lockFilePath);
+   static void refresh();
+   static void cleanUp();
+
+   Error acquire(const FilePath& lockFilePath);
+   Error release();
+   bool isLocked(const FilePath& lockFilePath) const;
+   FilePath lockFilePath() const;
+
+   LeaseBasedFileLock();
+   ~LeaseBasedFileLock();
+
+private:
+   struct Impl;
+   boost::scoped_ptr<Impl> pImpl_;
+};
+
 // ScopedFileLock for acquiring a lock on construction
 // and ensuring the lock is released on destruction
 class ScopedFileLock : boost::noncopyable
@@ -276,6 +276,11 @@ Error readStructVectorFromFile(const core::FilePath& filePath,
 ReadCollectionAction parseString(const std::string& line, std::string* pStr);
 std::string stringifyString(const std::string& str);
 
+ReadCollectionAction parseStringPair(
+                     const std::string& line,
+                     std::pair<const std::string,std::string>* pPair);
+std::string stringifyStringPair(const std::pair<std::string,std::string>& pair);
+
       
 Error writeStringMapToFile(const core::FilePath& filePath,
                            const std::map<std::string,std::string>& map);
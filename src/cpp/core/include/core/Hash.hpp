@@ -16,16 +16,58 @@
 #ifndef CORE_HASH_HPP
 #define CORE_HASH_HPP
 
+#include <cstddef>
 #include <string>
 
+#include <boost/cstdint.hpp>
+
+#include <shared_core/Error.hpp>
+
 namespace rstudio {
 namespace core {
+
+class FilePath;
+
 namespace hash {
-   
+
 std::string crc32Hash(const std::string& content);
 
 std::string crc32HexHash(const std::string& content);
 
+// fast non-cryptographic 64-bit hash (xxHash64). suitable for change
+// detection, fingerprinting, and hash tables -- not for security purposes
+boost::uint64_t hash64(const void* pData,
+                       std::size_t n,
+                       boost::uint64_t seed = 0);
+
+// convenience variant returning the hash in string form (analogous to
+// crc32Hash)
+std::string hash64Hash(const std::string& content);
+
+// streaming variant of hash64 -- feed data incrementally via append,
+// then call digest to retrieve the hash (equivalent to hashing the
+// concatenated input in one shot)
+class Hash64
+{
+public:
+   explicit Hash64(boost::uint64_t seed = 0);
+
+   void append(const void* pData, std::size_t n);
+   void append(const std::string& content);
+   boost::uint64_t digest() const;
+
+private:
+   boost::uint64_t v1_, v2_, v3_, v4_;
+   boost::uint64_t totalLength_;
+   boost::uint64_t seed_;
+   unsigned char buffer_[32];
+   std::size_t bufferSize_;
+};
+
+// hash the contents of a file, reading it in fixed-size chunks (so large
+// files are fingerprinted without being read into memory all at once)
+Error hashFile64(const FilePath& filePath, boost::uint64_t* pHash);
+
 } // namespace hash
 } // namespace core 
 } // namespace rstudio
@@ -58,6 +58,11 @@ public:
       }
    }
 
+   virtual boost::posix_time::ptime nextExecutionTime() const
+   {
+      return nextExecutionTime_;
+   }
+
    virtual boost::posix_time::time_duration period()
    {
       return period_;
@@ -33,6 +33,17 @@ class FilePath;
 
 namespace regex_utils {
    
+// return a compiled regex for the given pattern, serving repeated
+// requests for the same (pattern, flags) pair from a thread-safe
+// bounded LRU cache (compiling a boost::regex is expensive relative
+// to matching, so hot paths which build patterns at runtime should
+// prefer this over constructing a boost::regex per call). throws
+// boost::regex_error for invalid patterns, just like the boost::regex
+// constructor. the regex is returned by value; copies are cheap since
+// boost::regex shares its compiled representation.
+boost::regex cachedRegex(const std::string& pattern,
+                         boost::regex::flag_type flags = boost::regex::normal);
+
 // convert a pattern which includes wildcard (i.e. '*') characters
 // into a regulard expression
 boost::regex wildcardPatternToRegex(const std::string& pattern);
@@ -43,6 +43,15 @@ public:
 public:
    virtual void execute() = 0;
 
+   // earliest time at which execute() will actually perform work, so
+   // executors can skip commands whose deadline hasn't arrived. commands
+   // which want to run on every pass (e.g. incremental commands) return
+   // neg_infin, which is the default
+   virtual boost::posix_time::ptime nextExecutionTime() const
+   {
+      return boost::posix_time::ptime(boost::posix_time::neg_infin);
+   }
+
    bool finished() const { return finished_; }
 
 protected:
@@ -61,12 +61,22 @@ public:
 
 private:
    void writeSettings();
+   void appendSetting(const std::string& name, const std::string& value);
+
+   // the settings file is maintained as an append log (set() appends a
+   // single name=value line rather than rewriting the whole file); once
+   // superseded entries dominate the log it is compacted by a rewrite
+   std::size_t compactionThreshold() const
+   {
+      return settingsMap_.size() * 2 + 20;
+   }
 
 private:
    FilePath settingsFile_;
    std::map<std::string, std::string> settingsMap_;
    bool updatePending_;
    bool isDirty_;
+   std::size_t logEntries_;
 };
 
 }
@@ -99,6 +99,10 @@ void convertLineEndings(std::string* str, LineEnding type);
 
 bool detectLineEndings(const FilePath& filePath, LineEnding* pType);
 
+// Returns true if the string contains only valid UTF-8; when it does, a
+// utf8Clean pass would be a no-op and can be skipped.
+bool isValidUtf8(const std::string& str);
+
 std::string filterControlChars(const std::string& str);
 
 bool parseVersion(const std::string& str, uint64_t* pVersion);
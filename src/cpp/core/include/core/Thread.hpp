@@ -305,6 +305,35 @@ private:
    std::queue<T> queue_;
 };
 
+// shared pool of background worker threads. tasks are executed in fifo
+// order; exceptions escaping a task are logged and the worker keeps
+// running. workers are started lazily on first use (with all signals
+// blocked, as with safeLaunchThread) and run for the life of the process
+class ThreadPool : boost::noncopyable
+{
+public:
+   explicit ThreadPool(std::size_t numThreads);
+   virtual ~ThreadPool() {}
+
+   // queue a task for execution (starts the workers on first use)
+   void enque(const boost::function<void()>& task);
+
+private:
+   void workerMain();
+
+private:
+   std::size_t numThreads_;
+   boost::mutex mutex_;
+   bool started_;
+   ThreadsafeQueue<boost::function<void()> > tasks_;
+};
+
+// process-wide pool for short-lived background tasks, shared so that
+// individual features don't each need to spawn (and wake) their own
+// threads. sized to the number of cores (bounded), so never queue a
+// task that blocks indefinitely -- launch a dedicated thread for those
+ThreadPool& backgroundThreadPool();
+
 void safeLaunchThread(boost::function<void()> threadMain,
                       boost::thread* pThread = nullptr);
       
@@ -16,6 +16,7 @@
 #ifndef CORE_HTTP_ASYNC_CLIENT_HPP
 #define CORE_HTTP_ASYNC_CLIENT_HPP
 
+#include <boost/array.hpp>
 #include <boost/shared_ptr.hpp>
 #include <boost/function.hpp>
 #include <boost/enable_shared_from_this.hpp>
@@ -63,7 +64,11 @@ namespace http {
 
 // chunked handler for reading chunked encoding chunks
 // ONLY used for responses that return chunked encoding
-typedef boost::function<bool(const http::Response&, const std::string&)> ChunkHandler;
+// the chunk payload is delivered as a shared_ptr so consumers (like the
+// chunk proxy) can hold onto the parsed buffer without copying it - an
+// empty payload signifies the final chunk
+typedef boost::function<bool(const http::Response&,
+                             const boost::shared_ptr<std::string>&)> ChunkHandler;
 
 typedef boost::function<void(const http::Response&)> ResponseHandler;
 typedef boost::function<void(const core::Error&)> ErrorHandler;
@@ -272,6 +277,23 @@ protected:
       }
    }
 
+   // the Connection header sent with the request. defaults to close;
+   // subclasses which pool their connections override this to negotiate
+   // keep-alive with the server
+   virtual Header connectionOverrideHeader()
+   {
+      return Header::connectionClose();
+   }
+
+   // give subclasses a chance to recover from an error (e.g. by
+   // reissuing the request on a fresh connection when a pooled
+   // connection turns out to be stale). returns true if the subclass
+   // initiated recovery and normal error handling should be skipped
+   virtual bool recoverFromError(const Error& error)
+   {
+      return false;
+   }
+
    // asynchronously write the request (called by subclasses after
    // they finish connecting)
    void writeRequest()
@@ -281,7 +303,7 @@ protected:
       Header overrideHeader;
       if (!util::isWSUpgradeRequest(request_))
       {
-         overrideHeader = Header::connectionClose();
+         overrideHeader = connectionOverrideHeader();
       }
 
       // write
@@ -306,6 +328,10 @@ protected:
       }
       END_LOCK_MUTEX
 
+      // let subclasses attempt recovery before we tear down
+      if (recoverFromError(error))
+         return;
+
       // close the socket
       close();
 
@@ -516,13 +542,30 @@ private:
          return;
       }
 
-      boost::asio::async_read(
-         socket(),
-         responseBuffer_,
-         boost::asio::transfer_at_least(1),
+      // chunked responses are parsed out of the streambuf
+      if (chunkedEncoding_)
+      {
+         boost::asio::async_read(
+            socket(),
+            responseBuffer_,
+            boost::asio::transfer_at_least(1),
+            boost::bind(&AsyncClient<SocketService>::handleReadContent,
+                        AsyncClient<SocketService>::shared_from_this(),
+                        boost::asio::placeholders::error,
+                        boost::asio::placeholders::bytes_transferred));
+         return;
+      }
+
+      // read non-chunked content directly into a flat buffer (appended
+      // to the body in handleReadContent) -- each read drains as much
+      // as is available rather than the small increments the streambuf
+      // doles out, so large bodies take far fewer reads
+      socket().async_read_some(
+         boost::asio::buffer(contentBuffer_),
          boost::bind(&AsyncClient<SocketService>::handleReadContent,
                      AsyncClient<SocketService>::shared_from_this(),
-                     boost::asio::placeholders::error));
+                     boost::asio::placeholders::error,
+                     boost::asio::placeholders::bytes_transferred));
    }
 
    virtual bool stopReadingAndRespond()
@@ -568,6 +611,12 @@ private:
             if (responseBuffer_.size() > 0)
                ResponseParser::appendToBody(&responseBuffer_, &response_);
 
+            // when the length is known, size the body up front so
+            // content reads append without reallocating
+            if (response_.containsHeader("Content-Length"))
+               ResponseParser::reserveBody(response_.contentLength(),
+                                           &response_);
+
             // start reading content
             readSomeContent();
          }
@@ -579,7 +628,8 @@ private:
       CATCH_UNEXPECTED_ASYNC_CLIENT_EXCEPTION
    }
 
-   void handleReadContent(const boost::system::error_code& ec)
+   void handleReadContent(const boost::system::error_code& ec,
+                          std::size_t bytesTransferred)
    {
       try
       {
@@ -594,7 +644,9 @@ private:
             }
 
             // copy content
-            ResponseParser::appendToBody(&responseBuffer_, &response_);
+            ResponseParser::appendToBody(contentBuffer_.data(),
+                                         bytesTransferred,
+                                         &response_);
 
             // continue reading content
             readSomeContent();
@@ -686,7 +738,7 @@ private:
 
          if (chunkHandler_)
          {
-            bool keepGoing = chunkHandler_(response_, *chunk);
+            bool keepGoing = chunkHandler_(response_, chunk);
 
             if (!keepGoing)
             {
@@ -729,7 +781,10 @@ private:
       if (responseHandler_ && (!chunkedEncoding_ || !chunkHandler_))
          responseHandler_(response_);
       else if (chunkHandler_)
-         chunkHandler_(response_, ""); // completion of chunks signified by empty chunk
+      {
+         // completion of chunks signified by empty chunk
+         chunkHandler_(response_, boost::make_shared<std::string>());
+      }
 
       // free handlers in case they keep a strong reference to us
       // this will allow us to properly clean up in that case
@@ -789,6 +844,9 @@ private:
    ErrorHandler errorHandler_;
    http::Request request_;
    boost::asio::streambuf responseBuffer_;
+   // flat read buffer for non-chunked content (sized to drain a typical
+   // rpc response in a single read)
+   boost::array<char, 65536> contentBuffer_;
    boost::shared_ptr<ChunkParser> chunkParser_;
    ChunkHandler chunkHandler_;
 
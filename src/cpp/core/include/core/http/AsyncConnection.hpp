@@ -64,6 +64,16 @@ public:
                               bool close = true,
                               const http::Headers& extraHeaders = http::Headers()) = 0;
 
+   // move-enabled variant - takes ownership of the response so large
+   // bodies (e.g. proxied responses) aren't copied again; the default
+   // implementation simply falls back to a copy
+   virtual void writeResponse(http::Response&& response,
+                              bool close = true,
+                              const http::Headers& extraHeaders = http::Headers())
+   {
+      writeResponse(response, close, extraHeaders);
+   }
+
    // writes only the headers and not any body data
    // useful for chunked encoding (streaming)
    // after successful write, the handler callback is invoked
@@ -23,6 +23,7 @@
 #include <boost/enable_shared_from_this.hpp>
 
 #include <boost/asio/write.hpp>
+#include <boost/asio/deadline_timer.hpp>
 #include <boost/asio/io_service.hpp>
 #include <boost/asio/placeholders.hpp>
 #include <boost/asio/ssl.hpp>
@@ -47,6 +48,23 @@ namespace http {
 typedef boost::function<void(const boost::system::error_code&, std::size_t)> ReadHandler;
 typedef boost::function<void(const boost::system::error_code&, bool)> WriteHandler;
 
+// the peer's network address; only TCP sockets have one (local stream
+// sockets fall through to the generic overload)
+template <typename SocketType>
+std::string remoteSocketAddress(const SocketType&)
+{
+   return std::string();
+}
+
+inline std::string remoteSocketAddress(const boost::asio::ip::tcp::socket& socket)
+{
+   boost::system::error_code ec;
+   boost::asio::ip::tcp::endpoint endpoint = socket.remote_endpoint(ec);
+   if (ec)
+      return std::string();
+   return endpoint.address().to_string();
+}
+
 class ISocketOperations
 {
 public:
@@ -161,10 +179,38 @@ public:
       return *socket_;
    }
 
+   // optional handler invoked when the ssl handshake completes (whether or
+   // not it succeeded) - used by the server to bound the number of handshakes
+   // in flight at any one time; must be set before startReading is called
+   void setHandshakeCompleteHandler(const boost::function<void()>& handler)
+   {
+      onHandshakeComplete_ = handler;
+   }
+
+   // optional deadline for completing the ssl handshake - a client that
+   // connects but never completes the handshake is disconnected once the
+   // deadline passes; must be set before startReading is called
+   void setHandshakeTimeout(const boost::posix_time::time_duration& timeout)
+   {
+      handshakeTimeout_ = timeout;
+   }
+
    void startReading()
    {
       if (sslStream_)
       {
+         // enforce the handshake deadline (if any) with a timer - closing
+         // the socket causes the pending handshake to complete with an error
+         if (!handshakeTimeout_.is_special() &&
+             handshakeTimeout_.total_milliseconds() > 0)
+         {
+            handshakeTimer_.reset(new boost::asio::deadline_timer(ioService_));
+            handshakeTimer_->expires_from_now(handshakeTimeout_);
+            handshakeTimer_->async_wait(boost::bind(&AsyncConnectionImpl<SocketType>::handleHandshakeTimeout,
+                                                    AsyncConnectionImpl<SocketType>::shared_from_this(),
+                                                    boost::asio::placeholders::error));
+         }
+
          // begin ssl handshake
          sslStream_->async_handshake(boost::asio::ssl::stream_base::server,
                                      boost::bind(&AsyncConnectionImpl<SocketType>::handleHandshake,
@@ -205,6 +251,10 @@ public:
       if (responseFilter_)
          responseFilter_(originalRequest_, &response_);
 
+      // compress large compressible bodies when the client accepts it and
+      // the handler didn't already choose a content encoding
+      response_.negotiateContentEncoding(originalRequest_);
+
       if (response_.isStreamResponse())
       {
          boost::shared_ptr<core::http::StreamWriter<SocketType> > pWriter(
@@ -247,6 +297,16 @@ public:
       writeResponse(close);
    }
 
+   virtual void writeResponse(http::Response&& response,
+                              bool close = true,
+                              const Headers& additionalHeaders = Headers())
+   {
+      // move the response (including a potentially large body) into place
+      // rather than copying it
+      response_.assign(std::move(response), additionalHeaders);
+      writeResponse(close);
+   }
+
    virtual void writeResponseHeaders(Socket::Handler handler)
    {
       if (!response_.containsHeader("Date"))
@@ -396,6 +456,10 @@ private:
             // headers parsed - body parsing has not yet begun
             else if (status == RequestParser::headers_parsed)
             {
+               // record the peer's network address (used by filters and
+               // handlers which run before authentication)
+               request_.remoteAddress_ = remoteSocketAddress(socket());
+
                // record the original request
                originalRequest_.assign(request_);
 
@@ -547,6 +611,19 @@ private:
 
    void handleHandshake(const boost::system::error_code& ec)
    {
+      // the handshake is no longer in flight - cancel the deadline timer
+      // and release our handshake slot (even on error, so a failed handshake
+      // can't permanently consume a slot)
+      if (handshakeTimer_)
+         handshakeTimer_->cancel();
+
+      if (onHandshakeComplete_)
+      {
+         boost::function<void()> onComplete;
+         onComplete.swap(onHandshakeComplete_);
+         onComplete();
+      }
+
       if (ec)
       {
          Error error(ec, ERROR_LOCATION);
@@ -560,6 +637,17 @@ private:
       readSome();
    }
 
+   void handleHandshakeTimeout(const boost::system::error_code& ec)
+   {
+      // aborted means the handshake completed and cancelled the timer
+      if (ec == boost::asio::error::operation_aborted)
+         return;
+
+      // handshake did not complete within the deadline - close the socket,
+      // which causes the pending handshake operation to complete with an error
+      close();
+   }
+
    void onStreamComplete()
    {
       close();
@@ -587,6 +675,11 @@ private:
    // depending on whether or not SSL is enabled
    boost::shared_ptr<ISocketOperations> socketOperations_;
 
+   // handshake deadline enforcement - only used for ssl connections
+   boost::function<void()> onHandshakeComplete_;
+   boost::posix_time::time_duration handshakeTimeout_;
+   boost::shared_ptr<boost::asio::deadline_timer> handshakeTimer_;
+
    HeadersParsedHandler onHeadersParsed_;
    Handler onRequestParsed_;
    ClosedHandler onClosed_;
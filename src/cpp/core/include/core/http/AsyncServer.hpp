@@ -46,6 +46,11 @@ public:
    virtual void addHandler(const std::string& prefix,
                            const AsyncUriHandlerFunction& handler) = 0;
 
+   // bulk handlers serve large transfers; their concurrent execution is
+   // bounded so latency-critical handlers keep io threads available
+   virtual void addBulkHandler(const std::string& prefix,
+                               const AsyncUriHandlerFunction& handler) = 0;
+
    virtual void addUploadHandler(const std::string& prefix,
                                  const AsyncUriUploadHandlerFunction& handler) = 0;
 
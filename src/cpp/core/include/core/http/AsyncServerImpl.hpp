@@ -16,6 +16,7 @@
 #ifndef CORE_HTTP_ASYNC_SERVER_IMPL_HPP
 #define CORE_HTTP_ASYNC_SERVER_IMPL_HPP
 
+#include <deque>
 #include <vector>
 
 #include <boost/utility.hpp>
@@ -85,6 +86,9 @@ public:
         additionalResponseHeaders_(additionalResponseHeaders),
         scheduledCommandInterval_(boost::posix_time::seconds(3)),
         scheduledCommandTimer_(acceptorService_.ioService()),
+        activeHandshakes_(0),
+        activeBulkRequests_(0),
+        bulkConcurrencyLimit_(2),
         running_(false)
    {
    }
@@ -118,9 +122,22 @@ public:
       uriHandlers_.add(AsyncUriHandler(baseUri_ + prefix, handler));
    }
 
+   virtual void addBulkHandler(const std::string& prefix,
+                               const AsyncUriHandlerFunction& handler)
+   {
+      BOOST_ASSERT(!running_);
+      uriHandlers_.add(AsyncUriHandler(baseUri_ + prefix,
+                                       handler,
+                                       false,
+                                       AsyncUriHandler::SchedulingBulk));
+   }
+
    virtual void addUploadHandler(const std::string& prefix,
                                  const AsyncUriUploadHandlerFunction& handler)
    {
+      // NOTE: upload handlers are invoked by the request parser as body
+      // chunks arrive, so they don't flow through the bulk gate in
+      // handleConnection (socket reads provide natural backpressure)
       BOOST_ASSERT(!running_);
       uriHandlers_.add(AsyncUriHandler(baseUri_ + prefix, handler));
    }
@@ -202,6 +219,10 @@ public:
          // update state
          running_ = true;
 
+         // leave at least half of the pool (and always at least two
+         // threads' worth of concurrency) for latency-critical requests
+         bulkConcurrencyLimit_ = std::max<std::size_t>(2, threadPoolSize / 2);
+
          // get ready for next connection
          acceptNextConnection();
 
@@ -335,11 +356,62 @@ private:
 
    void onConnectionClosed(const boost::weak_ptr<AsyncConnectionImpl<typename ProtocolType::socket>>& connection)
    {
+      // if this connection held a bulk slot, hand it to the oldest
+      // waiting bulk request (started outside the mutex, mirroring the
+      // handshake queue above)
+      std::pair<boost::shared_ptr<AsyncConnectionImpl<typename ProtocolType::socket> >,
+                AsyncUriHandlerFunctionVariant> next;
       RECURSIVE_LOCK_MUTEX(mutex_)
       {
          connections_.erase(connection);
+
+         if (bulkConnections_.erase(connection) > 0)
+         {
+            if (!pendingBulkConnections_.empty())
+            {
+               next = pendingBulkConnections_.front();
+               pendingBulkConnections_.pop_front();
+               bulkConnections_.insert(next.first);
+            }
+            else
+            {
+               activeBulkRequests_--;
+            }
+         }
       }
       END_LOCK_MUTEX
+
+      if (next.first)
+         visitHandler(next.second,
+                      boost::static_pointer_cast<AsyncConnection>(next.first));
+   }
+
+   void invokeBulkHandler(
+         const boost::shared_ptr<AsyncConnectionImpl<typename ProtocolType::socket> >& pConnection,
+         const AsyncUriHandlerFunctionVariant& handlerFunc)
+   {
+      bool startNow = false;
+      RECURSIVE_LOCK_MUTEX(mutex_)
+      {
+         if (activeBulkRequests_ < bulkConcurrencyLimit_)
+         {
+            activeBulkRequests_++;
+            bulkConnections_.insert(pConnection);
+            startNow = true;
+         }
+         else
+         {
+            // over the limit -- the request waits its turn (slots are
+            // released as bulk connections close)
+            pendingBulkConnections_.push_back(
+                     std::make_pair(pConnection, handlerFunc));
+         }
+      }
+      END_LOCK_MUTEX
+
+      if (startNow)
+         visitHandler(handlerFunc,
+                      boost::static_pointer_cast<AsyncConnection>(pConnection));
    }
 
    void acceptNextConnection()
@@ -391,7 +463,14 @@ private:
          {
             boost::weak_ptr<AsyncConnectionImpl<typename ProtocolType::socket>> weak(ptrNextConnection_);
             addConnection(weak);
-            ptrNextConnection_->startReading();
+
+            // ssl connections must first perform a handshake, which is
+            // expensive - bound the number in flight so a burst of new
+            // connections can't starve established connections of io threads
+            if (sslContext_)
+               queueHandshake(ptrNextConnection_);
+            else
+               ptrNextConnection_->startReading();
          }
          else
          {
@@ -426,7 +505,60 @@ private:
       }
       CATCH_UNEXPECTED_EXCEPTION
    }
-   
+
+   void queueHandshake(
+         const boost::shared_ptr<AsyncConnectionImpl<typename ProtocolType::socket>>& pConnection)
+   {
+      pConnection->setHandshakeTimeout(
+               boost::posix_time::seconds(kSslHandshakeTimeoutSeconds));
+      pConnection->setHandshakeCompleteHandler(
+               boost::bind(&AsyncServerImpl<ProtocolType>::onHandshakeComplete,
+                           this));
+
+      bool startNow = false;
+      RECURSIVE_LOCK_MUTEX(mutex_)
+      {
+         if (activeHandshakes_ < kMaxConcurrentSslHandshakes)
+         {
+            activeHandshakes_++;
+            startNow = true;
+         }
+         else
+         {
+            // over the limit - wait for an in-flight handshake to finish
+            // (connections are handshaken in the order they arrived)
+            pendingHandshakes_.push_back(pConnection);
+         }
+      }
+      END_LOCK_MUTEX
+
+      if (startNow)
+         pConnection->startReading();
+   }
+
+   void onHandshakeComplete()
+   {
+      // hand the freed handshake slot to the oldest waiting connection,
+      // if any (start it outside the mutex to prevent potential deadlock)
+      boost::shared_ptr<AsyncConnectionImpl<typename ProtocolType::socket>> pNextConnection;
+      RECURSIVE_LOCK_MUTEX(mutex_)
+      {
+         if (!pendingHandshakes_.empty())
+         {
+            pNextConnection = pendingHandshakes_.front();
+            pendingHandshakes_.pop_front();
+         }
+         else
+         {
+            activeHandshakes_--;
+         }
+      }
+      END_LOCK_MUTEX
+
+      if (pNextConnection)
+         pNextConnection->startReading();
+   }
+
    bool onHeadersParsed(
          boost::shared_ptr<AsyncConnectionImpl<typename ProtocolType::socket> > pConnection,
          http::Request* pRequest)
@@ -554,10 +686,16 @@ private:
          if (!handlerFunc && defaultHandler_)
             handlerFunc = defaultHandler_;
 
-         // call handler if we have one
+         // call handler if we have one. bulk handlers (large
+         // downloads) are bounded in concurrent execution so a burst of
+         // transfers can't occupy every io thread and inflate the tail
+         // latency of small RPC/event-channel requests
          if (handlerFunc)
          {
-            visitHandler(handlerFunc.get(), pAsyncConnection);
+            if (handler.isBulkHandler())
+               invokeBulkHandler(pConnection, handlerFunc.get());
+            else
+               visitHandler(handlerFunc.get(), pAsyncConnection);
          }
          else
          {
@@ -731,6 +869,15 @@ private:
    }
 
 private:
+   // maximum number of ssl handshakes allowed in flight at once - additional
+   // connections wait their turn so io threads remain available to service
+   // established connections during a handshake storm
+   static const std::size_t kMaxConcurrentSslHandshakes = 64;
+
+   // maximum time a client may take to complete its ssl handshake before
+   // being disconnected (prevents stalled handshakes from pinning slots)
+   static const int kSslHandshakeTimeoutSeconds = 30;
+
    boost::recursive_mutex mutex_;
    SocketAcceptorService<ProtocolType> acceptorService_;
    bool abortOnResourceError_;
@@ -741,6 +888,13 @@ private:
    Headers additionalResponseHeaders_;
    boost::shared_ptr<boost::asio::ssl::context> sslContext_;
    boost::shared_ptr<AsyncConnectionImpl<typename ProtocolType::socket> > ptrNextConnection_;
+   std::size_t activeHandshakes_;
+   std::deque<boost::shared_ptr<AsyncConnectionImpl<typename ProtocolType::socket> > > pendingHandshakes_;
+   std::size_t activeBulkRequests_;
+   std::size_t bulkConcurrencyLimit_;
+   std::set<boost::weak_ptr<AsyncConnectionImpl<typename ProtocolType::socket> >> bulkConnections_;
+   std::deque<std::pair<boost::shared_ptr<AsyncConnectionImpl<typename ProtocolType::socket> >,
+                        AsyncUriHandlerFunctionVariant> > pendingBulkConnections_;
    std::set<boost::weak_ptr<AsyncConnectionImpl<typename ProtocolType::socket> >> connections_;
    AsyncUriHandlers uriHandlers_;
    AsyncUriHandlerFunction defaultHandler_;
@@ -37,8 +37,10 @@ namespace http {
 typedef boost::function<void(
             boost::shared_ptr<AsyncConnection>)> AsyncUriHandlerFunction;
 
+// upload handlers receive the form data by mutable reference so they can
+// take ownership of the buffer (moving from it) instead of copying it
 typedef boost::function<bool(
-            boost::shared_ptr<AsyncConnection>, const std::string&, bool)> AsyncUriUploadHandlerFunction;
+            boost::shared_ptr<AsyncConnection>, std::string&, bool)> AsyncUriUploadHandlerFunction;
 
 typedef boost::variant<AsyncUriHandlerFunction,
             AsyncUriUploadHandlerFunction> AsyncUriHandlerFunctionVariant;
@@ -79,12 +81,26 @@ private:
 class AsyncUriHandler
 {
 public:
-   AsyncUriHandler() : isProxyHandler_(false) {} // other members default initialized
+   // scheduling class for two-tier dispatch: bulk handlers (large
+   // downloads/uploads) have their concurrent execution bounded by the
+   // server so latency-critical requests (small RPCs, event channels)
+   // always find a free io thread
+   enum SchedulingClass { SchedulingLatency, SchedulingBulk };
+
+   AsyncUriHandler()
+      : isProxyHandler_(false),
+        schedulingClass_(SchedulingLatency)
+   {
+   } // other members default initialized
 
    AsyncUriHandler(const std::string& prefix,
                    AsyncUriHandlerFunctionVariant function,
-                   bool isProxyHandler = false)
-       : prefix_(prefix), function_(function), isProxyHandler_(isProxyHandler)
+                   bool isProxyHandler = false,
+                   SchedulingClass schedulingClass = SchedulingLatency)
+       : prefix_(prefix),
+         function_(function),
+         isProxyHandler_(isProxyHandler),
+         schedulingClass_(schedulingClass)
    {
    }
 
@@ -127,10 +143,16 @@ public:
       return isProxyHandler_;
    }
 
+   bool isBulkHandler() const
+   {
+      return schedulingClass_ == SchedulingBulk;
+   }
+
 private:
    std::string prefix_;
    boost::optional<AsyncUriHandlerFunctionVariant> function_;
    bool isProxyHandler_;
+   SchedulingClass schedulingClass_;
 
 };
 
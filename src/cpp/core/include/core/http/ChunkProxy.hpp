@@ -39,8 +39,17 @@ public:
 private:
    static constexpr uint64_t defaultMaxBufferSize = 1024*1024; // 1MB
 
+   // a queued chunk awaiting write - the payload shares the buffer parsed
+   // by the upstream connection so relaying does not copy the body, only
+   // the small framing header is generated per chunk
+   struct QueuedChunk
+   {
+      std::string header;
+      boost::shared_ptr<std::string> payload;
+   };
+
    bool queueChunk(const Response& response,
-                   const std::string& chunk);
+                   const boost::shared_ptr<std::string>& chunk);
    void onHeadersWrote(const boost::system::error_code& ec);
    void writeChunk();
    void onChunkWrote(const boost::system::error_code& ec);
@@ -53,7 +62,7 @@ private:
 
    boost::mutex mutex_;
    bool wroteHeaders_;
-   std::queue<std::string> writeBuffer_;
+   std::queue<QueuedChunk> writeBuffer_;
    uint64_t currentBufferSize_;
    bool bufferFull_;
 };
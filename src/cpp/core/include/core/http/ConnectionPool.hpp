@@ -0,0 +1,142 @@
+/*
+ * ConnectionPool.hpp
+ *
+ * Copyright (C) 2020 by RStudio, PBC
+ *
+ * Unless you have received this program directly from RStudio pursuant
+ * to the terms of a commercial license agreement with RStudio, then
+ * this program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ *
+ */
+
+#ifndef CORE_HTTP_CONNECTION_POOL_HPP
+#define CORE_HTTP_CONNECTION_POOL_HPP
+
+#include <deque>
+#include <map>
+#include <string>
+
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include <core/Thread.hpp>
+
+namespace rstudio {
+namespace core {
+namespace http {
+
+// pool of idle keep-alive connections, keyed by endpoint (e.g. the path
+// of a session's stream socket). clients which negotiate keep-alive hand
+// their socket back to the pool after a response; the next request to
+// the same endpoint adopts it and skips the connect. entries idle for
+// longer than the timeout are reaped lazily as the pool is used, so a
+// connection to a session which has gone away is never held for long
+template <typename SocketType>
+class ConnectionPool : boost::noncopyable
+{
+public:
+   ConnectionPool(
+         boost::posix_time::time_duration idleTimeout =
+                                    boost::posix_time::seconds(10),
+         std::size_t maxConnectionsPerEndpoint = 16)
+      : idleTimeout_(idleTimeout),
+        maxConnectionsPerEndpoint_(maxConnectionsPerEndpoint)
+   {
+   }
+
+   // COPYING: boost::noncopyable
+
+   // return an idle connection to the endpoint, or an empty pointer if
+   // none is available (most recently used connections are returned
+   // first, since they are the least likely to have gone stale)
+   boost::shared_ptr<SocketType> acquire(const std::string& endpoint)
+   {
+      LOCK_MUTEX(mutex_)
+      {
+         typename ConnectionMap::iterator it = connections_.find(endpoint);
+         if (it == connections_.end())
+            return boost::shared_ptr<SocketType>();
+
+         reapExpired(&(it->second));
+
+         while (!it->second.empty())
+         {
+            PooledConnection connection = it->second.back();
+            it->second.pop_back();
+
+            if (connection.pSocket->is_open())
+               return connection.pSocket;
+         }
+      }
+      END_LOCK_MUTEX
+
+      return boost::shared_ptr<SocketType>();
+   }
+
+   // return a connection to the pool for later reuse. if the pool for
+   // this endpoint is full the connection is simply dropped (closing
+   // the socket when the last reference is released)
+   void release(const std::string& endpoint,
+                const boost::shared_ptr<SocketType>& pSocket)
+   {
+      if (!pSocket || !pSocket->is_open())
+         return;
+
+      LOCK_MUTEX(mutex_)
+      {
+         Connections& connections = connections_[endpoint];
+         reapExpired(&connections);
+
+         if (connections.size() >= maxConnectionsPerEndpoint_)
+            return;
+
+         PooledConnection connection;
+         connection.pSocket = pSocket;
+         connection.lastUsed =
+               boost::posix_time::microsec_clock::universal_time();
+         connections.push_back(connection);
+      }
+      END_LOCK_MUTEX
+   }
+
+private:
+   struct PooledConnection
+   {
+      boost::shared_ptr<SocketType> pSocket;
+      boost::posix_time::ptime lastUsed;
+   };
+   typedef std::deque<PooledConnection> Connections;
+   typedef std::map<std::string, Connections> ConnectionMap;
+
+   // drop connections which have been idle for too long (caller must
+   // hold the mutex); oldest connections live at the front
+   void reapExpired(Connections* pConnections)
+   {
+      boost::posix_time::ptime expiry =
+            boost::posix_time::microsec_clock::universal_time() -
+            idleTimeout_;
+
+      while (!pConnections->empty() &&
+             pConnections->front().lastUsed < expiry)
+      {
+         pConnections->pop_front();
+      }
+   }
+
+   boost::posix_time::time_duration idleTimeout_;
+   std::size_t maxConnectionsPerEndpoint_;
+
+   boost::mutex mutex_;
+   ConnectionMap connections_;
+};
+
+} // namespace http
+} // namespace core
+} // namespace rstudio
+
+#endif // CORE_HTTP_CONNECTION_POOL_HPP
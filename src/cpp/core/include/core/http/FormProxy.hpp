@@ -34,7 +34,10 @@ public:
              const boost::shared_ptr<IAsyncClient>& pDownstreamCOnnection,
              uint64_t maxBufferSize = defaultMaxBufferSize);
 
-   bool queueData(const std::string& formData);
+   // queue form data for writing to the downstream connection - takes
+   // ownership of the buffer when it returns true; when it returns false
+   // (buffer full) the data is untouched and will be redelivered
+   bool queueData(std::string& formData);
    void initialize();
 
 private:
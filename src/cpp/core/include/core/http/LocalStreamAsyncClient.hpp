@@ -18,7 +18,9 @@
 
 #include <sys/stat.h>
 
+#include <boost/algorithm/string/predicate.hpp>
 #include <boost/function.hpp>
+#include <boost/make_shared.hpp>
 #include <boost/optional.hpp>
 
 #include <boost/asio/local/stream_protocol.hpp>
@@ -29,6 +31,7 @@
 #include <core/system/PosixUser.hpp>
 
 #include <core/http/AsyncClient.hpp>
+#include <core/http/ConnectionPool.hpp>
 #include <core/http/LocalStreamSocketUtils.hpp>
 
 namespace rstudio {
@@ -39,6 +42,9 @@ class LocalStreamAsyncClient
    : public AsyncClient<boost::asio::local::stream_protocol::socket>
 {
 public:
+   typedef ConnectionPool<boost::asio::local::stream_protocol::socket>
+                                                         StreamConnectionPool;
+
    LocalStreamAsyncClient(boost::asio::io_service& ioService,
                           const FilePath localStreamPath,
                           bool logToStderr = false,
@@ -49,11 +55,21 @@ public:
                                                                 logToStderr),
        socket_(ioService),
        localStreamPath_(localStreamPath),
-       validateUid_(validateUid)
+       validateUid_(validateUid),
+       usingPooledConnection_(false)
    {
       setConnectionRetryProfile(retryProfile);
    }
 
+   // opt in to keep-alive connection reuse. idle connections are adopted
+   // from (and handed back to) the pool rather than connecting per
+   // request
+   void setConnectionPool(
+            const boost::shared_ptr<StreamConnectionPool>& pConnectionPool)
+   {
+      pConnectionPool_ = pConnectionPool;
+   }
+
 protected:
 
    virtual boost::asio::local::stream_protocol::socket& socket()
@@ -65,6 +81,23 @@ private:
 
    virtual void connectAndWriteRequest()
    {
+      // adopt an idle keep-alive connection when one is available (the
+      // socket was uid-validated when it was originally connected)
+      if (pConnectionPool_)
+      {
+         boost::shared_ptr<boost::asio::local::stream_protocol::socket>
+               pSocket = pConnectionPool_->acquire(
+                                    localStreamPath_.getAbsolutePath());
+         if (pSocket)
+         {
+            socket_ = std::move(*pSocket);
+            usingPooledConnection_ = true;
+            writeRequest();
+            return;
+         }
+      }
+      usingPooledConnection_ = false;
+
       // validate if requested
       if (validateUid_.is_initialized() && localStreamPath_.exists())
       {
@@ -110,6 +143,63 @@ private:
       return "localhost";
    }
 
+   virtual Header connectionOverrideHeader()
+   {
+      // request keep-alive when pooling so the session leaves the
+      // connection open for the next request
+      return pConnectionPool_ ? Header::connectionKeepAlive()
+                              : Header::connectionClose();
+   }
+
+   virtual bool stopReadingAndRespond()
+   {
+      // when the connection is going to be reused the server won't
+      // close it, so terminate the read once the declared content has
+      // arrived (responses without a content length still read to eof)
+      return !chunkedEncoding_ &&
+             response_.containsHeader("Content-Length") &&
+             (response_.body().length() >= response_.contentLength());
+   }
+
+   virtual bool keepConnectionAlive()
+   {
+      // hand the connection back to the pool if the response allows
+      // reuse; otherwise fall back to the default close behavior
+      if (pConnectionPool_ &&
+          !chunkedEncoding_ &&
+          response_.containsHeader("Content-Length") &&
+          !boost::algorithm::iequals(response_.headerValue("Connection"),
+                                     "close"))
+      {
+         pConnectionPool_->release(
+            localStreamPath_.getAbsolutePath(),
+            boost::make_shared<boost::asio::local::stream_protocol::socket>(
+                                                      std::move(socket_)));
+         return true;
+      }
+
+      return false;
+   }
+
+   virtual bool recoverFromError(const Error& error)
+   {
+      // a pooled connection may have been closed by the peer between
+      // requests; if it fails before any of the response has been
+      // received, retry the request once on a freshly connected stream
+      if (usingPooledConnection_ && response_.statusCode() == 0)
+      {
+         usingPooledConnection_ = false;
+         Error closeError = closeSocket(socket_);
+         if (closeError && !http::isConnectionTerminatedError(closeError))
+            LOG_ERROR(closeError);
+
+         connectAndWriteRequest();
+         return true;
+      }
+
+      return false;
+   }
+
    void handleConnect(const boost::system::error_code& ec)
    {
       try
@@ -140,6 +230,8 @@ private:
    boost::asio::local::stream_protocol::socket socket_;
    core::FilePath localStreamPath_;
    boost::optional<UidType> validateUid_;
+   boost::shared_ptr<StreamConnectionPool> pConnectionPool_;
+   bool usingPooledConnection_;
 };
    
    
@@ -17,6 +17,7 @@
 #define CORE_HTTP_MESSAGE_HPP
 
 #include <string>
+#include <utility>
 #include <vector>
 #include <algorithm>
 
@@ -114,6 +115,12 @@ protected:
    void appendHttpVersionBuffers(
          std::vector<boost::asio::const_buffer>& buffers) const;
 
+   // appends the complete header section (first line, headers, terminating
+   // blank line) to an existing buffer sequence
+   void appendHeaderBuffers(
+         std::vector<boost::asio::const_buffer>& buffers,
+         const Header& overrideHeader) const;
+
    void assign(const Message& message, const Headers& extraHeaders)
    {
       body_ = message.body_;
@@ -127,8 +134,23 @@ protected:
                     boost::bind(&Message::setExtraHeader, this, _1));
    }
 
+   // move-enabled variant - steals the body and headers of the source
+   // message rather than copying them (the source is left valid but empty)
+   void assign(Message&& message, const Headers& extraHeaders)
+   {
+      body_ = std::move(message.body_);
+      httpVersionMajor_ = message.httpVersionMajor_;
+      httpVersionMinor_ = message.httpVersionMinor_;
+      headers_ = std::move(message.headers_);
+      overrideHeader_ = std::move(message.overrideHeader_);
+      httpVersion_ = std::move(message.httpVersion_);
+
+      std::for_each(extraHeaders.begin(), extraHeaders.end(),
+                    boost::bind(&Message::setExtraHeader, this, _1));
+   }
+
 private:
-   
+
    virtual void appendFirstLineBuffers(
          std::vector<boost::asio::const_buffer>& buffers) const = 0;
 
@@ -26,6 +26,8 @@ namespace rstudio {
 namespace core {
 namespace http {
 
+template <typename SocketType> class AsyncConnectionImpl;
+
 enum class BaseUriUse {
    Internal, // The default, includes internal addresses
    External  // Omit internal addresses, returning blank
@@ -44,6 +46,7 @@ public:
       method_ = request.method_;
       uri_ = request.uri_;
       remoteUid_ = request.remoteUid_;
+      remoteAddress_ = request.remoteAddress_;
       parsedCookies_ = request.parsedCookies_;
       cookies_ = request.cookies_;
       parsedFormFields_ = request.parsedFormFields_;
@@ -94,6 +97,10 @@ public:
    
    // only applies to local stream connections (returns -1 if unknown)
    int remoteUid() const { return remoteUid_; }
+
+   // the network address of the connection peer (empty for local
+   // stream connections, or when unknown)
+   const std::string& remoteAddress() const { return remoteAddress_; }
    
    boost::posix_time::ptime ifModifiedSince() const;
    
@@ -171,6 +178,7 @@ private:
    std::string method_;
    std::string uri_;
    int remoteUid_;
+   std::string remoteAddress_;
    
    // cookies, form fields, and query string are parsed on demand
    mutable bool parsedCookies_;
@@ -184,6 +192,7 @@ private:
 
    friend class RequestParser;
    friend class LocalStreamAsyncServer;
+   template <typename SocketType> friend class AsyncConnectionImpl;
 };
 
 std::ostream& operator << (std::ostream& stream, const Request& r);
@@ -17,6 +17,8 @@
 #ifndef CORE_HTTP_REQUEST_PARSER_HPP
 #define CORE_HTTP_REQUEST_PARSER_HPP
 
+#include <algorithm>
+
 #include <boost/algorithm/string.hpp>
 #include <boost/function.hpp>
 #include <boost/optional.hpp>
@@ -30,7 +32,10 @@ namespace rstudio {
 namespace core {
 namespace http {
 
-typedef boost::function<bool(const std::string&, bool)> FormHandler;
+// handler for form data pieces - the handler may take ownership of the
+// buffer (e.g. by moving from it) when it returns true; when it returns
+// false the parser keeps the buffer and redelivers it when resumed
+typedef boost::function<bool(std::string&, bool)> FormHandler;
 
 /// Parser for incoming requests.
 class RequestParser
@@ -123,6 +128,48 @@ public:
        // header parsing
        if (!parsingBody_)
        {
+          // bulk-append runs of ordinary bytes in the string-accumulating
+          // states (the uri and header names/values make up nearly the whole
+          // request); terminators and special characters still go through
+          // consume() a byte at a time, so state transitions are unchanged
+          if (state_ == uri)
+          {
+             InputIterator runEnd = begin;
+             while (runEnd != end && *runEnd != ' ' && !is_ctl(*runEnd))
+                ++runEnd;
+             if (runEnd != begin)
+             {
+                req.uri_.append(begin, runEnd);
+                begin = runEnd;
+                continue;
+             }
+          }
+          else if (state_ == header_value)
+          {
+             InputIterator runEnd = begin;
+             while (runEnd != end && !is_ctl(*runEnd))
+                ++runEnd;
+             if (runEnd != begin)
+             {
+                req.headers_.back().value.append(begin, runEnd);
+                begin = runEnd;
+                continue;
+             }
+          }
+          else if (state_ == header_name)
+          {
+             InputIterator runEnd = begin;
+             while (runEnd != end && is_char(*runEnd) && !is_ctl(*runEnd) &&
+                    !is_tspecial(*runEnd))
+                ++runEnd;
+             if (runEnd != begin)
+             {
+                req.headers_.back().name.append(begin, runEnd);
+                begin = runEnd;
+                continue;
+             }
+          }
+
           status st = consume(req, *begin++);
           if ( st == error )
           {
@@ -167,7 +214,22 @@ public:
                 checkContentLength_ = false;
              }
 
-             req.body_.push_back(*begin++);
+             if (req.body_.empty())
+             {
+                // reserve the body up front, capped so a hostile
+                // content-length can't force a huge allocation before any
+                // bytes arrive
+                req.body_.reserve(static_cast<size_t>(
+                     std::min(contentLength_,
+                              static_cast<uintmax_t>(MAX_BUFFER_SIZE))));
+             }
+
+             // bulk-append as much of the body as this buffer holds
+             uintmax_t take = std::min(
+                  static_cast<uintmax_t>(std::distance(begin, end)),
+                  contentLength_ - req.body_.size());
+             req.body_.append(begin, begin + take);
+             begin += take;
              if (req.body_.size() == contentLength_)
              {
                 cleanup();
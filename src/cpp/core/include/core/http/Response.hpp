@@ -51,6 +51,11 @@ namespace http {
 // uri not found handler
 typedef boost::function<void(const Request&, Response*)> NotFoundHandler;
 
+// files at least this large are streamed to the client in chunks rather
+// than buffered (and possibly compressed) in memory before the first
+// byte is written
+const uintmax_t kStreamFileThreshold = 64 * 1024;
+
 class Cookie;
    
 namespace status {
@@ -135,6 +140,18 @@ public:
       streamResponse_ = response.streamResponse_;
    }
 
+   // move-enabled variant - steals the body of the source response rather
+   // than copying it (useful when relaying large proxied responses)
+   void assign(Response&& response,
+               const Headers& extraHeaders = Headers())
+   {
+      Message::assign(std::move(response), extraHeaders);
+      statusCode_ = response.statusCode_;
+      statusCodeStr_ = std::move(response.statusCodeStr_);
+      statusMessage_ = std::move(response.statusMessage_);
+      streamResponse_ = std::move(response.streamResponse_);
+   }
+
 public:   
    int statusCode() const { return statusCode_; }
    void setStatusCode(int statusCode) { statusCode_ = statusCode; }
@@ -159,7 +176,20 @@ public:
    Headers getCookies(const std::vector<std::string>& names = {}) const;
    
    Error setBody(const std::string& content);
-   
+
+   // move-enabled setter - takes ownership of the content so large bodies
+   // aren't copied again; falls back to the stream path (which copies)
+   // when a content encoding has been set and compression is required
+   Error setBody(std::string&& content)
+   {
+      if (!contentEncoding().empty())
+         return setBody(static_cast<const std::string&>(content));
+
+      body_ = std::move(content);
+      setContentLength(body_.length());
+      return Success();
+   }
+
    Error setCacheableBody(const std::string& content,
                           const Request& request)
    {
@@ -299,6 +329,11 @@ public:
       }
    }
 
+   // compress the body with gzip if the client accepts it, the body is
+   // large enough to benefit, its media type is compressible, and no
+   // encoding was already applied (no-op on windows)
+   void negotiateContentEncoding(const Request& request);
+
    void setDynamicHtml(const std::string& html, const Request& request);
    
    void setFile(const FilePath& filePath, const Request& request)
@@ -308,8 +343,8 @@ public:
    }
    
    template <typename Filter>
-   void setFile(const FilePath& filePath, 
-                const Request& request, 
+   void setFile(const FilePath& filePath,
+                const Request& request,
                 const Filter& filter)
    {
       // ensure that the file exists
@@ -318,7 +353,46 @@ public:
          setNotFoundError(request);
          return;
       }
-      
+
+      // prefer a precompressed sibling (<file>.gz) when the client
+      // accepts gzip: serving prebuilt bytes skips per-request
+      // compression entirely, which matters for the large static
+      // payloads fetched at login. the variant must be at least as new
+      // as the source so a stale artifact is never served.
+      if (boost::is_same<Filter, NullOutputFilter>::value &&
+          request.acceptsEncoding(kGzipEncoding))
+      {
+         FilePath gzPath(filePath.getAbsolutePath() + ".gz");
+         if (gzPath.exists() &&
+             gzPath.getLastWriteTime() >= filePath.getLastWriteTime())
+         {
+            setContentType(filePath.getMimeContentType());
+
+            // read the precompressed bytes as-is (the gzip encoding
+            // header is set afterwards so setBody doesn't re-compress)
+            Error error = setBody(gzPath);
+            if (error)
+            {
+               setError(status::InternalServerError, error.getMessage());
+               return;
+            }
+            setContentEncoding(kGzipEncoding);
+            setHeader("Vary", "Accept-Encoding");
+            return;
+         }
+      }
+
+      // stream large unfiltered files from disk rather than reading
+      // (and possibly compressing) the entire file into the body up
+      // front -- filtered responses still need the buffered path since
+      // filters and response rewriting operate on the body
+      if (boost::is_same<Filter, NullOutputFilter>::value &&
+          filePath.getSize() >= kStreamFileThreshold)
+      {
+         setStreamFile(filePath, request);
+         return;
+      }
+
       // set content type
       setContentType(filePath.getMimeContentType());
       
@@ -409,9 +483,18 @@ public:
       using namespace boost::posix_time;
       ptime lastModifiedDate = from_time_t(filePath.getLastWriteTime());
       setHeader("Last-Modified", util::httpDate(lastModifiedDate));
-      
-      // compare file modified time to If-Modified-Since
-      if (lastModifiedDate == request.ifModifiedSince())
+
+      // also set a content hash validator; mtimes change on
+      // redeployment even when content does not, and the eTag lets the
+      // browser keep its cached copy across those (hashes are cached
+      // by path/mtime/size so this doesn't re-read the file)
+      std::string eTag = eTagForFile(filePath);
+      if (!eTag.empty())
+         setHeader("ETag", eTag);
+
+      // revalidate against If-Modified-Since / If-None-Match
+      if (lastModifiedDate == request.ifModifiedSince() ||
+          (!eTag.empty() && eTag == request.headerValue("If-None-Match")))
       {
          removeHeader("Content-Type"); // upstream code may have set this
          setStatusCode(status::NotModified);
@@ -421,6 +504,15 @@ public:
          setFile(filePath, request, filter);
       }
    }
+
+   // content hash of a file suitable for use as an eTag validator - hashes
+   // are cached by path/mtime/size so repeated calls don't re-read the file
+   std::string eTagForFile(const FilePath& filePath);
+
+   // serve a file with support for byte-range requests (so interrupted
+   // downloads can resume) and eTag revalidation (If-None-Match => 304,
+   // If-Range mismatch => full entity); file hashes are cached so
+   // repeated requests for an unchanged file don't re-hash it
    void setRangeableFile(const FilePath& filePath, const Request& request);
 
    void setRangeableFile(const std::string& contents,
@@ -96,10 +96,21 @@ public:
    static void appendToBody(boost::asio::streambuf* pResponseBuffer,
                             Response* pResponse)
    {
-      std::ostringstream bodyStream;
-      if (pResponseBuffer->size() > 0)
-         bodyStream << pResponseBuffer;
-      pResponse->body_ += bodyStream.str();
+      std::size_t size = pResponseBuffer->size();
+      if (size > 0)
+      {
+         pResponse->body_.append(
+            boost::asio::buffer_cast<const char*>(pResponseBuffer->data()),
+            size);
+         pResponseBuffer->consume(size);
+      }
+   }
+
+   static void appendToBody(const char* buffer,
+                            std::size_t length,
+                            Response* pResponse)
+   {
+      pResponse->body_.append(buffer, length);
    }
 
    static void appendToBody(const std::string& buff,
@@ -108,6 +119,12 @@ public:
       pResponse->body_ += buff;
    }
 
+   // pre-size the body so appends don't reallocate as content arrives
+   static void reserveBody(std::size_t size, Response* pResponse)
+   {
+      pResponse->body_.reserve(size);
+   }
+
    template <typename SyncReadStream>
    static Error parseFromStream(SyncReadStream& stream, Response* pResponse)
    {
@@ -17,6 +17,7 @@
 #define CORE_HTTP_SOCKET_PROXY_HPP
 
 #include <string>
+#include <vector>
 
 #include <boost/array.hpp>
 #include <boost/shared_ptr.hpp>
@@ -47,11 +48,66 @@ private:
                boost::shared_ptr<core::http::Socket> ptrServer)
       : ptrClient_(ptrClient), ptrServer_(ptrServer)
    {
+      clientToServer_.ptrSource = ptrClient_;
+      clientToServer_.ptrDest = ptrServer_;
+      clientToServer_.readHandler = &SocketProxy::handleClientRead;
+      clientToServer_.writeHandler = &SocketProxy::handleServerWrite;
+
+      serverToClient_.ptrSource = ptrServer_;
+      serverToClient_.ptrDest = ptrClient_;
+      serverToClient_.readHandler = &SocketProxy::handleServerRead;
+      serverToClient_.writeHandler = &SocketProxy::handleClientWrite;
    }
 
+   typedef void (SocketProxy::*CompletionHandler)(
+                                    const boost::system::error_code&,
+                                    std::size_t);
+
+   // each direction relays through a small ring of fixed reusable
+   // buffers so a read can proceed while the previous chunk is still
+   // being written to the other side, and chunks which accumulate
+   // during a slow write drain in a single vectored write
+   struct Direction
+   {
+      Direction()
+         : writeIndex(0),
+           filledCount(0),
+           writingCount(0),
+           reading(false)
+      {
+      }
+
+      static const std::size_t kNumBuffers = 2;
+
+      boost::shared_ptr<core::http::Socket> ptrSource;
+      boost::shared_ptr<core::http::Socket> ptrDest;
+      CompletionHandler readHandler;
+      CompletionHandler writeHandler;
+
+      boost::array<char, 8192> buffers[kNumBuffers];
+      std::size_t lengths[kNumBuffers];
+      std::size_t writeIndex;    // oldest filled buffer
+      std::size_t filledCount;   // buffers filled but not yet written
+      std::size_t writingCount;  // buffers in the in-flight write
+      bool reading;              // read currently outstanding
+
+      // reused across writes to avoid a per-chunk allocation
+      std::vector<boost::asio::const_buffer> writeBuffers;
+   };
+
    void readClient();
    void readServer();
 
+   // must be called with socketMutex_ held
+   void startRead(Direction& direction);
+   void startWrite(Direction& direction);
+
+   void handleRead(Direction& direction,
+                   const boost::system::error_code& e,
+                   std::size_t bytesTransferred);
+   void handleWrite(Direction& direction,
+                    const boost::system::error_code& e);
+
    void handleClientRead(const boost::system::error_code& e,
                          std::size_t bytesTransferred);
    void handleServerRead(const boost::system::error_code& e,
@@ -68,8 +124,8 @@ private:
 private:
    boost::shared_ptr<core::http::Socket> ptrClient_;
    boost::shared_ptr<core::http::Socket> ptrServer_;
-   boost::array<char, 8192> clientBuffer_;
-   boost::array<char, 8192> serverBuffer_;
+   Direction clientToServer_;
+   Direction serverToClient_;
    boost::mutex socketMutex_;
 };
 
@@ -74,6 +74,17 @@ public:
       if (ec)
          return Error(ec, ERROR_LOCATION);
 
+      // enable server-side session caching so returning clients can resume
+      // a previous TLS session with an abbreviated handshake rather than
+      // re-running the full key exchange on every connection
+      const char kSessionIdContext[] = "rstudio";
+      SSL_CTX_set_session_id_context(
+               context->native_handle(),
+               reinterpret_cast<const unsigned char*>(kSessionIdContext),
+               sizeof(kSessionIdContext) - 1);
+      SSL_CTX_set_session_cache_mode(context->native_handle(),
+                                     SSL_SESS_CACHE_SERVER);
+
       setSslContext(context);
 
       return initTcpIpAcceptor(acceptorService(), address, port);
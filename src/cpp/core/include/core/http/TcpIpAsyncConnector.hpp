@@ -16,6 +16,9 @@
 #ifndef CORE_HTTP_TCP_IP_ASYNC_CONNECTOR_HPP
 #define CORE_HTTP_TCP_IP_ASYNC_CONNECTOR_HPP
 
+#include <map>
+#include <vector>
+
 #include <boost/function.hpp>
 #include <boost/shared_ptr.hpp>
 #include <boost/enable_shared_from_this.hpp>
@@ -42,7 +45,84 @@
 
 namespace rstudio {
 namespace core {
-namespace http {  
+namespace http {
+
+// process-wide cache of resolved endpoints. repeat connections to the
+// same host (e.g. polling a CRAN mirror or downloading a series of
+// files) skip DNS resolution entirely while an entry is fresh; entries
+// expire after a short TTL so address changes are still picked up
+class TcpIpResolverCache : boost::noncopyable
+{
+public:
+   static TcpIpResolverCache& instance()
+   {
+      static TcpIpResolverCache instance;
+      return instance;
+   }
+
+   bool lookup(const std::string& key,
+               std::vector<boost::asio::ip::tcp::endpoint>* pEndpoints)
+   {
+      LOCK_MUTEX(mutex_)
+      {
+         std::map<std::string, Entry>::const_iterator it = cache_.find(key);
+         if (it == cache_.end())
+            return false;
+
+         if (boost::posix_time::microsec_clock::universal_time() > it->second.expiry)
+            return false;
+
+         *pEndpoints = it->second.endpoints;
+         return true;
+      }
+      END_LOCK_MUTEX
+
+      // keep compiler happy
+      return false;
+   }
+
+   void store(const std::string& key,
+              const std::vector<boost::asio::ip::tcp::endpoint>& endpoints)
+   {
+      LOCK_MUTEX(mutex_)
+      {
+         // bound the size of the cache (prevent unbounded accumulation
+         // for processes which connect to many distinct hosts)
+         if (cache_.size() >= 100)
+            cache_.clear();
+
+         Entry entry;
+         entry.endpoints = endpoints;
+         entry.expiry = boost::posix_time::microsec_clock::universal_time() +
+                        boost::posix_time::seconds(60);
+         cache_[key] = entry;
+      }
+      END_LOCK_MUTEX
+   }
+
+   void remove(const std::string& key)
+   {
+      LOCK_MUTEX(mutex_)
+      {
+         cache_.erase(key);
+      }
+      END_LOCK_MUTEX
+   }
+
+private:
+   TcpIpResolverCache()
+   {
+   }
+
+   struct Entry
+   {
+      std::vector<boost::asio::ip::tcp::endpoint> endpoints;
+      boost::posix_time::ptime expiry;
+   };
+
+   boost::mutex mutex_;
+   std::map<std::string, Entry> cache_;
+};
 
 class TcpIpAsyncConnector :
       public boost::enable_shared_from_this<TcpIpAsyncConnector>,
@@ -58,6 +138,8 @@ public:
      : service_(ioService),
        pSocket_(pSocket),
        resolver_(ioService),
+       endpointIndex_(0),
+       attemptTimedOut_(false),
        isConnected_(false),
        hasFailed_(false)
    {
@@ -69,11 +151,15 @@ public:
                 const ConnectedHandler& connectedHandler,
                 const ErrorHandler& errorHandler,
                 const boost::posix_time::time_duration& timeout =
-                   boost::posix_time::time_duration(boost::posix_time::pos_infin))
+                   boost::posix_time::time_duration(boost::posix_time::pos_infin),
+                const boost::posix_time::time_duration& attemptTimeout =
+                   boost::posix_time::seconds(10))
    {
-      // save handlers
+      // save handlers and connection parameters
       connectedHandler_ = connectedHandler;
       errorHandler_ = errorHandler;
+      attemptTimeout_ = attemptTimeout;
+      cacheKey_ = address + ":" + port;
 
       if (!timeout.is_special())
       {
@@ -85,6 +171,18 @@ public:
                                                    boost::asio::placeholders::error));
       }
 
+      // consult the resolver cache before resolving (repeat connections
+      // to the same host skip DNS entirely while the entry is fresh)
+      if (TcpIpResolverCache::instance().lookup(cacheKey_, &endpoints_))
+      {
+         LOCK_MUTEX(mutex_)
+         {
+            tryNextEndpoint();
+         }
+         END_LOCK_MUTEX
+         return;
+      }
+
       // start an async resolve
       boost::asio::ip::tcp::resolver::query query(address, port);
       resolver_.async_resolve(
@@ -149,14 +247,20 @@ private:
                   return;
                }
 
+               // materialize the endpoint list and cache it for
+               // subsequent connections to the same host
+               endpoints_.clear();
+               endpointIndex_ = 0;
+               for (boost::asio::ip::tcp::resolver::iterator end;
+                    endpoint_iterator != end;
+                    ++endpoint_iterator)
+               {
+                  endpoints_.push_back(*endpoint_iterator);
+               }
+               TcpIpResolverCache::instance().store(cacheKey_, endpoints_);
+
                // try endpoints until we successfully connect with one
-               boost::asio::ip::tcp::endpoint endpoint = *endpoint_iterator;
-               pSocket_->async_connect(
-                  endpoint,
-                  boost::bind(&TcpIpAsyncConnector::handleConnect,
-                              TcpIpAsyncConnector::shared_from_this(),
-                              boost::asio::placeholders::error,
-                              ++endpoint_iterator));
+               tryNextEndpoint();
             }
             else
             {
@@ -168,12 +272,96 @@ private:
       END_LOCK_MUTEX
    }
 
-   void handleConnect(
-         const boost::system::error_code& ec,
-         boost::asio::ip::tcp::resolver::iterator endpoint_iterator)
+   // initiate a connection attempt against the next unattempted endpoint
+   // (must be called under mutex_). attempts other than the last are
+   // bounded by the per-attempt timeout so that a slow or unreachable
+   // first address doesn't stall the connection for the full OS connect
+   // timeout; the final endpoint gets unlimited time (subject to the
+   // overall connection timeout) to preserve previous behavior for
+   // single-address hosts
+   void tryNextEndpoint()
+   {
+      if (endpointIndex_ >= endpoints_.size())
+      {
+         // exhausted all endpoints -- drop any cached resolution (so the
+         // next connection re-resolves) and report the last connect error
+         TcpIpResolverCache::instance().remove(cacheKey_);
+         if (!lastErrorCode_)
+         {
+            lastErrorCode_ = boost::system::error_code(
+                     boost::system::errc::io_error,
+                     boost::system::system_category());
+         }
+         handleErrorCode(lastErrorCode_, ERROR_LOCATION);
+         return;
+      }
+
+      boost::asio::ip::tcp::endpoint endpoint = endpoints_[endpointIndex_++];
+
+      // arm the per-attempt timer when more endpoints remain
+      attemptTimedOut_ = false;
+      if (!attemptTimeout_.is_special() && endpointIndex_ < endpoints_.size())
+      {
+         pAttemptTimer_.reset(
+               new boost::asio::deadline_timer(service_, attemptTimeout_));
+         pAttemptTimer_->async_wait(boost::bind(&TcpIpAsyncConnector::onAttemptTimeout,
+                                                TcpIpAsyncConnector::shared_from_this(),
+                                                boost::asio::placeholders::error));
+      }
+
+      pSocket_->async_connect(
+         endpoint,
+         boost::bind(&TcpIpAsyncConnector::handleConnect,
+                     TcpIpAsyncConnector::shared_from_this(),
+                     boost::asio::placeholders::error));
+   }
+
+   void onAttemptTimeout(const boost::system::error_code& ec)
+   {
+      try
+      {
+         if (ec == boost::system::errc::operation_canceled)
+            return;
+
+         LOCK_MUTEX(mutex_)
+         {
+            if (isConnected_ || hasFailed_)
+               return;
+
+            // the current attempt is taking too long -- close the socket
+            // (aborting the in-flight connect) and move on to the next
+            // endpoint
+            attemptTimedOut_ = true;
+            lastErrorCode_ = boost::system::error_code(
+                     boost::system::errc::timed_out,
+                     boost::system::system_category());
+            pSocket_->close();
+         }
+         END_LOCK_MUTEX
+      }
+      CATCH_UNEXPECTED_ASYNC_CONNECTOR_EXCEPTION
+   }
+
+   void handleConnect(const boost::system::error_code& ec)
    {
       if (ec == boost::asio::error::operation_aborted)
+      {
+         // an aborted connect is terminal unless it was our own
+         // per-attempt timeout that canceled it
+         LOCK_MUTEX(mutex_)
+         {
+            if (!attemptTimedOut_ || isConnected_ || hasFailed_)
+               return;
+
+            try
+            {
+               tryNextEndpoint();
+            }
+            CATCH_UNEXPECTED_ASYNC_CONNECTOR_EXCEPTION
+         }
+         END_LOCK_MUTEX
          return;
+      }
 
       LOCK_MUTEX(mutex_)
       {
@@ -182,6 +370,9 @@ private:
 
          try
          {
+            if (pAttemptTimer_)
+               pAttemptTimer_->cancel();
+
             if (!ec)
             {
                isConnected_ = true;
@@ -189,25 +380,31 @@ private:
                if (pConnectionTimer_)
                   pConnectionTimer_->cancel();
 
+               // if an earlier endpoint failed before this one connected,
+               // refresh the cache with the winner first so subsequent
+               // connections try it immediately
+               if (endpointIndex_ > 1)
+               {
+                  std::vector<boost::asio::ip::tcp::endpoint> reordered;
+                  reordered.push_back(endpoints_[endpointIndex_ - 1]);
+                  for (std::size_t i = 0; i < endpoints_.size(); i++)
+                  {
+                     if (i != endpointIndex_ - 1)
+                        reordered.push_back(endpoints_[i]);
+                  }
+                  TcpIpResolverCache::instance().store(cacheKey_, reordered);
+               }
+
                if (connectedHandler_)
                   connectedHandler_();
             }
-            else if (endpoint_iterator !=
-                     boost::asio::ip::tcp::resolver::iterator())
-            {
-               // try next endpoint
-               pSocket_->close();
-               boost::asio::ip::tcp::endpoint endpoint = *endpoint_iterator;
-               pSocket_->async_connect(
-                  endpoint,
-                  boost::bind(&TcpIpAsyncConnector::handleConnect,
-                              TcpIpAsyncConnector::shared_from_this(),
-                              boost::asio::placeholders::error,
-                              ++endpoint_iterator));
-            }
             else
             {
-               handleErrorCode(ec, ERROR_LOCATION);
+               // try the next endpoint (the error is reported only if
+               // every endpoint fails)
+               lastErrorCode_ = ec;
+               pSocket_->close();
+               tryNextEndpoint();
             }
          }
          CATCH_UNEXPECTED_ASYNC_CONNECTOR_EXCEPTION
@@ -229,6 +426,9 @@ private:
       if (pConnectionTimer_)
          pConnectionTimer_->cancel();
 
+      if (pAttemptTimer_)
+         pAttemptTimer_->cancel();
+
       handleError(Error(ec, location));
    }
 
@@ -251,10 +451,19 @@ private:
    ConnectedHandler connectedHandler_;
    ErrorHandler errorHandler_;
 
+   // endpoint attempt state
+   std::string cacheKey_;
+   std::vector<boost::asio::ip::tcp::endpoint> endpoints_;
+   std::size_t endpointIndex_;
+   boost::system::error_code lastErrorCode_;
+   boost::posix_time::time_duration attemptTimeout_;
+   bool attemptTimedOut_;
+
    bool isConnected_;
    bool hasFailed_;
    boost::mutex mutex_;
    boost::shared_ptr<boost::asio::deadline_timer> pConnectionTimer_;
+   boost::shared_ptr<boost::asio::deadline_timer> pAttemptTimer_;
 };
 
 } // namespace http
@@ -16,6 +16,8 @@
 #ifndef CORE_HTTP_URI_HANDLER_HPP
 #define CORE_HTTP_URI_HANDLER_HPP
 
+#include <cstddef>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -44,8 +46,10 @@ typedef boost::function<void(const Request&,Response*)> UriHandlerFunction;
 typedef boost::function<bool(const http::Request&, http::Response*)> 
                                                          UriFilterFunction;
 
+// upload handlers receive the form data by mutable reference so they can
+// take ownership of the buffer (moving from it) instead of copying it
 typedef boost::function<bool(const Request&,
-                             const std::string&,
+                             std::string&,
                              bool,
                              const UriHandlerFunctionContinuation&)> UriAsyncUploadHandlerFunction;
 
@@ -60,9 +64,11 @@ public:
    UriHandler(const std::string& prefix, const UriAsyncUploadHandlerFunction& function);
 
    // COPYING: via compiler
-   
+
    bool matches(const std::string& uri) const;
-   
+
+   const std::string& prefix() const { return prefix_; }
+
    UriAsyncHandlerFunctionVariant function() const;
   
    // implement UriHandlerFunction concept
@@ -82,16 +88,29 @@ private:
 class UriHandlers
 {
 public:
-   UriHandlers() {}
-   
+   UriHandlers() : trie_(1) {}
+
    // COPYING: via compiler
-   
+
    void add(const UriHandler& handler);
-   
+
    boost::optional<UriAsyncHandlerFunctionVariant> handlerFor(const std::string& uri) const;
-   
+
 private:
+   // node of the prefix trie used for dispatch; lookup cost depends only
+   // on the uri length, not on the number of registered handlers
+   struct TrieNode
+   {
+      static constexpr std::size_t kNoHandler = static_cast<std::size_t>(-1);
+
+      TrieNode() : handlerIndex(kNoHandler) {}
+
+      std::map<char, std::size_t> children;
+      std::size_t handlerIndex;
+   };
+
    std::vector<UriHandler> uriHandlers_;
+   std::vector<TrieNode> trie_; // node 0 is the root
 };
 
 inline void notFoundHandler(const Request& request, Response* pResponse)
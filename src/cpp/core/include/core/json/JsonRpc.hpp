@@ -195,7 +195,14 @@ bool parseJsonRpcRequestForMethod(const std::string& input,
 //
 // json parameter reading helpers
 //
-   
+// the variadic readParams below binds each handler's parameter list at
+// compile time (one typed extraction chain is generated per call site,
+// with the per-parameter type checks reduced to a tag comparison). a
+// parameter declared as boost::string_view borrows directly from the
+// request's parse buffer instead of copying -- use it for parameters
+// consumed within the handler (the view is only valid while the
+// JsonRpcRequest is alive)
+//
 
 inline core::Error readParam(const Array& params,
                              unsigned int index, 
@@ -89,20 +89,27 @@ private:
 
    struct StoredTranslationUnit
    {
-      StoredTranslationUnit() : lastWriteTime(0), tu(nullptr) {}
+      StoredTranslationUnit() : lastWriteTime(0), tu(nullptr), lastUse(0) {}
       StoredTranslationUnit(const std::vector<std::string>& compileArgs,
                             std::time_t lastWriteTime,
                             CXTranslationUnit tu)
-         : compileArgs(compileArgs), lastWriteTime(lastWriteTime), tu(tu)
+         : compileArgs(compileArgs), lastWriteTime(lastWriteTime), tu(tu),
+           lastUse(0)
       {
       }
       std::vector<std::string> compileArgs;
       std::time_t lastWriteTime;
       CXTranslationUnit tu;
+      unsigned long lastUse;
    };
    typedef std::map<std::string,StoredTranslationUnit> TranslationUnits;
    TranslationUnits translationUnits_;
 
+   // evict the least recently used translation units beyond maxUnits
+   void enforceTranslationUnitLimit(std::size_t maxUnits);
+
+   unsigned long useCounter_;
+
    CompilationDatabase compilationDB_;
 
    int verbose_;
@@ -16,7 +16,10 @@
 #ifndef CORE_MARKDOWN_MARKDOWN_HPP
 #define CORE_MARKDOWN_MARKDOWN_HPP
 
+#include <cstdint>
+#include <map>
 #include <string>
+#include <utility>
 
 namespace rstudio {
 namespace core {
@@ -101,6 +104,27 @@ Error markdownToHTML(const std::string& markdownInput,
                      const HTMLOptions& htmlOptions,
                      std::string* pHTMLOutput);
 
+// Cache of rendered HTML for markdown blocks, used by the incremental
+// overload of markdownToHTML below. Create one per document and pass it
+// to successive renders of that document; it retains only the blocks
+// present in the most recent render. Entries are keyed by a hash of the
+// block source plus the document's link definitions (which can affect
+// any block), with the source stored alongside to guard against hash
+// collisions.
+struct HTMLBlockCache
+{
+   std::map<uint64_t, std::pair<std::string, std::string> > entries;
+};
+
+// render markdown to HTML incrementally -- splits the input at stable
+// block boundaries and re-renders only the blocks which have changed
+// since the render recorded in the cache (falls back to a full render
+// when a table of contents is requested)
+Error markdownToHTML(const std::string& markdownInput,
+                     const Extensions& extensions,
+                     const HTMLOptions& htmlOptions,
+                     HTMLBlockCache* pCache,
+                     std::string* pHTMLOutput);
 
 bool isMathJaxRequired(const std::string& htmlOutput);
 
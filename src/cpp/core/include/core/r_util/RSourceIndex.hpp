@@ -195,6 +195,14 @@ public:
    RSourceIndex(const std::string& context,
                 const std::string& code);
 
+   // Construct an index directly from previously indexed items (e.g. a
+   // persisted index loaded from disk); no parsing is performed
+   RSourceIndex(const std::string& context,
+                const std::vector<RSourceItem>& items)
+      : context_(context), items_(items)
+   {
+   }
+
    const std::string& context() const { return context_; }
 
    template <typename OutputIterator>
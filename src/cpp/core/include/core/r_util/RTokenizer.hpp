@@ -285,6 +285,12 @@ public:
    explicit RTokens(const std::wstring& code, int flags = None)
       : tokenizer_(code)
    {
+      // tokens are stored in a single contiguous buffer (their content is
+      // a view into the tokenizer's copy of the document, not a per-token
+      // copy); reserve an estimate up front so tokenizing a large document
+      // doesn't repeatedly reallocate and copy the buffer as it grows
+      tokens_.reserve(code.size() / 8);
+
       while (RToken token = tokenizer_.nextToken())
       {
          if ((flags & StripWhitespace) && token.type() == RToken::WHITESPACE)
@@ -135,6 +135,15 @@ private:
 
 std::ostream& operator<<(std::ostream& os, const RVersion& version);
 
+// collect the candidate R home directories that enumerateRVersions would
+// probe (optionally including the well-known installation locations),
+// de-duplicated and filtered on existence. this only stats the
+// filesystem, so callers can use it to fingerprint the set of
+// installations without launching R
+std::vector<FilePath> candidateRHomePaths(
+                              std::vector<FilePath> rHomePaths,
+                              bool scanForOtherVersions);
+
 std::vector<RVersion> enumerateRVersions(
                               std::vector<FilePath> rHomePaths,
                               std::vector<r_util::RVersion> rEntries,
@@ -41,8 +41,40 @@ core::Error HMAC_SHA2(const std::string& data,
 core::Error sha256(const std::string& message,
                    std::string* pHash);
 
+// single-shot authenticated encryption (AES-256-GCM) intended for
+// high-frequency small messages (e.g. cookies, RPC fields). the output
+// carries the randomly generated IV and the authentication tag alongside
+// the ciphertext (IV || ciphertext || tag) so callers only manage the key;
+// key schedules and cipher contexts are pooled and reused across calls
+core::Error aeadEncrypt(const std::string& plainText,
+                        const std::vector<unsigned char>& key,
+                        std::vector<unsigned char>* pCipherText);
+
+core::Error aeadDecrypt(const std::vector<unsigned char>& cipherText,
+                        const std::vector<unsigned char>& key,
+                        std::string* pPlainText);
+
+core::Error aeadEncryptAndBase64Encode(const std::string& plainText,
+                                       const std::vector<unsigned char>& key,
+                                       std::string* pCipherText);
+
+core::Error base64DecodeAndAeadDecrypt(const std::string& cipherText,
+                                       const std::vector<unsigned char>& key,
+                                       std::string* pPlainText);
+
 core::Error rsaInit();
 
+// pre-computes sign-in keypairs until `targetCount` are staged; key
+// generation takes tens of milliseconds, so call this from a background
+// thread to keep it off request threads
+core::Error rsaPrecomputeKeys(std::size_t targetCount);
+
+// installs a pre-computed keypair as the active sign-in key (cheap: a
+// pointer swap). the retired key continues to decrypt for a grace window
+// so forms rendered against the old public key still work. no-op when no
+// pre-computed key is available
+void rsaRotateKey();
+
 core::Error rsaSign(const std::string& message,
                     const std::string& pemPrivateKey,
                     std::string* pOutSignature);
@@ -16,6 +16,8 @@
 #ifndef CORE_SYSTEM_FILE_CHANGE_EVENT_HPP
 #define CORE_SYSTEM_FILE_CHANGE_EVENT_HPP
 
+#include <algorithm>
+#include <iterator>
 #include <string>
 #include <iostream>
 #include <vector>
@@ -89,31 +91,23 @@ inline std::ostream& operator << (std::ostream& ostr,
    return ostr;
 }
 
+namespace detail {
+
+// linear two-pointer diff over ranges already sorted by path
 template<typename PreviousIterator, typename CurrentIterator>
-void collectFileChangeEvents(PreviousIterator prevBegin,
+void collectSortedFileChangeEvents(
+                             PreviousIterator prevIt,
                              PreviousIterator prevEnd,
-                             CurrentIterator currBegin,
+                             CurrentIterator currIt,
                              CurrentIterator currEnd,
                              const boost::function<bool(const FileInfo&)>& filter,
                              std::vector<FileChangeEvent>* pEvents)
 {
-   // sort the ranges
-   std::vector<FileInfo> prev;
-   std::copy(prevBegin, prevEnd, std::back_inserter(prev));
-   std::sort(prev.begin(), prev.end(), fileInfoPathLessThan);
-   std::vector<FileInfo> curr;
-   std::copy(currBegin, currEnd, std::back_inserter(curr));
-   std::sort(curr.begin(), curr.end(), fileInfoPathLessThan);
-
-   // initalize the iterators
-   std::vector<FileInfo>::iterator prevIt = prev.begin();
-   std::vector<FileInfo>::iterator currIt = curr.begin();
-
    FileInfo noFile;
-   while (prevIt != prev.end() || currIt != curr.end())
+   while (prevIt != prevEnd || currIt != currEnd)
    {
-      const FileInfo& prevFile = prevIt != prev.end() ? *prevIt : noFile;
-      const FileInfo& currFile = currIt != curr.end() ? *currIt : noFile;
+      const FileInfo& prevFile = prevIt != prevEnd ? *prevIt : noFile;
+      const FileInfo& currFile = currIt != currEnd ? *currIt : noFile;
 
       int comp;
       if (prevFile.empty())
@@ -157,6 +151,65 @@ void collectFileChangeEvents(PreviousIterator prevBegin,
    }
 }
 
+} // namespace detail
+
+template<typename PreviousIterator, typename CurrentIterator>
+void collectFileChangeEvents(PreviousIterator prevBegin,
+                             PreviousIterator prevEnd,
+                             CurrentIterator currBegin,
+                             CurrentIterator currEnd,
+                             const boost::function<bool(const FileInfo&)>& filter,
+                             std::vector<FileChangeEvent>* pEvents)
+{
+   // the diff is a linear merge over path-sorted ranges. ranges which
+   // arrive already sorted (e.g. scan results for a single directory,
+   // or listings maintained in sorted order) are diffed in place;
+   // otherwise we materialize and sort a snapshot of the range first
+   std::vector<FileInfo> prev;
+   if (!std::is_sorted(prevBegin, prevEnd, fileInfoPathLessThan))
+   {
+      prev.reserve(std::distance(prevBegin, prevEnd));
+      std::copy(prevBegin, prevEnd, std::back_inserter(prev));
+      std::sort(prev.begin(), prev.end(), fileInfoPathLessThan);
+   }
+   std::vector<FileInfo> curr;
+   if (!std::is_sorted(currBegin, currEnd, fileInfoPathLessThan))
+   {
+      curr.reserve(std::distance(currBegin, currEnd));
+      std::copy(currBegin, currEnd, std::back_inserter(curr));
+      std::sort(curr.begin(), curr.end(), fileInfoPathLessThan);
+   }
+
+   // dispatch to the merge using the sorted copies only where they
+   // were required (an empty copy means the input range was either
+   // already sorted or itself empty -- in both cases diffing over the
+   // original range is correct)
+   if (!prev.empty() && !curr.empty())
+   {
+      detail::collectSortedFileChangeEvents(prev.begin(), prev.end(),
+                                            curr.begin(), curr.end(),
+                                            filter, pEvents);
+   }
+   else if (!prev.empty())
+   {
+      detail::collectSortedFileChangeEvents(prev.begin(), prev.end(),
+                                            currBegin, currEnd,
+                                            filter, pEvents);
+   }
+   else if (!curr.empty())
+   {
+      detail::collectSortedFileChangeEvents(prevBegin, prevEnd,
+                                            curr.begin(), curr.end(),
+                                            filter, pEvents);
+   }
+   else
+   {
+      detail::collectSortedFileChangeEvents(prevBegin, prevEnd,
+                                            currBegin, currEnd,
+                                            filter, pEvents);
+   }
+}
+
 template<typename PreviousIterator, typename CurrentIterator>
 void collectFileChangeEvents(PreviousIterator prevBegin,
                              PreviousIterator prevEnd,
@@ -97,9 +97,19 @@ struct Callbacks
    // monitor is automatically unregistered if a monitoring error occurs)
    boost::function<void(const core::Error&)> onMonitoringError;
 
-   // callback which occurs when files change
+   // callback which occurs when files change. events are coalesced into
+   // batches while they await delivery, so a single invocation can cover
+   // all of the changes detected since the last call to checkForChanges
    boost::function<void(const std::vector<FileChangeEvent>&)> onFilesChanged;
 
+   // callback which occurs when a storm of change events is detected (e.g.
+   // as the result of a git checkout or archive extraction). when this
+   // callback is set, pending events are discarded once the storm threshold
+   // is crossed and this callback is invoked instead of onFilesChanged --
+   // consumers should respond with a single rescan rather than processing
+   // the (potentially tens of thousands of) individual events
+   boost::function<void()> onEventStorm;
+
    // callback which occurs when the monitor is fully unregistered. note that
    // this callback can occur as a result of:
    //    - an explicit call to unregisterMonitor;
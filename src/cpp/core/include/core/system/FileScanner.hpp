@@ -17,7 +17,15 @@
 #ifndef CORE_SYSTEM_FILE_SCANNER_HPP
 #define CORE_SYSTEM_FILE_SCANNER_HPP
 
+#include <map>
+#include <string>
+#include <vector>
+
 #include <boost/function.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <core/BoostThread.hpp>
 
 #include <shared_core/Error.hpp>
 #include <core/FileInfo.hpp>
@@ -34,7 +42,51 @@ namespace core {
 //   (1) The FileInfo::isSymlink member returns accurate symlink status
 //   (2) Symlink to directories are not traversed recursively
 
-namespace system {  
+namespace system {
+
+class FileChangeEvent;
+
+// cache of per-directory scan snapshots. a scan with a cache attached
+// records the (pre-filter) contents of each directory it visits, and
+// subsequent scans read untouched directories from the cache rather
+// than hitting the filesystem. consumers are responsible for
+// invalidation -- typically by feeding file-monitor change events to
+// processFileChanges. snapshots are stamped with a generation counter
+// so that an invalidation arriving while a scan is in flight prevents
+// the (possibly stale) in-flight results from entering the cache
+class FileScanCache : boost::noncopyable
+{
+public:
+   FileScanCache();
+
+   // returns the generation to pass to subsequent calls to store
+   uint64_t beginScan();
+
+   // retrieve the cached contents of a directory (returns false on miss)
+   bool lookup(const std::string& dirPath, std::vector<FileInfo>* pChildren);
+
+   // store a directory snapshot captured during a scan begun at the
+   // specified generation (ignored if an invalidation occurred after
+   // the scan began)
+   void store(const std::string& dirPath,
+              uint64_t scanGeneration,
+              const std::vector<FileInfo>& children);
+
+   // invalidate the snapshot for a single directory
+   void invalidate(const std::string& dirPath);
+
+   // invalidate the directories affected by file-monitor change events
+   // (for each event, the directory containing the changed file as well
+   // as the changed path itself if it refers to a directory)
+   void processFileChanges(const std::vector<FileChangeEvent>& events);
+
+   void clear();
+
+private:
+   boost::mutex mutex_;
+   uint64_t generation_;
+   std::map<std::string, std::vector<FileInfo> > cache_;
+};
 
 struct FileScannerOptions
 {
@@ -47,6 +99,12 @@ struct FileScannerOptions
    bool yield;
    boost::function<bool(const FileInfo&)> filter;
    boost::function<Error(const FileInfo&)> onBeforeScanDir;
+
+   // optional scan cache -- when provided, directories whose cached
+   // snapshots are still valid are read from the cache rather than
+   // re-enumerated (filters are applied per-scan so a shared cache can
+   // serve consumers with different filters)
+   boost::shared_ptr<FileScanCache> cache;
 };
 
 Error scanFiles(const tree<FileInfo>::iterator_base& fromNode,
@@ -16,6 +16,7 @@
 #ifndef CORE_SYSTEM_POSIX_NFS_HPP
 #define CORE_SYSTEM_POSIX_NFS_HPP
 
+#include <cstdint>
 #include <string>
 
 namespace rstudio {
@@ -34,7 +35,27 @@ namespace nfs {
 
 core::Error statWithCacheClear(const core::FilePath& path, bool *pCleared,
                                struct stat* pSt);
-   
+
+// async attribute revalidation service. paths registered here are
+// periodically refreshed (with the cache-clearing stat above) on a
+// background thread, so hot paths on NFS don't need blocking
+// revalidation syscalls on interactive codepaths. each registered path
+// has a generation counter that is bumped whenever a refresh observes
+// changed attributes; consumers cache derived state and recompute it
+// only when the generation moves (an atomic read, no syscall).
+
+// register a path for background revalidation; returns a handle for the
+// other functions below (the service thread starts on first use)
+int registerRevalidationPath(const core::FilePath& path);
+
+// stop revalidating a previously registered path
+void unregisterRevalidationPath(int handle);
+
+// current attribute generation for a registered path. starts at zero
+// and increments each time a background refresh sees the path's mtime,
+// ctime, size or inode change
+std::uint64_t revalidationGeneration(int handle);
+
 } // nfs
 } // namespace system
 } // namespace core
@@ -16,6 +16,7 @@
 #ifndef CORE_SYSTEM_RECYCLE_BIN_HPP
 #define CORE_SYSTEM_RECYCLE_BIN_HPP
 
+#include <boost/function.hpp>
 
 namespace rstudio {
 namespace core {
@@ -25,9 +26,23 @@ class FilePath;
 
 namespace system {
 namespace recycle_bin {
-      
+
 Error sendTo(const FilePath& filePath);
 
+// remove a file or directory asynchronously: the target is immediately
+// renamed into a hidden sibling graveyard (a single rename, so the
+// user-visible latency is constant regardless of size), then unlinked
+// on a background service thread with rate limiting so bulk deletes
+// don't monopolize filesystem metadata operations. the optional
+// completion callback is invoked from the service thread once
+// reclamation finishes. graveyards orphaned by a crash have uniquely
+// generated names and are simply re-deleted the next time their parent
+// is removed
+Error removeAsync(
+   const FilePath& filePath,
+   const boost::function<void(const Error&)>& onComplete =
+                                    boost::function<void(const Error&)>());
+
 } // namespace recycle_bin
 } // namespace system
 } // namespace core
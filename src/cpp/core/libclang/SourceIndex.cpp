@@ -48,6 +48,12 @@ bool isHeaderExtension(const std::string& ex)
    return ex == ".h" || ex == ".hh" || ex == ".hpp";
 }
 
+// maximum number of translation units retained in memory. each parsed
+// unit can occupy hundreds of megabytes for heavily templated code, so
+// retain only the most recently used ones (completion and diagnostics
+// revolve around the files the user is actively editing)
+const std::size_t kMaxStoredTranslationUnits = 10;
+
 } // anonymous namespace
 
 bool SourceIndex::isSourceFile(const FilePath& filePath)
@@ -71,6 +77,7 @@ bool SourceIndex::isHeaderFile(const FilePath& filePath)
 SourceIndex::SourceIndex(CompilationDatabase compilationDB, int verbose)
 {
    verbose_ = verbose;
+   useCounter_ = 0;
    index_ = clang().createIndex(0, (verbose_ > 0) ? 1 : 0);
    compilationDB_ = compilationDB;
 }
@@ -128,6 +135,27 @@ void SourceIndex::removeAllTranslationUnits()
 }
 
 
+void SourceIndex::enforceTranslationUnitLimit(std::size_t maxUnits)
+{
+   while (translationUnits_.size() > maxUnits)
+   {
+      TranslationUnits::iterator lruIt = translationUnits_.begin();
+      for (TranslationUnits::iterator it = translationUnits_.begin();
+           it != translationUnits_.end();
+           ++it)
+      {
+         if (it->second.lastUse < lruIt->second.lastUse)
+            lruIt = it;
+      }
+
+      if (verbose_ > 0)
+         std::cerr << "CLANG EVICT INDEX (LRU): " << lruIt->first << std::endl;
+
+      clang().disposeTranslationUnit(lruIt->second.tu);
+      translationUnits_.erase(lruIt);
+   }
+}
+
 void SourceIndex::primeEditorTranslationUnit(const std::string& filename)
 {
    // if we have no record of this translation unit then do a first pass
@@ -192,6 +220,9 @@ TranslationUnit SourceIndex::getTranslationUnit(const std::string& filename,
       // alias record
       StoredTranslationUnit& stored = it->second;
 
+      // mark the unit as recently used
+      stored.lastUse = ++useCounter_;
+
       // already up to date?
       if (!alwaysReparse &&
           (args == stored.compileArgs) &&
@@ -278,9 +309,12 @@ TranslationUnit SourceIndex::getTranslationUnit(const std::string& filename,
    // save and return it if we succeeded
    if (tu != nullptr)
    {
-      translationUnits_[filename] = StoredTranslationUnit(args,
-                                                          lastWriteTime,
-                                                          tu);
+      StoredTranslationUnit stored(args, lastWriteTime, tu);
+      stored.lastUse = ++useCounter_;
+      translationUnits_[filename] = stored;
+
+      // bound memory usage by evicting the least recently used units
+      enforceTranslationUnitLimit(kMaxStoredTranslationUnits);
 
       TranslationUnit unit(filename, tu, &unsavedFiles_);
       if (verbose_ > 0)
@@ -307,6 +307,155 @@ void stripMetadata(std::string* pInput)
    }
 }
 
+// classification of a line by the block construct it could begin or
+// continue across a blank line
+enum LineClass
+{
+   LineClassPlain,
+   LineClassHtml,
+   LineClassIndented,
+   LineClassListItem,
+   LineClassBlockquote
+};
+
+LineClass classifyLine(const std::string& line)
+{
+   if (line.empty())
+      return LineClassPlain;
+
+   if (line[0] == '<')
+      return LineClassHtml;
+
+   if (boost::algorithm::starts_with(line, "    ") || line[0] == '\t')
+      return LineClassIndented;
+
+   boost::regex listItemRegex("^ {0,3}([-*+] |\\d+[.)] )");
+   if (regex_utils::search(line, listItemRegex))
+      return LineClassListItem;
+
+   boost::regex blockquoteRegex("^ {0,3}>");
+   if (regex_utils::search(line, blockquoteRegex))
+      return LineClassBlockquote;
+
+   return LineClassPlain;
+}
+
+// returns true if a blank line between these two lines is a stable
+// block boundary -- i.e. no construct spans it
+bool isSafeBoundary(const std::string& prevLine, const std::string& nextLine)
+{
+   LineClass prev = classifyLine(prevLine);
+   LineClass next = classifyLine(nextLine);
+
+   // raw html blocks can extend past blank lines in either direction
+   // (though a closing tag is a safe place to end one)
+   bool prevClosesHtml = boost::algorithm::starts_with(prevLine, "</");
+   if ((prev == LineClassHtml && !prevClosesHtml) || next == LineClassHtml)
+      return false;
+
+   // indented code spans a blank line only when both sides are indented
+   if (prev == LineClassIndented && next == LineClassIndented)
+      return false;
+
+   // a loose list continues across a blank line into another item, an
+   // indented continuation, or any indented line
+   if (prev == LineClassListItem &&
+       (next == LineClassListItem ||
+        next == LineClassIndented ||
+        (!nextLine.empty() && (nextLine[0] == ' ' || nextLine[0] == '\t'))))
+   {
+      return false;
+   }
+
+   // keep adjacent blockquotes together (renderers differ on whether
+   // they merge)
+   if (prev == LineClassBlockquote && next == LineClassBlockquote)
+      return false;
+
+   return true;
+}
+
+// split markdown source at blank lines which are stable block
+// boundaries: outside fenced code, and not spanned by any construct
+void splitIntoBlocks(const std::string& input,
+                     std::vector<std::string>* pBlocks)
+{
+   std::vector<std::string> lines;
+   boost::algorithm::split(lines, input, boost::algorithm::is_any_of("\n"));
+
+   boost::regex fenceRegex("^ {0,3}(`{3,}|~{3,})");
+
+   std::string current;
+   std::string lastNonBlank;
+   bool inFence = false;
+   for (std::size_t i = 0; i < lines.size(); i++)
+   {
+      const std::string& line = lines[i];
+      bool blank = boost::algorithm::trim_copy(line).empty();
+
+      if (!inFence && blank)
+      {
+         // find the next non-blank line
+         std::size_t next = i + 1;
+         while (next < lines.size() &&
+                boost::algorithm::trim_copy(lines[next]).empty())
+         {
+            next++;
+         }
+
+         std::string nextLine = (next < lines.size()) ? lines[next]
+                                                      : std::string();
+         if (!current.empty() && isSafeBoundary(lastNonBlank, nextLine))
+         {
+            pBlocks->push_back(current);
+            current.clear();
+            lastNonBlank.clear();
+            i = next - 1;
+            continue;
+         }
+      }
+
+      if (!blank && regex_utils::search(line, fenceRegex))
+         inFence = !inFence;
+
+      current.append(line);
+      current.push_back('\n');
+      if (!blank)
+         lastNonBlank = line;
+   }
+
+   if (!current.empty())
+      pBlocks->push_back(current);
+}
+
+// collect reference link definitions -- they can be referenced from any
+// block, so each block is rendered with the full set appended
+void collectLinkDefinitions(const std::string& input,
+                            std::string* pDefinitions)
+{
+   std::vector<std::string> lines;
+   boost::algorithm::split(lines, input, boost::algorithm::is_any_of("\n"));
+
+   boost::regex fenceRegex("^ {0,3}(`{3,}|~{3,})");
+   boost::regex definitionRegex("^ {0,3}\\[[^\\]]+\\]:\\s+\\S");
+
+   bool inFence = false;
+   for (const std::string& line : lines)
+   {
+      if (regex_utils::search(line, fenceRegex))
+      {
+         inFence = !inFence;
+         continue;
+      }
+
+      if (!inFence && regex_utils::search(line, definitionRegex))
+      {
+         pDefinitions->append(line);
+         pDefinitions->push_back('\n');
+      }
+   }
+}
+
 } // anonymous namespace
 
 // render markdown to HTML -- assumes UTF-8 encoding
@@ -461,6 +610,68 @@ Error markdownToHTML(const std::string& markdownInput,
    return Success();
 }
 
+// render markdown to HTML incrementally -- assumes UTF-8 encoding
+Error markdownToHTML(const std::string& markdownInput,
+                     const Extensions& extensions,
+                     const HTMLOptions& options,
+                     HTMLBlockCache* pCache,
+                     std::string* pHTMLOutput)
+{
+   // a table of contents is a whole-document affair; no cache means
+   // nothing to be incremental against
+   if (options.toc || pCache == nullptr)
+      return markdownToHTML(markdownInput, extensions, options, pHTMLOutput);
+
+   // strip metadata once up front so it can't bleed into the first block
+   std::string input = markdownInput;
+   if (extensions.stripMetadata)
+      stripMetadata(&input);
+
+   std::string definitions;
+   collectLinkDefinitions(input, &definitions);
+
+   std::vector<std::string> blocks;
+   splitIntoBlocks(input, &blocks);
+
+   // each block already has metadata stripped
+   Extensions blockExtensions = extensions;
+   blockExtensions.stripMetadata = false;
+
+   HTMLBlockCache updated;
+   for (const std::string& block : blocks)
+   {
+      std::string source = block;
+      if (!definitions.empty())
+         source.append("\n").append(definitions);
+
+      uint64_t key = string_utils::hashStable<uint64_t>(source);
+
+      std::string html;
+      std::map<uint64_t, std::pair<std::string, std::string> >::iterator
+            it = pCache->entries.find(key);
+      if (it != pCache->entries.end() && it->second.first == source)
+      {
+         html = it->second.second;
+      }
+      else
+      {
+         // render through the standard pipeline so math filtering,
+         // html preservation, etc. all apply per-block
+         Error error = markdownToHTML(source, blockExtensions, options, &html);
+         if (error)
+            return error;
+      }
+
+      updated.entries[key] = std::make_pair(source, html);
+      pHTMLOutput->append(html);
+   }
+
+   // retain only the blocks present in this render
+   pCache->entries.swap(updated.entries);
+
+   return Success();
+}
+
 bool isMathJaxRequired(const std::string& htmlOutput)
 {
    return requiresMathjax(htmlOutput);
@@ -591,26 +591,35 @@ RToken RTokenizer::consumeToken(RToken::TokenType tokenType,
 class ConversionCache
 {
 public:
-   
+
    typedef std::wstring key_type;
    typedef std::string mapped_type;
-   
-   bool contains(const RToken& token) const
-   {
-      return database_.count(token.content());
-   }
-   
-   std::string& get(const RToken& token)
-   {
-      return database_[token.content()];
-   }
-   
-   void put(const RToken& token, const mapped_type& value)
+
+   // convert the token's content to utf-8, caching the result. the lint
+   // path converts millions of tokens (most of them drawn from a small set
+   // of identifiers and operators), so this is a single map traversal: one
+   // lookup locates the insertion point and the conversion is only
+   // performed on a miss
+   const std::string& convert(const RToken& token)
    {
-      database_[token.content()] = value;
+      // most documents draw tokens from a small working set, but
+      // pathological input (e.g. generated code with many unique literals)
+      // shouldn't grow the cache without bound
+      if (database_.size() > kMaxEntries)
+         database_.clear();
+
+      std::wstring key = token.content();
+      std::map<key_type, mapped_type>::iterator it = database_.lower_bound(key);
+      if (it == database_.end() || it->first != key)
+      {
+         it = database_.insert(
+                  it, std::make_pair(key, string_utils::wideToUtf8(key)));
+      }
+      return it->second;
    }
-   
+
 private:
+   static const std::size_t kMaxEntries = 16384;
    std::map<key_type, mapped_type> database_;
 };
 
@@ -622,13 +631,7 @@ ConversionCache& conversionCache()
 
 const std::string& RToken::contentAsUtf8() const
 {
-   ConversionCache& cache = conversionCache();
-   if (cache.contains(*this))
-      return cache.get(*this);
-   
-   std::string result = string_utils::wideToUtf8(content());
-   cache.put(*this, result);
-   return cache.get(*this);
+   return conversionCache().convert(*this);
 }
 
 std::string RToken::asString() const
@@ -19,6 +19,7 @@
 #include <algorithm>
 
 #include <boost/bind.hpp>
+#include <boost/thread.hpp>
 
 #include <core/Algorithm.hpp>
 #include <core/FileSerializer.hpp>
@@ -103,16 +104,10 @@ std::ostream& operator<<(std::ostream& os, const RVersion& version)
    return os;
 }
 
-std::vector<RVersion> enumerateRVersions(
+std::vector<FilePath> candidateRHomePaths(
                               std::vector<FilePath> rHomePaths,
-                              std::vector<r_util::RVersion> rEntries,
-                              bool scanForOtherVersions,
-                              const FilePath& ldPathsScript,
-                              const std::string& ldLibraryPath,
-                              const FilePath& modulesBinaryPath)
+                              bool scanForOtherVersions)
 {
-   std::vector<RVersion> rVersions;
-
    // scan if requested
    if (scanForOtherVersions)
    {
@@ -136,119 +131,190 @@ std::vector<RVersion> enumerateRVersions(
    rHomePaths.erase(std::unique(rHomePaths.begin(), rHomePaths.end()),
                     rHomePaths.end());
 
+   return rHomePaths;
+}
+
+std::vector<RVersion> enumerateRVersions(
+                              std::vector<FilePath> rHomePaths,
+                              std::vector<r_util::RVersion> rEntries,
+                              bool scanForOtherVersions,
+                              const FilePath& ldPathsScript,
+                              const std::string& ldLibraryPath,
+                              const FilePath& modulesBinaryPath)
+{
+   std::vector<RVersion> rVersions;
+
+   // collect, filter, and de-duplicate the candidate home paths
+   rHomePaths = candidateRHomePaths(rHomePaths, scanForOtherVersions);
+
    // resolve user defined r entries first
    // when duplicates are removed, the default paths
    // that are equivalent to the user defined entries (but which contain less metadata) will be removed
-   for (r_util::RVersion& rEntry : rEntries)
+   //
+   // entries are probed in parallel (see note on the home path scan below)
+   // with results folded back in entry order
+   std::vector<RVersion> entryResults(rEntries.size());
+   std::vector<int> entryDetected(rEntries.size(), 0);
+
+   std::size_t numEntryWorkers = std::min<std::size_t>(
+            std::max<std::size_t>(boost::thread::hardware_concurrency(), 1),
+            std::min<std::size_t>(rEntries.size(), 4));
+
+   boost::thread_group entryWorkers;
+   for (std::size_t w = 0; w < numEntryWorkers; w++)
    {
-      // compute R script path
-      FilePath rScriptPath = rEntry.homeDir().completeChildPath("bin/R");
-      if (!rScriptPath.exists())
-      {
-         if (rEntry.module().empty())
-         {
-            LOG_ERROR_MESSAGE("Invalid R version specified - path does not exist: " +
-                              rScriptPath.getAbsolutePath() + " - version will be skipped");
-            continue;
-         }
-         else
-         {
-            // if we are loading a module and no R path is defined, that's okay
-            // just mark the path as empty and the default R on the module path
-            // will be used instead
-            rScriptPath = FilePath();
-         }
-      }
-
-      // get the prelaunch script to be executed before attempting to load R to read version info
-      // if the prelaunch script is specific to users (starts with ~), don't attempt to use it
-      // as it is likely not available for the RStudio account
-      std::string prelaunchScript = rEntry.prelaunchScript();
-      if (prelaunchScript.find('~') == 0)
+      entryWorkers.create_thread([&, w]()
       {
-         prelaunchScript = "";
-      }
-
-      std::string rDiscoveredScriptPath, rVersion, errMsg;
-      core::system::Options env;
-      if (detectREnvironment(rScriptPath,
-                             ldPathsScript,
-                             ldLibraryPath,
-                             &rDiscoveredScriptPath,
-                             &rVersion,
-                             &env,
-                             &errMsg,
-                             prelaunchScript,
-                             rEntry.module(),
-                             modulesBinaryPath))
-      {
-         // merge the found environment with the existing user-overridden environment
-         // we ensure that the user overrides overwrite whatever environment we established automatically
-         core::system::Options userEnv = rEntry.environment();
-         core::system::Options mergedEnv;
-
-         // set automatically found variables first
-         for (const core::system::Option& option : env)
+         for (std::size_t entryIndex = w;
+              entryIndex < rEntries.size();
+              entryIndex += numEntryWorkers)
          {
-            core::system::setenv(&mergedEnv, option.first, option.second);
+            r_util::RVersion& rEntry = rEntries[entryIndex];
+            // compute R script path
+            FilePath rScriptPath = rEntry.homeDir().completeChildPath("bin/R");
+            if (!rScriptPath.exists())
+            {
+               if (rEntry.module().empty())
+               {
+                  LOG_ERROR_MESSAGE("Invalid R version specified - path does not exist: " +
+                                    rScriptPath.getAbsolutePath() + " - version will be skipped");
+                  continue;
+               }
+               else
+               {
+                  // if we are loading a module and no R path is defined, that's okay
+                  // just mark the path as empty and the default R on the module path
+                  // will be used instead
+                  rScriptPath = FilePath();
+               }
+            }
+
+            // get the prelaunch script to be executed before attempting to load R to read version info
+            // if the prelaunch script is specific to users (starts with ~), don't attempt to use it
+            // as it is likely not available for the RStudio account
+            std::string prelaunchScript = rEntry.prelaunchScript();
+            if (prelaunchScript.find('~') == 0)
+            {
+               prelaunchScript = "";
+            }
+
+            std::string rDiscoveredScriptPath, rVersion, errMsg;
+            core::system::Options env;
+            if (detectREnvironment(rScriptPath,
+                                   ldPathsScript,
+                                   ldLibraryPath,
+                                   &rDiscoveredScriptPath,
+                                   &rVersion,
+                                   &env,
+                                   &errMsg,
+                                   prelaunchScript,
+                                   rEntry.module(),
+                                   modulesBinaryPath))
+            {
+               // merge the found environment with the existing user-overridden environment
+               // we ensure that the user overrides overwrite whatever environment we established automatically
+               core::system::Options userEnv = rEntry.environment();
+               core::system::Options mergedEnv;
+
+               // set automatically found variables first
+               for (const core::system::Option& option : env)
+               {
+                  core::system::setenv(&mergedEnv, option.first, option.second);
+               }
+
+               // override them with whatever was explicitly set by the user
+               for (const core::system::Option& option : userEnv)
+               {
+                  // do not override R_HOME as it was corrected while detecting the environment
+                  // this is necessary because the user-specified path might be just the root directory
+                  // and not the full install directory
+                  if (option.first == "R_HOME")
+                     continue;
+
+                  core::system::setenv(&mergedEnv, option.first, option.second);
+               }
+
+               rEntry.setNumber(rVersion);
+               rEntry.setEnvironment(mergedEnv);
+
+               entryResults[entryIndex] = rEntry;
+               entryDetected[entryIndex] = 1;
+            }
+            else
+            {
+               std::string rVersion;
+
+               if (!rEntry.module().empty())
+                  rVersion += " module " + rEntry.module();
+               if (!rScriptPath.getAbsolutePath().empty())
+                  rVersion += " at " + rScriptPath.getAbsolutePath();
+
+               LOG_ERROR_MESSAGE("Error scanning R version" + rVersion + ": " + errMsg);
+            }
          }
+      });
+   }
+   entryWorkers.join_all();
 
-         // override them with whatever was explicitly set by the user
-         for (const core::system::Option& option : userEnv)
-         {
-            // do not override R_HOME as it was corrected while detecting the environment
-            // this is necessary because the user-specified path might be just the root directory
-            // and not the full install directory
-            if (option.first == "R_HOME")
-               continue;
+   for (std::size_t i = 0; i < rEntries.size(); i++)
+   {
+      if (entryDetected[i])
+         rVersions.push_back(entryResults[i]);
+   }
 
-            core::system::setenv(&mergedEnv, option.first, option.second);
-         }
+   // probe versions in parallel -- each probe launches the R binary to
+   // capture its version and environment, so with many installations
+   // (particularly on shared storage) a serial scan dominates startup
+   {
+      std::vector<RVersion> probed(rHomePaths.size());
+      std::vector<int> detected(rHomePaths.size(), 0);
 
-         rEntry.setNumber(rVersion);
-         rEntry.setEnvironment(mergedEnv);
+      std::size_t numWorkers = std::min<std::size_t>(
+               std::max<std::size_t>(boost::thread::hardware_concurrency(), 1),
+               std::min<std::size_t>(rHomePaths.size(), 4));
 
-         rVersions.push_back(rEntry);
-      }
-      else
+      boost::thread_group workers;
+      for (std::size_t w = 0; w < numWorkers; w++)
       {
-         std::string rVersion;
-
-         if (!rEntry.module().empty())
-            rVersion += " module " + rEntry.module();
-         if (!rScriptPath.getAbsolutePath().empty())
-            rVersion += " at " + rScriptPath.getAbsolutePath();
-
-         LOG_ERROR_MESSAGE("Error scanning R version" + rVersion + ": " + errMsg);
+         workers.create_thread([&, w]()
+         {
+            for (std::size_t i = w; i < rHomePaths.size(); i += numWorkers)
+            {
+               // compute R script path
+               FilePath rScriptPath =
+                     rHomePaths[i].completeChildPath("bin/R");
+               if (!rScriptPath.exists())
+                  continue;
+
+               std::string rDiscoveredScriptPath, rVersion, errMsg;
+               core::system::Options env;
+               if (detectREnvironment(rScriptPath,
+                                      ldPathsScript,
+                                      ldLibraryPath,
+                                      &rDiscoveredScriptPath,
+                                      &rVersion,
+                                      &env,
+                                      &errMsg))
+               {
+                  probed[i] = RVersion(rVersion, env);
+                  detected[i] = 1;
+               }
+               else
+               {
+                  LOG_ERROR_MESSAGE("Error scanning R version at " +
+                                       rScriptPath.getAbsolutePath() + ": " +
+                                    errMsg);
+               }
+            }
+         });
       }
-   }
+      workers.join_all();
 
-   // probe versions
-   for (const FilePath& rHomePath : rHomePaths)
-   {
-      // compute R script path
-      FilePath rScriptPath = rHomePath.completeChildPath("bin/R");
-      if (!rScriptPath.exists())
-         continue;
-
-      std::string rDiscoveredScriptPath, rVersion, errMsg;
-      core::system::Options env;
-      if (detectREnvironment(rScriptPath,
-                             ldPathsScript,
-                             ldLibraryPath,
-                             &rDiscoveredScriptPath,
-                             &rVersion,
-                             &env,
-                             &errMsg))
-      {
-         RVersion version(rVersion, env);
-         rVersions.push_back(version);
-      }
-      else
+      // fold detected versions in (preserving the original scan order)
+      for (std::size_t i = 0; i < rHomePaths.size(); i++)
       {
-         LOG_ERROR_MESSAGE("Error scanning R version at " +
-                              rScriptPath.getAbsolutePath() + ": " +
-                           errMsg);
+         if (detected[i])
+            rVersions.push_back(probed[i]);
       }
    }
 
@@ -16,6 +16,7 @@
 #include <core/spelling/HunspellSpellingEngine.hpp>
 
 #include <boost/algorithm/string.hpp>
+#include <boost/unordered_map.hpp>
 
 #include <core/Log.hpp>
 #include <core/FileSerializer.hpp>
@@ -41,6 +42,10 @@ namespace spelling {
 
 namespace {
 
+// upper bound on the number of spell-check results we memoize (the cache
+// is simply cleared when it fills up)
+const std::size_t kMaxCachedResults = 20000;
+
 // remove morphological description from text
 void removeMorphologicalDescription(std::string* pText)
 {
@@ -398,6 +403,32 @@ struct HunspellSpellingEngine::Impl
       return *pSpellChecker_;
    }
 
+   Error checkSpelling(const std::string& word, bool* pCorrect)
+   {
+      // consult the result cache first -- documents re-check the same
+      // vocabulary over and over, and every miss pays an iconv round trip
+      // before it even reaches hunspell
+      boost::unordered_map<std::string, bool>::const_iterator it =
+                                                   checkedWords_.find(word);
+      if (it != checkedWords_.end())
+      {
+         *pCorrect = it->second;
+         return Success();
+      }
+
+      Error error = spellChecker().checkSpelling(word, pCorrect);
+      if (error)
+         return error;
+
+      // cache the result (bounded so pathological input can't grow the
+      // cache without limit; resetDictionaries clears it as well)
+      if (checkedWords_.size() >= kMaxCachedResults)
+         checkedWords_.clear();
+      checkedWords_[word] = *pCorrect;
+
+      return Success();
+   }
+
 private:
    bool dictionaryContextChanged(const std::string& langId)
    {
@@ -407,6 +438,9 @@ private:
 
    void resetDictionaries(const std::string& langId)
    {
+      // cached results are only valid for the current dictionary context
+      checkedWords_.clear();
+
       HunspellDictionary dict = dictManager_.dictionaryForLanguageId(langId);
       if (!dict.empty())
       {
@@ -450,6 +484,7 @@ private:
    HunspellDictionaryManager dictManager_;
    IconvstrFunction iconvstrFunction_;
    boost::shared_ptr<SpellChecker> pSpellChecker_;
+   boost::unordered_map<std::string, bool> checkedWords_;
 };
 
 
@@ -470,7 +505,7 @@ void HunspellSpellingEngine::useDictionary(const std::string& langId)
 Error HunspellSpellingEngine::checkSpelling(const std::string& word,
                                             bool *pCorrect)
 {
-   return pImpl_->spellChecker().checkSpelling(word, pCorrect);
+   return pImpl_->checkSpelling(word, pCorrect);
 }
 
 Error HunspellSpellingEngine::suggestionList(const std::string& word,
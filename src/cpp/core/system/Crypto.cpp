@@ -34,11 +34,15 @@
 #include <openssl/rsa.h>
 
 #include <algorithm>
+#include <ctime>
+#include <deque>
 #include <stdio.h>
 
+#include <boost/shared_ptr.hpp>
 #include <boost/utility.hpp>
 
 #include <core/Log.hpp>
+#include <core/Thread.hpp>
 #include <shared_core/Error.hpp>
 
 #include <memory>
@@ -125,6 +129,254 @@ Error sha256(const std::string& message,
    return Success();
 }
 
+namespace {
+
+// AES-256-GCM parameters for the single-shot AEAD functions
+const int kAeadKeyLength = 32;
+const int kAeadIvLength = 12;
+const int kAeadTagLength = 16;
+
+// a cipher context whose key schedule has already been expanded for a
+// particular key and direction. contexts are pooled so high-frequency
+// small-message callers (cookie validation, secure-channel RPC fields)
+// pay for context setup and AES key expansion once rather than per call
+struct AeadContext : boost::noncopyable
+{
+   AeadContext()
+      : pCtx(::EVP_CIPHER_CTX_new()),
+        encrypt(false)
+   {
+   }
+
+   ~AeadContext()
+   {
+      if (pCtx != nullptr)
+         ::EVP_CIPHER_CTX_free(pCtx);
+   }
+
+   EVP_CIPHER_CTX* pCtx;
+   std::vector<unsigned char> key;
+   bool encrypt;
+};
+
+const std::size_t kMaxPooledAeadContexts = 8;
+boost::mutex s_aeadPoolMutex;
+std::vector<boost::shared_ptr<AeadContext> > s_aeadPool;
+
+Error acquireAeadContext(const std::vector<unsigned char>& key,
+                         bool encrypt,
+                         boost::shared_ptr<AeadContext>* pContext)
+{
+   // prefer a pooled context already scheduled for this key and direction:
+   // reusing it means the per-message init below only installs the IV
+   LOCK_MUTEX(s_aeadPoolMutex)
+   {
+      for (std::size_t i = 0; i < s_aeadPool.size(); i++)
+      {
+         if (s_aeadPool[i]->encrypt == encrypt && s_aeadPool[i]->key == key)
+         {
+            *pContext = s_aeadPool[i];
+            s_aeadPool.erase(s_aeadPool.begin() + i);
+            break;
+         }
+      }
+
+      // no schedule for this key; recycle the least recently returned
+      // context rather than allocating a new one
+      if (!*pContext && !s_aeadPool.empty())
+      {
+         *pContext = s_aeadPool.front();
+         s_aeadPool.erase(s_aeadPool.begin());
+      }
+   }
+   END_LOCK_MUTEX
+
+   if (!*pContext)
+   {
+      pContext->reset(new AeadContext());
+      if ((*pContext)->pCtx == nullptr)
+      {
+         pContext->reset();
+         return systemError(boost::system::errc::not_enough_memory,
+                            ERROR_LOCATION);
+      }
+   }
+
+   // expand the key schedule if this context isn't already set up for
+   // this key and direction
+   if ((*pContext)->key != key || (*pContext)->encrypt != encrypt)
+   {
+      if (::EVP_CipherInit_ex((*pContext)->pCtx,
+                              EVP_aes_256_gcm(),
+                              nullptr,
+                              &key[0],
+                              nullptr,
+                              encrypt ? 1 : 0) != 1)
+      {
+         pContext->reset();
+         return getLastCryptoError(ERROR_LOCATION);
+      }
+
+      (*pContext)->key = key;
+      (*pContext)->encrypt = encrypt;
+   }
+
+   return Success();
+}
+
+void releaseAeadContext(const boost::shared_ptr<AeadContext>& pContext)
+{
+   LOCK_MUTEX(s_aeadPoolMutex)
+   {
+      if (s_aeadPool.size() < kMaxPooledAeadContexts)
+         s_aeadPool.push_back(pContext);
+   }
+   END_LOCK_MUTEX
+}
+
+} // anonymous namespace
+
+Error aeadEncrypt(const std::string& plainText,
+                  const std::vector<unsigned char>& key,
+                  std::vector<unsigned char>* pCipherText)
+{
+   if (key.size() != static_cast<std::size_t>(kAeadKeyLength))
+      return systemError(boost::system::errc::invalid_argument,
+                         ERROR_LOCATION);
+
+   // generate a random per-message IV
+   std::vector<unsigned char> iv;
+   Error error = random(kAeadIvLength, iv);
+   if (error)
+      return error;
+
+   boost::shared_ptr<AeadContext> pContext;
+   error = acquireAeadContext(key, true, &pContext);
+   if (error)
+      return error;
+
+   // layout: IV || ciphertext || tag. on failure the context is dropped
+   // rather than returned to the pool (its state is undefined)
+   pCipherText->resize(kAeadIvLength + plainText.size() + kAeadTagLength);
+   std::copy(iv.begin(), iv.end(), pCipherText->begin());
+
+   if (::EVP_CipherInit_ex(pContext->pCtx, nullptr, nullptr, nullptr,
+                           &iv[0], -1) != 1)
+      return getLastCryptoError(ERROR_LOCATION);
+
+   int outLen = 0;
+   if (::EVP_CipherUpdate(pContext->pCtx,
+                          &(pCipherText->operator[](kAeadIvLength)),
+                          &outLen,
+                          reinterpret_cast<const unsigned char*>(
+                             plainText.c_str()),
+                          gsl::narrow_cast<int>(plainText.size())) != 1)
+      return getLastCryptoError(ERROR_LOCATION);
+
+   int finalLen = 0;
+   if (::EVP_CipherFinal_ex(pContext->pCtx,
+                            &(pCipherText->operator[](kAeadIvLength + outLen)),
+                            &finalLen) != 1)
+      return getLastCryptoError(ERROR_LOCATION);
+
+   if (::EVP_CIPHER_CTX_ctrl(pContext->pCtx,
+                             EVP_CTRL_GCM_GET_TAG,
+                             kAeadTagLength,
+                             &(pCipherText->operator[](
+                                  kAeadIvLength + outLen + finalLen))) != 1)
+      return getLastCryptoError(ERROR_LOCATION);
+
+   pCipherText->resize(kAeadIvLength + outLen + finalLen + kAeadTagLength);
+   releaseAeadContext(pContext);
+   return Success();
+}
+
+Error aeadDecrypt(const std::vector<unsigned char>& cipherText,
+                  const std::vector<unsigned char>& key,
+                  std::string* pPlainText)
+{
+   if (key.size() != static_cast<std::size_t>(kAeadKeyLength))
+      return systemError(boost::system::errc::invalid_argument,
+                         ERROR_LOCATION);
+
+   if (cipherText.size() <
+       static_cast<std::size_t>(kAeadIvLength + kAeadTagLength))
+      return systemError(boost::system::errc::invalid_argument,
+                         ERROR_LOCATION);
+
+   boost::shared_ptr<AeadContext> pContext;
+   Error error = acquireAeadContext(key, false, &pContext);
+   if (error)
+      return error;
+
+   if (::EVP_CipherInit_ex(pContext->pCtx, nullptr, nullptr, nullptr,
+                           &cipherText[0], -1) != 1)
+      return getLastCryptoError(ERROR_LOCATION);
+
+   int payloadLen = gsl::narrow_cast<int>(
+            cipherText.size() - kAeadIvLength - kAeadTagLength);
+   std::vector<unsigned char> plainText(payloadLen + kAeadTagLength);
+
+   int outLen = 0;
+   if (::EVP_CipherUpdate(pContext->pCtx,
+                          &plainText[0],
+                          &outLen,
+                          &cipherText[kAeadIvLength],
+                          payloadLen) != 1)
+      return getLastCryptoError(ERROR_LOCATION);
+
+   // install the expected tag; the final call below fails if the
+   // ciphertext or tag has been tampered with
+   if (::EVP_CIPHER_CTX_ctrl(
+            pContext->pCtx,
+            EVP_CTRL_GCM_SET_TAG,
+            kAeadTagLength,
+            const_cast<unsigned char*>(
+               &cipherText[cipherText.size() - kAeadTagLength])) != 1)
+      return getLastCryptoError(ERROR_LOCATION);
+
+   int finalLen = 0;
+   if (::EVP_CipherFinal_ex(pContext->pCtx,
+                            &plainText[outLen],
+                            &finalLen) != 1)
+   {
+      // authentication failure doesn't always queue an openssl error
+      ::ERR_clear_error();
+      return systemError(boost::system::errc::bad_message,
+                         "AEAD authentication failed",
+                         ERROR_LOCATION);
+   }
+
+   pPlainText->assign(plainText.begin(),
+                      plainText.begin() + outLen + finalLen);
+   releaseAeadContext(pContext);
+   return Success();
+}
+
+Error aeadEncryptAndBase64Encode(const std::string& plainText,
+                                 const std::vector<unsigned char>& key,
+                                 std::string* pCipherText)
+{
+   std::vector<unsigned char> cipherText;
+   Error error = aeadEncrypt(plainText, key, &cipherText);
+   if (error)
+      return error;
+
+   return base64Encode(cipherText, *pCipherText);
+}
+
+Error base64DecodeAndAeadDecrypt(const std::string& cipherText,
+                                 const std::vector<unsigned char>& key,
+                                 std::string* pPlainText)
+{
+   std::vector<unsigned char> decoded;
+   Error error = base64Decode(cipherText, decoded);
+   if (error)
+      return error;
+
+   return aeadDecrypt(decoded, key, pPlainText);
+}
+
 Error rsaSign(const std::string& message,
               const std::string& pemPrivateKey,
               std::string* pOutSignature)
@@ -294,69 +546,172 @@ Error generateRsaKeyPair(std::string* pOutPublicKey,
 }
 
 namespace {
-RSA* s_pRSA;
-std::string s_modulo;
-std::string s_exponent;
-}
 
-core::Error rsaInit()
+struct RsaKey
+{
+   RSA* pRSA = nullptr;
+   std::string modulo;
+   std::string exponent;
+   std::time_t retiredAt = 0;
+};
+
+// the active key plus a short list of recently retired keys: a sign-in
+// form rendered just before a rotation carries the previous public key,
+// so decryption falls back to retired keys within a grace window. keys
+// pre-computed via rsaPrecomputeKeys wait in s_precomputedKeys until a
+// rotation installs them
+boost::mutex s_rsaMutex;
+RsaKey s_activeKey;
+std::deque<RsaKey> s_precomputedKeys;
+std::deque<RsaKey> s_retiredKeys;
+
+const std::size_t kMaxRetiredKeys = 4;
+const std::time_t kRetiredKeyGraceSeconds = 600;
+
+// generates a 2048-bit keypair; this takes tens of milliseconds, so
+// callers other than rsaInit should invoke it from a background thread
+Error generateRsaKey(RsaKey* pKey)
 {
    const int KEY_SIZE = 2048;
-   const int ENTROPY_BYTES = 4096;
 
    const BIGNUM *bn_n;
    const BIGNUM *bn_e;
 
-   int rnd = ::open("/dev/urandom", O_RDONLY);
-   if (rnd == -1)
-      return systemError(errno, ERROR_LOCATION);
-
-   char entropy[ENTROPY_BYTES];
-   if (-1 == ::read(rnd, entropy, ENTROPY_BYTES))
-   {
-      ::close(rnd);
-      return systemError(errno, ERROR_LOCATION);
-   }
-   ::close(rnd);
-
-   RAND_seed(entropy, ENTROPY_BYTES);
-
    #if OPENSSL_VERSION_NUMBER < 0x10100000L
-      s_pRSA = ::RSA_generate_key(KEY_SIZE, 0x10001, nullptr, nullptr);
-      if (!s_pRSA)
+      pKey->pRSA = ::RSA_generate_key(KEY_SIZE, 0x10001, nullptr, nullptr);
+      if (!pKey->pRSA)
          return getLastCryptoError(ERROR_LOCATION);
 
-      bn_n = s_pRSA->n;
-      bn_e = s_pRSA->e;
+      bn_n = pKey->pRSA->n;
+      bn_e = pKey->pRSA->e;
    #else
       BIGNUM *bn = BN_new();
       BN_set_word(bn, RSA_F4);
- 
-      s_pRSA = RSA_new();
-      int rc = ::RSA_generate_key_ex(s_pRSA, KEY_SIZE, bn, nullptr);
+
+      pKey->pRSA = RSA_new();
+      int rc = ::RSA_generate_key_ex(pKey->pRSA, KEY_SIZE, bn, nullptr);
       BN_clear_free(bn);
       if (rc != 1) {
-        RSA_free(s_pRSA);
+        RSA_free(pKey->pRSA);
+        pKey->pRSA = nullptr;
         return getLastCryptoError(ERROR_LOCATION);
       }
-   
-      RSA_get0_key(s_pRSA, &bn_n, &bn_e, nullptr);
+
+      RSA_get0_key(pKey->pRSA, &bn_n, &bn_e, nullptr);
    #endif
 
    char* n = BN_bn2hex(bn_n);
-   s_modulo = n;
+   pKey->modulo = n;
    OPENSSL_free(n);
    char* e = BN_bn2hex(bn_e);
-   s_exponent = e;
+   pKey->exponent = e;
    OPENSSL_free(e);
 
    return Success();
 }
 
+// drop retired keys which have aged out of the grace window (caller must
+// hold s_rsaMutex)
+void expireRetiredKeys()
+{
+   std::time_t now = ::time(nullptr);
+   while (!s_retiredKeys.empty() &&
+          (s_retiredKeys.size() > kMaxRetiredKeys ||
+           (now - s_retiredKeys.front().retiredAt) > kRetiredKeyGraceSeconds))
+   {
+      RSA_free(s_retiredKeys.front().pRSA);
+      s_retiredKeys.pop_front();
+   }
+}
+
+} // anonymous namespace
+
+core::Error rsaInit()
+{
+   const int ENTROPY_BYTES = 4096;
+
+   int rnd = ::open("/dev/urandom", O_RDONLY);
+   if (rnd == -1)
+      return systemError(errno, ERROR_LOCATION);
+
+   char entropy[ENTROPY_BYTES];
+   if (-1 == ::read(rnd, entropy, ENTROPY_BYTES))
+   {
+      ::close(rnd);
+      return systemError(errno, ERROR_LOCATION);
+   }
+   ::close(rnd);
+
+   RAND_seed(entropy, ENTROPY_BYTES);
+
+   RsaKey key;
+   Error error = generateRsaKey(&key);
+   if (error)
+      return error;
+
+   LOCK_MUTEX(s_rsaMutex)
+   {
+      s_activeKey = key;
+   }
+   END_LOCK_MUTEX
+
+   return Success();
+}
+
+core::Error rsaPrecomputeKeys(std::size_t targetCount)
+{
+   while (true)
+   {
+      LOCK_MUTEX(s_rsaMutex)
+      {
+         if (s_precomputedKeys.size() >= targetCount)
+            return Success();
+      }
+      END_LOCK_MUTEX
+
+      // generate outside the lock so decryption isn't blocked on keygen
+      RsaKey key;
+      Error error = generateRsaKey(&key);
+      if (error)
+         return error;
+
+      LOCK_MUTEX(s_rsaMutex)
+      {
+         s_precomputedKeys.push_back(key);
+      }
+      END_LOCK_MUTEX
+   }
+}
+
+void rsaRotateKey()
+{
+   LOCK_MUTEX(s_rsaMutex)
+   {
+      // without a pre-computed key available, keep the current one rather
+      // than generating synchronously (rotation is an optimization; the
+      // active key always remains valid)
+      if (s_precomputedKeys.empty())
+         return;
+
+      s_activeKey.retiredAt = ::time(nullptr);
+      s_retiredKeys.push_back(s_activeKey);
+
+      s_activeKey = s_precomputedKeys.front();
+      s_precomputedKeys.pop_front();
+
+      expireRetiredKeys();
+   }
+   END_LOCK_MUTEX
+}
+
 void rsaPublicKey(std::string* pExponent, std::string* pModulo)
 {
-   pModulo->assign(s_modulo.begin(), s_modulo.end());
-   pExponent->assign(s_exponent.begin(), s_exponent.end());
+   LOCK_MUTEX(s_rsaMutex)
+   {
+      pModulo->assign(s_activeKey.modulo.begin(), s_activeKey.modulo.end());
+      pExponent->assign(s_activeKey.exponent.begin(), s_activeKey.exponent.end());
+   }
+   END_LOCK_MUTEX
 }
 
 core::Error rsaPrivateDecrypt(const std::string& cipherText, std::string* pPlainText)
@@ -366,20 +721,41 @@ core::Error rsaPrivateDecrypt(const std::string& cipherText, std::string* pPlain
    if (error)
       return error;
 
-   int size = RSA_size(s_pRSA);
-   std::vector<unsigned char> plainTextBytes(size);
-   int bytesRead = RSA_private_decrypt(gsl::narrow_cast<int>(cipherTextBytes.size()),
-                                       &cipherTextBytes[0],
-                                       &plainTextBytes[0],
-                                       s_pRSA,
-                                       RSA_PKCS1_PADDING);
-   if (bytesRead == -1)
-      return getLastCryptoError(ERROR_LOCATION);
+   LOCK_MUTEX(s_rsaMutex)
+   {
+      // try the active key first, then any retired keys still within the
+      // grace window (the ciphertext may predate a rotation); a padding
+      // failure against the wrong key simply reports -1
+      std::vector<RSA*> candidates;
+      candidates.push_back(s_activeKey.pRSA);
+      for (std::deque<RsaKey>::reverse_iterator it = s_retiredKeys.rbegin();
+           it != s_retiredKeys.rend();
+           ++it)
+      {
+         candidates.push_back(it->pRSA);
+      }
 
-   plainTextBytes.resize(bytesRead);
-   pPlainText->assign(plainTextBytes.begin(), plainTextBytes.end());
+      for (RSA* pRSA : candidates)
+      {
+         int size = RSA_size(pRSA);
+         std::vector<unsigned char> plainTextBytes(size);
+         int bytesRead = RSA_private_decrypt(
+                                 gsl::narrow_cast<int>(cipherTextBytes.size()),
+                                 &cipherTextBytes[0],
+                                 &plainTextBytes[0],
+                                 pRSA,
+                                 RSA_PKCS1_PADDING);
+         if (bytesRead != -1)
+         {
+            plainTextBytes.resize(bytesRead);
+            pPlainText->assign(plainTextBytes.begin(), plainTextBytes.end());
+            return Success();
+         }
+      }
+   }
+   END_LOCK_MUTEX
 
-   return Success();
+   return getLastCryptoError(ERROR_LOCATION);
 }
 
                       
@@ -0,0 +1,119 @@
+/*
+ * FileScanner.cpp
+ *
+ * Copyright (C) 2020 by RStudio, PBC
+ *
+ * Unless you have received this program directly from RStudio pursuant
+ * to the terms of a commercial license agreement with RStudio, then
+ * this program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ *
+ */
+
+#include <core/system/FileScanner.hpp>
+
+#include <shared_core/FilePath.hpp>
+
+#include <core/Thread.hpp>
+#include <core/system/FileChangeEvent.hpp>
+
+namespace rstudio {
+namespace core {
+namespace system {
+
+FileScanCache::FileScanCache()
+   : generation_(0)
+{
+}
+
+uint64_t FileScanCache::beginScan()
+{
+   LOCK_MUTEX(mutex_)
+   {
+      return generation_;
+   }
+   END_LOCK_MUTEX
+
+   // keep compiler happy
+   return 0;
+}
+
+bool FileScanCache::lookup(const std::string& dirPath,
+                           std::vector<FileInfo>* pChildren)
+{
+   LOCK_MUTEX(mutex_)
+   {
+      std::map<std::string, std::vector<FileInfo> >::const_iterator it =
+                                                         cache_.find(dirPath);
+      if (it == cache_.end())
+         return false;
+
+      *pChildren = it->second;
+      return true;
+   }
+   END_LOCK_MUTEX
+
+   // keep compiler happy
+   return false;
+}
+
+void FileScanCache::store(const std::string& dirPath,
+                          uint64_t scanGeneration,
+                          const std::vector<FileInfo>& children)
+{
+   LOCK_MUTEX(mutex_)
+   {
+      // if an invalidation arrived after the scan began then the
+      // snapshot may already be stale -- discard it (the next scan
+      // will re-enumerate the directory and store a fresh snapshot)
+      if (scanGeneration != generation_)
+         return;
+
+      cache_[dirPath] = children;
+   }
+   END_LOCK_MUTEX
+}
+
+void FileScanCache::invalidate(const std::string& dirPath)
+{
+   LOCK_MUTEX(mutex_)
+   {
+      ++generation_;
+      cache_.erase(dirPath);
+   }
+   END_LOCK_MUTEX
+}
+
+void FileScanCache::processFileChanges(
+                              const std::vector<FileChangeEvent>& events)
+{
+   for (const FileChangeEvent& event : events)
+   {
+      FilePath filePath(event.fileInfo().absolutePath());
+
+      // the directory containing the changed file has new contents
+      invalidate(filePath.getParent().getAbsolutePath());
+
+      // if the changed path is itself a directory then its own snapshot
+      // is also suspect (e.g. it was added or removed)
+      if (event.fileInfo().isDirectory())
+         invalidate(filePath.getAbsolutePath());
+   }
+}
+
+void FileScanCache::clear()
+{
+   LOCK_MUTEX(mutex_)
+   {
+      ++generation_;
+      cache_.clear();
+   }
+   END_LOCK_MUTEX
+}
+
+} // namespace system
+} // namespace core
+} // namespace rstudio
@@ -18,10 +18,13 @@
 #include <dirent.h>
 #include <sys/stat.h>
 
+#include <boost/bind.hpp>
+
 #include <shared_core/Error.hpp>
 #include <core/Log.hpp>
 #include <shared_core/FilePath.hpp>
 #include <core/BoostThread.hpp>
+#include <core/Thread.hpp>
 
 #include "config.h"
 
@@ -60,8 +63,22 @@ int alphasort(const dirent** lhs, const dirent** rhs)
    return strcmp((*lhs)->d_name, (*rhs)->d_name);
 }
 
+// directory entry (the type comes straight from the dirent, so it can be
+// DT_UNKNOWN on file systems which don't report entry types)
+struct DirEntry
+{
+   DirEntry() : type(DT_UNKNOWN) {}
+   DirEntry(const std::string& name, unsigned char type)
+      : name(name), type(type)
+   {
+   }
+
+   std::string name;
+   unsigned char type;
+};
+
 // wrapper for scandir api
-Error scanDir(const std::string& dirPath, std::vector<std::string>* pNames)
+Error scanDir(const std::string& dirPath, std::vector<DirEntry>* pEntries)
 {
    // read directory contents into namelist
    struct dirent **namelist;
@@ -79,18 +96,120 @@ Error scanDir(const std::string& dirPath, std::vector<std::string>* pNames)
    // extract the namelist then free it
    for(int i=0; i<entries; i++)
    {
-      // get the name (then free it)
-      std::string name(namelist[i]->d_name);
+      // get the name and type (then free it)
+      DirEntry entry(namelist[i]->d_name, namelist[i]->d_type);
       ::free(namelist[i]);
 
       // add to the vector
-      pNames->push_back(name);
+      pEntries->push_back(entry);
    }
    ::free(namelist);
 
    return Success();
 }
 
+// produce the FileInfo for a single directory entry. returns false if the
+// entry should be skipped (e.g. it was removed mid-scan or is unreadable)
+bool statEntry(const std::string& path,
+               unsigned char type,
+               FileInfo* pFileInfo)
+{
+   // if readdir already identified this as a (non-symlink) directory then
+   // we don't need any attributes and can skip the stat round trip
+   // entirely (these round trips dominate scan time on network volumes)
+   if (type == DT_DIR)
+   {
+      *pFileInfo = FileInfo(path, true, false);
+      return true;
+   }
+
+   // get the attributes
+   struct stat st;
+   int res = ::lstat(path.c_str(), &st);
+   if (res == -1)
+   {
+      if (errno != ENOENT && errno != EACCES)
+      {
+         Error error = systemError(errno, ERROR_LOCATION);
+         error.addProperty("path", path);
+         LOG_ERROR(error);
+      }
+      return false;
+   }
+
+   // create the FileInfo
+   bool isSymlink = S_ISLNK(st.st_mode);
+   if (S_ISDIR(st.st_mode))
+   {
+      *pFileInfo = FileInfo(path, true, isSymlink);
+   }
+   else
+   {
+      *pFileInfo = FileInfo(path,
+                            false,
+                            st.st_size,
+#ifdef __APPLE__
+                            st.st_mtimespec.tv_sec,
+#else
+                            st.st_mtime,
+#endif
+                            isSymlink);
+   }
+
+   return true;
+}
+
+// stat batching: directories with at least this many entries have their
+// stat calls issued in parallel (below this the coordination overhead
+// outweighs the benefit)
+const std::size_t kParallelStatThreshold = 64;
+const std::size_t kNumStatThreads = 4;
+
+// dedicated pool for stat batches. kept separate from the shared
+// background pool so that scans can't stall behind long-running tasks
+// queued by other subsystems
+core::thread::ThreadPool& statThreadPool()
+{
+   static core::thread::ThreadPool instance(kNumStatThreads);
+   return instance;
+}
+
+// tracks outstanding chunks of a parallel stat batch
+struct StatBatch
+{
+   StatBatch() : remaining(0) {}
+
+   boost::mutex mutex;
+   boost::condition condition;
+   std::size_t remaining;
+};
+
+// worker task: stat a contiguous range of entries. each task writes to a
+// distinct range of the output vectors so no synchronization is required
+// beyond the completion count
+void statEntryRange(boost::shared_ptr<StatBatch> pBatch,
+                    const std::vector<DirEntry>* pEntries,
+                    const FilePath* pRootPath,
+                    std::size_t begin,
+                    std::size_t end,
+                    std::vector<FileInfo>* pFileInfos,
+                    std::vector<char>* pValid)
+{
+   for (std::size_t i = begin; i < end; i++)
+   {
+      std::string path = pRootPath->completeChildPath(
+                              (*pEntries)[i].name).getAbsolutePath();
+      (*pValid)[i] = statEntry(path, (*pEntries)[i].type, &(*pFileInfos)[i]);
+   }
+
+   LOCK_MUTEX(pBatch->mutex)
+   {
+      if (--pBatch->remaining == 0)
+         pBatch->condition.notify_one();
+   }
+   END_LOCK_MUTEX
+}
+
 } // anonymous namespace
 
 Error scanFiles(const tree<FileInfo>::iterator_base& fromNode,
@@ -115,55 +234,96 @@ Error scanFiles(const tree<FileInfo>::iterator_base& fromNode,
          return error;
    }
 
-   // read directory contents
-   std::vector<std::string> names;
-   Error error = scanDir(fromNode->absolutePath(), &names);
-   if (error)
-      return error;
+   // consult the scan cache (if any) for a previously captured snapshot
+   // of this directory
+   uint64_t scanGeneration = 0;
+   std::vector<FileInfo> children;
+   bool haveCachedChildren = false;
+   if (options.cache)
+   {
+      scanGeneration = options.cache->beginScan();
+      haveCachedChildren = options.cache->lookup(fromNode->absolutePath(),
+                                                 &children);
+   }
 
-   // iterate over the names
-   for (const std::string& name : names)
+   if (!haveCachedChildren)
    {
-      // check for interrupt
-      if (boost::this_thread::interruption_requested())
-         return core::systemError(boost::system::errc::interrupted, ERROR_LOCATION);
+      // read directory contents
+      std::vector<DirEntry> entries;
+      Error error = scanDir(fromNode->absolutePath(), &entries);
+      if (error)
+         return error;
+
+      // produce a FileInfo for each entry. for large directories the stat
+      // calls are issued in parallel chunks on the stat pool (the caller
+      // blocks until the batch completes, but the round trips overlap);
+      // smaller directories are stat'd in place
+      std::vector<FileInfo> fileInfos(entries.size());
+      std::vector<char> valid(entries.size(), 0);
+      if (entries.size() >= kParallelStatThreshold)
+      {
+         boost::shared_ptr<StatBatch> pBatch(new StatBatch());
+         std::size_t chunkSize = (entries.size() + kNumStatThreads - 1) /
+                                 kNumStatThreads;
 
-      // compute the path
-      std::string path = rootPath.completeChildPath(name).getAbsolutePath();
+         // set the outstanding count before queueing any work (workers
+         // decrement it as they complete)
+         pBatch->remaining = (entries.size() + chunkSize - 1) / chunkSize;
 
-      // get the attributes
-      struct stat st;
-      int res = ::lstat(path.c_str(), &st);
-      if (res == -1)
+         for (std::size_t begin = 0; begin < entries.size(); begin += chunkSize)
+         {
+            std::size_t end = std::min(begin + chunkSize, entries.size());
+            statThreadPool().enque(boost::bind(statEntryRange,
+                                               pBatch,
+                                               &entries,
+                                               &rootPath,
+                                               begin,
+                                               end,
+                                               &fileInfos,
+                                               &valid));
+         }
+
+         // wait for the batch to complete. interruption is disabled here
+         // because the workers hold pointers into our stack frame (any
+         // requested interrupt is honored by the loop below)
+         boost::this_thread::disable_interruption disableInterruption;
+         boost::unique_lock<boost::mutex> lock(pBatch->mutex);
+         while (pBatch->remaining > 0)
+            pBatch->condition.wait(lock);
+      }
+      else
       {
-         if (errno != ENOENT && errno != EACCES)
+         for (std::size_t i = 0; i < entries.size(); i++)
          {
-            Error error = systemError(errno, ERROR_LOCATION);
-            error.addProperty("path", path);
-            LOG_ERROR(error);
+            std::string path = rootPath.completeChildPath(
+                                       entries[i].name).getAbsolutePath();
+            valid[i] = statEntry(path, entries[i].type, &fileInfos[i]);
          }
-         continue;
       }
 
-      // create the FileInfo
-      FileInfo fileInfo;
-      bool isSymlink = S_ISLNK(st.st_mode);
-      if (S_ISDIR(st.st_mode))
+      // collect the entries we could stat (skipping those which
+      // disappeared or were unreadable)
+      for (std::size_t i = 0; i < entries.size(); i++)
       {
-         fileInfo = FileInfo(path, true, isSymlink);
+         if (valid[i])
+            children.push_back(fileInfos[i]);
       }
-      else
+
+      // record the (pre-filter) snapshot for subsequent scans
+      if (options.cache)
       {
-         fileInfo = FileInfo(path,
-                             false,
-                             st.st_size,
-#ifdef __APPLE__
-                             st.st_mtimespec.tv_sec,
-#else
-                             st.st_mtime,
-#endif
-                             isSymlink);
+         options.cache->store(fromNode->absolutePath(),
+                              scanGeneration,
+                              children);
       }
+   }
+
+   // iterate over the entries
+   for (const FileInfo& fileInfo : children)
+   {
+      // check for interrupt
+      if (boost::this_thread::interruption_requested())
+         return core::systemError(boost::system::errc::interrupted, ERROR_LOCATION);
 
       // apply the filter (if any)
       if (!options.filter || options.filter(fileInfo))
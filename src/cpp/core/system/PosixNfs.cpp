@@ -18,6 +18,13 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include <sys/stat.h>
+
+#include <atomic>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+#include <core/Thread.hpp>
 #include <shared_core/Error.hpp>
 #include <shared_core/FilePath.hpp>
 
@@ -25,7 +32,7 @@ namespace rstudio {
 namespace core {
 namespace system {
 namespace nfs {
-   
+
 // Returns the most up-to-date file statistics available in *pSt, even when
 // 'path' resides on NFS. If *pCleared is given, also indicates whether *pSt
 // represents the most recent set of attributes.
@@ -74,6 +81,141 @@ core::Error statWithCacheClear(const core::FilePath& path,
    return core::Success();
 }
 
+namespace {
+
+// how often the background thread refreshes registered paths
+const int kRevalidateIntervalMs = 1000;
+
+// a path registered for background revalidation. the generation counter
+// is the only member touched off the service thread (it's atomic); the
+// cached attributes are private to the service thread
+struct RevalidationEntry
+{
+   explicit RevalidationEntry(const FilePath& path)
+      : path(path), active(true), haveStat(false), generation(0)
+   {
+   }
+
+   FilePath path;
+   bool active;
+   bool haveStat;
+   struct stat lastStat;
+   std::atomic<std::uint64_t> generation;
+};
+
+boost::mutex s_revalidationMutex;
+std::vector<boost::shared_ptr<RevalidationEntry> > s_revalidationEntries;
+bool s_serviceStarted = false;
+
+bool attributesChanged(const struct stat& a, const struct stat& b)
+{
+   return a.st_mtime != b.st_mtime ||
+          a.st_ctime != b.st_ctime ||
+          a.st_size != b.st_size ||
+          a.st_ino != b.st_ino;
+}
+
+void revalidationServiceMain()
+{
+   while (true)
+   {
+      // snapshot the active entries so refreshes run without the lock held
+      std::vector<boost::shared_ptr<RevalidationEntry> > entries;
+      LOCK_MUTEX(s_revalidationMutex)
+      {
+         for (std::size_t i = 0; i < s_revalidationEntries.size(); i++)
+         {
+            if (s_revalidationEntries[i]->active)
+               entries.push_back(s_revalidationEntries[i]);
+         }
+      }
+      END_LOCK_MUTEX
+
+      for (std::size_t i = 0; i < entries.size(); i++)
+      {
+         // refresh the attributes with the cache-clearing stat; failures
+         // aren't logged (transiently missing paths are normal) but do
+         // bump the generation if the path previously had attributes
+         struct stat st;
+         Error error = statWithCacheClear(entries[i]->path, nullptr, &st);
+         if (error)
+         {
+            if (entries[i]->haveStat)
+            {
+               entries[i]->haveStat = false;
+               entries[i]->generation++;
+            }
+            continue;
+         }
+
+         if (!entries[i]->haveStat ||
+             attributesChanged(entries[i]->lastStat, st))
+         {
+            entries[i]->lastStat = st;
+            if (entries[i]->haveStat)
+               entries[i]->generation++;
+            entries[i]->haveStat = true;
+         }
+      }
+
+      boost::this_thread::sleep(
+               boost::posix_time::milliseconds(kRevalidateIntervalMs));
+   }
+}
+
+} // anonymous namespace
+
+int registerRevalidationPath(const FilePath& path)
+{
+   int handle = -1;
+   LOCK_MUTEX(s_revalidationMutex)
+   {
+      handle = static_cast<int>(s_revalidationEntries.size());
+      s_revalidationEntries.push_back(
+               boost::shared_ptr<RevalidationEntry>(
+                                             new RevalidationEntry(path)));
+
+      // start the service thread on first use; it runs for the life of
+      // the process
+      if (!s_serviceStarted)
+      {
+         core::thread::safeLaunchThread(revalidationServiceMain);
+         s_serviceStarted = true;
+      }
+   }
+   END_LOCK_MUTEX
+   return handle;
+}
+
+void unregisterRevalidationPath(int handle)
+{
+   LOCK_MUTEX(s_revalidationMutex)
+   {
+      if (handle >= 0 &&
+          handle < static_cast<int>(s_revalidationEntries.size()))
+      {
+         s_revalidationEntries[handle]->active = false;
+      }
+   }
+   END_LOCK_MUTEX
+}
+
+std::uint64_t revalidationGeneration(int handle)
+{
+   boost::shared_ptr<RevalidationEntry> pEntry;
+   LOCK_MUTEX(s_revalidationMutex)
+   {
+      if (handle >= 0 &&
+          handle < static_cast<int>(s_revalidationEntries.size()))
+      {
+         pEntry = s_revalidationEntries[handle];
+      }
+   }
+   END_LOCK_MUTEX
+
+   return pEntry ? pEntry->generation.load() : 0;
+}
+
 } // namespace nfs
 } // namespace system
 } // namespace core
@@ -716,7 +716,10 @@ void AsyncChildProcess::poll()
    if (error)
       reportError(error);
    if (!stdOut.empty() && callbacks_.onStdout)
+   {
+      hasRecentOutput = true;
       callbacks_.onStdout(*this, stdOut);
+   }
 
    // check stderr
    // when using winpty, hStdErrRead is optional
@@ -93,24 +93,46 @@ Error scanFiles(const tree<FileInfo>::iterator_base& fromNode,
          return error;
    }
 
-   // read directory entries
-   std::vector<FilePath> children;
-   Error error = rootPath.getChildren(children);
-   if (error)
-      return error;
-
-   // convert to FileInfo and sort using alphasort equivilant (for
-   // compatability with scandir, which is what is used in our
-   // posix-specific implementation
-   int count = 0;
+   // consult the scan cache (if any) for a previously captured snapshot
+   // of this directory
+   uint64_t scanGeneration = 0;
    std::vector<FileInfo> childrenFileInfo;
-   std::transform(children.begin(),
-                  children.end(),
-                  std::back_inserter(childrenFileInfo),
-                  boost::bind(convertToFileInfo, _1, options.yield, &count));
-   std::sort(childrenFileInfo.begin(),
-             childrenFileInfo.end(),
-             fileInfoPathLessThan);
+   bool haveCachedChildren = false;
+   if (options.cache)
+   {
+      scanGeneration = options.cache->beginScan();
+      haveCachedChildren = options.cache->lookup(fromNode->absolutePath(),
+                                                 &childrenFileInfo);
+   }
+
+   if (!haveCachedChildren)
+   {
+      // read directory entries
+      std::vector<FilePath> children;
+      Error error = rootPath.getChildren(children);
+      if (error)
+         return error;
+
+      // convert to FileInfo and sort using alphasort equivilant (for
+      // compatability with scandir, which is what is used in our
+      // posix-specific implementation
+      int count = 0;
+      std::transform(children.begin(),
+                     children.end(),
+                     std::back_inserter(childrenFileInfo),
+                     boost::bind(convertToFileInfo, _1, options.yield, &count));
+      std::sort(childrenFileInfo.begin(),
+                childrenFileInfo.end(),
+                fileInfoPathLessThan);
+
+      // record the (pre-filter) snapshot for subsequent scans
+      if (options.cache)
+      {
+         options.cache->store(fromNode->absolutePath(),
+                              scanGeneration,
+                              childrenFileInfo);
+      }
+   }
 
    // iterate over entries
    for (const FileInfo& childFileInfo : childrenFileInfo)
@@ -15,6 +15,8 @@
 
 #include "Win32Pty.hpp"
 
+#include <algorithm>
+
 #include <shared_core/Error.hpp>
 #include <core/StringUtils.hpp>
 #include <core/system/System.hpp>
@@ -636,42 +638,59 @@ Error WinPty::writeToPty(HANDLE hPipe, const std::string& input)
 
 Error WinPty::readFromPty(HANDLE hPipe, std::string* pOutput)
 {
-   // check for available bytes
-   DWORD dwAvail = 0;
-   if (!::PeekNamedPipe(hPipe, nullptr, 0, nullptr, &dwAvail, nullptr))
+   // drain the pipe rather than taking a single read of whatever was
+   // available on entry -- a fast producer refills the pipe while we
+   // copy, and one read per poll tick caps throughput at the pipe
+   // buffer size; bound the total per call so a fire-hose of output
+   // can't starve the caller's event loop
+   const DWORD kMaxBytesPerCall = 1024 * 1024;
+
+   std::vector<CHAR> buffer;
+   DWORD totalRead = 0;
+   while (totalRead < kMaxBytesPerCall)
    {
-      auto lastErr = ::GetLastError();
-      if (lastErr == ERROR_BROKEN_PIPE)
+      // check for available bytes
+      DWORD dwAvail = 0;
+      if (!::PeekNamedPipe(hPipe, nullptr, 0, nullptr, &dwAvail, nullptr))
+      {
+         auto lastErr = ::GetLastError();
+         if (lastErr == ERROR_BROKEN_PIPE)
+            return Success();
+         else
+            return systemError(lastErr, ERROR_LOCATION);
+      }
+
+      // no data available
+      if (dwAvail == 0)
          return Success();
-      else
-         return systemError(lastErr, ERROR_LOCATION);
-   }
 
-   // no data available
-   if (dwAvail == 0)
-      return Success();
+      // stay within the per-call budget
+      dwAvail = std::min(dwAvail, kMaxBytesPerCall - totalRead);
 
-   // read data which is available
-   DWORD nBytesRead = dwAvail;
-   std::vector<CHAR> buffer(dwAvail, 0);
-   OVERLAPPED over;
-   memset(&over, 0, sizeof(over));
-   BOOL bSuccess = ::ReadFile(hPipe, &(buffer[0]), dwAvail, nullptr, &over);
-   auto lastErr = ::GetLastError();
-   if (!bSuccess && lastErr == ERROR_IO_PENDING)
-   {
-      bSuccess = GetOverlappedResult(hPipe,
-                                     &over,
-                                     &nBytesRead,
-                                     TRUE /*wait*/);
-      lastErr = ::GetLastError();
-   }
+      // read data which is available
+      DWORD nBytesRead = dwAvail;
+      if (buffer.size() < dwAvail)
+         buffer.resize(dwAvail);
+      OVERLAPPED over;
+      memset(&over, 0, sizeof(over));
+      BOOL bSuccess = ::ReadFile(hPipe, &(buffer[0]), dwAvail, nullptr, &over);
+      auto lastErr = ::GetLastError();
+      if (!bSuccess && lastErr == ERROR_IO_PENDING)
+      {
+         bSuccess = GetOverlappedResult(hPipe,
+                                        &over,
+                                        &nBytesRead,
+                                        TRUE /*wait*/);
+         lastErr = ::GetLastError();
+      }
 
-   if (!bSuccess)
-      return systemError(lastErr, ERROR_LOCATION);
+      if (!bSuccess)
+         return systemError(lastErr, ERROR_LOCATION);
 
-   // append to output
-   pOutput->append(&(buffer[0]), nBytesRead);
+      // append to output
+      pOutput->append(&(buffer[0]), nBytesRead);
+      totalRead += nBytesRead;
+   }
 
    // success
    return Success();
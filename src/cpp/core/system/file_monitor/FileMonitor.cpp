@@ -17,6 +17,7 @@
 #include <core/system/FileMonitor.hpp>
 
 #include <list>
+#include <map>
 
 #include <boost/bind.hpp>
 #include <boost/algorithm/string.hpp>
@@ -597,13 +598,152 @@ void enqueOnMonitoringError(const Callbacks& callbacks, const Error& error)
    }
 }
 
-void enqueOnFilesChanged(const Callbacks& callbacks,
+// once this many events are pending for a monitor which has opted in via
+// onEventStorm we stop accumulating and signal the storm instead (a single
+// rescan by the consumer is cheaper than processing the events one by one)
+const std::size_t kEventStormThreshold = 2000;
+
+// buffers change events between their detection on the monitoring thread
+// and their delivery on the thread which calls checkForChanges. events
+// which arrive while a delivery is already pending are folded into the
+// same batch (rather than queued as additional callbacks), so bulk
+// operations like a git checkout produce a few large batches rather than
+// tens of thousands of small ones
+struct FileEventBatch : boost::noncopyable
+{
+   explicit FileEventBatch(const Callbacks& callbacks)
+      : callbacks(callbacks),
+        flushPending(false),
+        eventStorm(false)
+   {
+   }
+
+   boost::mutex mutex;
+   Callbacks callbacks;
+   std::vector<FileChangeEvent> events;
+   std::map<std::string, std::size_t> eventIndexByPath;
+   bool flushPending;
+   bool eventStorm;
+};
+
+bool isNoneEvent(const FileChangeEvent& event)
+{
+   return event.type() == FileChangeEvent::None;
+}
+
+// fold an event into the batch, merging it with any pending event for the
+// same path (batch mutex must be held by the caller)
+void coalesceEvent(FileEventBatch* pBatch, const FileChangeEvent& event)
+{
+   std::string path = event.fileInfo().absolutePath();
+   std::map<std::string, std::size_t>::iterator it =
+                                       pBatch->eventIndexByPath.find(path);
+   if (it != pBatch->eventIndexByPath.end())
+   {
+      FileChangeEvent& pending = pBatch->events[it->second];
+
+      // a modification supersedes the data of a pending add or modify
+      // (but an add remains an add from the consumer's point of view)
+      if (event.type() == FileChangeEvent::FileModified &&
+          (pending.type() == FileChangeEvent::FileAdded ||
+           pending.type() == FileChangeEvent::FileModified))
+      {
+         pending = FileChangeEvent(pending.type(), event.fileInfo());
+         return;
+      }
+
+      // a remove of a file the consumer hasn't seen yet cancels the add;
+      // a remove after a pending modify supersedes it
+      if (event.type() == FileChangeEvent::FileRemoved)
+      {
+         if (pending.type() == FileChangeEvent::FileAdded)
+         {
+            pending = FileChangeEvent(FileChangeEvent::None,
+                                      event.fileInfo());
+            pBatch->eventIndexByPath.erase(it);
+            return;
+         }
+         else if (pending.type() == FileChangeEvent::FileModified)
+         {
+            pending = event;
+            return;
+         }
+      }
+
+      // for other sequences (e.g. add following a pending remove) preserve
+      // both events in order, tracking the most recent one for this path
+      pBatch->events.push_back(event);
+      it->second = pBatch->events.size() - 1;
+      return;
+   }
+
+   pBatch->events.push_back(event);
+   pBatch->eventIndexByPath[path] = pBatch->events.size() - 1;
+}
+
+// delivery function (runs on the thread which calls checkForChanges)
+void flushFileEventBatch(boost::shared_ptr<FileEventBatch> pBatch)
+{
+   std::vector<FileChangeEvent> events;
+   bool eventStorm = false;
+   LOCK_MUTEX(pBatch->mutex)
+   {
+      pBatch->flushPending = false;
+      eventStorm = pBatch->eventStorm;
+      pBatch->eventStorm = false;
+      events.swap(pBatch->events);
+      pBatch->eventIndexByPath.clear();
+   }
+   END_LOCK_MUTEX
+
+   if (eventStorm)
+   {
+      if (pBatch->callbacks.onEventStorm)
+         pBatch->callbacks.onEventStorm();
+   }
+   else
+   {
+      // prune events which were cancelled during coalescing
+      events.erase(std::remove_if(events.begin(), events.end(), isNoneEvent),
+                   events.end());
+
+      if (!events.empty() && pBatch->callbacks.onFilesChanged)
+         pBatch->callbacks.onFilesChanged(events);
+   }
+}
+
+void enqueOnFilesChanged(boost::shared_ptr<FileEventBatch> pBatch,
                          const std::vector<FileChangeEvent>& fileChanges)
 {
-   if (callbacks.onFilesChanged)
+   if (fileChanges.empty())
+      return;
+
+   LOCK_MUTEX(pBatch->mutex)
    {
-      callbackQueue().enque(boost::bind(callbacks.onFilesChanged, fileChanges));
+      if (!pBatch->eventStorm)
+      {
+         for (const FileChangeEvent& fileChange : fileChanges)
+            coalesceEvent(pBatch.get(), fileChange);
+
+         // detect event storms for monitors which can handle them (pending
+         // events are discarded since the rescan supersedes them)
+         if (pBatch->callbacks.onEventStorm &&
+             pBatch->events.size() >= kEventStormThreshold)
+         {
+            pBatch->events.clear();
+            pBatch->eventIndexByPath.clear();
+            pBatch->eventStorm = true;
+         }
+      }
+      // (while a storm is pending additional events are discarded as well)
+
+      if (!pBatch->flushPending)
+      {
+         pBatch->flushPending = true;
+         callbackQueue().enque(boost::bind(flushFileEventBatch, pBatch));
+      }
    }
+   END_LOCK_MUTEX
 }
 
 void enqueOnUnregistered(const Callbacks& callbacks, Handle handle)
@@ -655,7 +795,8 @@ void registerMonitor(const FilePath& filePath,
    qCallbacks.onMonitoringError = boost::bind(enqueOnMonitoringError,
                                               callbacks,
                                               _1);
-   qCallbacks.onFilesChanged = boost::bind(enqueOnFilesChanged, callbacks, _1);
+   boost::shared_ptr<FileEventBatch> pBatch(new FileEventBatch(callbacks));
+   qCallbacks.onFilesChanged = boost::bind(enqueOnFilesChanged, pBatch, _1);
    qCallbacks.onUnregistered = boost::bind(enqueOnUnregistered, callbacks, _1);
 
    // enque the registration
@@ -0,0 +1,150 @@
+/*
+ * RecycleBin.cpp
+ *
+ * Copyright (C) 2020 by RStudio, PBC
+ *
+ * Unless you have received this program directly from RStudio pursuant
+ * to the terms of a commercial license agreement with RStudio, then
+ * this program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ *
+ */
+
+#include <core/system/RecycleBin.hpp>
+
+#include <deque>
+#include <vector>
+
+#include <core/Log.hpp>
+#include <core/Thread.hpp>
+#include <core/system/System.hpp>
+#include <shared_core/Error.hpp>
+#include <shared_core/FilePath.hpp>
+
+namespace rstudio {
+namespace core {
+namespace system {
+namespace recycle_bin {
+
+namespace {
+
+// unlink rate limiting: pause between batches so bulk reclamation
+// doesn't monopolize filesystem metadata operations (important on NFS)
+const int kUnlinkBatchSize = 200;
+const int kBatchPauseMs = 25;
+
+struct PendingReclamation
+{
+   FilePath graveyardPath;
+   boost::function<void(const Error&)> onComplete;
+};
+
+boost::mutex s_queueMutex;
+boost::condition_variable s_queueCondition;
+std::deque<PendingReclamation> s_queue;
+bool s_serviceStarted = false;
+
+// delete the contents of a graveyard: unlink files as they're
+// encountered (pausing between batches), then remove the directories
+// deepest-first
+Error reclaim(const FilePath& path)
+{
+   if (!path.isDirectory())
+      return path.remove();
+
+   int unlinkCount = 0;
+   std::vector<FilePath> directories;
+   Error error = path.getChildrenRecursive(
+      [&](int, const FilePath& child)
+      {
+         if (child.isDirectory())
+         {
+            directories.push_back(child);
+         }
+         else
+         {
+            Error removeError = child.removeIfExists();
+            if (removeError)
+               LOG_ERROR(removeError);
+
+            if (++unlinkCount % kUnlinkBatchSize == 0)
+               boost::this_thread::sleep(
+                        boost::posix_time::milliseconds(kBatchPauseMs));
+         }
+         return true;
+      });
+   if (error)
+      return error;
+
+   // recursive iteration is parents-first, so removing in reverse order
+   // empties children before their parents
+   for (std::vector<FilePath>::reverse_iterator
+           it = directories.rbegin(); it != directories.rend(); ++it)
+   {
+      Error removeError = it->removeIfExists();
+      if (removeError)
+         LOG_ERROR(removeError);
+   }
+
+   return path.remove();
+}
+
+void reclamationServiceMain()
+{
+   while (true)
+   {
+      PendingReclamation pending;
+      {
+         boost::unique_lock<boost::mutex> lock(s_queueMutex);
+         while (s_queue.empty())
+            s_queueCondition.wait(lock);
+         pending = s_queue.front();
+         s_queue.pop_front();
+      }
+
+      Error error = reclaim(pending.graveyardPath);
+      if (pending.onComplete)
+         pending.onComplete(error);
+      else if (error)
+         LOG_ERROR(error);
+   }
+}
+
+} // anonymous namespace
+
+Error removeAsync(const FilePath& filePath,
+                  const boost::function<void(const Error&)>& onComplete)
+{
+   // rename into a uniquely named hidden sibling -- same directory, so
+   // this is a single rename regardless of the size of the target
+   FilePath graveyardPath = filePath.getParent().completePath(
+            ".rstudio-deleted-" + core::system::generateUuid(false));
+   Error error = filePath.move(graveyardPath, FilePath::MoveDirect);
+   if (error)
+      return error;
+
+   LOCK_MUTEX(s_queueMutex)
+   {
+      // start the service thread on first use; it runs for the life of
+      // the process
+      if (!s_serviceStarted)
+      {
+         core::thread::safeLaunchThread(reclamationServiceMain);
+         s_serviceStarted = true;
+      }
+
+      s_queue.push_back(PendingReclamation { graveyardPath, onComplete });
+   }
+   END_LOCK_MUTEX
+
+   s_queueCondition.notify_one();
+   return Success();
+}
+
+} // namespace recycle_bin
+} // namespace system
+} // namespace core
+} // namespace rstudio
@@ -17,6 +17,8 @@
 
 #include <boost/regex.hpp>
 
+#include <core/RegexUtils.hpp>
+
 namespace rstudio {
 namespace core {
 namespace text {
@@ -36,9 +38,14 @@ void stripAnsiCodes(std::string* pStr)
    if (!pStr)
       return;
 
+   // this runs on every console flush, so use cached compilations
    std::string replacement;
-   *pStr = boost::regex_replace(*pStr, boost::regex(kAnsiMatch), replacement);
-   *pStr = boost::regex_replace(*pStr, boost::regex(kXTermTitleMatch), replacement);
+   *pStr = boost::regex_replace(*pStr,
+                                regex_utils::cachedRegex(kAnsiMatch),
+                                replacement);
+   *pStr = boost::regex_replace(*pStr,
+                                regex_utils::cachedRegex(kXTermTitleMatch),
+                                replacement);
 }
 
 } // namespace text
@@ -18,6 +18,10 @@
 #include <QPushButton>
 #include <QQuickWindow>
 
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+
 #include <boost/bind.hpp>
 #include <boost/function.hpp>
 #include <boost/scoped_ptr.hpp>
@@ -65,6 +69,38 @@ using namespace rstudio::desktop;
 
 namespace {
 
+// lightweight startup tracing. slow desktop starts reported from the
+// field are hard to attribute (webengine warmup vs. R detection vs.
+// session launch), so we record the time elapsed since process start
+// at each major startup phase and write the result to the user log
+// directory once the session has been launched
+std::chrono::steady_clock::time_point s_startupTime =
+      std::chrono::steady_clock::now();
+std::vector<std::pair<std::string, double> > s_startupPhases;
+
+void recordStartupPhase(const std::string& phase)
+{
+   double elapsedMs = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - s_startupTime).count();
+   s_startupPhases.push_back(std::make_pair(phase, elapsedMs));
+}
+
+void writeStartupTrace()
+{
+   std::ostringstream ostr;
+   for (const auto& phase : s_startupPhases)
+   {
+      ostr << std::fixed << std::setprecision(1) << std::setw(9)
+           << phase.second << " ms  " << phase.first << std::endl;
+   }
+
+   Error error = core::writeStringToFile(
+            desktop::userLogPath().completeChildPath("rdesktop-startup.log"),
+            ostr.str());
+   if (error)
+      LOG_ERROR(error);
+}
+
 void augmentCommandLineArguments(std::vector<char*>* arguments)
 {
    std::string user = core::system::getenv("RSTUDIO_CHROMIUM_ARGUMENTS");
@@ -507,6 +543,7 @@ int main(int argc, char* argv[])
 
       initializeLang();
       initializeRenderingEngine(&arguments);
+      recordStartupPhase("rendering engine initialized");
 
       // initialize log
       core::system::initializeLog("rdesktop",
@@ -563,62 +600,18 @@ int main(int argc, char* argv[])
       static char disableCompositorPref[] = "--disable-prefer-compositing-to-lcd-text";
       arguments.push_back(disableCompositorPref);
       
-      // disable GPU features for certain machine configurations. see e.g.
+      // NOTE: we previously ran '/usr/sbin/system_profiler SPDisplaysDataType'
+      // here and used the output to disable GPU features for certain video
+      // cards on macOS High Sierra; see e.g.
       //
       // https://bugs.chromium.org/p/chromium/issues/detail?id=773705
       // https://github.com/rstudio/rstudio/issues/2093
       // https://github.com/rstudio/rstudio/issues/3148
       //
-      // because the issue seems to only affect certain video cards on macOS
-      // High Sierra, we scope that change to that particular configuration
-      // for now (we can expand this list if more users report issues)
-      {
-         core::system::ProcessResult processResult;
-         core::system::runCommand(
-                  "/usr/sbin/system_profiler SPDisplaysDataType",
-                  core::system::ProcessOptions(),
-                  &processResult);
-
-         std::string stdOut = processResult.stdOut;
-         if (!stdOut.empty())
-         {
-            // NOTE: temporarily backed out as it appears the rasterization
-            // issues do not occur anymore with Qt 5.12.1; re-enable if we
-            // receive more reports in the wild.
-            //
-            // https://github.com/rstudio/rstudio/issues/2176
-            
-            /*
-            std::vector<std::string> rasterBlacklist = {
-               "NVIDIA GeForce GT 650M",
-               "NVIDIA GeForce GT 750M",
-               "Intel Iris Graphics 6100"
-            };
-
-            for (const std::string& entry : rasterBlacklist)
-            {
-               if (stdOut.find(entry) != std::string::npos)
-               {
-                  static char disableGpuRasterization[] = "--disable-gpu-rasterization";
-                  arguments.push_back(disableGpuRasterization);
-                  break;
-               }
-            }
-            */
-            
-            std::vector<std::string> gpuBlacklist = {};
-            
-            for (const std::string& entry : gpuBlacklist)
-            {
-               if (stdOut.find(entry) != std::string::npos)
-               {
-                  static char disableGpu[] = "--disable-gpu";
-                  arguments.push_back(disableGpu);
-                  break;
-               }
-            }
-         }
-      }
+      // the blacklists have since been retired (the rasterization issues no
+      // longer reproduce with Qt 5.12.1; https://github.com/rstudio/rstudio/issues/2176)
+      // and the probe itself blocked startup for several hundred milliseconds,
+      // so it has been removed; restore it here if GPU issues resurface
 #endif
 
 #if defined(Q_OS_LINUX) 
@@ -657,6 +650,7 @@ int main(int argc, char* argv[])
                               argv,
                               &pApp,
                               &pAppLaunch);
+      recordStartupPhase("application initialized");
 
       // determine the filename that was passed to us
       QString filename;
@@ -749,6 +743,7 @@ int main(int argc, char* argv[])
       ProgramStatus status = initializeOptions(pApp->arguments());
       if (status.exit())
          return status.exitCode();
+      recordStartupPhase("options initialized");
 
       // reset log if we are in run-diagnostics mode
       if (desktop::options().runDiagnostics())
@@ -807,6 +802,7 @@ int main(int argc, char* argv[])
       Options& options = desktop::options();
       if (!prepareEnvironment(options))
          return 1;
+      recordStartupPhase("R environment prepared");
 
 #ifdef _WIN32
       RVersion version = detectRVersion(false);
@@ -933,6 +929,7 @@ int main(int argc, char* argv[])
             SessionLauncher* pLauncher = new SessionLauncher(sessionPath, confPath, filename, pAppLaunch.get());
             pLauncher->launchFirstSession(installPath, devMode, pApp->arguments());
             pSessionLauncher.reset(pLauncher);
+            recordStartupPhase("local session launched");
          }
          else
          {
@@ -985,8 +982,14 @@ int main(int argc, char* argv[])
 
             pLauncher->launchFirstSession(installPath, devMode, pApp->arguments());
             pSessionLauncher.reset(pLauncher);
+            recordStartupPhase("remote session launched");
          }
 
+         // session startup now proceeds asynchronously while the webengine
+         // finishes warming; flush the phase trace so it can be collected
+         // even if the session itself fails to come up
+         writeStartupTrace();
+
          ProgressActivator progressActivator;
 
          int result = pApp->exec();
@@ -13,12 +13,18 @@
  *
  */
 
+#include <map>
+#include <string>
+#include <vector>
+
 #include <boost/asio/io_service.hpp>
 
 #include <monitor/MonitorClient.hpp>
 
 #include <shared_core/ILogDestination.hpp>
 
+#include <core/Thread.hpp>
+
 #include "MonitorClientImpl.hpp"
 
 namespace rstudio {
@@ -59,6 +65,208 @@ private:
 // and never free it so that there are no order of destruction surprises)
 Client* s_pClient = NULL;
 
+// client-side metrics aggregation ------------------------------------------
+//
+// rolls metrics up into fixed windows before handing them to the underlying
+// transport so that per-event overhead doesn't scale with metric volume:
+// counters are summed within the window, gauges keep their latest value,
+// and each window is flushed as a small number of multi-metric batches.
+// memory is bounded -- once a window holds the maximum number of distinct
+// series any further new series are dropped (and the drop itself reported
+// as a counter), so a metric storm degrades monitoring rather than the
+// host process.
+
+// length of an aggregation window
+const int kMetricsWindowSeconds = 60;
+
+// maximum number of distinct metric series retained per window
+const std::size_t kMaxWindowSeries = 1000;
+
+class BatchingClient : public Client
+{
+public:
+   explicit BatchingClient(Client* pClient)
+      : Client(pClient->metricsSocket(), pClient->auth(),
+               pClient->useSharedSecret()),
+        pClient_(pClient),
+        seriesCount_(0),
+        droppedSeries_(0)
+   {
+   }
+
+   void logMessage(const std::string& programIdentity,
+                   core::log::LogLevel level,
+                   const std::string& message)
+   {
+      pClient_->logMessage(programIdentity, level, message);
+   }
+
+   void sendMetrics(const std::vector<metrics::Metric>& metrics)
+   {
+      LOCK_MUTEX(mutex_)
+      {
+         for (std::size_t i = 0; i < metrics.size(); i++)
+            rollup(metrics[i].scope(),
+                   metrics[i].type(),
+                   metrics[i].unit(),
+                   metrics[i].data());
+      }
+      END_LOCK_MUTEX
+
+      flushIfWindowElapsed();
+   }
+
+   void sendMultiMetrics(const std::vector<metrics::MultiMetric>& metrics)
+   {
+      LOCK_MUTEX(mutex_)
+      {
+         for (std::size_t i = 0; i < metrics.size(); i++)
+         {
+            const std::vector<metrics::MetricData>& data = metrics[i].data();
+            for (std::size_t j = 0; j < data.size(); j++)
+               rollup(metrics[i].scope(),
+                      metrics[i].type(),
+                      metrics[i].unit(),
+                      data[j]);
+         }
+      }
+      END_LOCK_MUTEX
+
+      flushIfWindowElapsed();
+   }
+
+   void logEvent(const Event& event)
+   {
+      pClient_->logEvent(event);
+   }
+
+   void logConsoleAction(const audit::ConsoleAction& action)
+   {
+      pClient_->logConsoleAction(action);
+   }
+
+private:
+   // one (scope, type, unit) group of named series within the window
+   struct WindowGroup
+   {
+      std::string scope;
+      std::string type;
+      std::string unit;
+      std::map<std::string, double> values;
+   };
+
+   // requires mutex_ to be held
+   void rollup(const std::string& scope,
+               const std::string& type,
+               const std::string& unit,
+               const metrics::MetricData& data)
+   {
+      if (data.isEmpty())
+         return;
+
+      std::string key = scope + "\n" + type + "\n" + unit;
+      WindowGroup& group = window_[key];
+      if (group.scope.empty())
+      {
+         group.scope = scope;
+         group.type = type;
+         group.unit = unit;
+      }
+
+      std::map<std::string, double>::iterator it =
+                                             group.values.find(data.name);
+      if (it == group.values.end())
+      {
+         // new series: enforce the per-window bound
+         if (seriesCount_ >= kMaxWindowSeries)
+         {
+            droppedSeries_++;
+            return;
+         }
+         seriesCount_++;
+         group.values[data.name] = data.value;
+      }
+      else if (type == "counter")
+      {
+         // counters accumulate within the window
+         it->second += data.value;
+      }
+      else
+      {
+         // gauges (and anything else) keep the latest value
+         it->second = data.value;
+      }
+   }
+
+   void flushIfWindowElapsed()
+   {
+      using namespace boost::posix_time;
+
+      std::vector<metrics::MultiMetric> batches;
+      LOCK_MUTEX(mutex_)
+      {
+         ptime now = microsec_clock::universal_time();
+         if (windowStart_.is_not_a_date_time())
+         {
+            windowStart_ = now;
+            return;
+         }
+         if ((now - windowStart_).total_seconds() < kMetricsWindowSeconds)
+            return;
+
+         // build one batch per (scope, type, unit) group
+         for (std::map<std::string, WindowGroup>::const_iterator
+              it = window_.begin(); it != window_.end(); ++it)
+         {
+            const WindowGroup& group = it->second;
+            std::vector<metrics::MetricData> data;
+            data.reserve(group.values.size());
+            for (std::map<std::string, double>::const_iterator
+                 valueIt = group.values.begin();
+                 valueIt != group.values.end();
+                 ++valueIt)
+            {
+               data.push_back(metrics::MetricData(valueIt->first,
+                                                  valueIt->second));
+            }
+            batches.push_back(metrics::MultiMetric(group.scope,
+                                                   data,
+                                                   group.type,
+                                                   group.unit));
+         }
+
+         // surface drops so overload is visible downstream
+         if (droppedSeries_ > 0)
+         {
+            std::vector<metrics::MetricData> dropData;
+            dropData.push_back(metrics::MetricData(
+                  "dropped-series", static_cast<double>(droppedSeries_)));
+            batches.push_back(metrics::MultiMetric("monitor-client",
+                                                   dropData,
+                                                   "counter"));
+            droppedSeries_ = 0;
+         }
+
+         window_.clear();
+         seriesCount_ = 0;
+         windowStart_ = now;
+      }
+      END_LOCK_MUTEX
+
+      // send outside the lock so a slow transport doesn't apply
+      // backpressure to metric producers
+      if (!batches.empty())
+         pClient_->sendMultiMetrics(batches);
+   }
+
+   Client* pClient_;
+   boost::mutex mutex_;
+   boost::posix_time::ptime windowStart_;
+   std::map<std::string, WindowGroup> window_;
+   std::size_t seriesCount_;
+   std::size_t droppedSeries_;
+};
+
 } // anonymous namespace
 
 std::shared_ptr<core::log::ILogDestination> Client::createLogDestination(
@@ -73,7 +281,8 @@ void initializeMonitorClient(const std::string& metricsSocket,
                              bool useSharedSecret)
 {
    BOOST_ASSERT(s_pClient == NULL);
-   s_pClient = new SyncClient(metricsSocket, auth, useSharedSecret);
+   s_pClient = new BatchingClient(
+                  new SyncClient(metricsSocket, auth, useSharedSecret));
 }
 
 void initializeMonitorClient(const std::string& metricsSocket,
@@ -82,7 +291,8 @@ void initializeMonitorClient(const std::string& metricsSocket,
                              bool useSharedSecret)
 {
    BOOST_ASSERT(s_pClient == NULL);
-   s_pClient = new AsyncClient(metricsSocket, auth, ioService, useSharedSecret);
+   s_pClient = new BatchingClient(
+                  new AsyncClient(metricsSocket, auth, ioService, useSharedSecret));
 }
 
 void initializeMonitorClient(const std::string& tcpAddress,
@@ -94,7 +304,8 @@ void initializeMonitorClient(const std::string& tcpAddress,
                              bool useSharedSecret)
 {
    BOOST_ASSERT(s_pClient == NULL);
-   s_pClient = new SyncClient(tcpAddress, tcpPort, useSsl, verifySslCerts, prefixUri, auth, useSharedSecret);
+   s_pClient = new BatchingClient(new SyncClient(
+         tcpAddress, tcpPort, useSsl, verifySslCerts, prefixUri, auth, useSharedSecret));
 }
 
 void initializeMonitorClient(const std::string& tcpAddress,
@@ -107,7 +318,8 @@ void initializeMonitorClient(const std::string& tcpAddress,
                              bool useSharedSecret)
 {
    BOOST_ASSERT(s_pClient == NULL);
-   s_pClient = new AsyncClient(tcpAddress, tcpPort, useSsl, verifySslCerts, prefixUri, auth, ioService, useSharedSecret);
+   s_pClient = new BatchingClient(new AsyncClient(
+         tcpAddress, tcpPort, useSsl, verifySslCerts, prefixUri, auth, ioService, useSharedSecret));
 }
 
 Client& client()
@@ -16,12 +16,26 @@
 #define R_INTERNAL_FUNCTIONS
 #include <r/RExec.hpp>
 
+#ifndef _WIN32
+# include <fcntl.h>
+# include <signal.h>
+# include <sys/select.h>
+# include <sys/time.h>
+# include <sys/wait.h>
+# include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <chrono>
+
 #include <shared_core/FilePath.hpp>
+#include <shared_core/json/Json.hpp>
 #include <core/Log.hpp>
 #include <core/StringUtils.hpp>
 #include <core/system/Environment.hpp>
 
 #include <r/RErrorCategory.hpp>
+#include <r/RJson.hpp>
 #include <r/RSourceManager.hpp>
 #include <r/RInterface.hpp>
 #include <r/RCntxt.hpp>
@@ -223,8 +237,42 @@ void SEXPTopLevelExec(void *data)
    *(pContext->pReturnSEXP) = pContext->function();
 }
    
+// evaluate an expression in this process and convert the result to json
+Error evaluateStringToJson(const std::string& str, core::json::Value* pResult)
+{
+   sexp::Protect rProtect;
+   SEXP resultSEXP = R_NilValue;
+   Error error = evaluateString(str, &resultSEXP, &rProtect);
+   if (error)
+      return error;
+
+   return r::json::jsonValueFromObject(resultSEXP, pResult);
+}
+
+#ifndef _WIN32
+
+// write an entire buffer to a file descriptor, retrying on EINTR
+bool writeAll(int fd, const char* data, std::size_t size)
+{
+   while (size > 0)
+   {
+      ssize_t written = ::write(fd, data, size);
+      if (written == -1)
+      {
+         if (errno == EINTR)
+            continue;
+         return false;
+      }
+      data += written;
+      size -= written;
+   }
+   return true;
+}
+
+#endif
+
 } // anonymous namespace
-   
+
 Error executeSafely(boost::function<void()> function)
 {
    // disable custom error handlers while we execute code
@@ -337,8 +385,131 @@ Error evaluateString(const std::string& str,
    
    return Success();
 }
-   
-bool atTopLevelContext() 
+
+Error evaluateStringInForkedSnapshot(const std::string& str,
+                                     double timeoutSeconds,
+                                     core::json::Value* pResult)
+{
+#ifdef _WIN32
+   return evaluateStringToJson(str, pResult);
+#else
+   int fds[2];
+   if (::pipe(fds) == -1)
+   {
+      // no pipe, no snapshot; evaluate inline
+      return evaluateStringToJson(str, pResult);
+   }
+
+   pid_t pid = ::fork();
+   if (pid == -1)
+   {
+      ::close(fds[0]);
+      ::close(fds[1]);
+      return evaluateStringToJson(str, pResult);
+   }
+
+   if (pid == 0)
+   {
+      // child: evaluate against the copy-on-write snapshot of the R heap
+      // and stream the result back over the pipe (a status byte followed
+      // by either the json payload or the error summary). exit with _exit
+      // so none of the parent's cleanup handlers run here
+      ::close(fds[0]);
+
+      core::json::Value resultJson;
+      Error error = evaluateStringToJson(str, &resultJson);
+      char status = error ? 0 : 1;
+      std::string payload = error ? error.getSummary() : resultJson.write();
+      if (writeAll(fds[1], &status, 1))
+         writeAll(fds[1], payload.data(), payload.size());
+      ::close(fds[1]);
+      ::_exit(0);
+   }
+
+   // parent: read the child's response, enforcing the timeout
+   ::close(fds[1]);
+
+   std::string response;
+   bool timedOut = false;
+   auto deadline = std::chrono::steady_clock::now() +
+         std::chrono::microseconds((long long) (timeoutSeconds * 1e6));
+   while (true)
+   {
+      double remaining = std::chrono::duration<double>(
+               deadline - std::chrono::steady_clock::now()).count();
+      if (remaining < 0)
+         remaining = 0;
+
+      timeval tv;
+      tv.tv_sec = (time_t) remaining;
+      tv.tv_usec = (suseconds_t) ((remaining - (double) tv.tv_sec) * 1e6);
+
+      fd_set readFds;
+      FD_ZERO(&readFds);
+      FD_SET(fds[0], &readFds);
+
+      int result = ::select(fds[0] + 1, &readFds, nullptr, nullptr, &tv);
+      if (result == -1 && errno == EINTR)
+         continue;
+
+      if (result <= 0)
+      {
+         timedOut = true;
+         break;
+      }
+
+      char buffer[4096];
+      ssize_t bytesRead = ::read(fds[0], buffer, sizeof(buffer));
+      if (bytesRead == -1 && errno == EINTR)
+         continue;
+      if (bytesRead <= 0)
+         break;
+
+      response.append(buffer, bytesRead);
+   }
+   ::close(fds[0]);
+
+   if (timedOut)
+      ::kill(pid, SIGKILL);
+
+   // reap the child (a SIGCHLD handler may have beaten us to it, so
+   // failures here are expected and ignored)
+   int childStatus = 0;
+   while (::waitpid(pid, &childStatus, 0) == -1 && errno == EINTR)
+   {
+   }
+
+   if (timedOut)
+   {
+      Error error = systemError(boost::system::errc::timed_out, ERROR_LOCATION);
+      error.addProperty("code", str);
+      return error;
+   }
+
+   if (response.empty())
+   {
+      // the child died without producing a response
+      Error error = systemError(boost::system::errc::io_error, ERROR_LOCATION);
+      error.addProperty("code", str);
+      return error;
+   }
+
+   std::string payload = response.substr(1);
+   if (response[0] != 1)
+      return rCodeExecutionError(payload, ERROR_LOCATION);
+
+   Error parseError = pResult->parse(payload);
+   if (parseError)
+   {
+      parseError.addProperty("code", str);
+      return parseError;
+   }
+
+   return Success();
+#endif
+}
+
+bool atTopLevelContext()
 {
    return context::RCntxt::begin()->callflag() == CTXT_TOPLEVEL;
 }
@@ -0,0 +1,135 @@
+/*
+ * RProgress.cpp
+ *
+ * Copyright (C) 2020 by RStudio, PBC
+ *
+ * Unless you have received this program directly from RStudio pursuant
+ * to the terms of a commercial license agreement with RStudio, then
+ * this program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ *
+ */
+
+#include <r/RProgress.hpp>
+
+#include <atomic>
+#include <cstdint>
+
+namespace rstudio {
+namespace r {
+namespace exec {
+
+namespace {
+
+// bounded multi-producer / single-consumer ring (Vyukov-style): each
+// cell carries a sequence number which tells producers whether the
+// cell is free and the consumer whether it has been filled, so neither
+// side ever takes a lock or spins on the other
+const std::uint64_t kRingCapacity = 2048; // must be a power of two
+const std::uint64_t kRingMask = kRingCapacity - 1;
+
+struct Cell
+{
+   std::atomic<std::uint64_t> sequence;
+   ProgressUpdate data;
+};
+
+struct Ring
+{
+   Ring()
+      : enqueuePos(0),
+        dequeuePos(0)
+   {
+      for (std::uint64_t i = 0; i < kRingCapacity; i++)
+         cells[i].sequence.store(i, std::memory_order_relaxed);
+   }
+
+   Cell cells[kRingCapacity];
+   std::atomic<std::uint64_t> enqueuePos;
+   std::uint64_t dequeuePos; // touched only by the consumer
+};
+
+Ring& ring()
+{
+   static Ring instance;
+   return instance;
+}
+
+std::atomic<int> s_nextChannel(1);
+
+// single-consumer dequeue; main thread only
+bool tryDequeue(ProgressUpdate* pUpdate)
+{
+   Ring& r = ring();
+   Cell& cell = r.cells[r.dequeuePos & kRingMask];
+   std::uint64_t seq = cell.sequence.load(std::memory_order_acquire);
+   if (static_cast<std::int64_t>(seq - (r.dequeuePos + 1)) < 0)
+      return false; // not yet filled
+
+   *pUpdate = cell.data;
+
+   // mark the cell free for the producer one lap ahead
+   cell.sequence.store(r.dequeuePos + kRingCapacity,
+                       std::memory_order_release);
+   r.dequeuePos++;
+   return true;
+}
+
+} // anonymous namespace
+
+int allocateProgressChannel()
+{
+   return s_nextChannel.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool reportProgress(int channel, double units, double max)
+{
+   Ring& r = ring();
+   Cell* pCell;
+   std::uint64_t pos = r.enqueuePos.load(std::memory_order_relaxed);
+   for (;;)
+   {
+      pCell = &r.cells[pos & kRingMask];
+      std::uint64_t seq = pCell->sequence.load(std::memory_order_acquire);
+      std::int64_t diff = static_cast<std::int64_t>(seq - pos);
+      if (diff == 0)
+      {
+         // cell is free; try to claim it
+         if (r.enqueuePos.compare_exchange_weak(pos, pos + 1,
+                                                std::memory_order_relaxed))
+            break;
+      }
+      else if (diff < 0)
+      {
+         // ring is full -- drop the record (a later report supersedes)
+         return false;
+      }
+      else
+      {
+         // another producer claimed this cell; reload and retry
+         pos = r.enqueuePos.load(std::memory_order_relaxed);
+      }
+   }
+
+   pCell->data.channel = channel;
+   pCell->data.units = units;
+   pCell->data.max = max;
+
+   // publish to the consumer
+   pCell->sequence.store(pos + 1, std::memory_order_release);
+   return true;
+}
+
+void drainProgress(std::map<int, ProgressUpdate>* pUpdates)
+{
+   ProgressUpdate update;
+   while (tryDequeue(&update))
+      (*pUpdates)[update.channel] = update;
+}
+
+} // namespace exec
+} // namespace r
+} // namespace rstudio
@@ -871,10 +871,8 @@ Error extract(SEXP valueSEXP, std::vector<int>* pVector)
    if (TYPEOF(valueSEXP) != INTSXP)
       return Error(errc::UnexpectedDataTypeError, ERROR_LOCATION);
    
-   pVector->clear();
-   for (int i=0; i<Rf_length(valueSEXP); i++)
-      pVector->push_back(INTEGER(valueSEXP)[i]);
-   
+   pVector->assign(INTEGER(valueSEXP), INTEGER(valueSEXP) + Rf_length(valueSEXP));
+
    return Success();
 }
 
@@ -896,9 +894,10 @@ Error extract(SEXP valueSEXP, std::vector<std::string>* pVector, bool asUtf8)
       return Error(errc::UnexpectedDataTypeError, ERROR_LOCATION);
 
    pVector->clear();
+   pVector->reserve(Rf_length(valueSEXP));
    for (int i = 0; i < Rf_length(valueSEXP); i++)
       pVector->push_back(translate(STRING_ELT(valueSEXP, i), asUtf8));
-   
+
    return Success();
 }
 
@@ -1076,12 +1075,50 @@ SEXP create(const core::json::Array& value, Protect* pProtect)
    // create the list
    SEXP listSEXP;
    pProtect->add(listSEXP = Rf_allocVector(VECSXP, value.getSize()));
-   
-   // add each array element to it
+
+   // cache of character data already interned during this conversion;
+   // string-heavy payloads tend to repeat values, and reusing the
+   // character SEXP avoids re-hashing each occurrence through R's
+   // global string pool
+   std::map<std::string, SEXP> internedStrings;
+
+   // add each array element to it. elements are protected only while
+   // they're created; once inserted into the list they're reachable from
+   // it, and keeping every element on the protection stack individually
+   // would overflow the stack for large arrays
    for (size_t i=0; i<value.getSize(); i++)
    {
-      SEXP valueSEXP = create(value[i], pProtect);
-      SET_VECTOR_ELT(listSEXP, i,  valueSEXP);
+      const core::json::Value& element = value[i];
+      if (element.getType() == core::json::Type::STRING)
+      {
+         // fast path for strings: intern the character data once per
+         // distinct value (cached character SEXPs are kept alive by the
+         // elements already inserted into the protected list)
+         std::string str = element.getString();
+         SEXP charSEXP;
+         std::map<std::string, SEXP>::iterator it = internedStrings.find(str);
+         if (it != internedStrings.end())
+         {
+            charSEXP = it->second;
+         }
+         else
+         {
+            charSEXP = Rf_mkCharLenCE(str.c_str(), str.size(), CE_UTF8);
+            internedStrings[str] = charSEXP;
+         }
+
+         ArenaProtect protect;
+         protect.add(charSEXP);
+         SEXP strSEXP = Rf_allocVector(STRSXP, 1);
+         SET_STRING_ELT(strSEXP, 0, charSEXP);
+         SET_VECTOR_ELT(listSEXP, i, strSEXP);
+      }
+      else
+      {
+         ArenaProtect protect;
+         SEXP valueSEXP = create(element, &protect);
+         SET_VECTOR_ELT(listSEXP, i,  valueSEXP);
+      }
    }
    return listSEXP;
 }
@@ -1102,11 +1139,12 @@ SEXP create(const core::json::Object& value, Protect* pProtect)
    {
       // set name
       SET_STRING_ELT(namesSEXP, index, Rf_mkChar(member.getName().c_str()));
-      
-      // set value
-      SEXP valueSEXP = create(member.getValue(), pProtect);
+
+      // set value (protected only while created; see create(Array) above)
+      ArenaProtect protect;
+      SEXP valueSEXP = create(member.getValue(), &protect);
       SET_VECTOR_ELT(listSEXP, index,  valueSEXP);
-      
+
       // increment element index
       index++;
    }
@@ -1124,12 +1162,14 @@ SEXP create(const std::vector<std::string>& value, Protect* pProtect)
    pProtect->add(valueSEXP = Rf_allocVector(STRSXP, value.size()));
    
    int index = 0;
-   for (std::vector<std::string>::const_iterator 
+   for (std::vector<std::string>::const_iterator
         it = value.begin(); it != value.end(); ++it)
    {
-      SET_STRING_ELT(valueSEXP, index++, Rf_mkChar(it->c_str()));
+      // the length is already known, so skip Rf_mkChar's strlen
+      SET_STRING_ELT(valueSEXP, index++,
+                     Rf_mkCharLenCE(it->c_str(), it->size(), CE_NATIVE));
    }
-   
+
    return valueSEXP;
 }
    
@@ -1137,10 +1177,11 @@ SEXP create(const std::vector<int>& value, Protect *pProtect)
 {
    SEXP valueSEXP;
    pProtect->add(valueSEXP = Rf_allocVector(INTSXP, value.size()));
-   
-   for (std::size_t i = 0; i < value.size(); ++i) 
-      INTEGER(valueSEXP)[i] = value[i];
-   
+
+   // contiguous storage on both sides, so copy in bulk
+   if (!value.empty())
+      ::memcpy(INTEGER(valueSEXP), &value[0], value.size() * sizeof(int));
+
    return valueSEXP;
 }
 
@@ -1148,10 +1189,11 @@ SEXP create(const std::vector<double>& value, Protect *pProtect)
 {
    SEXP valueSEXP;
    pProtect->add(valueSEXP = Rf_allocVector(REALSXP, value.size()));
-   
-   for (std::size_t i = 0; i < value.size(); ++i) 
-      REAL(valueSEXP)[i] = value[i];
-   
+
+   // contiguous storage on both sides, so copy in bulk
+   if (!value.empty())
+      ::memcpy(REAL(valueSEXP), &value[0], value.size() * sizeof(double));
+
    return valueSEXP;
 }
 
@@ -1368,7 +1410,7 @@ void Protect::add(SEXP sexp)
 {
    PROTECT(sexp);
    protectCount_++;
-}   
+}
 
 void Protect::unprotectAll()
 {
@@ -1377,6 +1419,81 @@ void Protect::unprotectAll()
    protectCount_ = 0;
 }
 
+namespace {
+
+// storage for ArenaProtect: preserved VECSXP batches whose slots anchor
+// the protected objects (an object stored in a preserved list is
+// reachable and therefore safe from the collector). batches are
+// recycled across calls so steady-state protection costs no allocation
+// and no PROTECT stack traffic. main R thread only, like PROTECT itself.
+const std::size_t kArenaBatchSize = 512;
+std::vector<SEXP> s_arenaBatches;
+std::size_t s_arenaIndex = 0;
+
+void arenaAnchor(SEXP sexp)
+{
+   std::size_t batch = s_arenaIndex / kArenaBatchSize;
+   std::size_t slot = s_arenaIndex % kArenaBatchSize;
+   if (batch == s_arenaBatches.size())
+   {
+      // growing the arena allocates, which can run the collector while
+      // the incoming object is still unanchored (it is typically freshly
+      // allocated and reachable from nowhere else) -- keep it alive on
+      // the PROTECT stack for the duration of the batch allocation
+      PROTECT(sexp);
+      SEXP batchSEXP = Rf_allocVector(VECSXP, kArenaBatchSize);
+      R_PreserveObject(batchSEXP);
+      s_arenaBatches.push_back(batchSEXP);
+      UNPROTECT(1);
+   }
+   SET_VECTOR_ELT(s_arenaBatches[batch], slot, sexp);
+   s_arenaIndex++;
+}
+
+void arenaRelease(std::size_t startIndex)
+{
+   // clear the slots this scope used so its objects can be collected
+   for (std::size_t i = startIndex; i < s_arenaIndex; i++)
+   {
+      SET_VECTOR_ELT(s_arenaBatches[i / kArenaBatchSize],
+                     i % kArenaBatchSize,
+                     R_NilValue);
+   }
+   s_arenaIndex = startIndex;
+
+   // when fully unwound keep one batch warm for the next conversion
+   // but release any extras acquired by an unusually large payload
+   if (s_arenaIndex == 0 && s_arenaBatches.size() > 1)
+   {
+      for (std::size_t i = 1; i < s_arenaBatches.size(); i++)
+         R_ReleaseObject(s_arenaBatches[i]);
+      s_arenaBatches.resize(1);
+   }
+}
+
+} // anonymous namespace
+
+ArenaProtect::ArenaProtect()
+   : startIndex_(s_arenaIndex)
+{
+}
+
+ArenaProtect::~ArenaProtect()
+{
+   try
+   {
+      arenaRelease(startIndex_);
+   }
+   catch(...)
+   {
+   }
+}
+
+void ArenaProtect::add(SEXP sexp)
+{
+   arenaAnchor(sexp);
+}
+
 
 PreservedSEXP::PreservedSEXP()
    : sexp_(R_NilValue)
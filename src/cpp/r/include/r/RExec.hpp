@@ -34,6 +34,9 @@
 namespace rstudio {
 namespace core {
    class FilePath;
+   namespace json {
+      class Value;
+   }
 }
 }
 
@@ -111,7 +114,18 @@ core::Error evaluateString(const std::string& str, T* pValue)
 
    return sexp::extract(valueSEXP, pValue);
 }
-   
+
+// evaluate an expression against a forked copy-on-write snapshot of this
+// session and marshal the result back as JSON (Posix only; elsewhere, and
+// when the fork fails, the expression is evaluated inline). evaluation in
+// the child can't block or mutate the parent interpreter, so this is only
+// appropriate for read-only introspection -- any side effects die with the
+// child. must be called from the main R thread; the child is killed if it
+// doesn't produce a result within the given timeout.
+core::Error evaluateStringInForkedSnapshot(const std::string& str,
+                                           double timeoutSeconds,
+                                           core::json::Value* pResult);
+
 // call R functions
 class RFunction : boost::noncopyable
 {
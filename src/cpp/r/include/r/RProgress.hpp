@@ -0,0 +1,65 @@
+/*
+ * RProgress.hpp
+ *
+ * Copyright (C) 2020 by RStudio, PBC
+ *
+ * Unless you have received this program directly from RStudio pursuant
+ * to the terms of a commercial license agreement with RStudio, then
+ * this program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ *
+ */
+
+#ifndef R_R_PROGRESS_HPP
+#define R_R_PROGRESS_HPP
+
+#include <map>
+
+namespace rstudio {
+namespace r {
+namespace exec {
+
+// lock-free progress channel for long computations
+//
+// native code running on worker threads (e.g. parallelized package
+// code) must not call into the R interpreter, so it has no way to
+// report progress through the normal R-level callbacks. these
+// functions provide a fixed-size lock-free ring that any thread can
+// write progress records into without touching R (and without taking
+// a lock, so reporting is safe at high frequency); the session's
+// event loop drains the ring on the interpreter thread, coalescing to
+// the most recent record per channel, and forwards the result to the
+// client at event-loop cadence.
+
+struct ProgressUpdate
+{
+   ProgressUpdate()
+      : channel(0), units(0), max(0)
+   {
+   }
+
+   int channel;
+   double units;
+   double max;
+};
+
+// allocate a fresh progress channel id (call on the main thread)
+int allocateProgressChannel();
+
+// report progress on a channel; safe to call from any thread and never
+// blocks. returns false if the ring was full and the record was
+// dropped (harmless for progress -- a subsequent report supersedes it)
+bool reportProgress(int channel, double units, double max);
+
+// drain all pending progress records, keeping only the most recent per
+// channel; call on the main thread
+void drainProgress(std::map<int, ProgressUpdate>* pUpdates);
+
+} // namespace exec
+} // namespace r
+} // namespace rstudio
+
+#endif // R_R_PROGRESS_HPP
@@ -266,14 +266,33 @@ public:
    virtual ~Protect();
    
    // COPYING: boost::noncopyable
-   
-   void add(SEXP sexp);
+
+   virtual void add(SEXP sexp);
    void unprotectAll();
-   
+
 private:
    int protectCount_;
 };
 
+// arena-style variant of Protect: objects are anchored in slots of a
+// preserved list (allocated in batches and recycled across calls)
+// rather than on R's PROTECT stack. conversion-heavy paths (e.g. the
+// JSON <-> SEXP converters) protect and release hundreds of thousands
+// of objects per RPC, and the per-object protection stack traffic
+// shows up in profiles; anchoring in the arena is a plain vector store.
+// scopes must unwind LIFO, which C++ scoping provides naturally.
+class ArenaProtect : public Protect
+{
+public:
+   ArenaProtect();
+   virtual ~ArenaProtect();
+
+   virtual void add(SEXP sexp);
+
+private:
+   std::size_t startIndex_;
+};
+
 // set list element by name. note that the specified element MUST already
 // exist before the call
 template <typename T>
@@ -16,16 +16,19 @@
 #ifndef R_SESSION_CONSOLE_ACTIONS_HPP
 #define R_SESSION_CONSOLE_ACTIONS_HPP
 
+#include <iosfwd>
+#include <memory>
+
 #include <boost/utility.hpp>
 #include <boost/circular_buffer.hpp>
 
 #include <core/BoostThread.hpp>
+#include <shared_core/FilePath.hpp>
 #include <shared_core/json/Json.hpp>
 
 namespace rstudio {
 namespace core {
    class Error;
-   class FilePath;
 }
 }
 
@@ -42,6 +45,26 @@ ConsoleActions& consoleActions();
 #define kConsoleActionOutput        2
 #define kConsoleActionOutputError   3
 
+// a single console action. actions are stored in this plain form and only
+// converted to their wire representation when a client requests a replay
+// (or the actions are persisted), so high-frequency output doesn't churn
+// json values
+struct ConsoleAction
+{
+   ConsoleAction()
+      : type(kConsoleActionOutput)
+   {
+   }
+
+   ConsoleAction(int type, const std::string& data)
+      : type(type), data(data)
+   {
+   }
+
+   int type;
+   std::string data;
+};
+
 class ConsoleActions : boost::noncopyable
 {
 private:
@@ -67,13 +90,34 @@ public:
    core::Error loadFromFile(const core::FilePath& filePath);
    core::Error saveToFile(const core::FilePath& filePath) const;
 
+   // binary transcript log: typed, length-prefixed records appended
+   // incrementally as actions arrive, so a replay endpoint can stream
+   // the transcript to the client without rebuilding it as json. the
+   // file opens with a 5-byte header ("RSCA" + version byte); each
+   // record is a 1-byte action type, a 4-byte little-endian length,
+   // and the data bytes
+   void setTranscriptFile(const core::FilePath& filePath);
+   const core::FilePath& transcriptFile() const { return transcriptFile_; }
+   void flushTranscript();
+
+private:
+   // these helpers require that mutex_ be held by the caller
+   void openTranscript(bool truncate);
+   void appendTranscriptRecord(int type, const std::string& data);
+   void rewriteTranscript();
+
 private:
    // protect data using a mutex because background threads (e.g.
    // console output capture threads) can interact with console actions
    mutable boost::mutex mutex_;
-   boost::circular_buffer<core::json::Value> actionsType_;
-   boost::circular_buffer<core::json::Value> actionsData_;
+   boost::circular_buffer<ConsoleAction> actions_;
    std::vector<std::string> pendingInput_;
+
+   // binary transcript log state
+   core::FilePath transcriptFile_;
+   std::shared_ptr<std::ostream> transcriptStream_;
+   uintmax_t transcriptBytes_ = 0;
+   uintmax_t transcriptBaseBytes_ = 0;
 };
 
    
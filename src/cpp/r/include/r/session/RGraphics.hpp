@@ -78,6 +78,7 @@ namespace graphics {
 
 std::string getDefaultBackend();
 std::string getDefaultAntialiasing();
+bool vectorPlotsEnabled();
 
 namespace device {
 
@@ -16,8 +16,9 @@
 #ifndef R_SESSION_GRAPHICS_CONSTANTS_HPP
 #define R_SESSION_GRAPHICS_CONSTANTS_HPP
 
-#define kGraphicsOptionBackend   "RStudioGD.backend"
-#define kGraphicsOptionAntialias "RStudioGD.antialias"
+#define kGraphicsOptionBackend     "RStudioGD.backend"
+#define kGraphicsOptionAntialias   "RStudioGD.antialias"
+#define kGraphicsOptionVectorPlots "RStudioGD.vector"
 
 #endif // R_SESSION_GRAPHICS_CONSTANTS_HPP
 
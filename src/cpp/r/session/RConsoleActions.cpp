@@ -34,9 +34,18 @@ namespace rstudio {
 namespace r {
 namespace session {
 
-namespace {   
+namespace {
 const char * const kActionType = "type";
 const char * const kActionData = "data";
+
+// binary transcript format constants (see RConsoleActions.hpp for the
+// record layout)
+const char * const kTranscriptMagic = "RSCA";
+const unsigned char kTranscriptVersion = 1;
+
+// rewrite the transcript from the (capacity-bounded) in-memory buffer
+// once the file grows past this size, so replay payloads stay bounded
+const uintmax_t kTranscriptMaxBytes = 2 * 1024 * 1024;
 }
    
 ConsoleActions& consoleActions()
@@ -54,7 +63,7 @@ int ConsoleActions::capacity() const
 {
    LOCK_MUTEX(mutex_)
    {
-      return gsl::narrow_cast<int>(actionsType_.capacity());
+      return gsl::narrow_cast<int>(actions_.capacity());
    }
    END_LOCK_MUTEX
 
@@ -66,8 +75,7 @@ void ConsoleActions::setCapacity(int capacity)
 {
    LOCK_MUTEX(mutex_)
    {
-      actionsType_.set_capacity(capacity);
-      actionsData_.set_capacity(capacity);
+      actions_.set_capacity(capacity);
    }
    END_LOCK_MUTEX
 }
@@ -98,16 +106,30 @@ void ConsoleActions::add(int type, const std::string& data)
       // didn't cap the size of combined output then the output actions could
       // grow to arbitrary size)
       if (type == kConsoleActionOutput &&
-          actionsType_.size() > 0      &&
-          actionsType_.back().getInt() == kConsoleActionOutput &&
-          actionsData_.back().getString().size() < 512)
+          !actions_.empty()            &&
+          actions_.back().type == kConsoleActionOutput &&
+          actions_.back().data.size() < 512)
       {
-         actionsData_.back() = actionsData_.back().getString() + data;
+         actions_.back().data.append(data);
       }
       else
       {
-         actionsType_.push_back(json::Value(type));
-         actionsData_.push_back(json::Value(data));
+         actions_.push_back(ConsoleAction(type, data));
+      }
+
+      // mirror the action into the binary transcript log (combined
+      // output records replay identically to the combined action)
+      appendTranscriptRecord(type, data);
+
+      // keep the file bounded: once it outgrows both the limit and twice
+      // its size after the last rewrite (the latter prevents rewriting on
+      // every action when the buffer itself serializes past the limit),
+      // replay the capacity-bounded in-memory buffer into a fresh file
+      if (transcriptStream_ &&
+          transcriptBytes_ > kTranscriptMaxBytes &&
+          transcriptBytes_ > transcriptBaseBytes_ * 2)
+      {
+         rewriteTranscript();
       }
    }
    END_LOCK_MUTEX
@@ -127,12 +149,104 @@ void ConsoleActions::reset()
    LOCK_MUTEX(mutex_)
    {
       // clear the existing actions
-      actionsType_.clear();
-      actionsData_.clear();
+      actions_.clear();
+
+      // restart the transcript log to match
+      if (transcriptStream_)
+         rewriteTranscript();
    }
    END_LOCK_MUTEX
 }
-   
+
+void ConsoleActions::setTranscriptFile(const FilePath& filePath)
+{
+   LOCK_MUTEX(mutex_)
+   {
+      transcriptFile_ = filePath;
+
+      // start fresh (the in-memory buffer is authoritative at startup;
+      // anything in a leftover file belongs to a previous session)
+      rewriteTranscript();
+   }
+   END_LOCK_MUTEX
+}
+
+void ConsoleActions::flushTranscript()
+{
+   LOCK_MUTEX(mutex_)
+   {
+      if (transcriptStream_)
+         transcriptStream_->flush();
+   }
+   END_LOCK_MUTEX
+}
+
+void ConsoleActions::openTranscript(bool truncate)
+{
+   transcriptStream_.reset();
+   transcriptBytes_ = 0;
+
+   if (transcriptFile_.isEmpty())
+      return;
+
+   Error error = transcriptFile_.openForWrite(transcriptStream_, truncate);
+   if (error)
+   {
+      // log and run without a transcript (replay falls back to json)
+      LOG_ERROR(error);
+      transcriptStream_.reset();
+      return;
+   }
+
+   transcriptStream_->write(kTranscriptMagic, 4);
+   transcriptStream_->put(static_cast<char>(kTranscriptVersion));
+   transcriptBytes_ = 5;
+}
+
+void ConsoleActions::appendTranscriptRecord(int type,
+                                            const std::string& data)
+{
+   if (!transcriptStream_)
+      return;
+
+   // typed, length-prefixed record
+   unsigned char header[5];
+   header[0] = static_cast<unsigned char>(type);
+   std::size_t size = data.size();
+   header[1] = static_cast<unsigned char>(size & 0xFF);
+   header[2] = static_cast<unsigned char>((size >> 8) & 0xFF);
+   header[3] = static_cast<unsigned char>((size >> 16) & 0xFF);
+   header[4] = static_cast<unsigned char>((size >> 24) & 0xFF);
+
+   transcriptStream_->write(reinterpret_cast<const char*>(header),
+                            sizeof(header));
+   transcriptStream_->write(data.data(), size);
+   transcriptBytes_ += sizeof(header) + size;
+
+   if (!*transcriptStream_)
+   {
+      // disable the transcript rather than logging on every action
+      LOG_WARNING_MESSAGE("error writing console transcript: " +
+                          transcriptFile_.getAbsolutePath());
+      transcriptStream_.reset();
+   }
+}
+
+void ConsoleActions::rewriteTranscript()
+{
+   openTranscript(true);
+   if (!transcriptStream_)
+      return;
+
+   for (const ConsoleAction& action : actions_)
+      appendTranscriptRecord(action.type, action.data);
+
+   transcriptBaseBytes_ = transcriptBytes_;
+
+   if (transcriptStream_)
+      transcriptStream_->flush();
+}
+
 void ConsoleActions::asJson(json::Object* pActions) const
 {
    LOCK_MUTEX(mutex_)
@@ -140,18 +254,15 @@ void ConsoleActions::asJson(json::Object* pActions) const
       // clear inbound
       pActions->clear();
 
-      // copy actions and insert into destination
+      // produce the wire representation (two identically sized arrays)
       json::Array actionsType;
-      std::copy(actionsType_.begin(),
-                actionsType_.end(),
-                std::back_inserter(actionsType));
-      pActions->operator[](kActionType) = actionsType;
-
-      // copy data and insert into destination
       json::Array actionsData;
-      std::copy(actionsData_.begin(),
-                actionsData_.end(),
-                std::back_inserter(actionsData));
+      for (const ConsoleAction& action : actions_)
+      {
+         actionsType.push_back(json::Value(action.type));
+         actionsData.push_back(json::Value(action.data));
+      }
+      pActions->operator[](kActionType) = actionsType;
       pActions->operator[](kActionData) = actionsData;
    }
    END_LOCK_MUTEX
@@ -161,8 +272,7 @@ Error ConsoleActions::loadFromFile(const FilePath& filePath)
 {
    LOCK_MUTEX(mutex_)
    {
-      actionsType_.clear();
-      actionsData_.clear();
+      actions_.clear();
 
       if (filePath.exists())
       {
@@ -180,25 +290,24 @@ Error ConsoleActions::loadFromFile(const FilePath& filePath)
             json::Object actions = value.getObject();
 
             json::Value typeValue = actions[kActionType];
-            if (typeValue.getType() == json::Type::ARRAY)
-            {
-               const json::Array& actionsType = typeValue.getArray();
-               std::copy(actionsType.begin(),
-                         actionsType.end(),
-                         std::back_inserter(actionsType_));
-            }
-            else
-            {
-               LOG_WARNING_MESSAGE("unexpected json type in: " + actionsJson);
-            }
-
             json::Value dataValue = actions[kActionData];
-            if ( dataValue.getType() == json::Type::ARRAY )
+            if (typeValue.getType() == json::Type::ARRAY &&
+                dataValue.getType() == json::Type::ARRAY)
             {
+               const json::Array& actionsType = typeValue.getArray();
                const json::Array& actionsData = dataValue.getArray();
-               std::copy(actionsData.begin(),
-                         actionsData.end(),
-                         std::back_inserter(actionsData_));
+               std::size_t size = std::min(actionsType.getSize(),
+                                           actionsData.getSize());
+               for (std::size_t i = 0; i < size; i++)
+               {
+                  json::Value type = actionsType[i];
+                  json::Value data = actionsData[i];
+                  if (type.isInt() && data.isString())
+                  {
+                     actions_.push_back(ConsoleAction(type.getInt(),
+                                                      data.getString()));
+                  }
+               }
             }
             else
             {
@@ -15,6 +15,10 @@
 
 #include <r/session/RConsoleHistory.hpp>
 
+#include <algorithm>
+#include <set>
+#include <vector>
+
 #include <boost/bind.hpp>
 #include <boost/function.hpp>
 #include <boost/tokenizer.hpp>
@@ -173,6 +177,29 @@ Error ConsoleHistory::loadFromFile(const FilePath& filePath,
    
 Error ConsoleHistory::saveToFile(const FilePath& filePath) const
 {
+   // when we are removing duplicates, persist each command only once
+   // (keeping its most recent position) so repeated commands don't bloat
+   // the history file; add() only catches consecutive repeats
+   if (removeDuplicates_)
+   {
+      std::vector<std::string> entries;
+      std::set<std::string> seen;
+      for (boost::circular_buffer<std::string>::const_reverse_iterator
+              it = historyBuffer_.rbegin();
+           it != historyBuffer_.rend();
+           ++it)
+      {
+         if (seen.insert(*it).second)
+            entries.push_back(*it);
+      }
+      std::reverse(entries.begin(), entries.end());
+
+      return core::writeCollectionToFile<std::vector<std::string> >(
+                                                      filePath,
+                                                      entries,
+                                                      core::stringifyString);
+   }
+
    return core::writeCollectionToFile<boost::circular_buffer<std::string> >(
                                                       filePath,
                                                       historyBuffer_,
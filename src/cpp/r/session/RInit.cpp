@@ -27,6 +27,7 @@
 
 #include "REmbedded.hpp"
 #include "RInit.hpp"
+#include "RSearchPath.hpp"
 #include "RSuspend.hpp"
 #include "RStdCallbacks.hpp"
 #include "RRestartContext.hpp"
@@ -115,6 +116,10 @@ void deferredRestoreSuspendedSession(
 
 void deferredRestoreNewSession()
 {
+   // any cached environment serialization belongs to a previous suspended
+   // session, not the workspace we're about to load
+   search_path::invalidateEnvironmentCache();
+
    // restore the default global environment if there is one
    FilePath globalEnvPath = utils::startupEnvironmentFilePath();
    if (utils::restoreWorkspace() && globalEnvPath.exists())
@@ -45,6 +45,8 @@
 
 #include <r/session/RSessionUtils.hpp>
 
+#include "RStdCallbacks.hpp"
+
 using namespace rstudio::core;
 
 namespace rstudio {
@@ -58,6 +60,7 @@ namespace search_path {
 namespace {   
 
 const char * const kEnvironmentFile = "environment";
+const char * const kEnvironmentLazyFile = "environment_lazy";
 const char * const kSearchPathDir = "search_path";
    
 const char * const kSearchPathElementsDir = "search_path_elements";
@@ -83,20 +86,133 @@ void reportRestoreError(const std::string& context,
    REprintf("%s\n", report.c_str());
 }   
    
-Error saveGlobalEnvironmentToFile(const FilePath& environmentFile)
+// cached copy of the most recently restored monolithic environment file.
+// R marks the image as dirty whenever a top-level evaluation occurs, so as
+// long as the image is still clean the cached serialization describes the
+// live image exactly -- this lets a session which was resumed and then
+// suspended again without any user activity (a common pattern under load
+// balancing) skip re-serializing a potentially very large workspace
+FilePath environmentCacheFilePath()
 {
-   std::string envPath =
-            string_utils::utf8ToSystem(environmentFile.getAbsolutePath());
-   return executeSafely(boost::bind(R_SaveGlobalEnvToFile, envPath.c_str()));
+   return utils::scopedScratchPath().completePath("environment-cache");
 }
-   
-Error restoreGlobalEnvironment(const core::FilePath& environmentFile)
+
+// directory holding the lazy-load database which backs the current session's
+// global environment. the database is moved here at restore time because
+// unevaluated promises read from it on demand, so it must outlive the
+// suspended state directory (which is destroyed once the restore completes)
+FilePath lazyResumeDirPath()
+{
+   return utils::scopedScratchPath().completePath("lazy-resume");
+}
+
+FilePath lazyDbFilePath(const FilePath& dirPath, const std::string& extension)
+{
+   return dirPath.completePath(std::string(kEnvironmentLazyFile) + extension);
+}
+
+void updateEnvironmentCache(const FilePath& environmentFile)
+{
+   // discard any previously cached serializations first so that a failed
+   // copy can't leave a stale cache behind
+   invalidateEnvironmentCache();
+
+   Error error = environmentFile.copy(environmentCacheFilePath(), true);
+   if (error)
+      LOG_ERROR(error);
+}
+
+Error saveGlobalEnvironmentToState(const FilePath& statePath)
+{
+   // if nothing has been evaluated since the environment was restored then
+   // the serialization which produced the current image can be reused
+   // rather than walking the entire workspace again
+   if (!imageIsDirty())
+   {
+      // lazy-load database left in place by the last resume
+      FilePath dbDirPath = lazyResumeDirPath();
+      if (lazyDbFilePath(dbDirPath, ".rdx").exists())
+      {
+         Error error = lazyDbFilePath(dbDirPath, ".rdx").copy(
+                              lazyDbFilePath(statePath, ".rdx"), true);
+         if (!error)
+            error = lazyDbFilePath(dbDirPath, ".rdb").copy(
+                              lazyDbFilePath(statePath, ".rdb"), true);
+         if (!error)
+            return Success();
+
+         // fall back to a full serialization
+         LOG_ERROR(error);
+      }
+
+      // monolithic environment file cached when the workspace was restored
+      // from state written by an older version
+      FilePath cacheFilePath = environmentCacheFilePath();
+      if (cacheFilePath.exists())
+      {
+         Error error = cacheFilePath.copy(
+                              statePath.completePath(kEnvironmentFile), true);
+         if (!error)
+            return Success();
+
+         // fall back to a full serialization
+         LOG_ERROR(error);
+      }
+   }
+
+   // serialize the workspace as a lazy-load database -- resume attaches
+   // the objects as promises from the index alone, so the console becomes
+   // available without deserializing object data (which is faulted in on
+   // first access)
+   FilePath filebase = statePath.completePath(kEnvironmentLazyFile);
+   return RFunction(".rs.saveGlobalEnvLazy",
+                    filebase.getAbsolutePath()).call();
+}
+
+Error restoreGlobalEnvironment(const FilePath& statePath)
 {
-   // tolerate no environment saved
+   // lazy-load database format
+   if (lazyDbFilePath(statePath, ".rdx").exists())
+   {
+      // cached serializations from any previous image are now superseded
+      invalidateEnvironmentCache();
+
+      // move the database out of the state directory so it survives for
+      // the lifetime of the session
+      FilePath dbDirPath = lazyResumeDirPath();
+      Error error = dbDirPath.resetDirectory();
+      if (error)
+         return error;
+
+      error = lazyDbFilePath(statePath, ".rdx").move(
+                           lazyDbFilePath(dbDirPath, ".rdx"));
+      if (!error)
+         error = lazyDbFilePath(statePath, ".rdb").move(
+                           lazyDbFilePath(dbDirPath, ".rdb"));
+      if (error)
+         return error;
+
+      // attach the objects to the global environment as promises
+      FilePath filebase = dbDirPath.completePath(kEnvironmentLazyFile);
+      return RFunction(".rs.lazyLoadGlobalEnv",
+                       filebase.getAbsolutePath()).call();
+   }
+
+   // monolithic environment file written by older versions
+   // (tolerate no environment saved)
+   FilePath environmentFile = statePath.completePath(kEnvironmentFile);
    if (!environmentFile.exists())
       return Success();
-   
-   return RFunction("load", environmentFile.getAbsolutePath()).call();
+
+   Error error = RFunction("load", environmentFile.getAbsolutePath()).call();
+   if (error)
+      return error;
+
+   // the suspended state directory is destroyed after a successful restore,
+   // so retain the serialization for reuse by the next suspend
+   updateEnvironmentCache(environmentFile);
+
+   return Success();
 }
 
 bool isPackage(const std::string& elementName, std::string* pPackageName)
@@ -232,8 +348,7 @@ void attachEnvironmentData(const FilePath& dataFilePath,
 Error save(const FilePath& statePath)
 {
    // save the global environment
-   FilePath environmentFile = statePath.completePath(kEnvironmentFile);
-   Error error = saveGlobalEnvironmentToFile(environmentFile);
+   Error error = saveGlobalEnvironmentToState(statePath);
    if (error)
       return error;
    
@@ -325,8 +440,26 @@ Error save(const FilePath& statePath)
 
 Error saveGlobalEnvironment(const FilePath& statePath)
 {
-   FilePath environmentFile = statePath.completePath(kEnvironmentFile);
-   return saveGlobalEnvironmentToFile(environmentFile);
+   return saveGlobalEnvironmentToState(statePath);
+}
+
+void invalidateEnvironmentCache()
+{
+   FilePath cacheFilePath = environmentCacheFilePath();
+   if (cacheFilePath.exists())
+   {
+      Error error = cacheFilePath.remove();
+      if (error)
+         LOG_ERROR(error);
+   }
+
+   FilePath dbDirPath = lazyResumeDirPath();
+   if (dbDirPath.exists())
+   {
+      Error error = dbDirPath.remove();
+      if (error)
+         LOG_ERROR(error);
+   }
 }
 
 Error restoreSearchPath(const FilePath& statePath)
@@ -407,11 +540,16 @@ Error restore(const FilePath& statePath, bool isCompatibleSessionState)
    // restore global environment unless suppressed
    if (utils::restoreEnvironmentOnResume())
    {
-      FilePath environmentFile = statePath.completePath(kEnvironmentFile);
-      Error error = restoreGlobalEnvironment(environmentFile);
+      Error error = restoreGlobalEnvironment(statePath);
       if (error)
          return error;
    }
+   else
+   {
+      // the saved serializations don't describe the (empty) image this
+      // session starts with, so make sure they can't be reused
+      invalidateEnvironmentCache();
+   }
 
    // only restore the search path if we have a compatible R version
    // (guard against attempts to attach incompatible packages to this
@@ -31,6 +31,10 @@ namespace search_path {
 core::Error save(const core::FilePath& statePath);
 core::Error saveGlobalEnvironment(const core::FilePath& statePath);
 core::Error restore(const core::FilePath& statePath, bool isCompatibleSessionState = true);
+
+// discard the cached serialization of the global environment (used to
+// avoid re-serializing an unchanged workspace at suspend time)
+void invalidateEnvironmentCache();
    
 } // namespace search_path
 } // namespace session
@@ -28,32 +28,46 @@
 #include <r/RExec.hpp>
 #include <r/session/RGraphics.hpp>
 
+#include "RGraphicsDevice.hpp"
+
 using namespace rstudio::core;
 
 namespace rstudio {
 namespace r {
 namespace session {
 namespace graphics {
-      
+
+namespace {
+
+// maximum bytes of cached renders retained per plot; least recently used
+// renders are evicted beyond this
+const std::size_t kMaxRenderCacheBytes = 8 * 1024 * 1024;
+
+} // anonymous namespace
+
 Plot::Plot(const GraphicsDeviceFunctions& graphicsDevice,
            const FilePath& baseDirPath,
            SEXP manipulatorSEXP)
-   : graphicsDevice_(graphicsDevice), 
+   : graphicsDevice_(graphicsDevice),
      baseDirPath_(baseDirPath),
+     renderedPixelRatio_(1.0),
      needsUpdate_(false),
+     renderCacheUse_(0),
      manipulator_(manipulatorSEXP)
 {
 }
 
 Plot::Plot(const GraphicsDeviceFunctions& graphicsDevice,
-           const FilePath& baseDirPath, 
+           const FilePath& baseDirPath,
            const std::string& storageUuid,
            const DisplaySize& renderedSize)
-   : graphicsDevice_(graphicsDevice), 
-     baseDirPath_(baseDirPath), 
+   : graphicsDevice_(graphicsDevice),
+     baseDirPath_(baseDirPath),
      storageUuid_(storageUuid),
      renderedSize_(renderedSize),
+     renderedPixelRatio_(1.0),
      needsUpdate_(false),
+     renderCacheUse_(0),
      manipulator_()
 {
    // invalidate if the image file doesn't exist (allows the server
@@ -121,38 +135,59 @@ void Plot::saveManipulator() const
    
 Error Plot::renderFromDisplay()
 {
-   // we can use our cached representation if we don't need an update and our 
+   // we can use our cached representation if we don't need an update and our
    // rendered size is the same as the current graphics device size
    if ( !needsUpdate_ &&
         (renderedSize() == graphicsDevice_.displaySize()) )
    {
       return Success();
    }
-   
+
+   // if only the size has changed (e.g. while the Plots pane is being
+   // resized) and we've already rendered this plot at the requested size,
+   // just point back at those files rather than re-rendering
+   RenderKey key = currentRenderKey();
+   if (!needsUpdate_ && restoreCachedRender(key))
+      return Success();
+
    // generate a new storage uuid
    std::string storageUuid = core::system::generateUuid();
-   
+
    // generate snapshot and image files
    FilePath snapshotPath = snapshotFilePath(storageUuid);
    FilePath imagePath = imageFilePath(storageUuid);
    Error error = graphicsDevice_.saveSnapshot(snapshotPath, imagePath);
    if (error)
       return Error(errc::PlotRenderingError, error, ERROR_LOCATION);
-   
-   // save rendered size
-   renderedSize_ = graphicsDevice_.displaySize();
-   
+
    // save manipulator (if any)
    saveManipulator(storageUuid);
 
-   // delete existing files (if any)
-   Error removeError = removeFiles();
-        
+   Error removeError;
+   if (!needsUpdate_ && hasStorage())
+   {
+      // the plot's contents haven't changed, so the previous render is
+      // still valid at its size; retain it so stepping back over a recent
+      // size reuses it
+      cacheRender(RenderKey(renderedSize_.width,
+                            renderedSize_.height,
+                            renderedPixelRatio_),
+                  storageUuid_);
+   }
+   else
+   {
+      // contents changed; any cached renders show a stale display list
+      clearRenderCache();
+      removeError = removeStorageFiles(storageUuid_);
+   }
+
    // update state
    storageUuid_ = storageUuid;
+   renderedSize_ = graphicsDevice_.displaySize();
+   renderedPixelRatio_ = key.devicePixelRatio;
    needsUpdate_ = false;
-   
-   // return error status 
+
+   // return error status
    return removeError;
 }
    
@@ -221,25 +256,133 @@ Error Plot::renderToDisplay()
 }
    
 Error Plot::removeFiles()
+{
+   // remove any cached renders along with the active files
+   clearRenderCache();
+   return removeStorageFiles(storageUuid_);
+}
+
+Error Plot::removeStorageFiles(const std::string& storageUuid)
 {
    // bail if we don't have any storage
-   if (storageUuid_.empty())
+   if (storageUuid.empty())
       return Success();
-   
-   Error snapshotError = snapshotFilePath(storageUuid_).removeIfExists();
-   Error imageError = imageFilePath(storageUuid_).removeIfExists();
-   Error manipulatorError = manipulatorFilePath(storageUuid_).removeIfExists();
-   
+
+   Error snapshotError = snapshotFilePath(storageUuid).removeIfExists();
+   Error imageError = imageFilePath(storageUuid).removeIfExists();
+   Error vectorError = vectorFilePath(storageUuid).removeIfExists();
+   Error manipulatorError = manipulatorFilePath(storageUuid).removeIfExists();
+
    if (snapshotError)
       return Error(errc::PlotFileError, snapshotError, ERROR_LOCATION);
    else if (imageError)
       return Error(errc::PlotFileError, imageError, ERROR_LOCATION);
+   else if (vectorError)
+      return Error(errc::PlotFileError, vectorError, ERROR_LOCATION);
    else if (manipulatorError)
       return Error(errc::PlotFileError, manipulatorError, ERROR_LOCATION);
    else
       return Success();
 }
 
+Plot::RenderKey Plot::currentRenderKey() const
+{
+   DisplaySize size = graphicsDevice_.displaySize();
+   return RenderKey(size.width, size.height, device::devicePixelRatio());
+}
+
+bool Plot::restoreCachedRender(const RenderKey& key)
+{
+   std::map<RenderKey, CachedRender>::iterator it = renderCache_.find(key);
+   if (it == renderCache_.end())
+      return false;
+
+   // the cached files may have been removed out from under us; treat
+   // that as a miss
+   std::string cachedUuid = it->second.storageUuid;
+   if (!snapshotFilePath(cachedUuid).exists() ||
+       !imageFilePath(cachedUuid).exists())
+   {
+      renderCache_.erase(it);
+      return false;
+   }
+
+   // the cached render becomes active and the active render goes back
+   // into the cache
+   renderCache_.erase(it);
+   cacheRender(RenderKey(renderedSize_.width,
+                         renderedSize_.height,
+                         renderedPixelRatio_),
+               storageUuid_);
+
+   storageUuid_ = cachedUuid;
+   renderedSize_ = graphicsDevice_.displaySize();
+   renderedPixelRatio_ = key.devicePixelRatio;
+   return true;
+}
+
+void Plot::cacheRender(const RenderKey& key, const std::string& storageUuid)
+{
+   // if another render is already cached under this key, its files are
+   // being replaced
+   std::map<RenderKey, CachedRender>::iterator it = renderCache_.find(key);
+   if (it != renderCache_.end() && it->second.storageUuid != storageUuid)
+   {
+      Error error = removeStorageFiles(it->second.storageUuid);
+      if (error)
+         LOG_ERROR(error);
+   }
+
+   CachedRender render;
+   render.storageUuid = storageUuid;
+   render.lastUse = ++renderCacheUse_;
+   renderCache_[key] = render;
+
+   evictCachedRenders(kMaxRenderCacheBytes);
+}
+
+void Plot::evictCachedRenders(std::size_t maxBytes)
+{
+   while (!renderCache_.empty())
+   {
+      // total the bytes held by cached images
+      uintmax_t cacheBytes = 0;
+      for (std::map<RenderKey, CachedRender>::iterator
+              it = renderCache_.begin(); it != renderCache_.end(); ++it)
+      {
+         cacheBytes += imageFilePath(it->second.storageUuid).getSize();
+      }
+      if (cacheBytes <= maxBytes)
+         break;
+
+      // over budget; evict the least recently used render
+      std::map<RenderKey, CachedRender>::iterator lru = renderCache_.begin();
+      for (std::map<RenderKey, CachedRender>::iterator
+              it = renderCache_.begin(); it != renderCache_.end(); ++it)
+      {
+         if (it->second.lastUse < lru->second.lastUse)
+            lru = it;
+      }
+
+      Error error = removeStorageFiles(lru->second.storageUuid);
+      if (error)
+         LOG_ERROR(error);
+      renderCache_.erase(lru);
+   }
+}
+
+void Plot::clearRenderCache()
+{
+   for (std::map<RenderKey, CachedRender>::iterator
+           it = renderCache_.begin(); it != renderCache_.end(); ++it)
+   {
+      Error error = removeStorageFiles(it->second.storageUuid);
+      if (error)
+         LOG_ERROR(error);
+   }
+   renderCache_.clear();
+}
+
 void Plot::purgeInMemoryResources()
 {
    manipulator_.clear();
@@ -267,6 +410,13 @@ FilePath Plot::imageFilePath(const std::string& storageUuid) const
    return baseDirPath_.completePath(storageUuid + "." + extension);
 }
 
+// optional vector rendering emitted alongside the bitmap when vector
+// plot delivery is enabled (see RShadowPngGraphicsHandler.cpp)
+FilePath Plot::vectorFilePath(const std::string& storageUuid) const
+{
+   return baseDirPath_.completePath(storageUuid + ".svg");
+}
+
 bool Plot::hasManipulatorFile() const
 {
    return hasStorage() && manipulatorFilePath(storageUuid()).exists();
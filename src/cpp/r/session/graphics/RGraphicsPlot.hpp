@@ -16,6 +16,7 @@
 #ifndef R_SESSION_GRAPHICS_PLOT_HPP
 #define R_SESSION_GRAPHICS_PLOT_HPP
 
+#include <map>
 #include <string>
 
 #include <boost/utility.hpp>
@@ -73,6 +74,10 @@ public:
    
    core::Error removeFiles();
 
+   // drops renders cached at other sizes (and their backing files); cached
+   // renders aren't serialized, so this is also called before suspending
+   void clearRenderCache();
+
    void purgeInMemoryResources();
    
 private:
@@ -81,19 +86,64 @@ private:
    core::FilePath snapshotFilePath() const;
    core::FilePath snapshotFilePath(const std::string& storageUuid) const;
    core::FilePath imageFilePath(const std::string& storageUuid) const;
+   core::FilePath vectorFilePath(const std::string& storageUuid) const;
 
    bool hasManipulatorFile() const;
    core::FilePath manipulatorFilePath(const std::string& storageUuid) const;
    void loadManipulatorIfNecessary() const;
    void saveManipulator(const std::string& storageUuid) const;
 
+   // identifies a rendered image of this plot at a particular size
+   struct RenderKey
+   {
+      RenderKey() : width(0), height(0), devicePixelRatio(1.0) {}
+      RenderKey(int width, int height, double devicePixelRatio)
+         : width(width), height(height), devicePixelRatio(devicePixelRatio)
+      {
+      }
+
+      bool operator<(const RenderKey& other) const
+      {
+         if (width != other.width)
+            return width < other.width;
+         if (height != other.height)
+            return height < other.height;
+         return devicePixelRatio < other.devicePixelRatio;
+      }
+
+      int width;
+      int height;
+      double devicePixelRatio;
+   };
+
+   struct CachedRender
+   {
+      CachedRender() : lastUse(0) {}
+
+      std::string storageUuid;
+      unsigned long lastUse;
+   };
+
+   RenderKey currentRenderKey() const;
+   bool restoreCachedRender(const RenderKey& key);
+   void cacheRender(const RenderKey& key, const std::string& storageUuid);
+   void evictCachedRenders(std::size_t maxBytes);
+   core::Error removeStorageFiles(const std::string& storageUuid);
+
 private:
    GraphicsDeviceFunctions graphicsDevice_;
    core::FilePath baseDirPath_;
    std::string storageUuid_;
    DisplaySize renderedSize_;
+   double renderedPixelRatio_;
    bool needsUpdate_;
 
+   // renders of this plot at other sizes, retained so that stepping back
+   // through recent sizes (e.g. while dragging the Plots pane splitter)
+   // doesn't replay the display list
+   std::map<RenderKey, CachedRender> renderCache_;
+   unsigned long renderCacheUse_;
+
    // manipulator and protection scope for it
    mutable PlotManipulator manipulator_;
 };
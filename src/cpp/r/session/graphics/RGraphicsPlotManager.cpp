@@ -617,9 +617,18 @@ Error PlotManager::savePlotsState()
    if (!graphicsPath_.exists())
       return Success();
 
+   // cached renders aren't serialized; drop them (and their files) so they
+   // don't accumulate across sessions
+   for (boost::circular_buffer<PtrPlot>::const_iterator it = plots_.begin();
+        it != plots_.end();
+        ++it)
+   {
+      (*it)->clearRenderCache();
+   }
+
    // list to write
    std::vector<std::string> plots;
-   
+
     // write the storage id of the active plot
    if (hasPlot())
       plots.push_back(activePlot().storageUuid());
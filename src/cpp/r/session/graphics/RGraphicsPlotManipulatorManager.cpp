@@ -86,7 +86,9 @@ void safeExecuteManipulator(SEXP manipulatorSEXP)
    CATCH_UNEXPECTED_EXCEPTION
 }
 
-void setManipulatorButtonsToFalse(SEXP manipulatorSEXP)
+// set all buttons to false; returns the button names so callers can
+// track which values were modified
+std::vector<std::string> setManipulatorButtonsToFalse(SEXP manipulatorSEXP)
 {
    // get the list of buttons
    std::vector<std::string> buttonNames;
@@ -95,7 +97,7 @@ void setManipulatorButtonsToFalse(SEXP manipulatorSEXP)
    if (error)
    {
       logAndReportError(error, ERROR_LOCATION);
-      return;
+      return buttonNames;
    }
 
    // set the values
@@ -104,6 +106,8 @@ void setManipulatorButtonsToFalse(SEXP manipulatorSEXP)
                  boost::bind(setManipulatorValueToFalse,
                              manipulatorSEXP,
                              _1));
+
+   return buttonNames;
 }
 
 SEXP rs_executeAndAttachManipulator(SEXP manipulatorSEXP)
@@ -147,7 +151,8 @@ PlotManipulatorManager& plotManipulatorManager()
 
 PlotManipulatorManager::PlotManipulatorManager()
    :  pendingManipulatorSEXP_(R_NilValue),
-      replayingManipulator_(false)
+      replayingManipulator_(false),
+      appliedManipulatorSEXP_(R_NilValue)
 {
 }
       
@@ -250,26 +255,75 @@ void PlotManipulatorManager::replayManipulator(SEXP manipulatorSEXP)
 
 void PlotManipulatorManager::setPlotManipulatorValues(const json::Object& values)
 {
-   if (manipulatorIsActive())
+   if (!manipulatorIsActive())
+   {
+      LOG_WARNING_MESSAGE("called setPlotManipulatorValues but active plot "
+                          "has no manipulator");
+      return;
+   }
+
+   // merge into the pending state (latest value wins). if a replay is
+   // already executing then just return -- the in-flight call replays
+   // the final pending state once it completes, so a burst of slider
+   // ticks renders once more rather than once per tick
+   for (const json::Object::Member& member : values)
+      pendingValues_.insert(member.getName(), member.getValue());
+
+   if (replayingManipulator_)
+      return;
+
+   replayPendingManipulatorValues();
+}
+
+void PlotManipulatorManager::replayPendingManipulatorValues()
+{
+   while (pendingValues_.getSize() > 0 && manipulatorIsActive())
    {
+      // take the pending state (ticks arriving during the replay below
+      // accumulate into a fresh pending object)
+      json::Object values;
+      std::swap(values, pendingValues_);
+
       // get the manipulator
       SEXP manipulatorSEXP = plotManager().activePlot().manipulatorSEXP();
 
-      // set the underlying values
-      std::for_each(values.begin(),
-                    values.end(),
-                    boost::bind(setManipulatorJsonValue, manipulatorSEXP, _1));
+      // the applied-value cache tracks a single manipulator; reset it
+      // when the active manipulator changes
+      if (manipulatorSEXP != appliedManipulatorSEXP_)
+      {
+         appliedValues_.clear();
+         appliedManipulatorSEXP_ = manipulatorSEXP;
+      }
+
+      // set the underlying values, diffing against the values most
+      // recently applied -- a tick which changes nothing needs no replay
+      bool changed = false;
+      for (const json::Object::Member& member : values)
+      {
+         json::Object::Iterator it = appliedValues_.find(member.getName());
+         if (it != appliedValues_.end() &&
+             (*it).getValue() == member.getValue())
+         {
+            continue;
+         }
+
+         setManipulatorJsonValue(manipulatorSEXP, member);
+         appliedValues_.insert(member.getName(), member.getValue());
+         changed = true;
+      }
+
+      if (!changed)
+         continue;
 
       // replay the manipulator
       replayManipulator(manipulatorSEXP);
 
-      // set all of the buttons to false
-      setManipulatorButtonsToFalse(manipulatorSEXP);
-   }
-   else
-   {
-      LOG_WARNING_MESSAGE("called setPlotManipulatorValues but active plot "
-                          "has no manipulator");
+      // set all of the buttons to false, and forget their applied values
+      // (the next press of the same button must replay again)
+      std::vector<std::string> buttonNames =
+                                 setManipulatorButtonsToFalse(manipulatorSEXP);
+      for (const std::string& buttonName : buttonNames)
+         appliedValues_.erase(buttonName);
    }
 }
 
@@ -75,14 +75,24 @@ private:
    bool manipulatorIsActive() const;
    bool trackingMouseClicks(SEXP manipulatorSEXP) const;
    void replayManipulator(SEXP manipulatorSEXP);
+   void replayPendingManipulatorValues();
 
-private:   
+private:
    // pending manipulator
    SEXP pendingManipulatorSEXP_;
 
    // are we currently replaying a manipulator call?
    bool replayingManipulator_;
 
+   // values waiting to be applied -- ticks which arrive while a replay
+   // is in flight are conflated here (latest value wins)
+   core::json::Object pendingValues_;
+
+   // values most recently applied to the active manipulator, used to
+   // skip replays for ticks which don't change any value
+   core::json::Object appliedValues_;
+   SEXP appliedManipulatorSEXP_;
+
    // manipulator event hook
    RSTUDIO_BOOST_SIGNAL<void ()> onShowManipulator_;
 
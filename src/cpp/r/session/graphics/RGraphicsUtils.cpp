@@ -120,6 +120,14 @@ std::string getDefaultAntialiasing()
             false);
 }
 
+bool vectorPlotsEnabled()
+{
+   return r::options::getOption<bool>(
+            kGraphicsOptionVectorPlots,
+            false,
+            false);
+}
+
 void setCompatibleEngineVersion(int version)
 {
    s_compatibleEngineVersion = version;
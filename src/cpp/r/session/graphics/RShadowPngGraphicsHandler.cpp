@@ -74,8 +74,22 @@ private:
 
 struct ShadowDeviceData
 {
-   ShadowDeviceData() : pShadowPngDevice(nullptr) {}
+   ShadowDeviceData()
+      : pShadowPngDevice(nullptr), syncPending(false), rasterOnPage(false)
+   {
+   }
    pDevDesc pShadowPngDevice;
+
+   // the display list needs to be replayed onto the shadow device before
+   // it's next drawn to (set after writeToPNG recycles the device; the
+   // replay is deferred to just before the next R execution so back to
+   // back renders don't each pay for a full replay)
+   bool syncPending;
+
+   // has the current page drawn any raster images? raster-heavy pages
+   // are delivered as png rather than svg (bitmap encoding is far more
+   // compact there)
+   bool rasterOnPage;
 };
 
 void shadowDevOff(DeviceContext* pDC)
@@ -242,6 +256,11 @@ FilePath tempFile(const std::string& extension)
 
 void shadowDevSync(DeviceContext* pDC)
 {
+   // any pending replay is satisfied by this sync
+   ShadowDeviceData* pDevData = (ShadowDeviceData*)pDC->pDeviceSpecific;
+   if (pDevData != nullptr)
+      pDevData->syncPending = false;
+
    // get the rstudio device number
    pGEDevDesc rsGEDevDesc = desc2GEDesc(pDC->dev);
    int rsDeviceNumber = GEdeviceNumber(rsGEDevDesc);
@@ -270,6 +289,34 @@ void shadowDevSync(DeviceContext* pDC)
    }
 }
 
+// replay the display list onto an svg device, leaving a vector rendering
+// alongside the png (which remains the fallback and the source for zoom,
+// export and clipboard operations)
+void writeToSVG(const FilePath& pngPath, DeviceContext* pDC)
+{
+   FilePath svgPath = pngPath.getParent().completePath(
+                                             pngPath.getStem() + ".svg");
+
+   int rsDeviceNumber = GEdeviceNumber(desc2GEDesc(pDC->dev));
+
+   // the svg device sizes in inches (the display sizes in logical
+   // 96 dpi pixels)
+   double width = pDC->width / 96.0;
+   double height = pDC->height / 96.0;
+
+   Error error = r::exec::RFunction(".rs.saveVectorGraphics")
+         .addParam(rsDeviceNumber)
+         .addParam(string_utils::utf8ToSystem(svgPath.getAbsolutePath()))
+         .addParam(width)
+         .addParam(height)
+         .call();
+
+   // vector output is strictly additive, so render failures just mean
+   // the png is delivered as before
+   if (error && !r::isCodeExecutionError(error))
+      LOG_ERROR(error);
+}
+
 } // anonymous namespace
 
 
@@ -344,10 +391,23 @@ Error writeToPNG(const FilePath& targetPath, DeviceContext* pDC)
    // sync the shadow device to ensure we have the full playlist,
    shadowDevSync(pDC);
 
+   // when vector plot delivery is enabled, also emit an svg rendering
+   // alongside the png -- the session serves it in place of the png for
+   // display in the Plots pane. pages that drew rasters stick with png
+   // delivery
+   if (vectorPlotsEnabled())
+   {
+      ShadowDeviceData* pDevData = (ShadowDeviceData*)pDC->pDeviceSpecific;
+      if (pDevData != nullptr && !pDevData->rasterOnPage)
+         writeToSVG(targetPath, pDC);
+   }
+
    // turn the shadow device off to write the file
    shadowDevOff(pDC);
 
-   // if the targetPath != the bitmap path then copy it
+   // if the targetPath != the bitmap path then move it into place (a
+   // rename when both live on the same volume, so the encoded image
+   // isn't read and rewritten)
    Error error;
    if (targetPath != pDC->targetPath)
    {
@@ -359,11 +419,7 @@ Error writeToPNG(const FilePath& targetPath, DeviceContext* pDC)
       }
       else
       {
-         error = pDC->targetPath.copy(targetPath);
-
-         Error deleteError = pDC->targetPath.remove();
-         if (deleteError)
-            LOG_ERROR(error);
+         error = pDC->targetPath.move(targetPath);
       }
    }
 
@@ -383,8 +439,13 @@ Error writeToPNG(const FilePath& targetPath, DeviceContext* pDC)
    // now update the device structure
    handler::setSize(dev);
 
-   // replay the rstudio graphics device context onto the png
-   shadowDevSync(pDC);
+   // defer replaying the display list onto the new shadow device until
+   // just before the next R execution (see onBeforeExecute); consecutive
+   // renders with no drawing in between (e.g. while plots are browsed or
+   // resized) would otherwise each replay the full display list
+   ShadowDeviceData* pShadowDevData = (ShadowDeviceData*)pDC->pDeviceSpecific;
+   if (pShadowDevData != nullptr)
+      pShadowDevData->syncPending = true;
 
    // return status
    return error;
@@ -488,7 +549,13 @@ void raster(unsigned int *raster,
    pDevDesc pngDevDesc = shadowDevDesc(dd);
    if (pngDevDesc == nullptr)
       return;
-   
+
+   // note the raster so this page is delivered as png rather than svg
+   DeviceContext* pDC = (DeviceContext*)dd->deviceSpecific;
+   ShadowDeviceData* pDevData = (ShadowDeviceData*)pDC->pDeviceSpecific;
+   if (pDevData != nullptr)
+      pDevData->rasterOnPage = true;
+
    dev_desc::raster(raster,
                     w,
                     h,
@@ -563,7 +630,13 @@ void newPage(const pGEcontext gc, pDevDesc dev)
    pDevDesc pngDevDesc = shadowDevDesc(dev);
    if (pngDevDesc == nullptr)
       return;
-   
+
+   // a new page starts with no rasters drawn
+   DeviceContext* pDC = (DeviceContext*)dev->deviceSpecific;
+   ShadowDeviceData* pDevData = (ShadowDeviceData*)pDC->pDeviceSpecific;
+   if (pDevData != nullptr)
+      pDevData->rasterOnPage = false;
+
    dev_desc::newPage(gc, pngDevDesc);
 }
 
@@ -592,6 +665,12 @@ void onBeforeExecute(DeviceContext* pDC)
          selectDevice(ndevNumber(pDC->dev));
       }
    }
+
+   // perform any replay deferred by writeToPNG -- drawing primitives only
+   // occur during R execution so the new shadow device needs to be brought
+   // up to date before we hand control back to R
+   if (pShadowDevData != nullptr && pShadowDevData->syncPending)
+      shadowDevSync(pDC);
 }
 
 } // namespace shadow
@@ -0,0 +1,371 @@
+/*
+ * ServerAdmissionControl.cpp
+ *
+ * Copyright (C) 2020 by RStudio, PBC
+ *
+ * Unless you have received this program directly from RStudio pursuant
+ * to the terms of a commercial license agreement with RStudio, then
+ * this program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ *
+ */
+
+#include <server/ServerAdmissionControl.hpp>
+
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <boost/bind.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/asio/deadline_timer.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include <core/Log.hpp>
+#include <core/StringUtils.hpp>
+#include <core/Thread.hpp>
+#include <core/http/Request.hpp>
+#include <core/http/Response.hpp>
+#include <core/system/Environment.hpp>
+
+#include <shared_core/SafeConvert.hpp>
+
+#include <server/auth/ServerAuthHandler.hpp>
+
+using namespace rstudio::core;
+
+namespace rstudio {
+namespace server {
+namespace admission_control {
+
+namespace {
+
+// how often queued requests are re-examined for release
+const long kPumpIntervalMs = 100;
+
+// per-user buckets idle for this long are discarded
+const long kIdleBucketSeconds = 60;
+
+bool enabled()
+{
+   static bool s_enabled =
+         core::system::getenv("RSTUDIO_ADMISSION_CONTROL") != "0";
+   return s_enabled;
+}
+
+// unauthenticated requests are keyed by X-Forwarded-For only when the
+// administrator has told us a reverse proxy fronts the server (where
+// the peer address is the proxy's own); a direct client could forge
+// the header to dodge throttling or redirect it onto another client
+bool behindProxy()
+{
+   static bool s_behindProxy =
+         core::system::getenv("RSTUDIO_ADMISSION_BEHIND_PROXY") == "1";
+   return s_behindProxy;
+}
+
+// steady-state requests per second allowed per user; generous enough
+// that interactive use (including busy multi-tab sessions) never queues
+double tokensPerSecond()
+{
+   static double s_rate = std::max(1.0, safe_convert::stringTo<double>(
+         core::system::getenv("RSTUDIO_ADMISSION_TOKENS_PER_SECOND"), 20.0));
+   return s_rate;
+}
+
+// burst allowance per user (bucket capacity)
+double bucketCapacity()
+{
+   static double s_capacity = std::max(1.0, safe_convert::stringTo<double>(
+         core::system::getenv("RSTUDIO_ADMISSION_BURST"), 60.0));
+   return s_capacity;
+}
+
+// beyond these queue depths we fail fast with a 503 rather than
+// accumulating work we can't keep up with
+const std::size_t kMaxQueuedPerUser = 50;
+const std::size_t kMaxQueuedTotal = 500;
+
+struct TokenBucket
+{
+   TokenBucket(double tokens, boost::posix_time::ptime now)
+      : tokens(tokens),
+        lastRefill(now),
+        lastActive(now)
+   {
+   }
+
+   double tokens;
+   boost::posix_time::ptime lastRefill;
+   boost::posix_time::ptime lastActive;
+   std::deque<http::RequestFilterContinuation> queue;
+};
+
+// all state guarded by s_mutex; continuations are always invoked with
+// the mutex released (they resume request parsing)
+boost::mutex s_mutex;
+std::map<std::string, boost::shared_ptr<TokenBucket> > s_buckets;
+std::size_t s_totalQueued = 0;
+
+// round-robin cursor for fair dequeuing (key of the user served last)
+std::string s_cursor;
+
+// timer which pumps the queues while any requests are waiting
+boost::shared_ptr<boost::asio::deadline_timer> s_pPumpTimer;
+bool s_pumpScheduled = false;
+
+// when idle buckets were last discarded (filterRequest prunes
+// periodically because the pump only runs while requests are queued)
+boost::posix_time::ptime s_lastPrune;
+
+void refillBucket(boost::shared_ptr<TokenBucket> pBucket,
+                  const boost::posix_time::ptime& now)
+{
+   double elapsedSeconds =
+         (now - pBucket->lastRefill).total_milliseconds() / 1000.0;
+   if (elapsedSeconds > 0)
+   {
+      pBucket->tokens = std::min(bucketCapacity(),
+                                 pBucket->tokens +
+                                    elapsedSeconds * tokensPerSecond());
+      pBucket->lastRefill = now;
+   }
+}
+
+// discard buckets with no queued work and no recent activity; must be
+// called under s_mutex
+void pruneIdleBuckets(const boost::posix_time::ptime& now)
+{
+   s_lastPrune = now;
+   for (std::map<std::string, boost::shared_ptr<TokenBucket> >::iterator
+           it = s_buckets.begin();
+        it != s_buckets.end();
+        )
+   {
+      if (it->second->queue.empty() &&
+          (now - it->second->lastActive).total_seconds() >=
+             kIdleBucketSeconds)
+      {
+         s_buckets.erase(it++);
+      }
+      else
+      {
+         ++it;
+      }
+   }
+}
+
+void pumpQueues(const boost::system::error_code& ec);
+
+// must be called under s_mutex
+void schedulePump(boost::asio::io_service& ioService)
+{
+   if (s_pumpScheduled)
+      return;
+
+   if (!s_pPumpTimer)
+      s_pPumpTimer.reset(new boost::asio::deadline_timer(ioService));
+
+   s_pPumpTimer->expires_from_now(
+         boost::posix_time::milliseconds(kPumpIntervalMs));
+   s_pPumpTimer->async_wait(boost::bind(pumpQueues, _1));
+   s_pumpScheduled = true;
+}
+
+void pumpQueues(const boost::system::error_code& ec)
+{
+   if (ec)
+      return;
+
+   std::vector<http::RequestFilterContinuation> released;
+   LOCK_MUTEX(s_mutex)
+   {
+      s_pumpScheduled = false;
+
+      boost::posix_time::ptime now =
+            boost::posix_time::microsec_clock::universal_time();
+
+      // refill all buckets and discard those with no queue and no
+      // recent activity
+      for (std::map<std::string, boost::shared_ptr<TokenBucket> >::iterator
+              it = s_buckets.begin();
+           it != s_buckets.end();
+           ++it)
+      {
+         refillBucket(it->second, now);
+      }
+      pruneIdleBuckets(now);
+
+      // release queued requests round-robin across users, one per user
+      // per pass, until no bucket can make further progress
+      bool progress = true;
+      while (progress && s_totalQueued > 0)
+      {
+         progress = false;
+
+         // start the pass just after the last user served
+         std::map<std::string, boost::shared_ptr<TokenBucket> >::iterator
+               start = s_buckets.upper_bound(s_cursor);
+         std::size_t numBuckets = s_buckets.size();
+         std::map<std::string, boost::shared_ptr<TokenBucket> >::iterator
+               it = start;
+         for (std::size_t i = 0; i < numBuckets; i++)
+         {
+            if (it == s_buckets.end())
+               it = s_buckets.begin();
+
+            boost::shared_ptr<TokenBucket> pBucket = it->second;
+            if (!pBucket->queue.empty() && pBucket->tokens >= 1.0)
+            {
+               pBucket->tokens -= 1.0;
+               released.push_back(pBucket->queue.front());
+               pBucket->queue.pop_front();
+               s_totalQueued--;
+               s_cursor = it->first;
+               progress = true;
+            }
+
+            ++it;
+         }
+      }
+
+      // keep pumping while requests remain queued
+      if (s_totalQueued > 0 && s_pPumpTimer)
+      {
+         s_pPumpTimer->expires_from_now(
+               boost::posix_time::milliseconds(kPumpIntervalMs));
+         s_pPumpTimer->async_wait(boost::bind(pumpQueues, _1));
+         s_pumpScheduled = true;
+      }
+   }
+   END_LOCK_MUTEX
+
+   // resume released requests outside the mutex
+   for (std::size_t i = 0; i < released.size(); i++)
+      released[i](boost::shared_ptr<http::Response>());
+}
+
+std::string bucketKeyFor(const http::Request& request)
+{
+   // prefer the authenticated identity so throttling follows the user
+   // rather than the address of a shared proxy
+   std::string key = auth::handler::getUserIdentifier(request, false);
+   if (!key.empty())
+      return key;
+
+   // unauthenticated requests (e.g. sign-in) are keyed by client
+   // address so one client in a retry loop can't consume the sign-in
+   // capacity of every other user. the forwarded header is only
+   // trusted behind a configured proxy
+   if (behindProxy())
+   {
+      key = request.headerValue("X-Forwarded-For");
+
+      // the header can carry a proxy chain; the first element is the
+      // originating client
+      std::string::size_type comma = key.find(',');
+      if (comma != std::string::npos)
+         key = key.substr(0, comma);
+      key = string_utils::trimWhitespace(key);
+      if (!key.empty())
+         return key;
+   }
+
+   key = request.remoteAddress();
+   if (!key.empty())
+      return key;
+
+   return "anonymous";
+}
+
+boost::shared_ptr<http::Response> rejectResponse(std::size_t queuedAhead)
+{
+   boost::shared_ptr<http::Response> pResponse =
+         boost::make_shared<http::Response>();
+   pResponse->setStatusCode(http::status::ServiceUnavailable);
+
+   // advise the client when capacity is likely to be available again
+   long retrySeconds = std::max(
+         1L, static_cast<long>(queuedAhead / tokensPerSecond()) + 1);
+   pResponse->setHeader("Retry-After", safe_convert::numberToString(
+         retrySeconds));
+   return pResponse;
+}
+
+} // anonymous namespace
+
+void filterRequest(boost::asio::io_service& ioService,
+                   http::Request* pRequest,
+                   http::RequestFilterContinuation continuation)
+{
+   if (!enabled())
+   {
+      continuation(boost::shared_ptr<http::Response>());
+      return;
+   }
+
+   std::string key = bucketKeyFor(*pRequest);
+
+   boost::shared_ptr<http::Response> pRejection;
+   bool admitted = false;
+   LOCK_MUTEX(s_mutex)
+   {
+      boost::posix_time::ptime now =
+            boost::posix_time::microsec_clock::universal_time();
+
+      boost::shared_ptr<TokenBucket>& pBucket = s_buckets[key];
+      if (!pBucket)
+         pBucket.reset(new TokenBucket(bucketCapacity(), now));
+
+      refillBucket(pBucket, now);
+      pBucket->lastActive = now;
+
+      if (pBucket->queue.empty() && pBucket->tokens >= 1.0)
+      {
+         // token available and nothing waiting ahead of us -- admit
+         pBucket->tokens -= 1.0;
+         admitted = true;
+      }
+      else if (pBucket->queue.size() >= kMaxQueuedPerUser ||
+               s_totalQueued >= kMaxQueuedTotal)
+      {
+         // over the queue limits -- fail fast rather than buffering
+         // unbounded work for a client in a retry loop
+         pRejection = rejectResponse(pBucket->queue.size());
+      }
+      else
+      {
+         // briefly queue; the pump releases requests fairly across
+         // users as tokens refill
+         pBucket->queue.push_back(continuation);
+         s_totalQueued++;
+         schedulePump(ioService);
+      }
+
+      // prune idle buckets opportunistically: the pump (which also
+      // prunes) runs only while requests are queued, so on a server
+      // that never exceeds the rate the bucket map would otherwise
+      // grow by one entry per distinct key forever
+      if (s_lastPrune.is_not_a_date_time() ||
+          (now - s_lastPrune).total_seconds() >= kIdleBucketSeconds)
+      {
+         pruneIdleBuckets(now);
+      }
+   }
+   END_LOCK_MUTEX
+
+   if (admitted)
+      continuation(boost::shared_ptr<http::Response>());
+   else if (pRejection)
+      continuation(pRejection);
+}
+
+} // namespace admission_control
+} // namespace server
+} // namespace rstudio
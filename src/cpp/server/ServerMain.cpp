@@ -47,6 +47,7 @@
 #include <server/auth/ServerValidateUser.hpp>
 #include <server/auth/ServerSecureUriHandler.hpp>
 
+#include <server/ServerAdmissionControl.hpp>
 #include <server/ServerOptions.hpp>
 #include <server/ServerUriHandlers.hpp>
 #include <server/ServerScheduler.hpp>
@@ -205,7 +206,7 @@ void pageNotFoundHandler(const http::Request& request,
    pResponse->setStatusCode(core::http::status::NotFound);
 }
 
-void rootPathRequestFilter(
+void mainRequestFilter(
             boost::asio::io_service& ioService,
             http::Request* pRequest,
             http::RequestFilterContinuation continuation)
@@ -213,8 +214,12 @@ void rootPathRequestFilter(
    // for all requests, be sure to inject the configured root path
    // this way proxied requests will redirect correctly and cookies
    // will have the correct path
-   pRequest->setRootPath(options().wwwRootPath());
-   continuation(boost::shared_ptr<http::Response>());
+   if (options().wwwRootPath() != kRequestDefaultRootPath)
+      pRequest->setRootPath(options().wwwRootPath());
+
+   // apply per-user admission control (the filter invokes the
+   // continuation, either immediately or once capacity is available)
+   admission_control::filterRequest(ioService, pRequest, continuation);
 }
 
 void httpServerAddHandlers()
@@ -396,6 +401,9 @@ Error waitForSignals()
          // call overlay shutdown
          overlay::shutdown();
 
+         // drain any queued log entries before we terminate
+         core::log::setAsyncLogging(false);
+
          // clear the signal mask
          Error error = core::system::clearSignalMask();
          if (error)
@@ -444,6 +452,12 @@ void add(const std::string& prefix,
    s_pHttpServer->addHandler(prefix, handler);
 }
 
+void addBulk(const std::string& prefix,
+             const http::AsyncUriHandlerFunction& handler)
+{
+   s_pHttpServer->addBulkHandler(prefix, handler);
+}
+
 void addUploadHandler(const std::string& prefix,
          const http::AsyncUriUploadHandlerFunction& handler)
 {
@@ -670,20 +684,25 @@ int main(int argc, char * const argv[])
                                        server::options().monitorSharedSecret(),
                                        s_pHttpServer->ioService());
 
+      // give the session proxy an io service for sign-in time pre-warm
+      // launches (also needs the http server's io service)
+      session_proxy::setSessionPrewarmIoService(s_pHttpServer->ioService());
+
       if (!options.verifyInstallation())
       {
          // add a monitor log writer
          core::log::addLogDestination(
             monitor::client().createLogDestination(core::log::LogLevel::WARN, kProgramIdentity));
-      }
 
-      // overlay may replace this
-      if (server::options().wwwRootPath() != kRequestDefaultRootPath) 
-      {
-         // inject the path prefix as the root path for all requests
-         uri_handlers::setRequestFilter(rootPathRequestFilter);
+         // move log writes off the server's request-handling threads (must
+         // happen after daemonizing since it starts a thread)
+         core::log::setAsyncLogging(true);
       }
 
+      // overlay may replace this; the filter injects the configured root
+      // path (when set) and applies per-user admission control
+      uri_handlers::setRequestFilter(mainRequestFilter);
+
       // call overlay initialize
       error = overlay::initialize();
       if (error)
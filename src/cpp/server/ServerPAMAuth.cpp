@@ -15,15 +15,25 @@
 #include "ServerPAMAuth.hpp"
 #include "ServerPAMAuthOverlay.hpp"
 
+#include <map>
+
+#include <boost/bind.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/shared_ptr.hpp>
+
 #include <core/Thread.hpp>
 #include <core/system/Process.hpp>
 #include <core/FileSerializer.hpp>
 #include <core/system/Crypto.hpp>
+#include <core/system/Environment.hpp>
 #include <core/system/PosixSystem.hpp>
 #include <core/system/PosixUser.hpp>
 
+#include <core/http/AsyncConnection.hpp>
 #include <core/http/URL.hpp>
 
+#include <shared_core/SafeConvert.hpp>
+
 #include <shared_core/Error.hpp>
 
 #include <server/ServerOptions.hpp>
@@ -137,18 +147,189 @@ void publicKey(const http::Request&,
    pResponse->setContentType("text/plain");
 }
 
-void doSignIn(const http::Request& request,
-              http::Response* pResponse)
+// PAM conversations block for the duration of the underlying auth stack
+// (seconds against an LDAP-backed stack), so they run on a dedicated pool
+// of worker threads rather than on the server's http threads -- a burst
+// of logins then queues here instead of starving proxy traffic
+core::thread::ThreadPool& pamWorkerPool()
+{
+   static core::thread::ThreadPool instance(4);
+   return instance;
+}
+
+// number of pre-computed sign-in keypairs kept staged; rotating to a
+// fresh keypair after each sign-in limits the exposure of any single
+// private key, and pre-computing means generation (tens of milliseconds)
+// never runs on the login critical path
+const std::size_t kRsaKeyPoolSize = 4;
+
+void replenishRsaKeyPool()
+{
+   Error error = core::system::crypto::rsaPrecomputeKeys(kRsaKeyPoolSize);
+   if (error)
+      LOG_ERROR(error);
+}
+
+// short-TTL cache of successful authentications, keyed by an HMAC of the
+// credentials under a per-process random key (raw credentials are never
+// stored). re-auth flows within the TTL skip the PAM conversation
+// entirely. disabled unless RSTUDIO_PAM_AUTH_CACHE_SECONDS is set, since
+// it defers revocation of changed passwords by up to the TTL
+int authCacheSeconds()
+{
+   static int seconds = safe_convert::stringTo<int>(
+            core::system::getenv("RSTUDIO_PAM_AUTH_CACHE_SECONDS"), 0);
+   return seconds;
+}
+
+boost::mutex s_authCacheMutex;
+std::map<std::string, boost::posix_time::ptime> s_authCache;
+
+std::string credentialHash(const std::string& username,
+                           const std::string& password)
+{
+   // per-process random key -- cache entries don't survive a restart
+   // and hashes can't be precomputed offline (initialization is
+   // thread-safe per C++11 static local semantics)
+   static std::vector<unsigned char> s_cacheKey = []()
+   {
+      std::vector<unsigned char> key;
+      Error error = core::system::crypto::random(32, key);
+      if (error)
+         LOG_ERROR(error);
+      return key;
+   }();
+
+   if (s_cacheKey.empty())
+      return std::string();
+
+   std::vector<unsigned char> hmac;
+   Error error = core::system::crypto::HMAC_SHA2(username + "\n" + password,
+                                                 s_cacheKey,
+                                                 &hmac);
+   if (error)
+   {
+      LOG_ERROR(error);
+      return std::string();
+   }
+
+   return std::string(hmac.begin(), hmac.end());
+}
+
+bool checkAuthCache(const std::string& username, const std::string& password)
+{
+   if (authCacheSeconds() <= 0)
+      return false;
+
+   std::string hash = credentialHash(username, password);
+   if (hash.empty())
+      return false;
+
+   LOCK_MUTEX(s_authCacheMutex)
+   {
+      std::map<std::string, boost::posix_time::ptime>::iterator it =
+                                                      s_authCache.find(hash);
+      if (it != s_authCache.end())
+      {
+         if (boost::posix_time::microsec_clock::universal_time() < it->second)
+            return true;
+
+         s_authCache.erase(it);
+      }
+   }
+   END_LOCK_MUTEX
+
+   return false;
+}
+
+void noteAuthSuccess(const std::string& username, const std::string& password)
 {
+   if (authCacheSeconds() <= 0)
+      return;
+
+   std::string hash = credentialHash(username, password);
+   if (hash.empty())
+      return;
+
+   boost::posix_time::ptime now =
+                        boost::posix_time::microsec_clock::universal_time();
+
+   LOCK_MUTEX(s_authCacheMutex)
+   {
+      // opportunistically drop expired entries so the cache stays bounded
+      // by the number of distinct logins within the TTL
+      for (std::map<std::string, boost::posix_time::ptime>::iterator
+              it = s_authCache.begin(); it != s_authCache.end(); )
+      {
+         if (it->second <= now)
+            s_authCache.erase(it++);
+         else
+            ++it;
+      }
+
+      s_authCache[hash] = now +
+                          boost::posix_time::seconds(authCacheSeconds());
+   }
+   END_LOCK_MUTEX
+}
+
+// credentials and context parsed from the sign-in form, carried across
+// the handoff to the PAM worker pool
+struct SignInRequest
+{
+   std::string appUri;
+   std::string username;
+   std::string password;
+   bool persist = false;
+};
+
+void completeSignIn(boost::shared_ptr<http::AsyncConnection> pConnection,
+                    boost::shared_ptr<SignInRequest> pSignIn,
+                    bool authenticated)
+{
+   http::Response* pResponse = &pConnection->response();
+   if (auth::common::doSignIn(pConnection->request(),
+                              pResponse,
+                              pSignIn->username,
+                              pSignIn->appUri,
+                              pSignIn->persist,
+                              authenticated))
+   {
+      overlay::onUserPasswordAvailable(pSignIn->username, pSignIn->password);
+   }
+   pConnection->writeResponse();
+}
+
+void pamConversation(boost::shared_ptr<http::AsyncConnection> pConnection,
+                     boost::shared_ptr<SignInRequest> pSignIn)
+{
+   bool authenticated = pamLogin(pSignIn->username, pSignIn->password);
+   if (authenticated)
+      noteAuthSuccess(pSignIn->username, pSignIn->password);
+
+   // complete on the connection's io thread (the response object and
+   // socket aren't safe to touch from a worker thread)
+   pConnection->ioService().post(boost::bind(completeSignIn,
+                                             pConnection,
+                                             pSignIn,
+                                             authenticated));
+}
+
+void doSignIn(boost::shared_ptr<http::AsyncConnection> pConnection)
+{
+   const http::Request& request = pConnection->request();
+   http::Response* pResponse = &pConnection->response();
+
    std::string appUri = request.formFieldValue(kAppUri);
    if (!auth::common::validateSignIn(request, pResponse))
    {
       redirectToLoginPage(request, pResponse, kAppUri, kErrorServer);
+      pConnection->writeResponse();
       return;
    }
 
-   bool persist = false;
-   std::string username, password;
+   boost::shared_ptr<SignInRequest> pSignIn(new SignInRequest());
+   pSignIn->appUri = appUri;
 
    if (server::options().authEncryptPassword())
    {
@@ -160,6 +341,7 @@ void doSignIn(const http::Request& request,
       {
          LOG_ERROR(error);
          redirectToLoginPage(request, pResponse, appUri, kErrorServer);
+         pConnection->writeResponse();
          return;
       }
 
@@ -168,36 +350,42 @@ void doSignIn(const http::Request& request,
       {
          LOG_ERROR_MESSAGE("Didn't find newline in plaintext");
          redirectToLoginPage(request, pResponse, appUri, kErrorServer);
+         pConnection->writeResponse();
          return;
       }
 
-      persist = request.formFieldValue("persist") == "1";
-      username = plainText.substr(0, splitAt);
-      password = plainText.substr(splitAt + 1, plainText.size());
+      pSignIn->persist = request.formFieldValue("persist") == "1";
+      pSignIn->username = plainText.substr(0, splitAt);
+      pSignIn->password = plainText.substr(splitAt + 1, plainText.size());
+
+      // swap in a pre-computed keypair (a pointer exchange) so the next
+      // sign-in form gets its own key, and top the pool back up off the
+      // request path
+      core::system::crypto::rsaRotateKey();
+      pamWorkerPool().enque(boost::bind(replenishRsaKeyPool));
    }
    else
    {
-      persist = request.formFieldValue("staySignedIn") == "1";
-      username = request.formFieldValue("username");
-      password = request.formFieldValue("password");
+      pSignIn->persist = request.formFieldValue("staySignedIn") == "1";
+      pSignIn->username = request.formFieldValue("username");
+      pSignIn->password = request.formFieldValue("password");
    }
 
    // tranform to local username
-   username = auth::handler::userIdentifierToLocalUsername(username);
+   pSignIn->username =
+         auth::handler::userIdentifierToLocalUsername(pSignIn->username);
 
-   overlay::onUserPasswordUnavailable(username);
+   overlay::onUserPasswordUnavailable(pSignIn->username);
 
-   bool authenticated = pamLogin(username, password);
-   if (!auth::common::doSignIn(request,
-                               pResponse,
-                               username,
-                               appUri,
-                               persist,
-                               authenticated))
+   // serve recent re-auths from the cache without a PAM conversation
+   if (checkAuthCache(pSignIn->username, pSignIn->password))
    {
+      completeSignIn(pConnection, pSignIn, true);
       return;
    }
-   overlay::onUserPasswordAvailable(username, password);
+
+   // hand the blocking PAM conversation to the worker pool
+   pamWorkerPool().enque(boost::bind(pamConversation, pConnection, pSignIn));
 }
 
 void signOut(const http::Request& request,
@@ -273,8 +461,9 @@ Error initialize()
       pamHandler.setSignInCookies = boost::bind(auth::common::setSignInCookies, _1, _2, _3, _4);
    auth::handler::registerHandler(pamHandler);
 
-   // add pam-specific auth handlers
-   uri_handlers::addBlocking(kDoSignIn, doSignIn);
+   // add pam-specific auth handlers (sign-in is async so the blocking
+   // PAM conversation runs on the dedicated worker pool)
+   uri_handlers::add(kDoSignIn, doSignIn);
    uri_handlers::addBlocking(kPublicKey, publicKey);
 
    // initialize overlay
@@ -283,7 +472,14 @@ Error initialize()
       return error;
 
    // initialize crypto
-   return core::system::crypto::rsaInit();
+   error = core::system::crypto::rsaInit();
+   if (error)
+      return error;
+
+   // stage the sign-in keypair pool in the background
+   pamWorkerPool().enque(boost::bind(replenishRsaKeyPool));
+
+   return Success();
 }
 
 } // namespace pam_auth
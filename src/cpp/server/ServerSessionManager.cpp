@@ -20,6 +20,7 @@
 #include <boost/format.hpp>
 
 #include <shared_core/SafeConvert.hpp>
+#include <core/FileSerializer.hpp>
 #include <core/system/PosixUser.hpp>
 #include <core/system/Environment.hpp>
 #include <core/json/JsonRpc.hpp>
@@ -273,6 +274,17 @@ Error SessionManager::launchSession(boost::asio::io_service& ioService,
       f(&profile);
    }
 
+   // consult the placement engine and forward its decision to the launch
+   // function (custom launchers for multi-host deployments honor it; the
+   // default local launcher ignores it)
+   std::string placementHost = placement::placeSession(context);
+   if (!placementHost.empty())
+   {
+      core::system::setenv(&profile.config.environment,
+                           kSessionPlacementHostEnvVar,
+                           placementHost);
+   }
+
    // launch the session
    Error error = sessionLaunchFunction_(ioService, profile, request, onLaunch, onError);
    if (error)
@@ -301,6 +313,168 @@ void setProcessConfigFilter(const core::system::ProcessConfigFilter& filter)
    END_LOCK_MUTEX
 }
 
+namespace placement {
+
+namespace {
+
+boost::mutex s_placementMutex;
+HostLoadSupplier s_hostLoadSupplier;
+PlacementFunction s_placementFunction;
+
+// default supplier: a single sample describing the local host
+Error localHostLoad(std::vector<HostLoadSample>* pSamples)
+{
+   core::system::SysInfo sysInfo;
+   Error error = core::system::systemInformation(&sysInfo);
+   if (error)
+      return error;
+
+   HostLoadSample sample;
+   sample.cores = sysInfo.cores;
+   sample.load1 = sysInfo.load1;
+   sample.load5 = sysInfo.load5;
+   sample.load15 = sysInfo.load15;
+   pSamples->push_back(sample);
+   return Success();
+}
+
+// default engine: lowest one-minute load average per core wins, with the
+// local host preferred on ties (strict comparison visits it first)
+std::string leastLoadedHost(const r_util::SessionContext&,
+                            const std::vector<HostLoadSample>& samples)
+{
+   std::string host;
+   double bestLoad = -1;
+   for (const HostLoadSample& sample : samples)
+   {
+      unsigned int cores = std::max(sample.cores, 1U);
+      double load = sample.load1 / cores;
+      if (bestLoad < 0 || load < bestLoad)
+      {
+         bestLoad = load;
+         host = sample.host;
+      }
+   }
+   return host;
+}
+
+} // anonymous namespace
+
+void setHostLoadSupplier(const HostLoadSupplier& supplier)
+{
+   LOCK_MUTEX(s_placementMutex)
+   {
+      s_hostLoadSupplier = supplier;
+   }
+   END_LOCK_MUTEX
+}
+
+void setPlacementFunction(const PlacementFunction& placementFunction)
+{
+   LOCK_MUTEX(s_placementMutex)
+   {
+      s_placementFunction = placementFunction;
+   }
+   END_LOCK_MUTEX
+}
+
+std::string placeSession(const r_util::SessionContext& context)
+{
+   HostLoadSupplier supplier;
+   PlacementFunction placementFunction;
+   LOCK_MUTEX(s_placementMutex)
+   {
+      supplier = s_hostLoadSupplier;
+      placementFunction = s_placementFunction;
+   }
+   END_LOCK_MUTEX
+
+   if (!supplier)
+      supplier = localHostLoad;
+   if (!placementFunction)
+      placementFunction = leastLoadedHost;
+
+   // collect load samples; on failure fall back to the local host rather
+   // than refusing to launch (placement is advisory, not load shedding)
+   std::vector<HostLoadSample> samples;
+   Error error = supplier(&samples);
+   if (error)
+   {
+      LOG_ERROR(error);
+      return std::string();
+   }
+   if (samples.empty())
+      return std::string();
+
+   return placementFunction(context, samples);
+}
+
+} // namespace placement
+
+namespace {
+
+// root of the cgroup v2 hierarchy under which per-session groups are
+// created (one group per session so limits can be adjusted independently)
+const char* const kSessionCgroupRoot = "/sys/fs/cgroup/rstudio-sessions";
+
+Error writeCgroupValue(const FilePath& cgroupPath,
+                       const std::string& file,
+                       const std::string& value)
+{
+   return core::writeStringToFile(cgroupPath.completeChildPath(file),
+                                  value + "\n");
+}
+
+} // anonymous namespace
+
+Error applySessionResourceLimits(PidType pid,
+                                 int cpuWeight,
+                                 int memoryHighMb,
+                                 int memoryMaxMb)
+{
+   // nothing to do when the governor isn't configured
+   if (cpuWeight <= 0 && memoryHighMb <= 0 && memoryMaxMb <= 0)
+      return Success();
+
+   // create the per-session group
+   FilePath cgroupPath = FilePath(kSessionCgroupRoot).completeChildPath(
+            "session-" + safe_convert::numberToString(pid));
+   Error error = cgroupPath.ensureDirectory();
+   if (error)
+      return error;
+
+   // apply cpu shares and memory watermarks before admitting the process
+   // so the limits cover its entire lifetime
+   if (cpuWeight > 0)
+   {
+      error = writeCgroupValue(cgroupPath, "cpu.weight",
+                               safe_convert::numberToString(cpuWeight));
+      if (error)
+         return error;
+   }
+   if (memoryHighMb > 0)
+   {
+      error = writeCgroupValue(
+               cgroupPath, "memory.high",
+               safe_convert::numberToString(
+                     static_cast<int64_t>(memoryHighMb) * 1024 * 1024));
+      if (error)
+         return error;
+   }
+   if (memoryMaxMb > 0)
+   {
+      error = writeCgroupValue(
+               cgroupPath, "memory.max",
+               safe_convert::numberToString(
+                     static_cast<int64_t>(memoryMaxMb) * 1024 * 1024));
+      if (error)
+         return error;
+   }
+
+   return writeCgroupValue(cgroupPath, "cgroup.procs",
+                           safe_convert::numberToString(pid));
+}
+
 // default session launcher -- does the launch then tracks the pid
 // for later reaping
 Error SessionManager::launchAndTrackSession(
@@ -328,6 +502,16 @@ Error SessionManager::launchAndTrackSession(
    if (error)
       return error;
 
+   // apply resource governor limits if configured (non-fatal: a session
+   // without cgroup limits beats no session at all)
+   server::Options& options = server::options();
+   error = applySessionResourceLimits(pid,
+                                      options.rsessionCpuWeight(),
+                                      options.rsessionMemoryHighMb(),
+                                      options.rsessionMemoryMaxMb());
+   if (error)
+      LOG_ERROR(error);
+
    // track it for subsequent reaping
    processTracker_.addProcess(pid, boost::bind(onProcessExit,
                                                profile.context.username,
@@ -163,6 +163,17 @@ ProxyFilter s_proxyFilter;
 
 ProxyRequestFilter s_proxyRequestFilter;
 
+// pool of idle keep-alive connections to session stream sockets, keyed
+// by stream path (i.e. per-session). connections are adopted by the
+// next proxied request to the same session rather than reconnecting
+boost::shared_ptr<http::LocalStreamAsyncClient::StreamConnectionPool>&
+                                                   sessionConnectionPool()
+{
+   static boost::shared_ptr<http::LocalStreamAsyncClient::StreamConnectionPool>
+         instance(new http::LocalStreamAsyncClient::StreamConnectionPool());
+   return instance;
+}
+
 void invokeRequestFilter(http::Request* pRequest)
 {
    if (s_proxyRequestFilter)
@@ -295,8 +306,8 @@ void sendSparkUIResponse(
    boost::algorithm::replace_all(body,
                                  "<img src=\"/",
                                  "<img src=\"" + prefix + "/");
-   fixedResponse.setBody(body);
-   ptrConnection->writeResponse(fixedResponse);
+   fixedResponse.setBody(std::move(body));
+   ptrConnection->writeResponse(std::move(fixedResponse));
 }
 
 void handleLocalhostResponse(
@@ -359,7 +370,7 @@ void handleLocalhostResponse(
          }
 
          // write the copy
-         ptrConnection->writeResponse(redirectResponse);
+         ptrConnection->writeResponse(std::move(redirectResponse));
       }
       else
       {
@@ -684,9 +695,15 @@ void proxyRequest(
    // create client
    // if the user is available on the system pass in the uid for validation to ensure
    // that we only connect to the socket if it was created by the user
-   boost::shared_ptr<http::IAsyncClient> pClient(new http::LocalStreamAsyncClient(
-                                                    ptrConnection->ioService(),
-                                                    streamPath, false, validateUid));
+   boost::shared_ptr<http::LocalStreamAsyncClient> pStreamClient(
+      new http::LocalStreamAsyncClient(ptrConnection->ioService(),
+                                       streamPath, false, validateUid));
+
+   // reuse keep-alive connections to the session so steady-state proxy
+   // requests skip the per-request connect
+   pStreamClient->setConnectionPool(sessionConnectionPool());
+
+   boost::shared_ptr<http::IAsyncClient> pClient = pStreamClient;
 
    // setup retry context
    if (!connectionRetryProfile.empty())
@@ -766,8 +783,48 @@ http::Headers getAuthCookies(const http::Response& response)
    return authCookies;
 }
 
+namespace {
+
+// io service used for sign-in time session pre-warm (the sign-in handlers
+// run on blocking handler threads which have no io service of their own)
+boost::asio::io_service* s_pPrewarmIoService = nullptr;
+
+} // anonymous namespace
+
+void setSessionPrewarmIoService(boost::asio::io_service& ioService)
+{
+   s_pPrewarmIoService = &ioService;
+}
+
+void prewarmSession(const std::string& userIdentifier)
+{
+   if (!options().rsessionPrewarmOnSignin() || s_pPrewarmIoService == nullptr)
+      return;
+
+   std::string username =
+         auth::handler::userIdentifierToLocalUsername(userIdentifier);
+   if (username.empty())
+      return;
+
+   // skip the pre-warm if the user's default session is already listening
+   // (or at least launching) -- the proxy will connect to it directly
+   r_util::SessionContext context(username);
+   FilePath streamPath = server_core::sessions::local_streams::streamPath(
+                                       r_util::sessionContextFile(context));
+   if (streamPath.exists())
+      return;
+
+   // best effort: a failed pre-warm just means the session launches the
+   // usual way when the client requests it
+   Error error = sessionManager().launchSession(*s_pPrewarmIoService,
+                                                context,
+                                                http::Request());
+   if (error)
+      LOG_ERROR(error);
+}
+
 Error initialize()
-{ 
+{
    return server_core::sessions::local_streams::ensureStreamsDir();
 }
 
@@ -823,7 +880,7 @@ bool proxyUploadRequest(
       const std::string& username,
       const std::string& userIdentifier,
       boost::shared_ptr<core::http::AsyncConnection> ptrConnection,
-      const std::string& formData,
+      std::string& formData,
       bool complete)
 {
    // get session context
@@ -27,6 +27,7 @@
 
 #include <server/ServerConstants.hpp>
 #include <server/ServerOptions.hpp>
+#include <server/ServerSessionProxy.hpp>
 
 #include <monitor/MonitorClient.hpp>
 
@@ -215,6 +216,11 @@ bool doSignIn(const core::http::Request& request,
       appUri = "/" + appUri;
    }
    setSignInCookies(request, username, persist, pResponse);
+
+   // optionally begin launching the user's session now so R startup
+   // overlaps with the IDE loading in the browser
+   session_proxy::prewarmSession(username);
+
    pResponse->setMovedTemporarily(request, appUri);
    return true;
 }
@@ -122,7 +122,7 @@ public:
 
    // provide http::AsyncUriUploadHandlerFunction concept
    bool operator()(boost::shared_ptr<http::AsyncConnection> pConnection,
-                   const std::string& formData,
+                   std::string& formData,
                    bool keepGoing)
    {
       if (!getUser(pConnection))
@@ -141,19 +141,20 @@ private:
                         boost::shared_ptr<http::AsyncConnection> pConnection)
          : username_(username),
            userIdentifier_(userIdentifier),
-           pConnection_(pConnection)
+           pConnection_(pConnection),
+           pFormData_(nullptr)
       {
       }
 
       InvocationVisitor(const std::string& username,
                         const std::string& userIdentifier,
                         boost::shared_ptr<http::AsyncConnection> pConnection,
-                        const std::string& formData,
+                        std::string& formData,
                         bool keepGoing)
          : username_(username),
            userIdentifier_(userIdentifier),
            pConnection_(pConnection),
-           formData_(formData),
+           pFormData_(&formData),
            keepGoing_(keepGoing)
       {
       }
@@ -168,14 +169,17 @@ private:
 
       bool operator()(const SecureAsyncUriUploadHandlerFunctionEx& func) const
       {
-         return func(username_, userIdentifier_, pConnection_, formData_, keepGoing_);
+         return func(username_, userIdentifier_, pConnection_, *pFormData_, keepGoing_);
       }
 
    private:
       std::string username_;
       std::string userIdentifier_;
       boost::shared_ptr<http::AsyncConnection> pConnection_;
-      std::string formData_;
+
+      // points at the caller's form data buffer - upload handlers can take
+      // ownership of it rather than copying it
+      std::string* pFormData_;
       bool keepGoing_;
    };
 
@@ -214,7 +218,7 @@ private:
    bool invokeHandler(const std::string& username,
                       const std::string& userIdentifier,
                       boost::shared_ptr<http::AsyncConnection> pConnection,
-                      const std::string& formData,
+                      std::string& formData,
                       bool keepGoing)
    {
       return boost::apply_visitor(
@@ -5,6 +5,13 @@
  *
  */
 
+#include <cstring>
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <core/Compression.hpp>
 #include <core/CrashHandler.hpp>
 #include <core/system/Environment.hpp>
 #include <core/system/PosixSystem.hpp>
@@ -12,7 +19,57 @@
 using namespace rstudio::core;
 using namespace rstudio::core::system;
 
-void runCrashHandler(const char* argv[])
+FilePath databasePathFromArgs(int argc, const char* argv[])
+{
+   const char* const kDatabaseArg = "--database=";
+   for (int i = 1; i < argc; i++)
+   {
+      if (::strncmp(argv[i], kDatabaseArg, ::strlen(kDatabaseArg)) == 0)
+         return FilePath(argv[i] + ::strlen(kDatabaseArg));
+   }
+   return FilePath();
+}
+
+void compressCompletedDumps(const FilePath& databasePath)
+{
+   // crashpad leaves completed reports on disk at full minidump size;
+   // compress them (and remove the originals) so the database doesn't
+   // accumulate multi-hundred-MB raw dumps
+   if (databasePath.isEmpty())
+      return;
+
+   FilePath completedPath = databasePath.completeChildPath("completed");
+   if (!completedPath.exists())
+      return;
+
+   std::vector<FilePath> reports;
+   Error error = completedPath.getChildren(reports);
+   if (error)
+   {
+      LOG_ERROR(error);
+      return;
+   }
+
+   for (const FilePath& report : reports)
+   {
+      if (report.getExtensionLowerCase() != ".dmp")
+         continue;
+
+      FilePath compressedPath(report.getAbsolutePath() + ".gz");
+      error = compression::gzipCompressFile(report, compressedPath);
+      if (error)
+      {
+         LOG_ERROR(error);
+         continue;
+      }
+
+      error = report.remove();
+      if (error)
+         LOG_ERROR(error);
+   }
+}
+
+int runCrashHandler(int argc, const char* argv[])
 {
    FilePath exePath;
    Error error = executablePath(nullptr, &exePath);
@@ -30,11 +87,36 @@ void runCrashHandler(const char* argv[])
    const char* handlerExe = handlerPathStr.c_str();
    argv[0] = handlerExe;
 
-   ::execvp(handlerExe, const_cast<char* const*>(argv));
+   // run the crashpad handler as a child so we can post-process the
+   // database after it finishes (it inherits the client fds passed on
+   // our command line)
+   pid_t pid = ::fork();
+   if (pid == 0)
+   {
+      ::execvp(handlerExe, const_cast<char* const*>(argv));
+
+      // if we get here, we failed to run the crash handler
+      // log an error indicating why
+      LOG_ERROR(systemError(errno, ERROR_LOCATION));
+      ::_exit(EXIT_FAILURE);
+   }
+   else if (pid == -1)
+   {
+      LOG_ERROR(systemError(errno, ERROR_LOCATION));
+      return EXIT_FAILURE;
+   }
 
-   // if we get here, we failed to run the crash handler
-   // log an error indicating why
-   LOG_ERROR(systemError(errno, ERROR_LOCATION));
+   int status = 0;
+   while (::waitpid(pid, &status, 0) == -1 && errno == EINTR)
+   {
+   }
+
+   // the handler is done -- the crashing process is gone and any enabled
+   // uploads have been attempted -- so dump post-processing here adds no
+   // IO to anyone's critical path
+   compressCompletedDumps(databasePathFromArgs(argc, argv));
+
+   return WIFEXITED(status) ? WEXITSTATUS(status) : EXIT_FAILURE;
 }
 
 int main(int argc, const char* argv[])
@@ -58,8 +140,5 @@ int main(int argc, const char* argv[])
       }
    }
 
-   runCrashHandler(argv);
-
-   // if we get here, we failed to run the crash handler
-   return EXIT_FAILURE;
+   return runCrashHandler(argc, argv);
 }
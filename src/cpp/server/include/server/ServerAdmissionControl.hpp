@@ -0,0 +1,55 @@
+/*
+ * ServerAdmissionControl.hpp
+ *
+ * Copyright (C) 2020 by RStudio, PBC
+ *
+ * Unless you have received this program directly from RStudio pursuant
+ * to the terms of a commercial license agreement with RStudio, then
+ * this program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ *
+ */
+
+#ifndef SERVER_ADMISSION_CONTROL_HPP
+#define SERVER_ADMISSION_CONTROL_HPP
+
+#include <core/http/AsyncConnection.hpp>
+
+namespace rstudio {
+namespace core {
+namespace http {
+class Request;
+}
+}
+}
+
+namespace rstudio {
+namespace server {
+namespace admission_control {
+
+// request filter which applies per-user admission control. each user
+// (keyed by authenticated identity, falling back to forwarded client
+// address) draws from a token bucket; requests arriving with a token
+// available proceed immediately, requests arriving during a burst are
+// briefly queued and released fairly (round-robin across users) as
+// tokens refill, and requests beyond the queue limits receive an
+// immediate 503 with a Retry-After header. this keeps a single
+// misbehaving client (e.g. a browser reconnect loop) from monopolizing
+// the server's io threads.
+//
+// the defaults are generous enough that interactive use never queues;
+// they can be tuned via RSTUDIO_ADMISSION_TOKENS_PER_SECOND and
+// RSTUDIO_ADMISSION_BURST, and the filter can be disabled entirely by
+// setting RSTUDIO_ADMISSION_CONTROL=0
+void filterRequest(boost::asio::io_service& ioService,
+                   core::http::Request* pRequest,
+                   core::http::RequestFilterContinuation continuation);
+
+} // namespace admission_control
+} // namespace server
+} // namespace rstudio
+
+#endif // SERVER_ADMISSION_CONTROL_HPP
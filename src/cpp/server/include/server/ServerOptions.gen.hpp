@@ -155,6 +155,18 @@ protected:
       ("rsession-proxy-max-wait-secs",
       value<int>(&rsessionProxyMaxWaitSeconds_)->default_value(10),
       "The maximum time to wait in seconds for a successful response when proxying requests to rsession.")
+      ("rsession-prewarm-on-signin",
+      value<bool>(&rsessionPrewarmOnSignin_)->default_value(false),
+      "Whether to begin launching a user's rsession as soon as they sign in, so R initialization overlaps with the IDE loading in the browser.")
+      ("rsession-cpu-weight",
+      value<int>(&rsessionCpuWeight_)->default_value(0),
+      "The cgroup v2 cpu.weight (1-10000) assigned to each rsession process, or 0 to leave CPU shares unmanaged.")
+      ("rsession-memory-high-mb",
+      value<int>(&rsessionMemoryHighMb_)->default_value(0),
+      "The cgroup v2 memory.high soft watermark in MB applied to each rsession process (reclaim throttles the session before the hard limit is hit), or 0 for no soft watermark.")
+      ("rsession-memory-max-mb",
+      value<int>(&rsessionMemoryMaxMb_)->default_value(0),
+      "The cgroup v2 memory.max hard limit in MB applied to each rsession process, or 0 for no hard limit.")
       ("rsession-memory-limit-mb",
       value<int>(&deprecatedMemoryLimitMb_)->default_value(0),
       "The limit in MB that an rsession process may consume.")
@@ -259,6 +271,10 @@ public:
    std::string rsessionLdLibraryPath() const { return rsessionLdLibraryPath_; }
    std::string rsessionConfigFile() const { return rsessionConfigFile_; }
    int rsessionProxyMaxWaitSeconds() const { return rsessionProxyMaxWaitSeconds_; }
+   bool rsessionPrewarmOnSignin() const { return rsessionPrewarmOnSignin_; }
+   int rsessionCpuWeight() const { return rsessionCpuWeight_; }
+   int rsessionMemoryHighMb() const { return rsessionMemoryHighMb_; }
+   int rsessionMemoryMaxMb() const { return rsessionMemoryMaxMb_; }
    std::string databaseConfigFile() const { return databaseConfigFile_; }
    bool authNone() const { return authNone_; }
    bool authValidateUsers() const { return authValidateUsers_; }
@@ -307,6 +323,10 @@ protected:
    std::string rsessionLdLibraryPath_;
    std::string rsessionConfigFile_;
    int rsessionProxyMaxWaitSeconds_;
+   bool rsessionPrewarmOnSignin_;
+   int rsessionCpuWeight_;
+   int rsessionMemoryHighMb_;
+   int rsessionMemoryMaxMb_;
    int deprecatedMemoryLimitMb_;
    int deprecatedStackLimitMb_;
    int deprecatedUserProcessLimit_;
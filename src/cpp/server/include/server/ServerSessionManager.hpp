@@ -116,6 +116,60 @@ private:
 // set a process config filter
 void setProcessConfigFilter(const core::system::ProcessConfigFilter& filter);
 
+// environment variable used to communicate the placement decision to
+// custom session launch functions
+#define kSessionPlacementHostEnvVar "RSTUDIO_SESSION_PLACEMENT_HOST"
+
+namespace placement {
+
+// a point-in-time load sample for a host eligible for session placement
+struct HostLoadSample
+{
+   HostLoadSample()
+      : cores(0), load1(0), load5(0), load15(0), memoryPercentUsed(-1)
+   {
+   }
+
+   std::string host;          // empty identifies the local host
+   unsigned int cores;
+   double load1;
+   double load5;
+   double load15;
+   double memoryPercentUsed;  // -1 when unknown
+};
+
+// supplies load samples for all hosts eligible to run a new session (the
+// default supplier returns a single sample for the local host)
+typedef boost::function<core::Error(std::vector<HostLoadSample>*)>
+                                                      HostLoadSupplier;
+void setHostLoadSupplier(const HostLoadSupplier& supplier);
+
+// chooses a host from the supplied samples (the default engine picks the
+// host with the lowest per-core load average, preferring the local host
+// on ties)
+typedef boost::function<std::string(const core::r_util::SessionContext&,
+                                    const std::vector<HostLoadSample>&)>
+                                                      PlacementFunction;
+void setPlacementFunction(const PlacementFunction& placementFunction);
+
+// returns the host on which a new session for the given context should be
+// launched (empty for the local host); the decision is also forwarded to
+// the session launch function via kSessionPlacementHostEnvVar
+std::string placeSession(const core::r_util::SessionContext& context);
+
+} // namespace placement
+
+// Apply resource governor limits (cgroup v2 cpu.weight and memory
+// high/max watermarks) to a running session process. Applied at launch
+// from the rsession-cpu-weight / rsession-memory-high-mb /
+// rsession-memory-max-mb options; may also be called later to adjust a
+// running session's limits (cgroup writes take effect immediately).
+// Pass 0 for any limit to leave it unmanaged.
+core::Error applySessionResourceLimits(PidType pid,
+                                       int cpuWeight,
+                                       int memoryHighMb,
+                                       int memoryMaxMb);
+
 // Lower-level global functions for launching sessions. These are used
 // internally by the SessionManager as well as for verify-installation
 core::Error launchSession(const core::r_util::SessionContext& context,
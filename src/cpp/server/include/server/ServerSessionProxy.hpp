@@ -66,7 +66,7 @@ bool proxyUploadRequest(
       const std::string& username,
       const std::string& userIdentifier,
       boost::shared_ptr<core::http::AsyncConnection> ptrConnection,
-      const std::string& formData,
+      std::string& formData,
       bool keepGoing);
 
 void proxyRpcRequest(
@@ -111,6 +111,13 @@ void setSessionContextSource(SessionContextSource source);
 
 core::http::Headers getAuthCookies(const core::http::Response& response);
 
+// session pre-warm: begin launching a user's session as soon as they
+// authenticate (when rsession-prewarm-on-signin is enabled) so process
+// exec, R initialization, and module init overlap with the browser
+// loading the IDE instead of being paid after client_init
+void setSessionPrewarmIoService(boost::asio::io_service& ioService);
+void prewarmSession(const std::string& userIdentifier);
+
 } // namespace session_proxy
 } // namespace server
 } // namespace rstudio
@@ -29,6 +29,11 @@ namespace uri_handlers {
 void add(const std::string& prefix,
          const core::http::AsyncUriHandlerFunction& handler);
 
+// add async uri handler on the bulk scheduling tier (large transfers;
+// concurrency is bounded so small requests keep io threads available)
+void addBulk(const std::string& prefix,
+             const core::http::AsyncUriHandlerFunction& handler);
+
 void addUploadHandler(const std::string& prefix,
                       const core::http::AsyncUriUploadHandlerFunction& handler);
 
@@ -60,7 +60,7 @@ typedef boost::function<bool(
                      const std::string& username,
                      const std::string& userIdentifier,
                      boost::shared_ptr<core::http::AsyncConnection>,
-                     const std::string&,
+                     std::string&,
                      bool)> SecureAsyncUriUploadHandlerFunctionEx;
 
 typedef boost::variant<SecureAsyncUriHandlerFunctionEx,
@@ -15,11 +15,14 @@
 
 #include <server_core/RVersionsScanner.hpp>
 
+#include <sstream>
+
 #include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/predicate.hpp>
 
 #include <shared_core/Error.hpp>
 #include <core/FileSerializer.hpp>
+#include <core/Thread.hpp>
 #include <core/json/JsonRpc.hpp>
 #include <core/r_util/REnvironment.hpp>
 #include <core/r_util/RVersionsPosix.hpp>
@@ -28,7 +31,14 @@
 
 namespace rstudio {
 namespace core {
-  
+
+namespace {
+
+// bump to invalidate probe caches persisted by older releases
+const int kProbeCacheVersion = 1;
+
+} // anonymous namespace
+
 RVersionsScanner::RVersionsScanner() :
    checkCommonRLocations_(true),
    whichROverride_(""),
@@ -173,15 +183,33 @@ std::vector<r_util::RVersion> RVersionsScanner::getRVersions()
       }
    }
 
-   // scan for available R versions
-   using namespace r_util;
-   std::vector<r_util::RVersion> versions = r_util::enumerateRVersions(
-            rHomeDirs,
-            rEntries,
-            checkCommonRLocations_,
-            rLdScriptPath_,
-            rLdLibraryPath_,
-            modulesBinaryPath_);
+   // fingerprint the candidate installations (paths + R binary mtimes);
+   // this only stats the filesystem, so it is effectively free compared
+   // with launching every R binary to probe its environment
+   std::string fingerprint = probeFingerprint(rHomeDirs, rEntries);
+
+   std::vector<r_util::RVersion> versions;
+   if (readProbeCache(fingerprint, &versions))
+   {
+      // serve this startup from the persisted cache, and rescan in the
+      // background so changes the fingerprint can't see (e.g. an updated
+      // environment module or prelaunch script) are picked up by the
+      // next restart. the probes each launch an R process so this gets
+      // its own thread rather than a slot in the background pool
+      RVersionsScanner scanner = *this;
+      core::thread::safeLaunchThread(
+               [scanner, rHomeDirs, rEntries, fingerprint]() mutable
+      {
+         scanner.writeProbeCache(
+                  fingerprint,
+                  scanner.scanRVersions(rHomeDirs, rEntries));
+      });
+   }
+   else
+   {
+      versions = scanRVersions(rHomeDirs, rEntries);
+      writeProbeCache(fingerprint, versions);
+   }
 
    // cache the versions that we just found
    cachedVersions_ = versions;
@@ -207,6 +235,134 @@ std::vector<r_util::RVersion> RVersionsScanner::getRVersions()
    return cachedVersions_;
 }
 
+void RVersionsScanner::setProbeCachePath(const core::FilePath& cachePath)
+{
+   probeCachePath_ = cachePath;
+}
+
+FilePath RVersionsScanner::probeCachePath()
+{
+   if (!probeCachePath_.isEmpty())
+      return probeCachePath_;
+
+   return core::system::xdg::userDataDir().completePath("r-versions-probe-cache");
+}
+
+std::string RVersionsScanner::probeFingerprint(
+                        const std::vector<FilePath>& rHomeDirs,
+                        const std::vector<r_util::RVersion>& rEntries)
+{
+   std::ostringstream ostr;
+
+   // scanner configuration that affects probe results
+   ostr << rLdScriptPath_.getAbsolutePath() << ":"
+        << rLdLibraryPath_ << ":"
+        << modulesBinaryPath_.getAbsolutePath() << "|";
+
+   // the full set of home paths the scan would probe (including the
+   // well-known locations), each keyed by the mtime of its R binary so
+   // that installing, removing, or upgrading R invalidates the cache
+   std::vector<FilePath> candidates = r_util::candidateRHomePaths(
+            rHomeDirs, checkCommonRLocations_);
+   for (const FilePath& homeDir : candidates)
+   {
+      FilePath rScriptPath = homeDir.completeChildPath("bin/R");
+      ostr << homeDir.getAbsolutePath() << ":";
+      if (rScriptPath.exists())
+         ostr << rScriptPath.getLastWriteTime();
+      ostr << ";";
+   }
+   ostr << "|";
+
+   // user-defined entries carry extra metadata (module, label, prelaunch
+   // script, etc.) so include their full definition alongside the mtime
+   for (const r_util::RVersion& rEntry : rEntries)
+   {
+      FilePath rScriptPath = rEntry.homeDir().completeChildPath("bin/R");
+      ostr << r_util::rVersionToJson(rEntry).write() << ":";
+      if (rScriptPath.exists())
+         ostr << rScriptPath.getLastWriteTime();
+      ostr << ";";
+   }
+
+   return ostr.str();
+}
+
+bool RVersionsScanner::readProbeCache(const std::string& fingerprint,
+                                      std::vector<r_util::RVersion>* pVersions)
+{
+   FilePath cachePath = probeCachePath();
+   if (!cachePath.exists())
+      return false;
+
+   std::string contents;
+   Error error = core::readStringFromFile(cachePath, &contents);
+   if (error)
+   {
+      LOG_ERROR(error);
+      return false;
+   }
+
+   json::Value cacheJson;
+   if (cacheJson.parse(contents) || !json::isType<json::Object>(cacheJson))
+      return false;
+
+   int version = 0;
+   std::string cachedFingerprint;
+   json::Array versionsJson;
+   error = json::readObject(cacheJson.getObject(),
+                            "version", version,
+                            "fingerprint", cachedFingerprint,
+                            "versions", versionsJson);
+   if (error ||
+       version != kProbeCacheVersion ||
+       cachedFingerprint != fingerprint)
+   {
+      return false;
+   }
+
+   std::vector<r_util::RVersion> versions;
+   error = r_util::rVersionsFromJson(versionsJson, &versions);
+   if (error)
+   {
+      LOG_ERROR(error);
+      return false;
+   }
+
+   *pVersions = versions;
+   return true;
+}
+
+void RVersionsScanner::writeProbeCache(
+                        const std::string& fingerprint,
+                        const std::vector<r_util::RVersion>& versions)
+{
+   json::Object cacheJson;
+   cacheJson["version"] = kProbeCacheVersion;
+   cacheJson["fingerprint"] = fingerprint;
+   cacheJson["versions"] = r_util::versionsToJson(versions);
+
+   FilePath cachePath = probeCachePath();
+   Error error = cachePath.getParent().ensureDirectory();
+   if (!error)
+      error = core::writeStringToFile(cachePath, cacheJson.write());
+   if (error)
+      LOG_ERROR(error);
+}
+
+std::vector<r_util::RVersion> RVersionsScanner::scanRVersions(
+                        const std::vector<FilePath>& rHomeDirs,
+                        const std::vector<r_util::RVersion>& rEntries)
+{
+   return r_util::enumerateRVersions(
+            rHomeDirs,
+            rEntries,
+            checkCommonRLocations_,
+            rLdScriptPath_,
+            rLdLibraryPath_,
+            modulesBinaryPath_);
+}
+
 void RVersionsScanner::parseRVersionsFile(const FilePath& versionsFile,
                                           const std::string& contents,
                                           std::vector<FilePath> *pRPaths,
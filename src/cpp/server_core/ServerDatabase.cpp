@@ -50,6 +50,7 @@ constexpr const char* kDefaultPostgresqlDatabaseUser = "postgres";
 constexpr const char* kDatabasePassword = "password";
 constexpr const char* kPostgresqlDatabaseConnectionTimeoutSeconds = "connnection-timeout-seconds";
 constexpr const int   kDefaultPostgresqlDatabaseConnectionTimeoutSeconds = 10;
+constexpr const char* kConnectionPoolSize = "pool-size";
 
 // environment variables
 constexpr const char* kDatabaseMigrationsPathEnvVar = "RS_DB_MIGRATIONS_PATH";
@@ -61,7 +62,8 @@ boost::shared_ptr<ConnectionPool> s_connectionPool;
 
 Error readOptions(const std::string& databaseConfigFile,
                   const boost::optional<system::User>& databaseFileUser,
-                  ConnectionOptions* pOptions)
+                  ConnectionOptions* pOptions,
+                  int* pPoolSize)
 {
    // read the options from the specified configuration file
    // if not specified, fall back to system configuration
@@ -74,6 +76,9 @@ Error readOptions(const std::string& databaseConfigFile,
    if (error)
       return error;
 
+   // read the connection pool size (0 = size based on the core count)
+   *pPoolSize = settings.getInt(kConnectionPoolSize, 0);
+
    std::string databaseProvider = settings.get(kDatabaseProvider, kDatabaseProviderSqlite);
    bool checkConfFilePermissions = false;
 
@@ -182,13 +187,22 @@ Error initialize(const std::string& databaseConfigFile,
                  const boost::optional<system::User>& databaseFileUser)
 {
    ConnectionOptions options;
-   Error error = readOptions(databaseConfigFile, databaseFileUser, &options);
+   int configuredPoolSize = 0;
+   Error error = readOptions(databaseConfigFile, databaseFileUser, &options, &configuredPoolSize);
    if (error)
       return error;
 
-   size_t poolSize = boost::thread::hardware_concurrency();
-   if (poolSize == 0)
-      poolSize = kDefaultConnectionPoolSize;
+   size_t poolSize;
+   if (configuredPoolSize > 0)
+   {
+      poolSize = static_cast<size_t>(configuredPoolSize);
+   }
+   else
+   {
+      poolSize = boost::thread::hardware_concurrency();
+      if (poolSize == 0)
+         poolSize = kDefaultConnectionPoolSize;
+   }
 
    error = createConnectionPool(poolSize, options, &s_connectionPool);
    if (error)
@@ -229,6 +243,12 @@ bool getConnection(const boost::posix_time::time_duration& waitTime,
    return s_connectionPool->getConnection(waitTime, pConnection);
 }
 
+std::future<Error> executeAsync(
+      const boost::function<Error(const boost::shared_ptr<IConnection>&)>& work)
+{
+   return s_connectionPool->executeAsync(work);
+}
+
 } // namespace database
 } // namespace server_core
 } // namespace rstudio
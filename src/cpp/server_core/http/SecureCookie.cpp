@@ -17,6 +17,8 @@
 
 #include <sys/stat.h>
 
+#include <map>
+
 #include <boost/optional.hpp>
 #include <boost/tokenizer.hpp>
 #include <boost/algorithm/string/predicate.hpp>
@@ -25,6 +27,7 @@
 
 #include <core/Log.hpp>
 #include <core/FileSerializer.hpp>
+#include <core/Thread.hpp>
 
 #include <core/http/URL.hpp>
 #include <core/http/Request.hpp>
@@ -52,6 +55,82 @@ const char * const kDelim = "|";
 std::string s_secureCookieKey;
 
 
+// cache of successfully verified cookies, keyed by the signed cookie
+// value. proxied traffic presents the same cookie on every request, so a
+// hit avoids recomputing the hmac on the request thread. only successful
+// verifications are cached (so forgery attempts can't grow the cache) and
+// a hit is honored only until the cookie's own expiry, so the cache never
+// extends a cookie's lifetime
+struct VerifiedCookie
+{
+   std::string value;
+   boost::posix_time::ptime expires;
+};
+
+boost::mutex s_verifiedCookiesMutex;
+std::map<std::string, VerifiedCookie> s_verifiedCookies;
+const std::size_t kMaxVerifiedCookies = 1000;
+
+bool lookupVerifiedCookie(const std::string& signedCookieValue,
+                          std::string* pValue)
+{
+   LOCK_MUTEX(s_verifiedCookiesMutex)
+   {
+      std::map<std::string, VerifiedCookie>::iterator it =
+                                    s_verifiedCookies.find(signedCookieValue);
+      if (it == s_verifiedCookies.end())
+         return false;
+
+      // the signature was valid when cached but the cookie may since have
+      // expired; drop the entry and fall back to the normal (failing) path
+      if (it->second.expires <=
+          boost::posix_time::second_clock::universal_time())
+      {
+         s_verifiedCookies.erase(it);
+         return false;
+      }
+
+      *pValue = it->second.value;
+      return true;
+   }
+   END_LOCK_MUTEX
+
+   return false;
+}
+
+void cacheVerifiedCookie(const std::string& signedCookieValue,
+                         const std::string& value,
+                         const boost::posix_time::ptime& expires)
+{
+   LOCK_MUTEX(s_verifiedCookiesMutex)
+   {
+      if (s_verifiedCookies.size() >= kMaxVerifiedCookies)
+      {
+         // evict expired entries; if everything is still live just start
+         // over (the cache repopulates within a few requests)
+         boost::posix_time::ptime now =
+                        boost::posix_time::second_clock::universal_time();
+         for (std::map<std::string, VerifiedCookie>::iterator
+                 it = s_verifiedCookies.begin();
+              it != s_verifiedCookies.end();)
+         {
+            if (it->second.expires <= now)
+               it = s_verifiedCookies.erase(it);
+            else
+               ++it;
+         }
+         if (s_verifiedCookies.size() >= kMaxVerifiedCookies)
+            s_verifiedCookies.clear();
+      }
+
+      VerifiedCookie entry;
+      entry.value = value;
+      entry.expires = expires;
+      s_verifiedCookies[signedCookieValue] = entry;
+   }
+   END_LOCK_MUTEX
+}
+
 Error base64HMAC(const std::string& value,
                  const std::string& expires,
                  std::string* pHMAC)
@@ -149,6 +228,12 @@ std::string readSecureCookie(const core::http::Request& request,
 
 std::string readSecureCookie(const std::string& signedCookieValue)
 {
+   // serve repeat cookies from the verification cache (one hmac per
+   // unique cookie rather than one per request)
+   std::string cachedValue;
+   if (lookupVerifiedCookie(signedCookieValue, &cachedValue))
+      return cachedValue;
+
    // split it into its parts (url decode them as well)
    std::string value, expires, hmac;
    using namespace boost;
@@ -199,6 +284,10 @@ std::string readSecureCookie(const std::string& signedCookieValue)
    else if (expiresTime <= second_clock::universal_time())
       return std::string();
 
+   // remember the verification so subsequent requests bearing this cookie
+   // skip the hmac
+   cacheVerifiedCookie(signedCookieValue, value, expiresTime);
+
    // ok to return the value
    return value;
 }
@@ -44,8 +44,18 @@ public:
 
    // scans for r versions and returns any that were found
    // subsequent calls return cached versions found in initial scan
+   //
+   // results are also persisted to disk along with a fingerprint of the
+   // candidate installations (paths + R binary mtimes); when nothing has
+   // changed the next scan is served from the persisted cache and a
+   // background rescan refreshes it, so restarts don't block on probing
+   // every R installation
    std::vector<r_util::RVersion> getRVersions();
 
+   // override the location of the persisted probe cache (primarily for
+   // testing; defaults to a file in the user data directory)
+   void setProbeCachePath(const core::FilePath& cachePath);
+
    bool detectRVersion(const core::FilePath& rScriptPath,
                        core::r_util::RVersion* pVersion,
                        std::string* pErrMsg);
@@ -66,6 +76,9 @@ private:
    core::r_util::RVersion systemVersion_;
    std::vector<r_util::RVersion> cachedVersions_;
 
+   // persisted probe cache
+   core::FilePath probeCachePath_;
+
    void parseRVersionsFile(const FilePath& versionsFile,
                            const std::string& contents,
                            std::vector<FilePath> *pRPaths,
@@ -75,6 +88,21 @@ private:
                                                    const std::string& rEntryStr);
 
    void setFallbackVersion();
+
+   core::FilePath probeCachePath();
+
+   std::string probeFingerprint(const std::vector<FilePath>& rHomeDirs,
+                                const std::vector<r_util::RVersion>& rEntries);
+
+   bool readProbeCache(const std::string& fingerprint,
+                       std::vector<r_util::RVersion>* pVersions);
+
+   void writeProbeCache(const std::string& fingerprint,
+                        const std::vector<r_util::RVersion>& versions);
+
+   std::vector<r_util::RVersion> scanRVersions(
+                        const std::vector<FilePath>& rHomeDirs,
+                        const std::vector<r_util::RVersion>& rEntries);
 };
 
 } // namespace core
@@ -37,6 +37,14 @@ boost::shared_ptr<core::database::IConnection> getConnection();
 bool getConnection(const boost::posix_time::time_duration& waitTime,
                    boost::shared_ptr<core::database::IConnection>* pConnection);
 
+// execute database work against a pool connection on a background thread,
+// returning a future for its result - use for queries whose round trip
+// must not stall the calling thread (e.g. request handlers); wait on the
+// future with wait_for to bound how long the caller will block
+std::future<core::Error> executeAsync(
+      const boost::function<core::Error(
+            const boost::shared_ptr<core::database::IConnection>&)>& work);
+
 } // namespace database
 } // namespace server_core
 } // namespace rstudio
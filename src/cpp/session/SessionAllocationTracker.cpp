@@ -0,0 +1,264 @@
+/*
+ * SessionAllocationTracker.cpp
+ *
+ * Copyright (C) 2022 by RStudio, PBC
+ *
+ * Unless you have received this program directly from RStudio pursuant
+ * to the terms of a commercial license agreement with RStudio, then
+ * this program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ *
+ */
+
+#include "SessionAllocationTracker.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include <boost/bind.hpp>
+
+#include <shared_core/Error.hpp>
+#include <shared_core/json/Json.hpp>
+
+#include <core/Exec.hpp>
+#include <core/json/JsonRpc.hpp>
+
+#include <session/SessionModuleContext.hpp>
+
+using namespace rstudio::core;
+
+namespace rstudio {
+namespace session {
+namespace allocation_tracker {
+namespace {
+
+// maximum number of distinct tags (registrations beyond this fall back
+// to the untagged slot)
+const int kMaxTags = 64;
+
+// tag 0 is implicit: allocations made outside any Scope
+const int kUntaggedTag = 0;
+
+// NOTE: everything touched from the allocation path must be constant
+// initialized (operator new runs before static constructors) and must not
+// itself allocate
+
+struct TagCounter
+{
+   std::atomic<long long> currentBytes;
+   std::atomic<long long> totalBytes;
+   std::atomic<long long> allocations;
+};
+
+TagCounter s_counters[kMaxTags];
+const char* s_tagNames[kMaxTags] = { "untagged" };
+std::atomic<int> s_numTags(1);
+
+// tag active on this thread (index into s_counters)
+thread_local int t_currentTag = kUntaggedTag;
+
+// tracking mode, resolved once from the environment on first allocation;
+// it never changes afterwards so headers are applied consistently
+// (-1 = unresolved)
+std::atomic<int> s_trackingEnabled(-1);
+
+bool trackingEnabled()
+{
+   int enabled = s_trackingEnabled.load(std::memory_order_relaxed);
+   if (enabled == -1)
+   {
+      // raw getenv: this runs inside operator new so it cannot allocate
+      const char* value = ::getenv("RSTUDIO_TRACK_ALLOCATIONS");
+      enabled = (value != nullptr && ::strcmp(value, "1") == 0) ? 1 : 0;
+      s_trackingEnabled.store(enabled, std::memory_order_relaxed);
+   }
+   return enabled == 1;
+}
+
+// header prefixed to each tracked allocation; kept to maximum alignment
+// so the returned pointer remains suitably aligned
+struct alignas(alignof(std::max_align_t)) AllocHeader
+{
+   std::size_t size;
+   int tag;
+};
+
+void* trackedAllocate(std::size_t size)
+{
+   void* pRaw = std::malloc(size + sizeof(AllocHeader));
+   if (pRaw == nullptr)
+      return nullptr;
+
+   int tag = t_currentTag;
+   AllocHeader* pHeader = static_cast<AllocHeader*>(pRaw);
+   pHeader->size = size;
+   pHeader->tag = tag;
+
+   TagCounter& counter = s_counters[tag];
+   counter.currentBytes.fetch_add(size, std::memory_order_relaxed);
+   counter.totalBytes.fetch_add(size, std::memory_order_relaxed);
+   counter.allocations.fetch_add(1, std::memory_order_relaxed);
+
+   return pHeader + 1;
+}
+
+void trackedFree(void* ptr)
+{
+   AllocHeader* pHeader = static_cast<AllocHeader*>(ptr) - 1;
+   s_counters[pHeader->tag].currentBytes.fetch_sub(
+            pHeader->size, std::memory_order_relaxed);
+   std::free(pHeader);
+}
+
+void* allocate(std::size_t size)
+{
+   if (trackingEnabled())
+      return trackedAllocate(size);
+   else
+      return std::malloc(size);
+}
+
+void deallocate(void* ptr)
+{
+   if (ptr == nullptr)
+      return;
+   if (trackingEnabled())
+      trackedFree(ptr);
+   else
+      std::free(ptr);
+}
+
+Error getAllocationStats(const json::JsonRpcRequest& request,
+                         json::JsonRpcResponse* pResponse)
+{
+   json::Array tagsJson;
+   int numTags = s_numTags.load();
+   for (int i = 0; i < numTags; i++)
+   {
+      json::Object tagJson;
+      tagJson["tag"] = std::string(s_tagNames[i]);
+      tagJson["current_bytes"] =
+            static_cast<double>(s_counters[i].currentBytes.load());
+      tagJson["total_bytes"] =
+            static_cast<double>(s_counters[i].totalBytes.load());
+      tagJson["allocations"] =
+            static_cast<double>(s_counters[i].allocations.load());
+      tagsJson.push_back(tagJson);
+   }
+
+   json::Object resultJson;
+   resultJson["enabled"] = trackingEnabled();
+   resultJson["tags"] = tagsJson;
+   pResponse->setResult(resultJson);
+   return Success();
+}
+
+} // anonymous namespace
+
+int registerTag(const char* name)
+{
+   // linear scan: registration is rare (once per marker site) and the tag
+   // list is small
+   int numTags = s_numTags.load();
+   for (int i = 0; i < numTags; i++)
+   {
+      if (::strcmp(s_tagNames[i], name) == 0)
+         return i;
+   }
+
+   int tag = s_numTags.fetch_add(1);
+   if (tag >= kMaxTags)
+   {
+      s_numTags.store(kMaxTags);
+      return kUntaggedTag;
+   }
+   s_tagNames[tag] = name;
+   return tag;
+}
+
+Scope::Scope(int tag)
+   : previous_(t_currentTag)
+{
+   t_currentTag = tag;
+}
+
+Scope::~Scope()
+{
+   t_currentTag = previous_;
+}
+
+Error initialize()
+{
+   using boost::bind;
+   using namespace module_context;
+   ExecBlock initBlock;
+   initBlock.addFunctions()
+      (bind(registerRpcMethod, "get_allocation_stats", getAllocationStats));
+   return initBlock.execute();
+}
+
+} // namespace allocation_tracker
+} // namespace session
+} // namespace rstudio
+
+// global operator new/delete overrides: route every allocation in the
+// session binary through the tracker. note these are intentionally outside
+// any namespace, and must exist in exactly one translation unit
+
+void* operator new(std::size_t size)
+{
+   void* ptr = rstudio::session::allocation_tracker::allocate(size);
+   if (ptr == nullptr)
+      throw std::bad_alloc();
+   return ptr;
+}
+
+void* operator new[](std::size_t size)
+{
+   return ::operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+   return rstudio::session::allocation_tracker::allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+   return rstudio::session::allocation_tracker::allocate(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+   rstudio::session::allocation_tracker::deallocate(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+   rstudio::session::allocation_tracker::deallocate(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+   rstudio::session::allocation_tracker::deallocate(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+   rstudio::session::allocation_tracker::deallocate(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+   rstudio::session::allocation_tracker::deallocate(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+   rstudio::session::allocation_tracker::deallocate(ptr);
+}
@@ -0,0 +1,62 @@
+/*
+ * SessionAllocationTracker.hpp
+ *
+ * Copyright (C) 2022 by RStudio, PBC
+ *
+ * Unless you have received this program directly from RStudio pursuant
+ * to the terms of a commercial license agreement with RStudio, then
+ * this program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ *
+ */
+
+#ifndef SESSION_ALLOCATION_TRACKER_HPP
+#define SESSION_ALLOCATION_TRACKER_HPP
+
+#include <boost/noncopyable.hpp>
+
+namespace rstudio {
+namespace core {
+   class Error;
+}
+}
+
+namespace rstudio {
+namespace session {
+namespace allocation_tracker {
+
+// per-tag allocation accounting. when enabled (RSTUDIO_TRACK_ALLOCATIONS=1
+// in the session environment) the global operator new/delete overrides in
+// SessionAllocationTracker.cpp prefix every allocation with a small header
+// recording its size and the tag active on the allocating thread, so bytes
+// can be attributed to subsystems (source database, client events, rpc
+// handlers, ...) and correctly un-attributed on free. when disabled the
+// overrides forward straight to malloc/free and Scope markers are inert.
+
+// register a tag (idempotent for a given name); typically called once via
+// a function-local static at each marker site
+int registerTag(const char* name);
+
+// RAII marker: attributes allocations on the current thread to the given
+// tag for the lifetime of the scope (nests; inner scopes win)
+class Scope : boost::noncopyable
+{
+public:
+   explicit Scope(int tag);
+   ~Scope();
+
+private:
+   int previous_;
+};
+
+// registers the get_allocation_stats RPC
+core::Error initialize();
+
+} // namespace allocation_tracker
+} // namespace session
+} // namespace rstudio
+
+#endif // SESSION_ALLOCATION_TRACKER_HPP
@@ -124,11 +124,14 @@ void asyncDownloadFile(const std::string& url,
    if (headerList.size() > 0)
      headersStr = ", headers = c(" + boost::algorithm::join(headerList, ", ") + ")";
 
-   // build the command
+   // build the command. relay the downloaded file with a single buffered
+   // readChar rather than readLines/cat (which splits the entire response
+   // into lines only to rejoin them -- slow for large responses, and lossy
+   // since the newlines are replaced with spaces)
    std::string cmd("{ ");
    cmd += "tmp <- tempfile(); ";
-   cmd += "download.file('" + url +"'" + headersStr + ", destfile = tmp, quiet = TRUE); ";
-   cmd += "cat(readLines(tmp, warn = FALSE)); ";
+   cmd += "download.file('" + url +"'" + headersStr + ", destfile = tmp, quiet = TRUE, mode = 'wb'); ";
+   cmd += "cat(readChar(tmp, file.size(tmp), useBytes = TRUE)); ";
    cmd += "} ";
 
    // kickoff the process
@@ -17,6 +17,7 @@
 #include <session/SessionConsoleProcess.hpp>
 #include <session/SessionModuleContext.hpp>
 
+#include <core/BoostThread.hpp>
 #include <core/system/Environment.hpp>
 #include <core/system/Process.hpp>
 
@@ -233,33 +234,67 @@ void AsyncRProcess::onStderr(const std::string& output)
    // no-op stub for optional implementation by derived classees
 }
 
+bool AsyncRProcess::serveIpcRequest()
+{
+   core::Error error = r::exec::RFunction(".rs.rstudioapi.processRequest")
+         .addParam(ipcRequests_.getAbsolutePathNative())
+         .addParam(ipcResponse_.getAbsolutePathNative())
+         .addParam(sharedSecret_)
+         .call();
+
+   if (error)
+   {
+      LOG_ERROR(error);
+
+      // remove the requests file so we don't attempt to re-log
+      core::Error error = ipcRequests_.removeIfExists();
+      if (error)
+         LOG_ERROR(error);
+
+      return false;
+   }
+
+   return true;
+}
+
 bool AsyncRProcess::onContinue()
 {
    if (terminationRequested_)
       return false;
-   
+
    // check for request requiring a response
    if (ipcRequests_.exists())
    {
-      core::Error error = r::exec::RFunction(".rs.rstudioapi.processRequest")
-            .addParam(ipcRequests_.getAbsolutePathNative())
-            .addParam(ipcResponse_.getAbsolutePathNative())
-            .addParam(sharedSecret_)
-            .call();
+      if (!serveIpcRequest())
+         return false;
 
-      if (error)
+      // the child blocks on our response before issuing its next request,
+      // so a tool calling the api in a tight loop would otherwise be served
+      // one call per supervisor poll. after serving a request, linger
+      // briefly for follow-ups so bursts complete in a single pass; both
+      // the linger window and the batch size are bounded so a chatty child
+      // can't starve the rest of the session loop
+      const int kMaxLingerPolls = 5;
+      const int kMaxBurstRequests = 100;
+      int lingerPolls = 0;
+      int served = 1;
+      while (lingerPolls < kMaxLingerPolls && served < kMaxBurstRequests)
       {
-         LOG_ERROR(error);
-
-         // remove the requests file so we don't attempt to re-log
-         core::Error error = ipcRequests_.removeIfExists();
-         if (error)
-            LOG_ERROR(error);
-
-         return false;
+         if (ipcRequests_.exists())
+         {
+            if (!serveIpcRequest())
+               return false;
+            served++;
+            lingerPolls = 0;
+         }
+         else
+         {
+            boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+            lingerPolls++;
+         }
       }
    }
-   
+
    return true;
 }
 
@@ -203,6 +203,11 @@ const int kTutorialCommand = 185;
 const int kTutorialLaunch = 186;
 const int kReticulateEvent = 187;
 const int kEnvironmentChanged = 188;
+const int kSessionStallDetected = 189;
+const int kAsyncFileDeletionCompleted = 190;
+const int kPreemptibleRpcProgress = 191;
+const int kPreemptibleRpcPartialResults = 192;
+const int kFileChangeset = 193;
 }
 
 void ClientEvent::init(int type, const json::Value& data)
@@ -564,6 +569,16 @@ std::string ClientEvent::typeName() const
          return "reticulate_event";
       case client_events::kEnvironmentChanged:
          return "environment_changed";
+      case client_events::kSessionStallDetected:
+         return "session_stall_detected";
+      case client_events::kAsyncFileDeletionCompleted:
+         return "async_file_deletion_completed";
+      case client_events::kPreemptibleRpcProgress:
+         return "preemptible_rpc_progress";
+      case client_events::kPreemptibleRpcPartialResults:
+         return "preemptible_rpc_partial_results";
+      case client_events::kFileChangeset:
+         return "file_changeset";
       default:
          LOG_WARNING_MESSAGE("unexpected event type: " + 
                              safe_convert::numberToString(type_));
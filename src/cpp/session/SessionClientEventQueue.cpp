@@ -15,6 +15,10 @@
 
 #include "SessionClientEventQueue.hpp"
 
+#include "SessionAllocationTracker.hpp"
+
+#include <algorithm>
+
 #include "modules/SessionConsole.hpp"
 
 #include <core/BoostThread.hpp>
@@ -30,9 +34,21 @@ namespace rstudio {
 namespace session {
  
 namespace {
+
 ClientEventQueue* s_pClientEventQueue = nullptr;
+
+// events where only the most recent instance matters to the client --
+// when a new one arrives any pending event of the same type is superseded
+// and can be dropped from the queue
+bool isSupersededEventType(int type)
+{
+   return type == client_events::kWorkingDirChanged ||
+          type == client_events::kPlotsStateChanged ||
+          type == client_events::kEnvironmentChanged;
 }
 
+} // anonymous namespace
+
 void initializeClientEventQueue()
 {
    BOOST_ASSERT(s_pClientEventQueue == nullptr);
@@ -71,14 +87,26 @@ bool ClientEventQueue::setActiveConsole(const std::string& console)
 }
 
 void ClientEventQueue::add(const ClientEvent& event)
-{ 
+{
+   // attribute queued event storage to the client event queue
+   static int s_allocTag = allocation_tracker::registerTag("client_events");
+   allocation_tracker::Scope allocScope(s_allocTag);
+
+   bool notifyListeners = true;
    LOCK_MUTEX(*pMutex_)
    {
       // console output is batched up for compactness/efficiency.
       if (event.type() == client_events::kConsoleWriteOutput)
       {
          if (event.data().getType() == json::Type::STRING)
+         {
+            // during bursts of output we only notify listeners on the
+            // transition from empty to non-empty -- subsequent chunks are
+            // coalesced into the pending string and picked up when the
+            // event service flushes on its batch delay
+            notifyListeners = pendingConsoleOutput_.empty();
             pendingConsoleOutput_ += event.data().getString();
+         }
       }
       else if (event.type() == client_events::kConsoleWriteError &&
                event.data().getType() == json::Type::STRING)
@@ -88,20 +116,34 @@ void ClientEventQueue::add(const ClientEvent& event)
       }
       else
       {
-         // flush existing console output prior to adding an 
+         // flush existing console output prior to adding an
          // action of another type
          flushPendingConsoleOutput();
-         
+
+         // remove any pending event which this one supersedes
+         if (isSupersededEventType(event.type()))
+         {
+            pendingEvents_.erase(
+               std::remove_if(pendingEvents_.begin(),
+                              pendingEvents_.end(),
+                              [&event](const ClientEvent& pendingEvent)
+                              {
+                                 return pendingEvent.type() == event.type();
+                              }),
+               pendingEvents_.end());
+         }
+
          // add event to queue
          pendingEvents_.push_back(event);
       }
-      
+
       lastEventAddTime_ = boost::posix_time::microsec_clock::universal_time();
    }
    END_LOCK_MUTEX
-   
+
    // notify listeners that an event has been added
-   pWaitForEventCondition_->notify_all();
+   if (notifyListeners)
+      pWaitForEventCondition_->notify_all();
 }
    
 bool ClientEventQueue::hasEvents() 
@@ -15,6 +15,8 @@
 
 #include <algorithm>
 
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/bind.hpp>
 #include <boost/function.hpp>
 
 #include <core/BoostThread.hpp>
@@ -27,10 +29,14 @@
 
 
 #include <core/http/Request.hpp>
+#include <core/http/Response.hpp>
+
+#include <shared_core/SafeConvert.hpp>
 
 #include <session/SessionOptions.hpp>
 #include <session/SessionHttpConnectionListener.hpp>
 #include <session/SessionClientEventService.hpp>
+#include <session/SessionConsoleProcessSocket.hpp>
 
 #include "SessionClientEventQueue.hpp"
 
@@ -43,6 +49,79 @@ namespace {
 
 const int kLastChanceWaitSeconds = 4;
 
+// websocket used to push events to clients which attach to it (connections
+// are dispatched by the trailing url segment, which must be the active
+// client id -- the same check long-poll requests are subject to)
+console_process::ConsoleProcessSocket s_eventSocket;
+
+// content type requested (via Accept) by clients which understand the
+// length-prefixed binary event frame format. each frame has the layout
+//
+//   [uint32 frameLength][uint8 kind][uint32 eventId][payload]
+//
+// (integers little-endian; frameLength counts everything after itself).
+// kind 0 frames carry the utf-8 json serialization of the event object;
+// kind 1 (console output) and kind 2 (console error) frames carry
+//
+//   [uint16 consoleIdLength][consoleId][raw output bytes]
+//
+// so console-heavy workloads skip json string escaping entirely
+const char* const kEventsBinaryContentType = "application/x-rstudio-events";
+
+void appendUInt16(uint16_t value, std::string* pBuffer)
+{
+   pBuffer->push_back(static_cast<char>(value & 0xFF));
+   pBuffer->push_back(static_cast<char>((value >> 8) & 0xFF));
+}
+
+void appendUInt32(uint32_t value, std::string* pBuffer)
+{
+   for (int i = 0; i < 4; i++)
+      pBuffer->push_back(static_cast<char>((value >> (i * 8)) & 0xFF));
+}
+
+void appendEventFrame(const json::Object& event, std::string* pBuffer)
+{
+   int id = 0;
+   std::string type;
+   Error error = json::readObject(event, "id", id, "type", type);
+   if (error)
+   {
+      LOG_ERROR(error);
+      return;
+   }
+
+   // console output/error events pass their text through as raw bytes;
+   // everything else is delivered as json within the frame
+   uint8_t kind = 0;
+   std::string payload;
+   json::Object::Iterator dataIt = event.find("data");
+   if ((type == "console_output" || type == "console_error") &&
+       dataIt != event.end() &&
+       (*dataIt).getValue().isObject())
+   {
+      std::string text, consoleId;
+      Error dataError = json::readObject((*dataIt).getValue().getObject(),
+                                         "text", text,
+                                         "console", consoleId);
+      if (!dataError)
+      {
+         kind = (type == "console_output") ? 1 : 2;
+         appendUInt16(static_cast<uint16_t>(consoleId.length()), &payload);
+         payload.append(consoleId);
+         payload.append(text);
+      }
+   }
+
+   if (kind == 0)
+      payload = event.write();
+
+   appendUInt32(static_cast<uint32_t>(1 + 4 + payload.length()), pBuffer);
+   pBuffer->push_back(static_cast<char>(kind));
+   appendUInt32(static_cast<uint32_t>(id), pBuffer);
+   pBuffer->append(payload);
+}
+
 bool hasEventIdLessThanOrEqualTo(const json::Value& event, int targetId)
 {
    const json::Object& eventJSON = event.getObject();
@@ -102,14 +181,126 @@ void ClientEventService::stop()
 
          serviceThread_.detach();
       }
+
+      // stop the websocket event channel (no-op if it was never started)
+      s_eventSocket.stopServer();
    }
    catch(const boost::thread_interrupted&)
    {
-      // the main thread is the one who calls stop() and it should 
+      // the main thread is the one who calls stop() and it should
       // NEVER be interrupted for any reason
       LOG_WARNING_MESSAGE("thread interrupted during stop");
    }
 }
+
+Error ClientEventService::startEventSocket(int* pPort)
+{
+   *pPort = 0;
+
+   Error error = s_eventSocket.ensureServerRunning();
+   if (error)
+      return error;
+
+   // (re)register the connection callbacks under the current client id
+   // (a new client id invalidates any listener for the previous one, just
+   // as it invalidates outstanding long-poll requests)
+   std::string handle = clientId();
+   LOCK_MUTEX(mutex_)
+   {
+      if (!eventSocketHandle_.empty() && eventSocketHandle_ != handle)
+         s_eventSocket.stopListening(eventSocketHandle_);
+      eventSocketHandle_ = handle;
+      eventSocketConnected_ = false;
+   }
+   END_LOCK_MUTEX
+
+   console_process::ConsoleProcessSocketConnectionCallbacks cb;
+   cb.onReceivedInput = boost::bind(&ClientEventService::onEventSocketAck,
+                                    this, _1);
+   cb.onConnectionOpened = boost::bind(&ClientEventService::onEventSocketOpened,
+                                       this);
+   cb.onConnectionClosed = boost::bind(&ClientEventService::onEventSocketClosed,
+                                       this);
+   error = s_eventSocket.listen(handle, cb);
+   if (error)
+      return error;
+
+   *pPort = s_eventSocket.port();
+   return Success();
+}
+
+void ClientEventService::onEventSocketAck(const std::string& input)
+{
+   // messages from the client on the event socket are acknowledgements
+   // carrying the last event id the client has processed
+   int lastClientEventIdSeen = safe_convert::stringTo<int>(input, -1);
+   if (lastClientEventIdSeen < 0)
+      return;
+
+   LOCK_MUTEX(mutex_)
+   {
+      lastAckedEventId_ = std::max(lastAckedEventId_, lastClientEventIdSeen);
+   }
+   END_LOCK_MUTEX
+
+   erasePreviouslyDeliveredEvents(lastClientEventIdSeen);
+}
+
+void ClientEventService::onEventSocketOpened()
+{
+   LOCK_MUTEX(mutex_)
+   {
+      eventSocketConnected_ = true;
+   }
+   END_LOCK_MUTEX
+}
+
+void ClientEventService::onEventSocketClosed()
+{
+   LOCK_MUTEX(mutex_)
+   {
+      eventSocketConnected_ = false;
+   }
+   END_LOCK_MUTEX
+}
+
+bool ClientEventService::eventSocketConnected()
+{
+   LOCK_MUTEX(mutex_)
+   {
+      return eventSocketConnected_;
+   }
+   END_LOCK_MUTEX
+
+   // keep compiler happy
+   return false;
+}
+
+int ClientEventService::lastAckedEventId()
+{
+   LOCK_MUTEX(mutex_)
+   {
+      return lastAckedEventId_;
+   }
+   END_LOCK_MUTEX
+
+   // keep compiler happy
+   return -1;
+}
+
+Error ClientEventService::sendEventsOverSocket()
+{
+   std::string handle;
+   std::string payload;
+   LOCK_MUTEX(mutex_)
+   {
+      handle = eventSocketHandle_;
+      payload = clientEvents_.write();
+   }
+   END_LOCK_MUTEX
+
+   return s_eventSocket.sendText(handle, payload);
+}
    
 void ClientEventService::setClientId(const std::string& clientId, bool clearEvents)
 {
@@ -183,6 +374,21 @@ void ClientEventService::setClientEventResult(
    END_LOCK_MUTEX
 }
 
+std::string ClientEventService::clientEventsAsBinaryFrames()
+{
+   std::string frames;
+   LOCK_MUTEX(mutex_)
+   {
+      for (const json::Value& event : clientEvents_)
+      {
+         if (event.isObject())
+            appendEventFrame(event.getObject(), &frames);
+      }
+   }
+   END_LOCK_MUTEX
+   return frames;
+}
+
 
 void ClientEventService::run()
 {
@@ -194,6 +400,14 @@ void ClientEventService::run()
       time_duration batchDelay = milliseconds(20);
       time_duration maxTotalBatchDelay = seconds(2);
 
+      // clients can advertise support for longer long-poll holds (second
+      // request param). when a session goes idle we then progressively
+      // extend the hold toward the advertised maximum, cutting the rate at
+      // which idle sessions cycle connections through the proxy. any
+      // delivered event resets the hold to the default
+      const int kMaxAdvertisedWaitSec = 600;
+      int consecutiveEmptyPolls = 0;
+
       // make much shorter for desktop mode
       if (options().programMode() == kSessionProgramModeDesktop)
       {
@@ -211,6 +425,70 @@ void ClientEventService::run()
       bool stopServer = false;
       while (!stopServer || clientEventQueue.hasEvents())
       {
+         // when a client is attached to the websocket event channel we push
+         // events over the socket rather than waiting for long-poll
+         // requests (any long-poll requests queued while the socket is
+         // connected are simply served once it disconnects)
+         if (eventSocketConnected())
+         {
+            // sync next event id to the most recent acknowledgement (same
+            // bookkeeping as the long-poll path performs per-request)
+            nextEventId = std::max(nextEventId, lastAckedEventId() + 1);
+
+            // wait for events to show up in the queue
+            bool haveEvents = false;
+            try
+            {
+               haveEvents = clientEventQueue.hasEvents() ||
+                            clientEventQueue.waitForEvent(seconds(1));
+               if (haveEvents)
+               {
+                  // wait for additional events that occur in rapid
+                  // succession but don't wait for more than the specified
+                  // maximum seconds
+                  boost::system_time maxBatchDelayTime =
+                                 boost::get_system_time() + maxTotalBatchDelay;
+
+                  while ( clientEventQueue.waitForEvent(batchDelay) &&
+                          (boost::get_system_time() < maxBatchDelayTime) )
+                  {
+                  }
+               }
+            }
+            catch(const boost::thread_interrupted&)
+            {
+               // terminate on the next iteration, but first flush whatever
+               // is in the queue (e.g. the quit event) over the socket
+               stopServer = true;
+               haveEvents = true;
+            }
+
+            if (!haveEvents)
+               continue;
+
+            // deque the events and convert to json with event ids
+            std::vector<ClientEvent> events;
+            clientEventQueue.remove(&events);
+            for (std::vector<ClientEvent>::const_iterator
+                 it = events.begin(); it != events.end(); ++it)
+            {
+               json::Object event;
+               it->asJsonObject(nextEventId++, &event);
+               addClientEvent(event);
+            }
+
+            // push all not-yet-acknowledged events to the client (which
+            // de-duplicates by event id, exactly as it does for long-poll
+            // responses which re-deliver unacknowledged events). if the
+            // send fails then fall back to long-polling -- the events
+            // remain in our internal list for delivery to the next request
+            Error error = sendEventsOverSocket();
+            if (error)
+               onEventSocketClosed();
+
+            continue;
+         }
+
          boost::shared_ptr<HttpConnection> ptrConnection;
          try
          {
@@ -266,14 +544,39 @@ void ClientEventService::run()
 
          // get the last event id seen by the client
          int lastClientEventIdSeen = -1;
-         Error paramError = json::readParam(request.params, 
-                                            0, 
+         Error paramError = json::readParam(request.params,
+                                            0,
                                             &lastClientEventIdSeen);
          if (paramError)
          {
             ptrConnection->sendJsonRpcError(paramError);
             continue;
          }
+
+         // read the maximum long-poll hold the client supports (optional
+         // second param; clients which don't send it get the default hold)
+         int clientMaxWaitSec = 0;
+         if (request.params.getSize() > 1)
+         {
+            Error waitError = json::readParam(request.params,
+                                              1,
+                                              &clientMaxWaitSec);
+            if (waitError)
+               clientMaxWaitSec = 0;
+            clientMaxWaitSec = std::min(clientMaxWaitSec,
+                                        kMaxAdvertisedWaitSec);
+         }
+
+         // compute this request's hold: the default, doubled for each
+         // recent empty poll, capped at what the client supports
+         time_duration requestWait = maxRequestSec;
+         if (clientMaxWaitSec > maxRequestSec.total_seconds())
+         {
+            long waitSec = maxRequestSec.total_seconds()
+                              << std::min(consecutiveEmptyPolls, 4);
+            requestWait = seconds(std::min(waitSec,
+                                           (long)clientMaxWaitSec));
+         }
            
          // remove all events already seen by the client from our internal list
          erasePreviouslyDeliveredEvents(lastClientEventIdSeen);
@@ -289,20 +592,26 @@ void ClientEventService::run()
          {
             // wait for the specified maximum time
             if (havePendingClientEvents() || clientEventQueue.hasEvents() ||
-                clientEventQueue.waitForEvent(maxRequestSec))
+                clientEventQueue.waitForEvent(requestWait))
             {
                // ...got at least one event
-               
-               // wait for additional events that occur in rapid succession 
+               consecutiveEmptyPolls = 0;
+
+               // wait for additional events that occur in rapid succession
                // but don't wait for more than the specified maximum seconds
-               boost::system_time maxBatchDelayTime = 
+               boost::system_time maxBatchDelayTime =
                               boost::get_system_time() + maxTotalBatchDelay;
-               
+
                while ( clientEventQueue.waitForEvent(batchDelay) &&
                        (boost::get_system_time() < maxBatchDelayTime) )
                {
                }
            }
+           else
+           {
+              // waited out the full hold with nothing to deliver
+              consecutiveEmptyPolls++;
+           }
          }
          catch(const boost::thread_interrupted&)
          {
@@ -333,13 +642,29 @@ void ClientEventService::run()
                addClientEvent(event);
             }
 
-            // send them (pass false for kEventsPending b/c responses from the
-            // event service shouldn't interact with automatic event service
-            // starting/re-starting)
-            json::JsonRpcResponse response;
-            setClientEventResult(&response);
-            response.setField(kEventsPending, "false");
-            ptrConnection->sendJsonRpcResponse(response);
+            // clients which advertise support for the binary frame format
+            // (via Accept) get the events as length-prefixed frames with
+            // console output passed through unescaped
+            if (boost::algorithm::contains(
+                   ptrConnection->request().headerValue("Accept"),
+                   kEventsBinaryContentType))
+            {
+               core::http::Response response;
+               response.setNoCacheHeaders();
+               response.setContentType(kEventsBinaryContentType);
+               response.setBodyUnencoded(clientEventsAsBinaryFrames());
+               ptrConnection->sendResponse(response);
+            }
+            else
+            {
+               // send them (pass false for kEventsPending b/c responses from
+               // the event service shouldn't interact with automatic event
+               // service starting/re-starting)
+               json::JsonRpcResponse response;
+               setClientEventResult(&response);
+               response.setField(kEventsPending, "false");
+               ptrConnection->sendJsonRpcResponse(response);
+            }
          }
          else
          {
@@ -80,6 +80,8 @@
 #include <server_core/UrlPorts.hpp>
 #endif
 
+#include <boost/bind.hpp>
+
 using namespace rstudio::core;
 
 extern "C" const char *locale2charset(const char *);
@@ -89,6 +91,65 @@ namespace session {
 namespace client_init {
 namespace {
 
+// cache of capability probes gathered for client_init. most of these
+// shell out to R (or load libraries) and their results change only
+// when the package library does, so a browser refresh can reuse the
+// values gathered for the previous client_init rather than re-probing
+// everything serially
+json::Object s_sessionCapabilities;
+bool s_haveSessionCapabilities = false;
+
+void invalidateSessionCapabilities()
+{
+   s_haveSessionCapabilities = false;
+}
+
+json::Object sessionCapabilitiesAsJson()
+{
+   // invalidate the cache whenever the package library changes (a newly
+   // installed package can add capabilities)
+   static bool s_invalidationRegistered = false;
+   if (!s_invalidationRegistered)
+   {
+      module_context::events().onPackageLibraryMutated.connect(
+                                       invalidateSessionCapabilities);
+      module_context::events().onLibPathsChanged.connect(
+                           boost::bind(invalidateSessionCapabilities));
+      s_invalidationRegistered = true;
+   }
+
+   if (s_haveSessionCapabilities)
+      return s_sessionCapabilities;
+
+   json::Object capsJson;
+   capsJson["rnw_weave_types"] = modules::authoring::supportedRnwWeaveTypes();
+   capsJson["latex_program_types"] = modules::authoring::supportedLatexProgramTypes();
+   capsJson["tex_capabilities"] = modules::authoring::texCapabilitiesAsJson();
+   capsJson["html_capabilities"] = modules::html_preview::capabilitiesAsJson();
+   capsJson["graphics_backends"] = modules::graphics::supportedBackends();
+   capsJson["devtools_installed"] = module_context::isMinimumDevtoolsInstalled();
+   capsJson["have_cairo_pdf"] = modules::plots::haveCairoPdf();
+   capsJson["packrat_available"] = module_context::isRequiredPackratInstalled();
+   capsJson["renv_available"] = module_context::isRequiredRenvInstalled();
+   capsJson["rmarkdown_available"] = modules::rmarkdown::rmarkdownPackageAvailable();
+   capsJson["knit_params_available"] = modules::rmarkdown::knitParamsAvailable();
+   capsJson["knit_working_dir_available"] = modules::rmarkdown::knitWorkingDirAvailable();
+   capsJson["ppt_available"] = modules::rmarkdown::pptAvailable();
+   capsJson["clang_available"] = modules::clang::isAvailable();
+   capsJson["bookdown_has_renumber_footnotes"] =
+         modules::rmarkdown::bookdown::hasRenumberFootnotes();
+
+   json::Object packageDependencies;
+   Error error = modules::dependency_list::getDependencyList(&packageDependencies);
+   if (error)
+      LOG_ERROR(error);
+   capsJson["package_dependencies"] = packageDependencies;
+
+   s_sessionCapabilities = capsJson;
+   s_haveSessionCapabilities = true;
+   return capsJson;
+}
+
 std::string userIdentityDisplay(const http::Request& request)
 {
    std::string userIdentity = request.headerValue(kRStudioUserIdentityDisplay);
@@ -270,12 +331,14 @@ void handleClientInit(const boost::function<void()>& initFunction,
       sessionInfo["console_actions"] = actionsObject;
    }
 
-   sessionInfo["rnw_weave_types"] = modules::authoring::supportedRnwWeaveTypes();
-   sessionInfo["latex_program_types"] = modules::authoring::supportedLatexProgramTypes();
-   sessionInfo["tex_capabilities"] = modules::authoring::texCapabilitiesAsJson();
-   sessionInfo["compile_pdf_state"] = modules::authoring::compilePdfStateAsJson();
+   // capability probes, cached across client inits (see
+   // sessionCapabilitiesAsJson) so that a browser refresh doesn't
+   // re-run them all serially
+   json::Object capabilitiesJson = sessionCapabilitiesAsJson();
+   for (const json::Object::Member& member : capabilitiesJson)
+      sessionInfo[member.getName()] = member.getValue();
 
-   sessionInfo["html_capabilities"] = modules::html_preview::capabilitiesAsJson();
+   sessionInfo["compile_pdf_state"] = modules::authoring::compilePdfStateAsJson();
 
    sessionInfo["find_in_files_state"] = modules::find::findInFilesStateAsJson();
 
@@ -403,11 +466,8 @@ void handleClientInit(const boost::function<void()>& initFunction,
    }
 
    sessionInfo["blogdown_config"] = modules::rmarkdown::blogdown::blogdownConfig();
-   sessionInfo["bookdown_has_renumber_footnotes"] = modules::rmarkdown::bookdown::hasRenumberFootnotes();
    sessionInfo["is_bookdown_project"] = module_context::isBookdownProject();
    sessionInfo["is_distill_project"] = module_context::isDistillProject();
-   
-   sessionInfo["graphics_backends"] = modules::graphics::supportedBackends();
 
    sessionInfo["presentation_state"] = modules::presentation::presentationStateAsJson();
    sessionInfo["presentation_commands"] = options.allowPresentationCommands();
@@ -416,8 +476,6 @@ void handleClientInit(const boost::function<void()>& initFunction,
    sessionInfo["tutorial_api_client_origin"] = json::Value();
 
    sessionInfo["build_state"] = modules::build::buildStateAsJson();
-   sessionInfo["devtools_installed"] = module_context::isMinimumDevtoolsInstalled();
-   sessionInfo["have_cairo_pdf"] = modules::plots::haveCairoPdf();
 
    // console history -- we do this at the end because
    // restoreBuildRestartContext may have reset it
@@ -445,6 +503,18 @@ void handleClientInit(const boost::function<void()>& initFunction,
    sessionInfo["websocket_ping_interval"] = options.webSocketPingInterval();
    sessionInfo["websocket_connect_timeout"] = options.webSocketConnectTimeout();
 
+   // websocket event channel: start the server side and advertise the port
+   // (zero means unavailable, in which case the client stays on long-polling;
+   // it likewise falls back on its own if connecting to the socket fails)
+   int eventSocketPort = 0;
+   if (options.allowEventWebsockets())
+   {
+      Error socketError = clientEventService().startEventSocket(&eventSocketPort);
+      if (socketError)
+         LOG_ERROR(socketError);
+   }
+   sessionInfo["event_socket_port"] = eventSocketPort;
+
    // publishing may be disabled globally or just for external services, and
    // via configuration options or environment variables
    bool allowPublish = options.allowPublish() &&
@@ -473,24 +543,6 @@ void handleClientInit(const boost::function<void()>& initFunction,
            (options.programMode() == kSessionProgramModeServer) &&
            options.showUserIdentity();
 
-   sessionInfo["packrat_available"] =
-                     module_context::isRequiredPackratInstalled();
-
-   sessionInfo["renv_available"] =
-         module_context::isRequiredRenvInstalled();
-
-   // check rmarkdown package presence and capabilities
-   sessionInfo["rmarkdown_available"] =
-         modules::rmarkdown::rmarkdownPackageAvailable();
-   sessionInfo["knit_params_available"] =
-         modules::rmarkdown::knitParamsAvailable();
-   sessionInfo["knit_working_dir_available"] = 
-         modules::rmarkdown::knitWorkingDirAvailable();
-   sessionInfo["ppt_available"] = 
-         modules::rmarkdown::pptAvailable();
-
-   sessionInfo["clang_available"] = modules::clang::isAvailable();
-
    // don't show help home until we figure out a sensible heuristic
    // sessionInfo["show_help_home"] = options.showHelpHome();
    sessionInfo["show_help_home"] = false;
@@ -529,12 +581,6 @@ void handleClientInit(const boost::function<void()>& initFunction,
 
    sessionInfo["launcher_jobs_enabled"] = modules::overlay::launcherJobsFeatureDisplayed();
 
-   json::Object packageDependencies;
-   error = modules::dependency_list::getDependencyList(&packageDependencies);
-   if (error)
-      LOG_ERROR(error);
-   sessionInfo["package_dependencies"] = packageDependencies;
-
    // crash handler settings
    bool canModifyCrashSettings =
          options.programMode() == kSessionProgramModeDesktop &&
@@ -546,6 +592,14 @@ void handleClientInit(const boost::function<void()>& initFunction,
 
    sessionInfo["project_id"] = session::options().sessionScope().project();
 
+   // clients which understand the binary event frame format can opt in
+   // by sending the advertised content type in the Accept header of
+   // their get_events requests
+   json::Array eventStreamFormats;
+   eventStreamFormats.push_back("json");
+   eventStreamFormats.push_back("application/x-rstudio-events");
+   sessionInfo["event_stream_formats"] = eventStreamFormats;
+
    if (session::options().getBoolOverlayOption(kSessionUserLicenseSoftLimitReached))
    {
       sessionInfo["license_message"] =
@@ -551,18 +551,21 @@ void ConsoleProcess::enqueOutputEvent(const std::string &output)
    if (procInfo_->getAltBufferActive() != currentAltBufferStatus)
       saveConsoleProcesses();
 
-   // If there's more output than the client can even show, then
-   // truncate it to the amount that the client can show. Too much
-   // output can overwhelm the client, making it unresponsive.
-   std::string trimmedOutput = output;
-   string_utils::trimLeadingLines(procInfo_->getMaxOutputLines(), &trimmedOutput);
-
    if (procInfo_->getChannelMode() == Websocket)
    {
+      // websocket output goes to the client as-is (the client-side
+      // emulator enforces its own scrollback limit) so don't pay for
+      // trimming on this path -- it's the throughput-critical one
       s_terminalSocket.sendText(procInfo_->getHandle(), output);
       return;
    }
 
+   // If there's more output than the client can even show, then
+   // truncate it to the amount that the client can show. Too much
+   // output can overwhelm the client, making it unresponsive.
+   std::string trimmedOutput = output;
+   string_utils::trimLeadingLines(procInfo_->getMaxOutputLines(), &trimmedOutput);
+
    // Rpc
    json::Object data;
    data["handle"] = handle();
@@ -15,9 +15,12 @@
 
 #include <session/SessionConsoleProcessPersist.hpp>
 
+#include <map>
+
 #include <gsl/gsl>
 
 #include <core/FileSerializer.hpp>
+#include <core/Thread.hpp>
 
 #include <session/SessionModuleContext.hpp>
 #include <session/SessionOptions.hpp>
@@ -63,6 +66,15 @@ FilePath s_consoleProcIndexPath;
 bool s_inited = false;
 const std::string s_envFileExt = ".env";
 
+// terminal output awaiting persistence, per handle. high-volume output
+// (e.g. cat-ing a large file) arrives in many small chunks; opening and
+// appending to the log file for each of them throttles the whole output
+// path, so chunks are batched here and written once a batch accumulates
+// (or when the buffer is about to be read, deleted, or checkpointed)
+const size_t kPendingOutputFlushBytes = 8192;
+boost::mutex s_pendingOutputMutex;
+std::map<std::string, std::string> s_pendingOutput;
+
 void initialize()
 {
    if (s_inited) return;
@@ -130,6 +142,50 @@ Error getEnvFilePath(const std::string& handle, FilePath* pFile)
    return Success();
 }
 
+void writeOutputToLog(const std::string& handle, const std::string& buffer)
+{
+   FilePath log;
+   Error error = getLogFilePath(handle, &log);
+   if (error)
+   {
+      LOG_ERROR(error);
+      return;
+   }
+
+   error = rstudio::core::appendToFile(log, buffer);
+   if (error)
+   {
+      LOG_ERROR(error);
+   }
+}
+
+void flushPendingOutput(const std::string& handle)
+{
+   std::string pending;
+   LOCK_MUTEX(s_pendingOutputMutex)
+   {
+      std::map<std::string, std::string>::iterator it =
+                                                s_pendingOutput.find(handle);
+      if (it == s_pendingOutput.end())
+         return;
+
+      pending.swap(it->second);
+      s_pendingOutput.erase(it);
+   }
+   END_LOCK_MUTEX
+
+   writeOutputToLog(handle, pending);
+}
+
+void discardPendingOutput(const std::string& handle)
+{
+   LOCK_MUTEX(s_pendingOutputMutex)
+   {
+      s_pendingOutput.erase(handle);
+   }
+   END_LOCK_MUTEX
+}
+
 } // anonymous namespace
 
 std::string loadConsoleProcessMetadata()
@@ -152,6 +208,10 @@ void saveConsoleProcesses(const std::string& metadata)
 {
    initialize();
 
+   // metadata checkpoints (including suspend and shutdown) also flush any
+   // batched terminal output so the buffer files are complete on disk
+   flushOutputBuffers();
+
    if (!s_consoleProcPath.exists())
       return;
 
@@ -166,6 +226,9 @@ std::string getSavedBuffer(const std::string& handle, int maxLines)
    std::string content;
    FilePath log;
 
+   // ensure batched output has made it to the file before reading it back
+   flushPendingOutput(handle);
+
    Error error = getLogFilePath(handle, &log);
    if (error)
    {
@@ -211,23 +274,50 @@ int getSavedBufferLineCount(const std::string& handle, int maxLines)
 
 void appendToOutputBuffer(const std::string& handle, const std::string& buffer)
 {
-   FilePath log;
-   Error error = getLogFilePath(handle, &log);
-   if (error)
+   // batch output in memory and write it once a reasonable amount has
+   // accumulated (a flush also happens whenever the buffer file is about
+   // to be read, deleted, or checkpointed via saveConsoleProcesses)
+   std::string pending;
+   LOCK_MUTEX(s_pendingOutputMutex)
    {
-      LOG_ERROR(error);
-      return;
+      std::string& pendingOutput = s_pendingOutput[handle];
+      pendingOutput.append(buffer);
+      if (pendingOutput.length() < kPendingOutputFlushBytes)
+         return;
+
+      pending.swap(pendingOutput);
+      s_pendingOutput.erase(handle);
    }
+   END_LOCK_MUTEX
 
-   error = rstudio::core::appendToFile(log, buffer);
-   if (error)
+   writeOutputToLog(handle, pending);
+}
+
+void flushOutputBuffers()
+{
+   std::map<std::string, std::string> pendingOutput;
+   LOCK_MUTEX(s_pendingOutputMutex)
    {
-      LOG_ERROR(error);
+      pendingOutput.swap(s_pendingOutput);
+   }
+   END_LOCK_MUTEX
+
+   for (std::map<std::string, std::string>::const_iterator
+        it = pendingOutput.begin(); it != pendingOutput.end(); ++it)
+   {
+      writeOutputToLog(it->first, it->second);
    }
 }
 
 void deleteLogFile(const std::string &handle, bool lastLineOnly)
 {
+   // batched output is doomed either way; when only trimming the last
+   // line it needs to be in the file first
+   if (lastLineOnly)
+      flushPendingOutput(handle);
+   else
+      discardPendingOutput(handle);
+
    FilePath log;
    Error error = getLogFilePath(handle, &log);
    if (error)
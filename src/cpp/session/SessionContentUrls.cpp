@@ -22,6 +22,7 @@
 #include <shared_core/FilePath.hpp>
 #include <core/FileSerializer.hpp>
 #include <core/Exec.hpp>
+#include <core/Hash.hpp>
 
 #include <core/system/System.hpp>
 
@@ -34,6 +35,7 @@
 extern "C" const char *locale2charset(const char *);
 
 #include <session/SessionModuleContext.hpp>
+#include <session/SessionUriContentCache.hpp>
 
 using namespace rstudio::core;
 
@@ -159,9 +161,10 @@ void handleContentRequest(const http::Request& request, http::Response* pRespons
    // set private cache forever headers
    pResponse->setPrivateCacheForeverHeaders();
 
-   // read file
+   // read file (through the shared content cache -- provisioned content
+   // is immutable so repeat views are served without a disk read)
    std::string contents;
-   error = core::readStringFromFile(contentFilePath, &contents);
+   error = content_cache::readCachedFile(contentFilePath, &contents);
    if (error)
    {
       pResponse->setError(error);
@@ -188,6 +191,17 @@ void handleContentRequest(const http::Request& request, http::Response* pRespons
       contents.append(fill);
    }
 
+   // use the content hash for revalidation so repeated fetches of
+   // unchanged content can be answered with a 304
+   std::string eTag = core::hash::crc32Hash(contents);
+   pResponse->setHeader("ETag", eTag);
+   if (eTag == request.headerValue("If-None-Match"))
+   {
+      pResponse->setStatusCode(http::status::NotModified);
+      pResponse->setHeader("Title", title);
+      return;
+   }
+
    // set contents
    pResponse->setContentType(contentFilePath.getMimeContentType());
    pResponse->setBody(contents);
@@ -198,7 +212,7 @@ void handleContentRequest(const http::Request& request, http::Response* pRespons
       // If the content looks like valid UTF-8, assume it is. Otherwise, assume
       // it's the system encoding.
       std::string contents;
-      error = core::readStringFromFile(contentFilePath, &contents);
+      error = content_cache::readCachedFile(contentFilePath, &contents);
       if (!error)
       {
          for (std::string::iterator pos = contents.begin(); pos != contents.end(); )
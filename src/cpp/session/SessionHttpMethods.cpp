@@ -21,6 +21,7 @@
 #include "SessionInit.hpp"
 #include "SessionUriHandlers.hpp"
 #include "SessionDirs.hpp"
+#include "SessionMainLoopMonitor.hpp"
 #include "SessionRpc.hpp"
 #include "http/SessionTcpIpHttpConnectionListener.hpp"
 
@@ -259,6 +260,11 @@ void polledEventHandler()
       return;
    }
 
+   // note that the event loop is alive (even while R is busy, R continues
+   // to pump polled events; a heartbeat gap therefore indicates a native
+   // stall rather than a long computation)
+   main_loop_monitor::heartbeat();
+
    // static lastPerformed value used for throttling
    using namespace boost::posix_time;
    static ptime s_lastPerformed;
@@ -485,6 +491,12 @@ bool waitForMethod(const std::string& method,
                                             connectionQueueTimeout);
 
 
+      // note that the event loop is alive
+      main_loop_monitor::heartbeat();
+
+      // trim rebuildable caches if the session has been idle long enough
+      suspend::checkForIdleTrim();
+
       // perform background processing (true for isIdle)
       module_context::onBackgroundProcessing(true);
 
@@ -569,9 +581,11 @@ bool waitForMethod(const std::string& method,
 void handleConnection(boost::shared_ptr<HttpConnection> ptrConnection,
                       ConnectionType connectionType)
 {
-   // check for a uri handler registered by a module
+   // check for a uri handler registered by a module (initializing any
+   // lazily registered module that owns the uri first)
    const core::http::Request& request = ptrConnection->request();
    std::string uri = request.uri();
+   module_context::ensureLazyModuleForUri(uri);
    boost::optional<core::http::UriAsyncHandlerFunctionVariant> uriHandler =
      uri_handlers::handlers().handlerFor(uri);
 
@@ -113,6 +113,8 @@
 #include "SessionHttpMethods.hpp"
 #include "SessionInit.hpp"
 #include "SessionMainProcess.hpp"
+#include "SessionAllocationTracker.hpp"
+#include "SessionMainLoopMonitor.hpp"
 #include "SessionRpc.hpp"
 #include "SessionSuspend.hpp"
 
@@ -157,6 +159,7 @@
 #include "modules/SessionSource.hpp"
 #include "modules/SessionTests.hpp"
 #include "modules/SessionThemes.hpp"
+#include "modules/SessionTokenService.hpp"
 #include "modules/SessionTutorial.hpp"
 #include "modules/SessionUpdates.hpp"
 #include "modules/SessionVCS.hpp"
@@ -471,10 +474,16 @@ Error rInit(const rstudio::r::session::RInitInfo& rInitInfo)
       // rpc methods
       (rpc::initialize)
 
+      // main-loop stall detection
+      (main_loop_monitor::initialize)
+
+      // allocation accounting
+      (allocation_tracker::initialize)
+
       // json-rpc listeners
       (bind(registerRpcMethod, kConsoleInput, bufferConsoleInput))
       (bind(registerRpcMethod, "suspend_for_restart", suspendForRestart))
-      (bind(registerRpcMethod, "ping", ping))
+      (bind(registerOffloadRpcMethod, "ping", ping))
 
       // signal handlers
       (registerSignalHandlers)
@@ -576,7 +585,16 @@ Error rInit(const rstudio::r::session::RInitInfo& rInitInfo)
       (modules::projects::templates::initialize)
       (modules::mathjax::initialize)
       (modules::panmirror::initialize)
-      (modules::zotero::initialize)
+      // zotero is rpc-only and rarely used, so defer its full
+      // initialization until one of its methods is first called
+      (bind(registerLazyModule,
+            "zotero",
+            std::vector<std::string>({ "zotero_get_collections",
+                                       "zotero_validate_web_api_key",
+                                       "zotero_detect_local_config",
+                                       "zotero_better_bibtex_export" }),
+            std::vector<std::string>(),
+            modules::zotero::initialize))
       (modules::rstudioapi::initialize)
       (modules::libpaths::initialize)
       (modules::explorer::initialize)
@@ -592,6 +610,7 @@ Error rInit(const rstudio::r::session::RInitInfo& rInitInfo)
       (modules::terminal::initialize)
       (modules::config_file::initialize)
       (modules::tutorial::initialize)
+      (modules::token_service::initialize)
       (modules::graphics::initialize)
       (modules::fonts::initialize)
 
@@ -1950,7 +1969,10 @@ int main (int argc, char * const argv[])
                FilePath templatePath = FilePath(options.firstProjectTemplatePath());
                if (templatePath.exists())
                {
-                  error = templatePath.copyDirectoryRecursive(
+                  // templates can be large (e.g. vendored package caches);
+                  // materialize with parallel workers rather than one file
+                  // at a time so first launch isn't gated on the copy
+                  error = templatePath.copyRecursiveParallel(
                      options.userHomePath().completeChildPath(
                         templatePath.getFilename()));
                   if (error)
@@ -0,0 +1,259 @@
+/*
+ * SessionMainLoopMonitor.cpp
+ *
+ * Copyright (C) 2022 by RStudio, PBC
+ *
+ * Unless you have received this program directly from RStudio pursuant
+ * to the terms of a commercial license agreement with RStudio, then
+ * this program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ *
+ */
+
+#include "SessionMainLoopMonitor.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+
+#include <shared_core/Error.hpp>
+#include <shared_core/SafeConvert.hpp>
+#include <shared_core/json/Json.hpp>
+
+#include <core/DateTime.hpp>
+#include <core/Exec.hpp>
+#include <core/Thread.hpp>
+#include <core/json/JsonRpc.hpp>
+#include <core/system/Environment.hpp>
+
+#include <r/RCntxtUtils.hpp>
+#include <r/RExec.hpp>
+
+#include <session/SessionClientEvent.hpp>
+#include <session/SessionModuleContext.hpp>
+
+#include "SessionConsoleInput.hpp"
+
+using namespace rstudio::core;
+
+namespace rstudio {
+namespace session {
+namespace main_loop_monitor {
+namespace {
+
+// a heartbeat gap longer than this is considered a stall
+const double kStallThresholdMs = 2000;
+
+// how often the watchdog samples the heartbeat
+const int kSampleIntervalMs = 250;
+
+// bound on the number of retained stall records
+const std::size_t kMaxStallLog = 50;
+
+// last heartbeat time (milliseconds on the steady clock, written by the
+// main thread, read by the watchdog)
+std::atomic<long long> s_lastHeartbeatMs(0);
+
+// context captured on the main thread alongside each heartbeat; this is
+// what we attribute a subsequent stall to (the watchdog thread must not
+// touch R state itself)
+struct HeartbeatContext
+{
+   HeartbeatContext() : rBusy(false), inFunctionContext(false),
+                        interruptsPending(false) {}
+   std::string activeMethod;
+   bool rBusy;
+   bool inFunctionContext;
+   bool interruptsPending;
+};
+
+boost::mutex s_contextMutex;
+HeartbeatContext s_heartbeatContext;
+
+// completed stall records (watchdog thread writes, RPC reads)
+struct StallRecord
+{
+   StallRecord() : startedAtMs(0), durationMs(0) {}
+   double startedAtMs;      // wall clock, milliseconds since epoch
+   double durationMs;
+   HeartbeatContext context;
+};
+
+boost::mutex s_stallLogMutex;
+std::deque<StallRecord> s_stallLog;
+
+// whether to notify the client when a stall resolves (opt-in; the event
+// is informational and most front ends won't handle it)
+bool s_notifyClient = false;
+
+long long steadyNowMs()
+{
+   using namespace std::chrono;
+   return duration_cast<milliseconds>(
+            steady_clock::now().time_since_epoch()).count();
+}
+
+json::Object stallRecordAsJson(const StallRecord& record)
+{
+   json::Object recordJson;
+   recordJson["started_at_ms"] = record.startedAtMs;
+   recordJson["duration_ms"] = record.durationMs;
+   recordJson["method"] = record.context.activeMethod;
+   recordJson["r_busy"] = record.context.rBusy;
+   recordJson["r_function_context"] = record.context.inFunctionContext;
+   recordJson["r_interrupts_pending"] = record.context.interruptsPending;
+   return recordJson;
+}
+
+void watchdogMain()
+{
+   bool inStall = false;
+   long long stallStartHeartbeatMs = 0;
+   HeartbeatContext stallContext;
+
+   while (true)
+   {
+      boost::this_thread::sleep(
+               boost::posix_time::milliseconds(kSampleIntervalMs));
+
+      long long lastHeartbeatMs = s_lastHeartbeatMs.load();
+
+      // not yet initialized (no heartbeat seen)
+      if (lastHeartbeatMs == 0)
+         continue;
+
+      long long gapMs = steadyNowMs() - lastHeartbeatMs;
+
+      if (!inStall && gapMs > kStallThresholdMs)
+      {
+         // stall detected: capture the context recorded with the last
+         // heartbeat (i.e. what the main thread was doing when it went dark)
+         inStall = true;
+         stallStartHeartbeatMs = lastHeartbeatMs;
+         LOCK_MUTEX(s_contextMutex)
+         {
+            stallContext = s_heartbeatContext;
+         }
+         END_LOCK_MUTEX
+      }
+      else if (inStall && lastHeartbeatMs != stallStartHeartbeatMs)
+      {
+         // heartbeat resumed: finalize the record
+         inStall = false;
+
+         StallRecord record;
+         record.durationMs =
+               static_cast<double>(lastHeartbeatMs - stallStartHeartbeatMs);
+         record.startedAtMs =
+               date_time::millisecondsSinceEpoch() - record.durationMs;
+         record.context = stallContext;
+
+         LOCK_MUTEX(s_stallLogMutex)
+         {
+            s_stallLog.push_back(record);
+            if (s_stallLog.size() > kMaxStallLog)
+               s_stallLog.pop_front();
+         }
+         END_LOCK_MUTEX
+
+         LOG_WARNING_MESSAGE(
+                  "main loop stall detected (" +
+                  safe_convert::numberToString(record.durationMs) + "ms; " +
+                  (record.context.activeMethod.empty()
+                      ? std::string("no active rpc")
+                      : "rpc: " + record.context.activeMethod) +
+                  (record.context.rBusy ? "; r busy" : "") + ")");
+
+         // client event queue is internally synchronized so this is safe
+         // to do from the watchdog thread
+         if (s_notifyClient)
+         {
+            ClientEvent event(client_events::kSessionStallDetected,
+                              stallRecordAsJson(record));
+            module_context::enqueClientEvent(event);
+         }
+      }
+   }
+}
+
+Error getSessionStalls(const json::JsonRpcRequest& request,
+                       json::JsonRpcResponse* pResponse)
+{
+   json::Array stallsJson;
+   LOCK_MUTEX(s_stallLogMutex)
+   {
+      for (const StallRecord& record : s_stallLog)
+         stallsJson.push_back(stallRecordAsJson(record));
+   }
+   END_LOCK_MUTEX
+
+   json::Object resultJson;
+   resultJson["stalls"] = stallsJson;
+   resultJson["threshold_ms"] = kStallThresholdMs;
+   pResponse->setResult(resultJson);
+   return Success();
+}
+
+} // anonymous namespace
+
+void heartbeat()
+{
+   long long nowMs = steadyNowMs();
+
+   // refresh the attribution snapshot at most every 50ms (heartbeats can
+   // arrive much more often than that and the R context queries, while
+   // cheap, aren't free)
+   long long lastMs = s_lastHeartbeatMs.load();
+   if (lastMs == 0 || (nowMs - lastMs) >= 50)
+   {
+      HeartbeatContext context;
+      context.rBusy = console_input::executing();
+      context.inFunctionContext =
+            static_cast<bool>(r::context::globalContext());
+      context.interruptsPending = r::exec::interruptsPending();
+      LOCK_MUTEX(s_contextMutex)
+      {
+         context.activeMethod = s_heartbeatContext.activeMethod;
+         s_heartbeatContext = context;
+      }
+      END_LOCK_MUTEX
+   }
+
+   s_lastHeartbeatMs.store(nowMs);
+}
+
+void setActiveRpcMethod(const std::string& method)
+{
+   LOCK_MUTEX(s_contextMutex)
+   {
+      s_heartbeatContext.activeMethod = method;
+   }
+   END_LOCK_MUTEX
+}
+
+Error initialize()
+{
+   // client notification is opt-in (informational event; off by default)
+   s_notifyClient = core::system::getenv("RSTUDIO_NOTIFY_SESSION_STALLS") == "1";
+
+   // launch the watchdog
+   core::thread::safeLaunchThread(watchdogMain);
+
+   // register rpc methods
+   using boost::bind;
+   using namespace module_context;
+   ExecBlock initBlock;
+   initBlock.addFunctions()
+      (bind(registerRpcMethod, "get_session_stalls", getSessionStalls));
+   return initBlock.execute();
+}
+
+} // namespace main_loop_monitor
+} // namespace session
+} // namespace rstudio
@@ -0,0 +1,48 @@
+/*
+ * SessionMainLoopMonitor.hpp
+ *
+ * Copyright (C) 2022 by RStudio, PBC
+ *
+ * Unless you have received this program directly from RStudio pursuant
+ * to the terms of a commercial license agreement with RStudio, then
+ * this program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ *
+ */
+
+#ifndef SESSION_MAIN_LOOP_MONITOR_HPP
+#define SESSION_MAIN_LOOP_MONITOR_HPP
+
+#include <string>
+
+namespace rstudio {
+namespace core {
+   class Error;
+}
+}
+
+namespace rstudio {
+namespace session {
+namespace main_loop_monitor {
+
+// record a main-loop heartbeat. called from the polled event handler and
+// the waitForMethod loop; while heartbeats flow the event loop is healthy
+// (even if R is busy with a long computation), and a gap indicates a
+// stall somewhere in native code
+void heartbeat();
+
+// note the RPC method currently being dispatched on the main thread (empty
+// to clear) so stalls can be attributed to the request that triggered them
+void setActiveRpcMethod(const std::string& method);
+
+// starts the watchdog thread and registers the get_session_stalls RPC
+core::Error initialize();
+
+} // namespace main_loop_monitor
+} // namespace session
+} // namespace rstudio
+
+#endif // SESSION_MAIN_LOOP_MONITOR_HPP
@@ -15,8 +15,11 @@
 
 #include "SessionModuleContextInternal.hpp"
 
+#include <algorithm>
+#include <map>
 #include <vector>
 
+#include <boost/algorithm/string/predicate.hpp>
 #include <boost/assert.hpp>
 #include <boost/utility.hpp>
 #include <boost/format.hpp>
@@ -70,6 +73,7 @@
 #include <session/http/SessionRequest.hpp>
 
 #include "SessionRpc.hpp"
+#include "SessionAllocationTracker.hpp"
 #include "SessionClientEventQueue.hpp"
 #include "SessionMainProcess.hpp"
 
@@ -752,17 +756,39 @@ typedef std::vector<boost::shared_ptr<ScheduledCommand> >
 ScheduledCommands s_scheduledCommands;
 ScheduledCommands s_idleScheduledCommands;
 
+// cached earliest deadline among the commands in each list, so that a
+// pass where nothing is due costs a single clock read and comparison
+// rather than a virtual execute() per registered command. not-a-date-time
+// means "unknown -- scan on the next pass"
+boost::posix_time::ptime s_scheduledCommandsDeadline;
+boost::posix_time::ptime s_idleScheduledCommandsDeadline;
+
 void addScheduledCommand(boost::shared_ptr<ScheduledCommand> pCommand,
                          bool idleOnly)
 {
    if (idleOnly)
+   {
       s_idleScheduledCommands.push_back(pCommand);
+      s_idleScheduledCommandsDeadline = boost::posix_time::ptime();
+   }
    else
+   {
       s_scheduledCommands.push_back(pCommand);
+      s_scheduledCommandsDeadline = boost::posix_time::ptime();
+   }
 }
 
-void executeScheduledCommands(ScheduledCommands* pCommands)
+void executeScheduledCommands(ScheduledCommands* pCommands,
+                              boost::posix_time::ptime* pDeadline)
 {
+   using namespace boost::posix_time;
+
+   // nothing due yet? (pos_infin here means no commands registered;
+   // neg_infin means a command wants to run on every pass)
+   ptime now = microsec_clock::universal_time();
+   if (!pDeadline->is_not_a_date_time() && now < *pDeadline)
+      return;
+
    // make a copy of scheduled commands before executing them
    // (this is because a scheduled command could result in
    // R code executing which in turn could cause the list of
@@ -770,10 +796,12 @@ void executeScheduledCommands(ScheduledCommands* pCommands)
    // invalidated)
    ScheduledCommands commands = *pCommands;
 
-   // execute all commands
-   std::for_each(commands.begin(),
-                 commands.end(),
-                 boost::bind(&ScheduledCommand::execute, _1));
+   // execute all commands which are due
+   for (const boost::shared_ptr<ScheduledCommand>& pCommand : commands)
+   {
+      if (pCommand->nextExecutionTime() <= now)
+         pCommand->execute();
+   }
 
    // remove any commands which are finished
    pCommands->erase(
@@ -782,6 +810,16 @@ void executeScheduledCommands(ScheduledCommands* pCommands)
                     pCommands->end(),
                     boost::bind(&ScheduledCommand::finished, _1)),
                  pCommands->end());
+
+   // recompute the earliest deadline (scanning pCommands rather than the
+   // copy so commands added during execution are included)
+   ptime deadline(pos_infin);
+   for (const boost::shared_ptr<ScheduledCommand>& pCommand : *pCommands)
+   {
+      if (pCommand->nextExecutionTime() < deadline)
+         deadline = pCommand->nextExecutionTime();
+   }
+   *pDeadline = deadline;
 }
 
 
@@ -901,6 +939,12 @@ void scheduleDelayedWork(const boost::posix_time::time_duration& period,
 
 void onBackgroundProcessing(bool isIdle)
 {
+   // attribute allocations made during background processing (covers
+   // module background work: file monitor, indexing, scheduled commands)
+   static int s_backgroundAllocTag =
+         allocation_tracker::registerTag("background_processing");
+   allocation_tracker::Scope allocScope(s_backgroundAllocTag);
+
    // allow process supervisor to poll for events
    processSupervisor().poll();
 
@@ -911,9 +955,10 @@ void onBackgroundProcessing(bool isIdle)
    events().onBackgroundProcessing(isIdle);
 
    // execute incremental commands
-   executeScheduledCommands(&s_scheduledCommands);
+   executeScheduledCommands(&s_scheduledCommands, &s_scheduledCommandsDeadline);
    if (isIdle)
-      executeScheduledCommands(&s_idleScheduledCommands);
+      executeScheduledCommands(&s_idleScheduledCommands,
+                               &s_idleScheduledCommandsDeadline);
 }
 
 #ifdef _WIN32
@@ -960,6 +1005,84 @@ Error registerIdleOnlyAsyncRpcMethod(
                                                 _1, _2, function));
 }
 
+namespace {
+
+// modules registered for lazy initialization (main thread only, like the
+// rpc and uri handler registries themselves)
+struct LazyModule
+{
+   std::string name;
+   std::vector<std::string> rpcMethods;
+   std::vector<std::string> uriPrefixes;
+   boost::function<Error()> initFunction;
+   bool initialized;
+};
+
+std::vector<LazyModule> s_lazyModules;
+
+void initializeLazyModule(LazyModule* pModule)
+{
+   // mark initialized up front so a failing module doesn't re-run its
+   // initialize on every subsequent dispatch
+   pModule->initialized = true;
+   Error error = pModule->initFunction();
+   if (error)
+      LOG_ERROR(error);
+}
+
+} // anonymous namespace
+
+Error registerLazyModule(
+      const std::string& name,
+      const std::vector<std::string>& rpcMethods,
+      const std::vector<std::string>& uriPrefixes,
+      const boost::function<Error()>& initFunction)
+{
+   LazyModule module;
+   module.name = name;
+   module.rpcMethods = rpcMethods;
+   module.uriPrefixes = uriPrefixes;
+   module.initFunction = initFunction;
+   module.initialized = false;
+   s_lazyModules.push_back(module);
+   return Success();
+}
+
+void ensureLazyModuleForRpc(const std::string& method)
+{
+   for (LazyModule& module : s_lazyModules)
+   {
+      if (module.initialized)
+         continue;
+
+      if (std::find(module.rpcMethods.begin(),
+                    module.rpcMethods.end(),
+                    method) != module.rpcMethods.end())
+      {
+         initializeLazyModule(&module);
+         return;
+      }
+   }
+}
+
+void ensureLazyModuleForUri(const std::string& uri)
+{
+   for (LazyModule& module : s_lazyModules)
+   {
+      if (module.initialized)
+         continue;
+
+      for (const std::string& prefix : module.uriPrefixes)
+      {
+         if (boost::algorithm::starts_with(uri, prefix))
+         {
+            initializeLazyModule(&module);
+            return;
+         }
+      }
+   }
+}
+
 core::string_utils::LineEnding lineEndings(const core::FilePath& srcFile)
 {
    // potential special case for Makevars
@@ -1020,11 +1143,19 @@ Error convertToUtf8(const std::string& encodedContents,
 
    stripBOM(pContents);
 
-   // Detect invalid UTF-8 sequences and recover
-   error = string_utils::utf8Clean(pContents->begin(),
-                                   pContents->end(),
-                                   '?');
-   return error;
+   // Detect invalid UTF-8 sequences and recover; validation is a fast
+   // scan, and the byte-wise clean pass only runs when the contents are
+   // actually malformed
+   if (!string_utils::isValidUtf8(*pContents))
+   {
+      error = string_utils::utf8Clean(pContents->begin(),
+                                      pContents->end(),
+                                      '?');
+      if (error)
+         return error;
+   }
+
+   return Success();
 }
 
 FilePath userHomePath()
@@ -1365,26 +1496,65 @@ bool disablePackages()
 }
 
 // check if a package is installed
+namespace {
+
+// cache of package installation probes -- modules call these checks
+// repeatedly on startup and first-use paths, and each one costs an R
+// evaluation that scans the library paths. entries are dropped whenever
+// the package library or the lib paths change (see initialize below)
+std::map<std::string, bool> s_packageInstalledCache;
+
+void clearPackageInstalledCache()
+{
+   s_packageInstalledCache.clear();
+}
+
+void onLibPathsChangedClearCache(const std::vector<std::string>&)
+{
+   clearPackageInstalledCache();
+}
+
+} // anonymous namespace
+
 bool isPackageInstalled(const std::string& packageName)
 {
+   std::map<std::string, bool>::const_iterator it =
+         s_packageInstalledCache.find(packageName);
+   if (it != s_packageInstalledCache.end())
+      return it->second;
+
    r::session::utils::SuppressOutputInScope suppressOutput;
 
    bool installed = false;
    r::exec::RFunction func(".rs.isPackageInstalled", packageName);
    Error error = func.call(&installed);
-   return !error ? installed : false;
+   if (error)
+      return false;
+
+   s_packageInstalledCache[packageName] = installed;
+   return installed;
 }
 
 bool isPackageVersionInstalled(const std::string& packageName,
                                const std::string& version)
 {
+   std::string cacheKey = packageName + ">=" + version;
+   std::map<std::string, bool>::const_iterator it =
+         s_packageInstalledCache.find(cacheKey);
+   if (it != s_packageInstalledCache.end())
+      return it->second;
+
    r::session::utils::SuppressOutputInScope suppressOutput;
 
    bool installed = false;
    r::exec::RFunction func(".rs.isPackageVersionInstalled",
                            packageName, version);
    Error error = func.call(&installed);
-   return !error ? installed : false;
+   if (error)
+      return false;
+
+   s_packageInstalledCache[cacheKey] = installed;
+   return installed;
 }
 
 bool isMinimumDevtoolsInstalled()
@@ -2296,13 +2466,13 @@ core::Error executeAsync(const json::JsonRpcFunction& function,
 {
    // Immediately return a response to the server with a handle that
    // identifies this invocation. In the meantime, kick off the actual
-   // operation on a new thread.
+   // operation on the shared background pool.
 
    std::string handle = core::system::generateUuid(true);
-   core::thread::safeLaunchThread(bind(beginRpcHandler,
-                                       function,
-                                       request,
-                                       handle));
+   core::thread::backgroundThreadPool().enque(bind(beginRpcHandler,
+                                                   function,
+                                                   request,
+                                                   handle));
    pResponse->setAsyncHandle(handle);
    return Success();
 }
@@ -2806,6 +2976,10 @@ Error initialize()
    RS_REGISTER_CALL_METHOD(rs_userPrompt);
    RS_REGISTER_CALL_METHOD(rs_setRpcDelay);
 
+   // invalidate cached package probes when the library changes
+   events().onPackageLibraryMutated.connect(clearPackageInstalledCache);
+   events().onLibPathsChanged.connect(onLibPathsChangedClearCache);
+
    // initialize monitored scratch dir
    initializeMonitoredUserScratchDir();
 
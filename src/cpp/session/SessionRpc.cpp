@@ -13,16 +13,38 @@
  *
  */
 
+#include <algorithm>
+#include <cstdint>
+#include <map>
 #include <string>
+#include <vector>
+
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
 
 #include "SessionRpc.hpp"
 #include "SessionHttpMethods.hpp"
+#include "SessionAllocationTracker.hpp"
 #include "SessionClientEventQueue.hpp"
+#include "SessionMainLoopMonitor.hpp"
+#include "SessionSuspend.hpp"
+
+#include "http/SessionHttpConnectionUtils.hpp"
 
 #include <shared_core/json/Json.hpp>
 #include <core/json/JsonRpc.hpp>
 #include <core/Exec.hpp>
 #include <core/Log.hpp>
+#include <core/Thread.hpp>
+#include <core/http/CSRFToken.hpp>
+#include <core/system/System.hpp>
+
+#include <monitor/MonitorClient.hpp>
+
+#include <session/SessionClientEventService.hpp>
+#include <session/SessionHttpConnectionQueue.hpp>
+#include <session/SessionModuleContext.hpp>
+#include <session/SessionOptions.hpp>
 
 #include <r/RExec.hpp>
 #include <r/RSexp.hpp>
@@ -41,12 +63,388 @@ int s_rpcDelayMs = -1;
 
 // json rpc methods
 core::json::JsonRpcAsyncMethods* s_pJsonRpcMethods = nullptr;
-   
+
+// rpc methods declared read-only (they touch neither the R interpreter nor
+// other main-thread-only state) which are executed on the offload worker
+// thread rather than the main thread
+boost::mutex s_offloadMethodsMutex;
+std::map<std::string, core::json::JsonRpcFunction> s_offloadMethods;
+
+// connections claimed by the offload lane (routed here by the listener
+// threads via connection::checkForOffloadRpc)
+HttpConnectionQueue s_offloadConnectionQueue;
+bool s_offloadThreadStarted = false;
+boost::thread s_offloadThread;
+
+// per-method rpc latency and request size statistics ----------------------
+//
+// aggregated with constant memory per method: latency samples are bucketed
+// by power-of-two bounds (HDR style) so percentiles can be estimated
+// without retaining individual samples. guarded by a mutex since rpcs
+// execute on both the main thread and the offload worker.
+
+const int kRpcLatencyBuckets = 32;
+
+// export aggregated metrics to the monitor service at most this often
+const int kRpcMetricsExportSeconds = 300;
+
+struct RpcMethodStats
+{
+   RpcMethodStats()
+      : count(0), totalMicros(0), totalRequestBytes(0)
+   {
+      std::fill(latencyBuckets, latencyBuckets + kRpcLatencyBuckets,
+                static_cast<uint64_t>(0));
+   }
+
+   uint64_t count;
+   uint64_t totalMicros;
+   uint64_t totalRequestBytes;
+   uint64_t latencyBuckets[kRpcLatencyBuckets];
+};
+
+boost::mutex s_rpcStatsMutex;
+std::map<std::string, RpcMethodStats> s_rpcStats;
+boost::posix_time::ptime s_lastRpcMetricsExport;
+
+int rpcLatencyBucket(uint64_t micros)
+{
+   int bucket = 0;
+   while (micros > 1 && bucket < kRpcLatencyBuckets - 1)
+   {
+      micros >>= 1;
+      bucket++;
+   }
+   return bucket;
+}
+
+// upper bound (in microseconds) of the given latency bucket
+double rpcLatencyBucketBound(int bucket)
+{
+   return static_cast<double>(static_cast<uint64_t>(1) << (bucket + 1));
+}
+
+double estimateLatencyPercentile(const RpcMethodStats& stats,
+                                 double percentile)
+{
+   if (stats.count == 0)
+      return 0.0;
+
+   uint64_t target = static_cast<uint64_t>(stats.count * percentile);
+   uint64_t cumulative = 0;
+   for (int i = 0; i < kRpcLatencyBuckets; i++)
+   {
+      cumulative += stats.latencyBuckets[i];
+      if (cumulative > target)
+         return rpcLatencyBucketBound(i);
+   }
+   return rpcLatencyBucketBound(kRpcLatencyBuckets - 1);
+}
+
+void recordRpcExecution(const std::string& method,
+                        const boost::posix_time::ptime& startTime,
+                        std::size_t requestBytes)
+{
+   // methods are only recorded after successful registry lookup, so the
+   // map is bounded by the number of registered rpc methods
+   using namespace boost::posix_time;
+   uint64_t micros = (microsec_clock::universal_time() - startTime)
+                        .total_microseconds();
+
+   LOCK_MUTEX(s_rpcStatsMutex)
+   {
+      RpcMethodStats& stats = s_rpcStats[method];
+      stats.count++;
+      stats.totalMicros += micros;
+      stats.totalRequestBytes += requestBytes;
+      stats.latencyBuckets[rpcLatencyBucket(micros)]++;
+   }
+   END_LOCK_MUTEX
+}
+
+Error rpcMetricsAsJson(const json::JsonRpcRequest& request,
+                       json::JsonRpcResponse* pResponse)
+{
+   json::Array methodsJson;
+   LOCK_MUTEX(s_rpcStatsMutex)
+   {
+      for (std::map<std::string, RpcMethodStats>::const_iterator
+           it = s_rpcStats.begin(); it != s_rpcStats.end(); ++it)
+      {
+         const RpcMethodStats& stats = it->second;
+         json::Object methodJson;
+         methodJson["method"] = it->first;
+         methodJson["count"] = static_cast<double>(stats.count);
+         methodJson["mean_ms"] = stats.count > 0 ?
+               (stats.totalMicros / stats.count) / 1000.0 : 0.0;
+         methodJson["p50_ms"] = estimateLatencyPercentile(stats, 0.50) / 1000.0;
+         methodJson["p99_ms"] = estimateLatencyPercentile(stats, 0.99) / 1000.0;
+         methodJson["total_request_bytes"] =
+               static_cast<double>(stats.totalRequestBytes);
+         methodsJson.push_back(methodJson);
+      }
+   }
+   END_LOCK_MUTEX
+
+   pResponse->setResult(methodsJson);
+   return Success();
+}
+
+void exportRpcMetrics()
+{
+   using namespace monitor::metrics;
+
+   std::vector<MetricData> p99Data;
+   std::vector<MetricData> countData;
+   LOCK_MUTEX(s_rpcStatsMutex)
+   {
+      for (std::map<std::string, RpcMethodStats>::const_iterator
+           it = s_rpcStats.begin(); it != s_rpcStats.end(); ++it)
+      {
+         p99Data.push_back(MetricData(
+               it->first, estimateLatencyPercentile(it->second, 0.99) / 1000.0));
+         countData.push_back(MetricData(
+               it->first, static_cast<double>(it->second.count)));
+      }
+   }
+   END_LOCK_MUTEX
+
+   if (p99Data.empty())
+      return;
+
+   std::vector<MultiMetric> metrics;
+   metrics.push_back(MultiMetric("session-rpc-p99", p99Data, "gauge", "ms"));
+   metrics.push_back(MultiMetric("session-rpc-count", countData, "counter"));
+   monitor::client().sendMultiMetrics(metrics);
+}
+
+void onBackgroundProcessing(bool)
+{
+   using namespace boost::posix_time;
+   ptime now = microsec_clock::universal_time();
+   if (s_lastRpcMetricsExport.is_not_a_date_time())
+   {
+      s_lastRpcMetricsExport = now;
+      return;
+   }
+   if ((now - s_lastRpcMetricsExport).total_seconds() <
+       kRpcMetricsExportSeconds)
+      return;
+
+   s_lastRpcMetricsExport = now;
+   exportRpcMetrics();
+}
+
+bool lookupOffloadMethod(const std::string& name,
+                         core::json::JsonRpcFunction* pFunction)
+{
+   LOCK_MUTEX(s_offloadMethodsMutex)
+   {
+      std::map<std::string, core::json::JsonRpcFunction>::const_iterator it =
+                                                   s_offloadMethods.find(name);
+      if (it == s_offloadMethods.end())
+         return false;
+
+      *pFunction = it->second;
+      return true;
+   }
+   END_LOCK_MUTEX
+
+   // keep compiler happy
+   return false;
+}
+
+void handleOffloadRpcConnection(boost::shared_ptr<HttpConnection> ptrConnection)
+{
+   // record the time just prior to execution (so we can determine whether
+   // any events were added during execution)
+   using namespace boost::posix_time;
+   ptime executeStartTime = microsec_clock::universal_time();
+
+   // parse and validate -- the same checks the main thread performs, except
+   // that the client id is read from the threadsafe copy maintained for the
+   // client event service
+   json::JsonRpcRequest request;
+   Error error = json::parseJsonRpcRequest(ptrConnection->request().body(),
+                                           &request);
+   if (error)
+   {
+      ptrConnection->sendJsonRpcError(error);
+      return;
+   }
+
+   if (options().programMode() == kSessionProgramModeServer &&
+       !core::http::validateCSRFHeaders(ptrConnection->request()))
+   {
+      ptrConnection->sendJsonRpcError(
+               Error(json::errc::Unauthorized, ERROR_LOCATION));
+      return;
+   }
+
+   if (request.clientId != clientEventService().clientId())
+   {
+      ptrConnection->sendJsonRpcError(
+               Error(json::errc::InvalidClientId, ERROR_LOCATION));
+      return;
+   }
+
+   if (!request.clientVersion.empty() &&
+       http_methods::clientVersion() != request.clientVersion)
+   {
+      ptrConnection->sendJsonRpcError(
+               Error(json::errc::InvalidClientVersion, ERROR_LOCATION));
+      return;
+   }
+
+   // execute the method
+   core::json::JsonRpcFunction function;
+   if (!lookupOffloadMethod(request.method, &function))
+   {
+      Error methodError = Error(json::errc::MethodNotFound, ERROR_LOCATION);
+      methodError.addProperty("method", request.method);
+      LOG_ERROR(methodError);
+      ptrConnection->sendJsonRpcError(methodError);
+      return;
+   }
+
+   json::JsonRpcResponse response;
+   error = function(request, &response);
+   recordRpcExecution(request.method,
+                      executeStartTime,
+                      ptrConnection->request().body().size());
+   if (error)
+   {
+      ptrConnection->sendJsonRpcError(error);
+      return;
+   }
+
+   // offload methods are read-only by contract so there is no
+   // onDetectChanges pass here (it could only run on the main thread, which
+   // is exactly what this lane exists to avoid waiting on)
+   BOOST_ASSERT(!response.hasAfterResponse());
+   if (!clientEventQueue().eventAddedSince(executeStartTime))
+      response.setField(kEventsPending, "false");
+   ptrConnection->sendJsonRpcResponse(response);
+}
+
+void offloadRpcThread()
+{
+   try
+   {
+      while (true)
+      {
+         boost::shared_ptr<HttpConnection> ptrConnection =
+               s_offloadConnectionQueue.dequeConnection(
+                                          boost::posix_time::seconds(1));
+         if (ptrConnection)
+            handleOffloadRpcConnection(ptrConnection);
+      }
+   }
+   catch(const boost::thread_interrupted&)
+   {
+   }
+   CATCH_UNEXPECTED_EXCEPTION
+}
+
+
+// preemptible rpcs --------------------------------------------------------
+//
+// some rpcs (code search, large data fetches) run long with no way for the
+// client to stop them once issued; an abandoned request keeps consuming
+// session cpu until it completes. a preemptible method receives a token it
+// polls between units of work. the cancel rpc executes on the offload
+// worker, so it is serviced even while the main thread is busy running the
+// very method being cancelled; it trips the token and the method bails at
+// its next poll. methods can also stream progress and partial result pages
+// to the client as events keyed by the same handle.
+
+const char* const kCancelRpc = "cancel_rpc";
+const char* const kPreemptHandleParam = "preempt_handle";
+
+boost::mutex s_preemptibleTokensMutex;
+std::map<std::string, boost::shared_ptr<module_context::PreemptibleRpcToken> >
+                                                         s_preemptibleTokens;
+
+// cancel an in-flight preemptible rpc by handle. registered on the offload
+// lane; it only trips an atomic flag so it satisfies the read-only contract
+Error cancelRpc(const json::JsonRpcRequest& request,
+                json::JsonRpcResponse* pResponse)
+{
+   std::string handle;
+   Error error = json::readParams(request.params, &handle);
+   if (error)
+      return error;
+
+   bool found = false;
+   LOCK_MUTEX(s_preemptibleTokensMutex)
+   {
+      std::map<std::string,
+               boost::shared_ptr<module_context::PreemptibleRpcToken> >
+            ::const_iterator it = s_preemptibleTokens.find(handle);
+      if (it != s_preemptibleTokens.end())
+      {
+         it->second->cancel();
+         found = true;
+      }
+   }
+   END_LOCK_MUTEX
+
+   // not finding the handle isn't an error -- the method may simply have
+   // completed before the cancellation arrived
+   pResponse->setResult(found);
+   return Success();
+}
+
+Error runPreemptibleRpc(const module_context::PreemptibleRpcFunction& function,
+                        const json::JsonRpcRequest& request,
+                        json::JsonRpcResponse* pResponse)
+{
+   // the client supplies the handle so it can address cancel_rpc and
+   // correlate progress/partial result events; fall back to a generated
+   // one for callers that don't opt in (the method then just runs to
+   // completion, as it always did)
+   std::string handle;
+   json::Object::Iterator it = request.kwparams.find(kPreemptHandleParam);
+   if (it != request.kwparams.end() && (*it).getValue().isString())
+      handle = (*it).getValue().getString();
+   bool clientSupplied = !handle.empty();
+   if (!clientSupplied)
+      handle = core::system::generateUuid(false);
+
+   boost::shared_ptr<module_context::PreemptibleRpcToken> pToken(
+            new module_context::PreemptibleRpcToken(handle, clientSupplied));
+   LOCK_MUTEX(s_preemptibleTokensMutex)
+   {
+      s_preemptibleTokens[handle] = pToken;
+   }
+   END_LOCK_MUTEX
+
+   Error error = function(request, *pToken, pResponse);
+
+   LOCK_MUTEX(s_preemptibleTokensMutex)
+   {
+      s_preemptibleTokens.erase(handle);
+   }
+   END_LOCK_MUTEX
+
+   return error;
+}
+
 void endHandleRpcRequestDirect(boost::shared_ptr<HttpConnection> ptrConnection,
                          boost::posix_time::ptime executeStartTime,
+                         const std::string& method,
                          const core::Error& executeError,
                          json::JsonRpcResponse* pJsonRpcResponse)
 {
+   // record per-method statistics (method is empty when it wasn't found
+   // in the registry; don't let arbitrary request uris grow the stats map)
+   if (!method.empty())
+   {
+      recordRpcExecution(method,
+                         executeStartTime,
+                         ptrConnection->request().body().size());
+   }
+
    // return error or result then continue waiting for requests
    if (executeError)
    {
@@ -87,9 +485,14 @@ void endHandleRpcRequestDirect(boost::shared_ptr<HttpConnection> ptrConnection,
 
 void endHandleRpcRequestIndirect(
       const std::string& asyncHandle,
+      const std::string& method,
+      boost::posix_time::ptime executeStartTime,
+      std::size_t requestBytes,
       const core::Error& executeError,
       json::JsonRpcResponse* pJsonRpcResponse)
 {
+   recordRpcExecution(method, executeStartTime, requestBytes);
+
    json::JsonRpcResponse temp;
    json::JsonRpcResponse& jsonRpcResponse =
                                  pJsonRpcResponse ? *pJsonRpcResponse : temp;
@@ -113,6 +516,114 @@ void saveJsonResponse(const core::Error& error, core::json::JsonRpcResponse *pSr
    *pDest = *pSrc;
 }
 
+// rpc batch envelope ------------------------------------------------------
+//
+// the client issues many small rpcs in bursts (a keystroke can trigger
+// completion, diagnostics, and lint requests together); batching them into
+// one request saves a proxy round trip per call, which matters on high
+// latency links
+
+const char* const kExecuteRpcBatch = "execute_rpc_batch";
+
+// execute a batch of rpc calls in one request. calls execute in order on
+// this thread and their raw responses are returned in a parallel array;
+// when abort_on_error is set (the default) a failing call ends the batch
+// early, since later calls in a burst frequently depend on earlier ones
+Error executeRpcBatch(const json::JsonRpcRequest& request,
+                      json::JsonRpcResponse* pResponse)
+{
+   // read the array of calls and the optional abort flag
+   json::Array callsJson;
+   Error error = json::readParam(request.params, 0, &callsJson);
+   if (error)
+      return error;
+
+   bool abortOnError = true;
+   if (request.params.getSize() > 1)
+   {
+      error = json::readParam(request.params, 1, &abortOnError);
+      if (error)
+         return error;
+   }
+
+   bool aborted = false;
+   json::Array responsesJson;
+   for (const json::Value& callValue : callsJson)
+   {
+      if (!callValue.isObject())
+         return Error(json::errc::ParamTypeMismatch, ERROR_LOCATION);
+      json::Object callJson = callValue.getObject();
+
+      // read the method and its parameters
+      json::JsonRpcRequest callRequest;
+      error = json::readObject(callJson, "method", callRequest.method);
+      if (error)
+         return error;
+
+      json::Object::Iterator it = callJson.find("params");
+      if (it != callJson.end() && (*it).getValue().isArray())
+         callRequest.params = (*it).getValue().getArray();
+      it = callJson.find("kwparams");
+      if (it != callJson.end() && (*it).getValue().isObject())
+         callRequest.kwparams = (*it).getValue().getObject();
+
+      // carry over request context so handlers that consult it behave as
+      // they would for a standalone call
+      callRequest.sourceWindow = request.sourceWindow;
+      callRequest.clientId = request.clientId;
+      callRequest.clientVersion = request.clientVersion;
+      callRequest.version = request.version;
+
+      // execute the call (synchronous methods only; async methods respond
+      // via the event stream and don't benefit from batching anyway -- and
+      // nested batches are disallowed to keep the envelope non-recursive)
+      json::JsonRpcResponse callResponse;
+      Error callError;
+      module_context::ensureLazyModuleForRpc(callRequest.method);
+      auto methodIter = s_pJsonRpcMethods->find(callRequest.method);
+      if (methodIter == s_pJsonRpcMethods->end())
+      {
+         callError = Error(json::errc::MethodNotFound, ERROR_LOCATION);
+         callError.addProperty("method", callRequest.method);
+      }
+      else if (!methodIter->second.first ||
+               callRequest.method == kExecuteRpcBatch)
+      {
+         callError = Error(json::errc::InvalidRequest, ERROR_LOCATION);
+         callError.addProperty("method", callRequest.method);
+      }
+      else
+      {
+         methodIter->second.second(
+               callRequest,
+               boost::bind(saveJsonResponse, _1, _2,
+                           &callError, &callResponse));
+      }
+
+      if (callError)
+         callResponse.setError(callError);
+
+      // run any after-response work now, before the next call executes,
+      // so ordering matches standalone execution
+      if (callResponse.hasAfterResponse())
+         callResponse.runAfterResponse();
+
+      responsesJson.push_back(callResponse.getRawResponse());
+
+      if (callError && abortOnError)
+      {
+         aborted = true;
+         break;
+      }
+   }
+
+   json::Object resultJson;
+   resultJson["responses"] = responsesJson;
+   resultJson["aborted"] = aborted;
+   pResponse->setResult(resultJson);
+   return Success();
+}
+
 // invoke an HTTP RPC directly from R.
 SEXP rs_invokeRpc(SEXP name, SEXP args)
 {
@@ -120,7 +631,9 @@ SEXP rs_invokeRpc(SEXP name, SEXP args)
    json::JsonRpcRequest request;
    rpc::formatRpcRequest(name, args, &request);
 
-   // check to see if the RPC exists
+   // check to see if the RPC exists (initializing any lazily registered
+   // module that owns it first)
+   module_context::ensureLazyModuleForRpc(request.method);
    auto it = s_pJsonRpcMethods->find(request.method);
    if (it == s_pJsonRpcMethods->end())
    {
@@ -197,8 +710,96 @@ void registerRpcMethod(const core::json::JsonRpcAsyncMethod& method)
    s_pJsonRpcMethods->insert(method);
 }
 
+Error registerOffloadRpcMethod(const std::string& name,
+                               const core::json::JsonRpcFunction& function)
+{
+   // record in the offload registry (consulted by the listener threads to
+   // route matching connections to the offload worker)
+   LOCK_MUTEX(s_offloadMethodsMutex)
+   {
+      s_offloadMethods[name] = function;
+   }
+   END_LOCK_MUTEX
+
+   // lazily launch the worker thread (registration occurs during session
+   // init on the main thread so there is no race on the started flag)
+   if (!s_offloadThreadStarted)
+   {
+      // block all signals for launch of background thread (will cause it
+      // to never receive signals)
+      core::system::SignalBlocker signalBlocker;
+      Error error = signalBlocker.blockAll();
+      if (error)
+         return error;
+
+      core::thread::safeLaunchThread(offloadRpcThread, &s_offloadThread);
+      s_offloadThreadStarted = true;
+   }
+
+   // also register as a normal rpc method so it remains reachable via
+   // rs_invokeRpc and any request that bypasses the offload lane
+   return registerRpcMethod(name, function);
+}
+
+void PreemptibleRpcToken::reportPartialResults(
+                                 const core::json::Value& results) const
+{
+   if (!clientSupplied_)
+      return;
+
+   json::Object value;
+   value["handle"] = handle_;
+   value["results"] = results;
+   enqueClientEvent(
+            ClientEvent(client_events::kPreemptibleRpcPartialResults, value));
+}
+
+void PreemptibleRpcToken::reportProgress(int units, int totalUnits) const
+{
+   if (!clientSupplied_)
+      return;
+
+   json::Object value;
+   value["handle"] = handle_;
+   value["units"] = units;
+   value["total_units"] = totalUnits;
+   enqueClientEvent(
+            ClientEvent(client_events::kPreemptibleRpcProgress, value));
+}
+
+Error registerPreemptibleRpcMethod(const std::string& name,
+                                   const PreemptibleRpcFunction& function)
+{
+   return registerRpcMethod(name,
+                            boost::bind(runPreemptibleRpc, function, _1, _2));
+}
+
 } // namespace module_context
 
+namespace connection {
+
+bool checkForOffloadRpc(boost::shared_ptr<HttpConnection> ptrConnection)
+{
+   // extract the method name from the uri (e.g. "foo" from "/rpc/foo")
+   const std::string kRpcUriPrefix = "/rpc/";
+   std::string uri = ptrConnection->request().uri();
+   if (!boost::algorithm::starts_with(uri, kRpcUriPrefix))
+      return false;
+   std::string method = uri.substr(kRpcUriPrefix.length());
+
+   LOCK_MUTEX(s_offloadMethodsMutex)
+   {
+      if (s_offloadMethods.find(method) == s_offloadMethods.end())
+         return false;
+   }
+   END_LOCK_MUTEX
+
+   s_offloadConnectionQueue.enqueConnection(ptrConnection);
+   return true;
+}
+
+} // namespace connection
+
 namespace rpc {
 
 void formatRpcRequest(SEXP name,
@@ -269,7 +870,22 @@ void handleRpcRequest(const core::json::JsonRpcRequest& request,
    // (so we can determine if any events were added during execution)
    using namespace boost::posix_time;
    ptime executeStartTime = microsec_clock::universal_time();
-   
+
+   // give any lazily registered module owning this method a chance to
+   // initialize (and register its real handlers) before lookup
+   module_context::ensureLazyModuleForRpc(request.method);
+
+   // note the active method so main-loop stalls triggered by this
+   // request can be attributed to it
+   main_loop_monitor::setActiveRpcMethod(request.method);
+
+   // attribute allocations made while dispatching to rpc handlers
+   static int s_rpcAllocTag = allocation_tracker::registerTag("rpc");
+   allocation_tracker::Scope allocScope(s_rpcAllocTag);
+
+   // client activity re-arms the idle trim timer
+   suspend::noteClientActivity();
+
    // execute the method
    auto it = s_pJsonRpcMethods->find(request.method);
    if (it != s_pJsonRpcMethods->end())
@@ -284,6 +900,7 @@ void handleRpcRequest(const core::json::JsonRpcRequest& request,
                          boost::bind(endHandleRpcRequestDirect,
                                      ptrConnection,
                                      executeStartTime,
+                                     request.method,
                                      _1,
                                      _2));
       }
@@ -299,6 +916,9 @@ void handleRpcRequest(const core::json::JsonRpcRequest& request,
          handlerFunction(request,
                          boost::bind(endHandleRpcRequestIndirect,
                                      handle,
+                                     request.method,
+                                     executeStartTime,
+                                     ptrConnection->request().body().size(),
                                      _1,
                                      _2));
       }
@@ -312,8 +932,11 @@ void handleRpcRequest(const core::json::JsonRpcRequest& request,
       // application states
       LOG_ERROR(executeError);
 
-      endHandleRpcRequestDirect(ptrConnection, executeStartTime, executeError, nullptr);
+      endHandleRpcRequestDirect(ptrConnection, executeStartTime, std::string(),
+                                executeError, nullptr);
    }
+
+   main_loop_monitor::setActiveRpcMethod(std::string());
 }
 
 void setRpcDelay(int delayMs)
@@ -332,6 +955,27 @@ Error initialize()
 
    RS_REGISTER_CALL_METHOD(rs_invokeRpc);
 
+   // diagnostics: per-method latency/size statistics, exported periodically
+   // to the monitor service
+   module_context::events().onBackgroundProcessing.connect(
+                                                      onBackgroundProcessing);
+   Error error = module_context::registerRpcMethod("get_rpc_metrics",
+                                                   rpcMetricsAsJson);
+   if (error)
+      return error;
+
+   // batch envelope (multiple rpc calls per http request)
+   error = module_context::registerRpcMethod(kExecuteRpcBatch,
+                                             executeRpcBatch);
+   if (error)
+      return error;
+
+   // cancellation for preemptible rpcs (on the offload lane so it is
+   // serviced while the main thread is busy with the method to cancel)
+   error = module_context::registerOffloadRpcMethod(kCancelRpc, cancelRpc);
+   if (error)
+      return error;
+
    return Success();
 }
 
@@ -15,9 +15,17 @@
 
 #include <session/SessionSourceDatabase.hpp>
 
+#include <algorithm>
+#include <list>
 #include <string>
 #include <vector>
-#include <algorithm>
+
+#ifndef _WIN32
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
 
 #include <boost/bind.hpp>
 #include <boost/regex.hpp>
@@ -32,7 +40,11 @@
 #include <core/FileUtils.hpp>
 #include <core/RegexUtils.hpp>
 #include <core/DateTime.hpp>
+#include <core/Thread.hpp>
 
+#include <core/StringUtils.hpp>
+
+#include <core/system/Environment.hpp>
 #include <core/system/System.hpp>
 
 #include <core/http/Util.hpp>
@@ -45,6 +57,7 @@
 #include <session/SessionModuleContext.hpp>
 #include <session/projects/SessionProjects.hpp>
 
+#include "SessionAllocationTracker.hpp"
 #include "SessionSourceDatabaseSupervisor.hpp"
 
 #define kContentsSuffix "-contents"
@@ -71,6 +84,140 @@ namespace {
 // lookup)
 std::map<std::string, std::string> s_idToPath;
 
+// bounded memory mode: documents whose contents exceed the threshold are
+// not held in memory; contents() materializes them from the sidecar file
+// on access (mmap where available) through a small LRU of materialized
+// strings, so idle tabs cost close to nothing
+namespace contents_cache {
+
+const std::size_t kLazyThreshold = 128 * 1024;
+const std::size_t kMaxCachedBytes = 8 * 1024 * 1024;
+
+bool enabled()
+{
+   static bool s_enabled =
+         core::system::getenv("RSTUDIO_BOUNDED_SOURCE_DB") == "1";
+   return s_enabled;
+}
+
+boost::mutex s_cacheMutex;
+std::map<std::string, boost::shared_ptr<const std::string> > s_cache;
+std::list<std::string> s_lru; // front = most recently used
+std::size_t s_cachedBytes = 0;
+
+// read the sidecar file, preferring mmap (single copy into the result,
+// no buffered i/o); falls back to the regular read path
+Error readContents(const FilePath& contentsPath, std::string* pContents)
+{
+#ifndef _WIN32
+   int fd = ::open(contentsPath.getAbsolutePath().c_str(), O_RDONLY);
+   if (fd != -1)
+   {
+      struct stat st;
+      if (::fstat(fd, &st) == 0 && st.st_size > 0)
+      {
+         void* pMapped = ::mmap(nullptr, st.st_size, PROT_READ,
+                                MAP_PRIVATE, fd, 0);
+         if (pMapped != MAP_FAILED)
+         {
+            pContents->assign(static_cast<const char*>(pMapped), st.st_size);
+            ::munmap(pMapped, st.st_size);
+            ::close(fd);
+
+            // apply the same line ending normalization as the regular
+            // read path
+            string_utils::convertLineEndings(pContents,
+                                             options().sourceLineEnding());
+            return Success();
+         }
+      }
+      ::close(fd);
+   }
+#endif
+   return readStringFromFile(contentsPath,
+                             pContents,
+                             options().sourceLineEnding());
+}
+
+void touch(const std::string& id)
+{
+   s_lru.remove(id);
+   s_lru.push_front(id);
+}
+
+// materialize (or fetch cached) contents for the given document
+boost::shared_ptr<const std::string> contentsForDocument(
+                                       const std::string& id,
+                                       const std::string& contentsPath)
+{
+   LOCK_MUTEX(s_cacheMutex)
+   {
+      std::map<std::string, boost::shared_ptr<const std::string> >::iterator
+            it = s_cache.find(id);
+      if (it != s_cache.end())
+      {
+         touch(id);
+         return it->second;
+      }
+   }
+   END_LOCK_MUTEX
+
+   boost::shared_ptr<std::string> pContents(new std::string());
+   Error error = readContents(FilePath(contentsPath), pContents.get());
+   if (error)
+   {
+      LOG_ERROR(error);
+      return boost::shared_ptr<const std::string>();
+   }
+
+   LOCK_MUTEX(s_cacheMutex)
+   {
+      s_cache[id] = pContents;
+      s_cachedBytes += pContents->size();
+      touch(id);
+
+      // evict least recently used entries beyond the cap (documents
+      // currently holding a reference keep their string alive; we just
+      // drop the cache's reference)
+      while (s_cachedBytes > kMaxCachedBytes && s_lru.size() > 1)
+      {
+         std::string evictId = s_lru.back();
+         s_lru.pop_back();
+         std::map<std::string,
+                  boost::shared_ptr<const std::string> >::iterator evictIt =
+               s_cache.find(evictId);
+         if (evictIt != s_cache.end())
+         {
+            s_cachedBytes -= evictIt->second->size();
+            s_cache.erase(evictIt);
+         }
+      }
+   }
+   END_LOCK_MUTEX
+
+   return pContents;
+}
+
+// drop any cached contents for the given document (called when the
+// document is updated or removed)
+void invalidate(const std::string& id)
+{
+   LOCK_MUTEX(s_cacheMutex)
+   {
+      std::map<std::string, boost::shared_ptr<const std::string> >::iterator
+            it = s_cache.find(id);
+      if (it != s_cache.end())
+      {
+         s_cachedBytes -= it->second->size();
+         s_cache.erase(it);
+         s_lru.remove(id);
+      }
+   }
+   END_LOCK_MUTEX
+}
+
+} // namespace contents_cache
+
 struct PropertiesDatabase
 {
    FilePath path;
@@ -280,6 +427,122 @@ bool isIntendedAsReadOnly(const std::string& contents,
    return false;
 }
 
+// write-behind queue for document files. put() captures the serialized
+// bytes of a document and queues the disk write on the shared background
+// pool, so autosave latency doesn't include the filesystem round trip
+// (which can be substantial e.g. on NFS home directories). readers flush
+// pending writes before touching the files so they always observe the
+// most recent put, and suspend/quit flushes everything before the
+// supervisor moves the database directory
+struct PendingWrite
+{
+   PendingWrite() : hasContents(false) {}
+
+   bool hasContents;
+   std::string contents;
+   std::string properties;
+};
+
+// pending writes keyed by the absolute path of the properties file
+boost::mutex s_pendingWritesMutex;
+std::map<std::string, PendingWrite> s_pendingWrites;
+
+// serializes the writes themselves so flushes of successive versions
+// of the same document can't interleave
+boost::mutex s_flushMutex;
+
+Error writePendingWrite(const FilePath& propertiesPath,
+                        const PendingWrite& write)
+{
+   if (write.hasContents)
+   {
+      FilePath contentsPath(propertiesPath.getAbsolutePath() +
+                            kContentsSuffix);
+      Error error = writeStringToFile(contentsPath, write.contents);
+      if (error)
+         return error;
+   }
+
+   return writeStringToFile(propertiesPath, write.properties);
+}
+
+void flushPendingWrite(const std::string& propertiesPath)
+{
+   LOCK_MUTEX(s_flushMutex)
+   {
+      // take the most recent payload for this document (a put which
+      // arrives while we write will be flushed by its own task)
+      PendingWrite write;
+      bool hasWrite = false;
+      LOCK_MUTEX(s_pendingWritesMutex)
+      {
+         std::map<std::string, PendingWrite>::iterator it =
+                                    s_pendingWrites.find(propertiesPath);
+         if (it != s_pendingWrites.end())
+         {
+            write = it->second;
+            s_pendingWrites.erase(it);
+            hasWrite = true;
+         }
+      }
+      END_LOCK_MUTEX
+
+      if (hasWrite)
+      {
+         Error error = writePendingWrite(FilePath(propertiesPath), write);
+         if (error)
+            LOG_ERROR(error);
+      }
+   }
+   END_LOCK_MUTEX
+}
+
+void flushAllPendingWrites()
+{
+   std::vector<std::string> paths;
+   LOCK_MUTEX(s_pendingWritesMutex)
+   {
+      for (std::map<std::string, PendingWrite>::const_iterator
+               it = s_pendingWrites.begin();
+           it != s_pendingWrites.end();
+           ++it)
+      {
+         paths.push_back(it->first);
+      }
+   }
+   END_LOCK_MUTEX
+
+   std::for_each(paths.begin(), paths.end(), flushPendingWrite);
+}
+
+void discardPendingWrite(const std::string& propertiesPath)
+{
+   // wait out any in-flight flush, then drop whatever is queued (used
+   // when a document is removed so a late flush can't resurrect it)
+   LOCK_MUTEX(s_flushMutex)
+   {
+      LOCK_MUTEX(s_pendingWritesMutex)
+      {
+         s_pendingWrites.erase(propertiesPath);
+      }
+      END_LOCK_MUTEX
+   }
+   END_LOCK_MUTEX
+}
+
+void discardAllPendingWrites()
+{
+   LOCK_MUTEX(s_flushMutex)
+   {
+      LOCK_MUTEX(s_pendingWritesMutex)
+      {
+         s_pendingWrites.clear();
+      }
+      END_LOCK_MUTEX
+   }
+   END_LOCK_MUTEX
+}
+
 }  // anonymous namespace
 
 SourceDocument::SourceDocument(const std::string& type)
@@ -319,14 +582,43 @@ bool SourceDocument::isUntitled() const
    return path().empty() && !getProperty("tempName").empty();
 }
 
+const std::string& SourceDocument::contents() const
+{
+   // bounded memory mode: materialize deferred contents on access
+   if (!lazyContentsPath_.empty())
+   {
+      if (!lazyContents_)
+      {
+         lazyContents_ = contents_cache::contentsForDocument(
+                                             id_, lazyContentsPath_);
+      }
+      if (lazyContents_)
+         return *lazyContents_;
+   }
+   return contents_;
+}
+
 // set contents from string
 void SourceDocument::setContents(const std::string& contents)
 {
+   // inline contents supersede any deferred contents
+   lazyContentsPath_.clear();
+   lazyContents_.reset();
+
    contents_ = contents;
-   hash_ = hash::crc32Hash(contents_);
+   hash_ = hash::hash64Hash(contents_);
    lastContentUpdate_ = static_cast<std::time_t>(date_time::millisecondsSinceEpoch());
 }
 
+void SourceDocument::setLazyContents(const std::string& contentsPath,
+                                     const std::string& hash)
+{
+   contents_.clear();
+   lazyContentsPath_ = contentsPath;
+   lazyContents_.reset();
+   hash_ = hash;
+}
+
 // set contents from file
 Error SourceDocument::setPathAndContents(const std::string& path,
                                          bool allowSubstChars)
@@ -367,8 +659,8 @@ Error SourceDocument::contentsMatchDisk(bool *pMatches)
       if (error)
          return error;
 
-      *pMatches = contents_.length() == contents.length() && 
-                  hash_ == hash::crc32Hash(contents);
+      *pMatches = this->contents().length() == contents.length() &&
+                  hash_ == hash::hash64Hash(contents);
    }
 
    return Success();
@@ -378,7 +670,7 @@ Error SourceDocument::updateDirty()
 {
    if (path().empty())
    {
-      dirty_ = !contents_.empty();
+      dirty_ = !contents().empty();
    }
    else if (dirty_)
    {
@@ -566,7 +858,7 @@ Error SourceDocument::writeToFile(const FilePath& filePath, bool writeContents)
    if (writeContents)
    {
       FilePath contentsPath(filePath.getAbsolutePath() + kContentsSuffix);
-      Error error = writeStringToFile(contentsPath, contents_);
+      Error error = writeStringToFile(contentsPath, contents());
       if (error)
          return error;
    }
@@ -626,14 +918,29 @@ Error get(const std::string& id, boost::shared_ptr<SourceDocument> pDoc)
    
 Error get(const std::string& id, bool includeContents, boost::shared_ptr<SourceDocument> pDoc)
 {
+   // attribute document storage to the source database
+   static int s_allocTag = allocation_tracker::registerTag("source_database");
+   allocation_tracker::Scope allocScope(s_allocTag);
+
    FilePath propertiesPath = source_database::path().completePath(id);
-   
-   // attempt to read file contents from sidecar file if available
+
+   // ensure any queued write of this document reaches disk first
+   flushPendingWrite(propertiesPath.getAbsolutePath());
+
+   // attempt to read file contents from sidecar file if available; in
+   // bounded memory mode large contents are deferred and materialized
+   // from the sidecar file on access instead
    std::string contents;
-   if (includeContents)
+   bool deferContents = false;
+   FilePath contentsPath(propertiesPath.getAbsolutePath() + kContentsSuffix);
+   if (includeContents && contentsPath.exists())
    {
-      FilePath contentsPath(propertiesPath.getAbsolutePath() + kContentsSuffix);
-      if (contentsPath.exists())
+      if (contents_cache::enabled() &&
+          contentsPath.getSize() > contents_cache::kLazyThreshold)
+      {
+         deferContents = true;
+      }
+      else
       {
          Error error = readStringFromFile(contentsPath,
                                           &contents,
@@ -675,8 +982,24 @@ Error get(const std::string& id, bool includeContents, boost::shared_ptr<SourceD
       
       if (jsonDoc.find("contents") == jsonDoc.end())
          jsonDoc["contents"] = std::string();
-      
-      return pDoc->readFromJson(&jsonDoc);
+
+      error = pDoc->readFromJson(&jsonDoc);
+      if (error)
+         return error;
+
+      // defer contents to the sidecar file, restoring the hash from the
+      // persisted properties (readFromJson computed it over the empty
+      // inline contents)
+      if (deferContents)
+      {
+         std::string hash;
+         json::Object::Iterator hashIt = jsonDoc.find("hash");
+         if (hashIt != jsonDoc.end() && (*hashIt).getValue().isString())
+            hash = (*hashIt).getValue().getString();
+         pDoc->setLazyContents(contentsPath.getAbsolutePath(), hash);
+      }
+
+      return Success();
    }
    else
    {
@@ -776,36 +1099,104 @@ bool isSafeSourceDocument(const FilePath& docDbPath,
 }
 
 
+namespace {
+
+// state shared by the parallel document reads in list()
+struct ParallelListState
+{
+   explicit ParallelListState(std::size_t n)
+      : docs(n), errors(n), remaining(static_cast<int>(n))
+   {
+   }
+
+   std::vector<boost::shared_ptr<SourceDocument> > docs;
+   std::vector<Error> errors;
+   boost::mutex mutex;
+   boost::condition_variable allDone;
+   int remaining;
+};
+
+void readDocumentForList(boost::shared_ptr<ParallelListState> pState,
+                         std::size_t index,
+                         const std::string& id)
+{
+   boost::shared_ptr<SourceDocument> pDoc(new SourceDocument());
+   Error error = source_database::get(id, pDoc);
+
+   boost::unique_lock<boost::mutex> lock(pState->mutex);
+   if (error)
+      pState->errors[index] = error;
+   else
+      pState->docs[index] = pDoc;
+   if (--pState->remaining == 0)
+      pState->allDone.notify_one();
+}
+
+} // anonymous namespace
+
 Error list(std::vector<boost::shared_ptr<SourceDocument> >* pDocs)
 {
+   // documents put but not yet flushed may have no file at all yet
+   flushAllPendingWrites();
+
    std::vector<FilePath> files;
    Error error = source_database::path().getChildren(files);
    if (error)
       return error;
-   
+
+   // collect document files
+   std::vector<FilePath> docFiles;
    for (FilePath& filePath : files)
    {
       if (isSourceDocument(filePath))
+         docFiles.push_back(filePath);
+   }
+
+   if (docFiles.empty())
+      return Success();
+
+   // read the documents on the shared background pool: session restore
+   // with many open tabs is dominated by serial per-file read latency
+   // (painfully so on network storage), and the reads are independent.
+   // results are collected back in enumeration order
+   boost::shared_ptr<ParallelListState> pState(
+            new ParallelListState(docFiles.size()));
+   for (std::size_t i = 0; i < docFiles.size(); i++)
+   {
+      core::thread::backgroundThreadPool().enque(
+               boost::bind(readDocumentForList,
+                           pState,
+                           i,
+                           docFiles[i].getFilename()));
+   }
+
+   // wait for all reads to complete
+   boost::unique_lock<boost::mutex> lock(pState->mutex);
+   while (pState->remaining > 0)
+      pState->allDone.wait(lock);
+
+   for (std::size_t i = 0; i < docFiles.size(); i++)
+   {
+      if (pState->errors[i])
       {
-         // get the source doc
-         boost::shared_ptr<SourceDocument> pDoc(new SourceDocument());
-         Error error = source_database::get(filePath.getFilename(), pDoc);
-         if (!error)
-         {
-            // safety filter
-            if (isSafeSourceDocument(filePath, pDoc))
-               pDocs->push_back(pDoc);
-         }
-         else
-            LOG_ERROR(error);
+         LOG_ERROR(pState->errors[i]);
+      }
+      else if (pState->docs[i])
+      {
+         // safety filter
+         if (isSafeSourceDocument(docFiles[i], pState->docs[i]))
+            pDocs->push_back(pState->docs[i]);
       }
    }
-   
+
    return Success();
 }
 
 Error list(std::vector<FilePath>* pPaths)
 {
+   // documents put but not yet flushed may have no file at all yet
+   flushAllPendingWrites();
+
    // list children
    std::vector<FilePath> children;
    Error error = source_database::path().getChildren(children);
@@ -823,17 +1214,41 @@ Error list(std::vector<FilePath>* pPaths)
 }
    
 Error put(boost::shared_ptr<SourceDocument> pDoc, bool writeContents)
-{   
-   // write to file
+{
+   // attribute document storage to the source database
+   static int s_allocTag = allocation_tracker::registerTag("source_database");
+   allocation_tracker::Scope allocScope(s_allocTag);
+
+   // capture the serialized document and queue the disk write on the
+   // background pool (readers flush before reading, so the deferral is
+   // invisible to them; write errors are logged when the flush runs)
    FilePath filePath = source_database::path().completePath(pDoc->id());
-   Error error = pDoc->writeToFile(filePath, writeContents);
-   if (error)
-      return error;
+
+   PendingWrite write;
+   write.hasContents = writeContents;
+   if (writeContents)
+      write.contents = pDoc->contents();
+
+   json::Object jsonProperties;
+   pDoc->writeToJson(&jsonProperties, false);
+   write.properties = jsonProperties.writeFormatted();
+
+   LOCK_MUTEX(s_pendingWritesMutex)
+   {
+      s_pendingWrites[filePath.getAbsolutePath()] = write;
+   }
+   END_LOCK_MUTEX
+
+   core::thread::backgroundThreadPool().enque(
+            boost::bind(flushPendingWrite, filePath.getAbsolutePath()));
+
+   // drop any cached materialization (contents may have changed)
+   contents_cache::invalidate(pDoc->id());
 
    // write properties to durable storage (if there is a path)
    if (!pDoc->path().empty())
    {
-      error = putProperties(pDoc->path(), pDoc->properties());
+      Error error = putProperties(pDoc->path(), pDoc->properties());
       if (error)
          LOG_ERROR(error);
    }
@@ -843,11 +1258,16 @@ Error put(boost::shared_ptr<SourceDocument> pDoc, bool writeContents)
    
 Error remove(const std::string& id)
 {
-   return source_database::path().completePath(id).removeIfExists();
+   FilePath filePath = source_database::path().completePath(id);
+   discardPendingWrite(filePath.getAbsolutePath());
+   contents_cache::invalidate(id);
+   return filePath.removeIfExists();
 }
-   
+
 Error removeAll()
 {
+   discardAllPendingWrites();
+
    std::vector<FilePath> files;
    Error error = source_database::path().getChildren(files);
    if (error)
@@ -945,6 +1365,9 @@ namespace {
 
 void onQuit()
 {
+   // the supervisor is about to copy/move the database directory
+   flushAllPendingWrites();
+
    Error error = supervisor::saveMostRecentDocuments();
    if (error)
       LOG_ERROR(error);
@@ -956,6 +1379,7 @@ void onQuit()
 
 void onSuspend(const r::session::RSuspendOptions& options, core::Settings*)
 {
+   flushAllPendingWrites();
    supervisor::suspendSourceDatabase(options.status);
 }
 
@@ -16,10 +16,29 @@
 #include <cstdlib>
 #include <signal.h>
 
+#ifdef __GLIBC__
+# include <malloc.h>
+#endif
+
+#ifdef __linux__
+# include <unistd.h>
+#endif
+
+#include <sstream>
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include <core/FileSerializer.hpp>
+#include <core/Log.hpp>
+#include <shared_core/SafeConvert.hpp>
+
+#include <core/system/Environment.hpp>
+
 #include "SessionSuspend.hpp"
 #include "SessionConsoleInput.hpp"
 
 #include <session/SessionConstants.hpp>
+#include <session/SessionModuleContext.hpp>
 #include <session/SessionOptions.hpp>
 #include <session/SessionConstants.hpp>
 
@@ -41,6 +60,38 @@ bool s_suspendedFromTimeout = false;
 // was the underlying r session resumed
 bool s_rSessionResumed = false;
 
+// idle memory trimming state
+boost::posix_time::ptime s_lastActivityTime;
+bool s_trimPerformed = false;
+
+// idle threshold (seconds) before a trim; 0 disables
+int idleTrimSeconds()
+{
+   static int s_seconds = core::safe_convert::stringTo<int>(
+            core::system::getenv("RSTUDIO_IDLE_TRIM_SECONDS"), 300);
+   return s_seconds;
+}
+
+// current resident set size in KB (0 where unavailable)
+long residentSizeKb()
+{
+#ifdef __linux__
+   std::string statm;
+   core::Error error = core::readStringFromFile(
+            core::FilePath("/proc/self/statm"), &statm);
+   if (error)
+      return 0;
+
+   // second field is resident pages
+   std::istringstream istr(statm);
+   long size = 0, resident = 0;
+   istr >> size >> resident;
+   return resident * (::sysconf(_SC_PAGESIZE) / 1024);
+#else
+   return 0;
+#endif
+}
+
 } // anonymous namespace
 
 // convenience function for disallowing suspend (note still doesn't override
@@ -152,10 +203,69 @@ void handleUSR2(int unused)
       rstudio::r::exec::setInterruptsPending(true);
    }
 
-   // note that a suspend is being forced. 
+   // note that a suspend is being forced.
    s_forceSuspend = 1;
 }
 
+void noteClientActivity()
+{
+   s_lastActivityTime = boost::posix_time::microsec_clock::universal_time();
+   s_trimPerformed = false;
+}
+
+void checkForIdleTrim()
+{
+   int thresholdSeconds = idleTrimSeconds();
+   if (thresholdSeconds <= 0)
+      return;
+
+   // R executing counts as activity (a long computation isn't idle)
+   if (console_input::executing())
+   {
+      noteClientActivity();
+      return;
+   }
+
+   using namespace boost::posix_time;
+   ptime now = microsec_clock::universal_time();
+
+   // first call establishes the baseline
+   if (s_lastActivityTime.is_not_a_date_time())
+   {
+      s_lastActivityTime = now;
+      return;
+   }
+
+   // trim at most once per idle period (activity re-arms it)
+   if (s_trimPerformed)
+      return;
+
+   if (now < s_lastActivityTime + seconds(thresholdSeconds))
+      return;
+
+   s_trimPerformed = true;
+
+   long beforeKb = residentSizeKb();
+
+   // give modules a chance to drop rebuildable caches (parse/lint caches,
+   // token caches, search indexes, ...)
+   module_context::events().onMemoryTrim();
+
+#ifdef __GLIBC__
+   // return freed heap pages to the OS
+   ::malloc_trim(0);
+#endif
+
+   long afterKb = residentSizeKb();
+   long savedKb = beforeKb - afterKb;
+
+   LOG_INFO_MESSAGE("idle memory trim: " +
+                    core::safe_convert::numberToString(beforeKb) + "KB -> " +
+                    core::safe_convert::numberToString(afterKb) + "KB (" +
+                    core::safe_convert::numberToString(savedKb) +
+                    "KB released)");
+}
+
 } // namespace suspend
 } // namespace session
 } // namespace rstudio
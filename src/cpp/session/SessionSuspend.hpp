@@ -29,6 +29,13 @@ void setSuspendedFromTimeout(bool suspended);
 bool sessionResumed();
 void setSessionResumed(bool resumed);
 
+// idle memory trimming: a lighter tier than a full suspend. activity
+// resets the idle clock; once the session has been idle for the trim
+// threshold, rebuildable caches are dropped (via the onMemoryTrim module
+// event) and free heap pages are returned to the OS
+void noteClientActivity();
+void checkForIdleTrim();
+
 } // namespace suspend
 } // namespace session
 } // namespace rstudio
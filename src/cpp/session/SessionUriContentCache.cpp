@@ -0,0 +1,203 @@
+/*
+ * SessionUriContentCache.cpp
+ *
+ * Copyright (C) 2020 by RStudio, PBC
+ *
+ * Unless you have received this program directly from RStudio pursuant
+ * to the terms of a commercial license agreement with RStudio, then
+ * this program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ *
+ */
+
+#include <session/SessionUriContentCache.hpp>
+
+#include <ctime>
+#include <list>
+#include <map>
+#include <vector>
+
+#include <boost/thread/mutex.hpp>
+
+#include <shared_core/Error.hpp>
+#include <shared_core/FilePath.hpp>
+
+#include <core/FileSerializer.hpp>
+#include <core/Thread.hpp>
+#include <core/zlib/zlib.hpp>
+
+using namespace rstudio::core;
+
+namespace rstudio {
+namespace session {
+namespace content_cache {
+
+namespace {
+
+// don't cache files larger than this (they are unlikely to be served
+// repeatedly enough to justify the memory)
+const std::size_t kMaxEntrySize = 512 * 1024;
+
+// total bytes of cached (stored) content to retain
+const std::size_t kMaxCacheBytes = 4 * 1024 * 1024;
+
+struct Entry
+{
+   std::string path;
+   std::time_t lastWriteTime;
+   uintmax_t size;
+   bool compressed;
+   std::vector<unsigned char> data;
+};
+
+// LRU list (most recently used at the front) plus an index by path;
+// handlers can run off the main thread so access is mutex protected
+typedef std::list<Entry> EntryList;
+boost::mutex s_mutex;
+EntryList s_entries;
+std::map<std::string, EntryList::iterator> s_index;
+std::size_t s_cacheBytes = 0;
+
+void removeEntry(const EntryList::iterator& it)
+{
+   s_cacheBytes -= it->data.size();
+   s_index.erase(it->path);
+   s_entries.erase(it);
+}
+
+void insertEntry(Entry& entry)
+{
+   // evict least recently used entries until the new one fits
+   while (!s_entries.empty() &&
+          (s_cacheBytes + entry.data.size()) > kMaxCacheBytes)
+   {
+      removeEntry(--s_entries.end());
+   }
+
+   s_cacheBytes += entry.data.size();
+   s_entries.push_front(Entry());
+   s_entries.front().path.swap(entry.path);
+   s_entries.front().lastWriteTime = entry.lastWriteTime;
+   s_entries.front().size = entry.size;
+   s_entries.front().compressed = entry.compressed;
+   s_entries.front().data.swap(entry.data);
+   s_index[s_entries.front().path] = s_entries.begin();
+}
+
+// returns true and fills pContents on a hit; stale entries are removed
+bool lookup(const std::string& path,
+            std::time_t lastWriteTime,
+            uintmax_t size,
+            std::string* pContents)
+{
+   LOCK_MUTEX(s_mutex)
+   {
+      std::map<std::string, EntryList::iterator>::iterator indexIt =
+                                                         s_index.find(path);
+      if (indexIt == s_index.end())
+         return false;
+
+      EntryList::iterator it = indexIt->second;
+      if (it->lastWriteTime != lastWriteTime || it->size != size)
+      {
+         // file changed on disk -- discard the stale entry
+         removeEntry(it);
+         return false;
+      }
+
+      // move to the front of the LRU list
+      s_entries.splice(s_entries.begin(), s_entries, it);
+
+      if (it->compressed)
+      {
+         Error error = zlib::decompressString(it->data, pContents);
+         if (error)
+         {
+            // corrupt entry -- drop it and fall back to the disk read
+            LOG_ERROR(error);
+            removeEntry(it);
+            return false;
+         }
+      }
+      else
+      {
+         pContents->assign(it->data.begin(), it->data.end());
+      }
+
+      return true;
+   }
+   END_LOCK_MUTEX
+
+   return false;
+}
+
+void store(const std::string& path,
+           std::time_t lastWriteTime,
+           uintmax_t size,
+           const std::string& contents)
+{
+   Entry entry;
+   entry.path = path;
+   entry.lastWriteTime = lastWriteTime;
+   entry.size = size;
+
+   // store compressed only when compression actually saves space (it
+   // won't for e.g. png plot thumbnails, which are already compressed)
+   std::vector<unsigned char> compressedData;
+   Error error = zlib::compressString(contents, &compressedData);
+   if (!error && compressedData.size() < contents.size())
+   {
+      entry.compressed = true;
+      entry.data.swap(compressedData);
+   }
+   else
+   {
+      entry.compressed = false;
+      entry.data.assign(contents.begin(), contents.end());
+   }
+
+   LOCK_MUTEX(s_mutex)
+   {
+      // another thread may have raced us here -- replace any entry it added
+      std::map<std::string, EntryList::iterator>::iterator indexIt =
+                                                         s_index.find(path);
+      if (indexIt != s_index.end())
+         removeEntry(indexIt->second);
+
+      insertEntry(entry);
+   }
+   END_LOCK_MUTEX
+}
+
+} // anonymous namespace
+
+Error readCachedFile(const FilePath& filePath, std::string* pContents)
+{
+   // stat the file up front -- both to key/revalidate the cache and so
+   // that a removed file produces the same error a direct read would
+   if (!filePath.exists())
+      return fileNotFoundError(filePath, ERROR_LOCATION);
+
+   uintmax_t size = filePath.getSize();
+   if (size > kMaxEntrySize)
+      return core::readStringFromFile(filePath, pContents);
+
+   std::string path = filePath.getAbsolutePath();
+   std::time_t lastWriteTime = filePath.getLastWriteTime();
+   if (lookup(path, lastWriteTime, size, pContents))
+      return Success();
+
+   Error error = core::readStringFromFile(filePath, pContents);
+   if (error)
+      return error;
+
+   store(path, lastWriteTime, size, *pContents);
+   return Success();
+}
+
+} // namespace content_cache
+} // namespace session
+} // namespace rstudio
@@ -17,6 +17,7 @@
 #define SESSION_HTTP_CONNECTION_IMPL_HPP
 
 
+#include <boost/algorithm/string/predicate.hpp>
 #include <boost/array.hpp>
 
 #include <boost/utility.hpp>
@@ -102,10 +103,27 @@ public:
             return;
          }
 
+         // keep the connection open for another request when the client
+         // asked for keep-alive (the server session proxy does so for
+         // its pooled connections). this requires a content length so
+         // the client can find the end of the body without a close
+         bool keepAlive =
+               response.containsHeader("Content-Length") &&
+               boost::algorithm::iequals(request_.headerValue("Connection"),
+                                         "keep-alive");
+
          // write the non streaming response
          boost::asio::write(socket_,
                             response.toBuffers(
+                               keepAlive ?
+                                  core::http::Header::connectionKeepAlive() :
                                   core::http::Header::connectionClose()));
+
+         if (keepAlive)
+         {
+            startNextRequest();
+            return;
+         }
       }
       catch(const boost::system::system_error& e)
       {
@@ -172,6 +190,17 @@ public:
 
 private:
 
+   // reset per-request state and resume reading on the same socket
+   // (used after a keep-alive response). the connection stays alive
+   // until the peer closes or another complete request arrives
+   void startNextRequest()
+   {
+      requestParser_.reset();
+      request_.assign(core::http::Request());
+      requestId_.clear();
+      readSome();
+   }
+
    // async request reading interface
    void readSome()
    {
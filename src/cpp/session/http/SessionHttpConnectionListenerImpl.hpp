@@ -319,6 +319,11 @@ private:
       if (connection::checkForInterrupt(ptrHttpConnection))
          return;
 
+      // rpc methods declared read-only are executed on a worker thread so
+      // they never queue behind long-running work on the main thread
+      if (connection::checkForOffloadRpc(ptrHttpConnection))
+         return;
+
       // place the connection on the correct queue
       if (connection::isGetEvents(ptrHttpConnection))
          eventsConnectionQueue_.enqueConnection(ptrHttpConnection);
@@ -52,6 +52,13 @@ bool checkForSuspend(boost::shared_ptr<HttpConnection> ptrConnection);
 
 bool checkForInterrupt(boost::shared_ptr<HttpConnection> ptrConnection);
 
+// offer the connection to the read-only rpc offload lane; returns true if
+// it was claimed for execution on the offload worker thread. the method
+// registry lives alongside the other rpc registration machinery, so this
+// is implemented in SessionRpc.cpp (methods opt in via
+// module_context::registerOffloadRpcMethod)
+bool checkForOffloadRpc(boost::shared_ptr<HttpConnection> ptrConnection);
+
 bool authenticate(boost::shared_ptr<HttpConnection> ptrConnection,
                   const std::string& secret);
 
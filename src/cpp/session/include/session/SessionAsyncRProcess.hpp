@@ -89,6 +89,7 @@ protected:
 
 private:
    void onProcessCompleted(int exitStatus);
+   bool serveIpcRequest();
    bool isRunning_;
    bool terminationRequested_;
    std::string input_;
@@ -41,7 +41,10 @@ ClientEventService& clientEventService();
 class ClientEventService : boost::noncopyable
 {
 private:
-   ClientEventService() {}
+   ClientEventService()
+      : eventSocketConnected_(false), lastAckedEventId_(-1)
+   {
+   }
    friend ClientEventService& clientEventService();
 
 public:
@@ -49,11 +52,18 @@ public:
 
    core::Error start(const std::string& clientId);
    void stop();
-   
+
    void setClientId(const std::string& clientId, bool clearEvents);
 
    std::string clientId();
 
+   // start the websocket event channel for the current client and return
+   // the port the client should connect to. events are pushed over the
+   // socket once a client attaches; long-polling continues to work at all
+   // times so clients which can't establish the socket (or lose it) fall
+   // back automatically
+   core::Error startEventSocket(int* pPort);
+
 private:
    void run();
 
@@ -61,14 +71,27 @@ private:
    bool havePendingClientEvents();
    void addClientEvent(const core::json::Object& eventObject);
    void setClientEventResult(core::json::JsonRpcResponse* pResponse);
+   std::string clientEventsAsBinaryFrames();
+
+   // websocket event channel helpers (callbacks can arrive on the
+   // websocket servicing thread)
+   void onEventSocketAck(const std::string& input);
+   void onEventSocketOpened();
+   void onEventSocketClosed();
+   bool eventSocketConnected();
+   int lastAckedEventId();
+   core::Error sendEventsOverSocket();
 
-  
 private:
    boost::mutex mutex_;
    boost::thread serviceThread_;
 
    std::string clientId_;
    core::json::Array clientEvents_;
+
+   std::string eventSocketHandle_;
+   bool eventSocketConnected_;
+   int lastAckedEventId_;
 };
    
   
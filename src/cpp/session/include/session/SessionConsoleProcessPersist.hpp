@@ -47,9 +47,15 @@ std::string getSavedBuffer(const std::string& handle, int maxLines);
 // buffer will be trimmed to max number of lines and rewritten.
 int getSavedBufferLineCount(const std::string& handle, int maxLines);
 
-// Add to the saved buffer for the given ConsoleProcess
+// Add to the saved buffer for the given ConsoleProcess. Output is batched
+// in memory and written out asynchronously from the terminal's point of
+// view; call flushOutputBuffers to force everything to disk.
 void appendToOutputBuffer(const std::string& handle, const std::string& buffer);
 
+// Write any batched terminal output to the buffer files (also happens
+// automatically when buffers are read, deleted, or metadata is saved)
+void flushOutputBuffers();
+
 // Delete the persisted saved buffer for the given ConsoleProcess
 void deleteLogFile(const std::string& handle, bool lastLineOnly = false);
 
@@ -17,6 +17,7 @@
 #ifndef SESSION_MODULE_CONTEXT_HPP
 #define SESSION_MODULE_CONTEXT_HPP
 
+#include <atomic>
 #include <string>
 
 #include <boost/utility.hpp>
@@ -231,8 +232,86 @@ core::Error registerIdleOnlyAsyncRpcMethod(
 core::Error registerRpcMethod(const std::string& name,
                               const core::json::JsonRpcFunction& function);
 
+// register an rpc method which is read-only -- i.e. touches neither the R
+// interpreter nor other main-thread-only state -- and can therefore be
+// executed on a worker thread, without queueing behind whatever the main
+// thread is currently busy with
+core::Error registerOffloadRpcMethod(
+                              const std::string& name,
+                              const core::json::JsonRpcFunction& function);
+
+// token observed by a preemptible rpc method while it runs. the client
+// addresses it by handle (passed in the request as the "preempt_handle"
+// kwparam); the cancel_rpc method trips the token from the offload worker,
+// so cancellation is serviced even while the main thread is busy executing
+// the method being cancelled
+class PreemptibleRpcToken : boost::noncopyable
+{
+public:
+   // clientSupplied indicates whether the handle came from the request;
+   // progress and partial result events are only emitted for handles the
+   // client knows about (callers that don't opt in just see the method
+   // run to completion, as it always did)
+   PreemptibleRpcToken(const std::string& handle, bool clientSupplied)
+      : handle_(handle), clientSupplied_(clientSupplied), cancelled_(false)
+   {
+   }
+
+   const std::string& handle() const { return handle_; }
+
+   // poll between units of work; when true, stop working and return
+   // whatever has been accumulated so far
+   bool cancelled() const { return cancelled_; }
+   void cancel() { cancelled_ = true; }
+
+   // stream a partial page of results to the client (delivered as a
+   // preemptible_rpc_partial_results event carrying the handle)
+   void reportPartialResults(const core::json::Value& results) const;
+
+   // report progress to the client (units completed out of a total;
+   // pass a total of 0 when the amount of work isn't known up front)
+   void reportProgress(int units, int totalUnits = 0) const;
+
+private:
+   std::string handle_;
+   bool clientSupplied_;
+   std::atomic<bool> cancelled_;
+};
+
+typedef boost::function<core::Error(const core::json::JsonRpcRequest&,
+                                    const PreemptibleRpcToken&,
+                                    core::json::JsonRpcResponse*)>
+                                                   PreemptibleRpcFunction;
+
+// register a long-running rpc method as preemptible: the method receives a
+// token it can poll for client-requested cancellation and use to stream
+// progress and partial result pages, so abandoned requests stop consuming
+// session cpu instead of running to completion
+core::Error registerPreemptibleRpcMethod(
+                              const std::string& name,
+                              const PreemptibleRpcFunction& function);
+
 void registerRpcMethod(const core::json::JsonRpcAsyncMethod& method);
 
+// Lazy module initialization. Rarely used modules can defer full
+// initialization until first use: declare the rpc methods and uri prefixes
+// the module owns along with its initialize function, and the dispatch
+// layers will run the initialize (exactly once) the first time one of them
+// is requested. Only suitable for modules whose initialize does nothing
+// but register handlers -- modules that subscribe to events, add suspend
+// handlers, or source R files needed by other code must stay eager.
+core::Error registerLazyModule(
+      const std::string& name,
+      const std::vector<std::string>& rpcMethods,
+      const std::vector<std::string>& uriPrefixes,
+      const boost::function<core::Error()>& initFunction);
+
+// run the initializer of any lazy module owning the given rpc method or
+// uri (no-op when none matches); called by the dispatch layers before
+// handler lookup
+void ensureLazyModuleForRpc(const std::string& method);
+void ensureLazyModuleForUri(const std::string& uri);
+
 core::Error executeAsync(const core::json::JsonRpcFunction& function,
                          const core::json::JsonRpcRequest& request,
                          core::json::JsonRpcResponse* pResponse);
@@ -340,6 +419,7 @@ struct Events : boost::noncopyable
    RSTUDIO_BOOST_SIGNAL<void(bool)>                 onDeferredInit;
    RSTUDIO_BOOST_SIGNAL<void(bool)>                 afterSessionInitHook;
    RSTUDIO_BOOST_SIGNAL<void(bool)>                 onBackgroundProcessing;
+   RSTUDIO_BOOST_SIGNAL<void ()>                    onMemoryTrim;
    RSTUDIO_BOOST_SIGNAL<void(bool)>                 onShutdown;
    RSTUDIO_BOOST_SIGNAL<void ()>                    onQuit;
    RSTUDIO_BOOST_SIGNAL<void ()>                    onDestroyed;
@@ -217,6 +217,9 @@ protected:
       ("allow-terminal-websockets",
       value<bool>(&allowTerminalWebsockets_)->default_value(true),
       "Indicates whether or not to allow connections to terminal sessions with websockets.")
+      ("allow-event-websockets",
+      value<bool>(&allowEventWebsockets_)->default_value(true),
+      "Indicates whether or not to allow delivery of client events with websockets.")
       ("allow-file-downloads",
       value<bool>(&allowFileDownloads_)->default_value(true),
       "Indicates whether or not to allow file downloads from the files pane.")
@@ -427,6 +430,7 @@ public:
    bool allowPackageInstallation() const { return allowPackageInstallation_; }
    bool allowShell() const { return allowShell_; }
    bool allowTerminalWebsockets() const { return allowTerminalWebsockets_; }
+   bool allowEventWebsockets() const { return allowEventWebsockets_; }
    bool allowFileDownloads() const { return allowFileDownloads_; }
    bool allowFileUploads() const { return allowFileUploads_; }
    bool allowRemovePublicFolder() const { return allowRemovePublicFolder_; }
@@ -521,6 +525,7 @@ protected:
    bool allowPackageInstallation_;
    bool allowShell_;
    bool allowTerminalWebsockets_;
+   bool allowEventWebsockets_;
    bool allowFileDownloads_;
    bool allowFileUploads_;
    bool allowRemovePublicFolder_;
@@ -87,15 +87,25 @@ private:
    void beginIndexing();
    bool work();
    void endIndexing();
-   
+
+   // fingerprint of the package directories on the current library
+   // paths (used to skip re-indexing when nothing has changed)
+   std::string libraryFingerprint(const std::vector<core::FilePath>& pkgDirs);
+   std::vector<core::FilePath> enumeratePackageDirs();
+
 private:
    std::vector<boost::shared_ptr<Worker> > workers_;
    std::vector<core::FilePath> pkgDirs_;
    core::json::Object payload_;
-   
+
    std::size_t index_;
    std::size_t n_;
    bool running_;
+
+   // fingerprints for the index currently being built and the last
+   // completed index
+   std::string pendingFingerprint_;
+   std::string indexedFingerprint_;
 };
 
 Indexer& indexer();
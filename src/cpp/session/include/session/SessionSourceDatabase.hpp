@@ -61,7 +61,7 @@ public:
    const std::string& id() const { return id_; }
    const std::string& path() const { return path_; }
    const std::string& type() const { return type_; }
-   const std::string& contents() const { return contents_; }
+   const std::string& contents() const;
    const std::string& hash() const { return hash_; }
    const std::string& encoding() const { return encoding_; }
    bool dirty() const { return dirty_; }
@@ -81,6 +81,13 @@ public:
    // set contents from string
    void setContents(const std::string& contents);
 
+   // defer contents to the on-disk sidecar file (bounded memory mode);
+   // contents() materializes them on access via the shared contents cache.
+   // the hash is restored from the persisted document properties so it
+   // remains valid without reading the contents
+   void setLazyContents(const std::string& contentsPath,
+                        const std::string& hash);
+
    // set contents from file
    core::Error setPathAndContents(const std::string& path,
                                   bool allowSubstChars = true);
@@ -173,6 +180,12 @@ private:
    std::string path_;
    std::string type_;
    std::string contents_;
+
+   // bounded memory mode: when set, contents live in the sidecar file at
+   // this path and are materialized (and LRU-cached) on first access
+   std::string lazyContentsPath_;
+   mutable boost::shared_ptr<const std::string> lazyContents_;
+
    std::string hash_;
    std::string encoding_;
    std::string folds_;
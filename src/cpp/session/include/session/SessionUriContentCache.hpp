@@ -0,0 +1,47 @@
+/*
+ * SessionUriContentCache.hpp
+ *
+ * Copyright (C) 2020 by RStudio, PBC
+ *
+ * Unless you have received this program directly from RStudio pursuant
+ * to the terms of a commercial license agreement with RStudio, then
+ * this program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ *
+ */
+
+#ifndef SESSION_SESSION_URI_CONTENT_CACHE_HPP
+#define SESSION_SESSION_URI_CONTENT_CACHE_HPP
+
+#include <string>
+
+namespace rstudio {
+namespace core {
+   class Error;
+   class FilePath;
+}
+}
+
+namespace rstudio {
+namespace session {
+namespace content_cache {
+
+// read a file through a small in-memory LRU shared by the session's uri
+// handlers (content urls, help pages, presentation assets, etc.). entries
+// are keyed by path and revalidated against the file's size and last
+// write time on every lookup, so a file modified on disk is re-read
+// transparently. cached bodies are stored zlib-compressed (when that
+// actually saves space) and the cache is bounded, so repeatedly served
+// content stops costing disk reads without growing session memory
+// unboundedly. files too large to be worth caching are read directly.
+core::Error readCachedFile(const core::FilePath& filePath,
+                           std::string* pContents);
+
+} // namespace content_cache
+} // namespace session
+} // namespace rstudio
+
+#endif // SESSION_SESSION_URI_CONTENT_CACHE_HPP
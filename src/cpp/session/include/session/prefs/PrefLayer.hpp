@@ -16,6 +16,8 @@
 #ifndef SESSION_PREF_LAYER_HPP
 #define SESSION_PREF_LAYER_HPP
 
+#include <set>
+
 #include <shared_core/json/Json.hpp>
 #include <core/json/JsonRpc.hpp>
 
@@ -46,6 +48,13 @@ public:
    virtual void destroy();
    std::string layerName();
 
+   // Batched updates: writes between beginBatch and endBatch update the
+   // in-memory cache immediately but defer the file serialization and
+   // change notifications until endBatch, so N writes cost a single
+   // serialization. Batches may nest; only the outermost endBatch commits.
+   void beginBatch();
+   core::Error endBatch();
+
    template<typename T> boost::optional<T> readPref(const std::string& name)
    {
       // Ensure we have a cache from which to read preferences
@@ -96,6 +105,14 @@ public:
             return error;
          }
          (*cache_)[name] = value;
+
+         if (batchDepth_ > 0)
+         {
+            // Inside a batch: defer the file write and the change
+            // notification until endBatch commits the batch
+            batchChanged_.insert(name);
+            return core::Success();
+         }
       }
       END_LOCK_MUTEX;
 
@@ -133,6 +150,11 @@ protected:
    // The name of this pref layer
    std::string layerName_;
 
+   // Batched update state: nesting depth and the values changed during
+   // the current batch (guarded by mutex_)
+   int batchDepth_;
+   std::set<std::string> batchChanged_;
+
 private:
    // File monitor event handlers
    boost::optional<core::system::file_monitor::Handle> handle_;
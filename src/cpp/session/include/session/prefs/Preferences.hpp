@@ -16,6 +16,9 @@
 #ifndef SESSION_PREFERENCES_HPP
 #define SESSION_PREFERENCES_HPP
 
+#include <map>
+#include <set>
+
 #include <shared_core/json/Json.hpp>
 
 #include <boost/range/adaptor/reversed.hpp>
@@ -48,15 +51,29 @@ public:
 
    template <typename T> T readPref(const std::string& name)
    {
-      // Work backwards through the layers, starting with the most specific (project or user-level
-      // settings) and working towards the most general (basic defaults)
       RECURSIVE_LOCK_MUTEX(mutex_)
       {
+         // Consult the resolved-value cache first so hot-path reads cost a
+         // single lookup instead of a walk across every layer
+         const auto cached = prefCache_.find(name);
+         if (cached != prefCache_.end() && core::json::isType<T>(cached->second))
+         {
+            return cached->second.getValue<T>();
+         }
+
+         // Work backwards through the layers, starting with the most specific (project or
+         // user-level settings) and working towards the most general (basic defaults)
          for (auto layer: boost::adaptors::reverse(layers_))
          {
             boost::optional<T> val = layer->readPref<T>(name);
             if (val)
             {
+               // Remember the resolved value for subsequent reads; the entry is
+               // invalidated whenever this pref changes in any layer
+               boost::optional<core::json::Value> jsonVal = layer->readValue(name);
+               if (jsonVal)
+                  prefCache_[name] = *jsonVal;
+
                return *val;
             }
          }
@@ -101,8 +118,20 @@ public:
    core::Error writeValue(const std::string& name, const core::json::Value& value);
    core::Error clearValue(const std::string& name);
 
+   // Write multiple preference values to the user layer as a single
+   // transaction: values that already match are skipped, the layer is
+   // serialized to disk once, and the names of the values actually
+   // changed are returned via pChanged (pass them to notifyClient to
+   // send the client a single aggregated update)
+   core::Error writeValues(const core::json::Object& values,
+                           std::set<std::string>* pChanged = nullptr);
+
    void notifyClient(const std::string& layer, const std::string& pref);
 
+   // Notify the client of a group of changed preferences with a single
+   // client event rather than one event per pref
+   void notifyClient(const std::string& layer, const std::set<std::string>& prefs);
+
    virtual core::Error createLayers() = 0;
    virtual int userLayer() = 0;
    virtual int clientChangedEvent() = 0;
@@ -117,6 +146,14 @@ protected:
    std::vector<boost::shared_ptr<PrefLayer>> layers_;
    boost::recursive_mutex mutex_;
    bool initialized_;
+
+private:
+   void invalidateCachedPref(const std::string& name);
+   void invalidateCachedPrefs();
+
+   // Cache of resolved preference values (what the layer walk would
+   // produce); guarded by mutex_ and invalidated on change
+   std::map<std::string, core::json::Value> prefCache_;
 };
 
 } // namespace prefs
@@ -242,6 +242,7 @@ namespace prefs {
 #define kTerminalRendererCanvas "canvas"
 #define kTerminalRendererDom "dom"
 #define kShowRmdRenderCommand "show_rmd_render_command"
+#define kRmdPreviewRenderCache "rmd_preview_render_cache"
 #define kEnableTextDrag "enable_text_drag"
 #define kShowHiddenFiles "show_hidden_files"
 #define kSortFileNamesNaturally "sort_file_names_naturally"
@@ -1187,6 +1188,12 @@ public:
    bool showRmdRenderCommand();
    core::Error setShowRmdRenderCommand(bool val);
 
+   /**
+    * Whether to cache chunk output across R Markdown preview renders so that unchanged chunks are not re-executed.
+    */
+   bool rmdPreviewRenderCache();
+   core::Error setRmdPreviewRenderCache(bool val);
+
    /**
     * Whether to enable moving text on the editing surface by clicking and dragging it.
     */
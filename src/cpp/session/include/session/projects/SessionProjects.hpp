@@ -218,11 +218,13 @@ private:
    // onMonitoringEnabled)
    void onDeferredInit(bool newSession);
 
-   // file monitor event handlers
+   // file monitor registration & event handlers
+   void startFileMonitor();
    void fileMonitorRegistered(core::system::file_monitor::Handle handle,
                               const tree<core::FileInfo>& files);
    void fileMonitorFilesChanged(
                    const std::vector<core::system::FileChangeEvent>& events);
+   void fileMonitorEventStorm();
    void fileMonitorTermination(const core::Error& error);
    bool fileMonitorFilter(const core::FileInfo& fileInfo,
                           const FileMonitorFilterContext& context) const;
@@ -254,6 +256,7 @@ private:
    bool isNewProject_;
 
    bool hasFileMonitor_;
+   core::system::file_monitor::Handle fileMonitorHandle_;
    std::vector<std::string> monitorSubscribers_;
    RSTUDIO_BOOST_SIGNAL<void(const tree<core::FileInfo>&)> onMonitoringEnabled_;
    RSTUDIO_BOOST_SIGNAL<void(const std::vector<core::system::FileChangeEvent>&)>
@@ -204,6 +204,11 @@ extern const int kTutorialCommand;
 extern const int kTutorialLaunch;
 extern const int kReticulateEvent;
 extern const int kEnvironmentChanged;
+extern const int kSessionStallDetected;
+extern const int kAsyncFileDeletionCompleted;
+extern const int kPreemptibleRpcProgress;
+extern const int kPreemptibleRpcPartialResults;
+extern const int kFileChangeset;
 }
    
 class ClientEvent
@@ -23,15 +23,19 @@
 #include <sstream>
 
 #include <shared_core/FilePath.hpp>
+#include <shared_core/SafeConvert.hpp>
 #include <shared_core/json/Json.hpp>
 #include <core/json/JsonRpc.hpp>
 #include <shared_core/Error.hpp>
+#include <core/FileSerializer.hpp>
 
 #include <boost/format.hpp>
 #include <boost/algorithm/string.hpp>
 
 #include <session/SessionModuleContext.hpp>
 
+#include "SessionLibPathsIndexer.hpp"
+
 #include <core/Macros.hpp>
 
 namespace rstudio {
@@ -140,6 +144,148 @@ bool fillFunctionInfo(const json::Object& functionObjectJson,
    
 }
 
+// populate the source index from a single package's information object
+// (the per-line payload produced by .rs.getPackageInformation)
+bool addPackageInformation(const json::Object& objectJson,
+                           std::string* pPackageName)
+{
+   json::Array exportsJson;
+   json::Array typesJson;
+   json::Object functionInfoJson;
+   json::Array datasetsJson;
+
+   core::r_util::PackageInformation pkgInfo;
+
+   Error error = json::readObject(objectJson,
+                                  "package", pkgInfo.package,
+                                  "exports", exportsJson,
+                                  "types", typesJson,
+                                  "function_info", functionInfoJson,
+                                  "datasets", datasetsJson);
+
+   if (error)
+   {
+      LOG_ERROR(error);
+      return false;
+   }
+
+   DEBUG("Adding entry for package: '" << pkgInfo.package << "'");
+
+   if (!exportsJson.toVectorString(pkgInfo.exports))
+      LOG_ERROR_MESSAGE("Failed to read JSON 'objects' array to vector");
+
+   if (!typesJson.toVectorInt(pkgInfo.types))
+      LOG_ERROR_MESSAGE("Failed to read JSON 'types' array to vector");
+
+   if (!fillFunctionInfo(functionInfoJson, pkgInfo.package, &(pkgInfo.functionInfo)))
+      LOG_ERROR_MESSAGE("Failed to read JSON 'functions' object to map");
+
+   if (!datasetsJson.toVectorString(pkgInfo.datasets))
+      LOG_ERROR_MESSAGE("Failed to read JSON 'data' array to vector");
+
+   // Update the index
+   core::r_util::RSourceIndex::addPackageInformation(pkgInfo.package, pkgInfo);
+
+   if (pPackageName != nullptr)
+      *pPackageName = pkgInfo.package;
+   return true;
+}
+
+// shared symbol database --------------------------------------------------
+//
+// deriving a package's exports and formals requires loading it in a child R
+// process, which makes the first lint after startup slow. since the results
+// only change when the installed package changes, each package's
+// information object is persisted (keyed by a fingerprint of the installed
+// package) in the user scratch path, where every session on the host can
+// map it read-only instead of re-deriving it
+
+FilePath packageSymbolCachePath()
+{
+   return module_context::userScratchPath().completeChildPath(
+            "package-symbol-db");
+}
+
+// fingerprint the installed copy of the package (library location plus
+// DESCRIPTION write time and size); a mismatch invalidates the cache entry
+std::string packageFingerprint(const std::string& pkgName)
+{
+   for (const FilePath& pkgPath : libpaths::getInstalledPackages())
+   {
+      if (pkgPath.getFilename() != pkgName)
+         continue;
+
+      FilePath descPath = pkgPath.completeChildPath("DESCRIPTION");
+      if (!descPath.exists())
+         continue;
+
+      return pkgPath.getAbsolutePath() + ":" +
+             safe_convert::numberToString(descPath.getLastWriteTime()) + ":" +
+             safe_convert::numberToString(descPath.getSize());
+   }
+   return std::string();
+}
+
+bool loadPackageInformationFromCache(const std::string& pkgName)
+{
+   FilePath cacheFile = packageSymbolCachePath().completeChildPath(
+            pkgName + ".json");
+   if (!cacheFile.exists())
+      return false;
+
+   std::string fingerprint = packageFingerprint(pkgName);
+   if (fingerprint.empty())
+      return false;
+
+   std::string contents;
+   Error error = core::readStringFromFile(cacheFile, &contents);
+   if (error)
+   {
+      LOG_ERROR(error);
+      return false;
+   }
+
+   json::Value value;
+   if (value.parse(contents) || !value.isObject())
+      return false;
+
+   std::string cachedFingerprint;
+   json::Object dataJson;
+   error = json::readObject(value.getObject(),
+                            "fingerprint", cachedFingerprint,
+                            "data", dataJson);
+   if (error || cachedFingerprint != fingerprint)
+      return false;
+
+   return addPackageInformation(dataJson, nullptr);
+}
+
+void writePackageSymbolCache(const std::string& pkgName,
+                             const json::Object& dataJson)
+{
+   std::string fingerprint = packageFingerprint(pkgName);
+   if (fingerprint.empty())
+      return;
+
+   FilePath cacheDir = packageSymbolCachePath();
+   Error error = cacheDir.ensureDirectory();
+   if (error)
+   {
+      LOG_ERROR(error);
+      return;
+   }
+
+   json::Object cacheJson;
+   cacheJson["fingerprint"] = fingerprint;
+   cacheJson["data"] = dataJson;
+
+   error = core::writeStringToFile(
+            cacheDir.completeChildPath(pkgName + ".json"),
+            cacheJson.write());
+   if (error)
+      LOG_ERROR(error);
+}
+
 } // anonymous namespace
 
 void AsyncPackageInformationProcess::onCompleted(int exitStatus)
@@ -176,25 +322,18 @@ void AsyncPackageInformationProcess::onCompleted(int exitStatus)
    // }
    for (std::size_t i = 0; i < n; ++i)
    {
-      json::Array exportsJson;
-      json::Array typesJson;
-      json::Object functionInfoJson;
-      json::Array datasetsJson;
-      
-      core::r_util::PackageInformation pkgInfo;
-
       if (splat[i].empty())
          continue;
-      
+
       // The lines we wish to parse should be prefixed with
       // the code '#!json: '.
       if (!boost::algorithm::starts_with(splat[i], "#!json: "))
          continue;
-      
+
       std::string line = splat[i].substr(::strlen("#!json: "));
-      
+
       json::Value value;
-      if (!value.parse(line))
+      if (value.parse(line))
       {
          std::string subset;
          if (splat[i].length() > 60)
@@ -205,41 +344,19 @@ void AsyncPackageInformationProcess::onCompleted(int exitStatus)
          LOG_ERROR_MESSAGE("Failed to parse JSON: '" + subset + "'");
          continue;
       }
-      
+
       // Ensure that this parsed as an Object -- this might have parsed as
       // something else if e.g. we got malformed output on load of a package
       if (!json::isType<json::Object>(value))
          continue;
-      
-      Error error = json::readObject(value.getObject(),
-                                     "package", pkgInfo.package,
-                                     "exports", exportsJson,
-                                     "types", typesJson,
-                                     "function_info", functionInfoJson,
-                                     "datasets", datasetsJson);
 
-      if (error)
-      {
-         LOG_ERROR(error);
+      std::string pkgName;
+      if (!addPackageInformation(value.getObject(), &pkgName))
          continue;
-      }
-
-      DEBUG("Adding entry for package: '" << pkgInfo.package << "'");
 
-      if (!exportsJson.toVectorString(pkgInfo.exports))
-         LOG_ERROR_MESSAGE("Failed to read JSON 'objects' array to vector");
-
-      if (!typesJson.toVectorInt(pkgInfo.types))
-         LOG_ERROR_MESSAGE("Failed to read JSON 'types' array to vector");
-
-      if (!fillFunctionInfo(functionInfoJson, pkgInfo.package, &(pkgInfo.functionInfo)))
-         LOG_ERROR_MESSAGE("Failed to read JSON 'functions' object to map");
-      
-      if (!datasetsJson.toVectorString(pkgInfo.datasets))
-         LOG_ERROR_MESSAGE("Failed to read JSON 'data' array to vector");
-      
-      // Update the index
-      core::r_util::RSourceIndex::addPackageInformation(pkgInfo.package, pkgInfo);
+      // persist to the shared symbol database so other sessions (and our
+      // own next start) can skip the child R process for this package
+      writePackageSymbolCache(pkgName, value.getObject());
    }
 
 }
@@ -257,7 +374,18 @@ void AsyncPackageInformationProcess::update()
    
    s_pkgsToUpdate_ =
       RSourceIndex::getAllUnindexedPackages();
-   
+
+   // satisfy what we can from the shared symbol database (populated by any
+   // prior session on this host); only packages with no entry, or a stale
+   // one, need the child R process
+   std::vector<std::string> uncached;
+   for (const std::string& pkg : s_pkgsToUpdate_)
+   {
+      if (!loadPackageInformationFromCache(pkg))
+         uncached.push_back(pkg);
+   }
+   s_pkgsToUpdate_ = uncached;
+
    // alias for readability
    const std::vector<std::string>& pkgs = s_pkgsToUpdate_;
    
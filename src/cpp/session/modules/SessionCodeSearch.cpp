@@ -18,18 +18,22 @@
 
 #include "SessionCodeSearch.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <vector>
 #include <set>
 #include <gsl/gsl>
 
 #include <boost/bind.hpp>
+#include <boost/cstdint.hpp>
 #include <boost/shared_ptr.hpp>
 #include <boost/foreach.hpp>
 #include <boost/format.hpp>
 #include <boost/regex.hpp>
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/algorithm/string/split.hpp>
+#include <boost/thread.hpp>
 
 #include <shared_core/Error.hpp>
 #include <shared_core/FilePath.hpp>
@@ -38,6 +42,7 @@
 #include <core/Debug.hpp>
 #include <core/FileSerializer.hpp>
 #include <core/Exec.hpp>
+#include <core/Thread.hpp>
 #include <core/collection/Tree.hpp>
 
 #include <core/r_util/RSourceIndex.hpp>
@@ -448,11 +453,47 @@ private:
    
 };
 
+// persistent source index cache -- maps absolute path to the index
+// persisted for it at the end of the previous session. populated once at
+// startup and treated as read-only thereafter, so indexing worker threads
+// can consult it without locking
+struct CachedSourceIndex
+{
+   CachedSourceIndex() : lastWriteTime(0) {}
+   std::time_t lastWriteTime;
+   boost::shared_ptr<core::r_util::RSourceIndex> pIndex;
+};
+typedef std::map<std::string, CachedSourceIndex> SourceIndexCache;
+SourceIndexCache s_sourceIndexCache;
+
+// return the previously persisted index for a file, or an empty pointer
+// if the file has been modified since the cache was written
+boost::shared_ptr<r_util::RSourceIndex> lookupCachedSourceIndex(
+                                             const FileInfo& fileInfo)
+{
+   SourceIndexCache::const_iterator it =
+         s_sourceIndexCache.find(fileInfo.absolutePath());
+   if (it != s_sourceIndexCache.end() &&
+       it->second.lastWriteTime == fileInfo.lastWriteTime())
+   {
+      return it->second.pIndex;
+   }
+   return boost::shared_ptr<r_util::RSourceIndex>();
+}
+
+// thresholds governing the parallel indexing engine. batches smaller than
+// the threshold aren't worth the thread startup cost; larger batches (e.g.
+// the initial scan of a big project) are sharded across the worker pool
+const std::size_t kParallelIndexingThreshold = 512;
+const std::size_t kMaxIndexingWorkers = 8;
+const std::size_t kMergeChunkSize = 200;
+
 class SourceFileIndex : boost::noncopyable
 {
 public:
    SourceFileIndex()
-      : pEntries_(new EntryTree()), indexing_(false)
+      : pEntries_(new EntryTree()), indexing_(false), activeWorkers_(0),
+        entriesVersion_(0)
    {
    }
 
@@ -478,6 +519,17 @@ public:
    template <typename ForwardIterator>
    void enqueFiles(ForwardIterator begin, ForwardIterator end)
    {
+      // for large batches (e.g. the initial project scan) shard the
+      // parsing work across background threads rather than nibbling at
+      // the queue in 20ms slices on the main thread
+      std::size_t numFiles = std::distance(begin, end);
+      if (numFiles >= kParallelIndexingThreshold &&
+          boost::thread::hardware_concurrency() > 1)
+      {
+         enqueFilesParallel(begin, end);
+         return;
+      }
+
       // add all files to the indexing queue
       using namespace rstudio::core::system;
       for ( ; begin != end; ++begin)
@@ -501,6 +553,47 @@ public:
       }
    }
 
+   template <typename ForwardIterator>
+   void enqueFilesParallel(ForwardIterator begin, ForwardIterator end)
+   {
+      // snapshot the file list and the default encoding up front (worker
+      // threads must not touch the project context)
+      std::vector<FileInfo> files(begin, end);
+      std::string encoding = projects::projectContext().defaultEncoding();
+
+      // shard the file list round-robin across the worker pool (this
+      // interleaves large and small files reasonably well without
+      // needing to stat everything up front)
+      std::size_t numWorkers = std::min<std::size_t>(
+               boost::thread::hardware_concurrency(), kMaxIndexingWorkers);
+      activeWorkers_ += gsl::narrow_cast<int>(numWorkers);
+      for (std::size_t i = 0; i < numWorkers; i++)
+      {
+         std::vector<FileInfo> shard;
+         for (std::size_t j = i; j < files.size(); j += numWorkers)
+            shard.push_back(files[j]);
+
+         core::thread::safeLaunchThread(
+                  boost::bind(&SourceFileIndex::indexShard,
+                              this,
+                              shard,
+                              encoding));
+      }
+
+      // merge completed entries into the live index on the main thread;
+      // insertion stays single-writer so readers never need to take a lock
+      if (!indexing_)
+      {
+         indexing_ = true;
+
+         module_context::scheduleIncrementalWork(
+                           boost::posix_time::milliseconds(200),
+                           boost::posix_time::milliseconds(20),
+                           boost::bind(&SourceFileIndex::dequeAndMerge, this),
+                           false /* allow indexing even when non-idle */);
+      }
+   }
+
    void enqueFileChange(const core::system::FileChangeEvent& event)
    {
       // add to the queue
@@ -590,7 +683,116 @@ public:
          }
       }
    }
-   
+
+   // as searchSource, but restricted to entries beneath the given root --
+   // used to order results by workspace root priority when additional
+   // roots share the index
+   void searchSourceUnder(const FilePath& rootPath,
+                          const std::string& term,
+                          std::size_t maxResults,
+                          bool prefixOnly,
+                          const std::set<std::string>& excludeContexts,
+                          std::vector<r_util::RSourceItem>* pItems)
+   {
+      Entry parentEntry(core::toFileInfo(rootPath));
+      EntryTree::iterator parent = pEntries_->find(parentEntry);
+      if (parent == pEntries_->end())
+         return;
+
+      EntryTree::leaf_iterator it = pEntries_->begin_leaf(parent);
+      EntryTree::leaf_iterator end = pEntries_->end_leaf(parent);
+      for (; it != end && pEntries_->is_valid(it); ++it)
+      {
+         const Entry& entry = *it;
+
+         // skip if it has no index
+         if (!entry.hasIndex())
+            continue;
+
+         // bail if this is an exluded context
+         if (excludeContexts.find(entry.pIndex->context()) !=
+             excludeContexts.end())
+         {
+            continue;
+         }
+
+         // scan the next index
+         entry.pIndex->search(term,
+                              prefixOnly,
+                              false,
+                              std::back_inserter(*pItems));
+
+         // return if we are past maxResults
+         if (pItems->size() >= maxResults)
+         {
+            pItems->resize(maxResults);
+            return;
+         }
+      }
+   }
+
+   // subsequence (fuzzy) file matching over the packed name arena. stage
+   // one rejects candidates whose character-occurrence bitmask can't
+   // contain the query's -- one AND per candidate over cache-contiguous
+   // data -- and only survivors pay for the exact subsequence scan, so
+   // per-keystroke cost stays low even with very large indexes
+   template <typename T>
+   void searchFilesFuzzy(const std::string& term,
+                         std::size_t maxResults,
+                         bool sourceFilesOnly,
+                         const FilePath& parentPath,
+                         T* pNames,
+                         T* pPaths,
+                         bool* pMoreAvailable)
+   {
+      ensureNameArena();
+
+      // we allow the user to submit queries of the form e.g.
+      // <query>:<row><column>; make sure we only match on the query
+      // up to ':'
+      std::string::size_type queryEnd = term.find(":");
+      if (queryEnd == std::string::npos)
+         queryEnd = term.length();
+
+      boost::uint64_t queryMask = nameMask(term.data(), queryEnd);
+      std::string parentPrefix = parentPath.getAbsolutePath() + "/";
+
+      for (std::size_t i = 0, n = nameArena_.entries.size(); i < n; i++)
+      {
+         // stage one: bitmask prefilter
+         if ((queryMask & ~nameArena_.masks[i]) != 0)
+            continue;
+
+         const Entry& entry = *nameArena_.entries[i];
+
+         // skip if it's not a source file
+         if (sourceFilesOnly && !isSourceFile(entry.fileInfo))
+            continue;
+
+         // skip if it's outside the requested parent
+         if (!boost::algorithm::starts_with(entry.fileInfo.absolutePath(),
+                                            parentPrefix))
+            continue;
+
+         // stage two: exact subsequence match (against the arena's
+         // already-lowercased copy of the name)
+         std::string name(nameArena_.names,
+                          nameArena_.offsets[i],
+                          nameArena_.offsets[i + 1] - nameArena_.offsets[i]);
+         if (!string_utils::isSubsequence(name, term, queryEnd, true))
+            continue;
+
+         // name and aliased path
+         FilePath filePath(entry.fileInfo.absolutePath());
+         pNames->push_back(filePath.getFilename());
+         pPaths->push_back(module_context::createAliasedPath(filePath));
+
+         // return if we are past max results
+         if (enforceMaxResults(maxResults, pNames, pPaths, pMoreAvailable))
+            return;
+      }
+   }
+
    template <typename T>
    void searchFiles(const std::string& term,
                     std::size_t maxResults,
@@ -606,7 +808,22 @@ public:
 
       // create wildcard pattern if the search has a '*'
       boost::regex pattern = regex_utils::regexIfWildcardPattern(term);
-      
+
+      // subsequence matches (the common Go-To-File keystroke path) go
+      // through the two-stage matcher; wildcard and prefix queries
+      // remain on the tree walk below
+      if (pattern.empty() && !prefixOnly)
+      {
+         searchFilesFuzzy(term,
+                          maxResults,
+                          sourceFilesOnly,
+                          parentPath,
+                          pNames,
+                          pPaths,
+                          pMoreAvailable);
+         return;
+      }
+
       // get the start and end iterators -- default to all leaves
       EntryTree::leaf_iterator it = pEntries_->begin_leaf();
       
@@ -798,10 +1015,98 @@ public:
       indexing_ = false;
       indexingQueue_ = std::queue<core::system::FileChangeEvent>();
       pEntries_->clear();
+      entriesVersion_++;
    }
 
 private:
 
+   // packed candidate names for the fuzzy matcher: every leaf entry's
+   // filename lowercased into one contiguous buffer, alongside a
+   // character-occurrence bitmask per name. rebuilt lazily whenever the
+   // entry tree changes (cheap relative to how rarely the index mutates
+   // mid-keystroke) so entry pointers are never stale when consulted
+   struct NameArena
+   {
+      NameArena() : version(static_cast<std::size_t>(-1)) {}
+
+      std::size_t version;
+      std::string names;
+      std::vector<std::size_t> offsets;   // size() == entries.size() + 1
+      std::vector<boost::uint64_t> masks;
+      std::vector<const Entry*> entries;
+   };
+
+   // bitmask of the characters occurring in a name: bits 0-25 for
+   // (lowercased) letters, 26-35 for digits, then a few common filename
+   // punctuation characters; everything else shares a single bit. a
+   // query can only be a subsequence of a candidate if the query's mask
+   // is a subset of the candidate's
+   static boost::uint64_t nameMask(const char* data, std::size_t n)
+   {
+      boost::uint64_t mask = 0;
+      for (std::size_t i = 0; i < n; i++)
+      {
+         char ch = data[i];
+         if (ch >= 'A' && ch <= 'Z')
+            ch = ch - 'A' + 'a';
+
+         if (ch >= 'a' && ch <= 'z')
+            mask |= (boost::uint64_t(1) << (ch - 'a'));
+         else if (ch >= '0' && ch <= '9')
+            mask |= (boost::uint64_t(1) << (26 + (ch - '0')));
+         else if (ch == '.')
+            mask |= (boost::uint64_t(1) << 36);
+         else if (ch == '_')
+            mask |= (boost::uint64_t(1) << 37);
+         else if (ch == '-')
+            mask |= (boost::uint64_t(1) << 38);
+         else
+            mask |= (boost::uint64_t(1) << 39);
+      }
+      return mask;
+   }
+
+   void ensureNameArena()
+   {
+      if (nameArena_.version == entriesVersion_)
+         return;
+
+      nameArena_.names.clear();
+      nameArena_.offsets.clear();
+      nameArena_.masks.clear();
+      nameArena_.entries.clear();
+      nameArena_.offsets.push_back(0);
+
+      EntryTree::leaf_iterator it = pEntries_->begin_leaf();
+      for (; pEntries_->is_valid(it); ++it)
+      {
+         const Entry& entry = *it;
+         const std::string& absolutePath = entry.fileInfo.absolutePath();
+         if (absolutePath.empty())
+            continue;
+
+         // append the lowercased filename to the packed buffer
+         std::size_t slashPos = absolutePath.find_last_of('/');
+         std::size_t nameStart = (slashPos == std::string::npos)
+                                    ? 0 : slashPos + 1;
+         for (std::size_t i = nameStart; i < absolutePath.length(); i++)
+         {
+            char ch = absolutePath[i];
+            if (ch >= 'A' && ch <= 'Z')
+               ch = ch - 'A' + 'a';
+            nameArena_.names.push_back(ch);
+         }
+
+         nameArena_.masks.push_back(
+                  nameMask(absolutePath.data() + nameStart,
+                           absolutePath.length() - nameStart));
+         nameArena_.entries.push_back(&entry);
+         nameArena_.offsets.push_back(nameArena_.names.length());
+      }
+
+      nameArena_.version = entriesVersion_;
+   }
+
    bool dequeAndIndex()
    {
       using namespace rstudio::core::system;
@@ -839,6 +1144,91 @@ private:
       return indexing_;
    }
 
+   // worker thread entry point -- reads and parses each file in the
+   // shard, then hands the completed entries back to the main thread
+   // via the merge queue
+   void indexShard(const std::vector<FileInfo>& files,
+                   const std::string& encoding)
+   {
+      for (const FileInfo& fileInfo : files)
+      {
+         FilePath filePath(fileInfo.absolutePath());
+
+         // filter certain directories (e.g. those that exist in build
+         // directories)
+         if (isWithinIgnoredDirectory(filePath))
+            continue;
+
+         boost::shared_ptr<r_util::RSourceIndex> pIndex;
+         if (isIndexableSourceFile(fileInfo))
+         {
+            // consult the persistent cache first; if the file is
+            // unchanged since the cache was written we can skip the
+            // read and parse entirely
+            pIndex = lookupCachedSourceIndex(fileInfo);
+            if (pIndex)
+            {
+               mergeQueue_.enque(Entry(fileInfo, pIndex));
+               continue;
+            }
+
+            std::string code;
+            Error error = module_context::readAndDecodeFile(
+                                    filePath,
+                                    encoding,
+                                    true,
+                                    &code);
+            if (error)
+            {
+               // log if not path not found error (this can happen if the
+               // file was removed after entering the indexing queue)
+               if (!core::isPathNotFoundError(error))
+               {
+                  error.addProperty("src-file", filePath.getAbsolutePath());
+                  LOG_ERROR(error);
+               }
+               continue;
+            }
+
+            std::string context = module_context::createAliasedPath(filePath);
+            pIndex.reset(new r_util::RSourceIndex(context, code));
+         }
+
+         mergeQueue_.enque(Entry(fileInfo, pIndex));
+      }
+
+      activeWorkers_--;
+   }
+
+   // main thread counterpart of indexShard -- folds completed entries
+   // into the live EntryTree in bounded chunks
+   bool dequeAndMerge()
+   {
+      Entry entry;
+      for (std::size_t i = 0; i < kMergeChunkSize; i++)
+      {
+         if (!mergeQueue_.deque(&entry))
+            break;
+         pEntries_->insertEntry(entry);
+         entriesVersion_++;
+      }
+
+      bool working = (activeWorkers_ > 0) || !mergeQueue_.isEmpty();
+      if (!working)
+      {
+         // kick off a package information update once per batch rather
+         // than once per file
+         r_packages::AsyncPackageInformationProcess::update();
+
+         // process any file change events which arrived while the
+         // workers were running
+         working = dequeAndIndex();
+      }
+
+      indexing_ = working;
+      return working;
+   }
+
    void updateIndexEntry(const FileInfo& fileInfo)
    {
       // index the source if necessary
@@ -853,6 +1243,17 @@ private:
 
       if (isIndexableSourceFile(fileInfo))
       {
+         // consult the persistent cache first; if the file is unchanged
+         // since the cache was written we can skip the parse entirely
+         pIndex = lookupCachedSourceIndex(fileInfo);
+         if (pIndex)
+         {
+            pEntries_->insertEntry(Entry(fileInfo, pIndex));
+            entriesVersion_++;
+            r_packages::AsyncPackageInformationProcess::update();
+            return;
+         }
+
          std::string code;
          Error error = module_context::readAndDecodeFile(
                                  filePath,
@@ -879,6 +1280,7 @@ private:
       // attempt to add the entry
       Entry entry(fileInfo, pIndex);
       pEntries_->insertEntry(entry);
+      entriesVersion_++;
 
       // kick off an update
       r_packages::AsyncPackageInformationProcess::update();
@@ -891,7 +1293,10 @@ private:
 
       EntryTree::iterator it = pEntries_->find(entry);
       if (it != pEntries_->end())
+      {
          pEntries_->erase(it);
+         entriesVersion_++;
+      }
       else
       {
          DEBUG("Failed to remove index entry for file: '" << fileInfo.getAbsolutePath() << "'");
@@ -899,6 +1304,18 @@ private:
       }
    }
 
+   // visit every entry which has an associated source index (used to
+   // persist the index at shutdown)
+   void visitIndexedEntries(
+            const boost::function<void(const Entry&)>& callback)
+   {
+      for (const Entry& entry : *pEntries_)
+      {
+         if (entry.hasIndex())
+            callback(entry);
+      }
+   }
+
    static bool isSourceFile(const FileInfo& fileInfo)
    {
       FilePath filePath(fileInfo.absolutePath());
@@ -962,6 +1379,16 @@ private:
    // indexing queue
    bool indexing_;
    std::queue<core::system::FileChangeEvent> indexingQueue_;
+
+   // parallel indexing state -- workers push completed entries onto the
+   // merge queue and the main thread folds them into pEntries_
+   std::atomic<int> activeWorkers_;
+   core::thread::ThreadsafeQueue<Entry> mergeQueue_;
+
+   // fuzzy matching state -- the version counter is bumped on every
+   // entry tree mutation so the name arena can be rebuilt lazily
+   std::size_t entriesVersion_;
+   NameArena nameArena_;
 };
 
 } // anonymous namespace
@@ -1131,6 +1558,149 @@ SourceFileIndex& projectIndex()
    return instance;
 }
 
+// additional workspace roots -----------------------------------------------
+//
+// beyond the active project root we allow additional roots (e.g. sibling
+// repos) to be registered for indexing. their files go into the same
+// SourceFileIndex as the project's -- one shared entry tree and one set
+// of RSourceIndex objects, so adding roots doesn't duplicate any of the
+// index infrastructure -- and each root gets its own file monitor so
+// incremental updates work the same way they do for the project. the
+// project root always ranks first in search results; additional roots
+// rank by their registered priority (lower values first).
+
+struct WorkspaceRoot
+{
+   WorkspaceRoot() : priority(0) {}
+
+   FilePath path;
+   int priority;
+   core::system::file_monitor::Handle handle;
+};
+
+// sorted by ascending priority (single-threaded: main thread only)
+std::vector<boost::shared_ptr<WorkspaceRoot> > s_workspaceRoots;
+
+void sortWorkspaceRoots()
+{
+   std::stable_sort(s_workspaceRoots.begin(),
+                    s_workspaceRoots.end(),
+                    [](const boost::shared_ptr<WorkspaceRoot>& lhs,
+                       const boost::shared_ptr<WorkspaceRoot>& rhs)
+                    {
+                       return lhs->priority < rhs->priority;
+                    });
+}
+
+bool workspaceRootFilter(const FileInfo& fileInfo)
+{
+   return module_context::fileListingFilter(fileInfo, true);
+}
+
+void onWorkspaceRootRegistered(boost::shared_ptr<WorkspaceRoot> pRoot,
+                               core::system::file_monitor::Handle handle,
+                               const tree<FileInfo>& files)
+{
+   pRoot->handle = handle;
+   projectIndex().enqueFiles(files.begin_leaf(), files.end_leaf());
+}
+
+void onWorkspaceRootFilesChanged(
+                  const std::vector<core::system::FileChangeEvent>& events)
+{
+   std::for_each(
+         events.begin(),
+         events.end(),
+         boost::bind(&SourceFileIndex::enqueFileChange, &projectIndex(), _1));
+}
+
+void onWorkspaceRootRegistrationError(boost::shared_ptr<WorkspaceRoot> pRoot,
+                                      const Error& error)
+{
+   LOG_ERROR(error);
+   s_workspaceRoots.erase(std::remove(s_workspaceRoots.begin(),
+                                      s_workspaceRoots.end(),
+                                      pRoot),
+                          s_workspaceRoots.end());
+}
+
+Error addWorkspaceRoot(const json::JsonRpcRequest& request,
+                       json::JsonRpcResponse* pResponse)
+{
+   std::string path;
+   int priority;
+   Error error = json::readParams(request.params, &path, &priority);
+   if (error)
+      return error;
+
+   FilePath rootPath = module_context::resolveAliasedPath(path);
+   if (!rootPath.exists())
+      return fileNotFoundError(rootPath, ERROR_LOCATION);
+
+   // ignore requests to re-register the project root (it is always
+   // indexed, and always ranks first)
+   if (projects::projectContext().hasProject() &&
+       rootPath == projects::projectContext().directory())
+   {
+      return Success();
+   }
+
+   // if the root is already registered this is just a priority update --
+   // its files are already indexed and monitored
+   for (boost::shared_ptr<WorkspaceRoot>& pExisting : s_workspaceRoots)
+   {
+      if (pExisting->path == rootPath)
+      {
+         pExisting->priority = priority;
+         sortWorkspaceRoots();
+         return Success();
+      }
+   }
+
+   boost::shared_ptr<WorkspaceRoot> pRoot(new WorkspaceRoot());
+   pRoot->path = rootPath;
+   pRoot->priority = priority;
+   s_workspaceRoots.push_back(pRoot);
+   sortWorkspaceRoots();
+
+   // monitor the root for changes (the registration callback delivers
+   // the initial scan, which primes the shared index)
+   core::system::file_monitor::Callbacks cb;
+   cb.onRegistered = boost::bind(onWorkspaceRootRegistered, pRoot, _1, _2);
+   cb.onRegistrationError = boost::bind(onWorkspaceRootRegistrationError,
+                                        pRoot, _1);
+   cb.onFilesChanged = onWorkspaceRootFilesChanged;
+   core::system::file_monitor::registerMonitor(rootPath,
+                                               true,
+                                               workspaceRootFilter,
+                                               cb);
+
+   return Success();
+}
+
+Error removeWorkspaceRoot(const json::JsonRpcRequest& request,
+                          json::JsonRpcResponse* pResponse)
+{
+   std::string path;
+   Error error = json::readParams(request.params, &path);
+   if (error)
+      return error;
+
+   FilePath rootPath = module_context::resolveAliasedPath(path);
+   for (std::vector<boost::shared_ptr<WorkspaceRoot> >::iterator
+        it = s_workspaceRoots.begin(); it != s_workspaceRoots.end(); ++it)
+   {
+      if ((*it)->path == rootPath)
+      {
+         core::system::file_monitor::unregisterMonitor((*it)->handle);
+         s_workspaceRoots.erase(it);
+         break;
+      }
+   }
+
+   return Success();
+}
+
 } // end anonymous namespace
 
 boost::shared_ptr<r_util::RSourceIndex> getIndexedProjectFile(
@@ -1165,11 +1735,41 @@ void searchSource(const std::string& term,
 
    // now search the project (excluding contexts already searched in the source db)
    std::vector<r_util::RSourceItem> projItems;
-   projectIndex().searchSource(term,
-                               maxProjResults,
-                               prefixOnly,
-                               srcDBContexts,
-                               &projItems);
+   if (s_workspaceRoots.empty())
+   {
+      projectIndex().searchSource(term,
+                                  maxProjResults,
+                                  prefixOnly,
+                                  srcDBContexts,
+                                  &projItems);
+   }
+   else
+   {
+      // root-aware ranking: results from the project root always come
+      // first, then additional workspace roots in priority order
+      if (projects::projectContext().hasProject())
+      {
+         projectIndex().searchSourceUnder(projects::projectContext().directory(),
+                                          term,
+                                          maxProjResults,
+                                          prefixOnly,
+                                          srcDBContexts,
+                                          &projItems);
+      }
+
+      for (const boost::shared_ptr<WorkspaceRoot>& pRoot : s_workspaceRoots)
+      {
+         if (projItems.size() >= maxProjResults)
+            break;
+
+         projectIndex().searchSourceUnder(pRoot->path,
+                                          term,
+                                          maxProjResults,
+                                          prefixOnly,
+                                          srcDBContexts,
+                                          &projItems);
+      }
+   }
 
    // add project items to the list
    for (const r_util::RSourceItem& sourceItem : projItems)
@@ -1687,6 +2287,7 @@ json::Array toJsonArray(
 
 
 Error searchCode(const json::JsonRpcRequest& request,
+                 const module_context::PreemptibleRpcToken& token,
                  json::JsonRpcResponse* pResponse)
 {
    // get params
@@ -1695,7 +2296,7 @@ Error searchCode(const json::JsonRpcRequest& request,
    Error error = json::readParams(request.params, &term, &maxResultsInt);
    if (error)
       return error;
-   
+
    std::size_t maxResults =
          safe_convert::numberTo<int, std::size_t>(maxResultsInt, 20);
 
@@ -1712,26 +2313,49 @@ Error searchCode(const json::JsonRpcRequest& request,
    // sending over the wire). Simiarly with the 'more*Available' bools
    searchFiles(term, 100, true, &names, &paths, &moreFilesAvailable);
 
-   // search source and convert to source items
+   // stream the file matches to the client right away -- they are the
+   // cheapest phase and remain useful while the slower source item
+   // phases run (or if the search is abandoned partway through)
+   if (!token.cancelled())
+   {
+      json::Object filesPage;
+      filesPage["filename"] = json::toJsonArray(names);
+      filesPage["path"] = json::toJsonArray(paths);
+      token.reportPartialResults(filesPage);
+   }
+   token.reportProgress(1, 4);
+
+   // search source and convert to source items (skipping any remaining
+   // phases once the client has cancelled the search)
    std::vector<SourceItem> srcItems;
    std::vector<r_util::RSourceItem> rSrcItems;
    bool moreSourceItemsAvailable = false;
-   searchSource(term, 100, false, &rSrcItems, &moreSourceItemsAvailable);
-   std::transform(rSrcItems.begin(),
-                  rSrcItems.end(),
-                  std::back_inserter(srcItems),
-                  fromRSourceItem);
+   if (!token.cancelled())
+   {
+      searchSource(term, 100, false, &rSrcItems, &moreSourceItemsAvailable);
+      std::transform(rSrcItems.begin(),
+                     rSrcItems.end(),
+                     std::back_inserter(srcItems),
+                     fromRSourceItem);
+   }
+   token.reportProgress(2, 4);
 
    // search cpp source and convert to source items
-   std::vector<clang::CppDefinition> cppDefinitions;
-   clang::searchDefinitions(term, &cppDefinitions);
-   std::transform(cppDefinitions.begin(),
-                  cppDefinitions.end(),
-                  std::back_inserter(srcItems),
-                  fromCppDefinition);
-   
+   if (!token.cancelled())
+   {
+      std::vector<clang::CppDefinition> cppDefinitions;
+      clang::searchDefinitions(term, &cppDefinitions);
+      std::transform(cppDefinitions.begin(),
+                     cppDefinitions.end(),
+                     std::back_inserter(srcItems),
+                     fromCppDefinition);
+   }
+   token.reportProgress(3, 4);
+
    // search bookdown xref index
-   fillFromBookdownRefs(term, &srcItems);
+   if (!token.cancelled())
+      fillFromBookdownRefs(term, &srcItems);
+   token.reportProgress(4, 4);
 
    // typedef necessary for range-based-for to work with pairs
    typedef std::pair<int, int> PairIntInt;
@@ -1810,6 +2434,10 @@ Error searchCode(const json::JsonRpcRequest& request,
    result["more_available"] =
          moreFilesAvailable || moreSourceItemsAvailable;
 
+   // let the client know when it received a truncated result set because
+   // it cancelled the search partway through
+   result["preempted"] = token.cancelled();
+
    pResponse->setResult(result);
 
    return Success();
@@ -2588,8 +3216,194 @@ SEXP rs_viewFunction(SEXP functionSEXP, SEXP nameSEXP, SEXP namespaceSEXP)
 
 } // anonymous namespace
    
+FilePath sourceIndexFilePath()
+{
+   return projects::projectContext().scratchPath().completeChildPath(
+                                                      "code-search-index");
+}
+
+json::Object rSourceItemToJson(const r_util::RSourceItem& item)
+{
+   json::Object itemJson;
+   itemJson["type"] = item.type();
+   itemJson["name"] = item.name();
+   itemJson["brace_level"] = item.braceLevel();
+   itemJson["line"] = item.line();
+   itemJson["column"] = item.column();
+
+   json::Array signatureJson;
+   for (const r_util::RS4MethodParam& param : item.signature())
+   {
+      json::Object paramJson;
+      paramJson["name"] = param.name();
+      paramJson["type"] = param.type();
+      signatureJson.push_back(paramJson);
+   }
+   itemJson["signature"] = signatureJson;
+
+   return itemJson;
+}
+
+r_util::RSourceItem rSourceItemFromJson(const json::Object& itemJson)
+{
+   int type, braceLevel, line, column;
+   std::string name;
+   json::Array signatureJson;
+   Error error = json::readObject(itemJson,
+                                  "type", type,
+                                  "name", name,
+                                  "brace_level", braceLevel,
+                                  "line", line,
+                                  "column", column,
+                                  "signature", signatureJson);
+   if (error)
+   {
+      LOG_ERROR(error);
+      return r_util::RSourceItem();
+   }
+
+   std::vector<r_util::RS4MethodParam> signature;
+   for (const json::Value& paramJson : signatureJson)
+   {
+      if (!json::isType<json::Object>(paramJson))
+         continue;
+
+      std::string paramName, paramType;
+      error = json::readObject(paramJson.getObject(),
+                               "name", paramName,
+                               "type", paramType);
+      if (error)
+      {
+         LOG_ERROR(error);
+         continue;
+      }
+      signature.push_back(r_util::RS4MethodParam(paramName, paramType));
+   }
+
+   return r_util::RSourceItem(type,
+                              name,
+                              signature,
+                              braceLevel,
+                              gsl::narrow_cast<std::size_t>(line),
+                              gsl::narrow_cast<std::size_t>(column));
+}
+
+void loadSourceIndexCache()
+{
+   using namespace safe_convert;
+
+   if (!projects::projectContext().hasProject())
+      return;
+
+   FilePath indexFilePath = sourceIndexFilePath();
+   if (!indexFilePath.exists())
+      return;
+
+   std::string contents;
+   Error error = readStringFromFile(indexFilePath, &contents);
+   if (error)
+   {
+      LOG_ERROR(error);
+      return;
+   }
+
+   json::Value indexValueJson;
+   if (indexValueJson.parse(contents) ||
+       !json::isType<json::Array>(indexValueJson))
+   {
+      LOG_ERROR_MESSAGE("Error parsing code search index: " +
+                        indexFilePath.getAbsolutePath());
+      return;
+   }
+
+   for (const json::Value& fileJson : indexValueJson.getArray())
+   {
+      if (!json::isType<json::Object>(fileJson))
+         continue;
+
+      std::string file, context;
+      double fileLastWrite;
+      json::Array itemsJson;
+      Error error = json::readObject(fileJson.getObject(),
+                                     "file", file,
+                                     "file_last_write", fileLastWrite,
+                                     "context", context,
+                                     "items", itemsJson);
+      if (error)
+      {
+         LOG_ERROR(error);
+         continue;
+      }
+
+      // if the file no longer exists then don't bother caching it
+      if (!FilePath::exists(file))
+         continue;
+
+      std::vector<r_util::RSourceItem> items;
+      for (const json::Value& itemJson : itemsJson)
+      {
+         if (!json::isType<json::Object>(itemJson))
+            continue;
+
+         r_util::RSourceItem item = rSourceItemFromJson(itemJson.getObject());
+         if (!item.name().empty())
+            items.push_back(item);
+      }
+
+      CachedSourceIndex cached;
+      cached.lastWriteTime = numberTo<double, std::time_t>(fileLastWrite, 0);
+      cached.pIndex.reset(new r_util::RSourceIndex(context, items));
+      s_sourceIndexCache[file] = cached;
+   }
+}
+
+void appendEntryJson(const Entry& entry, json::Array* pIndexJson)
+{
+   json::Object fileJson;
+   fileJson["file"] = entry.fileInfo.absolutePath();
+   fileJson["file_last_write"] = safe_convert::numberTo<std::time_t, double>(
+                                       entry.fileInfo.lastWriteTime(), 0);
+   fileJson["context"] = entry.pIndex->context();
+
+   json::Array itemsJson;
+   for (const r_util::RSourceItem& item : entry.pIndex->items())
+      itemsJson.push_back(rSourceItemToJson(item));
+   fileJson["items"] = itemsJson;
+
+   pIndexJson->push_back(fileJson);
+}
+
+void saveSourceIndexCache()
+{
+   if (!projects::projectContext().hasProject())
+      return;
+
+   json::Array indexJson;
+   projectIndex().visitIndexedEntries(
+            boost::bind(appendEntryJson, _1, &indexJson));
+
+   Error error = writeStringToFile(sourceIndexFilePath(),
+                                   indexJson.writeFormatted());
+   if (error)
+      LOG_ERROR(error);
+}
+
+void onShutdown(bool terminatedNormally)
+{
+   if (terminatedNormally)
+      saveSourceIndexCache();
+}
+
 Error initialize()
 {
+   // load any index persisted by a previous session (entries are
+   // reconciled against file mtimes as the file monitor scan re-enqueues
+   // files, so only changed files are re-parsed)
+   loadSourceIndexCache();
+
+   // save the index at shutdown so the next session can start warm
+   module_context::events().onShutdown.connect(onShutdown);
+
    // subscribe to project context file monitoring state changes
    // (note that if there is no project this will no-op)
    session::projects::FileMonitorCallbacks cb;
@@ -2613,7 +3427,9 @@ Error initialize()
    using namespace module_context;
    ExecBlock initBlock;
    initBlock.addFunctions()
-      (bind(registerRpcMethod, "search_code", searchCode))
+      (bind(registerPreemptibleRpcMethod, "search_code", searchCode))
+      (bind(registerRpcMethod, "add_workspace_root", addWorkspaceRoot))
+      (bind(registerRpcMethod, "remove_workspace_root", removeWorkspaceRoot))
       (bind(registerRpcMethod, "get_function_definition", getFunctionDefinition))
       (bind(registerRpcMethod, "get_search_path_function_definition", getSearchPathFunctionDefinition))
       (bind(registerRpcMethod, "get_method_definition", getMethodDefinition))
@@ -152,6 +152,28 @@ Error resetConsoleActions(const json::JsonRpcRequest& request,
    return Success();
 }
 
+void handleConsoleTranscriptRequest(const http::Request& request,
+                                    http::Response* pResponse)
+{
+   // streams the binary transcript log directly from disk (with range
+   // support) so reconnecting clients can replay the console without the
+   // session rebuilding the transcript as json
+   r::session::ConsoleActions& consoleActions = r::session::consoleActions();
+   FilePath transcriptPath = consoleActions.transcriptFile();
+   if (transcriptPath.isEmpty() || !transcriptPath.exists())
+   {
+      pResponse->setNotFoundError(request);
+      return;
+   }
+
+   // make sure buffered records have hit the file
+   consoleActions.flushTranscript();
+
+   pResponse->setNoCacheHeaders();
+   pResponse->setContentType("application/octet-stream");
+   pResponse->setRangeableFile(transcriptPath, request);
+}
+
 SEXP rs_getPendingInput()
 {
    r::sexp::Protect rProtect;
@@ -224,6 +246,11 @@ Error initialize()
       r::session::consoleActions().setCapacity(maxLines);
    }
 
+   // maintain the binary transcript log in the session scratch path
+   r::session::consoleActions().setTranscriptFile(
+         module_context::sessionScratchPath().completeChildPath(
+            "console_transcript"));
+
    // register routines
    RS_REGISTER_CALL_METHOD(rs_getPendingInput);
    
@@ -241,7 +268,9 @@ Error initialize()
    ExecBlock initBlock;
    initBlock.addFunctions()
       (bind(sourceModuleRFile, "SessionConsole.R"))
-      (bind(registerRpcMethod, "reset_console_actions", resetConsoleActions));
+      (bind(registerRpcMethod, "reset_console_actions", resetConsoleActions))
+      (bind(registerUriHandler, "/console_transcript",
+            handleConsoleTranscriptRequest));
 
    return initBlock.execute();
 }
@@ -24,6 +24,7 @@
 #include "SessionAsyncPackageInformation.hpp"
 #include "SessionRParser.hpp"
 
+#include <functional>
 #include <set>
 
 #include <core/Debug.hpp>
@@ -633,6 +634,248 @@ void setFileLocalParseOptions(const std::wstring& rCode,
    applyOptions(options, pOptions);
 }
 
+// cache of parse results by document id. background linting is driven
+// from an idle timer on the client so successive passes frequently see
+// identical contents -- reuse the previous parse in that case rather
+// than re-parsing the entire document
+struct CachedParse
+{
+   CachedParse() : optionFlags(0) {}
+   std::wstring contents;
+   int optionFlags;
+   ParseResults results;
+};
+
+std::map<std::string, CachedParse> s_parseCache;
+
+// collapse the option state which influences parse results into a
+// bitset so cached results are discarded when preferences change
+int parseOptionFlags(const ParseOptions& options)
+{
+   int flags = 0;
+   if (options.lintRFunctions())
+      flags |= (1 << 0);
+   if (options.checkArgumentsToRFunctionCalls())
+      flags |= (1 << 1);
+   if (options.checkUnexpectedAssignmentInFunctionCall())
+      flags |= (1 << 2);
+   if (options.warnIfVariableIsDefinedButNotUsed())
+      flags |= (1 << 3);
+   if (options.warnIfNoSuchVariableInScope())
+      flags |= (1 << 4);
+   if (options.recordStyleLint())
+      flags |= (1 << 5);
+   return flags;
+}
+
+// function-granular lint reuse --------------------------------------------
+//
+// a localized edit usually touches a single top-level expression, but we
+// re-lint the whole document on idle. when the active diagnostics are all
+// expression-local we split the document into top-level expressions, hash
+// each one, and re-analyze only the expression that changed, reusing the
+// cached lint (with rows shifted) everywhere else -- so lint latency on a
+// large file tracks the edited function rather than the file. the
+// cross-expression checks (no-such-symbol-in-scope, defined-but-not-used)
+// inspect the whole parse tree, so when they're enabled we fall back to a
+// full parse.
+
+struct TopLevelSpan
+{
+   TopLevelSpan(std::size_t beginRow, std::size_t endRow,
+                std::size_t beginOffset, std::size_t endOffset,
+                std::size_t hash)
+      : beginRow(beginRow), endRow(endRow),
+        beginOffset(beginOffset), endOffset(endOffset),
+        hash(hash)
+   {
+   }
+
+   std::size_t beginRow;     // first row of the span
+   std::size_t endRow;       // one past the last row of the span
+   std::size_t beginOffset;  // character offsets of the span's text
+   std::size_t endOffset;
+   std::size_t hash;         // hash of the span's text
+};
+
+std::vector<TopLevelSpan> splitTopLevelSpans(const std::wstring& rCode)
+{
+   // record the character offset at which each row begins (used to slice
+   // out span text below)
+   std::vector<std::size_t> lineOffsets;
+   lineOffsets.push_back(0);
+   for (std::size_t i = 0; i < rCode.size(); i++)
+      if (rCode[i] == L'\n')
+         lineOffsets.push_back(i + 1);
+   std::size_t numRows = lineOffsets.size();
+
+   // locate the starting rows of top-level expressions with a token scan:
+   // a significant token at bracket depth zero which begins a fresh row
+   // and doesn't continue the previous expression starts a new one
+   std::vector<std::size_t> spanStarts;
+   r_util::RTokenizer tokenizer(rCode);
+   r_util::RToken token;
+   int depth = 0;
+   bool continuation = false;
+   std::size_t prevRow = static_cast<std::size_t>(-1);
+   while ((token = tokenizer.nextToken()))
+   {
+      if (token.isType(r_util::RToken::WHITESPACE))
+         continue;
+
+      if (depth == 0 &&
+          !continuation &&
+          token.row() != prevRow &&
+          !token.contentEquals(L"else"))
+      {
+         spanStarts.push_back(token.row());
+      }
+      prevRow = token.row();
+
+      switch (token.type())
+      {
+         case r_util::RToken::LPAREN:
+         case r_util::RToken::LBRACE:
+         case r_util::RToken::LBRACKET:
+         case r_util::RToken::LDBRACKET:
+            depth++;
+            break;
+         case r_util::RToken::RPAREN:
+         case r_util::RToken::RBRACE:
+         case r_util::RToken::RBRACKET:
+         case r_util::RToken::RDBRACKET:
+            if (depth > 0)
+               depth--;
+            break;
+         default:
+            break;
+      }
+
+      continuation = token.isType(r_util::RToken::OPER) ||
+                     token.isType(r_util::RToken::UOPER) ||
+                     token.isType(r_util::RToken::COMMA);
+   }
+
+   std::vector<TopLevelSpan> spans;
+   std::hash<std::wstring> hasher;
+   for (std::size_t i = 0; i < spanStarts.size(); i++)
+   {
+      std::size_t beginRow = spanStarts[i];
+      std::size_t endRow = (i + 1 < spanStarts.size()) ?
+               spanStarts[i + 1] :
+               numRows;
+      std::size_t beginOffset = lineOffsets[beginRow];
+      std::size_t endOffset = (endRow < numRows) ?
+               lineOffsets[endRow] :
+               rCode.size();
+      spans.push_back(TopLevelSpan(
+               beginRow, endRow, beginOffset, endOffset,
+               hasher(rCode.substr(beginOffset, endOffset - beginOffset))));
+   }
+   return spans;
+}
+
+bool tryIncrementalLint(const CachedParse& cached,
+                        const std::wstring& rCode,
+                        const FilePath& origin,
+                        const ParseOptions& options,
+                        ParseResults* pResults)
+{
+   // only expression-local diagnostics can be reused per expression
+   if (options.warnIfNoSuchVariableInScope() ||
+       options.warnIfVariableIsDefinedButNotUsed())
+      return false;
+
+   std::vector<TopLevelSpan> oldSpans = splitTopLevelSpans(cached.contents);
+   std::vector<TopLevelSpan> newSpans = splitTopLevelSpans(rCode);
+   if (oldSpans.empty() || newSpans.empty())
+      return false;
+
+   // match unchanged spans from both ends
+   std::size_t minSize = std::min(oldSpans.size(), newSpans.size());
+   std::size_t prefix = 0;
+   while (prefix < minSize &&
+          oldSpans[prefix].hash == newSpans[prefix].hash &&
+          oldSpans[prefix].beginRow == newSpans[prefix].beginRow)
+   {
+      prefix++;
+   }
+
+   std::size_t suffix = 0;
+   while (suffix < minSize - prefix &&
+          oldSpans[oldSpans.size() - 1 - suffix].hash ==
+             newSpans[newSpans.size() - 1 - suffix].hash)
+   {
+      suffix++;
+   }
+
+   // the edit must be confined to a single top-level expression
+   if (oldSpans.size() - prefix - suffix != 1 ||
+       newSpans.size() - prefix - suffix != 1)
+   {
+      return false;
+   }
+
+   const TopLevelSpan& oldSpan = oldSpans[prefix];
+   const TopLevelSpan& newSpan = newSpans[prefix];
+
+   // re-analyze just the edited expression (parsed standalone, so its lint
+   // rows come back relative to the span start)
+   std::wstring spanText = rCode.substr(
+            newSpan.beginOffset, newSpan.endOffset - newSpan.beginOffset);
+   ParseResults spanResults = rparser::parse(origin, spanText, options);
+   if (spanResults.parseTree() == nullptr)
+      return false;
+
+   // splice: reuse cached lint outside the edited expression, shifting
+   // rows below it by the change in line count
+   int rowDelta = static_cast<int>(newSpan.endRow) -
+                  static_cast<int>(oldSpan.endRow);
+
+   LintItems lintItems(options);
+   for (const LintItem& item : cached.results.lint().get())
+   {
+      if (item.startRow < static_cast<int>(oldSpan.beginRow))
+      {
+         lintItems.add(item.startRow, item.startColumn,
+                       item.endRow, item.endColumn,
+                       item.type, item.message);
+      }
+      else if (item.startRow >= static_cast<int>(oldSpan.endRow))
+      {
+         lintItems.add(item.startRow + rowDelta, item.startColumn,
+                       item.endRow + rowDelta, item.endColumn,
+                       item.type, item.message);
+      }
+   }
+
+   for (const LintItem& item : spanResults.lint().get())
+   {
+      lintItems.add(item.startRow + newSpan.beginRow, item.startColumn,
+                    item.endRow + newSpan.beginRow, item.endColumn,
+                    item.type, item.message);
+   }
+
+   *pResults = ParseResults(ParseNode::createRootNode(), lintItems);
+   return true;
+}
+
+void onSourceDocRemoved(const std::string& id, const std::string& path)
+{
+   s_parseCache.erase(id);
+}
+
+void onAllSourceDocsRemoved()
+{
+   s_parseCache.clear();
+}
+
+void onMemoryTrim()
+{
+   // parse results are rebuilt on the next lint request
+   s_parseCache.clear();
+}
+
 } // end anonymous namespace
 
 ParseResults parse(const std::wstring& rCode,
@@ -665,7 +908,38 @@ ParseResults parse(const std::wstring& rCode,
    setFileLocalParseOptions(rCode, &options, &noLint);
    if (noLint)
       return ParseResults();
-   
+
+   // check whether we can reuse the previous parse of this document
+   int optionFlags = parseOptionFlags(options);
+   if (!documentId.empty())
+   {
+      std::map<std::string, CachedParse>::const_iterator it =
+                                               s_parseCache.find(documentId);
+      if (it != s_parseCache.end() &&
+          it->second.optionFlags == optionFlags &&
+          it->second.contents == rCode)
+      {
+         return it->second.results;
+      }
+   }
+
+   // check whether the edit is confined to a single top-level expression,
+   // in which case only that expression needs re-analysis
+   if (!documentId.empty())
+   {
+      std::map<std::string, CachedParse>::iterator it =
+                                               s_parseCache.find(documentId);
+      if (it != s_parseCache.end() &&
+          it->second.optionFlags == optionFlags &&
+          tryIncrementalLint(it->second, rCode, origin, options, &results))
+      {
+         // cache the new generation for the next pass
+         it->second.contents = rCode;
+         it->second.results = results;
+         return results;
+      }
+   }
+
    results = rparser::parse(origin, rCode, options);
    
    ParseNode* pRoot = results.parseTree();
@@ -690,7 +964,16 @@ ParseResults parse(const std::wstring& rCode,
    
    if (options.warnIfVariableIsDefinedButNotUsed())
       checkDefinedButNotUsed(results);
-   
+
+   // cache the results for reuse by the next pass over this document
+   if (!documentId.empty())
+   {
+      CachedParse& cached = s_parseCache[documentId];
+      cached.contents = rCode;
+      cached.optionFlags = optionFlags;
+      cached.results = results;
+   }
+
    return results;
 }
 
@@ -1033,7 +1316,11 @@ core::Error initialize()
    using namespace module_context;
    
    events().afterSessionInitHook.connect(afterSessionInitHook);
-   
+   events().onMemoryTrim.connect(onMemoryTrim);
+
+   source_database::events().onDocRemoved.connect(onSourceDocRemoved);
+   source_database::events().onRemoveAll.connect(onAllSourceDocsRemoved);
+
    session::projects::FileMonitorCallbacks cb;
    cb.onFilesChanged = onFilesChanged;
    projects::projectContext().subscribeToFileMonitor("Diagnostics", cb);
@@ -238,23 +238,41 @@ Error listFiles(const json::JsonRpcRequest& request, json::JsonRpcResponse* pRes
    
    // if this includes a request for monitoring
    core::json::Array jsonFiles;
+
+   // generation number of the monitored listing (-1 when the listing isn't
+   // maintained by our monitor, in which case no changeset events are sent)
+   int generation = -1;
    if (monitor)
    {
-      // always stop existing if we have one
-      s_filesListingMonitor.stop();
-
-      // install a monitor only if we aren't already covered by the project monitor
-      if (!session::projects::projectContext().isMonitoringDirectory(targetPath))
+      // serve from the monitor's listing snapshot when we're already
+      // monitoring this directory (constant time regardless of the number
+      // of entries; the snapshot is kept current from monitor events)
+      if (s_filesListingMonitor.cachedListing(targetPath,
+                                              includeHidden,
+                                              &jsonFiles))
       {
-         error = s_filesListingMonitor.start(targetPath, includeHidden, &jsonFiles);
-         if (error)
-            return error;
+         // no rescan or monitor restart required
+         generation = s_filesListingMonitor.listingGeneration();
       }
       else
       {
-         error = FilesListingMonitor::listFiles(targetPath, includeHidden, &jsonFiles);
-         if (error)
-            return error;
+         // always stop existing if we have one
+         s_filesListingMonitor.stop();
+
+         // install a monitor only if we aren't already covered by the project monitor
+         if (!session::projects::projectContext().isMonitoringDirectory(targetPath))
+         {
+            error = s_filesListingMonitor.start(targetPath, includeHidden, &jsonFiles);
+            if (error)
+               return error;
+            generation = s_filesListingMonitor.listingGeneration();
+         }
+         else
+         {
+            error = FilesListingMonitor::listFiles(targetPath, includeHidden, &jsonFiles);
+            if (error)
+               return error;
+         }
       }
    }
    else
@@ -265,6 +283,7 @@ Error listFiles(const json::JsonRpcRequest& request, json::JsonRpcResponse* pRes
    }
 
    result["files"] = jsonFiles;
+   result["generation"] = generation;
 
    bool browseable = true;
 
@@ -308,6 +327,21 @@ core::Error createFolder(const core::json::JsonRpcRequest& request,
 }
 
 
+// notify the client when background reclamation of a deleted path
+// finishes (invoked from the recycle bin's service thread; the client
+// event queue is thread-safe)
+void onAsyncDeletionCompleted(const FilePath& filePath, const Error& error)
+{
+   if (error)
+      LOG_ERROR(error);
+
+   json::Object dataJson;
+   dataJson["path"] = module_context::createAliasedPath(filePath);
+   dataJson["succeeded"] = !error;
+   ClientEvent event(client_events::kAsyncFileDeletionCompleted, dataJson);
+   module_context::enqueClientEvent(event);
+}
+
 core::Error deleteFile(const FilePath& filePath)
 {
    if (session::options().programMode() == kSessionProgramModeDesktop)
@@ -325,7 +359,20 @@ core::Error deleteFile(const FilePath& filePath)
    }
    else
    {
-      return filePath.remove();
+      // rename out of the way immediately and unlink in the background,
+      // so deleting a large directory doesn't block the session while
+      // (potentially network) storage processes the unlinks
+      Error error = core::system::recycle_bin::removeAsync(
+               filePath,
+               boost::bind(onAsyncDeletionCompleted, filePath, _1));
+      if (error)
+      {
+         // couldn't move the target aside (e.g. parent not writable for
+         // a rename) -- fall back to synchronous removal
+         LOG_ERROR(error);
+         return filePath.remove();
+      }
+      return Success();
    }
 }
 
@@ -397,11 +444,12 @@ Error copyFile(const core::json::JsonRpcRequest& request,
    // compute the source file path
    FilePath sourceFilePath = module_context::resolveAliasedPath(sourcePath);
    
-   // copy directories recursively
+   // copy directories recursively (parallel payload copies, so large
+   // projects approach storage bandwidth rather than one file at a time)
    Error copyError;
    if (sourceFilePath.isDirectory())
    {
-      copyError = file_utils::copyDirectory(sourceFilePath, targetFilePath);
+      copyError = sourceFilePath.copyRecursiveParallel(targetFilePath);
    }
    else
    {
@@ -545,32 +593,6 @@ const char * const kUploadFilename = "filename";
 const char * const kUploadedTempFile = "uploadedTempFile";
 const char * const kUploadTargetDirectory = "targetDirectory";
 
-Error writeTmpData(const FilePath& tmpFile,
-                   const char* buffer,
-                   size_t beginOffset,
-                   size_t endOffset)
-{
-   Error error = tmpFile.ensureFile();
-   if (error)
-      return error;
-
-   std::shared_ptr<std::ostream> pOfs;
-   error = tmpFile.openForWrite(pOfs, false);
-   if (error)
-      return error;
-
-   pOfs->seekp(tmpFile.getSize());
-
-   if (!pOfs->write(buffer + beginOffset, endOffset - beginOffset + 1))
-   {
-      return systemError(boost::system::errc::io_error,
-                         "Could not write to destination file: " + tmpFile.getAbsolutePath(),
-                         ERROR_LOCATION);
-   }
-
-   return Success();
-}
-
 Error completeUpload(const core::json::JsonRpcRequest& request,
                      json::JsonRpcResponse* pResponse)
 {
@@ -757,8 +779,52 @@ struct UploadState
    std::string fileName;
    std::string targetDirectory;
    FilePath tmpFile;
+
+   // spool stream for the temporary file - held open across form data
+   // pieces so each piece is appended without reopening and seeking
+   std::shared_ptr<std::ostream> pOutputStream;
 };
 
+Error writeTmpData(const boost::shared_ptr<UploadState>& pUploadState,
+                   const char* buffer,
+                   size_t beginOffset,
+                   size_t endOffset)
+{
+   if (!pUploadState->pOutputStream)
+   {
+      Error error = pUploadState->tmpFile.ensureFile();
+      if (error)
+         return error;
+
+      error = pUploadState->tmpFile.openForWrite(pUploadState->pOutputStream, false);
+      if (error)
+         return error;
+
+      pUploadState->pOutputStream->seekp(pUploadState->tmpFile.getSize());
+   }
+
+   if (!pUploadState->pOutputStream->write(buffer + beginOffset, endOffset - beginOffset + 1))
+   {
+      return systemError(boost::system::errc::io_error,
+                         "Could not write to destination file: " +
+                            pUploadState->tmpFile.getAbsolutePath(),
+                         ERROR_LOCATION);
+   }
+
+   return Success();
+}
+
+void closeAndRemoveTmpFile(const boost::shared_ptr<UploadState>& pUploadState)
+{
+   // close the spool stream before removing the file so the removal
+   // succeeds on platforms that forbid deleting open files
+   pUploadState->pOutputStream.reset();
+
+   Error error = pUploadState->tmpFile.removeIfExists();
+   if (error)
+      LOG_ERROR(error);
+}
+
 boost::mutex s_uploadMutex;
 std::map<const http::Request*, boost::shared_ptr<UploadState>> s_uploadStateMap;
 
@@ -814,7 +880,7 @@ std::string getBoundary(const http::Request& request)
 // note: this function is invoked on the thread pool and is not handled in an R context
 // therefore, no R methods may be invoked within this function!!
 bool handleFileUploadRequestAsync(const http::Request& request,
-                                  const std::string& formData,
+                                  std::string& formData,
                                   bool complete,
                                   const http::UriHandlerFunctionContinuation& cont)
 {
@@ -956,7 +1022,7 @@ bool handleFileUploadRequestAsync(const http::Request& request,
          size_t pos = formData.rfind(searchStr);
          if (pos == std::string::npos)
          {
-            pUploadState->tmpFile.removeIfExists();
+            closeAndRemoveTmpFile(pUploadState);
             writeError(systemError(boost::system::errc::protocol_error,
                                    "Invalid form data received - final end of header not found",
                                    ERROR_LOCATION));
@@ -972,7 +1038,7 @@ bool handleFileUploadRequestAsync(const http::Request& request,
          if (pUploadState->targetDirectory.empty())
          {
             // didn't find target directory - return an error
-            pUploadState->tmpFile.removeIfExists();
+            closeAndRemoveTmpFile(pUploadState);
             writeParamError();
             return false;
          }
@@ -984,7 +1050,7 @@ bool handleFileUploadRequestAsync(const http::Request& request,
          size_t pos = formData.rfind(searchStr);
          if (pos == std::string::npos)
          {
-            pUploadState->tmpFile.removeIfExists();
+            closeAndRemoveTmpFile(pUploadState);
             writeError(systemError(boost::system::errc::protocol_error,
                                    "Invalid form data received - final end of form not found",
                                    ERROR_LOCATION));
@@ -995,29 +1061,32 @@ bool handleFileUploadRequestAsync(const http::Request& request,
       }
 
       // write the last chunk of file data
-      Error saveError = writeTmpData(pUploadState->tmpFile,
+      Error saveError = writeTmpData(pUploadState,
                                      formData.c_str(),
                                      pUploadState->fileStartPos,
                                      pUploadState->fileEndPos);
       if (saveError)
       {
-         pUploadState->tmpFile.removeIfExists();
+         closeAndRemoveTmpFile(pUploadState);
          writeError(saveError);
          return false;
       }
 
       pUploadState->totalWritten += pUploadState->fileEndPos - pUploadState->fileStartPos + 1;
+
+      // flush and close the spool stream before the file is inspected below
+      pUploadState->pOutputStream.reset();
    }
    else
    {
       // write a chunk of data
-      Error saveError = writeTmpData(pUploadState->tmpFile,
+      Error saveError = writeTmpData(pUploadState,
                                      formData.c_str(),
                                      pUploadState->fileStartPos,
                                      formData.size() - 1);
       if (saveError)
       {
-         pUploadState->tmpFile.removeIfExists();
+         closeAndRemoveTmpFile(pUploadState);
          writeError(saveError);
          return false;
       }
@@ -1031,9 +1100,7 @@ bool handleFileUploadRequestAsync(const http::Request& request,
    if (!validateUploadedFile(pUploadState->tmpFile, &response))
    {
       // user cannot upload files this large - delete the temp file
-      Error error = pUploadState->tmpFile.removeIfExists();
-      if (error)
-         LOG_ERROR(error);
+      closeAndRemoveTmpFile(pUploadState);
 
       cleanupState();
       cont(&response);
@@ -1105,7 +1172,23 @@ void setAttachmentResponse(const http::Request& request,
    pResponse->setHeader("Content-Disposition",
                         "attachment; filename*=UTF-8''"
                            + http::util::urlEncode(filename, false));
-   pResponse->setStreamFile(attachmentPath, request);
+
+   // serve via the rangeable path when the client is resuming or
+   // revalidating an earlier download; otherwise stream the file from
+   // disk, advertising range support and a validator for next time
+   if (!request.headerValue("Range").empty() ||
+       !request.headerValue("If-None-Match").empty())
+   {
+      pResponse->setRangeableFile(attachmentPath, request);
+   }
+   else
+   {
+      std::string eTag = pResponse->eTagForFile(attachmentPath);
+      if (!eTag.empty())
+         pResponse->setHeader("ETag", eTag);
+      pResponse->setHeader("Accept-Ranges", "bytes");
+      pResponse->setStreamFile(attachmentPath, request);
+   }
 }
    
 void handleMultipleFileExportRequest(const http::Request& request, 
@@ -59,10 +59,20 @@ Error FilesListingMonitor::start(const FilePath& filePath, bool includeHidden,
 
    // scan the directory (populates pJsonFiles out parameter)
    std::vector<FilePath> files;
-   Error error = listFiles(filePath, &files, includeHidden, pJsonFiles);
+   std::vector<FilePath> listedFiles;
+   Error error = listFiles(filePath, &files, includeHidden, pJsonFiles,
+                           &listedFiles);
    if (error)
       return error;
 
+   // seed the listing snapshot (kept current from monitor events so that
+   // subsequent listings of this directory don't require a rescan)
+   listingFiles_ = listedFiles;
+   listingObjects_.clear();
+   for (const json::Value& value : *pJsonFiles)
+      listingObjects_.push_back(value.getObject());
+   listingValid_ = true;
+
    // copy the file listing into a vector of FileInfo which we will order so that it can
    // be compared with the initial scan of the file monitor for changes
    std::vector<FileInfo> prevFiles;
@@ -76,7 +86,8 @@ Error FilesListingMonitor::start(const FilePath& filePath, bool includeHidden,
    cb.onRegistered = boost::bind(&FilesListingMonitor::onRegistered,
          this, _1, filePath, prevFiles, _2);
    cb.onRegistrationError = boost::bind(core::log::logError, _1, ERROR_LOCATION);
-   cb.onFilesChanged = boost::bind(module_context::enqueFileChangedEvents, filePath, _1);
+   cb.onFilesChanged = boost::bind(&FilesListingMonitor::onFilesChanged, this, _1);
+   cb.onEventStorm = boost::bind(&FilesListingMonitor::onEventStorm, this);
    cb.onMonitoringError = boost::bind(core::log::logError, _1, ERROR_LOCATION);
    cb.onUnregistered = boost::bind(&FilesListingMonitor::onUnregistered, this, _1);
    if (includeHidden)
@@ -98,6 +109,9 @@ void FilesListingMonitor::stop()
 {
    // reset monitored path and unregister any existing handle
    currentPath_ = FilePath();
+   listingValid_ = false;
+   listingFiles_.clear();
+   listingObjects_.clear();
    if (!currentHandle_.empty())
    {
       core::system::file_monitor::unregisterMonitor(currentHandle_);
@@ -110,6 +124,23 @@ const FilePath& FilesListingMonitor::currentMonitoredPath() const
    return currentPath_;
 }
 
+bool FilesListingMonitor::cachedListing(const FilePath& filePath,
+                                        bool includeHidden,
+                                        json::Array* pJsonFiles) const
+{
+   if (!listingValid_ ||
+       filePath != currentPath_ ||
+       includeHidden != includeHidden_)
+   {
+      return false;
+   }
+
+   for (const json::Object& object : listingObjects_)
+      pJsonFiles->push_back(object);
+
+   return true;
+}
+
 namespace {
 
 // Convert fileInfo returned from file monitor into a normalized path which
@@ -175,9 +206,144 @@ void FilesListingMonitor::onRegistered(core::system::file_monitor::Handle handle
                   prefs::userPrefs().hideObjectFiles()), &events);
    }
 
-   // enqueue any events we discovered
+   // apply any events we discovered to the listing snapshot and
+   // enqueue them for the client
    if (!events.empty())
-      module_context::enqueFileChangedEvents(filePath, events);
+   {
+      applyEventsToListing(events);
+      enqueListingChangedEvent(events);
+   }
+}
+
+void FilesListingMonitor::onFilesChanged(
+                  const std::vector<core::system::FileChangeEvent>& events)
+{
+   // keep the listing snapshot current, then relay to the client
+   applyEventsToListing(events);
+   enqueListingChangedEvent(events);
+}
+
+void FilesListingMonitor::enqueListingChangedEvent(
+                  const std::vector<core::system::FileChangeEvent>& events)
+{
+   if (events.empty())
+      return;
+
+   // decorate relative to the common parent of the events (fall back to
+   // the monitored directory), as enqueFileChangedEvents does
+   FilePath commonParentPath =
+         FilePath(events.front().fileInfo().absolutePath()).getParent();
+   for (const core::system::FileChangeEvent& event : events)
+   {
+      if (!FilePath(event.fileInfo().absolutePath()).isWithin(commonParentPath))
+      {
+         commonParentPath = currentPath_;
+         break;
+      }
+   }
+   auto pCtx = source_control::fileDecorationContext(commonParentPath, true);
+
+   // build the changeset (same per-change record as the file_changed event)
+   json::Array changesJson;
+   for (const core::system::FileChangeEvent& event : events)
+   {
+      json::Object changeJson;
+      changeJson["type"] = event.type();
+      json::Object fileSystemItem =
+                        module_context::createFileSystemItem(event.fileInfo());
+      if (prefs::userPrefs().vcsAutorefresh())
+      {
+         pCtx->decorateFile(FilePath(event.fileInfo().absolutePath()),
+                            &fileSystemItem);
+      }
+      changeJson["file"] = fileSystemItem;
+      changesJson.push_back(changeJson);
+   }
+
+   // relay all of the changes to the client as a single event, stamped
+   // with the next listing generation so the client can detect a missed
+   // changeset and re-list
+   json::Object dataJson;
+   dataJson["directory"] = module_context::createAliasedPath(currentPath_);
+   dataJson["generation"] = ++listingGeneration_;
+   dataJson["changes"] = changesJson;
+   ClientEvent event(client_events::kFileChangeset, dataJson);
+   module_context::enqueClientEvent(event);
+}
+
+void FilesListingMonitor::applyEventsToListing(
+                  const std::vector<core::system::FileChangeEvent>& events)
+{
+   if (!listingValid_)
+      return;
+
+   // decoration context for newly created/updated entries
+   auto pCtx = source_control::fileDecorationContext(currentPath_, false);
+
+   for (const core::system::FileChangeEvent& event : events)
+   {
+      FilePath filePath(event.fileInfo().absolutePath());
+
+      // locate the entry (or its sorted insertion point). note that
+      // isEqualCaseInsensitive is the listing's sort predicate
+      std::vector<FilePath>::iterator it =
+            std::lower_bound(listingFiles_.begin(),
+                             listingFiles_.end(),
+                             filePath,
+                             FilePath::isEqualCaseInsensitive);
+      bool found = it != listingFiles_.end() &&
+                   !FilePath::isEqualCaseInsensitive(filePath, *it);
+      std::size_t idx = it - listingFiles_.begin();
+
+      switch (event.type())
+      {
+      case core::system::FileChangeEvent::FileAdded:
+      case core::system::FileChangeEvent::FileModified:
+      {
+         json::Object fileObject =
+                           module_context::createFileSystemItem(filePath);
+         pCtx->decorateFile(filePath, &fileObject);
+         if (found)
+         {
+            listingObjects_[idx] = fileObject;
+         }
+         else
+         {
+            listingFiles_.insert(it, filePath);
+            listingObjects_.insert(listingObjects_.begin() + idx, fileObject);
+         }
+         break;
+      }
+      case core::system::FileChangeEvent::FileRemoved:
+      {
+         if (found)
+         {
+            listingFiles_.erase(it);
+            listingObjects_.erase(listingObjects_.begin() + idx);
+         }
+         break;
+      }
+      default:
+         break;
+      }
+   }
+}
+
+void FilesListingMonitor::onEventStorm()
+{
+   // a bulk change (e.g. archive extraction into the monitored directory)
+   // produced more events than are worth relaying individually -- have the
+   // client re-list the directory instead (navigating to the current path
+   // triggers a fresh listing, which also restarts monitoring)
+   listingValid_ = false;
+   if (!currentPath_.isEmpty())
+   {
+      json::Object dataJson;
+      dataJson["directory"] = module_context::createAliasedPath(currentPath_);
+      dataJson["activate"] = false;
+      ClientEvent event(client_events::kDirectoryNavigate, dataJson);
+      module_context::enqueClientEvent(event);
+   }
 }
 
 void FilesListingMonitor::onUnregistered(core::system::file_monitor::Handle handle)
@@ -190,13 +356,17 @@ void FilesListingMonitor::onUnregistered(core::system::file_monitor::Handle hand
    {
       currentPath_ = FilePath();
       currentHandle_ = core::system::file_monitor::Handle();
+      listingValid_ = false;
+      listingFiles_.clear();
+      listingObjects_.clear();
    }
 }
 
 Error FilesListingMonitor::listFiles(const FilePath& rootPath,
                                      std::vector<FilePath>* pFiles,
                                      bool includeHidden,
-                                     json::Array* pJsonFiles)
+                                     json::Array* pJsonFiles,
+                                     std::vector<FilePath>* pListedFiles)
 {
    // enumerate the files
    pFiles->clear();
@@ -222,6 +392,10 @@ Error FilesListingMonitor::listFiles(const FilePath& rootPath,
          core::json::Object fileObject = module_context::createFileSystemItem(filePath);
          pCtx->decorateFile(filePath, &fileObject);
          pJsonFiles->push_back(fileObject);
+
+         // record the files included in the listing if requested
+         if (pListedFiles != nullptr)
+            pListedFiles->push_back(filePath);
       }
    }
 
@@ -50,8 +50,13 @@ namespace files {
 class FilesListingMonitor : boost::noncopyable
 {
 public:
+   FilesListingMonitor()
+      : includeHidden_(false), listingValid_(false), listingGeneration_(0)
+   {
+   }
+
    // kickoff monitoring
-   core::Error start(const core::FilePath& filePath, 
+   core::Error start(const core::FilePath& filePath,
          bool includeHidden, core::json::Array* pJsonFiles);
 
    void stop();
@@ -59,6 +64,18 @@ public:
    // what path are we currently monitoring?
    const core::FilePath& currentMonitoredPath() const;
 
+   // retrieve the listing maintained for the currently monitored directory
+   // (returns false if no up-to-date listing is available for the
+   // specified path/options, in which case a full listing is required)
+   bool cachedListing(const core::FilePath& filePath,
+                      bool includeHidden,
+                      core::json::Array* pJsonFiles) const;
+
+   // generation number of the maintained listing. each changeset event
+   // relayed to the client increments it, so the client can detect a
+   // missed changeset and fall back to a full re-listing
+   int listingGeneration() const { return listingGeneration_; }
+
    // convenience method which is also called by listFiles for requests that
    // don't specify monitoring (e.g. file dialog listing)
    static core::Error listFiles(const core::FilePath& rootPath,
@@ -66,7 +83,7 @@ public:
                                 core::json::Array* pJsonFiles)
    {
       std::vector<core::FilePath> files;
-      return listFiles(rootPath, &files, includeHidden, pJsonFiles);
+      return listFiles(rootPath, &files, includeHidden, pJsonFiles, nullptr);
    }
 
 private:
@@ -76,18 +93,37 @@ private:
                      const std::vector<core::FileInfo>& prevFiles,
                      const tree<core::FileInfo>& files);
 
+   void onFilesChanged(
+             const std::vector<core::system::FileChangeEvent>& events);
+
+   void onEventStorm();
+
    void onUnregistered(core::system::file_monitor::Handle handle);
 
+   void applyEventsToListing(
+             const std::vector<core::system::FileChangeEvent>& events);
+
+   void enqueListingChangedEvent(
+             const std::vector<core::system::FileChangeEvent>& events);
+
    // helpers
    static core::Error listFiles(const core::FilePath& rootPath,
                                 std::vector<core::FilePath>* pFiles,
-                                bool includeHidden, 
-                                core::json::Array* pJsonFiles);
+                                bool includeHidden,
+                                core::json::Array* pJsonFiles,
+                                std::vector<core::FilePath>* pListedFiles);
 
 private:
    core::FilePath currentPath_;
    bool includeHidden_;
    core::system::file_monitor::Handle currentHandle_;
+
+   // listing snapshot for the monitored directory, kept current by
+   // applying monitor events (parallel vectors, sorted by path)
+   bool listingValid_;
+   int listingGeneration_;
+   std::vector<core::FilePath> listingFiles_;
+   std::vector<core::json::Object> listingObjects_;
 };
 
 
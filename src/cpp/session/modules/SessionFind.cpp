@@ -16,6 +16,8 @@
 #include "SessionFind.hpp"
 
 #include <algorithm>
+#include <atomic>
+#include <cctype>
 #include <gsl/gsl>
 
 #include <boost/algorithm/string.hpp>
@@ -24,8 +26,11 @@
 #include <boost/filesystem.hpp>
 
 #include <core/Exec.hpp>
+#include <core/FileSerializer.hpp>
 #include <core/StringUtils.hpp>
+#include <core/Thread.hpp>
 #include <core/system/Environment.hpp>
+#include <core/system/FileScanner.hpp>
 #include <core/system/Process.hpp>
 #include <core/system/ShellUtils.hpp>
 
@@ -67,6 +72,17 @@ const size_t MAX_COUNT = 1000;
 
 const size_t MAX_LINE_LENGTH = 1000;
 
+bool shouldSkipFile(const std::string& file)
+{
+   return (file.find("/.Rproj.user/") != std::string::npos ||
+           file.find("/.git/") != std::string::npos ||
+           file.find("/.svn/") != std::string::npos ||
+           file.find("/packrat/lib/") != std::string::npos ||
+           file.find("/packrat/src/") != std::string::npos ||
+           file.find("/renv/library/") != std::string::npos ||
+           file.find("/.Rhistory") != std::string::npos);
+}
+
 // Reflects the estimated current progress made in performing a replace
 class LocalProgress : public boost::noncopyable
 {
@@ -910,17 +926,6 @@ private:
       return Success();
    }
 
-   bool shouldSkipFile(std::string file)
-   {
-      return (file.find("/.Rproj.user/") != std::string::npos ||
-              file.find("/.git/") != std::string::npos ||
-              file.find("/.svn/") != std::string::npos ||
-              file.find("/packrat/lib/") != std::string::npos ||
-              file.find("/packrat/src/") != std::string::npos ||
-              file.find("/renv/library/") != std::string::npos ||
-              file.find("/.Rhistory") != std::string::npos);
-   }
-
    void onStdout(const core::system::ProcessOperations& /*ops*/, const std::string& data)
    {
       json::Array files;
@@ -1149,6 +1154,543 @@ private:
    bool fileSuccess_;
 };
 
+// In-process parallel search engine. Plain finds (no replace, no git
+// exclusions) are serviced by a pool of worker threads which search the
+// file tree directly rather than by shelling out to grep; this avoids
+// per-file process and pipe overhead and scales across cores on large
+// projects. Workers only read files -- results are merged and delivered
+// to the client on the main thread via scheduleIncrementalWork.
+class ParallelFindOperation :
+      public boost::enable_shared_from_this<ParallelFindOperation>
+{
+public:
+   static boost::shared_ptr<ParallelFindOperation> create(
+                                             const std::string& encoding,
+                                             const std::string& searchPattern,
+                                             bool asRegex,
+                                             bool ignoreCase)
+   {
+      return boost::shared_ptr<ParallelFindOperation>(
+            new ParallelFindOperation(encoding, searchPattern,
+                                      asRegex, ignoreCase));
+   }
+
+private:
+   ParallelFindOperation(const std::string& encoding,
+                         const std::string& searchPattern,
+                         bool asRegex,
+                         bool ignoreCase)
+      : encoding_(encoding),
+        searchPattern_(searchPattern),
+        asRegex_(asRegex),
+        ignoreCase_(ignoreCase),
+        nextFile_(0),
+        activeWorkers_(0),
+        cancelled_(false)
+   {
+      handle_ = core::system::generateUuid(false);
+   }
+
+public:
+   std::string handle() const
+   {
+      return handle_;
+   }
+
+   Error start(const std::vector<FilePath>& rootPaths,
+               const std::vector<std::string>& includePatterns,
+               const std::vector<std::string>& excludePatterns)
+   {
+      // compile the search pattern (grep-style expressions, to match the
+      // behavior of the external grep we are replacing)
+      if (asRegex_)
+      {
+         try
+         {
+            boost::regex::flag_type flags = boost::regex::grep;
+            if (ignoreCase_)
+               flags |= boost::regex::icase;
+            pattern_ = boost::regex(searchPattern_, flags);
+         }
+         catch (const boost::regex_error& e)
+         {
+            return Error(
+               errc::findCategory(),
+               errc::RegexError,
+               "Invalid search pattern: " + std::string(e.what()),
+               ERROR_LOCATION);
+         }
+         literalFilter_ = extractLiteralFilter(searchPattern_);
+      }
+      else
+      {
+         literalFilter_ = searchPattern_;
+      }
+
+      // compile include/exclude globs (matched against filenames, as
+      // grep --include/--exclude do)
+      for (const std::string& pattern : includePatterns)
+         includeFilters_.push_back(globToRegex(pattern));
+      for (const std::string& pattern : excludePatterns)
+         excludeFilters_.push_back(globToRegex(pattern));
+
+      // resolve the website output directory on this thread (it consults
+      // session state the enumerator must not touch)
+      websiteOutputDir_ = module_context::websiteOutputDir();
+      if (!websiteOutputDir_.empty())
+         websiteOutputDir_ = "/" + websiteOutputDir_ + "/";
+
+      // enumerate candidate files on a dedicated thread -- the recursive
+      // scan can take a long time on large (especially network-mounted)
+      // projects and must not block the begin_find RPC. the enumerator
+      // counts as an active worker until it has launched the real ones so
+      // flushResults doesn't mistake "not started yet" for completion
+      activeWorkers_ = 1;
+      core::thread::safeLaunchThread(
+         boost::bind(&ParallelFindOperation::runEnumerator,
+                     shared_from_this(),
+                     rootPaths));
+
+      // deliver results on the main thread as they accumulate (even when
+      // no files match we schedule the flush so the operation ended event
+      // is delivered)
+      module_context::scheduleIncrementalWork(
+         boost::posix_time::milliseconds(100),
+         boost::bind(&ParallelFindOperation::flushResults,
+                     shared_from_this()),
+         false);
+
+      return Success();
+   }
+
+private:
+   struct Match
+   {
+      std::string file;
+      int lineNum;
+      std::string preview;
+      std::vector<int> matchOn;
+      std::vector<int> matchOff;
+   };
+
+   static const int kMaxFindWorkers = 8;
+
+   // find the longest run of characters with no special meaning in a
+   // grep (basic) regex; scanning for it with a plain string search lets
+   // workers reject most lines without entering the regex engine
+   static std::string extractLiteralFilter(const std::string& pattern)
+   {
+      // alternation invalidates any single required literal
+      if (pattern.find("\\|") != std::string::npos)
+         return std::string();
+
+      std::string longest, current;
+      for (char ch : pattern)
+      {
+         if (std::isalnum(static_cast<unsigned char>(ch)) ||
+             ch == ' ' || ch == '_' || ch == '-')
+         {
+            current.push_back(ch);
+         }
+         else
+         {
+            // a quantifier or escape can make the preceding character
+            // optional, so drop it from the run
+            if ((ch == '*' || ch == '\\') && !current.empty())
+               current.erase(current.length() - 1);
+            if (current.length() > longest.length())
+               longest = current;
+            current.clear();
+         }
+      }
+      if (current.length() > longest.length())
+         longest = current;
+
+      // very short filters reject too little to pay for themselves
+      return longest.length() >= 3 ? longest : std::string();
+   }
+
+   static boost::regex globToRegex(const std::string& glob)
+   {
+      std::string pattern;
+      for (char ch : glob)
+      {
+         if (ch == '*')
+            pattern.append(".*");
+         else if (ch == '?')
+            pattern.append(".");
+         else if (std::isalnum(static_cast<unsigned char>(ch)))
+            pattern.push_back(ch);
+         else
+         {
+            pattern.push_back('\\');
+            pattern.push_back(ch);
+         }
+      }
+      return boost::regex(pattern);
+   }
+
+   bool matchesFilePatterns(const std::string& filename) const
+   {
+      for (const boost::regex& filter : excludeFilters_)
+      {
+         if (boost::regex_match(filename, filter))
+            return false;
+      }
+
+      if (includeFilters_.empty())
+         return true;
+
+      for (const boost::regex& filter : includeFilters_)
+      {
+         if (boost::regex_match(filename, filter))
+            return true;
+      }
+      return false;
+   }
+
+   // runs on its own thread: walk the file tree, filter candidates, then
+   // hand off to the search workers. workers only start reading files_
+   // once it is fully built (thread creation orders the writes), so the
+   // vector needs no locking
+   void runEnumerator(const std::vector<FilePath>& rootPaths)
+   {
+      for (const FilePath& rootPath : rootPaths)
+      {
+         if (cancelled_)
+            break;
+
+         core::system::FileScannerOptions options;
+         options.recursive = true;
+         tree<FileInfo> scannedFiles;
+         Error error = core::system::scanFiles(FileInfo(rootPath),
+                                               options,
+                                               &scannedFiles);
+         if (error)
+         {
+            // the RPC has already returned; log and search what we can
+            LOG_ERROR(error);
+            continue;
+         }
+
+         for (tree<FileInfo>::iterator it = scannedFiles.begin();
+              it != scannedFiles.end() && !cancelled_;
+              ++it)
+         {
+            const FileInfo& fileInfo = *it;
+            if (fileInfo.isDirectory())
+               continue;
+
+            FilePath filePath(fileInfo.absolutePath());
+            std::string file = module_context::createAliasedPath(filePath);
+            if (shouldSkipFile(file) ||
+                (!websiteOutputDir_.empty() &&
+                 file.find(websiteOutputDir_) != std::string::npos))
+               continue;
+
+            if (!matchesFilePatterns(filePath.getFilename()))
+               continue;
+
+            files_.push_back(filePath);
+         }
+      }
+
+      // launch the workers; add their count before dropping our own so
+      // activeWorkers_ can't touch zero while searching remains
+      int numWorkers = 0;
+      if (!cancelled_)
+      {
+         numWorkers = std::min<int>(
+            std::max<int>(boost::thread::hardware_concurrency(), 1),
+            gsl::narrow_cast<int>(files_.size()));
+         if (numWorkers > kMaxFindWorkers)
+            numWorkers = kMaxFindWorkers;
+      }
+      activeWorkers_ += numWorkers;
+      for (int i = 0; i < numWorkers; i++)
+      {
+         core::thread::safeLaunchThread(
+            boost::bind(&ParallelFindOperation::runWorker,
+                        shared_from_this()));
+      }
+      --activeWorkers_;
+   }
+
+   void runWorker()
+   {
+      bool firstDecodeError = true;
+      while (!cancelled_)
+      {
+         std::size_t index = nextFile_.fetch_add(1);
+         if (index >= files_.size())
+            break;
+         searchFile(files_[index], &firstDecodeError);
+      }
+      --activeWorkers_;
+   }
+
+   bool lineMatchesFilter(const std::string& line) const
+   {
+      if (ignoreCase_)
+         return boost::algorithm::icontains(line, literalFilter_);
+      else
+         return line.find(literalFilter_) != std::string::npos;
+   }
+
+   void searchFile(const FilePath& filePath, bool* pFirstDecodeError)
+   {
+      std::string contents;
+      Error error = core::readStringFromFile(filePath, &contents);
+      if (error)
+         return;
+
+      // skip binary files
+      if (contents.find('\0') != std::string::npos)
+         return;
+
+      // fast literal pre-filter: most files don't contain the search
+      // term at all and can be rejected without line splitting
+      if (!literalFilter_.empty() && !lineMatchesFilter(contents))
+         return;
+
+      std::string file = module_context::createAliasedPath(filePath);
+      int lineNum = 0;
+      std::size_t pos = 0;
+      while (pos <= contents.size() && !cancelled_)
+      {
+         std::size_t endPos = contents.find('\n', pos);
+         std::size_t lineEnd =
+            (endPos == std::string::npos) ? contents.size() : endPos;
+         std::string line = contents.substr(pos, lineEnd - pos);
+         pos = lineEnd + 1;
+         lineNum++;
+
+         if (!line.empty() && line[line.size() - 1] == '\r')
+            line.erase(line.size() - 1);
+
+         if (!literalFilter_.empty() && !lineMatchesFilter(line))
+            continue;
+
+         if (!encoding_.empty())
+            line = Replacer::decode(line, encoding_, *pFirstDecodeError);
+
+         // the client displays (and indexes matches within) trimmed lines
+         boost::algorithm::trim(line);
+         if (line.empty())
+            continue;
+
+         Match match;
+         if (!findMatches(line, &match))
+            continue;
+         match.file = file;
+         match.lineNum = lineNum;
+         resultQueue_.enque(match);
+      }
+   }
+
+   bool findMatches(const std::string& line, Match* pMatch)
+   {
+      std::vector<std::size_t> byteOn, byteOff;
+      if (asRegex_)
+      {
+         const char* begin = line.c_str();
+         const char* inputPos = begin;
+         boost::cmatch match;
+         while (regex_utils::search(inputPos, match, pattern_))
+         {
+            // guard against zero-length matches
+            if (match.length() == 0)
+               break;
+            byteOn.push_back((inputPos - begin) + match.position());
+            byteOff.push_back(
+               (inputPos - begin) + match.position() + match.length());
+            inputPos += match.position() + match.length();
+         }
+      }
+      else
+      {
+         std::string haystack(line);
+         std::string needle(searchPattern_);
+         if (ignoreCase_)
+         {
+            boost::algorithm::to_lower(haystack);
+            boost::algorithm::to_lower(needle);
+         }
+         std::size_t offset = haystack.find(needle);
+         while (offset != std::string::npos)
+         {
+            byteOn.push_back(offset);
+            byteOff.push_back(offset + needle.size());
+            offset = haystack.find(needle, offset + needle.size());
+         }
+      }
+
+      if (byteOn.empty())
+         return false;
+
+      // convert byte offsets to UTF-8 character offsets for the client
+      for (std::size_t i = 0; i < byteOn.size(); i++)
+      {
+         std::size_t charOn = byteOn[i];
+         std::size_t charOff = byteOff[i];
+         Error error = string_utils::utf8Distance(
+            line.begin(), line.begin() + byteOn[i], &charOn);
+         if (!error)
+            error = string_utils::utf8Distance(
+               line.begin(), line.begin() + byteOff[i], &charOff);
+         pMatch->matchOn.push_back(gsl::narrow_cast<int>(charOn));
+         pMatch->matchOff.push_back(gsl::narrow_cast<int>(charOff));
+      }
+
+      pMatch->preview = line;
+      adjustPreview(pMatch);
+      return true;
+   }
+
+   // mirrors GrepOperation's preview adjustment: long lines are
+   // truncated around the first match
+   void adjustPreview(Match* pMatch)
+   {
+      const std::size_t maxPreviewLength = 300;
+      if (pMatch->preview.size() <= maxPreviewLength)
+         return;
+
+      std::size_t firstMatchOn = pMatch->matchOn.front();
+      if (firstMatchOn > maxPreviewLength)
+      {
+         pMatch->preview.erase(0, firstMatchOn - 30);
+         pMatch->preview.insert(0, "...");
+         int offset = gsl::narrow_cast<int>(firstMatchOn - 33);
+         for (std::size_t i = 0; i < pMatch->matchOn.size(); i++)
+         {
+            pMatch->matchOn[i] -= offset;
+            pMatch->matchOff[i] -= offset;
+         }
+      }
+      if (pMatch->preview.size() > maxPreviewLength)
+      {
+         pMatch->preview.erase(maxPreviewLength);
+         pMatch->preview.append("...");
+      }
+   }
+
+   // invoked on the main thread to merge worker results and deliver
+   // them to the client
+   bool flushResults()
+   {
+      // the client may have stopped this find (or begun another one)
+      if (!findResults().isRunning() || findResults().handle() != handle())
+         cancelled_ = true;
+
+      // note worker status before draining so results enqueued during
+      // the drain are not mistaken for completion
+      bool workersDone = (activeWorkers_ == 0);
+
+      json::Array files;
+      json::Array lineNums;
+      json::Array contents;
+      json::Array matchOns;
+      json::Array matchOffs;
+      json::Array replaceMatchOns;
+      json::Array replaceMatchOffs;
+      json::Array errors;
+
+      int recordsToProcess =
+         gsl::narrow_cast<int>(MAX_COUNT) + 1 - findResults().resultCount();
+      if (recordsToProcess < 0)
+         recordsToProcess = 0;
+
+      bool drained = false;
+      Match match;
+      while (!cancelled_ && recordsToProcess > 0)
+      {
+         if (!resultQueue_.deque(&match))
+         {
+            drained = true;
+            break;
+         }
+
+         files.push_back(match.file);
+         lineNums.push_back(match.lineNum);
+         contents.push_back(match.preview);
+
+         json::Array matchOn, matchOff;
+         for (std::size_t i = 0; i < match.matchOn.size(); i++)
+         {
+            matchOn.push_back(match.matchOn[i]);
+            matchOff.push_back(match.matchOff[i]);
+         }
+         matchOns.push_back(matchOn);
+         matchOffs.push_back(matchOff);
+
+         // replace info and errors don't apply to plain finds but the
+         // client expects the arrays to be parallel
+         replaceMatchOns.push_back(json::Array());
+         replaceMatchOffs.push_back(json::Array());
+         errors.push_back(json::Array());
+         recordsToProcess--;
+      }
+
+      if (files.getSize() > 0)
+      {
+         json::Object result;
+         result["handle"] = handle();
+         json::Object results;
+         results["file"] = files;
+         results["line"] = lineNums;
+         results["lineValue"] = contents;
+         results["matchOn"] = matchOns;
+         results["matchOff"] = matchOffs;
+         results["replaceMatchOn"] = replaceMatchOns;
+         results["replaceMatchOff"] = replaceMatchOffs;
+         results["errors"] = errors;
+         result["results"] = results;
+
+         findResults().addResult(handle(),
+                                 files,
+                                 lineNums,
+                                 contents,
+                                 matchOns,
+                                 matchOffs,
+                                 replaceMatchOns,
+                                 replaceMatchOffs);
+
+         module_context::enqueClientEvent(
+               ClientEvent(client_events::kFindResult, result));
+      }
+
+      // stop the workers once the result limit has been reached
+      if (!cancelled_ && recordsToProcess <= 0)
+         cancelled_ = true;
+
+      if (cancelled_ || (workersDone && drained))
+      {
+         findResults().onFindEnd(handle());
+         module_context::enqueClientEvent(
+               ClientEvent(client_events::kFindOperationEnded, handle()));
+         return false;
+      }
+
+      return true;
+   }
+
+   std::string handle_;
+   std::string encoding_;
+   std::string searchPattern_;
+   bool asRegex_;
+   bool ignoreCase_;
+   boost::regex pattern_;
+   std::string literalFilter_;
+   std::string websiteOutputDir_;
+   std::vector<boost::regex> includeFilters_;
+   std::vector<boost::regex> excludeFilters_;
+   std::vector<FilePath> files_;
+   std::atomic<std::size_t> nextFile_;
+   std::atomic<int> activeWorkers_;
+   std::atomic<bool> cancelled_;
+   core::thread::ThreadsafeQueue<Match> resultQueue_;
+};
+
 } // namespace
 
 class GrepOptions : public boost::noncopyable
@@ -1477,6 +2019,74 @@ core::Error runGrepOperation(const GrepOptions& grepOptions, const ReplaceOption
    return Success();
 }
 
+core::Error runParallelFindOperation(const GrepOptions& grepOptions,
+                                     json::JsonRpcResponse* pResponse)
+{
+   std::string encoding = projects::projectContext().hasProject() ?
+                          projects::projectContext().defaultEncoding() :
+                          prefs::userPrefs().defaultEncoding();
+
+   FilePath dirPath = module_context::resolveAliasedPath(grepOptions.directory());
+
+   // resolve search roots the same way the grep command line does
+   std::vector<FilePath> rootPaths;
+   if (!grepOptions.anyPackageFlag())
+   {
+      rootPaths.push_back(dirPath);
+   }
+   else if (grepOptions.packageSourceFlag())
+   {
+      FilePath rPath = dirPath.completePath("R");
+      FilePath srcPath = dirPath.completePath("src");
+      if (rPath.exists())
+         rootPaths.push_back(rPath);
+      if (srcPath.exists())
+         rootPaths.push_back(srcPath);
+      else if (!rPath.exists())
+         LOG_WARNING_MESSAGE(
+            "Package source directories not found in " + dirPath.getAbsolutePath());
+   }
+   else
+   {
+      FilePath testsPath = dirPath.completePath("tests");
+      if (testsPath.exists())
+         rootPaths.push_back(testsPath);
+      else
+         LOG_WARNING_MESSAGE(
+            "Package test directory not found in " + dirPath.getAbsolutePath());
+   }
+
+   // strip the grep argument prefixes from the file patterns
+   std::vector<std::string> includePatterns, excludePatterns;
+   for (const std::string& arg : grepOptions.includeArgs())
+      includePatterns.push_back(arg.substr(std::string("--include=").length()));
+   for (const std::string& arg : grepOptions.excludeArgs())
+      excludePatterns.push_back(arg.substr(std::string("--exclude=").length()));
+
+   boost::shared_ptr<ParallelFindOperation> ptrFindOp =
+         ParallelFindOperation::create(encoding,
+                                       grepOptions.searchPattern(),
+                                       grepOptions.asRegex(),
+                                       grepOptions.ignoreCase());
+
+   // clear existing results
+   findResults().clear();
+
+   Error error = ptrFindOp->start(rootPaths, includePatterns, excludePatterns);
+   if (error)
+      return error;
+
+   findResults().onFindBegin(ptrFindOp->handle(),
+                             grepOptions.searchPattern(),
+                             grepOptions.directory(),
+                             grepOptions.asRegex(),
+                             grepOptions.ignoreCase(),
+                             grepOptions.gitFlag());
+   pResponse->setResult(ptrFindOp->handle());
+
+   return Success();
+}
+
 core::Error beginFind(const json::JsonRpcRequest& request,
                       json::JsonRpcResponse* pResponse)
 {
@@ -1497,6 +2107,12 @@ core::Error beginFind(const json::JsonRpcRequest& request,
 
    GrepOptions grepOptions(searchString, directory, includeFilePatterns, excludeFilePatterns,
       asRegex, ignoreCase);
+
+   // plain finds run on the in-process parallel engine; git-aware
+   // searches still shell out so we inherit git's exclusion semantics
+   if (!grepOptions.gitFlag())
+      return runParallelFindOperation(grepOptions, pResponse);
+
    error = runGrepOperation(grepOptions, ReplaceOptions(), nullptr, pResponse);
    return error;
 }
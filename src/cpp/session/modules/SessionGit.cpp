@@ -14,6 +14,9 @@
  */
 #include "SessionGit.hpp"
 
+#include <ctime>
+#include <set>
+
 #include <gsl/gsl>
 
 #include <signal.h>
@@ -47,6 +50,7 @@
 #include <core/system/System.hpp>
 #include <core/system/Process.hpp>
 #include <core/system/Environment.hpp>
+#include <core/Diff.hpp>
 #include <core/Exec.hpp>
 #include <core/FileSerializer.hpp>
 #include <core/GitGraph.hpp>
@@ -514,17 +518,31 @@ public:
 
    core::Error status(const FilePath& dir,
                       StatusResult* pStatusResult)
+   {
+      ShellArgs arguments = gitArgs();
+      arguments << "status" << "-z" << "--porcelain" << "--" << dir;
+      return runStatus(arguments, pStatusResult);
+   }
+
+   // targeted status limited to the given paths (used by the
+   // incremental status cache)
+   core::Error status(const std::vector<FilePath>& paths,
+                      StatusResult* pStatusResult)
+   {
+      ShellArgs arguments = gitArgs();
+      arguments << "status" << "-z" << "--porcelain" << "--" << paths;
+      return runStatus(arguments, pStatusResult);
+   }
+
+private:
+   core::Error runStatus(const ShellArgs& arguments,
+                         StatusResult* pStatusResult)
    {
       using namespace boost;
 
       // objects to be populated from git's output
       std::vector<FileWithStatus> files;
-      
-      // build shell arguments
-      ShellArgs arguments = gitArgs();
-      
-      arguments << "status" << "-z" << "--porcelain" << "--" << dir;
-      
+
       std::string output;
       Error error = runGit(arguments, &output);
       if (error)
@@ -567,6 +585,7 @@ public:
       return Success();
    }
 
+public:
    core::Error add(const std::vector<FilePath>& filePaths)
    {
       return runGit(gitArgs() << "add" << "--" << filePaths);
@@ -1095,14 +1114,22 @@ public:
             return error;
          if (status.status() == "??" && mode == PatchModeWorking)
          {
-            error = doDiffFile(filePath,
-                               &(shell_utils::devnull()),
-                               mode,
-                               contextLines,
-                               ignoreWhitespace,
-                               pOutput);
+            // untracked file: git has nothing to diff it against, so
+            // build the all-added patch in-process rather than forking
+            // a second git to compare against /dev/null
+            std::string contents;
+            error = core::readStringFromFile(filePath, &contents);
             if (error)
                return error;
+
+            std::string relativePath = filePath.isWithin(root_) ?
+                     filePath.getRelativePath(root_) :
+                     filePath.getFilename();
+            *pOutput = diff::unifiedDiff("/dev/null",
+                                         std::string(),
+                                         "b/" + relativePath,
+                                         contents,
+                                         contextLines);
          }
       }
 
@@ -1482,6 +1509,171 @@ public:
 
 Git s_git_;
 
+// Incremental status engine. Maintains the most recent whole-repository
+// StatusResult and keeps it current by feeding paths from file monitor
+// change events into targeted `git status -- <paths>` calls; full
+// rescans only occur when repository state changes underneath us (HEAD
+// or index modifications from commits, branch switches, staging, etc.)
+// or when a burst of changes makes targeted updates uneconomical.
+class GitStatusCache : boost::noncopyable
+{
+public:
+   GitStatusCache()
+      : monitoring_(false),
+        valid_(false),
+        lastHeadTime_(0),
+        lastIndexTime_(0)
+   {
+   }
+
+   void onMonitoringEnabled()
+   {
+      monitoring_ = true;
+      invalidate();
+   }
+
+   void onMonitoringDisabled()
+   {
+      monitoring_ = false;
+      invalidate();
+   }
+
+   void invalidate()
+   {
+      valid_ = false;
+      pendingPaths_.clear();
+   }
+
+   void onFilesChanged(const std::vector<core::system::FileChangeEvent>& events)
+   {
+      FilePath rootDir = s_git_.root();
+      if (rootDir.isEmpty() || !valid_)
+         return;
+
+      for (const core::system::FileChangeEvent& event : events)
+      {
+         FilePath filePath(event.fileInfo().absolutePath());
+         if (filePath.isWithin(rootDir))
+            pendingPaths_.insert(filePath);
+      }
+
+      // once a change burst exceeds this many paths a single full
+      // rescan is cheaper than long pathspec invocations
+      if (pendingPaths_.size() > kMaxPendingPaths)
+         invalidate();
+   }
+
+   core::Error status(StatusResult* pStatusResult)
+   {
+      // without file monitoring we can't observe working tree changes,
+      // so preserve the previous always-rescan behavior
+      if (monitoring_)
+         checkRepoState();
+      else
+         invalidate();
+
+      if (!valid_)
+      {
+         Error error = s_git_.status(s_git_.root(), &cached_);
+         if (error)
+            return error;
+         valid_ = true;
+         pendingPaths_.clear();
+      }
+      else if (!pendingPaths_.empty())
+      {
+         std::vector<FilePath> paths(pendingPaths_.begin(),
+                                     pendingPaths_.end());
+         StatusResult updated;
+         Error error = s_git_.status(paths, &updated);
+         if (error)
+         {
+            // fall back to a full rescan on the next query
+            invalidate();
+            return error;
+         }
+         applyUpdate(paths, updated);
+         pendingPaths_.clear();
+      }
+
+      *pStatusResult = cached_;
+      return Success();
+   }
+
+private:
+   static const std::size_t kMaxPendingPaths = 100;
+
+   // the project file monitor doesn't watch .git, so commits, branch
+   // switches, and staging (including git run outside of RStudio) are
+   // detected by checking HEAD and the index for modification
+   void checkRepoState()
+   {
+      FilePath gitDir = s_git_.root().completeChildPath(".git");
+      FilePath headPath = gitDir.completeChildPath("HEAD");
+      if (!headPath.exists())
+      {
+         // non-standard repository layout (e.g. worktree); don't
+         // attempt to cache
+         invalidate();
+         return;
+      }
+
+      std::time_t headTime = headPath.getLastWriteTime();
+      std::time_t indexTime =
+            gitDir.completeChildPath("index").getLastWriteTime();
+      if (headTime != lastHeadTime_ || indexTime != lastIndexTime_)
+      {
+         invalidate();
+         lastHeadTime_ = headTime;
+         lastIndexTime_ = indexTime;
+      }
+   }
+
+   void applyUpdate(const std::vector<FilePath>& paths,
+                    const StatusResult& updated)
+   {
+      // drop cached entries covered by the refreshed paths. coverage
+      // runs in both directions because git collapses wholly untracked
+      // directories into a single entry
+      std::vector<FileWithStatus> files;
+      for (const FileWithStatus& file : cached_.files())
+      {
+         bool covered = false;
+         for (const FilePath& path : paths)
+         {
+            if (file.path == path ||
+                file.path.isWithin(path) ||
+                path.isWithin(file.path))
+            {
+               covered = true;
+               break;
+            }
+         }
+         if (!covered)
+            files.push_back(file);
+      }
+
+      // then merge in the fresh results
+      for (const FileWithStatus& file : updated.files())
+         files.push_back(file);
+
+      cached_ = StatusResult(files);
+   }
+
+   bool monitoring_;
+   bool valid_;
+   StatusResult cached_;
+   std::set<FilePath> pendingPaths_;
+   std::time_t lastHeadTime_;
+   std::time_t lastIndexTime_;
+};
+
+GitStatusCache& gitStatusCache()
+{
+   static GitStatusCache instance;
+   return instance;
+}
+
 FilePath resolveAliasedPath(const std::string& path)
 {
    if (boost::algorithm::starts_with(path, "~/"))
@@ -1609,6 +1801,11 @@ core::Error status(const FilePath& dir, StatusResult* pStatusResult)
    if (s_git_.root().isEmpty())
       return Success();
 
+   // the common whole-repository query is served from the incremental
+   // status cache
+   if (dir == s_git_.root())
+      return gitStatusCache().status(pStatusResult);
+
    return s_git_.status(dir, pStatusResult);
 }
 
@@ -1798,7 +1995,7 @@ Error vcsFullStatus(const json::JsonRpcRequest&,
                     json::JsonRpcResponse* pResponse)
 {
    StatusResult statusResult;
-   Error error = s_git_.status(s_git_.root(), &statusResult);
+   Error error = gitStatusCache().status(&statusResult);
    if (error)
       return error;
 
@@ -3203,6 +3400,21 @@ void onResume(const core::Settings&)
    enqueueRefreshEvent();
 }
 
+void onFileMonitoringEnabled(const tree<core::FileInfo>&)
+{
+   gitStatusCache().onMonitoringEnabled();
+}
+
+void onFileMonitoringDisabled()
+{
+   gitStatusCache().onMonitoringDisabled();
+}
+
+void onFilesChanged(const std::vector<core::system::FileChangeEvent>& events)
+{
+   gitStatusCache().onFilesChanged(events);
+}
+
 bool initGitBin()
 {
    Error error;
@@ -3373,6 +3585,14 @@ core::Error initialize()
    // add settings changed handler
    prefs::userPrefs().onChanged.connect(onUserSettingsChanged);
 
+   // subscribe to file monitor changes so the status cache can be
+   // updated incrementally (if there is no project this will no-op)
+   projects::FileMonitorCallbacks cb;
+   cb.onMonitoringEnabled = onFileMonitoringEnabled;
+   cb.onFilesChanged = onFilesChanged;
+   cb.onMonitoringDisabled = onFileMonitoringDisabled;
+   projects::projectContext().subscribeToFileMonitor("Git status", cb);
+
    // install rpc methods
    using boost::bind;
    using namespace module_context;
@@ -65,6 +65,22 @@ namespace html_preview {
 
 namespace {
 
+// per-file block caches so that re-previewing a document only re-renders
+// the markdown blocks which changed since the last preview
+std::map<std::string, markdown::HTMLBlockCache> s_markdownBlockCaches;
+const std::size_t kMaxMarkdownBlockCaches = 8;
+
+markdown::HTMLBlockCache* markdownBlockCache(const FilePath& targetFile)
+{
+   std::string key = targetFile.getAbsolutePath();
+   if (s_markdownBlockCaches.count(key) == 0 &&
+       s_markdownBlockCaches.size() >= kMaxMarkdownBlockCaches)
+   {
+      s_markdownBlockCaches.clear();
+   }
+   return &s_markdownBlockCaches[key];
+}
+
 void enqueHTMLPreviewSucceeded(const std::string& title,
                                const std::string& previewUrl,
                                const FilePath& sourceFile,
@@ -370,12 +386,14 @@ private:
             // highlighting, base64 encoding, etc.)
             isInternalMarkdown_ = true;
 
-            // run markdownToHTML
+            // run markdownToHTML (incrementally, against the blocks
+            // rendered by the previous preview of this file)
             std::string htmlContent;
             Error error = markdown::markdownToHTML(
                                             content,
                                             markdown::Extensions(),
                                             markdown::HTMLOptions(),
+                                            markdownBlockCache(targetFile_),
                                             &htmlContent);
             if (error)
             {
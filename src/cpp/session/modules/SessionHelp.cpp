@@ -50,7 +50,9 @@
 #include <r/session/RSessionUtils.hpp>
 
 #include <session/SessionModuleContext.hpp>
+#include <session/SessionPackageProvidedExtension.hpp>
 #include <session/SessionPersistentState.hpp>
+#include <session/SessionUriContentCache.hpp>
 
 #include <session/prefs/UserPrefs.hpp>
 
@@ -484,9 +486,11 @@ void handleHttpdResult(SEXP httpdSEXP,
          // get file path
          FilePath filePath(fileName);
          
-         // read file contents
+         // read file contents (help pages and their static assets are
+         // re-requested frequently while browsing, so go through the
+         // shared content cache)
          std::string contents;
-         Error error = readStringFromFile(filePath, &contents);
+         Error error = content_cache::readCachedFile(filePath, &contents);
          if (error)
          {
             pResponse->setError(error);
@@ -999,12 +1003,171 @@ SEXP rs_showPythonHelp(SEXP codeSEXP)
    return R_NilValue;
 }
 
+// index of help topic aliases by package directory. built incrementally
+// by the package indexer, persisted across sessions, and served to the
+// 'suggest_topics' handler so F1 lookups don't re-read files per query
+std::map< std::string, std::vector<std::string> > s_helpTopicIndex;
+
+FilePath helpTopicIndexFilePath()
+{
+   return module_context::scopedScratchPath().completePath(
+                                                "help_topic_index");
+}
+
+std::vector<std::string> readAnIndexTopics(const FilePath& anIndexPath)
+{
+   std::vector<std::string> topics;
+
+   std::string contents;
+   Error error = core::readStringFromFile(anIndexPath,
+                                          &contents,
+                                          string_utils::LineEndingPosix);
+   if (error)
+   {
+      LOG_ERROR(error);
+      return topics;
+   }
+
+   // each line of AnIndex maps '<alias>\t<file>'
+   std::vector<std::string> lines;
+   boost::algorithm::split(lines, contents, boost::is_any_of("\n"));
+   for (const std::string& line : lines)
+   {
+      std::string::size_type tabPos = line.find('\t');
+      if (tabPos != std::string::npos && tabPos > 0)
+         topics.push_back(line.substr(0, tabPos));
+   }
+
+   return topics;
+}
+
+void saveHelpTopicIndex()
+{
+   std::ostringstream ostr;
+   for (const std::pair<const std::string, std::vector<std::string> >&
+                                             entry : s_helpTopicIndex)
+   {
+      ostr << entry.first;
+      for (const std::string& topic : entry.second)
+         ostr << "\t" << topic;
+      ostr << "\n";
+   }
+
+   Error error = core::writeStringToFile(helpTopicIndexFilePath(),
+                                         ostr.str());
+   if (error)
+      LOG_ERROR(error);
+}
+
+void loadHelpTopicIndex()
+{
+   FilePath indexFilePath = helpTopicIndexFilePath();
+   if (!indexFilePath.exists())
+      return;
+
+   std::string contents;
+   Error error = core::readStringFromFile(indexFilePath,
+                                          &contents,
+                                          string_utils::LineEndingPosix);
+   if (error)
+   {
+      LOG_ERROR(error);
+      return;
+   }
+
+   std::vector<std::string> lines;
+   boost::algorithm::split(lines, contents, boost::is_any_of("\n"));
+   for (const std::string& line : lines)
+   {
+      if (line.empty())
+         continue;
+
+      std::vector<std::string> fields;
+      boost::algorithm::split(fields, line, boost::is_any_of("\t"));
+      std::vector<std::string> topics(fields.begin() + 1, fields.end());
+      s_helpTopicIndex[fields[0]] = topics;
+   }
+}
+
+class HelpTopicIndexWorker : public ppe::Worker
+{
+   void onIndexingStarted()
+   {
+      index_.clear();
+   }
+
+   void onWork(const std::string& pkgName, const FilePath& anIndexPath)
+   {
+      // the resource path addresses '<package>/help/AnIndex'
+      std::string pkgPath =
+            anIndexPath.getParent().getParent().getAbsolutePath();
+      index_[pkgPath] = readAnIndexTopics(anIndexPath);
+   }
+
+   void onIndexingCompleted(json::Object* pPayload)
+   {
+      s_helpTopicIndex = index_;
+      saveHelpTopicIndex();
+   }
+
+public:
+
+   HelpTopicIndexWorker() : ppe::Worker("help/AnIndex") {}
+
+private:
+   std::map< std::string, std::vector<std::string> > index_;
+};
+
+boost::shared_ptr<HelpTopicIndexWorker>& helpTopicIndexWorker()
+{
+   static boost::shared_ptr<HelpTopicIndexWorker> instance(
+                                          new HelpTopicIndexWorker());
+   return instance;
+}
+
+SEXP rs_getHelpTopics(SEXP pkgPathsSEXP)
+{
+   std::vector<std::string> pkgPaths;
+   if (!r::sexp::fillVectorString(pkgPathsSEXP, &pkgPaths))
+      return R_NilValue;
+
+   std::vector<std::string> topics;
+   for (const std::string& pkgPath : pkgPaths)
+   {
+      std::map< std::string, std::vector<std::string> >::iterator it =
+                                       s_helpTopicIndex.find(pkgPath);
+      if (it == s_helpTopicIndex.end())
+      {
+         // index on demand (e.g. a package loaded from a development
+         // library the background indexer hasn't visited)
+         std::vector<std::string> pkgTopics;
+         FilePath anIndexPath =
+               FilePath(pkgPath).completeChildPath("help/AnIndex");
+         if (anIndexPath.exists())
+            pkgTopics = readAnIndexTopics(anIndexPath);
+         it = s_helpTopicIndex.insert(
+                  std::make_pair(pkgPath, pkgTopics)).first;
+      }
+
+      topics.insert(topics.end(), it->second.begin(), it->second.end());
+   }
+
+   r::sexp::Protect protect;
+   return r::sexp::create(topics, &protect);
+}
+
 } // anonymous namespace
    
 Error initialize()
 {
    RS_REGISTER_CALL_METHOD(rs_previewRd, 1);
    RS_REGISTER_CALL_METHOD(rs_showPythonHelp, 1);
+   RS_REGISTER_CALL_METHOD(rs_getHelpTopics, 1);
+
+   // restore the persisted help topic index (refreshed in the
+   // background by the package indexer)
+   loadHelpTopicIndex();
+   ppe::indexer().addWorker(helpTopicIndexWorker());
 
    using boost::bind;
    using core::http::UriHandler;
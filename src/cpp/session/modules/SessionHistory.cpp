@@ -360,31 +360,34 @@ Error searchHistoryArchiveByPrefix(const json::JsonRpcRequest& request,
    
    // trim the prefix
    boost::algorithm::trim(prefix);
-   
-   // examine the items in the history for matches
-   const std::vector<HistoryEntry>& allEntries = historyArchive().entries();
-   std::set<std::string> matchedCommands;
+
    std::vector<HistoryEntry> matchingEntries;
-   for (std::vector<HistoryEntry>::const_reverse_iterator 
-        it = allEntries.rbegin();
-        it != allEntries.rend();
-        ++it)
+   if (uniqueOnly)
    {
-      // check limit
-      if (matchingEntries.size() >= static_cast<std::size_t>(maxEntries))
-         break;
-      
-      // look for match 
-      if (boost::algorithm::starts_with(it->command, prefix))
+      // serve from the archive's sorted command index -- logarithmic in
+      // the archive size rather than a scan of every entry, which is what
+      // keeps up-arrow navigation responsive with very large histories
+      historyArchive().searchByPrefix(prefix, maxEntries, &matchingEntries);
+   }
+   else
+   {
+      // duplicates requested: scan the entries directly
+      const std::vector<HistoryEntry>& allEntries = historyArchive().entries();
+      for (std::vector<HistoryEntry>::const_reverse_iterator
+           it = allEntries.rbegin();
+           it != allEntries.rend();
+           ++it)
       {
-         if (!uniqueOnly || (matchedCommands.count(it->command) == 0))
-         {
+         // check limit
+         if (matchingEntries.size() >= static_cast<std::size_t>(maxEntries))
+            break;
+
+         // look for match
+         if (boost::algorithm::starts_with(it->command, prefix))
             matchingEntries.push_back(*it);
-            matchedCommands.insert(it->command);
-         }
       }
    }
-   
+
    // return json
    json::Object entriesJson;
    historyEntriesAsJson(matchingEntries, &entriesJson);
@@ -15,8 +15,12 @@
 
 #include "SessionHistoryArchive.hpp"
 
+#include <algorithm>
+#include <functional>
 #include <string>
 
+#include <boost/algorithm/string/predicate.hpp>
+
 #include <shared_core/Error.hpp>
 #include <core/Log.hpp>
 #include <shared_core/FilePath.hpp>
@@ -129,20 +133,41 @@ HistoryArchive& historyArchive()
 
 Error HistoryArchive::add(const std::string& command)
 {
-   // reset the cache (since this write will invalidate the current one,
-   // no sense in keeping our cache around in memory)
-   entries_.clear();
-   entryCacheLastWriteTime_ = -1;
-
    // rotate if necessary
    rotateHistoryDatabase();
 
+   // determine whether the in-memory cache can be maintained incrementally:
+   // possible whenever it is still current with respect to the file we are
+   // about to append to. this keeps search and pagination from re-reading
+   // and re-parsing the entire database after every console command
+   FilePath historyDB = historyDatabaseFilePath();
+   bool updateCache = (entryCacheLastWriteTime_ != -1) &&
+                      historyDB.exists() &&
+                      (historyDB.getLastWriteTime() == entryCacheLastWriteTime_);
+
    // write the entry to the file
    std::ostringstream ostrEntry;
    double currentTime = core::date_time::millisecondsSinceEpoch();
    writeEntry(currentTime, command, &ostrEntry);
    ostrEntry << std::endl;
-   return appendToFile(historyDatabaseFilePath(), ostrEntry.str());
+   Error error = appendToFile(historyDB, ostrEntry.str());
+
+   // on any error (or when the cache was already stale, e.g. another
+   // session also appended) reset the cache and let entries() rebuild it
+   if (error || !updateCache)
+   {
+      entries_.clear();
+      commandIndex_.clear();
+      entryCacheLastWriteTime_ = -1;
+      return error;
+   }
+
+   // append to the cache and keep its write time in sync with the file
+   int nextIndex = entries_.empty() ? 0 : entries_.back().index + 1;
+   entries_.push_back(HistoryEntry(nextIndex, currentTime, command));
+   commandIndex_[command] = entries_.size() - 1;
+   entryCacheLastWriteTime_ = historyDB.getLastWriteTime();
+   return Success();
 }
 
 const std::vector<HistoryEntry>& HistoryArchive::entries() const
@@ -154,6 +179,7 @@ const std::vector<HistoryEntry>& HistoryArchive::entries() const
    if (!historyDBPath.exists())
    {
       entries_.clear();
+      commandIndex_.clear();
    }
 
    // otherwise check for divergent lastWriteTime and read the file
@@ -197,12 +223,50 @@ const std::vector<HistoryEntry>& HistoryArchive::entries() const
          entryCacheLastWriteTime_ = historyDBPath.getLastWriteTime();
       }
 
+      rebuildCommandIndex();
    }
 
    // return entries
    return entries_;
 }
 
+void HistoryArchive::rebuildCommandIndex() const
+{
+   commandIndex_.clear();
+   for (std::size_t i = 0; i < entries_.size(); i++)
+      commandIndex_[entries_[i].command] = i;
+}
+
+void HistoryArchive::searchByPrefix(const std::string& prefix,
+                                    int maxEntries,
+                                    std::vector<HistoryEntry>* pEntries) const
+{
+   // ensure the entry cache (and with it the command index) is current
+   const std::vector<HistoryEntry>& allEntries = entries();
+
+   // walk the contiguous range of commands sharing the prefix
+   std::vector<std::size_t> matchPositions;
+   for (std::map<std::string, std::size_t>::const_iterator it =
+           commandIndex_.lower_bound(prefix);
+        it != commandIndex_.end();
+        ++it)
+   {
+      if (!boost::algorithm::starts_with(it->first, prefix))
+         break;
+      matchPositions.push_back(it->second);
+   }
+
+   // most recent first, capped at the requested number of entries
+   std::sort(matchPositions.begin(),
+             matchPositions.end(),
+             std::greater<std::size_t>());
+   if (matchPositions.size() > static_cast<std::size_t>(maxEntries))
+      matchPositions.resize(maxEntries);
+
+   for (std::size_t position : matchPositions)
+      pEntries->push_back(allEntries[position]);
+}
+
 void HistoryArchive::migrateRhistoryIfNecessary()
 {
    // if the history database doesn't exist see if we can migrate the
@@ -16,6 +16,7 @@
 #ifndef SESSION_HISTORY_ARCHIVE_HPP
 #define SESSION_HISTORY_ARCHIVE_HPP
 
+#include <map>
 #include <string>
 #include <vector>
 
@@ -61,9 +62,26 @@ public:
    core::Error add(const std::string& command);
    const std::vector<HistoryEntry>& entries() const;
 
+   // search for entries whose command begins with the given prefix,
+   // deduplicated by command (the most recent occurrence wins) and
+   // returned most recent first. served from the sorted command index,
+   // so cost is logarithmic in the archive size (plus the matches)
+   // rather than a scan of every entry
+   void searchByPrefix(const std::string& prefix,
+                       int maxEntries,
+                       std::vector<HistoryEntry>* pEntries) const;
+
+private:
+   void rebuildCommandIndex() const;
+
 private:
    mutable time_t entryCacheLastWriteTime_;
    mutable std::vector<HistoryEntry> entries_;
+
+   // sorted index mapping each unique command to the position of its most
+   // recent occurrence in entries_; rebuilt alongside the entry cache and
+   // maintained incrementally on append
+   mutable std::map<std::string, std::size_t> commandIndex_;
 };
                        
 } // namespace history
@@ -16,12 +16,19 @@
 
 #include "SessionLimits.hpp"
 
+#include <sstream>
+
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/algorithm/string/trim.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/format.hpp>
 #include <boost/bind.hpp>
 #include <boost/function.hpp>
 
+#include <core/FileSerializer.hpp>
 #include <core/Log.hpp>
 #include <shared_core/Error.hpp>
+#include <shared_core/SafeConvert.hpp>
 #include <core/system/System.hpp>
 
 #include <r/RExec.hpp>
@@ -54,15 +61,134 @@ void onBeforeExecute()
    }
 }    
    
+#ifdef __linux__
+
+// memory pressure monitoring ----------------------------------------------
+//
+// when the server applies a cgroup v2 memory.high watermark to this
+// session we surface a warning to the client as usage approaches it, so
+// the user can free memory before reclaim throttling (or the OOM killer,
+// if memory.max is also set) kicks in
+
+// fraction of memory.high at which we warn
+const double kMemoryPressureThreshold = 0.9;
+
+// minimum time between checks / warnings
+const int kMemoryPressureCheckSeconds = 10;
+const int kMemoryPressureWarnSeconds = 300;
+
+boost::posix_time::ptime s_lastMemoryCheck;
+boost::posix_time::ptime s_lastMemoryWarning;
+
+// reads a single-value cgroup file for this process's cgroup
+Error readOwnCgroupValue(const std::string& file, std::string* pValue)
+{
+   // resolve our cgroup (v2 entries have the form "0::<path>")
+   std::string contents;
+   Error error = core::readStringFromFile(FilePath("/proc/self/cgroup"),
+                                          &contents);
+   if (error)
+      return error;
+
+   std::string cgroup;
+   std::istringstream istr(contents);
+   std::string line;
+   while (std::getline(istr, line))
+   {
+      if (boost::algorithm::starts_with(line, "0::"))
+      {
+         cgroup = line.substr(3);
+         break;
+      }
+   }
+   if (cgroup.empty())
+      return core::fileNotFoundError("/proc/self/cgroup", ERROR_LOCATION);
+
+   FilePath valuePath = FilePath("/sys/fs/cgroup" + cgroup)
+                              .completeChildPath(file);
+   error = core::readStringFromFile(valuePath, pValue);
+   if (error)
+      return error;
+
+   boost::algorithm::trim(*pValue);
+   return Success();
+}
+
+void checkMemoryPressure()
+{
+   // rate limit both the proc filesystem reads and the warning itself
+   using namespace boost::posix_time;
+   ptime now = microsec_clock::universal_time();
+   if (!s_lastMemoryCheck.is_not_a_date_time() &&
+       (now - s_lastMemoryCheck).total_seconds() < kMemoryPressureCheckSeconds)
+   {
+      return;
+   }
+   s_lastMemoryCheck = now;
+
+   if (!s_lastMemoryWarning.is_not_a_date_time() &&
+       (now - s_lastMemoryWarning).total_seconds() <
+                                       kMemoryPressureWarnSeconds)
+   {
+      return;
+   }
+
+   // no watermark means no governor; "max" means unlimited
+   std::string high;
+   Error error = readOwnCgroupValue("memory.high", &high);
+   if (error || high.empty() || high == "max")
+      return;
+
+   std::string current;
+   error = readOwnCgroupValue("memory.current", &current);
+   if (error)
+      return;
+
+   double highBytes = safe_convert::stringTo<double>(high, 0);
+   double currentBytes = safe_convert::stringTo<double>(current, 0);
+   if (highBytes <= 0)
+      return;
+
+   if (currentBytes / highBytes >= kMemoryPressureThreshold)
+   {
+      s_lastMemoryWarning = now;
+
+      json::Object msgJson;
+      msgJson["severe"] = false;
+      boost::format fmt(
+         "This session is using %1% MB of its %2% MB memory allowance. "
+         "Consider removing large objects from the workspace to avoid "
+         "the session being throttled or terminated.");
+      msgJson["message"] = boost::str(
+               fmt % static_cast<int>(currentBytes / (1024 * 1024))
+                   % static_cast<int>(highBytes / (1024 * 1024)));
+      ClientEvent event(client_events::kShowWarningBar, msgJson);
+      module_context::enqueClientEvent(event);
+   }
+}
+
+void onBackgroundProcessing(bool)
+{
+   checkMemoryPressure();
+}
+
+#endif // __linux__
+
 } // anonymous namespace
-   
+
 Error initialize()
-{  
+{
    // subscribe to onBeforeExecute so we can set a cpu time limit for
    // top level computations
    module_context::events().onBeforeExecute.connect(boost::bind(
                                                             onBeforeExecute));
 
+#ifdef __linux__
+   // warn the user when approaching a server-applied memory watermark
+   module_context::events().onBackgroundProcessing.connect(
+                                                   onBackgroundProcessing);
+#endif
+
    return Success();
 }
    
@@ -251,12 +251,43 @@ SEXP rs_objectAttributes(SEXP objectSEXP)
    return ATTRIB(objectSEXP);
 }
 
+SEXP rs_newWeakRef(SEXP objectSEXP)
+{
+   // a weak reference to the object (used to validate address-keyed
+   // caches: while the key is live, its address can't be reused)
+   return ::R_MakeWeakRef(objectSEXP, R_NilValue, R_NilValue, FALSE);
+}
+
+SEXP rs_weakRefKey(SEXP refSEXP)
+{
+   if (TYPEOF(refSEXP) != WEAKREFSXP)
+      return R_NilValue;
+   return ::R_WeakRefKey(refSEXP);
+}
+
 SEXP rs_explorerCacheDir()
 {
    r::sexp::Protect protect;
    return r::sexp::create(explorerCacheDirSystem(), &protect);
 }
 
+void executeScheduledPrefetch()
+{
+   Error error = r::exec::RFunction(".rs.explorer.executePrefetch").call();
+   if (error)
+      LOG_ERROR(error);
+}
+
+SEXP rs_explorerSchedulePrefetch()
+{
+   // compute the next page of a paged inspection at idle time, so it's
+   // already available when the client requests it
+   module_context::scheduleDelayedWork(boost::posix_time::milliseconds(200),
+                                       executeScheduledPrefetch,
+                                       true);
+   return R_NilValue;
+}
+
 } // end anonymous namespace
 
 core::Error initialize()
@@ -275,7 +306,10 @@ core::Error initialize()
    RS_REGISTER_CALL_METHOD(rs_objectAddress, 1);
    RS_REGISTER_CALL_METHOD(rs_objectClass, 1);
    RS_REGISTER_CALL_METHOD(rs_objectAttributes, 1);
+   RS_REGISTER_CALL_METHOD(rs_newWeakRef, 1);
+   RS_REGISTER_CALL_METHOD(rs_weakRefKey, 1);
    RS_REGISTER_CALL_METHOD(rs_explorerCacheDir, 0);
+   RS_REGISTER_CALL_METHOD(rs_explorerSchedulePrefetch, 0);
    
    ExecBlock initBlock;
    initBlock.addFunctions()
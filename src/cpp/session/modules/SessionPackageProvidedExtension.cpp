@@ -15,6 +15,8 @@
 
 #include <session/SessionPackageProvidedExtension.hpp>
 
+#include <sstream>
+
 #include <boost/regex.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
 
@@ -88,7 +90,19 @@ void Indexer::start()
    if (running_)
       return;
 
+   // enumerate the package directories we would index and compare
+   // against the last completed index -- many reindex triggers (e.g.
+   // console commands which merely look like package installs) don't
+   // actually change the library, and for those the existing index is
+   // already current
+   std::vector<FilePath> pkgDirs = enumeratePackageDirs();
+   std::string fingerprint = libraryFingerprint(pkgDirs);
+   if (!indexedFingerprint_.empty() && fingerprint == indexedFingerprint_)
+      return;
+
    running_ = true;
+   pendingFingerprint_ = fingerprint;
+   pkgDirs_ = pkgDirs;
    beginIndexing();
    module_context::scheduleIncrementalWork(
             boost::posix_time::milliseconds(300),
@@ -97,6 +111,45 @@ void Indexer::start()
             true);
 }
 
+std::vector<FilePath> Indexer::enumeratePackageDirs()
+{
+   std::vector<FilePath> pkgDirs;
+
+   // discover packages available on the current library paths
+   std::vector<core::FilePath> libPaths = module_context::getLibPaths();
+   for (const core::FilePath& libPath : libPaths)
+   {
+      if (!libPath.exists())
+         continue;
+
+      std::vector<core::FilePath> pkgPaths;
+      core::Error error = libPath.getChildren(pkgPaths);
+      if (error)
+         LOG_ERROR(error);
+
+      pkgDirs.insert(
+               pkgDirs.end(),
+               pkgPaths.begin(),
+               pkgPaths.end());
+   }
+
+   return pkgDirs;
+}
+
+std::string Indexer::libraryFingerprint(const std::vector<FilePath>& pkgDirs)
+{
+   // the fingerprint covers each package directory's path and mtime, so
+   // installing, removing, or updating a package invalidates it (package
+   // installation replaces the package directory wholesale)
+   std::ostringstream ostr;
+   for (const FilePath& pkgDir : pkgDirs)
+   {
+      ostr << pkgDir.getAbsolutePath() << ':'
+           << pkgDir.getLastWriteTime() << '\n';
+   }
+   return ostr.str();
+}
+
 bool Indexer::work()
 {
    // check whether we've run out of work items
@@ -128,29 +181,10 @@ bool Indexer::work()
 
 void Indexer::beginIndexing()
 {
-   // reset indexer state
-   pkgDirs_.clear();
+   // reset indexer state (start() has already populated pkgDirs_)
    index_ = 0;
-
-   // discover packages available on the current library paths
-   std::vector<core::FilePath> libPaths = module_context::getLibPaths();
-   for (const core::FilePath& libPath : libPaths)
-   {
-      if (!libPath.exists())
-         continue;
-
-      std::vector<core::FilePath> pkgPaths;
-      core::Error error = libPath.getChildren(pkgPaths);
-      if (error)
-         LOG_ERROR(error);
-
-      pkgDirs_.insert(
-               pkgDirs_.end(),
-               pkgPaths.begin(),
-               pkgPaths.end());
-   }
    n_ = pkgDirs_.size();
-   
+
    for (boost::shared_ptr<Worker> pWorker : workers_)
    {
       try
@@ -165,7 +199,12 @@ void Indexer::endIndexing()
 {
    running_ = false;
    payload_.clear();
-   
+
+   // the index now reflects the fingerprint captured when it started
+   indexedFingerprint_ = pendingFingerprint_;
+   pendingFingerprint_.clear();
+
+
    for (boost::shared_ptr<Worker> pWorker : workers_)
    {
       try
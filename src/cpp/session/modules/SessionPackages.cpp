@@ -254,6 +254,14 @@ SEXP rs_enqueLoadedPackageUpdates(SEXP installCmdSEXP)
    return R_NilValue;
 }
 
+SEXP rs_packageInfoCachePath()
+{
+   r::sexp::Protect protect;
+   FilePath cachePath = module_context::scopedScratchPath().completePath(
+                                             "package_info_cache.rds");
+   return r::sexp::create(cachePath.getAbsolutePath(), &protect);
+}
+
 SEXP rs_canInstallPackages()
 {
    r::sexp::Protect rProtect;
@@ -352,6 +360,13 @@ void enquePackageStateChanged()
       LOG_ERROR(error);
    else
    {
+      // library mutation detection is deliberately conservative, so
+      // don't push state the client has already seen
+      static json::Object s_lastPackageState;
+      if (pkgState == s_lastPackageState)
+         return;
+      s_lastPackageState = pkgState;
+
       ClientEvent event(client_events::kPackageStateChanged, pkgState);
       module_context::enqueClientEvent(event);
    }
@@ -367,6 +382,7 @@ Error initialize()
    // register routines
    RS_REGISTER_CALL_METHOD(rs_enqueLoadedPackageUpdates);
    RS_REGISTER_CALL_METHOD(rs_canInstallPackages);
+   RS_REGISTER_CALL_METHOD(rs_packageInfoCachePath);
    RS_REGISTER_CALL_METHOD(rs_packageLibraryMutated);
    RS_REGISTER_CALL_METHOD(rs_getCachedAvailablePackages);
    RS_REGISTER_CALL_METHOD(rs_downloadAvailablePackages);
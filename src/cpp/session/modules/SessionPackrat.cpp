@@ -155,6 +155,16 @@ static bool s_autoSnapshotRunning = false;
 static bool s_packageStateChanged = false;
 static bool s_pendingLibraryHash  = false;
 
+// computing a hash means re-reading the lockfile or walking every DESCRIPTION
+// file in the private library (preceded by an R call); on network file systems
+// this is slow enough to be felt on every console prompt. computed hashes are
+// therefore cached and recomputed only after the file monitor (or a packrat
+// action) reports that the underlying files actually changed.
+static bool s_lockfileHashValid = false;
+static std::string s_cachedLockfileHash;
+static bool s_libraryHashValid = false;
+static std::string s_cachedLibraryHash;
+
 
 // Forward declarations ------------------------------------------------------
 
@@ -236,7 +246,7 @@ void addDescContent(const FilePath& path, std::string* pDescContent)
 
 // computes a hash of the content of all DESCRIPTION files in the Packrat
 // private library
-std::string computeLibraryHash()
+std::string computeLibraryHashImpl()
 {
    // figure out what library paths are being used by Packrat
    std::string libraryPath;
@@ -269,7 +279,7 @@ std::string computeLibraryHash()
 }
 
 // computes the hash of the current project's lockfile
-std::string computeLockfileHash()
+std::string computeLockfileHashImpl()
 {
    FilePath lockFilePath =
       projects::projectContext().directory().completePath(kPackratLockfilePath);
@@ -288,6 +298,36 @@ std::string computeLockfileHash()
    return hash::crc32HexHash(lockFileContent);
 }
 
+// cached variants of the above; all callers funnel through these so that the
+// expensive computation runs once per generation of the underlying files
+std::string computeLibraryHash()
+{
+   if (!s_libraryHashValid)
+   {
+      s_cachedLibraryHash = computeLibraryHashImpl();
+      s_libraryHashValid = true;
+   }
+   return s_cachedLibraryHash;
+}
+
+std::string computeLockfileHash()
+{
+   if (!s_lockfileHashValid)
+   {
+      s_cachedLockfileHash = computeLockfileHashImpl();
+      s_lockfileHashValid = true;
+   }
+   return s_cachedLockfileHash;
+}
+
+void invalidateComputedHashes(bool lockfile, bool library)
+{
+   if (lockfile)
+      s_lockfileHashValid = false;
+   if (library)
+      s_libraryHashValid = false;
+}
+
 void checkHashes(
       PackratHashType hashType, 
       PackratHashState hashState,
@@ -407,6 +447,9 @@ void pendingSnapshot(PendingSnapshotAction action)
          else if (action == COMPLETE_SNAPSHOT)
          {
             s_autoSnapshotRunning = false;
+            // the snapshot just rewrote the lockfile; don't wait for the
+            // file monitor to notice before recomputing its hash
+            invalidateComputedHashes(true, false);
             // if there are remaining actions, re-emit the state to the client 
             if (!resolveStateAfterAction(PACKRAT_ACTION_SNAPSHOT, 
                                          HASH_TYPE_LOCKFILE))
@@ -595,6 +638,7 @@ void onFileChanged(FilePath sourceFilePath)
    if (sourceFilePath.getFilename() == kPackratLockfile)
    {
       PACKRAT_TRACE("detected change to lockfile " << sourceFilePath);
+      invalidateComputedHashes(true, false);
       checkHashes(HASH_TYPE_LOCKFILE, HASH_STATE_OBSERVED, onLockfileUpdate);
    }
    else if (sourceFilePath.isWithin(libraryPath) && 
@@ -611,6 +655,7 @@ void onFileChanged(FilePath sourceFilePath)
          return;
       }
       PACKRAT_TRACE("detected change to library file " << sourceFilePath);
+      invalidateComputedHashes(false, true);
       s_pendingLibraryHash = true;
    }
 }
@@ -802,6 +847,10 @@ void onPackratAction(const std::string& project,
    PackratActionType completedAction = s_runningPackratAction;
    s_runningPackratAction = PACKRAT_ACTION_NONE;
 
+   // file changes were ignored while the action ran, so both computed
+   // hashes are suspect now
+   invalidateComputedHashes(true, true);
+
    // action ended, update hashes accordingly
    switch (completedAction)
    {
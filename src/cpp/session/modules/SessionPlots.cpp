@@ -39,6 +39,7 @@
 #include <r/session/RGraphics.hpp>
 
 #include <session/SessionModuleContext.hpp>
+#include <session/SessionUriContentCache.hpp>
 
 using namespace rstudio::core;
 
@@ -474,6 +475,32 @@ void setImageFileResponse(const FilePath& imageFilePath,
    }
 }
 
+// as above, but reads through the shared content cache -- used for
+// strong-named plot images, which are immutable and re-requested every
+// time the plot history is traversed (not for temporary zoom/export
+// images, which are served once then deleted)
+void setCachedImageFileResponse(const FilePath& imageFilePath,
+                                const http::Request& request,
+                                http::Response* pResponse)
+{
+   std::string contents;
+   Error error = content_cache::readCachedFile(imageFilePath, &contents);
+   if (error)
+   {
+      if (!core::isPathNotFoundError(error))
+         LOG_ERROR(error);
+      pResponse->setError(http::status::InternalServerError,
+                          error.getMessage());
+      return;
+   }
+
+   // set content type
+   pResponse->setContentType(imageFilePath.getMimeContentType());
+
+   // set body
+   pResponse->setBody(contents);
+}
+
 void setTemporaryFileResponse(const FilePath& filePath, 
                               const http::Request& request, 
                               http::Response* pResponse)
@@ -659,8 +686,15 @@ void handleGraphicsRequest(const http::Request& request,
       // strong named - cache permanently (in user's browser only)
       pResponse->setPrivateCacheForeverHeaders();
 
-      // set the file
-      setImageFileResponse(imagePath, request, pResponse);
+      // serve the vector rendering when one was produced for this plot
+      // (the browser rasterizes it client-side; payloads are much smaller
+      // than the equivalent png for typical line / point plots)
+      FilePath vectorPath = imagePath.getParent().completePath(
+                                             imagePath.getStem() + ".svg");
+      if (vectorPath.exists())
+         setCachedImageFileResponse(vectorPath, request, pResponse);
+      else
+         setCachedImageFileResponse(imagePath, request, pResponse);
    }
    else
    {
@@ -16,13 +16,24 @@
 
 #include "SessionProfiler.hpp"
 
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <sstream>
+
+#include <boost/algorithm/string/join.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
 #include <core/Exec.hpp>
+#include <core/FileSerializer.hpp>
+#include <core/json/JsonRpc.hpp>
 
 #include <session/SessionModuleContext.hpp>
 
 #include <shared_core/Error.hpp>
 #include <core/Exec.hpp>
 
+#include <r/RExec.hpp>
 #include <r/RSexp.hpp>
 #include <r/RRoutines.hpp>
 #include <r/RUtil.hpp>
@@ -56,6 +67,272 @@ SEXP rs_profilesPath()
    return r::sexp::create(cacheDir, &rProtect);
 }
 
+// session profiling (diagnostics) -----------------------------------------
+//
+// always-available sampling of the main R thread, driven by R's built-in
+// sampling profiler (Rprof, which is itself signal based) so no external
+// tools need to be attached to a production session. samples are written
+// under the session scratch path and post-processed into the collapsed
+// stack format consumed by flame graph tools. we also track how much wall
+// clock time the session spends executing R code vs. waiting for work so
+// that event loop utilization can be reported alongside the samples.
+
+// utilization counters (single-threaded: only touched on the main thread)
+boost::posix_time::ptime s_lastTransition;
+bool s_executing = false;
+double s_busySeconds = 0.0;
+double s_idleSeconds = 0.0;
+bool s_profileActive = false;
+
+double secondsSince(const boost::posix_time::ptime& time)
+{
+   using namespace boost::posix_time;
+   return (microsec_clock::universal_time() - time).total_microseconds() /
+          1000000.0;
+}
+
+void onBeforeExecute()
+{
+   if (!s_executing)
+   {
+      if (!s_lastTransition.is_not_a_date_time())
+         s_idleSeconds += secondsSince(s_lastTransition);
+      s_lastTransition = boost::posix_time::microsec_clock::universal_time();
+      s_executing = true;
+   }
+}
+
+void onConsolePrompt(const std::string&)
+{
+   if (s_executing)
+   {
+      if (!s_lastTransition.is_not_a_date_time())
+         s_busySeconds += secondsSince(s_lastTransition);
+      s_lastTransition = boost::posix_time::microsec_clock::universal_time();
+      s_executing = false;
+   }
+}
+
+FilePath sessionProfilePath(const std::string& extension)
+{
+   return module_context::scopedScratchPath().completeChildPath(
+            "session-profile" + extension);
+}
+
+// streaming Rprof parser ---------------------------------------------------
+//
+// rather than reading the whole sample file once profiling stops (which
+// for long runs means a large parse before anything can be shown), we
+// tail the file as Rprof appends to it and fold identical stacks
+// incrementally. the client can poll for the partially aggregated data
+// while the profile is still running, and stopping a profile only has to
+// drain whatever tail hasn't been folded yet.
+
+// parser state (single-threaded: only touched on the main thread)
+std::streamoff s_parseOffset = 0;
+std::string s_partialLine;
+std::map<std::string, int> s_stackCounts;
+int s_totalSamples = 0;
+
+// bytes to fold per background pass -- enough to keep up with Rprof's
+// output rate while bounding the time taken away from the event loop
+const std::streamoff kMaxBytesPerPass = 256 * 1024;
+
+void resetParserState()
+{
+   s_parseOffset = 0;
+   s_partialLine.clear();
+   s_stackCounts.clear();
+   s_totalSamples = 0;
+}
+
+void foldProfileLine(const std::string& line)
+{
+   if (line.empty() || line.find("sample.interval=") != std::string::npos)
+      return;
+
+   // Rprof emits one line per sample with quoted function names,
+   // innermost frame first -- flame graph tools expect semicolon
+   // delimited stacks rooted at the left
+   std::vector<std::string> frames;
+   std::size_t pos = 0;
+   while ((pos = line.find('"', pos)) != std::string::npos)
+   {
+      std::size_t end = line.find('"', pos + 1);
+      if (end == std::string::npos)
+         break;
+      frames.push_back(line.substr(pos + 1, end - pos - 1));
+      pos = end + 1;
+   }
+   if (frames.empty())
+      return;
+
+   std::reverse(frames.begin(), frames.end());
+   s_stackCounts[boost::algorithm::join(frames, ";")]++;
+   s_totalSamples++;
+}
+
+// fold samples appended since the last pass; pass maxBytes = 0 to drain
+// the file completely (e.g. when the profile is stopped)
+void drainProfileFile(std::streamoff maxBytes)
+{
+   FilePath profPath = sessionProfilePath(".Rprof");
+   std::shared_ptr<std::istream> pStream;
+   Error error = profPath.openForRead(pStream);
+   if (error)
+      return;
+
+   pStream->seekg(s_parseOffset);
+   if (!pStream->good())
+      return;
+
+   std::streamoff bytesRead = 0;
+   char buffer[16 * 1024];
+   while (maxBytes == 0 || bytesRead < maxBytes)
+   {
+      pStream->read(buffer, sizeof(buffer));
+      std::streamsize count = pStream->gcount();
+      if (count <= 0)
+         break;
+
+      bytesRead += count;
+      s_parseOffset += count;
+
+      // split into lines, carrying any partial trailing line over to
+      // the next pass (Rprof may be mid-write when we read)
+      std::size_t lineStart = 0;
+      for (std::size_t i = 0; i < static_cast<std::size_t>(count); i++)
+      {
+         if (buffer[i] == '\n')
+         {
+            s_partialLine.append(buffer + lineStart, i - lineStart);
+            foldProfileLine(s_partialLine);
+            s_partialLine.clear();
+            lineStart = i + 1;
+         }
+      }
+      s_partialLine.append(buffer + lineStart, count - lineStart);
+   }
+}
+
+std::string collapsedStacks()
+{
+   std::ostringstream ostr;
+   for (std::map<std::string, int>::const_iterator
+        it = s_stackCounts.begin(); it != s_stackCounts.end(); ++it)
+   {
+      ostr << it->first << " " << it->second << "\n";
+   }
+   return ostr.str();
+}
+
+void onBackgroundProcessing(bool)
+{
+   // keep folding while a profile is running so the aggregation is
+   // (nearly) complete by the time the profile is stopped
+   if (s_profileActive)
+      drainProfileFile(kMaxBytesPerPass);
+}
+
+Error startSessionProfile(const json::JsonRpcRequest& request,
+                          json::JsonRpcResponse* pResponse)
+{
+   // sampling interval in seconds (default matches Rprof)
+   double interval = 0.02;
+   Error error = json::readParams(request.params, &interval);
+   if (error)
+      return error;
+
+   FilePath profPath = sessionProfilePath(".Rprof");
+   error = r::exec::RFunction("utils:::Rprof")
+         .addParam(string_utils::utf8ToSystem(profPath.getAbsolutePath()))
+         .addParam("interval", interval)
+         .call();
+   if (error)
+      return error;
+
+   resetParserState();
+   s_profileActive = true;
+   return Success();
+}
+
+Error getSessionProfileData(const json::JsonRpcRequest& request,
+                            json::JsonRpcResponse* pResponse)
+{
+   // fold whatever has been appended since the last pass so the client
+   // sees (nearly) current data, even mid-profile
+   drainProfileFile(kMaxBytesPerPass);
+
+   json::Object resultJson;
+   resultJson["collapsed"] = collapsedStacks();
+   resultJson["samples"] = s_totalSamples;
+   resultJson["active"] = s_profileActive;
+   pResponse->setResult(resultJson);
+
+   return Success();
+}
+
+Error stopSessionProfile(const json::JsonRpcRequest& request,
+                         json::JsonRpcResponse* pResponse)
+{
+   // stop sampling (harmless if profiling was never started)
+   Error error = r::exec::executeString("utils::Rprof(NULL)");
+   if (error)
+      return error;
+   s_profileActive = false;
+
+   // fold whatever tail the background passes haven't consumed yet --
+   // for most profiles this is a few KB, so stopping is immediate even
+   // when the raw sample file is very large
+   drainProfileFile(0);
+   if (!s_partialLine.empty())
+   {
+      foldProfileLine(s_partialLine);
+      s_partialLine.clear();
+   }
+   int totalSamples = s_totalSamples;
+
+   // write the collapsed stacks alongside the raw samples
+   FilePath collapsedPath = sessionProfilePath(".folded");
+   error = core::writeStringToFile(collapsedPath, collapsedStacks());
+   if (error)
+      return error;
+
+   // report the profile location and event loop utilization
+   double busySeconds = s_busySeconds;
+   double idleSeconds = s_idleSeconds;
+   if (!s_lastTransition.is_not_a_date_time())
+   {
+      if (s_executing)
+         busySeconds += secondsSince(s_lastTransition);
+      else
+         idleSeconds += secondsSince(s_lastTransition);
+   }
+   double totalSeconds = busySeconds + idleSeconds;
+
+   json::Object resultJson;
+   resultJson["profile_file"] = module_context::createAliasedPath(collapsedPath);
+   resultJson["samples"] = totalSamples;
+   resultJson["busy_seconds"] = busySeconds;
+   resultJson["idle_seconds"] = idleSeconds;
+   resultJson["utilization"] = totalSeconds > 0.0 ?
+            busySeconds / totalSeconds : 0.0;
+   pResponse->setResult(resultJson);
+
+   return Success();
+}
+
+void onShutdown(bool)
+{
+   // don't leave Rprof running against a file we're about to abandon
+   if (s_profileActive)
+   {
+      Error error = r::exec::executeString("utils::Rprof(NULL)");
+      if (error)
+         LOG_ERROR(error);
+   }
+}
+
 } // anonymous namespace
 
 void handleProfilerResReq(const http::Request& request,
@@ -107,6 +384,14 @@ Error initialize()
    
    source_database::events().onDocPendingRemove.connect(onDocPendingRemove);
 
+   // track event loop utilization from session startup
+   s_lastTransition = boost::posix_time::microsec_clock::universal_time();
+   module_context::events().onBeforeExecute.connect(onBeforeExecute);
+   module_context::events().onConsolePrompt.connect(onConsolePrompt);
+   module_context::events().onShutdown.connect(onShutdown);
+   module_context::events().onBackgroundProcessing.connect(
+                                                      onBackgroundProcessing);
+
    RS_REGISTER_CALL_METHOD(rs_profilesPath);
    
    r::options::setOptionDefault(
@@ -116,7 +401,10 @@ Error initialize()
    initBlock.addFunctions()
       (boost::bind(module_context::sourceModuleRFile, "SessionProfiler.R"))
       (boost::bind(module_context::registerUriHandler, "/" kProfilesUrlPath "/", handleProfilerResReq))
-      (boost::bind(module_context::registerUriHandler, kProfilerResourceLocation, handleProfilerResourceResReq));
+      (boost::bind(module_context::registerUriHandler, kProfilerResourceLocation, handleProfilerResourceResReq))
+      (boost::bind(module_context::registerRpcMethod, "start_session_profile", startSessionProfile))
+      (boost::bind(module_context::registerRpcMethod, "get_session_profile_data", getSessionProfileData))
+      (boost::bind(module_context::registerRpcMethod, "stop_session_profile", stopSessionProfile));
 
    return initBlock.execute();
 }
@@ -16,8 +16,11 @@
 #include "SessionPythonEnvironments.hpp"
 
 #include <core/Exec.hpp>
+#include <shared_core/FilePath.hpp>
 
 #include <r/RExec.hpp>
+#include <r/RRoutines.hpp>
+#include <r/RSexp.hpp>
 
 #include <session/prefs/UserPrefs.hpp>
 #include <session/prefs/UserPrefValues.hpp>
@@ -53,14 +56,24 @@ void onPrefsChanged(const std::string& /* layerName */,
    }
 }
 
+SEXP rs_pythonInfoCachePath()
+{
+   r::sexp::Protect protect;
+   FilePath cachePath = module_context::scopedScratchPath().completePath(
+                                             "python_info_cache.rds");
+   return r::sexp::create(cachePath.getAbsolutePath(), &protect);
+}
+
 } // end anonymous namespace
 
 Error initialize()
 {
    using namespace module_context;
-   
+
    prefs::userPrefs().onChanged.connect(onPrefsChanged);
 
+   RS_REGISTER_CALL_METHOD(rs_pythonInfoCachePath);
+
    ExecBlock initBlock;
    initBlock.addFunctions()
       (bind(sourceModuleRFile, "SessionPythonEnvironments.R"));
@@ -23,6 +23,7 @@
 #include <shared_core/Error.hpp>
 #include <core/Exec.hpp>
 #include <shared_core/FilePath.hpp>
+#include <shared_core/SafeConvert.hpp>
 #include <core/FileSerializer.hpp>
 #include <core/text/DcfParser.hpp>
 
@@ -112,10 +113,13 @@ private:
    int ordinal_;
 };
 
+// bumped whenever the persisted registry format changes
+const int kRegistryVersion = 2;
+
 class AddinRegistry : boost::noncopyable
 {
 public:
-   
+
    void saveToFile(const core::FilePath& filePath) const
    {
       std::shared_ptr<std::ostream> pStream;
@@ -126,12 +130,20 @@ public:
          return;
       }
 
-      toJson().writeFormatted(*pStream);
+      // persist alongside the fingerprint of the dcf files the registry
+      // was compiled from, so the next session can tell whether the
+      // cached registry is still current without parsing anything
+      json::Object registryJson;
+      registryJson["version"] = kRegistryVersion;
+      registryJson["fingerprint"] = fingerprint_;
+      registryJson["addins"] = toJson();
+      registryJson.writeFormatted(*pStream);
    }
 
    void loadFromFile(const core::FilePath& filePath)
    {
       addins_.clear();
+      fingerprint_.clear();
 
       if (!filePath.exists())
          return;
@@ -150,7 +162,27 @@ public:
       if (!parsedJson.parse(contents) &&
           json::isType<json::Object>(parsedJson))
       {
-         const json::Object& addinsJson = parsedJson.getObject();
+         json::Object addinsJson = parsedJson.getObject();
+
+         // versioned registries carry the addins in an 'addins' member
+         // (older registries were a bare map of key to specification, in
+         // which case the fingerprint stays empty and the registry is
+         // recompiled on first use)
+         if (addinsJson.hasMember("version"))
+         {
+            int version = 0;
+            json::Object versionedAddinsJson;
+            error = json::readObject(addinsJson,
+                                     "version", version,
+                                     "fingerprint", fingerprint_,
+                                     "addins", versionedAddinsJson);
+            if (error || version != kRegistryVersion)
+            {
+               fingerprint_.clear();
+               return;
+            }
+            addinsJson = versionedAddinsJson;
+         }
 
          for(const json::Object::Member& member : addinsJson)
          {
@@ -265,9 +297,15 @@ public:
    }
 
    std::size_t size() const { return addins_.size(); }
-   
+
+   const std::string& fingerprint() const { return fingerprint_; }
+   void setFingerprint(const std::string& fingerprint)
+   {
+      fingerprint_ = fingerprint;
+   }
+
 private:
-   
+
    static std::map<std::string, std::string> parseAddinDcf(
                                           const std::string& contents)
    {
@@ -291,11 +329,12 @@ private:
    {
       std::string lower = string_utils::trimWhitespace(
                boost::algorithm::to_lower_copy(string));
-      
+
       return lower == "true";
    }
 
    std::map<std::string, AddinSpecification> addins_;
+   std::string fingerprint_;
 };
 
 // maintain single "active" registry that is updatable as a result of indexing
@@ -326,8 +365,33 @@ void loadAddinRegistry()
    s_pCurrentRegistry->loadFromFile(addinRegistryPath());
 }
 
+// dcf files discovered by the indexing crawl but not yet parsed. parsing
+// is deferred until the registry is first consulted (e.g. when the addins
+// palette is opened) since many sessions never execute an addin
+std::vector<std::pair<std::string, FilePath> > s_pendingAddinPaths;
+std::string s_pendingFingerprint;
+
+void compilePendingAddins()
+{
+   if (s_pendingFingerprint.empty())
+      return;
+
+   boost::shared_ptr<AddinRegistry> pRegistry =
+                                       boost::make_shared<AddinRegistry>();
+   for (const std::pair<std::string, FilePath>& addin : s_pendingAddinPaths)
+      pRegistry->add(addin.first, addin.second);
+   pRegistry->setFingerprint(s_pendingFingerprint);
+
+   s_pendingAddinPaths.clear();
+   s_pendingFingerprint.clear();
+
+   updateAddinRegistry(pRegistry);
+}
+
 AddinRegistry& addinRegistry()
 {
+   // compile any dcf files whose parsing was deferred
+   compilePendingAddins();
    return *s_pCurrentRegistry;
 }
 
@@ -335,14 +399,22 @@ class AddinWorker : public ppe::Worker
 {
    void onIndexingStarted()
    {
-      pRegistry_ = boost::make_shared<AddinRegistry>();
+      pendingPaths_.clear();
+      fingerprint_.clear();
    }
-   
+
    void onWork(const std::string& pkgName, const FilePath& addinPath)
    {
-      pRegistry_->add(pkgName, addinPath);
+      // record the dcf file and its mtime -- no reading or parsing here;
+      // that's deferred until the registry is actually consulted
+      pendingPaths_.push_back(std::make_pair(pkgName, addinPath));
+      fingerprint_.append(addinPath.getAbsolutePath())
+                  .append(":")
+                  .append(safe_convert::numberToString(
+                             static_cast<double>(addinPath.getLastWriteTime())))
+                  .append(";");
    }
-   
+
    void onIndexingCompleted(json::Object* pPayload)
    {
       // finalize by indexing current package
@@ -353,41 +425,60 @@ class AddinWorker : public ppe::Worker
          if (addinPath.exists())
          {
             std::string pkgName = projects::projectContext().packageInfo().name();
-            pRegistry_->add(pkgName, addinPath);
+            onWork(pkgName, addinPath);
          }
       }
 
-      // update the addin registry
-      updateAddinRegistry(pRegistry_);
+      if (fingerprint_ == s_pCurrentRegistry->fingerprint() &&
+          !fingerprint_.empty())
+      {
+         // the registry persisted by a previous session was compiled
+         // from these same dcf files -- nothing to do
+         s_pendingAddinPaths.clear();
+         s_pendingFingerprint.clear();
+      }
+      else
+      {
+         // stash the discovered dcf files for deferred compilation
+         s_pendingAddinPaths = pendingPaths_;
+         s_pendingFingerprint = fingerprint_;
+      }
 
-      // handle pending continuations
-      json::Object registryJson = addinRegistry().toJson();
-      for (json::JsonRpcFunctionContinuation continuation : continuations_)
+      // handle pending continuations (this compiles the registry if
+      // anyone is actually waiting on it)
+      if (!continuations_.empty())
       {
-         json::JsonRpcResponse response;
-         response.setResult(registryJson);
-         continuation(Success(), &response);
+         json::Object registryJson = addinRegistry().toJson();
+         for (json::JsonRpcFunctionContinuation continuation : continuations_)
+         {
+            json::JsonRpcResponse response;
+            response.setResult(registryJson);
+            continuation(Success(), &response);
+         }
       }
-      
-      // provide registry as json
-      (*pPayload)["addin_registry"] = registryJson;
+
+      // provide registry as json (without forcing a deferred compile)
+      if (s_pendingFingerprint.empty())
+         (*pPayload)["addin_registry"] = s_pCurrentRegistry->toJson();
 
       // reset
       continuations_.clear();
-      pRegistry_.reset();
+      pendingPaths_.clear();
+      fingerprint_.clear();
    }
 
 public:
-   
+
    AddinWorker() : ppe::Worker("rstudio/addins.dcf") {}
-   
+
    void addContinuation(json::JsonRpcFunctionContinuation continuation)
    {
       continuations_.push_back(continuation);
    }
 
 private:
-   boost::shared_ptr<AddinRegistry> pRegistry_;
+   std::vector<std::pair<std::string, FilePath> > pendingPaths_;
+   std::string fingerprint_;
    std::vector<json::JsonRpcFunctionContinuation> continuations_;
 };
 
@@ -256,6 +256,28 @@ bool subsequenceFilter(const FileInfo& fileInfo,
    return false;
 }
 
+// Cache of per-directory scan snapshots for the project. Repeated file
+// scans (e.g. for fuzzy file completions) read untouched directories from
+// the cache; project file monitor events invalidate the affected entries.
+boost::shared_ptr<core::system::FileScanCache> s_pProjectScanCache;
+
+void onProjectMonitoringEnabled(const tree<core::FileInfo>& files)
+{
+   s_pProjectScanCache.reset(new core::system::FileScanCache());
+}
+
+void onProjectFilesChanged(
+                  const std::vector<core::system::FileChangeEvent>& events)
+{
+   if (s_pProjectScanCache)
+      s_pProjectScanCache->processFileChanges(events);
+}
+
+void onProjectMonitoringDisabled()
+{
+   s_pProjectScanCache.reset();
+}
+
 SEXP rs_scanFiles(SEXP pathSEXP,
                   SEXP patternSEXP,
                   SEXP maxCountSEXP)
@@ -272,6 +294,15 @@ SEXP rs_scanFiles(SEXP pathSEXP,
    options.recursive = true;
    options.yield = true;
 
+   // Use the project scan cache when scanning within the monitored project
+   // directory (the filter below is applied per-scan, so sharing cached
+   // snapshots across scans with different patterns is safe)
+   if (s_pProjectScanCache &&
+       projects::projectContext().isMonitoringDirectory(filePath))
+   {
+      options.cache = s_pProjectScanCache;
+   }
+
    // Use a subsequence filter, and bail after too many files
    std::vector<std::string> paths;
    
@@ -482,6 +513,181 @@ SEXP rs_getKnitParamsForDocument(SEXP documentIdSEXP)
    return resultSEXP;
 }
 
+// cached symbol table for an environment on the search path. symbols
+// are sorted by their fuzzy-match keys so completion lookups can
+// binary search rather than scan every symbol
+struct EnvironmentSymbols
+{
+   EnvironmentSymbols() : envSEXP(R_NilValue) {}
+   SEXP envSEXP;
+   std::vector<std::string> symbols;
+   std::vector<std::string> matchKeys;
+};
+
+// cache of symbols for attached packages, keyed by search path name.
+// package environments are locked on attach so a cached table remains
+// valid for as long as the same environment is attached -- we record
+// the environment pointer itself (compared, never dereferenced) so
+// that detaching and re-attaching a package invalidates the entry
+std::map<std::string, EnvironmentSymbols> s_searchPathSymbolCache;
+
+void clearSearchPathSymbolCache()
+{
+   s_searchPathSymbolCache.clear();
+}
+
+// transform a symbol into the key used for fuzzy matching. this is the
+// C++ analog of '.rs.fuzzyMatches()', which strips '.' and '_' (except
+// at the start of a symbol) and then performs case-insensitive prefix
+// matching
+std::string fuzzyMatchKey(const std::string& symbol)
+{
+   std::string key;
+   key.reserve(symbol.size());
+   for (std::size_t i = 0; i < symbol.size(); i++)
+   {
+      char ch = symbol[i];
+      if (i > 0 && (ch == '.' || ch == '_'))
+         continue;
+      key.push_back(
+         static_cast<char>(::tolower(static_cast<unsigned char>(ch))));
+   }
+   return key;
+}
+
+bool listEnvironmentSymbols(SEXP envSEXP, EnvironmentSymbols* pSymbols)
+{
+   std::vector<std::string> symbols;
+   Error error = r::sexp::objects(envSEXP, true, &symbols);
+   if (error)
+   {
+      LOG_ERROR(error);
+      return false;
+   }
+
+   // sort symbols by match key
+   std::vector< std::pair<std::string, std::string> > keyed;
+   keyed.reserve(symbols.size());
+   for (const std::string& symbol : symbols)
+      keyed.push_back(std::make_pair(fuzzyMatchKey(symbol), symbol));
+   std::sort(keyed.begin(), keyed.end());
+
+   pSymbols->envSEXP = envSEXP;
+   pSymbols->symbols.clear();
+   pSymbols->matchKeys.clear();
+   pSymbols->symbols.reserve(keyed.size());
+   pSymbols->matchKeys.reserve(keyed.size());
+   for (std::size_t i = 0; i < keyed.size(); i++)
+   {
+      pSymbols->matchKeys.push_back(keyed[i].first);
+      pSymbols->symbols.push_back(keyed[i].second);
+   }
+
+   return true;
+}
+
+const EnvironmentSymbols* symbolsForSearchPathEntry(
+                                          const std::string& name,
+                                          SEXP envSEXP,
+                                          EnvironmentSymbols* pScratch)
+{
+   // package environments are locked so we can reuse a cached table
+   // while the same environment remains attached
+   if (name.compare(0, 8, "package:") == 0)
+   {
+      std::map<std::string, EnvironmentSymbols>::iterator it =
+                                    s_searchPathSymbolCache.find(name);
+      if (it != s_searchPathSymbolCache.end() &&
+          it->second.envSEXP == envSEXP)
+      {
+         return &it->second;
+      }
+
+      EnvironmentSymbols& cached = s_searchPathSymbolCache[name];
+      if (!listEnvironmentSymbols(envSEXP, &cached))
+      {
+         s_searchPathSymbolCache.erase(name);
+         return nullptr;
+      }
+      return &cached;
+   }
+
+   // other environments (e.g. the global environment) can mutate
+   // freely so list them on each request
+   if (!listEnvironmentSymbols(envSEXP, pScratch))
+      return nullptr;
+   return pScratch;
+}
+
+SEXP rs_getSearchPathCompletions(SEXP tokenSEXP)
+{
+   std::string token = r::sexp::asString(tokenSEXP);
+   std::string tokenKey = fuzzyMatchKey(token);
+   bool tokenIsHidden = !token.empty() && token[0] == '.';
+
+   std::vector<std::string> searchPath;
+   Error error = r::exec::RFunction("search").call(&searchPath);
+   if (error)
+   {
+      LOG_ERROR(error);
+      return R_NilValue;
+   }
+
+   // matches are emitted in search path order so that duplicates can
+   // be resolved downstream with earlier entries masking later ones
+   std::vector<std::string> results;
+   std::vector<std::string> packages;
+
+   r::sexp::Protect protect;
+   for (std::size_t i = 0; i < searchPath.size(); i++)
+   {
+      const std::string& name = searchPath[i];
+
+      SEXP envSEXP = R_NilValue;
+      error = r::exec::RFunction("as.environment")
+            .addParam(gsl::narrow_cast<int>(i + 1))
+            .call(&envSEXP, &protect);
+      if (error)
+      {
+         LOG_ERROR(error);
+         continue;
+      }
+
+      EnvironmentSymbols scratch;
+      const EnvironmentSymbols* pSymbols =
+                  symbolsForSearchPathEntry(name, envSEXP, &scratch);
+      if (pSymbols == nullptr)
+         continue;
+
+      // locate the range of symbols whose keys share the token's key
+      // as a prefix
+      const std::vector<std::string>& keys = pSymbols->matchKeys;
+      std::vector<std::string>::const_iterator it =
+                  std::lower_bound(keys.begin(), keys.end(), tokenKey);
+      for (; it != keys.end(); ++it)
+      {
+         if (it->compare(0, tokenKey.size(), tokenKey) != 0)
+            break;
+
+         const std::string& symbol = pSymbols->symbols[it - keys.begin()];
+
+         // hidden symbols are only surfaced when the token itself
+         // begins with '.'
+         if (!tokenIsHidden && !symbol.empty() && symbol[0] == '.')
+            continue;
+
+         results.push_back(symbol);
+         packages.push_back(name);
+      }
+   }
+
+   r::sexp::ListBuilder builder(&protect);
+   builder.add("results", results);
+   builder.add("packages", packages);
+
+   return r::sexp::create(builder, &protect);
+}
+
 SEXP rs_listIndexedPackages()
 {
    std::vector<std::string> pkgNames;
@@ -510,9 +716,27 @@ Error initialize() {
    RS_REGISTER_CALL_METHOD(rs_getNAMESPACEImportedSymbols, 1);
    RS_REGISTER_CALL_METHOD(rs_getKnitParamsForDocument, 1);
    RS_REGISTER_CALL_METHOD(rs_listIndexedPackages, 0);
-   
+   RS_REGISTER_CALL_METHOD(rs_getSearchPathCompletions, 1);
+
    using boost::bind;
    using namespace module_context;
+
+   // invalidate the search path symbol cache when the package library
+   // changes underneath us
+   events().onLibPathsChanged.connect(
+         bind(clearSearchPathSymbolCache));
+   events().onPackageLoaded.connect(
+         bind(clearSearchPathSymbolCache));
+
+   // subscribe to project file monitor events so that rs_scanFiles can
+   // serve repeated scans from the scan cache (an empty feature name means
+   // we don't force monitoring on -- the cache is purely opportunistic)
+   projects::FileMonitorCallbacks cb;
+   cb.onMonitoringEnabled = onProjectMonitoringEnabled;
+   cb.onFilesChanged = onProjectFilesChanged;
+   cb.onMonitoringDisabled = onProjectMonitoringDisabled;
+   projects::projectContext().subscribeToFileMonitor("", cb);
+
    ExecBlock initBlock;
    initBlock.addFunctions()
          (bind(sourceModuleRFile, "SessionRCompletions.R"));
@@ -90,6 +90,32 @@ namespace renv {
 
 namespace {
 
+// refreshing renv state stats the lockfile and every file in the project
+// library, which adds per-prompt latency on network file systems -- so we
+// only refresh when the file monitor has reported a change to the renv
+// folder (the flag starts true so the first prompt seeds renv's cache)
+bool s_renvStateDirty = true;
+
+void onFilesChanged(const std::vector<core::system::FileChangeEvent>& changes)
+{
+   if (s_renvStateDirty)
+      return;
+
+   FilePath renvPath =
+         projects::projectContext().directory().completeChildPath("renv");
+
+   for (const core::system::FileChangeEvent& fileChange : changes)
+   {
+      FilePath changedFilePath(fileChange.fileInfo().absolutePath());
+      if (changedFilePath.getFilename() == "renv.lock" ||
+          changedFilePath.isWithin(renvPath))
+      {
+         s_renvStateDirty = true;
+         break;
+      }
+   }
+}
+
 void onConsolePrompt(const std::string& /* prompt */)
 {
    // use RENV_PROJECT environment variable to detect if renv active
@@ -103,6 +129,11 @@ void onConsolePrompt(const std::string& /* prompt */)
    if (!projDir.isEquivalentTo(FilePath(renvProject)))
       return;
 
+   // nothing relevant has changed since the last refresh
+   if (!s_renvStateDirty)
+      return;
+   s_renvStateDirty = false;
+
    Error error = r::exec::RFunction(".rs.renv.refresh") .call();
    if (error)
       LOG_ERROR(error);
@@ -118,6 +149,15 @@ Error initialize()
    // all other RStudio startup code runs first)
    events().onConsolePrompt.connect(onConsolePrompt);
 
+   // watch for changes to the lockfile and project library so the
+   // console-prompt refresh only runs when renv state may have changed
+   if (projects::projectContext().hasProject())
+   {
+      projects::FileMonitorCallbacks cb;
+      cb.onFilesChanged = onFilesChanged;
+      projects::projectContext().subscribeToFileMonitor("renv", cb);
+   }
+
    using boost::bind;
    ExecBlock initBlock;
    initBlock.addFunctions()
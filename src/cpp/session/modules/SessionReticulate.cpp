@@ -24,6 +24,7 @@
 
 #include <r/RExec.hpp>
 #include <r/RRoutines.hpp>
+#include <r/RSexp.hpp>
 
 #include <session/SessionModuleContext.hpp>
 
@@ -54,6 +55,22 @@ SEXP rs_reticulateInitialized()
    return R_NilValue;
 }
 
+SEXP rs_reticulateReplOutput(SEXP outputSEXP, SEXP errorSEXP)
+{
+   // write Python REPL output directly to the client event queue,
+   // bypassing R's console write machinery (sinks, write callbacks,
+   // and the extra copy reticulate's R-level capture would perform).
+   // the event queue coalesces adjacent writes, so high-volume Python
+   // output is batched the same way R console output is
+   std::string output = r::sexp::safeAsString(outputSEXP);
+   if (r::sexp::asLogical(errorSEXP))
+      module_context::consoleWriteError(output);
+   else
+      module_context::consoleWriteOutput(output);
+
+   return R_NilValue;
+}
+
 void onDeferredInit(bool)
 {
    Error error = r::exec::RFunction(".rs.reticulate.initialize").call();
@@ -84,6 +101,7 @@ Error initialize()
    events().onDeferredInit.connect(onDeferredInit);
 
    RS_REGISTER_CALL_METHOD(rs_reticulateInitialized);
+   RS_REGISTER_CALL_METHOD(rs_reticulateReplOutput);
 
    ExecBlock initBlock;
    initBlock.addFunctions()
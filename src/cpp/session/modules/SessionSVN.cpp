@@ -21,6 +21,8 @@
 #include <shlwapi.h>
 #endif
 
+#include <map>
+
 #include <boost/algorithm/string.hpp>
 #include <boost/bind.hpp>
 #include <boost/date_time.hpp>
@@ -828,36 +830,15 @@ Error statusToJson(const core::FilePath &path,
    return Success();
 }
 
-Error status(const FilePath& filePath,
-             std::vector<source_control::FileWithStatus>* pFiles)
+Error parseStatusXml(const std::string& statusXml,
+                     std::vector<source_control::FileWithStatus>* pFiles)
 {
    using namespace source_control;
 
-   ShellArgs args;
-   args << "status" << globalArgs() << "--xml" << "--ignore-externals";
-   if (!filePath.isEmpty())
-      args << "--" << filePath;
-
-   std::string stdOut, stdErr;
-   int exitCode;
-   Error error = runSvn(
-         args,
-         &stdOut,
-         &stdErr,
-         &exitCode);
-   if (error)
-      return error;
-
-   if (exitCode != EXIT_SUCCESS)
-   {
-      LOG_ERROR_MESSAGE(stdErr);
-      return Success();
-   }
-
    std::vector<char> xmlData;
    using namespace rapidxml;
    xml_document<> doc;
-   error = parseXml(stdOut, &xmlData, &doc);
+   Error error = parseXml(statusXml, &xmlData, &doc);
    if (error)
       return error;
 
@@ -932,17 +913,39 @@ Error status(const FilePath& filePath,
 }
 
 Error status(const FilePath& filePath,
-             json::Array* pResults)
+             std::vector<source_control::FileWithStatus>* pFiles)
 {
-   std::vector<source_control::FileWithStatus> files;
-   Error error = status(filePath, &files);
+   ShellArgs args;
+   args << "status" << globalArgs() << "--xml" << "--ignore-externals";
+   if (!filePath.isEmpty())
+      args << "--" << filePath;
+
+   std::string stdOut, stdErr;
+   int exitCode;
+   Error error = runSvn(
+         args,
+         &stdOut,
+         &stdErr,
+         &exitCode);
    if (error)
       return error;
 
+   if (exitCode != EXIT_SUCCESS)
+   {
+      LOG_ERROR_MESSAGE(stdErr);
+      return Success();
+   }
+
+   return parseStatusXml(stdOut, pFiles);
+}
+
+Error statusFilesToJson(const std::vector<source_control::FileWithStatus>& files,
+                        json::Array* pResults)
+{
    for (source_control::FileWithStatus file : files)
    {
       json::Object fileObj;
-      error = statusToJson(file.path, file.status, &fileObj);
+      Error error = statusToJson(file.path, file.status, &fileObj);
       if (error)
          return error;
       pResults->push_back(fileObj);
@@ -950,15 +953,183 @@ Error status(const FilePath& filePath,
    return Success();
 }
 
-Error svnStatus(const json::JsonRpcRequest& request,
-                json::JsonRpcResponse* pResponse)
+Error status(const FilePath& filePath,
+             json::Array* pResults)
 {
-   json::Array results;
-   Error error = status(FilePath(), &results);
+   std::vector<source_control::FileWithStatus> files;
+   Error error = status(filePath, &files);
    if (error)
       return error;
 
-   pResponse->setResult(results);
+   return statusFilesToJson(files, pResults);
+}
+
+// cached results of the last full `svn status` query, along with the
+// machinery that keeps it current. `svn status` only inspects the
+// working copy, but on large legacy repos a full run can still take
+// seconds, so the pane's status query is served from this cache and
+// refreshed by a background process driven by file-monitor events
+bool s_statusMonitoring = false;
+bool s_statusCacheValid = false;
+json::Array s_cachedStatusResults;
+bool s_statusRefreshRunning = false;
+bool s_statusRefreshPending = false;
+std::time_t s_lastWcDbTime = 0;
+
+void startStatusRefresh();
+
+void invalidateStatusCache()
+{
+   s_statusCacheValid = false;
+   if (s_statusMonitoring)
+      startStatusRefresh();
+}
+
+// the project file monitor doesn't watch .svn, so operations that change
+// status without touching monitored files (commits, updates, reverts --
+// including svn run outside of RStudio) are detected by checking the
+// working copy database for modification
+void checkWcState()
+{
+   FilePath wcDbPath = s_workingDir.completeChildPath(".svn")
+                                   .completeChildPath("wc.db");
+   if (!wcDbPath.exists())
+   {
+      // pre-1.7 working copy (per-directory .svn); don't attempt to cache
+      s_statusCacheValid = false;
+      return;
+   }
+
+   std::time_t wcDbTime = wcDbPath.getLastWriteTime();
+   if (wcDbTime != s_lastWcDbTime)
+   {
+      s_statusCacheValid = false;
+      s_lastWcDbTime = wcDbTime;
+   }
+}
+
+void onStatusRefreshCompleted(const core::system::ProcessResult& result)
+{
+   s_statusRefreshRunning = false;
+
+   if (result.exitStatus == EXIT_SUCCESS)
+   {
+      std::vector<source_control::FileWithStatus> files;
+      json::Array results;
+      Error error = parseStatusXml(result.stdOut, &files);
+      if (!error)
+         error = statusFilesToJson(files, &results);
+
+      if (error)
+      {
+         LOG_ERROR(error);
+      }
+      else
+      {
+         s_cachedStatusResults = results;
+         s_statusCacheValid = true;
+
+         // let the client know fresh results are available (its query
+         // will be served from the cache)
+         enqueueRefreshEvent();
+      }
+   }
+   else if (!result.stdErr.empty())
+   {
+      LOG_ERROR_MESSAGE(result.stdErr);
+   }
+
+   // an invalidation arrived while we were running; go again so the
+   // cache catches up
+   if (s_statusRefreshPending)
+   {
+      s_statusRefreshPending = false;
+      startStatusRefresh();
+   }
+}
+
+void startStatusRefresh()
+{
+   // coalesce change bursts: if a refresh is already running pick the
+   // request back up when it completes
+   if (s_statusRefreshRunning)
+   {
+      s_statusRefreshPending = true;
+      return;
+   }
+
+   // `svn status` without -u is working-copy-local, so no auth prompting
+   // is possible and we can run it headless
+   ShellArgs args;
+   args << "status" << globalArgs() << "--xml" << "--ignore-externals";
+
+   core::system::ProcessOptions options = procOptions();
+   if (!s_workingDir.isEmpty())
+      options.workingDir = s_workingDir;
+
+   Error error = module_context::processSupervisor().runProgram(
+            s_svnExePath,
+            args.args(),
+            "",
+            options,
+            &onStatusRefreshCompleted);
+   if (error)
+      LOG_ERROR(error);
+   else
+      s_statusRefreshRunning = true;
+}
+
+void onStatusMonitoringEnabled(const tree<core::FileInfo>&)
+{
+   s_statusMonitoring = true;
+   s_statusCacheValid = false;
+}
+
+void onStatusMonitoringDisabled()
+{
+   s_statusMonitoring = false;
+   s_statusCacheValid = false;
+}
+
+void onFilesChanged(const std::vector<core::system::FileChangeEvent>& events)
+{
+   invalidateStatusCache();
+}
+
+Error svnStatus(const json::JsonRpcRequest& request,
+                json::JsonRpcResponse* pResponse)
+{
+   // without file monitoring we can't observe working tree changes, so
+   // preserve the previous always-rescan behavior
+   if (s_statusMonitoring)
+      checkWcState();
+   else
+      s_statusCacheValid = false;
+
+   if (!s_statusCacheValid)
+   {
+      if (s_statusRefreshRunning)
+      {
+         // a background refresh is underway; serve the previous results
+         // now and let its completion event bring the client back for
+         // fresh ones (briefly stale beats blocking the session for the
+         // duration of a full status run)
+         pResponse->setResult(s_cachedStatusResults);
+         return Success();
+      }
+
+      // no refresh in flight (e.g. first query of the session); run one
+      // synchronously
+      json::Array results;
+      Error error = status(FilePath(), &results);
+      if (error)
+         return error;
+
+      s_cachedStatusResults = results;
+      s_statusCacheValid = true;
+   }
+
+   pResponse->setResult(s_cachedStatusResults);
 
    return Success();
 }
@@ -1280,7 +1451,16 @@ Error parseHistoryXml(int skip,
    return Success();
 }
 
-void historyEnd(boost::function<void(Error, const std::string&)> callback,
+// cache of raw `svn log --xml` output keyed by the exact argument list.
+// revision-pinned queries (-r N:1) are immutable in svn, so their output
+// can be replayed for pagination and back-navigation in the history pane
+// without a round trip to the (potentially slow) server; HEAD-relative
+// queries are never cached
+std::map<std::string, std::string> s_logCache;
+const std::size_t kMaxLogCacheEntries = 16;
+
+void historyEnd(std::string cacheKey,
+                boost::function<void(Error, const std::string&)> callback,
                 const Error& error,
                 const core::system::ProcessResult& result)
 {
@@ -1290,6 +1470,13 @@ void historyEnd(boost::function<void(Error, const std::string&)> callback,
    if (error)
       LOG_ERROR(error);
 
+   if (!error && result.exitStatus == EXIT_SUCCESS && !cacheKey.empty())
+   {
+      if (s_logCache.size() >= kMaxLogCacheEntries)
+         s_logCache.clear();
+      s_logCache[cacheKey] = result.stdOut;
+   }
+
    callback(error, result.stdOut);
 }
 
@@ -1312,10 +1499,24 @@ void history(int rev,
    if (!fileFilter.isEmpty())
       args << fileFilter;
 
+   // replay cached output for revision-pinned queries
+   std::string cacheKey;
+   if (rev > 0)
+   {
+      cacheKey = boost::algorithm::join(args.args(), " ");
+      std::map<std::string, std::string>::const_iterator it =
+                                                   s_logCache.find(cacheKey);
+      if (it != s_logCache.end())
+      {
+         callback(Success(), it->second);
+         return;
+      }
+   }
+
    runSvnAsync(args,
                "SVN History",
                false,
-               boost::bind(historyEnd, callback, _1, _2));
+               boost::bind(historyEnd, cacheKey, callback, _1, _2));
 }
 
 Error svnHistoryCountEnd_CommitCallback(int* pCount, const CommitInfo&)
@@ -1887,6 +2088,14 @@ Error initializeSvn(const core::FilePath& workingDir)
 
    prefs::userPrefs().onChanged.connect(onUserSettingsChanged);
 
+   // subscribe to file monitor changes so background status refreshes can
+   // keep the cache current (if there is no project this will no-op)
+   projects::FileMonitorCallbacks cb;
+   cb.onMonitoringEnabled = onStatusMonitoringEnabled;
+   cb.onFilesChanged = onFilesChanged;
+   cb.onMonitoringDisabled = onStatusMonitoringDisabled;
+   projects::projectContext().subscribeToFileMonitor("SVN status", cb);
+
    return Success();
 }
 
@@ -59,6 +59,35 @@ namespace {
 // track a pending Shiny path launch
 FilePath s_pendingShinyPath;
 
+// a single pre-initialized R child kept warm so background Run App
+// iteration doesn't pay R + shiny startup on every run; replenished in
+// the background after each use
+boost::shared_ptr<shiny::ShinyAsyncJob> s_pWarmShinyJob;
+
+void replenishWarmShinyJob()
+{
+   if (s_pWarmShinyJob)
+      return;
+
+   s_pWarmShinyJob = boost::make_shared<shiny::ShinyAsyncJob>();
+   s_pWarmShinyJob->startWarm();
+}
+
+boost::shared_ptr<shiny::ShinyAsyncJob> takeWarmShinyJob()
+{
+   boost::shared_ptr<shiny::ShinyAsyncJob> pJob = s_pWarmShinyJob;
+   s_pWarmShinyJob.reset();
+
+   if (pJob && pJob->warmReady())
+      return pJob;
+
+   // the warm child died while idle (e.g. R startup failure)
+   if (pJob)
+      pJob->terminate();
+
+   return boost::shared_ptr<shiny::ShinyAsyncJob>();
+}
+
 void enqueueStartEvent(const std::string& url,
                        const std::string& path,
                        const std::string& viewerType,
@@ -284,21 +313,50 @@ Error runShinyBackgroundApp(boost::shared_ptr<std::string> pShinyViewerType,
    std::string cmd = shinyRunCmd(targetPath, appPath, extendedType, 
          AppDestination::BackgroundApp);
 
-   // create the asynchronous R job that will be used to run the Shiny application
-   boost::shared_ptr<shiny::ShinyAsyncJob> pJob = boost::make_shared<shiny::ShinyAsyncJob>(
-         "Shiny: " + appPath.getFilename(),
-         module_context::resolveAliasedPath(targetPath),
-         *pShinyViewerType,
-         cmd);
-
-   // register it and create an ID
    std::string id;
-   error = jobs::registerAsyncRJob(pJob, &id);
-   if (error)
-      return error;
 
-   // start the job (actually creates the underlying R session)
-   pJob->start();
+   // use the warm runner when one is available; its R child is already
+   // initialized so the app starts nearly instantly
+   boost::shared_ptr<shiny::ShinyAsyncJob> pJob = takeWarmShinyJob();
+   if (pJob)
+   {
+      pJob->setApp(
+            "Shiny: " + appPath.getFilename(),
+            module_context::resolveAliasedPath(targetPath),
+            *pShinyViewerType,
+            cmd);
+
+      // register it and create an ID
+      error = jobs::registerAsyncRJob(pJob, &id);
+      if (error)
+         return error;
+
+      // hand the app to the waiting R child
+      pJob->run();
+   }
+   else
+   {
+      // create the asynchronous R job that will be used to run the Shiny application
+      pJob = boost::make_shared<shiny::ShinyAsyncJob>(
+            "Shiny: " + appPath.getFilename(),
+            module_context::resolveAliasedPath(targetPath),
+            *pShinyViewerType,
+            cmd);
+
+      // register it and create an ID
+      error = jobs::registerAsyncRJob(pJob, &id);
+      if (error)
+         return error;
+
+      // start the job (actually creates the underlying R session)
+      pJob->start();
+   }
+
+   // keep the next runner warm; deferred briefly (and to idle time) so
+   // the launch doesn't compete with the app we just started
+   module_context::scheduleDelayedWork(boost::posix_time::seconds(5),
+                                       replenishWarmShinyJob,
+                                       true);
 
    // return the ID we created
    pResponse->setResult(id);
@@ -15,6 +15,8 @@
 
 #include "SessionSnippets.hpp"
 
+#include <sstream>
+
 #include <shared_core/Error.hpp>
 #include <core/Exec.hpp>
 #include <core/FileSerializer.hpp>
@@ -112,7 +114,7 @@ bool isSnippetFilePath(const FilePath& filePath,
    return true;
 }
 
-Error getSnippetsAsJson(json::Array* pJsonData)
+std::vector<FilePath> getSnippetsDirs()
 {
    std::vector<FilePath> dirs;
 
@@ -125,7 +127,49 @@ Error getSnippetsAsJson(json::Array* pJsonData)
    // Add user snippets files
    dirs.push_back(getSnippetsDir());
 
-   for (const auto& snippetsDir: dirs)
+   return dirs;
+}
+
+// fingerprint of all snippet files across the search path (path + mtime +
+// size per file). computing this only stats the files, so we can detect
+// an unchanged snippet collection without reading any of the contents
+std::string snippetsFingerprint()
+{
+   std::ostringstream ostr;
+   for (const FilePath& snippetsDir : getSnippetsDirs())
+   {
+      if (!snippetsDir.exists() || !snippetsDir.isDirectory())
+         continue;
+
+      std::vector<FilePath> snippetPaths;
+      Error error = snippetsDir.getChildren(snippetPaths);
+      if (error)
+      {
+         LOG_ERROR(error);
+         continue;
+      }
+
+      for (const FilePath& filePath : snippetPaths)
+      {
+         std::string mode;
+         if (!isSnippetFilePath(filePath, &mode))
+            continue;
+
+         ostr << filePath.getAbsolutePath() << ":"
+              << filePath.getLastWriteTime() << ":"
+              << filePath.getSize() << ";";
+      }
+   }
+   return ostr.str();
+}
+
+// compiled snippets, keyed by the fingerprint they were built from
+std::string s_compiledFingerprint;
+json::Array s_compiledSnippets;
+
+Error readSnippetsAsJson(json::Array* pJsonData)
+{
+   for (const auto& snippetsDir: getSnippetsDirs())
    {
       if (!snippetsDir.exists() || !snippetsDir.isDirectory())
       {
@@ -173,6 +217,82 @@ Error getSnippetsAsJson(json::Array* pJsonData)
    return Success();
 }
 
+const int kSnippetCacheVersion = 1;
+
+FilePath snippetsCachePath()
+{
+   return module_context::userScratchPath().completeChildPath("snippet-cache");
+}
+
+// return the compiled snippet collection, re-reading the source files
+// only when their fingerprint has changed. the compiled form is also
+// persisted (versioned, alongside the fingerprint it was built from) so
+// the next session's startup is a stat-and-load rather than a re-read
+// of every snippet file
+Error getSnippetsAsJson(json::Array* pJsonData)
+{
+   std::string fingerprint = snippetsFingerprint();
+
+   // in-memory hit
+   if (fingerprint == s_compiledFingerprint)
+   {
+      *pJsonData = s_compiledSnippets;
+      return Success();
+   }
+
+   // consult the cache persisted by a previous session
+   FilePath cachePath = snippetsCachePath();
+   if (cachePath.exists())
+   {
+      std::string contents;
+      Error error = core::readStringFromFile(cachePath, &contents);
+      if (!error)
+      {
+         json::Value cacheJson;
+         if (!cacheJson.parse(contents) &&
+             json::isType<json::Object>(cacheJson))
+         {
+            int version = 0;
+            std::string cachedFingerprint;
+            json::Array snippetsJson;
+            error = json::readObject(cacheJson.getObject(),
+                                     "version", version,
+                                     "fingerprint", cachedFingerprint,
+                                     "snippets", snippetsJson);
+            if (!error &&
+                version == kSnippetCacheVersion &&
+                cachedFingerprint == fingerprint)
+            {
+               s_compiledFingerprint = fingerprint;
+               s_compiledSnippets = snippetsJson;
+               *pJsonData = s_compiledSnippets;
+               return Success();
+            }
+         }
+      }
+   }
+
+   // compile from the source files and refresh both caches
+   json::Array snippetsJson;
+   Error error = readSnippetsAsJson(&snippetsJson);
+   if (error)
+      return error;
+
+   s_compiledFingerprint = fingerprint;
+   s_compiledSnippets = snippetsJson;
+
+   json::Object cacheJson;
+   cacheJson["version"] = kSnippetCacheVersion;
+   cacheJson["fingerprint"] = fingerprint;
+   cacheJson["snippets"] = snippetsJson;
+   error = core::writeStringToFile(cachePath, cacheJson.write());
+   if (error)
+      LOG_ERROR(error);
+
+   *pJsonData = s_compiledSnippets;
+   return Success();
+}
+
 void checkAndNotifyClientIfSnippetsAvailable()
 {
    json::Array jsonData;
@@ -136,10 +136,16 @@ std::string inferDocumentType(const FilePath& documentPath,
 }
 
 void writeDocToJson(boost::shared_ptr<SourceDocument> pDoc,
-                    core::json::Object* pDocJson)
+                    core::json::Object* pDocJson,
+                    bool includeContents = true)
 {
    // write the doc
-   pDoc->writeToJson(pDocJson);
+   pDoc->writeToJson(pDocJson, includeContents);
+
+   // flag deferred contents so the client knows to fetch them on demand
+   // (via get_source_document) rather than treating the doc as empty
+   if (!includeContents)
+      (*pDocJson)["contents_deferred"] = true;
 
    // derive the extended type property
    (*pDocJson)["extended_type"] = module_context::events()
@@ -553,18 +559,18 @@ Error saveDocumentDiff(const json::JsonRpcRequest& request,
    // unique id and jsonPath (can be null for auto-save)
    std::string id;
    json::Value jsonPath, jsonType, jsonEncoding, jsonFoldSpec, jsonChunkOutput;
-   
-   // This is a chunk of text that should be inserted into the
-   // current document. It replaces the subrange [offset, offset+length).
-   std::string replacement;
-   int offset, length;
+
+   // These are the replaced regions of the current document, in
+   // ascending offset order. Each chunk replaces the subrange
+   // [offset, offset+length) with its replacement text.
+   json::Value jsonChunks;
    bool valid;
-   
+
    // This is the expected hash of the current document. If the
    // current hash value is different than this value, then the
    // document cannot be patched and the request should be discarded.
    std::string hash;
-   
+
    // read params
    Error error = json::readParams(request.params,
                                   &id,
@@ -573,9 +579,7 @@ Error saveDocumentDiff(const json::JsonRpcRequest& request,
                                   &jsonEncoding,
                                   &jsonFoldSpec,
                                   &jsonChunkOutput,
-                                  &replacement,
-                                  &offset,
-                                  &length,
+                                  &jsonChunks,
                                   &valid,
                                   &hash);
    if (error)
@@ -609,12 +613,36 @@ Error saveDocumentDiff(const json::JsonRpcRequest& request,
       // going down this code path just to ensure that any code that
       // runs in response to a document save (even if that save fails)
       // still has a chance to run
-      if (valid)
+      if (valid && jsonChunks.isArray())
       {
-         // the offsets we receive are in bytes, so we can replace the contents
-         // of the string directly at the supplied offset + length (the contents
-         // string itself is already UTF-8 encoded)
-         contents.replace(offset, length, replacement);
+         // the offsets we receive are in bytes, so we can replace the
+         // contents of the string directly at the supplied offset +
+         // length (the contents string itself is already UTF-8 encoded).
+         // chunks arrive in ascending offset order against the original
+         // document, so apply them back to front to keep earlier
+         // offsets valid
+         const json::Array& chunks = jsonChunks.getArray();
+         for (std::size_t i = chunks.getSize(); i > 0; i--)
+         {
+            const json::Value& chunkValue = chunks[i - 1];
+            if (!chunkValue.isObject())
+               return Error(json::errc::ParamTypeMismatch, ERROR_LOCATION);
+
+            // borrow the replacement text from the request buffer
+            // (diff-based saves run on every autosave, so skipping the
+            // per-chunk copy matters)
+            boost::string_view replacement;
+            int offset, length;
+            error = json::readObject(chunkValue.getObject(),
+                                     "replacement", replacement,
+                                     "offset", offset,
+                                     "length", length);
+            if (error)
+               return error;
+
+            contents.replace(offset, length,
+                             replacement.data(), replacement.size());
+         }
       }
 
       // track if we're updating the document contents
@@ -1446,8 +1474,18 @@ Error clientInitDocuments(core::json::Array* pJsonDocs)
       if (error)
          LOG_ERROR(error);
 
+      // defer the contents of large clean file-backed documents -- the
+      // client fetches them on demand when the tab is activated, which
+      // keeps the init payload proportional to metadata rather than to
+      // the size of every open document. dirty and untitled documents
+      // are always sent inline
+      const size_t kMaxInlineDocContents = 16 * 1024;
+      bool includeContents = pDoc->dirty() ||
+                             pDoc->path().empty() ||
+                             pDoc->contents().size() <= kMaxInlineDocContents;
+
       json::Object jsonDoc;
-      writeDocToJson(pDoc, &jsonDoc);
+      writeDocToJson(pDoc, &jsonDoc, includeContents);
       pJsonDocs->push_back(jsonDoc);
 
       source_database::events().onDocUpdated(pDoc);
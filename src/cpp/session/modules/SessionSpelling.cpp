@@ -17,7 +17,10 @@
 
 #include <gsl/gsl>
 
+#include <map>
+
 #include <boost/shared_ptr.hpp>
+#include <boost/unordered_set.hpp>
 
 #include <core/Exec.hpp>
 #include <core/system/Xdg.hpp>
@@ -32,6 +35,7 @@
 
 #include <session/prefs/UserPrefs.hpp>
 #include <session/SessionModuleContext.hpp>
+#include <session/SessionSourceDatabase.hpp>
 
 #include <shared_core/Error.hpp>
 
@@ -51,6 +55,12 @@ namespace {
 // underlying spelling engine
 boost::scoped_ptr<core::spelling::SpellingEngine> s_pSpellingEngine;
 
+// per-document cache of words already verified as correct. enables the
+// client to re-check only the tokens touched by an edit (it sends just
+// those) while words previously seen in the document are answered without
+// consulting the engine at all
+std::map<std::string, boost::unordered_set<std::string> > s_documentCheckedWords;
+
 // R function for testing & debugging
 SEXP rs_checkSpelling(SEXP wordSEXP)
 {
@@ -87,6 +97,9 @@ FilePath userDictionariesDir()
 void syncSpellingEngineDictionaries()
 {
    s_pSpellingEngine->useDictionary(prefs::userPrefs().spellingDictionaryLanguage());
+
+   // a dictionary change invalidates previously verified words
+   s_documentCheckedWords.clear();
 }
 
 
@@ -227,6 +240,67 @@ Error checkSpelling(const json::JsonRpcRequest& request,
    return Success();
 }
 
+// incremental variant of check_spelling: scoped to a source document so
+// the client can send only the tokens intersecting an edit. words already
+// verified as correct for the document short-circuit before reaching the
+// spelling engine
+Error checkSpellingIncremental(const json::JsonRpcRequest& request,
+                               json::JsonRpcResponse* pResponse)
+{
+   std::string docId;
+   json::Array words;
+   Error error = json::readParams(request.params, &docId, &words);
+   if (error)
+      return error;
+
+   boost::unordered_set<std::string>& checkedWords = s_documentCheckedWords[docId];
+
+   json::Array misspelledIndexes;
+   for (std::size_t i=0; i<words.getSize(); i++)
+   {
+      if (!json::isType<std::string>(words[i]))
+      {
+         BOOST_ASSERT(false);
+         continue;
+      }
+
+      std::string word = words[i].getString();
+      if (checkedWords.count(word) > 0)
+         continue;
+
+      bool isCorrect = true;
+      error = s_pSpellingEngine->checkSpelling(word, &isCorrect);
+      if (error)
+      {
+         // see comment in checkSpelling: words which can't be converted
+         // for checking are simply not spell checked
+         LOG_ERROR(error);
+      }
+      else if (!isCorrect)
+      {
+         misspelledIndexes.push_back(gsl::narrow_cast<int>(i));
+      }
+      else
+      {
+         checkedWords.insert(word);
+      }
+   }
+
+   pResponse->setResult(misspelledIndexes);
+
+   return Success();
+}
+
+void onSourceDocRemoved(const std::string& id, const std::string& path)
+{
+   s_documentCheckedWords.erase(id);
+}
+
+void onAllSourceDocsRemoved()
+{
+   s_documentCheckedWords.clear();
+}
+
 Error suggestionList(const json::JsonRpcRequest& request,
                      json::JsonRpcResponse* pResponse)
 {
@@ -426,12 +500,17 @@ Error initialize()
    // connect to user settings changed
    prefs::userPrefs().onChanged.connect(onUserSettingsChanged);
 
+   // release per-document caches when documents go away
+   source_database::events().onDocRemoved.connect(onSourceDocRemoved);
+   source_database::events().onRemoveAll.connect(onAllSourceDocsRemoved);
+
    // register rpc methods
    using boost::bind;
    using namespace module_context;
    ExecBlock initBlock;
    initBlock.addFunctions()
       (bind(registerRpcMethod, "check_spelling", checkSpelling))
+      (bind(registerRpcMethod, "check_spelling_incremental", checkSpellingIncremental))
       (bind(registerRpcMethod, "suggestion_list", suggestionList))
       (bind(registerRpcMethod, "get_word_chars", getWordChars))
       (bind(registerRpcMethod, "add_custom_dictionary", addCustomDictionary))
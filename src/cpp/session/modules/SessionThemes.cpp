@@ -25,6 +25,7 @@
 #include <shared_core/Error.hpp>
 #include <core/Exec.hpp>
 #include <shared_core/FilePath.hpp>
+#include <core/Hash.hpp>
 #include <core/json/JsonRpc.hpp>
 
 #include <core/http/Request.hpp>
@@ -33,9 +34,12 @@
 #include <core/system/Xdg.hpp>
 
 #include <session/SessionModuleContext.hpp>
+#include <session/SessionUriContentCache.hpp>
 #include <session/prefs/UserPrefs.hpp>
 #include <session/prefs/UserState.hpp>
 
+#include "session-config.h"
+
 #include <r/RExec.hpp>
 #include <r/RRoutines.hpp>
 #include <r/RSexp.hpp>
@@ -563,11 +567,42 @@ void onDeferredInit(bool)
    s_deferredInitComplete = true;
 }
 
+// serve theme css with a strong validator: the content hash salted with
+// the IDE version, since theme compilation output can change across
+// releases and a new build must invalidate cached css even when the
+// source file didn't change. the bytes go through the shared content
+// cache, so the repeated theme fetches done at login don't re-read the
+// file from disk
 void setCacheableFile(const FilePath& filePath,
                       const http::Request& request,
                       http::Response* pResponse)
 {
-   pResponse->setCacheableFile(filePath, request);
+   if (!filePath.exists())
+   {
+      pResponse->setNotFoundError(request);
+      return;
+   }
+
+   std::string contents;
+   Error error = content_cache::readCachedFile(filePath, &contents);
+   if (error)
+   {
+      pResponse->setError(error);
+      return;
+   }
+
+   pResponse->setCacheWithRevalidationHeaders();
+
+   std::string eTag = core::hash::crc32Hash(contents + RSTUDIO_VERSION);
+   pResponse->setHeader("ETag", eTag);
+   if (eTag == request.headerValue("If-None-Match"))
+   {
+      pResponse->setStatusCode(http::status::NotModified);
+      return;
+   }
+
+   pResponse->setContentType(filePath.getMimeContentType());
+   pResponse->setBody(contents);
 }
 
 } // anonymous namespace
@@ -0,0 +1,217 @@
+/*
+ * SessionTokenService.cpp
+ *
+ * Copyright (C) 2020 by RStudio, PBC
+ *
+ * Unless you have received this program directly from RStudio pursuant
+ * to the terms of a commercial license agreement with RStudio, then
+ * this program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ *
+ */
+
+#include "SessionTokenService.hpp"
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <string>
+
+#include <boost/bind.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <shared_core/Error.hpp>
+#include <core/Exec.hpp>
+#include <core/StringUtils.hpp>
+#include <core/json/JsonRpc.hpp>
+#include <core/r_util/RTokenizer.hpp>
+
+#include <session/SessionModuleContext.hpp>
+#include <session/SessionSourceDatabase.hpp>
+
+using namespace rstudio::core;
+
+namespace rstudio {
+namespace session {
+namespace modules {
+namespace token_service {
+
+namespace {
+
+// tokenized documents, keyed by document id. the client tokenizes files it
+// edits itself; this cache exists so very large files can render highlighted
+// text immediately on open, before the client-side tokenizer catches up.
+// entries are invalidated when the document changes, so the cache holds at
+// most one generation (identified by the document hash) per document
+struct TokenCache
+{
+   std::string hash;
+   json::Array tokens;
+};
+
+std::map<std::string, TokenCache> s_tokenCache;
+
+// R keywords highlighted distinctly from ordinary identifiers
+bool isKeyword(const std::wstring& content)
+{
+   static const std::set<std::wstring> kKeywords = {
+      L"function", L"if", L"else", L"for", L"while", L"repeat",
+      L"break", L"next", L"return", L"TRUE", L"FALSE", L"NULL",
+      L"NA", L"NA_integer_", L"NA_real_", L"NA_character_",
+      L"Inf", L"NaN", L"in"
+   };
+   return kKeywords.count(content) > 0;
+}
+
+const char* tokenTypeName(const r_util::RToken& token)
+{
+   switch (token.type())
+   {
+      case r_util::RToken::STRING:
+         return "string";
+      case r_util::RToken::NUMBER:
+         return "number";
+      case r_util::RToken::ID:
+         return isKeyword(token.content()) ? "keyword" : "identifier";
+      case r_util::RToken::COMMENT:
+         return "comment";
+      case r_util::RToken::OPER:
+      case r_util::RToken::UOPER:
+         return "operator";
+      case r_util::RToken::LPAREN:
+      case r_util::RToken::RPAREN:
+      case r_util::RToken::LBRACKET:
+      case r_util::RToken::RBRACKET:
+      case r_util::RToken::LDBRACKET:
+      case r_util::RToken::RDBRACKET:
+      case r_util::RToken::LBRACE:
+      case r_util::RToken::RBRACE:
+         return "bracket";
+      case r_util::RToken::COMMA:
+      case r_util::RToken::SEMI:
+         return "punctuation";
+      default:
+         return "text";
+   }
+}
+
+// tokenize document contents into an array of [row, column, length, type]
+// spans (whitespace is omitted; the client infers gaps from the offsets)
+json::Array tokenizeContents(const std::string& contents)
+{
+   json::Array tokensJson;
+
+   std::wstring wideContents = string_utils::utf8ToWide(contents);
+   r_util::RTokenizer tokenizer(wideContents);
+   r_util::RToken token;
+   while ((token = tokenizer.nextToken()))
+   {
+      if (token.type() == r_util::RToken::WHITESPACE)
+         continue;
+
+      json::Array tokenJson;
+      tokenJson.push_back(static_cast<int>(token.row()));
+      tokenJson.push_back(static_cast<int>(token.column()));
+      tokenJson.push_back(static_cast<int>(token.length()));
+      tokenJson.push_back(tokenTypeName(token));
+      tokensJson.push_back(tokenJson);
+   }
+
+   return tokensJson;
+}
+
+// serve a page of highlight tokens for the given document. the first
+// request for a document generation tokenizes and caches the whole
+// document; subsequent pages are served from the cache
+Error getDocumentTokens(const json::JsonRpcRequest& request,
+                        json::JsonRpcResponse* pResponse)
+{
+   std::string id;
+   int start, count;
+   Error error = json::readParams(request.params, &id, &start, &count);
+   if (error)
+      return error;
+   if (start < 0 || count < 0)
+      return Error(json::errc::ParamInvalid, ERROR_LOCATION);
+
+   boost::shared_ptr<source_database::SourceDocument> pDoc(
+            new source_database::SourceDocument());
+   error = source_database::get(id, pDoc);
+   if (error)
+      return error;
+
+   json::Object resultJson;
+   resultJson["hash"] = pDoc->hash();
+
+   // only R sources are tokenized server-side; for other document types
+   // return no tokens so the client falls back to local tokenization
+   if (!pDoc->isRFile())
+   {
+      resultJson["start"] = 0;
+      resultJson["total"] = 0;
+      resultJson["tokens"] = json::Array();
+      pResponse->setResult(resultJson);
+      return Success();
+   }
+
+   TokenCache& cache = s_tokenCache[id];
+   if (cache.hash != pDoc->hash())
+   {
+      cache.hash = pDoc->hash();
+      cache.tokens = tokenizeContents(pDoc->contents());
+   }
+
+   json::Array pageJson;
+   std::size_t total = cache.tokens.getSize();
+   std::size_t begin = std::min(static_cast<std::size_t>(start), total);
+   std::size_t end = std::min(begin + static_cast<std::size_t>(count), total);
+   for (std::size_t i = begin; i < end; i++)
+      pageJson.push_back(cache.tokens[i]);
+
+   resultJson["start"] = static_cast<int>(begin);
+   resultJson["total"] = static_cast<int>(total);
+   resultJson["tokens"] = pageJson;
+   pResponse->setResult(resultJson);
+   return Success();
+}
+
+void onDocUpdated(boost::shared_ptr<source_database::SourceDocument> pDoc)
+{
+   // drop the cached generation (it's rebuilt on the next page request)
+   s_tokenCache.erase(pDoc->id());
+}
+
+void onDocRemoved(const std::string& id, const std::string&)
+{
+   s_tokenCache.erase(id);
+}
+
+void onMemoryTrim()
+{
+   // token pages are rebuilt on the next request
+   s_tokenCache.clear();
+}
+
+} // anonymous namespace
+
+Error initialize()
+{
+   source_database::events().onDocUpdated.connect(onDocUpdated);
+   source_database::events().onDocRemoved.connect(onDocRemoved);
+   module_context::events().onMemoryTrim.connect(onMemoryTrim);
+
+   using boost::bind;
+   using namespace module_context;
+   ExecBlock initBlock;
+   initBlock.addFunctions()
+      (bind(registerRpcMethod, "get_document_tokens", getDocumentTokens));
+   return initBlock.execute();
+}
+
+} // namespace token_service
+} // namespace modules
+} // namespace session
+} // namespace rstudio
@@ -17,6 +17,7 @@
 
 #include "session-config.h"
 
+#include <algorithm>
 #include <vector>
 
 #include <boost/utility.hpp>
@@ -27,8 +28,12 @@
 #include <boost/algorithm/string/split.hpp>
 #include <boost/algorithm/string/join.hpp>
 
+#include <boost/thread.hpp>
+
 #include <core/Exec.hpp>
 #include <core/FileSerializer.hpp>
+#include <core/Hash.hpp>
+#include <shared_core/SafeConvert.hpp>
 #include <core/text/DcfParser.hpp>
 #include <core/system/Process.hpp>
 #include <core/system/Environment.hpp>
@@ -39,6 +44,8 @@
 
 #ifdef _WIN32
 #include <core/r_util/RToolsInfo.hpp>
+#else
+#include <core/system/PosixSystem.hpp>
 #endif
 
 #include <r/RExec.hpp>
@@ -228,6 +235,162 @@ bool collectForcePackageRebuild()
 }
 
 
+// auto-size the parallelism for package compiles: start from the core
+// count, then back off by the current load average so we don't
+// oversubscribe a machine that's already busy (e.g. a shared server
+// with several active sessions)
+int packageBuildJobs()
+{
+   int jobs = static_cast<int>(boost::thread::hardware_concurrency());
+
+#ifndef _WIN32
+   core::system::SysInfo sysInfo;
+   Error error = core::system::systemInformation(&sysInfo);
+   if (error)
+      LOG_ERROR(error);
+   else
+      jobs -= static_cast<int>(sysInfo.load1);
+#endif
+
+   return std::max(jobs, 1);
+}
+
+// ---- incremental website builds ----
+//
+// after each successful website build we write a manifest of source
+// file hashes; when every change since the last build is confined to
+// top-level .Rmd/.md documents the next build re-renders just the
+// changed files rather than the whole site. changes to site
+// configuration, includes, or assets force a full rebuild, as does
+// bookdown (whose cross-references require rendering the book as a
+// whole).
+
+FilePath websiteManifestPath()
+{
+   return projects::projectContext().scratchPath().completeChildPath(
+                                                      "website-manifest");
+}
+
+// top-level .Rmd/.md documents are independently renderable via
+// rmarkdown::render_site(<file>)
+bool isWebsiteSourceFile(const FilePath& websitePath, const FilePath& filePath)
+{
+   if (filePath.getParent() != websitePath)
+      return false;
+
+   std::string ext = filePath.getExtensionLowerCase();
+   return ext == ".rmd" || ext == ".md";
+}
+
+Error computeWebsiteManifest(const FilePath& websitePath,
+                             json::Object* pManifestJson)
+{
+   // determine the output directory (never part of the source manifest)
+   FilePath outputDirPath;
+   std::string outputDir = module_context::websiteOutputDir();
+   if (!outputDir.empty())
+      outputDirPath = websitePath.completeChildPath(outputDir);
+
+   json::Object manifestJson;
+   Error error = websitePath.getChildrenRecursive(
+      [&](int, const FilePath& child) -> bool
+      {
+         if (child.isDirectory())
+            return true;
+
+         // skip hidden files and anything within a hidden directory
+         // or the website output directory
+         std::string relative = child.getRelativePath(websitePath);
+         if (relative.empty() || relative[0] == '.' ||
+             relative.find("/.") != std::string::npos)
+            return true;
+         if (!outputDirPath.isEmpty() && child.isWithin(outputDirPath))
+            return true;
+
+         boost::uint64_t fileHash;
+         Error hashError = hash::hashFile64(child, &fileHash);
+         if (hashError)
+         {
+            LOG_ERROR(hashError);
+            return true;
+         }
+
+         manifestJson[relative] = safe_convert::numberToString(fileHash);
+         return true;
+      });
+   if (error)
+      return error;
+
+   *pManifestJson = manifestJson;
+   return Success();
+}
+
+// returns true (along with the set of files to re-render) when the
+// build can be satisfied by rendering only changed files
+bool websiteFilesToRender(const FilePath& websitePath,
+                          const json::Object& manifestJson,
+                          std::vector<std::string>* pFiles)
+{
+   // bookdown chapters are not independently renderable
+   if (module_context::isBookdownWebsite())
+      return false;
+
+   // read the manifest from the previous successful build
+   FilePath manifestPath = websiteManifestPath();
+   if (!manifestPath.exists())
+      return false;
+   std::string contents;
+   Error error = core::readStringFromFile(manifestPath, &contents);
+   if (error)
+   {
+      LOG_ERROR(error);
+      return false;
+   }
+   json::Object previousJson;
+   if (previousJson.parse(contents))
+      return false;
+
+   // a file removed since the last build requires a full rebuild
+   // (so its stale output isn't presented as current)
+   for (const json::Object::Member& member : previousJson)
+   {
+      if (manifestJson.find(member.getName()) == manifestJson.end())
+         return false;
+   }
+
+   // collect changed files; anything other than an independently
+   // renderable document forces a full rebuild
+   std::vector<std::string> files;
+   for (const json::Object::Member& member : manifestJson)
+   {
+      json::Object::Iterator it = previousJson.find(member.getName());
+      if (it != previousJson.end() &&
+          (*it).getValue() == member.getValue())
+      {
+         continue;
+      }
+
+      std::string relative = member.getName();
+      if (!isWebsiteSourceFile(websitePath,
+                               websitePath.completeChildPath(relative)))
+         return false;
+
+      // don't attempt to quote exotic file names into R code
+      if (relative.find('\'') != std::string::npos ||
+          relative.find('\\') != std::string::npos)
+         return false;
+
+      files.push_back(relative);
+   }
+
+   // nothing changed -- the user asked for a build so do a full one
+   if (files.empty())
+      return false;
+
+   *pFiles = files;
+   return true;
+}
+
 const char * const kRoxygenizePackage = "roxygenize-package";
 const char * const kBuildSourcePackage = "build-source-package";
 const char * const kBuildBinaryPackage = "build-binary-package";
@@ -253,8 +416,10 @@ public:
 
 private:
    Build()
-      : isRunning_(false), terminationRequested_(false), restartR_(false),
-        usedDevtools_(false), openErrorList_(true)
+      : isRunning_(false), terminationRequested_(false),
+        reportedErrorCount_(0), lastErrorParseLength_(0), restartR_(false),
+        usedDevtools_(false), openErrorList_(true),
+        havePendingWebsiteManifest_(false)
    {
    }
 
@@ -709,6 +874,19 @@ private:
       core::system::setenv(&childEnv, "R_BROWSER", "false");
       core::system::setenv(&childEnv, "R_PDFVIEWER", "false");
 
+      // parallelize src/ compilation (unless the user has already
+      // expressed a preference via MAKEFLAGS)
+      if (core::system::getenv(childEnv, "MAKEFLAGS").empty())
+      {
+         int jobs = packageBuildJobs();
+         if (jobs > 1)
+         {
+            core::system::setenv(&childEnv,
+                                 "MAKEFLAGS",
+                                 "-j" + safe_convert::numberToString(jobs));
+         }
+      }
+
       // add r tools to path if necessary
       module_context::addRtoolsToPathIfNecessary(&childEnv, &buildToolsWarning_);
 
@@ -1469,7 +1647,6 @@ private:
             options_.websiteOutputFormat = subType;
          }
 
-         boost::format fmt("rmarkdown::render_site(%1%)");
          std::string format;
          if (options_.websiteOutputFormat != "all")
             format = "output_format = '" + options_.websiteOutputFormat + "', ";
@@ -1478,10 +1655,50 @@ private:
                     projects::projectContext().defaultEncoding() +
                     "'");
 
-         command = boost::str(fmt % format);
+         // compute the current source manifest; on a successful build
+         // it's written out so subsequent builds can be incremental
+         // (note that we snapshot it now, before launching the build,
+         // so that files edited while the build runs are still seen
+         // as changed next time)
+         json::Object manifestJson;
+         Error error = computeWebsiteManifest(websitePath, &manifestJson);
+         if (error)
+            LOG_ERROR(error);
+         else
+         {
+            pendingWebsiteManifest_ = manifestJson;
+            havePendingWebsiteManifest_ = true;
+         }
+
+         // if only independently renderable documents have changed
+         // since the last successful build then render just those
+         // files rather than the whole site
+         std::vector<std::string> filesToRender;
+         if (subType.empty() && !error &&
+             websiteFilesToRender(websitePath, manifestJson, &filesToRender))
+         {
+            std::vector<std::string> renderCommands;
+            for (const std::string& file : filesToRender)
+            {
+               renderCommands.push_back(
+                  "rmarkdown::render_site('" + file + "', " + format + ")");
+            }
+            command = boost::algorithm::join(renderCommands, "; ");
+         }
+         else
+         {
+            boost::format fmt("rmarkdown::render_site(%1%)");
+            command = boost::str(fmt % format);
+         }
       }
       else if (type == "clean-all")
       {
+         // outputs are being removed so the manifest no longer
+         // reflects a built site
+         Error error = websiteManifestPath().removeIfExists();
+         if (error)
+            LOG_ERROR(error);
+
          command = "rmarkdown::clean_site()";
       }
 
@@ -1611,6 +1828,8 @@ private:
          outputWithFilter(output);
       else
          enqueBuildOutput(module_context::kCompileOutputNormal, output);
+
+      streamBuildErrors(false);
    }
 
    void onStandardError(const std::string& output)
@@ -1619,23 +1838,61 @@ private:
          outputWithFilter(output);
       else
          enqueBuildOutput(module_context::kCompileOutputError, output);
+
+      streamBuildErrors(false);
    }
 
-   void onCompleted(int exitStatus)
+   // parse accumulated output for structured diagnostics and stream any
+   // newly discovered markers to the client while the build is still
+   // running (rather than withholding them all until completion)
+   void streamBuildErrors(bool completed)
    {
       using namespace module_context;
 
-      // call the error parser if one has been specified
-      if (errorParser_)
+      if (!errorParser_)
+         return;
+
+      std::string output = outputAsText();
+
+      if (!completed)
       {
-         std::vector<SourceMarker> errors = errorParser_(outputAsText());
-         if (!errors.empty())
-         {
-            errorsJson_ = sourceMarkersAsJson(errors);
-            enqueBuildErrors(errorsJson_);
-         }
+         // wait until a reasonable amount of new output has accumulated
+         // (each parse re-scans the output from the beginning)
+         if (output.length() < (lastErrorParseLength_ + 512))
+            return;
+
+         // only consider complete lines -- a diagnostic delivered in
+         // two chunks would otherwise be reported truncated
+         std::size_t lastNewline = output.find_last_of('\n');
+         if (lastNewline == std::string::npos)
+            return;
+         output.erase(lastNewline + 1);
       }
 
+      lastErrorParseLength_ = output.length();
+
+      // the parsers re-discover previously reported markers (in the
+      // same order) so only the tail of the list is new
+      std::vector<SourceMarker> errors = errorParser_(output);
+      if (errors.size() <= reportedErrorCount_)
+         return;
+
+      std::vector<SourceMarker> newErrors(errors.begin() + reportedErrorCount_,
+                                          errors.end());
+      reportedErrorCount_ = errors.size();
+
+      errorsJson_ = sourceMarkersAsJson(errors);
+      enqueBuildErrors(sourceMarkersAsJson(newErrors));
+   }
+
+   void onCompleted(int exitStatus)
+   {
+      using namespace module_context;
+
+      // parse any output which arrived since the last incremental parse
+      // (markers found earlier have already been streamed to the client)
+      streamBuildErrors(true);
+
       if (exitStatus != EXIT_SUCCESS)
       {
          boost::format fmt("\nExited with status %1%.\n\n");
@@ -1674,6 +1931,18 @@ private:
       }
       else
       {
+         // record the website source manifest snapshotted when the
+         // build was launched (enables incremental rebuilds)
+         if (havePendingWebsiteManifest_)
+         {
+            Error error = core::writeStringToFile(
+                              websiteManifestPath(),
+                              pendingWebsiteManifest_.writeFormatted());
+            if (error)
+               LOG_ERROR(error);
+            havePendingWebsiteManifest_ = false;
+         }
+
          if (!successMessage_.empty())
             enqueBuildOutput(kCompileOutputNormal, successMessage_ + "\n");
 
@@ -1832,6 +2101,8 @@ private:
    bool terminationRequested_;
    std::vector<module_context::CompileOutput> output_;
    CompileErrorParser errorParser_;
+   std::size_t reportedErrorCount_;
+   std::size_t lastErrorParseLength_;
    std::string errorsBaseDir_;
    json::Array errorsJson_;
    r_util::RPackageInfo pkgInfo_;
@@ -1845,6 +2116,8 @@ private:
    bool restartR_;
    bool usedDevtools_;
    bool openErrorList_;
+   json::Object pendingWebsiteManifest_;
+   bool havePendingWebsiteManifest_;
    std::string type_;
 };
 
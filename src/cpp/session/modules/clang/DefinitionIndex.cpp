@@ -22,12 +22,14 @@
 #include <core/DateTime.hpp>
 #include <core/PerformanceTimer.hpp>
 #include <core/FileSerializer.hpp>
+#include <core/Thread.hpp>
 #include <core/libclang/LibClang.hpp>
 #include <core/system/ProcessArgs.hpp>
 #include <session/IncrementalFileChangeHandler.hpp>
 
 #include <session/SessionModuleContext.hpp>
 #include <session/projects/SessionProjects.hpp>
+#include <session/jobs/JobsApi.hpp>
 
 #include "RSourceIndex.hpp"
 #include "RCompilationDatabase.hpp"
@@ -172,6 +174,115 @@ CXChildVisitResult cursorVisitor(CXCursor cxCursor,
    }
 }
 
+// once a re-index batch grows beyond this many files we surface its
+// progress in the jobs UI (smaller batches come and go too quickly
+// to be worth reporting)
+const std::size_t kIndexingJobThreshold = 10;
+
+// completed parses are produced on background threads and merged into
+// s_definitionsByFile on the main thread only. the counters below are
+// likewise touched only on the main thread (incremented at dispatch,
+// updated at merge) so the queue is the only cross-thread channel
+core::thread::ThreadsafeQueue<boost::shared_ptr<CppDefinitions> >
+                                                      s_completedParses;
+std::size_t s_pendingParses = 0;
+std::size_t s_batchTotal = 0;
+std::size_t s_batchComplete = 0;
+bool s_mergeScheduled = false;
+
+// job used to surface progress for large indexing batches
+boost::shared_ptr<jobs::Job> s_indexingJob;
+
+// parse a translation unit and collect its definitions. runs on the
+// background thread pool -- libclang is safe to use off the main thread
+// so long as each task works against its own CXIndex
+void parseForDefinitions(boost::shared_ptr<CppDefinitions> pDefinitions,
+                         const std::vector<std::string>& compileArgs,
+                         int verbose)
+{
+   // create index
+   CXIndex index = libclang::clang().createIndex(
+             1 /* Exclude PCH */,
+             (verbose > 0) ? 1 : 0);
+
+   // get args in form clang expects
+   core::system::ProcessArgs argsArray(compileArgs);
+
+   // parse the translation unit
+   CXTranslationUnit tu = libclang::clang().parseTranslationUnit(
+                         index,
+                         pDefinitions->file.c_str(),
+                         argsArray.args(),
+                         gsl::narrow_cast<int>(argsArray.argCount()),
+                         nullptr, 0, // no unsaved files
+                         CXTranslationUnit_None |
+                         CXTranslationUnit_Incomplete);
+
+   if (tu != nullptr)
+   {
+      // wire visitor to the definitions
+      DefinitionVisitor visitor =
+         boost::bind(insertDefinition, _1, pDefinitions.get());
+
+      // visit the cursors
+      libclang::clang().visitChildren(
+           libclang::clang().getTranslationUnitCursor(tu),
+           cursorVisitor,
+           (CXClientData)&visitor);
+
+      // dispose translation unit
+      libclang::clang().disposeTranslationUnit(tu);
+   }
+   else
+   {
+      LOG_ERROR_MESSAGE("Error parsing translation unit " +
+                        pDefinitions->file);
+   }
+
+   // dispose the index and hand the result back to the main thread
+   libclang::clang().disposeIndex(index);
+   s_completedParses.enque(pDefinitions);
+}
+
+// periodic worker (main thread) which merges completed parses into the
+// definition index and retires the batch once nothing remains in flight
+bool mergeCompletedParses()
+{
+   boost::shared_ptr<CppDefinitions> pDefinitions;
+   while (s_completedParses.deque(&pDefinitions))
+   {
+      // ignore the result if a newer parse of the file already landed
+      // (results arrive in completion order, not dispatch order)
+      DefinitionsByFile::const_iterator it =
+                           s_definitionsByFile.find(pDefinitions->file);
+      if (it == s_definitionsByFile.end() ||
+          it->second.fileLastWrite <= pDefinitions->fileLastWrite)
+      {
+         s_definitionsByFile[pDefinitions->file] = *pDefinitions;
+      }
+
+      // update batch accounting and progress (note that setProgress
+      // automatically transitions the job to succeeded when the last
+      // unit of progress is reported)
+      s_pendingParses--;
+      s_batchComplete++;
+      if (s_indexingJob)
+         jobs::setJobProgress(s_indexingJob,
+                              gsl::narrow_cast<int>(s_batchComplete));
+   }
+
+   // keep running if parses are still in flight
+   if (s_pendingParses > 0)
+      return true;
+
+   // batch complete -- reset state for the next one
+   s_indexingJob.reset();
+   s_batchTotal = 0;
+   s_batchComplete = 0;
+   s_mergeScheduled = false;
+   return false;
+}
+
 void fileChangeHandler(const core::system::FileChangeEvent& event)
 {
    // alias the filename
@@ -200,49 +311,54 @@ void fileChangeHandler(const core::system::FileChangeEvent& event)
    if (event.type() == core::system::FileChangeEvent::FileAdded ||
        event.type() == core::system::FileChangeEvent::FileModified)
    {    
-      // get the compilation arguments for this file and use them to
-      // create a translation unit
+      // get the compilation arguments for this file (this can evaluate R
+      // code so must happen here on the main thread, not on a worker)
       std::vector<std::string> compileArgs =
          rCompilationDatabase().compileArgsForTranslationUnit(file, true);
 
       if (!compileArgs.empty())
       {
-         // create index
-         CXIndex index = libclang::clang().createIndex(
-                   1 /* Exclude PCH */,
-                   (rSourceIndex().verbose() > 0) ? 1 : 0);
-
-         // get args in form clang expects
-         core::system::ProcessArgs argsArray(compileArgs);
-
-         // parse the translation unit
-         CXTranslationUnit tu = libclang::clang().parseTranslationUnit(
-                               index,
-                               file.c_str(),
-                               argsArray.args(),
-                               gsl::narrow_cast<int>(argsArray.argCount()),
-                               nullptr, 0, // no unsaved files
-                               CXTranslationUnit_None |
-                               CXTranslationUnit_Incomplete);
-
-
-         // create definitions and wire visitor to it
-         CppDefinitions definitions;
-         definitions.file = file;
-         definitions.fileLastWrite = event.fileInfo().lastWriteTime();
-         s_definitionsByFile[file] = definitions;
-         DefinitionVisitor visitor =
-            boost::bind(insertDefinition, _1, &s_definitionsByFile[file]);
-
-         // visit the cursors
-         libclang::clang().visitChildren(
-              libclang::clang().getTranslationUnitCursor(tu),
-              cursorVisitor,
-              (CXClientData)&visitor);
+         // hand the parse off to the worker pool
+         boost::shared_ptr<CppDefinitions> pDefinitions(new CppDefinitions());
+         pDefinitions->file = file;
+         pDefinitions->fileLastWrite = event.fileInfo().lastWriteTime();
+         s_pendingParses++;
+         s_batchTotal++;
+         core::thread::backgroundThreadPool().enque(
+               boost::bind(parseForDefinitions,
+                           pDefinitions,
+                           compileArgs,
+                           rSourceIndex().verbose()));
+
+         // merge results on the main thread as they become available
+         if (!s_mergeScheduled)
+         {
+            s_mergeScheduled = true;
+            module_context::schedulePeriodicWork(
+                     boost::posix_time::milliseconds(100),
+                     mergeCompletedParses);
+         }
 
-         // dispose translation unit and index
-         libclang::clang().disposeTranslationUnit(tu);
-         libclang::clang().disposeIndex(index);
+         // surface progress in the jobs UI once the batch is large
+         // enough to take a noticeable amount of time
+         if (!s_indexingJob && s_batchTotal > kIndexingJobThreshold)
+         {
+            s_indexingJob = jobs::addJob("Indexing C++ definitions",
+                                         "", "",
+                                         gsl::narrow_cast<int>(s_batchTotal),
+                                         jobs::JobRunning,
+                                         jobs::JobTypeSession,
+                                         true, R_NilValue, true, {});
+            if (s_batchComplete > 0)
+               jobs::setJobProgress(
+                        s_indexingJob,
+                        gsl::narrow_cast<int>(s_batchComplete));
+         }
+         else if (s_indexingJob)
+         {
+            s_indexingJob->setProgressMax(
+                     gsl::narrow_cast<int>(s_batchTotal));
+         }
       }
    }
 }
@@ -456,6 +456,28 @@ void connectionListFields(const json::JsonRpcRequest& request,
    sendResponse(error, sexpResult, continuation, ERROR_LOCATION);
 }
 
+// number of rows shown in an object preview, and the size of the first
+// batch fetched before the viewer opens (the remainder is backfilled
+// once the session is idle)
+const int kConnectionPreviewRows = 1000;
+const int kConnectionPreviewFirstRows = 100;
+
+void backfillPreviewObject(const ConnectionId& connectionId,
+                           const json::Array& objectSpecifier,
+                           const std::string& cacheKey)
+{
+   // fetch the full preview and refresh the open viewer in place
+   r::exec::RFunction backfill(".rs.connectionBackfillPreview",
+                               connectionId.type,
+                               connectionId.host,
+                               kConnectionPreviewRows,
+                               cacheKey);
+   addObjectSpecifiers(objectSpecifier, &backfill);
+   Error error = backfill.call();
+   if (error)
+      LOG_ERROR(error);
+}
+
 void connectionPreviewObject(const json::JsonRpcRequest& request,
                              const json::JsonRpcFunctionContinuation& continuation)
 {
@@ -471,18 +493,38 @@ void connectionPreviewObject(const json::JsonRpcRequest& request,
       return;
    }
 
-   // view the table
+   // view the table: fetch and show a small first batch immediately; if
+   // it filled up the R side returns the viewer's cache key and we
+   // backfill the rest of the preview once the session is idle, so large
+   // remote tables render incrementally instead of stalling on the full
+   // fetch
    r::sexp::Protect rProtect;
    SEXP sexpResult;
    r::exec::RFunction previewObject(".rs.connectionPreviewObject",
                                  connectionId.type,
                                  connectionId.host,
-                                 1000);
+                                 kConnectionPreviewFirstRows);
    addObjectSpecifiers(objectSpecifier, &previewObject);
    error = previewObject.call(&sexpResult, &rProtect);
 
-   // send the response
-   sendResponse(error, sexpResult, continuation, ERROR_LOCATION);
+   if (!error)
+   {
+      std::string cacheKey = r::sexp::safeAsString(sexpResult, "");
+      if (!cacheKey.empty())
+      {
+         module_context::scheduleDelayedWork(
+               boost::posix_time::milliseconds(100),
+               boost::bind(backfillPreviewObject,
+                           connectionId,
+                           objectSpecifier,
+                           cacheKey),
+               true);
+      }
+   }
+
+   // send the response (the cache key is an implementation detail between
+   // us and the R side; the client just sees success)
+   sendResponse(error, R_NilValue, continuation, ERROR_LOCATION);
 }
 
 // track whether connections were enabled at the start of this R session
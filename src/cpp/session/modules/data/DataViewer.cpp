@@ -42,6 +42,7 @@
 #include <r/RRoutines.hpp>
 
 #include <session/SessionModuleContext.hpp>
+#include <session/SessionAsyncRProcess.hpp>
 #include <session/SessionContentUrls.hpp>
 #include <session/SessionSourceDatabase.hpp>
 
@@ -225,6 +226,88 @@ int safeDim(SEXP data, DimType dimType)
    return 0;
 }
 
+// formatted values are cached in chunk-aligned blocks of rows so that
+// scrolling over previously viewed regions of a frame doesn't re-enter R
+const int kSnapshotChunkRows = 512;
+
+// the largest number of chunks retained per frame (bounds snapshot
+// memory; least recently used chunks are evicted beyond this)
+const size_t kMaxSnapshotChunks = 256;
+
+// frames with at least this many rows have their sort/filter transforms
+// computed in a child R process so the console stays responsive
+const int kAsyncTransformRows = 1000000;
+
+// a chunk of display-ready values for one column of a viewed frame; NA
+// cells are marked so they can be rendered distinctly
+struct FormattedChunk
+{
+   FormattedChunk() : lastUse(0) {}
+
+   std::vector<std::string> values;
+   std::vector<bool> isNA;
+   unsigned long lastUse;
+};
+
+// Columnar snapshot of formatted values for a frame in a particular
+// transform (search/filter/order) state. The frame is formatted into
+// chunks on first access and pagination over those chunks is served
+// without re-entering R.
+class FrameSnapshot
+{
+public:
+   FrameSnapshot() : useCounter_(0) {}
+
+   // invalidates the snapshot if the frame's transform state has changed
+   void applySignature(const std::string& signature)
+   {
+      if (signature != signature_)
+      {
+         chunks_.clear();
+         signature_ = signature;
+      }
+   }
+
+   FormattedChunk* findChunk(int column, int chunkIndex)
+   {
+      std::map<ChunkKey, FormattedChunk>::iterator it =
+         chunks_.find(ChunkKey(column, chunkIndex));
+      if (it == chunks_.end())
+         return nullptr;
+      it->second.lastUse = ++useCounter_;
+      return &it->second;
+   }
+
+   FormattedChunk* addChunk(int column, int chunkIndex)
+   {
+      // keep the snapshot bounded; evict the least recently used chunk
+      if (chunks_.size() >= kMaxSnapshotChunks)
+      {
+         std::map<ChunkKey, FormattedChunk>::iterator oldest = chunks_.begin();
+         for (std::map<ChunkKey, FormattedChunk>::iterator it = chunks_.begin();
+              it != chunks_.end();
+              it++)
+         {
+            if (it->second.lastUse < oldest->second.lastUse)
+               oldest = it;
+         }
+         chunks_.erase(oldest);
+      }
+
+      FormattedChunk& chunk = chunks_[ChunkKey(column, chunkIndex)];
+      chunk.lastUse = ++useCounter_;
+      return &chunk;
+   }
+
+private:
+   // column index (-1 for row names) and chunk ordinal
+   typedef std::pair<int, int> ChunkKey;
+
+   std::string signature_;
+   std::map<ChunkKey, FormattedChunk> chunks_;
+   unsigned long useCounter_;
+};
+
 // CachedFrame represents an object that's currently active in a data viewer
 // window.
 struct CachedFrame
@@ -288,6 +371,10 @@ struct CachedFrame
    std::vector<int> workingOrderCols;
    std::vector<std::string> workingOrderDirs;
 
+   // Columnar snapshot of formatted values for the frame (reset when
+   // the frame or its transform state changes)
+   FrameSnapshot snapshot;
+
    // NB: There's no protection on this SEXP and it may be a stale pointer!
    // Used only to test for changes.
    SEXP observedSEXP;
@@ -296,12 +383,162 @@ struct CachedFrame
 // The set of active frames. Used primarily to check each for changes.
 std::map<std::string, CachedFrame> s_cachedFrames;
 
-std::string viewerCacheDir() 
+std::string viewerCacheDir()
 {
    return module_context::sessionScratchPath().completeChildPath(kViewerCacheDir)
       .getAbsolutePath();
 }
 
+// helpers for forming R expressions to pass to a child process
+std::string asRLiteral(const std::string& value)
+{
+   return "'" + string_utils::singleQuotedStrEscape(value) + "'";
+}
+
+std::string asRLiteral(const std::vector<std::string>& values)
+{
+   std::string literal = "c(";
+   for (size_t i = 0; i < values.size(); i++)
+   {
+      if (i > 0)
+         literal += ", ";
+      literal += asRLiteral(values[i]);
+   }
+   return literal + ")";
+}
+
+std::string asRLiteral(const std::vector<int>& values)
+{
+   std::string literal = "c(";
+   for (size_t i = 0; i < values.size(); i++)
+   {
+      if (i > 0)
+         literal += ", ";
+      literal += safe_convert::numberToString(values[i]) + "L";
+   }
+   return literal + ")";
+}
+
+class AsyncTransform;
+
+// sort/filter jobs currently running in child processes, keyed by the cache
+// key of the frame being transformed
+std::map<std::string, boost::shared_ptr<AsyncTransform> > s_pendingTransforms;
+
+// runs a sort/filter transform for a viewed frame in a child R process so
+// that the console stays responsive while large views recompute; the child
+// reads the frame from the viewer cache, computes the selected row indices,
+// and writes them to a file which is applied to the session's working copy
+// when the job completes
+class AsyncTransform : public async_r::AsyncRProcess
+{
+public:
+   static boost::shared_ptr<AsyncTransform> create(
+         const std::string& cacheKey,
+         const std::string& signature,
+         const std::string& search,
+         const std::vector<std::string>& filters,
+         const std::vector<int>& ordercols,
+         const std::vector<std::string>& orderdirs)
+   {
+      boost::shared_ptr<AsyncTransform> pTransform(new AsyncTransform());
+      pTransform->cacheKey_ = cacheKey;
+      pTransform->signature_ = signature;
+      pTransform->search_ = search;
+      pTransform->filters_ = filters;
+      pTransform->ordercols_ = ordercols;
+      pTransform->orderdirs_ = orderdirs;
+      pTransform->indicesFile_ = module_context::tempFile("transform", "rds");
+
+      // load the files which contain the R scripts needed to transform data
+      std::vector<core::FilePath> sources;
+
+      FilePath modulesPath = session::options().modulesRSourcePath();
+      FilePath sourcesPath = session::options().coreRSourcePath();
+
+      sources.push_back(sourcesPath.completePath("Tools.R"));
+      sources.push_back(modulesPath.completePath("ModuleTools.R"));
+      sources.push_back(modulesPath.completePath("SessionDataViewer.R"));
+
+      // form command to pass to R
+      std::string cmd(".rs.executeTransformJob(" +
+                      asRLiteral(cacheKey) + ", " +
+                      asRLiteral(viewerCacheDir()) + ", " +
+                      asRLiteral(string_utils::utf8ToSystem(
+                         pTransform->indicesFile_.getAbsolutePath())) + ", " +
+                      asRLiteral(filters) + ", " +
+                      asRLiteral(search) + ", " +
+                      asRLiteral(ordercols) + ", " +
+                      asRLiteral(orderdirs) + ")");
+
+      // invoke the asynchronous process
+      pTransform->start(cmd.c_str(), FilePath(), async_r::R_PROCESS_VANILLA,
+                        sources);
+      return pTransform;
+   }
+
+   const std::string& signature() const
+   {
+      return signature_;
+   }
+
+private:
+   void onCompleted(int exitStatus)
+   {
+      // apply the computed indices to the session's copy of the frame
+      if (exitStatus == EXIT_SUCCESS && indicesFile_.exists())
+      {
+         Error error = r::exec::RFunction(".rs.completeTransformJob",
+               cacheKey_, viewerCacheDir(),
+               string_utils::utf8ToSystem(indicesFile_.getAbsolutePath()))
+            .call();
+         if (error)
+         {
+            LOG_ERROR(error);
+         }
+         else
+         {
+            // record the transform state now reflected by the working copy
+            std::map<std::string, CachedFrame>::iterator it =
+               s_cachedFrames.find(cacheKey_);
+            if (it != s_cachedFrames.end())
+            {
+               it->second.workingSearch = search_;
+               it->second.workingFilters = filters_;
+               it->second.workingOrderCols = ordercols_;
+               it->second.workingOrderDirs = orderdirs_;
+            }
+
+            // tell the client the view is ready; it responds by requesting
+            // the grid data again, which is then served from the working copy
+            json::Object changed;
+            changed["cache_key"] = cacheKey_;
+            changed["structure_changed"] = false;
+            ClientEvent event(client_events::kDataViewChanged, changed);
+            module_context::enqueClientEvent(event);
+         }
+      }
+
+      Error error = indicesFile_.removeIfExists();
+      if (error)
+         LOG_ERROR(error);
+
+      // deregister, unless a newer job for the frame has replaced this one
+      std::map<std::string, boost::shared_ptr<AsyncTransform> >::iterator it =
+         s_pendingTransforms.find(cacheKey_);
+      if (it != s_pendingTransforms.end() && it->second.get() == this)
+         s_pendingTransforms.erase(it);
+   }
+
+   std::string cacheKey_;
+   std::string signature_;
+   std::string search_;
+   std::vector<std::string> filters_;
+   std::vector<int> ordercols_;
+   std::vector<std::string> orderdirs_;
+   core::FilePath indicesFile_;
+};
+
 SEXP findInNamedEnvir(const std::string& envir, const std::string& name)
 {
    SEXP env = nullptr;
@@ -424,11 +661,29 @@ SEXP rs_viewData(SEXP dataSEXP, SEXP exprSEXP, SEXP captionSEXP, SEXP nameSEXP,
       r::exec::error(e.message());
    }
    CATCH_UNEXPECTED_EXCEPTION
-   
+
    // keep compiler happy
    return R_NilValue;
 }
-  
+
+SEXP rs_dataViewUpdated(SEXP cacheKeySEXP, SEXP structureChangedSEXP)
+{
+   try
+   {
+      // the cached data backing an open viewer was replaced (e.g. a
+      // connection preview backfill); tell the client to re-request the
+      // grid data
+      json::Object changed;
+      changed["cache_key"] = r::sexp::safeAsString(cacheKeySEXP);
+      changed["structure_changed"] = r::sexp::asLogical(structureChangedSEXP);
+      ClientEvent event(client_events::kDataViewChanged, changed);
+      module_context::enqueClientEvent(event);
+   }
+   CATCH_UNEXPECTED_EXCEPTION
+
+   return R_NilValue;
+}
+
 void handleGridResReq(const http::Request& request,
                             http::Response* pResponse)
 {
@@ -464,9 +719,147 @@ json::Value getCols(SEXP dataSEXP)
    return result;
 }
 
+// computes a signature for a frame's transform state; snapshot chunks
+// are only valid for the transform state they were formatted under
+std::string transformSignature(const std::string& search,
+                               const std::vector<std::string>& filters,
+                               const std::vector<int>& ordercols,
+                               const std::vector<std::string>& orderdirs)
+{
+   std::ostringstream ostr;
+   ostr << search;
+   for (const std::string& filter : filters)
+      ostr << '\n' << filter;
+   ostr << '\f';
+   for (size_t i = 0; i < ordercols.size(); i++)
+      ostr << '\n' << ordercols[i] << ' '
+           << (i < orderdirs.size() ? orderdirs[i] : std::string());
+   return ostr.str();
+}
+
+// formats one chunk of the given column (-1 for row names) into pChunk.
+//
+// NB: may throw exceptions! (see getData)
+void fillFormattedChunk(SEXP dataSEXP,
+                        int column,
+                        int chunkIndex,
+                        int totalRows,
+                        FormattedChunk* pChunk)
+{
+   r::sexp::Protect protect;
+
+   int chunkStart = chunkIndex * kSnapshotChunkRows;
+   int rows = std::min(kSnapshotChunkRows, totalRows - chunkStart);
+   if (rows < 0)
+      rows = 0;
+
+   SEXP formattedSEXP = nullptr;
+   if (column < 0)
+   {
+      // row names (errors here aren't fatal; row numbers are displayed
+      // for missing names)
+      r::exec::RFunction(".rs.formatRowNames", dataSEXP, chunkStart + 1, rows)
+         .call(&formattedSEXP, &protect);
+   }
+   else
+   {
+      SEXP columnSEXP = VECTOR_ELT(dataSEXP, column);
+      if (columnSEXP == nullptr || TYPEOF(columnSEXP) == NILSXP ||
+          Rf_isNull(columnSEXP))
+      {
+         throw r::exec::RErrorException("No data in column " +
+               boost::lexical_cast<std::string>(column));
+      }
+      r::exec::RFunction formatFx(".rs.formatDataColumn");
+      formatFx.addParam(columnSEXP);
+      formatFx.addParam(gsl::narrow_cast<int>(chunkStart + 1));
+      formatFx.addParam(gsl::narrow_cast<int>(rows));
+      Error error = formatFx.call(&formattedSEXP, &protect);
+      if (error)
+         throw r::exec::RErrorException(error.getSummary());
+   }
+
+   pChunk->values.assign(rows, std::string());
+   pChunk->isNA.assign(rows, false);
+
+   if (formattedSEXP != nullptr && TYPEOF(formattedSEXP) == STRSXP &&
+       !Rf_isNull(formattedSEXP))
+   {
+      int n = std::min(rows, Rf_length(formattedSEXP));
+      for (int i = 0; i < n; i++)
+      {
+         SEXP stringSEXP = STRING_ELT(formattedSEXP, i);
+         if (stringSEXP == NA_STRING)
+            pChunk->isNA[i] = true;
+         else if (stringSEXP != nullptr && r::sexp::length(stringSEXP) > 0)
+            pChunk->values[i] = Rf_translateCharUTF8(stringSEXP);
+      }
+   }
+   else if (column < 0)
+   {
+      // no row names; display row numbers instead
+      pChunk->isNA.assign(rows, true);
+   }
+}
+
+// returns formatted cells for rows [startRow, startRow + length) of the
+// given column (0-based startRow; column -1 for row names), serving
+// from the frame's snapshot where possible.
+//
+// NB: may throw exceptions! (see getData)
+void getFormattedColumn(SEXP dataSEXP,
+                        FrameSnapshot* pSnapshot,
+                        int column,
+                        int startRow,
+                        int length,
+                        int totalRows,
+                        std::vector<std::string>* pValues,
+                        std::vector<bool>* pIsNA)
+{
+   if (length <= 0)
+      return;
+
+   int firstChunk = startRow / kSnapshotChunkRows;
+   int lastChunk = (startRow + length - 1) / kSnapshotChunkRows;
+   for (int chunkIndex = firstChunk; chunkIndex <= lastChunk; chunkIndex++)
+   {
+      FormattedChunk localChunk;
+      FormattedChunk* pChunk = nullptr;
+      if (pSnapshot != nullptr)
+         pChunk = pSnapshot->findChunk(column, chunkIndex);
+      if (pChunk == nullptr)
+      {
+         // format into a local chunk first so a failure doesn't leave
+         // an empty chunk in the snapshot
+         fillFormattedChunk(dataSEXP, column, chunkIndex, totalRows,
+                            &localChunk);
+         if (pSnapshot != nullptr)
+         {
+            pChunk = pSnapshot->addChunk(column, chunkIndex);
+            *pChunk = localChunk;
+         }
+         else
+         {
+            pChunk = &localChunk;
+         }
+      }
+
+      // copy the rows within this chunk which fall inside the window
+      int chunkStart = chunkIndex * kSnapshotChunkRows;
+      int from = std::max(startRow, chunkStart);
+      int to = std::min(startRow + length,
+                        chunkStart + gsl::narrow_cast<int>(pChunk->values.size()));
+      for (int row = from; row < to; row++)
+      {
+         pValues->push_back(pChunk->values[row - chunkStart]);
+         pIsNA->push_back(pChunk->isNA[row - chunkStart]);
+      }
+   }
+}
+
 // given an object from which to return data, and a description of the data to
 // return via URL-encoded parameters supplied by the DataTables API, returns the
-// data requested by the parameters. 
+// data requested by the parameters.
 //
 // the shape of the API is described here:
 // http://datatables.net/manual/server-side
@@ -548,8 +941,13 @@ json::Value getData(SEXP dataSEXP, const http::Fields& fields)
    bool needsTransform = ordercols.size() > 0 || hasFilter || !search.empty();
    bool hasTransform = false;
 
+   // hold on to the untransformed frame; it's both the fallback view while
+   // an asynchronous transform is in flight and the copy persisted to the
+   // viewer cache for child processes
+   SEXP originalDataSEXP = dataSEXP;
+
    // check to see if we have an ordered/filtered view we can build from
-   std::map<std::string, CachedFrame>::iterator cachedFrame = 
+   std::map<std::string, CachedFrame>::iterator cachedFrame =
       s_cachedFrames.find(cacheKey);
    if (needsTransform)
    {
@@ -584,8 +982,58 @@ json::Value getData(SEXP dataSEXP, const http::Fields& fields)
       }
    }
 
-   // apply transformations if needed.    
-   if (needsTransform) 
+   // for very large frames, compute the transform in a child R process
+   // rather than blocking the session (and with it the console); until the
+   // job delivers, serve the untransformed frame
+   bool transformPending = false;
+   if (needsTransform && nrow >= kAsyncTransformRows &&
+       cachedFrame != s_cachedFrames.end())
+   {
+      std::string signature = transformSignature(search, filters, ordercols,
+                                                 orderdirs);
+      std::map<std::string, boost::shared_ptr<AsyncTransform> >::iterator
+         pending = s_pendingTransforms.find(cacheKey);
+      if (pending != s_pendingTransforms.end() &&
+          pending->second->signature() == signature)
+      {
+         // the requested transform is already being computed
+         transformPending = true;
+      }
+      else
+      {
+         // ensure the frame is on disk where the child process can read it
+         r::exec::RFunction ensureCached(".rs.ensureCachedData");
+         ensureCached.addParam(originalDataSEXP);
+         ensureCached.addParam(cacheKey);
+         ensureCached.addParam(viewerCacheDir());
+         Error error = ensureCached.call();
+         if (error)
+         {
+            // fall back to the synchronous path
+            LOG_ERROR(error);
+         }
+         else
+         {
+            // discard any job computing a now-stale transform and launch one
+            // for the requested state
+            if (pending != s_pendingTransforms.end())
+               pending->second->terminate();
+            s_pendingTransforms[cacheKey] = AsyncTransform::create(
+               cacheKey, signature, search, filters, ordercols, orderdirs);
+            transformPending = true;
+         }
+      }
+
+      if (transformPending)
+      {
+         dataSEXP = originalDataSEXP;
+         needsTransform = false;
+         hasTransform = false;
+      }
+   }
+
+   // apply transformations if needed.
+   if (needsTransform)
    {
       // can we use a working copy? 
       r::exec::RFunction transform(".rs.applyTransform");
@@ -620,99 +1068,69 @@ json::Value getData(SEXP dataSEXP, const http::Fields& fields)
 
    // apply new row count if we've transformed the data (or need to)
    filteredNRow = needsTransform || hasTransform ?
-      safeDim(dataSEXP, DIM_ROWS) : 
+      safeDim(dataSEXP, DIM_ROWS) :
       nrow;
 
    // return the lesser of the rows available and rows requested
    length = std::min(length, filteredNRow - start);
-
-   // DataTables uses 0-based indexing, but R uses 1-based indexing
-   start++;
+   if (length < 0)
+      length = 0;
 
    // extract the portion of the column vector requested by the client
    int numFormattedColumns = ncol - columnOffset < maxColumns ? ncol - columnOffset : maxColumns;
-   SEXP formattedDataSEXP = Rf_allocVector(VECSXP, numFormattedColumns);
-   protect.add(formattedDataSEXP);
-
    int initialIndex = 0 + columnOffset;
+
+   // associate this request with the frame's columnar snapshot; chunks
+   // formatted for previous requests in the same transform state are
+   // reused without re-entering R
+   FrameSnapshot* pSnapshot = nullptr;
+   if (cachedFrame != s_cachedFrames.end() && !transformPending)
+   {
+      cachedFrame->second.snapshot.applySignature(
+         transformSignature(search, filters, ordercols, orderdirs));
+      pSnapshot = &cachedFrame->second.snapshot;
+   }
+
+   // gather formatted cells for the requested window (row names first)
+   std::vector<std::string> rowNames;
+   std::vector<bool> rowNameMissing;
+   getFormattedColumn(dataSEXP, pSnapshot, -1, start, length, filteredNRow,
+                      &rowNames, &rowNameMissing);
+
+   std::vector<std::vector<std::string> > columnValues(numFormattedColumns);
+   std::vector<std::vector<bool> > columnNAs(numFormattedColumns);
    for (int i = initialIndex; i < initialIndex + numFormattedColumns; i++)
    {
-      SEXP columnSEXP = VECTOR_ELT(dataSEXP, i);
-      if (columnSEXP == nullptr || TYPEOF(columnSEXP) == NILSXP ||
-          Rf_isNull(columnSEXP))
-      {
-         throw r::exec::RErrorException("No data in column " +
-               boost::lexical_cast<std::string>(i));
-      }
-      SEXP formattedColumnSEXP;
-      r::exec::RFunction formatFx(".rs.formatDataColumn");
-      formatFx.addParam(columnSEXP);
-      formatFx.addParam(gsl::narrow_cast<int>(start));
-      formatFx.addParam(gsl::narrow_cast<int>(length));
-      error = formatFx.call(&formattedColumnSEXP, &protect);
-      if (error)
-         throw r::exec::RErrorException(error.getSummary());
-      SET_VECTOR_ELT(formattedDataSEXP, i - initialIndex, formattedColumnSEXP);
+      getFormattedColumn(dataSEXP, pSnapshot, i, start, length, filteredNRow,
+                         &columnValues[i - initialIndex],
+                         &columnNAs[i - initialIndex]);
    }
 
-   // format the row names
-   SEXP rownamesSEXP;
-   r::exec::RFunction(".rs.formatRowNames", dataSEXP, start, length)
-      .call(&rownamesSEXP, &protect);
-   
    // create the result grid as JSON
    json::Array data;
    for (int row = 0; row < length; row++)
    {
       json::Array rowData;
-      if (rownamesSEXP != nullptr &&
-          TYPEOF(rownamesSEXP) != NILSXP &&
-          !Rf_isNull(rownamesSEXP) )
+      if (row < gsl::narrow_cast<int>(rowNames.size()) &&
+          !rowNameMissing[row] &&
+          !rowNames[row].empty())
       {
-         SEXP nameSEXP = STRING_ELT(rownamesSEXP, row);
-         if (nameSEXP != nullptr &&
-             nameSEXP != NA_STRING &&
-             r::sexp::length(nameSEXP) > 0)
-         {
-            rowData.push_back(Rf_translateCharUTF8(nameSEXP));
-         }
-         else
-         {
-            rowData.push_back(row + start);
-         }
+         rowData.push_back(rowNames[row]);
       }
       else
       {
-         rowData.push_back(row + start);
+         // DataTables uses 0-based indexing, but R uses 1-based indexing
+         rowData.push_back(row + start + 1);
       }
 
-      for (int col = 0; col<Rf_length(formattedDataSEXP); col++)
+      for (int col = 0; col < numFormattedColumns; col++)
       {
-         SEXP columnSEXP = VECTOR_ELT(formattedDataSEXP, col);
-         if (columnSEXP != nullptr &&
-             TYPEOF(columnSEXP) == STRSXP &&
-             !Rf_isNull(columnSEXP))
-         {
-            SEXP stringSEXP = STRING_ELT(columnSEXP, row);
-            if (stringSEXP != nullptr &&
-                stringSEXP != NA_STRING &&
-                r::sexp::length(stringSEXP) > 0)
-            {
-               rowData.push_back(Rf_translateCharUTF8(stringSEXP));
-            }
-            else if (stringSEXP == NA_STRING)
-            {
-               rowData.push_back(SPECIAL_CELL_NA);
-            }
-            else
-            {
-               rowData.push_back("");
-            }
-         }
-         else
-         {
+         if (row >= gsl::narrow_cast<int>(columnValues[col].size()))
             rowData.push_back("");
-         }
+         else if (columnNAs[col][row])
+            rowData.push_back(SPECIAL_CELL_NA);
+         else
+            rowData.push_back(columnValues[col][row]);
       }
       data.push_back(rowData);
    }
@@ -838,11 +1256,20 @@ Error getGridData(const http::Request& request,
 Error removeCacheKey(const std::string& cacheKey)
 {
    // remove from watchlist
-   std::map<std::string, CachedFrame>::iterator pos = 
+   std::map<std::string, CachedFrame>::iterator pos =
       s_cachedFrames.find(cacheKey);
    if (pos != s_cachedFrames.end())
       s_cachedFrames.erase(pos);
-   
+
+   // abandon any in-flight transform job for the frame
+   std::map<std::string, boost::shared_ptr<AsyncTransform> >::iterator pending =
+      s_pendingTransforms.find(cacheKey);
+   if (pending != s_pendingTransforms.end())
+   {
+      pending->second->terminate();
+      s_pendingTransforms.erase(pending);
+   }
+
    // remove cache env object and backing file
    return r::exec::RFunction(".rs.removeCachedData", cacheKey, 
          viewerCacheDir()).call();
@@ -1035,6 +1462,7 @@ Error initialize()
 
    // register viewData method
    RS_REGISTER_CALL_METHOD(rs_viewData);
+   RS_REGISTER_CALL_METHOD(rs_dataViewUpdated);
 
    source_database::events().onDocPendingRemove.connect(onDocPendingRemove);
 
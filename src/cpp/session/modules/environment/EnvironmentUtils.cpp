@@ -162,7 +162,7 @@ json::Value languageVarToJson(SEXP env, std::string objectName)
    }
 }
 
-json::Value varToJson(SEXP env, const r::sexp::Variable& var)
+json::Value varToJson(SEXP env, const r::sexp::Variable& var, bool exactSize)
 {
    json::Object varJson;
    SEXP varSEXP = var.second;
@@ -217,7 +217,7 @@ json::Value varToJson(SEXP env, const r::sexp::Variable& var)
       json::Value val;
       r::sexp::Protect protect;
       Error error = r::exec::RFunction(".rs.describeObject",
-                  env, var.first, !hasAltrep(varSEXP))
+                  env, var.first, !hasAltrep(varSEXP), exactSize)
                   .call(&description, &protect);
       if (error)
          LOG_ERROR(error);
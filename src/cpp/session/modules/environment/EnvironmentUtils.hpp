@@ -24,7 +24,9 @@ namespace session {
 namespace modules {
 namespace environment {
 
-core::json::Value varToJson(SEXP env, const r::sexp::Variable& var);
+core::json::Value varToJson(SEXP env,
+                            const r::sexp::Variable& var,
+                            bool exactSize = false);
 bool isUnevaluatedPromise(SEXP var);
 bool functionDiffersFromSource(SEXP srcRef, const std::string& functionCode);
 void sourceRefToJson(const SEXP srcref, core::json::Object* pObject);
@@ -392,6 +392,157 @@ json::Array callFramesAsJson(LineDebugState* pLineDebugState)
    return listFrames;
 }
 
+// Caches the JSON descriptions produced by the most recent environment
+// listing. Describing an object requires a call back into R
+// (.rs.describeObject) for every binding, which can add hundreds of
+// milliseconds per listing for workspaces with many or complex objects.
+// Since most bindings don't change between listings, each listing reuses
+// the description computed last time unless the binding now refers to a
+// different object -- the same pointer identity test the environment
+// monitor uses to detect changes between top-level commands.
+class EnvironmentDescriptionCache
+{
+public:
+   EnvironmentDescriptionCache(): env_(nullptr) {}
+
+   json::Value descriptionFor(SEXP env, const r::sexp::Variable& var,
+                              bool exactSize)
+   {
+      // discard the cache wholesale when the monitored environment changes
+      if (env != env_)
+      {
+         cache_.clear();
+         env_ = env;
+      }
+
+      // reuse the cached description if the binding still refers to the
+      // same object. promises are always re-described, since evaluating a
+      // promise changes its value in place without rebinding it. exact
+      // size requests always re-describe (the cached description may
+      // hold an estimated size).
+      std::map<std::string, Entry>::iterator it = cache_.find(var.first);
+      if (!exactSize &&
+          it != cache_.end() &&
+          it->second.object == var.second &&
+          TYPEOF(var.second) != PROMSXP)
+      {
+         it->second.used = true;
+         return it->second.description;
+      }
+
+      Entry entry;
+      entry.object = var.second;
+      entry.description = varToJson(env, var, exactSize);
+      entry.used = true;
+      cache_[var.first] = entry;
+      return entry.description;
+   }
+
+   // drops entries for bindings which no longer exist; called after each
+   // full listing (entries the listing didn't touch are stale)
+   void prune()
+   {
+      std::map<std::string, Entry>::iterator it = cache_.begin();
+      while (it != cache_.end())
+      {
+         if (it->second.used)
+         {
+            it->second.used = false;
+            ++it;
+         }
+         else
+         {
+            cache_.erase(it++);
+         }
+      }
+   }
+
+private:
+   struct Entry
+   {
+      Entry(): object(nullptr), used(false) {}
+
+      // NB: used only as an identity to detect rebinding; never
+      // dereferenced (like the environment monitor's last-seen list, it
+      // may be a stale pointer)
+      SEXP object;
+
+      json::Value description;
+      bool used;
+   };
+
+   SEXP env_;
+   std::map<std::string, Entry> cache_;
+};
+
+EnvironmentDescriptionCache s_descriptionCache;
+
+// objects whose sizes were estimated during the most recent listing
+// (computing the exact size of a long list can take seconds, so listings
+// report a cheap extrapolated estimate and the exact size is computed
+// here at idle time and pushed to the client as an assignment event)
+std::vector<std::string> s_pendingSizeRefinements;
+bool s_sizeRefinementScheduled = false;
+
+bool refineObjectSizes()
+{
+   if (s_pendingSizeRefinements.empty() ||
+       !s_pEnvironmentMonitor->hasEnvironment())
+   {
+      s_pendingSizeRefinements.clear();
+      s_sizeRefinementScheduled = false;
+      return false;
+   }
+
+   // refine one object per unit of work so we never occupy the
+   // interpreter for more than a single size computation at a time
+   std::string name = s_pendingSizeRefinements.back();
+   s_pendingSizeRefinements.pop_back();
+
+   SEXP env = s_pEnvironmentMonitor->getMonitoredEnvironment();
+   SEXP varSEXP = r::sexp::findVar(name, env);
+   if (varSEXP != R_UnboundValue && !isUnevaluatedPromise(varSEXP))
+   {
+      r::sexp::Variable var(name, varSEXP);
+      json::Value desc = s_descriptionCache.descriptionFor(env, var, true);
+      ClientEvent event(client_events::kEnvironmentAssigned, desc);
+      module_context::enqueClientEvent(event);
+   }
+
+   if (s_pendingSizeRefinements.empty())
+   {
+      s_sizeRefinementScheduled = false;
+      return false;
+   }
+   return true;
+}
+
+void scheduleSizeRefinements(const json::Array& listJson)
+{
+   s_pendingSizeRefinements.clear();
+   for (const json::Value& itemJson : listJson)
+   {
+      if (!itemJson.isObject())
+         continue;
+      std::string name;
+      bool estimated = false;
+      Error error = json::readObject(itemJson.getObject(),
+                                     "name", name,
+                                     "size_estimated", estimated);
+      if (!error && estimated)
+         s_pendingSizeRefinements.push_back(name);
+   }
+
+   if (!s_pendingSizeRefinements.empty() && !s_sizeRefinementScheduled)
+   {
+      s_sizeRefinementScheduled = true;
+      module_context::scheduleIncrementalWork(
+               boost::posix_time::milliseconds(25),
+               refineObjectSizes,
+               true);
+   }
+}
+
 json::Array environmentListAsJson()
 {
     using namespace rstudio::r::sexp;
@@ -408,11 +559,18 @@ json::Array environmentListAsJson()
                        &rProtect,
                        &vars);
 
-       // get object details and transform to json
+       // get object details and transform to json (unchanged bindings are
+       // served from the description cache without re-entering R)
        std::transform(vars.begin(),
                       vars.end(),
                       std::back_inserter(listJson),
-                      boost::bind(varToJson, env, _1));
+                      boost::bind(&EnvironmentDescriptionCache::descriptionFor,
+                                  &s_descriptionCache, env, _1, false));
+       s_descriptionCache.prune();
+
+       // lazily compute exact sizes for any objects whose sizes were
+       // estimated above
+       scheduleSizeRefinements(listJson);
     }
 
     return listJson;
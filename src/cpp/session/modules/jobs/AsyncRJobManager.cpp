@@ -15,7 +15,12 @@
 
 #include "AsyncRJobManager.hpp"
 
+#include <deque>
+
+#include <boost/thread.hpp>
+
 #include <r/RExec.hpp>
+#include <r/ROptions.hpp>
 
 #include <session/jobs/JobsApi.hpp>
 
@@ -23,13 +28,66 @@ using namespace rstudio::core;
 
 namespace rstudio {
 namespace session {
-namespace modules { 
+namespace modules {
 namespace jobs {
 namespace {
 
 // Vector of currently active async R jobs
 std::vector<boost::shared_ptr<AsyncRJob> > s_jobs;
 
+// Jobs waiting for a slot, in the order they were submitted
+std::deque<boost::shared_ptr<AsyncRJob> > s_pendingJobs;
+
+// The number of scheduled jobs currently holding a slot
+std::size_t s_runningJobs = 0;
+
+// Guards against re-entrant scheduling (a job completing synchronously
+// during scheduling triggers another scheduling pass)
+bool s_schedulingJobs = false;
+
+// The maximum number of background jobs to run simultaneously; defaults to
+// all but one core (leaving headroom for the interactive session) and can be
+// tuned with the rstudio.maxRunningJobs option
+std::size_t maxRunningJobs()
+{
+   int maxJobs = r::options::getOption<int>("rstudio.maxRunningJobs", 0, false);
+   if (maxJobs > 0)
+      return maxJobs;
+
+   unsigned int cores = boost::thread::hardware_concurrency();
+   return cores > 1 ? cores - 1 : 1;
+}
+
+// Start pending jobs until the available slots are consumed
+void scheduleJobs()
+{
+   if (s_schedulingJobs)
+      return;
+   s_schedulingJobs = true;
+
+   while (!s_pendingJobs.empty() && s_runningJobs < maxRunningJobs())
+   {
+      boost::shared_ptr<AsyncRJob> job = s_pendingJobs.front();
+      s_pendingJobs.pop_front();
+
+      // account for the job now; its completion handler releases the slot
+      s_runningJobs++;
+
+      if (job->cancelled())
+      {
+         // cancelled while waiting in the queue; the underlying process was
+         // never started so just run the completion path directly
+         job->onCompleted(EXIT_FAILURE);
+      }
+      else
+      {
+         job->start();
+      }
+   }
+
+   s_schedulingJobs = false;
+}
+
 } // anonymous namespace
 
 
@@ -109,6 +167,17 @@ void AsyncRJob::cancel()
    }
 }
 
+bool AsyncRJob::cancelled() const
+{
+   return cancelled_;
+}
+
+void AsyncRJob::setQueued()
+{
+   if (job_)
+      setJobStatus(job_, "Waiting for other jobs to finish");
+}
+
 void AsyncRJob::addOnComplete(boost::function<void()> onComplete)
 {
    onComplete_.push_back(onComplete);
@@ -136,6 +205,31 @@ Error registerAsyncRJob(boost::shared_ptr<AsyncRJob> job,
    return Success();
 }
 
+Error startAsyncRJob(boost::shared_ptr<AsyncRJob> job,
+      std::string *pId)
+{
+   Error error = registerAsyncRJob(job, pId);
+   if (error)
+      return error;
+
+   // release the job's slot when it completes and start anything waiting
+   job->addOnComplete([]()
+   {
+      if (s_runningJobs > 0)
+         s_runningJobs--;
+      scheduleJobs();
+   });
+
+   // queue the job; if it can't run immediately then let the user know why
+   s_pendingJobs.push_back(job);
+   if (s_runningJobs >= maxRunningJobs())
+      job->setQueued();
+
+   scheduleJobs();
+
+   return Success();
+}
+
 core::Error stopAsyncRJob(const std::string& id)
 {
    for (auto job: s_jobs)
@@ -143,6 +237,19 @@ core::Error stopAsyncRJob(const std::string& id)
       if (job->id() == id)
       {
          job->cancel();
+
+         // if the job was still waiting in the queue then there's no process
+         // to wind down; run its completion path now
+         auto it = std::find(s_pendingJobs.begin(), s_pendingJobs.end(), job);
+         if (it != s_pendingJobs.end())
+         {
+            s_pendingJobs.erase(it);
+
+            // balance the slot release performed by the completion handler
+            s_runningJobs++;
+            job->onCompleted(EXIT_FAILURE);
+         }
+
          return Success();
       }
    }
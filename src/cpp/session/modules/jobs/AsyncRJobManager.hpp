@@ -41,12 +41,22 @@ class AsyncRJob : public async_r::AsyncRProcess
 public:
    AsyncRJob(const std::string& name);
 
+   // Start the underlying R process; invoked by the scheduler when a
+   // slot is available (see startAsyncRJob)
+   virtual void start() = 0;
+
    // The ID of the underlying job; only valid after registration
    std::string id();
 
    // Cancel the job (abort the R session)
    void cancel();
 
+   // Whether the user has cancelled the job
+   bool cancelled() const;
+
+   // Update the job's status to indicate that it's waiting its turn
+   void setQueued();
+
    // Register the job (create the underlying job)
    void registerJob();
 
@@ -77,6 +87,14 @@ protected:
 core::Error registerAsyncRJob(boost::shared_ptr<AsyncRJob> job,
       std::string *pId);
 
+// Registers an asynchronous R job and schedules it for execution: the job is
+// started immediately if a slot is available, and otherwise queued (FIFO)
+// behind currently running jobs so that a batch of background jobs doesn't
+// swamp the machine. The number of slots defaults to all but one core and can
+// be tuned with the rstudio.maxRunningJobs R option.
+core::Error startAsyncRJob(boost::shared_ptr<AsyncRJob> job,
+      std::string *pId);
+
 // Stops an asynchronous R job
 core::Error stopAsyncRJob(const std::string& id);
  
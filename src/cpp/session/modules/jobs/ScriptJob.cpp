@@ -52,12 +52,9 @@ Error startScriptJobInternal(const ScriptLaunchSpec& spec,
       pJob->addOnComplete(*onComplete);
    }
 
-   Error error = registerAsyncRJob(pJob, pId);
-   if (error)
-      return error;
-
-   pJob->start();
-   return Success();
+   // register the job with the scheduler; it will start immediately if a
+   // slot is available and otherwise wait for running jobs to finish
+   return startAsyncRJob(pJob, pId);
 }
 
 
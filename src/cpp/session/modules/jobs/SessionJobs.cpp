@@ -13,6 +13,7 @@
  *
  */
 
+#include <algorithm>
 #include <string>
 
 #include <shared_core/Error.hpp>
@@ -21,6 +22,7 @@
 
 #include <r/RSexp.hpp>
 #include <r/RExec.hpp>
+#include <r/RProgress.hpp>
 #include <r/RRoutines.hpp>
 
 #include <session/SessionModuleContext.hpp>
@@ -127,6 +129,69 @@ SEXP rs_setJobProgress(SEXP jobSEXP, SEXP unitsSEXP)
    return R_NilValue;
 }
 
+// maps lock-free progress channels (see r::exec::reportProgress) to
+// job ids; accessed on the main thread only
+std::map<int, std::string> s_progressChannels;
+
+SEXP rs_connectProgressChannel(SEXP jobSEXP)
+{
+   boost::shared_ptr<Job> pJob;
+   if (!lookupJob(jobSEXP, &pJob))
+      return R_NilValue;
+
+   if (pJob->max() == 0)
+   {
+      r::exec::error("Cannot connect a progress channel for this job because it does not "
+                     "have a progress maximum defined.");
+      return R_NilValue;
+   }
+
+   int channel = r::exec::allocateProgressChannel();
+   s_progressChannels[channel] = pJob->id();
+
+   r::sexp::Protect protect;
+   return r::sexp::create(channel, &protect);
+}
+
+void onBackgroundProcessing(bool isIdle)
+{
+   if (s_progressChannels.empty())
+      return;
+
+   // drain pending records; this coalesces to the most recent record
+   // per channel, so a worker reporting at high frequency results in
+   // (at most) one client update per channel per pass
+   std::map<int, r::exec::ProgressUpdate> updates;
+   r::exec::drainProgress(&updates);
+
+   for (const std::pair<const int, r::exec::ProgressUpdate>& update : updates)
+   {
+      std::map<int, std::string>::iterator it =
+            s_progressChannels.find(update.first);
+      if (it == s_progressChannels.end())
+         continue;
+
+      boost::shared_ptr<Job> pJob;
+      if (!lookupJob(it->second, &pJob))
+      {
+         // the job is gone; drop its channel
+         s_progressChannels.erase(it);
+         continue;
+      }
+
+      // scale the report to the job's progress units; progress is
+      // monotonic so stale or duplicate records are simply skipped
+      const r::exec::ProgressUpdate& progress = update.second;
+      if (progress.max <= 0 || pJob->max() == 0)
+         continue;
+      int units = static_cast<int>(
+            (progress.units / progress.max) * pJob->max());
+      units = std::min(units, pJob->max());
+      if (units > pJob->progress())
+         setJobProgress(pJob, units);
+   }
+}
+
 SEXP rs_addJobProgress(SEXP jobSEXP, SEXP unitsSEXP)
 {
    boost::shared_ptr<Job> pJob;
@@ -455,6 +520,7 @@ core::Error initialize()
    RS_REGISTER_CALL_METHOD(rs_removeJob);
    RS_REGISTER_CALL_METHOD(rs_isJobRunning);
    RS_REGISTER_CALL_METHOD(rs_setJobProgress);
+   RS_REGISTER_CALL_METHOD(rs_connectProgressChannel);
    RS_REGISTER_CALL_METHOD(rs_addJobProgress);
    RS_REGISTER_CALL_METHOD(rs_setJobStatus);
    RS_REGISTER_CALL_METHOD(rs_setJobState);
@@ -467,6 +533,7 @@ core::Error initialize()
             onSuspend, onResume));
    module_context::events().onClientInit.connect(onClientInit);
    module_context::events().onShutdown.connect(onShutdown);
+   module_context::events().onBackgroundProcessing.connect(onBackgroundProcessing);
 
    using boost::bind;
    ExecBlock initBlock;
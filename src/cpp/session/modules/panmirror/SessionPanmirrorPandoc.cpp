@@ -15,6 +15,8 @@
 
 #include "SessionPanmirrorPandoc.hpp"
 
+#include <map>
+#include <sstream>
 
 #include <shared_core/Error.hpp>
 
@@ -36,6 +38,96 @@ namespace pandoc {
 
 namespace {
 
+// fingerprint of the pandoc binary (path + write time), used to key
+// caches of pandoc outputs which are static for a given binary so that
+// repeated requests don't re-run pandoc just to recompute them
+std::string pandocFingerprint()
+{
+   FilePath pandocPath(module_context::pandocPath());
+   std::ostringstream ostr;
+   ostr << pandocPath.getAbsolutePath() << ':' << pandocPath.getLastWriteTime();
+   return ostr.str();
+}
+
+// cache of recent whole-document conversion results. toggling the visual
+// editor on and off usually round-trips an unchanged document through
+// pandoc in both directions, and on book-length documents each conversion
+// is expensive; serving repeats from here makes those toggles instant.
+// conversions are keyed by their complete input (binary fingerprint,
+// direction, format, options, and document text) so a hit is exact by
+// construction, and entries for a replaced pandoc binary simply age out
+#define kMaxConversionCacheEntries 8
+
+class ConversionCache : boost::noncopyable
+{
+public:
+   ConversionCache() : use_(0) {}
+
+   bool lookup(const std::string& key, json::Value* pResult)
+   {
+      std::map<std::string,Entry>::iterator it = cache_.find(key);
+      if (it == cache_.end())
+         return false;
+
+      it->second.lastUse = ++use_;
+      *pResult = it->second.result;
+      return true;
+   }
+
+   void store(const std::string& key, const json::Value& result)
+   {
+      // evict the least recently used entry to make room
+      if (cache_.size() >= kMaxConversionCacheEntries)
+      {
+         std::map<std::string,Entry>::iterator lru = cache_.begin();
+         for (std::map<std::string,Entry>::iterator it = cache_.begin();
+              it != cache_.end();
+              ++it)
+         {
+            if (it->second.lastUse < lru->second.lastUse)
+               lru = it;
+         }
+         cache_.erase(lru);
+      }
+
+      Entry entry;
+      entry.result = result;
+      entry.lastUse = ++use_;
+      cache_[key] = entry;
+   }
+
+private:
+   struct Entry
+   {
+      Entry() : lastUse(0) {}
+      json::Value result;
+      unsigned long lastUse;
+   };
+
+   std::map<std::string,Entry> cache_;
+   unsigned long use_;
+};
+
+ConversionCache& conversionCache()
+{
+   static ConversionCache instance;
+   return instance;
+}
+
+std::string conversionCacheKey(const std::string& direction,
+                               const std::string& format,
+                               const std::vector<std::string>& options,
+                               const std::string& input)
+{
+   std::ostringstream ostr;
+   ostr << pandocFingerprint() << '\n'
+        << direction << '\n'
+        << format << '\n'
+        << core::algorithm::join(options, "\x1e") << '\n'
+        << input;
+   return ostr.str();
+}
+
 Error readOptionsParam(const json::Array& options, std::vector<std::string>* pOptions)
 {
    for(json::Array::Iterator
@@ -52,12 +144,14 @@ Error readOptionsParam(const json::Array& options, std::vector<std::string>* pOp
    return Success();
 }
 
-void endAstToMarkdown(const json::JsonRpcFunctionContinuation& cont,
+void endAstToMarkdown(const std::string& cacheKey,
+                      const json::JsonRpcFunctionContinuation& cont,
                       const core::system::ProcessResult& result)
 {
    json::JsonRpcResponse response;
    if (result.exitStatus == EXIT_SUCCESS)
    {
+      conversionCache().store(cacheKey, json::Value(result.stdOut));
       response.setResult(result.stdOut);
    }
    else
@@ -94,6 +188,17 @@ void pandocAstToMarkdown(const json::JsonRpcRequest& request,
       return;
    }
 
+   // serve an identical conversion from cache if we have one
+   std::string astJson = jsonAst.write();
+   std::string cacheKey = conversionCacheKey("ast-to-markdown", format, options, astJson);
+   json::Value cachedResult;
+   if (conversionCache().lookup(cacheKey, &cachedResult))
+   {
+      response.setResult(cachedResult);
+      cont(Success(), &response);
+      return;
+   }
+
    // build args
    std::vector<std::string> args;
    args.push_back("--from");
@@ -103,7 +208,7 @@ void pandocAstToMarkdown(const json::JsonRpcRequest& request,
    std::copy(options.begin(), options.end(), std::back_inserter(args));
 
    // run pandoc (async)
-   error = module_context::runPandocAsync(args, jsonAst.write(), boost::bind(endAstToMarkdown, cont, _1));
+   error = module_context::runPandocAsync(args, astJson, boost::bind(endAstToMarkdown, cacheKey, cont, _1));
    if (error)
    {
       json::setErrorResponse(error, &response);
@@ -111,80 +216,72 @@ void pandocAstToMarkdown(const json::JsonRpcRequest& request,
    }
 }
 
-void endHeadingIds(json::Object astJson,
-                   const core::system::ProcessResult& result,
-                   const json::JsonRpcFunctionContinuation& cont)
+// join state for the two pandoc invocations behind markdown -> ast (the
+// ast conversion itself and the heading id extraction); both run
+// concurrently and the response is assembled once the second completes.
+// callbacks are invoked from the process supervisor on the main thread,
+// so no synchronization is required
+struct MarkdownToAstState
 {
-   json::JsonRpcResponse response;
-   if (result.exitStatus == EXIT_SUCCESS)
+   MarkdownToAstState() : astComplete(false), headingIdsComplete(false) {}
+   std::string cacheKey;
+   bool astComplete;
+   bool headingIdsComplete;
+   core::system::ProcessResult astResult;
+   core::system::ProcessResult headingIdsResult;
+};
+
+void endMarkdownToAstPass(boost::shared_ptr<MarkdownToAstState> pState,
+                          bool headingIdsPass,
+                          const core::system::ProcessResult& result,
+                          const json::JsonRpcFunctionContinuation& cont)
+{
+   // record this pass and wait for the other if it's still running
+   if (headingIdsPass)
    {
-      std::vector<std::string> lines;
-      boost::algorithm::split(lines, result.stdOut, boost::algorithm::is_any_of("\n\r"));
-      json::Array jsonHeadingsIds;
-      std::for_each(lines.begin(), lines.end(), [&jsonHeadingsIds](std::string line) {
-         boost::algorithm::trim(line);
-         if (!line.empty())
-            jsonHeadingsIds.push_back(line);
-      });
-      astJson["heading_ids"] = jsonHeadingsIds;
-      response.setResult(astJson);
-      cont(Success(), &response);
+      pState->headingIdsResult = result;
+      pState->headingIdsComplete = true;
    }
    else
    {
-      json::setProcessErrorResponse(result, ERROR_LOCATION, &response);
-      cont(Success(), &response);
+      pState->astResult = result;
+      pState->astComplete = true;
    }
-}
+   if (!pState->astComplete || !pState->headingIdsComplete)
+      return;
 
-void endMarkdownToAst(std::string markdown,
-                      std::string format,
-                      const core::system::ProcessResult& result,
-                      const json::JsonRpcFunctionContinuation& cont)
-{
+   // both passes complete; assemble the response
    json::JsonRpcResponse response;
-   if (result.exitStatus == EXIT_SUCCESS)
+   if (pState->astResult.exitStatus != EXIT_SUCCESS)
    {
-      json::Object jsonObject;
-      if (json::parseJsonForResponse(result.stdOut, &jsonObject, &response))
-      {
-         // got ast, now extract heading ids
-
-         // disable auto identifiers so we can discover *only* explicit ids
-         format += "-auto_identifiers-gfm_auto_identifiers";
-
-         // path to lua filter
-         FilePath resPath = session::options().rResourcesPath();
-         FilePath headingIdsLuaPath = resPath.completePath("heading_ids.lua");
-         std::string headingIdsLua = string_utils::utf8ToSystem(headingIdsLuaPath.getAbsolutePath());
-
-         // build args
-         std::vector<std::string> args;
-         args.push_back("--from");
-         args.push_back(format);
-         args.push_back("--to");
-         args.push_back(headingIdsLua);
-
-         // run pandoc
-         core::system::ProcessResult result;
-         Error error = module_context::runPandocAsync(args, markdown, boost::bind(endHeadingIds, jsonObject, _1, cont));
-         if (error)
-         {
-            json::setErrorResponse(error, &response);
-            cont(Success(), &response);
-         }
-      }
-      else
-      {
-         cont(Success(), &response);
-      }
+      json::setProcessErrorResponse(pState->astResult, ERROR_LOCATION, &response);
+      cont(Success(), &response);
+      return;
    }
-   else
+   if (pState->headingIdsResult.exitStatus != EXIT_SUCCESS)
    {
-      json::setProcessErrorResponse(result, ERROR_LOCATION, &response);
+      json::setProcessErrorResponse(pState->headingIdsResult, ERROR_LOCATION, &response);
       cont(Success(), &response);
+      return;
    }
 
+   json::Object jsonObject;
+   if (json::parseJsonForResponse(pState->astResult.stdOut, &jsonObject, &response))
+   {
+      std::vector<std::string> lines;
+      boost::algorithm::split(lines, pState->headingIdsResult.stdOut,
+                              boost::algorithm::is_any_of("\n\r"));
+      json::Array jsonHeadingsIds;
+      std::for_each(lines.begin(), lines.end(), [&jsonHeadingsIds](std::string line) {
+         boost::algorithm::trim(line);
+         if (!line.empty())
+            jsonHeadingsIds.push_back(line);
+      });
+      jsonObject["heading_ids"] = jsonHeadingsIds;
+      conversionCache().store(pState->cacheKey, jsonObject);
+      response.setResult(jsonObject);
+   }
+   cont(Success(), &response);
 }
 
 void pandocMarkdownToAst(const json::JsonRpcRequest& request,
@@ -212,6 +309,16 @@ void pandocMarkdownToAst(const json::JsonRpcRequest& request,
       return;
    }
 
+   // serve an identical conversion from cache if we have one
+   std::string cacheKey = conversionCacheKey("markdown-to-ast", format, options, markdown);
+   json::Value cachedResult;
+   if (conversionCache().lookup(cacheKey, &cachedResult))
+   {
+      response.setResult(cachedResult);
+      cont(Success(), &response);
+      return;
+   }
+
    // build args
    std::vector<std::string> args;
    args.push_back("--from");
@@ -220,15 +327,42 @@ void pandocMarkdownToAst(const json::JsonRpcRequest& request,
    args.push_back("json");
    std::copy(options.begin(), options.end(), std::back_inserter(args));
 
-   // run pandoc
-   core::system::ProcessResult result;
-   error = module_context::runPandocAsync(args, markdown, boost::bind(endMarkdownToAst, markdown, format, _1, cont));
+   // heading id extraction args; disable auto identifiers so we can
+   // discover *only* explicit ids
+   FilePath resPath = session::options().rResourcesPath();
+   FilePath headingIdsLuaPath = resPath.completePath("heading_ids.lua");
+   std::string headingIdsLua = string_utils::utf8ToSystem(headingIdsLuaPath.getAbsolutePath());
+   std::vector<std::string> headingIdsArgs;
+   headingIdsArgs.push_back("--from");
+   headingIdsArgs.push_back(format + "-auto_identifiers-gfm_auto_identifiers");
+   headingIdsArgs.push_back("--to");
+   headingIdsArgs.push_back(headingIdsLua);
+
+   // run both pandoc passes concurrently rather than back to back (each
+   // pays pandoc's full startup cost, which dominates for typical
+   // editor-sized documents)
+   boost::shared_ptr<MarkdownToAstState> pState(new MarkdownToAstState());
+   pState->cacheKey = cacheKey;
+   error = module_context::runPandocAsync(
+            args, markdown, boost::bind(endMarkdownToAstPass, pState, false, _1, cont));
    if (error)
    {
       json::setErrorResponse(error, &response);
       cont(Success(), &response);
       return;
    }
+   error = module_context::runPandocAsync(
+            headingIdsArgs, markdown, boost::bind(endMarkdownToAstPass, pState, true, _1, cont));
+   if (error)
+   {
+      // the ast pass is already in flight; let its completion record
+      // the (failed) heading pass so the continuation fires exactly once
+      core::system::ProcessResult failedResult;
+      failedResult.exitStatus = EXIT_FAILURE;
+      failedResult.stdErr = error.getSummary();
+      endMarkdownToAstPass(pState, true, failedResult, cont);
+      return;
+   }
 }
 
 
@@ -271,20 +405,22 @@ void pandocGetCapabilities(const json::JsonRpcRequest&,
    // response object
    json::JsonRpcResponse response;
 
-   // version
-   std::string version;
-   if (!pandocCaptureOutput("--version", &version, &response))
+   // try for hit from cache of capabilities by binary fingerprint (so a
+   // cache hit doesn't run pandoc at all, not even for --version)
+   static std::map<std::string,json::Object> s_capabilitiesCache;
+   std::string cacheKey = pandocFingerprint();
+   std::map<std::string,json::Object>::const_iterator it = s_capabilitiesCache.find(cacheKey);
+   if (it != s_capabilitiesCache.end())
    {
+      response.setResult(it->second);
       cont(Success(), &response);
       return;
    }
 
-   // try for hit from cache of capabilities by version
-   static std::map<std::string,json::Object> s_capabilitiesCache;
-   std::map<std::string,json::Object>::const_iterator it = s_capabilitiesCache.find(version);
-   if (it != s_capabilitiesCache.end())
+   // version
+   std::string version;
+   if (!pandocCaptureOutput("--version", &version, &response))
    {
-      response.setResult(it->second);
       cont(Success(), &response);
       return;
    }
@@ -330,8 +466,8 @@ void pandocGetCapabilities(const json::JsonRpcRequest&,
    capabilities["output_formats"] = outputFormats;
    capabilities["highlight_languages"] = highlightLanguages;
 
-   // cache by version
-   s_capabilitiesCache[version] = capabilities;
+   // cache by binary fingerprint
+   s_capabilitiesCache[cacheKey] = capabilities;
 
    // set response
    response.setResult(capabilities);
@@ -355,6 +491,18 @@ void pandocListExtensions(const json::JsonRpcRequest& request,
      return;
    }
 
+   // extension lists are static for a given binary and format, so serve
+   // repeated requests from cache
+   static std::map<std::string,std::string> s_extensionsCache;
+   std::string cacheKey = pandocFingerprint() + '\n' + format;
+   std::map<std::string,std::string>::const_iterator it = s_extensionsCache.find(cacheKey);
+   if (it != s_extensionsCache.end())
+   {
+      response.setResult(it->second);
+      cont(Success(), &response);
+      return;
+   }
+
    // build arg
    std::string arg =  "--list-extensions";
    if (!format.empty())
@@ -364,6 +512,7 @@ void pandocListExtensions(const json::JsonRpcRequest& request,
    std::string extensions;
    if (pandocCaptureOutput(arg, &extensions, &response))
    {
+      s_extensionsCache[cacheKey] = extensions;
       response.setResult(extensions);
       cont(Success(), &response);
    }
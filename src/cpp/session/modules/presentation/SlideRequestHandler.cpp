@@ -16,7 +16,10 @@
 
 #include "SlideRequestHandler.hpp"
 
+#include <algorithm>
 #include <iostream>
+#include <map>
+#include <sstream>
 
 #include <boost/utility.hpp>
 #include <boost/format.hpp>
@@ -36,6 +39,7 @@
 #include <r/RExec.hpp>
 
 #include <session/SessionModuleContext.hpp>
+#include <session/SessionUriContentCache.hpp>
 #include <session/projects/SessionProjects.hpp>
 
 #include "PresentationState.hpp"
@@ -486,7 +490,7 @@ std::string userSlidesCss(const SlideDeck& slideDeck)
    std::string userSlidesCss;
    if (cssPath.exists())
    {
-      Error error = core::readStringFromFile(cssPath, &userSlidesCss);
+      Error error = content_cache::readCachedFile(cssPath, &userSlidesCss);
       if (error)
          LOG_ERROR(error);
    }
@@ -835,9 +839,90 @@ void setWebCacheableFileResponse(const FilePath& path,
    }
 }
 
-void handlePresentationRootRequest(const std::string& path,
+// most recent rendered root page (and zoom variant), along with the
+// deck state it was rendered from
+std::map<std::string, std::pair<std::string, std::string> > s_renderedRootPages;
+
+// a token representing the state of the deck on disk; used to decide
+// whether the most recent render of the root page can be re-served
+// (edits to the Rmd, re-knits of the md, and custom css changes all
+// produce new timestamps and invalidate it)
+std::string deckStateToken(const std::string& path)
+{
+   FilePath rmdFile = presentation::state::filePath();
+   FilePath mdFile = rmdFile.getParent().completeChildPath(
+                                                rmdFile.getStem() + ".md");
+
+   std::ostringstream ostr;
+   ostr << rmdFile.getAbsolutePath() << "|" << path;
+   if (rmdFile.exists())
+      ostr << "|" << rmdFile.getLastWriteTime() << ":" << rmdFile.getSize();
+   if (mdFile.exists())
+      ostr << "|" << mdFile.getLastWriteTime() << ":" << mdFile.getSize();
+
+   // custom css can restyle the deck without touching the source
+   std::vector<FilePath> children;
+   Error error = presentation::state::directory().getChildren(children);
+   if (error)
+      LOG_ERROR(error);
+   std::vector<std::string> cssEntries;
+   for (const FilePath& child : children)
+   {
+      if (child.getExtensionLowerCase() == ".css")
+      {
+         std::ostringstream cssOstr;
+         cssOstr << child.getFilename() << ":" << child.getLastWriteTime();
+         cssEntries.push_back(cssOstr.str());
+      }
+   }
+   std::sort(cssEntries.begin(), cssEntries.end());
+   for (const std::string& cssEntry : cssEntries)
+      ostr << "|" << cssEntry;
+
+   return ostr.str();
+}
+
+// refresh the standalone view-in-browser copy of the presentation;
+// scheduled as deferred work so it doesn't delay the pane response
+void updateViewInBrowser()
+{
+   FilePath viewInBrowserPath = presentation::state::viewInBrowserPath();
+   if (!viewInBrowserPath.exists())
+      return;
+
+   ErrorResponse errorResponse;
+   if (!savePresentationAsStandalone(viewInBrowserPath, &errorResponse))
+      LOG_ERROR_MESSAGE(errorResponse.message);
+}
+
+void handlePresentationRootRequest(const http::Request& request,
+                                   const std::string& path,
                                    http::Response* pResponse)
-{   
+{
+   // serve from the rendered-page cache when the deck hasn't changed
+   // since the last render (with an etag so an unchanged page can be
+   // revalidated with a 304 rather than re-sent)
+   std::string stateToken = deckStateToken(path);
+   std::map<std::string, std::pair<std::string, std::string> >::iterator
+         cacheIt = s_renderedRootPages.find(path);
+   if (cacheIt != s_renderedRootPages.end() &&
+       cacheIt->second.first == stateToken)
+   {
+      pResponse->setCacheWithRevalidationHeaders();
+      pResponse->setContentType("text/html");
+      Error error = pResponse->setCacheableBody(cacheIt->second.second,
+                                                request);
+      if (error)
+         LOG_ERROR(error);
+
+      if (path != "zoom")
+      {
+         ClientEvent event(client_events::kPresentationPaneRequestCompleted);
+         module_context::enqueClientEvent(event);
+      }
+      return;
+   }
+
    // read presentation
    presentation::SlideDeck slideDeck;
    std::string slides, initCommands, slideCommands;
@@ -908,19 +993,30 @@ void handlePresentationRootRequest(const std::string& path,
    filters.push_back(linkFilter());
    if (renderPresentation(vars, filters, previewOutputStream, &errorResponse))
    {
+      // remember this render so subsequent requests against an
+      // unchanged deck can skip the knit/parse/render pipeline
+      // entirely (the knit may have updated the md, so recompute
+      // the state token)
+      std::string html = previewOutputStream.str();
+      s_renderedRootPages[path] = std::make_pair(deckStateToken(path), html);
+
       // set response
-      pResponse->setNoCacheHeaders();
+      pResponse->setCacheWithRevalidationHeaders();
       pResponse->setContentType("text/html");
-      pResponse->setBody(previewOutputStream);
+      Error error = pResponse->setCacheableBody(html, request);
+      if (error)
+         LOG_ERROR(error);
 
       // also save a view in browser version if that path already exists
-      // (allows the user to do a simple browser refresh to see changes)
-      FilePath viewInBrowserPath = presentation::state::viewInBrowserPath();
-      if (viewInBrowserPath.exists())
+      // (allows the user to do a simple browser refresh to see changes);
+      // deferred so re-rendering the standalone copy doesn't delay the
+      // pane response
+      if (presentation::state::viewInBrowserPath().exists())
       {
-         ErrorResponse errorResponse;
-         if (!savePresentationAsStandalone(viewInBrowserPath, &errorResponse))
-            LOG_ERROR_MESSAGE(errorResponse.message);
+         module_context::scheduleDelayedWork(
+                  boost::posix_time::milliseconds(500),
+                  updateViewInBrowser,
+                  true);
       }
    }
    else
@@ -1133,7 +1229,7 @@ void handlePresentationPaneRequest(const http::Request& request,
    // special handling for the root
    if (path.empty() || (path == "zoom"))
    {
-      handlePresentationRootRequest(path, pResponse);
+      handlePresentationRootRequest(request, path, pResponse);
    }
 
    // special handling for view in browser
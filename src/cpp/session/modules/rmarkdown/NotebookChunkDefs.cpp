@@ -17,6 +17,9 @@
 #include "NotebookCache.hpp"
 #include "NotebookChunkDefs.hpp"
 
+#include <ctime>
+#include <map>
+
 #include <shared_core/json/Json.hpp>
 #include <core/json/JsonRpc.hpp>
 #include <core/Exec.hpp>
@@ -122,9 +125,41 @@ FilePath chunkDefinitionsPath(const std::string& docPath,
    return defs;
 }
 
+namespace {
+
+// cache of parsed chunk definition files, validated by write time and
+// size. chunk values (working directory, options, etc.) are looked up
+// against the defs file for every chunk executed, so without the cache
+// each lookup re-reads and re-parses the same JSON from disk (painful
+// when the cache folder lives on network storage)
+struct CachedChunkDefs
+{
+   std::time_t lastWriteTime;
+   uintmax_t size;
+   json::Object contents;
+};
+
+std::map<std::string, CachedChunkDefs> s_chunkDefsCache;
+
+} // anonymous namespace
+
 Error getChunkJson(const FilePath& defs, json::Object *pJson)
 {
-   // read the defs file 
+   // check for a cached copy of the parsed defs file
+   std::string cacheKey = defs.getAbsolutePath();
+   std::time_t lastWriteTime = defs.getLastWriteTime();
+   uintmax_t size = defs.getSize();
+   std::map<std::string, CachedChunkDefs>::const_iterator it =
+                                             s_chunkDefsCache.find(cacheKey);
+   if (it != s_chunkDefsCache.end() &&
+       it->second.lastWriteTime == lastWriteTime &&
+       it->second.size == size)
+   {
+      *pJson = it->second.contents;
+      return Success();
+   }
+
+   // read the defs file
    std::string contents;
    Error error = readStringFromFile(defs, &contents);
    if (error)
@@ -138,6 +173,16 @@ Error getChunkJson(const FilePath& defs, json::Object *pJson)
 
    *pJson = defContents.getValue<json::Object>();
 
+   // store in the cache (bound the number of entries; typically there's
+   // one defs file per open notebook)
+   if (s_chunkDefsCache.size() >= 20)
+      s_chunkDefsCache.clear();
+   CachedChunkDefs cached;
+   cached.lastWriteTime = lastWriteTime;
+   cached.size = size;
+   cached.contents = *pJson;
+   s_chunkDefsCache[cacheKey] = cached;
+
    return Success();
 }
 
@@ -204,7 +249,15 @@ Error setChunkDefs(boost::shared_ptr<source_database::SourceDocument> pDoc,
       LOG_ERROR(error);
       return error;
    }
-   
+
+   // refresh the cached copy to match what we just wrote (avoids an
+   // immediate re-read on the next chunk value lookup)
+   CachedChunkDefs cached;
+   cached.lastWriteTime = defFile.getLastWriteTime();
+   cached.size = defFile.getSize();
+   cached.contents = defContents;
+   s_chunkDefsCache[defFile.getAbsolutePath()] = cached;
+
    return Success();
 }
 
@@ -0,0 +1,286 @@
+/*
+ * NotebookChunkPlan.cpp
+ *
+ * Copyright (C) 2020 by RStudio, PBC
+ *
+ * Unless you have received this program directly from RStudio pursuant
+ * to the terms of a commercial license agreement with RStudio, then
+ * this program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ *
+ */
+
+#include "SessionRmdNotebook.hpp"
+#include "NotebookChunkPlan.hpp"
+#include "NotebookChunkDefs.hpp"
+#include "NotebookChunkOptions.hpp"
+#include "NotebookParallelExec.hpp"
+#include "NotebookQueue.hpp"
+#include "NotebookQueueUnit.hpp"
+
+#include <map>
+#include <set>
+#include <vector>
+
+#include <boost/make_shared.hpp>
+
+#include <shared_core/FilePath.hpp>
+#include <shared_core/json/Json.hpp>
+#include <core/StringUtils.hpp>
+
+#include <r/RExec.hpp>
+#include <r/RSexp.hpp>
+
+#include <session/SessionModuleContext.hpp>
+#include <session/SessionSourceDatabase.hpp>
+
+using namespace rstudio::core;
+
+namespace rstudio {
+namespace session {
+namespace modules {
+namespace rmarkdown {
+namespace notebook {
+namespace {
+
+// chunk code hashes last observed per document; a chunk whose code hash
+// changes between plan passes is stale relative to the notebook cache
+std::map<std::string, std::map<std::string, uint64_t> > s_observedHashes;
+
+// documents awaiting a plan pass
+std::set<std::string> s_pendingPlans;
+bool s_planScheduled = false;
+
+// speculatively execute a stale chunk if (and only if) it has opted into
+// self-contained parallel execution; other chunks need the session's
+// global environment and can't be run ahead of the user safely
+void speculativeExecute(const std::string& docId,
+                        const std::string& chunkId,
+                        const std::string& code,
+                        const json::Object& defaultOptions,
+                        const FilePath& workingDir)
+{
+   // construct a queue unit representing a whole-chunk batch execution
+   json::Object range;
+   range["start"] = 0;
+   range["stop"] = static_cast<int>(code.length());
+   json::Array pending;
+   pending.push_back(range);
+
+   json::Object unitJson;
+   unitJson["code"]       = code;
+   unitJson["doc_id"]     = docId;
+   unitJson["chunk_id"]   = chunkId;
+   unitJson["completed"]  = json::Array();
+   unitJson["pending"]    = pending;
+   unitJson["exec_mode"]  = static_cast<int>(ExecModeBatch);
+   unitJson["exec_scope"] = static_cast<int>(ExecScopeChunk);
+
+   boost::shared_ptr<NotebookQueueUnit> pUnit =
+         boost::make_shared<NotebookQueueUnit>();
+   Error error = NotebookQueueUnit::fromJson(unitJson, &pUnit);
+   if (error)
+   {
+      LOG_ERROR(error);
+      return;
+   }
+
+   // parse the chunk's options from its header; a parse failure likely
+   // means the header is mid-edit, so just skip this pass
+   json::Object chunkOptions;
+   error = pUnit->parseOptions(&chunkOptions);
+   if (error)
+      return;
+
+   ChunkOptions options(defaultOptions, chunkOptions);
+
+   std::string engine = options.getOverlayOption("engine", std::string("r"));
+   if (engine == "R")
+      engine = "r";
+
+   if (!isParallelUnit(pUnit, options, engine))
+      return;
+
+   // don't run chunks which have been disabled
+   if (!options.getOverlayOption("eval", true))
+      return;
+
+   error = executeParallelUnit(pUnit, notebookCtxId(), workingDir, options);
+   if (error)
+      LOG_ERROR(error);
+}
+
+void planDocument(const std::string& docId)
+{
+   // don't speculate while the document has an active execution queue
+   if (!getDocQueue(docId).isNull())
+      return;
+
+   // look up the document; if it's gone, unsaved, or isn't an R Markdown
+   // document there's nothing to plan
+   boost::shared_ptr<source_database::SourceDocument> pDoc(
+         new source_database::SourceDocument());
+   Error error = source_database::get(docId, pDoc);
+   if (error || !pDoc->isRMarkdownDocument() || pDoc->path().empty())
+   {
+      s_observedHashes.erase(docId);
+      return;
+   }
+   std::string docPath = pDoc->path();
+
+   // parse chunk fence rows and code from the document contents
+   r::sexp::Protect protect;
+   SEXP planSEXP = R_NilValue;
+   error = r::exec::RFunction(".rs.rnb.chunkPlan", pDoc->contents())
+         .call(&planSEXP, &protect);
+   if (error)
+   {
+      LOG_ERROR(error);
+      return;
+   }
+
+   std::vector<int> rows;
+   std::vector<std::string> code;
+   error = r::sexp::getNamedListElement(planSEXP, "rows", &rows);
+   if (!error)
+      error = r::sexp::getNamedListElement(planSEXP, "code", &code);
+   if (error || rows.size() != code.size())
+   {
+      if (error)
+         LOG_ERROR(error);
+      return;
+   }
+
+   // read the chunk definitions (which map document rows to chunk ids)
+   json::Array chunkDefs;
+   error = getChunkValue(docPath, docId, kChunkDefs, &chunkDefs);
+   if (error)
+   {
+      LOG_ERROR(error);
+      return;
+   }
+
+   // default chunk options (from the setup chunk) and working directory;
+   // both may be absent
+   json::Object defaultOptions;
+   getChunkValue(docPath, docId, kChunkDefaultOptions, &defaultOptions);
+
+   std::string workingDirProp;
+   getChunkValue(docPath, docId, kChunkWorkingDir, &workingDirProp);
+   FilePath workingDir = workingDirProp.empty() ?
+      module_context::resolveAliasedPath(docPath).getParent() :
+      module_context::resolveAliasedPath(workingDirProp);
+
+   std::map<std::string, uint64_t>& observed = s_observedHashes[docId];
+   std::map<std::string, uint64_t> current;
+
+   for (const json::Value& defVal : chunkDefs)
+   {
+      if (!defVal.isObject())
+         continue;
+
+      std::string chunkId;
+      int row = 0;
+      Error defError = json::readObject(defVal.getObject(),
+                                        kChunkId, chunkId,
+                                        "row", row);
+      if (defError)
+         continue;
+
+      // find the parsed chunk whose closing fence matches this definition
+      std::size_t idx = 0;
+      bool found = false;
+      for (std::size_t i = 0; i < rows.size(); i++)
+      {
+         if (rows[i] == row)
+         {
+            idx = i;
+            found = true;
+            break;
+         }
+      }
+      if (!found)
+         continue;
+
+      uint64_t hash = string_utils::hashStable<uint64_t>(code[idx]);
+      current[chunkId] = hash;
+
+      // first sighting of this chunk: record its hash without speculating
+      // (on session resume we assume the cache reflects the code on disk)
+      std::map<std::string, uint64_t>::iterator it = observed.find(chunkId);
+      if (it == observed.end())
+         continue;
+
+      // unchanged since the last pass; the cache is already warm
+      if (it->second == hash)
+         continue;
+
+      speculativeExecute(docId, chunkId, code[idx], defaultOptions,
+                         workingDir);
+   }
+
+   // forget chunks removed from the document and adopt the new hashes
+   observed.swap(current);
+}
+
+void performScheduledPlans()
+{
+   s_planScheduled = false;
+
+   std::set<std::string> pending;
+   pending.swap(s_pendingPlans);
+   for (const std::string& docId : pending)
+      planDocument(docId);
+}
+
+void schedulePlan(const std::string& docId)
+{
+   s_pendingPlans.insert(docId);
+   if (s_planScheduled)
+      return;
+
+   // plan once the session has been idle for a moment; rapid-fire document
+   // updates (e.g. while typing) conflate into a single pass
+   s_planScheduled = true;
+   module_context::scheduleDelayedWork(
+            boost::posix_time::seconds(2), performScheduledPlans, true);
+}
+
+void onDocUpdated(boost::shared_ptr<source_database::SourceDocument> pDoc)
+{
+   // only R Markdown documents have chunks to plan
+   if (pDoc->isRMarkdownDocument())
+      schedulePlan(pDoc->id());
+}
+
+void onDocRemoved(const std::string& docId, const std::string&)
+{
+   s_pendingPlans.erase(docId);
+   s_observedHashes.erase(docId);
+}
+
+void onRemoveAll()
+{
+   s_pendingPlans.clear();
+   s_observedHashes.clear();
+}
+
+} // anonymous namespace
+
+Error initChunkPlan()
+{
+   source_database::events().onDocUpdated.connect(onDocUpdated);
+   source_database::events().onDocRemoved.connect(onDocRemoved);
+   source_database::events().onRemoveAll.connect(onRemoveAll);
+
+   return Success();
+}
+
+} // namespace notebook
+} // namespace rmarkdown
+} // namespace modules
+} // namespace session
+} // namespace rstudio
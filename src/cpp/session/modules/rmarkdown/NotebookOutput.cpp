@@ -30,6 +30,7 @@
 #include <core/StringUtils.hpp>
 #include <shared_core/json/Json.hpp>
 #include <core/text/CsvParser.hpp>
+#include <core/zlib/zlib.hpp>
 
 #include <r/RSexp.hpp>
 #include <r/RJson.hpp>
@@ -39,6 +40,7 @@
 #include <session/SessionModuleContext.hpp>
 
 #include <map>
+#include <sstream>
 
 #define kRequestId    "request_id"
 #define kChunkOutputs "chunk_outputs"
@@ -59,6 +61,35 @@ namespace {
 typedef std::map<std::string, OutputPair> LastChunkOutput;
 LastChunkOutput s_lastChunkOutputs;
 
+// compressed cache of per-chunk replay output. building the outputs json
+// for replay re-reads and re-parses every output file (and calls into R
+// for data outputs), which makes reopening a large notebook proportional
+// to its total output; the serialized array is cached zlib-compressed,
+// keyed by a fingerprint of the output folder, so unchanged chunks replay
+// without touching their files
+struct ChunkOutputCacheEntry
+{
+   std::string fingerprint;
+   std::vector<unsigned char> compressed;
+};
+std::map<std::string, ChunkOutputCacheEntry> s_chunkOutputCache;
+
+// keep the cache bounded (entries are small relative to the outputs they
+// replace, but notebooks can accumulate many chunks)
+const std::size_t kMaxChunkOutputCacheEntries = 500;
+
+std::string chunkOutputFingerprint(const std::vector<FilePath>& outputPaths)
+{
+   std::ostringstream ostr;
+   for (const FilePath& path : outputPaths)
+   {
+      ostr << path.getFilename() << ":"
+           << path.getSize() << ":"
+           << path.getLastWriteTime() << ";";
+   }
+   return ostr.str();
+}
+
 ChunkOutputType chunkOutputType(const FilePath& outputPath)
 {
    ChunkOutputType outputType = ChunkOutputNone;
@@ -486,46 +517,90 @@ Error enqueueChunkOutput(
    if (outputDir.exists())
    {
       Error error = outputDir.getChildren(outputPaths);
-      if (error) 
+      if (error)
          LOG_ERROR(error);
 
       // arrange by filename (use FilePath's < operator)
       std::sort(outputPaths.begin(), outputPaths.end());
 
-      // loop through each and build an array of the outputs
-      for (const FilePath& outputPath : outputPaths)
+      // replay from the compressed cache when the output folder hasn't
+      // changed since the outputs were last assembled
+      std::string cacheKey = docId + "/" + chunkId + "/" + ctxId;
+      std::string fingerprint = chunkOutputFingerprint(outputPaths);
+      bool cached = false;
+      std::map<std::string, ChunkOutputCacheEntry>::const_iterator cacheIt =
+            s_chunkOutputCache.find(cacheKey);
+      if (cacheIt != s_chunkOutputCache.end() &&
+          cacheIt->second.fingerprint == fingerprint)
+      {
+         std::string outputsJson;
+         error = core::zlib::decompressString(cacheIt->second.compressed,
+                                              &outputsJson);
+         json::Value outputsVal;
+         if (!error && !outputsVal.parse(outputsJson) && outputsVal.isArray())
+         {
+            outputs = outputsVal.getArray();
+            cached = true;
+         }
+         else if (error)
+         {
+            LOG_ERROR(error);
+         }
+      }
+
+      if (!cached)
       {
-         json::Object output;
-
-         // ascertain chunk output type from file extension; skip if extension 
-         // unknown
-         ChunkOutputType outputType = chunkOutputType(outputPath);
-         if (outputType == ChunkOutputNone)
-            continue;
-
-         // extract ordinal from filename
-         unsigned ordinal = ::strtol(outputPath.getStem().c_str(), nullptr, 16);
-
-         // extract metadata if present
-         json::Value meta;
-         FilePath metadata = outputDir.completePath(
-            outputPath.getStem() + ".metadata");
-         if (metadata.exists())
+         // loop through each and build an array of the outputs
+         for (const FilePath& outputPath : outputPaths)
          {
-            std::string contents;
-            error = readStringFromFile(metadata, &contents);
-            if (!contents.empty())
-               meta.parse(contents);
+            json::Object output;
+
+            // ascertain chunk output type from file extension; skip if
+            // extension unknown
+            ChunkOutputType outputType = chunkOutputType(outputPath);
+            if (outputType == ChunkOutputNone)
+               continue;
+
+            // extract ordinal from filename
+            unsigned ordinal = ::strtol(outputPath.getStem().c_str(), nullptr, 16);
+
+            // extract metadata if present
+            json::Value meta;
+            FilePath metadata = outputDir.completePath(
+               outputPath.getStem() + ".metadata");
+            if (metadata.exists())
+            {
+               std::string contents;
+               error = readStringFromFile(metadata, &contents);
+               if (!contents.empty())
+                  meta.parse(contents);
+            }
+            output[kChunkOutputMetadata] = meta;
+
+            // format/parse chunk output for client consumption
+            error = fillOutputObject(docId, chunkId, ctxId, ordinal, outputType,
+                  outputPath, &output);
+            if (error)
+               LOG_ERROR(error);
+            else
+               outputs.push_back(output);
          }
-         output[kChunkOutputMetadata] = meta;
-         
-         // format/parse chunk output for client consumption
-         error = fillOutputObject(docId, chunkId, ctxId, ordinal, outputType, 
-               outputPath, &output);
+
+         // cache the serialized outputs for the next replay
+         std::vector<unsigned char> compressed;
+         error = core::zlib::compressString(outputs.write(), &compressed);
          if (error)
+         {
             LOG_ERROR(error);
+         }
          else
-            outputs.push_back(output);
+         {
+            if (s_chunkOutputCache.size() >= kMaxChunkOutputCacheEntries)
+               s_chunkOutputCache.clear();
+            ChunkOutputCacheEntry& entry = s_chunkOutputCache[cacheKey];
+            entry.fingerprint = fingerprint;
+            entry.compressed = compressed;
+         }
       }
    }
    
@@ -0,0 +1,279 @@
+/*
+ * NotebookParallelExec.cpp
+ *
+ * Copyright (C) 2020 by RStudio, PBC
+ *
+ * Unless you have received this program directly from RStudio pursuant
+ * to the terms of a commercial license agreement with RStudio, then
+ * this program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ *
+ */
+
+#include "SessionRmdNotebook.hpp"
+#include "NotebookParallelExec.hpp"
+#include "NotebookQueueUnit.hpp"
+#include "NotebookChunkOptions.hpp"
+#include "NotebookOutput.hpp"
+
+#include <list>
+
+#include <boost/make_shared.hpp>
+#include <boost/thread.hpp>
+
+#include <core/FileSerializer.hpp>
+#include <core/StringUtils.hpp>
+
+#include <session/SessionModuleContext.hpp>
+#include <session/SessionAsyncRProcess.hpp>
+#include <session/SessionSourceDatabase.hpp>
+
+using namespace rstudio::core;
+
+namespace rstudio {
+namespace session {
+namespace modules {
+namespace rmarkdown {
+namespace notebook {
+namespace {
+
+// chunk execution states; must match ChunkExecState in NotebookQueue.cpp
+// (and the client's enumeration of the same)
+enum
+{
+   kChunkExecStarted  = 0,
+   kChunkExecFinished = 1
+};
+
+void enqueueExecStateChanged(const std::string& docId,
+                             const std::string& chunkId,
+                             int state,
+                             const json::Object& options)
+{
+   json::Object event;
+   event["doc_id"]     = docId;
+   event["chunk_id"]   = chunkId;
+   event["exec_state"] = state;
+   event["options"]    = options;
+   module_context::enqueClientEvent(ClientEvent(
+            client_events::kChunkExecStateChanged, event));
+}
+
+// a chunk waiting for a free worker process
+struct PendingChunk
+{
+   PendingChunk(boost::shared_ptr<NotebookQueueUnit> unitIn,
+                const std::string& nbCtxIdIn,
+                const core::FilePath& workingDirIn,
+                const ChunkOptions& optionsIn)
+      : unit(unitIn),
+        nbCtxId(nbCtxIdIn),
+        workingDir(workingDirIn),
+        options(optionsIn)
+   {
+   }
+
+   boost::shared_ptr<NotebookQueueUnit> unit;
+   std::string nbCtxId;
+   core::FilePath workingDir;
+   ChunkOptions options;
+};
+
+// executes a single chunk's code on a worker R process, streaming its
+// console output into the chunk's cache entry
+class ParallelChunkExec : public async_r::AsyncRProcess
+{
+public:
+   static Error create(boost::shared_ptr<NotebookQueueUnit> unit,
+                       const std::string& nbCtxId,
+                       const core::FilePath& workingDir,
+                       const ChunkOptions& options,
+                       boost::shared_ptr<ParallelChunkExec>* pExec)
+   {
+      // extract the code to execute (without the chunk header)
+      std::string code;
+      Error error = unit->innerCode(&code);
+      if (error)
+         return error;
+
+      // write it to a script file the worker can source
+      FilePath scriptFile = module_context::tempFile("notebook-chunk-", "R");
+      error = writeStringToFile(scriptFile, code);
+      if (error)
+         return error;
+
+      // reset any existing output for the chunk; the whole chunk is
+      // re-executing
+      error = cleanChunkOutput(unit->docId(), unit->chunkId(), nbCtxId, true);
+      if (error)
+         LOG_ERROR(error);
+      updateLastChunkOutput(unit->docId(), unit->chunkId(), OutputPair());
+
+      boost::shared_ptr<ParallelChunkExec> pChunkExec(new ParallelChunkExec());
+      pChunkExec->docId_ = unit->docId();
+      pChunkExec->chunkId_ = unit->chunkId();
+      pChunkExec->nbCtxId_ = nbCtxId;
+      pChunkExec->scriptFile_ = scriptFile;
+      pChunkExec->options_ = options.chunkOptions();
+
+      // let the client know the chunk is running
+      enqueueExecStateChanged(unit->docId(), unit->chunkId(),
+            kChunkExecStarted, options.chunkOptions());
+
+      // execute the chunk in a vanilla R process (it deliberately does not
+      // see the session's global environment or .RData)
+      std::string cmd("source('" +
+            string_utils::singleQuotedStrEscape(
+               string_utils::utf8ToSystem(scriptFile.getAbsolutePath())) +
+            "', print.eval = TRUE, encoding = 'UTF-8')");
+      pChunkExec->start(cmd.c_str(), workingDir, async_r::R_PROCESS_VANILLA);
+
+      *pExec = pChunkExec;
+      return Success();
+   }
+
+   std::string docId() const
+   {
+      return docId_;
+   }
+
+   std::string chunkId() const
+   {
+      return chunkId_;
+   }
+
+private:
+   void onStdout(const std::string& output)
+   {
+      onChunkOutput(kChunkConsoleOutput, output);
+   }
+
+   void onStderr(const std::string& output)
+   {
+      onChunkOutput(kChunkConsoleError, output);
+   }
+
+   void onChunkOutput(int type, const std::string& output)
+   {
+      FilePath outputCsv = chunkOutputFile(docId_, chunkId_, nbCtxId_,
+            ChunkOutputText);
+      Error error = appendConsoleOutput(type, output, outputCsv);
+      if (error)
+         LOG_ERROR(error);
+
+      events().onChunkConsoleOutput(docId_, chunkId_, type, output);
+   }
+
+   void onCompleted(int exitStatus);
+
+   std::string docId_;
+   std::string chunkId_;
+   std::string nbCtxId_;
+   FilePath scriptFile_;
+   json::Object options_;
+};
+
+// running workers and the chunks waiting behind them
+std::list<boost::shared_ptr<ParallelChunkExec> > s_running;
+std::list<PendingChunk> s_pending;
+
+std::size_t maxParallelWorkers()
+{
+   return std::max<std::size_t>(boost::thread::hardware_concurrency(), 1);
+}
+
+void processPendingChunks()
+{
+   while (!s_pending.empty() && s_running.size() < maxParallelWorkers())
+   {
+      PendingChunk pending = s_pending.front();
+      s_pending.pop_front();
+
+      boost::shared_ptr<ParallelChunkExec> pExec;
+      Error error = ParallelChunkExec::create(pending.unit, pending.nbCtxId,
+            pending.workingDir, pending.options, &pExec);
+      if (error)
+      {
+         LOG_ERROR(error);
+         continue;
+      }
+      s_running.push_back(pExec);
+   }
+}
+
+void ParallelChunkExec::onCompleted(int exitStatus)
+{
+   // clean up the script file
+   Error error = scriptFile_.removeIfExists();
+   if (error)
+      LOG_ERROR(error);
+
+   // deliver the chunk's accumulated output to the client from the cache
+   std::string docPath;
+   source_database::getPath(docId_, &docPath);
+   error = enqueueChunkOutput(docPath, docId_, chunkId_, nbCtxId_,
+         std::string());
+   if (error)
+      LOG_ERROR(error);
+
+   enqueueExecStateChanged(docId_, chunkId_, kChunkExecFinished, options_);
+   events().onChunkExecCompleted(docId_, chunkId_, nbCtxId_);
+
+   // remove ourselves from the running list and dispatch waiting chunks
+   for (std::list<boost::shared_ptr<ParallelChunkExec> >::iterator
+        it = s_running.begin(); it != s_running.end(); it++)
+   {
+      if (it->get() == this)
+      {
+         s_running.erase(it);
+         break;
+      }
+   }
+   processPendingChunks();
+}
+
+} // anonymous namespace
+
+bool isParallelUnit(boost::shared_ptr<NotebookQueueUnit> unit,
+                    const ChunkOptions& options,
+                    const std::string& engine)
+{
+   // only whole R chunks can run on a worker (partial executions and inline
+   // chunks need the session's environment)
+   if (engine != "r" || unit->execScope() != ExecScopeChunk)
+      return false;
+
+   return options.getOverlayOption("parallel", false);
+}
+
+Error executeParallelUnit(boost::shared_ptr<NotebookQueueUnit> unit,
+                          const std::string& nbCtxId,
+                          const core::FilePath& workingDir,
+                          const ChunkOptions& options)
+{
+   s_pending.push_back(PendingChunk(unit, nbCtxId, workingDir, options));
+   processPendingChunks();
+   return Success();
+}
+
+void interruptParallelExec()
+{
+   // discard chunks we haven't started
+   s_pending.clear();
+
+   // terminate running workers; they finish via onCompleted, which emits
+   // the finished state for the chunk
+   for (boost::shared_ptr<ParallelChunkExec> pExec : s_running)
+   {
+      pExec->terminate();
+   }
+}
+
+} // namespace notebook
+} // namespace rmarkdown
+} // namespace modules
+} // namespace session
+} // namespace rstudio
@@ -0,0 +1,64 @@
+/*
+ * NotebookParallelExec.hpp
+ *
+ * Copyright (C) 2020 by RStudio, PBC
+ *
+ * Unless you have received this program directly from RStudio pursuant
+ * to the terms of a commercial license agreement with RStudio, then
+ * this program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ *
+ */
+
+#ifndef SESSION_NOTEBOOK_PARALLEL_EXEC_HPP
+#define SESSION_NOTEBOOK_PARALLEL_EXEC_HPP
+
+#include <string>
+
+#include <boost/shared_ptr.hpp>
+
+namespace rstudio {
+namespace core {
+   class Error;
+   class FilePath;
+}
+}
+
+namespace rstudio {
+namespace session {
+namespace modules {
+namespace rmarkdown {
+namespace notebook {
+
+class NotebookQueueUnit;
+class ChunkOptions;
+
+// returns true if the given unit has opted in to execution on a pooled
+// worker R process (R engine, whole-chunk scope, and parallel=TRUE in its
+// chunk options). such chunks must be self-contained: they run in a fresh
+// R process and do not see (or modify) the session's global environment
+bool isParallelUnit(boost::shared_ptr<NotebookQueueUnit> unit,
+                    const ChunkOptions& options,
+                    const std::string& engine);
+
+// execute the unit on a pooled worker R process (or queue it for execution
+// when all workers are busy); output is merged into the notebook cache and
+// delivered to the client when the chunk completes
+core::Error executeParallelUnit(boost::shared_ptr<NotebookQueueUnit> unit,
+                                const std::string& nbCtxId,
+                                const core::FilePath& workingDir,
+                                const ChunkOptions& options);
+
+// terminate all running parallel chunks and discard pending ones
+void interruptParallelExec();
+
+} // namespace notebook
+} // namespace rmarkdown
+} // namespace modules
+} // namespace session
+} // namespace rstudio
+
+#endif // SESSION_NOTEBOOK_PARALLEL_EXEC_HPP
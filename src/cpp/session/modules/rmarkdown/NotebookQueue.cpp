@@ -29,6 +29,7 @@
 #include "NotebookCache.hpp"
 #include "NotebookAlternateEngines.hpp"
 #include "NotebookChunkOptions.hpp"
+#include "NotebookParallelExec.hpp"
 
 #include <r/RCntxtUtils.hpp>
 #include <r/RInterface.hpp>
@@ -397,6 +398,19 @@ private:
       if (engine == "R")
          engine = "r";
 
+      // chunks which have declared themselves parallel run on a pooled
+      // worker R process; dispatch the unit and move on to the next one
+      // rather than waiting for it
+      if (isParallelUnit(unit, options, engine))
+      {
+         popUnit(unit);
+         error = executeParallelUnit(unit, ctx, docQueue->workingDir(),
+               options);
+         if (error)
+            LOG_ERROR(error);
+         return executeNextUnit(mode);
+      }
+
       if (engine == "r")
       {
          // establish execution context unless we're an inline chunk
@@ -744,6 +758,8 @@ void onConsolePrompt(const std::string& prompt)
 
 void onUserInterrupt()
 {
+   interruptParallelExec();
+
    if (s_queue)
    {
       s_queue->clear();
@@ -31,6 +31,7 @@
 
 #include <core/FileSerializer.hpp>
 #include <core/Exec.hpp>
+#include <core/Hash.hpp>
 #include <core/system/Environment.hpp>
 #include <core/system/Process.hpp>
 #include <core/StringUtils.hpp>
@@ -515,9 +516,37 @@ private:
          renderOptions = "render_args = list(" + renderOptions + ")";
       }
 
+      // when the user has opted in to the preview render cache, enable
+      // knitr's chunk-level cache in a persistent per-document location;
+      // knitr keys cached chunks by their code and declared dependencies, so
+      // re-rendering after prose-only edits skips chunk re-execution
+      std::string cachePrefix;
+      if (prefs::userPrefs().rmdPreviewRenderCache() &&
+          !isShiny_ &&
+          renderFunc == kStandardRenderFunc)
+      {
+         FilePath cachePath = module_context::userScratchPath()
+            .completeChildPath("render-cache")
+            .completeChildPath(core::hash::crc32HexHash(
+               targetFile_.getAbsolutePath()));
+         error = cachePath.ensureDirectory();
+         if (error)
+         {
+            LOG_ERROR(error);
+         }
+         else
+         {
+            cachePrefix = "knitr::opts_chunk$set(cache = TRUE, "
+               "cache.path = '" +
+               string_utils::singleQuotedStrEscape(
+                  utf8ToConsole(cachePath.getAbsolutePath())) + "/'); ";
+         }
+      }
+
       // render command
-      boost::format fmt("%1%('%2%', %3% %4%);");
+      boost::format fmt("%1%%2%('%3%', %4% %5%);");
       std::string cmd = boost::str(fmt %
+                             cachePrefix %
                              renderFunc %
                              string_utils::singleQuotedStrEscape(targetFile) %
                              extraParams %
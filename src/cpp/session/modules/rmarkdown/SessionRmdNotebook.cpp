@@ -18,6 +18,7 @@
 #include "NotebookPlotReplay.hpp"
 #include "NotebookCache.hpp"
 #include "NotebookChunkDefs.hpp"
+#include "NotebookChunkPlan.hpp"
 #include "NotebookData.hpp"
 #include "NotebookOutput.hpp"
 #include "NotebookHtmlWidgets.hpp"
@@ -236,6 +237,7 @@ Error initialize()
       (bind(initQueue))
       (bind(initAlternateEngines))
       (bind(initChunkDefs))
+      (bind(initChunkPlan))
       (bind(initConditions));
 
    return initBlock.execute();
@@ -18,6 +18,8 @@
 #include "ShinyAsyncJob.hpp"
 #include "../SessionShinyViewer.hpp"
 
+#include <core/FileSerializer.hpp>
+
 #include <session/jobs/JobsApi.hpp>
 
 #include <session/SessionUrlPorts.hpp>
@@ -31,14 +33,21 @@ namespace session {
 namespace modules { 
 namespace shiny {
 
-ShinyAsyncJob::ShinyAsyncJob(const std::string& name, 
+ShinyAsyncJob::ShinyAsyncJob(const std::string& name,
       const FilePath& path,
       const std::string& viewerType,
       const std::string& runCmd):
    AsyncRJob(name),
    path_(path),
    viewerType_(viewerType),
-   runCmd_(runCmd)
+   runCmd_(runCmd),
+   warm_(false)
+{
+}
+
+ShinyAsyncJob::ShinyAsyncJob():
+   AsyncRJob(std::string()),
+   warm_(false)
 {
 }
 
@@ -63,6 +72,81 @@ void ShinyAsyncJob::start()
    onStdout("=> " + runCmd_ + "\n\n");
 }
 
+void ShinyAsyncJob::startWarm()
+{
+   // path the child polls for its run command; it's handed to the
+   // child via the environment and written by run()
+   commandFile_ = module_context::tempFile("rstudio-shiny-run-", "R");
+   Error error = commandFile_.removeIfExists();
+   if (error)
+      LOG_ERROR(error);
+
+   // preload shiny, then wait for the command file to appear; sourcing
+   // it runs the app exactly as a cold start would, so by the time the
+   // user hits Run the only cost remaining is the app's own startup
+   std::string cmd(
+         "options(shiny.launch.browser = function(url) { "
+         "   cat(\"" kShinyAppStarted "\", url)"
+         "}); "
+         "try(suppressPackageStartupMessages(library(shiny)), silent = TRUE); "
+         "local({ "
+         "   f <- Sys.getenv('RSTUDIO_SHINY_RUN_FILE'); "
+         "   while (!file.exists(f)) Sys.sleep(0.05); "
+         "   source(f, echo = FALSE) "
+         "})");
+
+   core::system::Options environment;
+   core::system::setenv(&environment, "RSTUDIO_SHINY_RUN_FILE",
+                        commandFile_.getAbsolutePath());
+   warm_ = true;
+   async_r::AsyncRProcess::start(cmd.c_str(), environment, FilePath(),
+         async_r::AsyncRProcessOptions::R_PROCESS_NO_RDATA);
+}
+
+bool ShinyAsyncJob::warmReady()
+{
+   return warm_ && isRunning();
+}
+
+void ShinyAsyncJob::setApp(const std::string& name,
+      const FilePath& path,
+      const std::string& viewerType,
+      const std::string& runCmd)
+{
+   name_ = name;
+   path_ = path;
+   viewerType_ = viewerType;
+   runCmd_ = runCmd;
+}
+
+void ShinyAsyncJob::run()
+{
+   // set a status while the app starts up
+   jobs::setJobStatus(job_, "Starting");
+
+   // run from the app's parent folder for consistency with start()
+   std::string script = "setwd('" +
+         path_.getParent().getAbsolutePath() + "'); " + runCmd_;
+
+   // write the command to a temporary sibling and rename it into place
+   // so the polling child can't observe a partially written file
+   FilePath tempScript = module_context::tempFile("rstudio-shiny-cmd-", "R");
+   Error error = core::writeStringToFile(tempScript, script);
+   if (!error)
+      error = tempScript.move(commandFile_);
+   if (error)
+   {
+      // unable to hand the app to the warm child; shut it down (the
+      // job will be marked failed by the completion handler)
+      LOG_ERROR(error);
+      terminate();
+      return;
+   }
+
+   // echo the command we submitted to R
+   onStdout("=> " + runCmd_ + "\n\n");
+}
+
 void ShinyAsyncJob::enqueueStateEvent(const std::string& state)
 {
    json::Object dataJson;
@@ -101,6 +185,10 @@ void ShinyAsyncJob::onStdout(const std::string& output)
 
 void ShinyAsyncJob::onCompleted(int exitStatus)
 {
+   // a warm child which was never handed an app has no associated job
+   if (!job_)
+      return;
+
    if (exitStatus == 0)
    {
       setJobState(job_, jobs::JobState::JobSucceeded);
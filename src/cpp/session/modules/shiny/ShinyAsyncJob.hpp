@@ -27,11 +27,34 @@ class ShinyAsyncJob : public jobs::AsyncRJob
 {
 public:
    ShinyAsyncJob(const std::string& name,
-         const core::FilePath& path, 
-         const std::string& viewerType, 
+         const core::FilePath& path,
+         const std::string& viewerType,
          const std::string& runCmd);
+
+   // creates a warm job: the R child is launched ahead of time (with
+   // the shiny package preloaded) and waits for an app to run; see
+   // startWarm/setApp/run
+   ShinyAsyncJob();
+
    void start();
 
+   // launch the pre-initialized R child (no job is registered yet)
+   void startWarm();
+
+   // whether the pre-initialized child is still alive and waiting
+   bool warmReady();
+
+   // supply the app for a warm child to run; must be called before the
+   // job is registered (the job name is derived from the app)
+   void setApp(const std::string& name,
+         const core::FilePath& path,
+         const std::string& viewerType,
+         const std::string& runCmd);
+
+   // hand the app to the waiting warm child (counterpart of start()
+   // for jobs created with the warm constructor)
+   void run();
+
 private:
    void enqueueStateEvent(const std::string& state);
    void onStdout(const std::string& output);
@@ -41,6 +64,10 @@ private:
    std::string viewerType_;
    std::string runCmd_;
    std::string url_;
+
+   // warm-start support
+   bool warm_;
+   core::FilePath commandFile_;
 };
                       
 } // namespace shiny
@@ -736,6 +736,8 @@ private:
       options.fileLineError = false;
       options.syncTex = !isTargetRnw() || !concordances.empty();
       options.shellEscape = prefs::userPrefs().latexShellEscape();
+      options.precompilePreamble =
+                        pdflatex::precompilePreambleEnabled(magicComments_);
 
       // get back-end version info
       core::system::ProcessResult result;
@@ -20,6 +20,7 @@
 #include <boost/regex.hpp>
 #include <boost/algorithm/string.hpp>
 
+#include <core/Hash.hpp>
 #include <core/system/Environment.hpp>
 #include <core/FileSerializer.hpp>
 
@@ -247,6 +248,143 @@ bool logIncludesRerun(const FilePath& logFilePath)
    return logContents.find("Rerun to get") != std::string::npos;
 }
 
+// precompiled preamble support. the mylatexformat package can dump
+// everything up to \begin{document} into a latex format file which
+// subsequent compiles then load via -fmt, skipping preamble processing
+// entirely (for package-heavy documents the preamble dominates compile
+// time). the dump is re-generated whenever the preamble text or the
+// latex program changes
+
+bool mylatexformatInstalled()
+{
+   // probe for the package once per session
+   static int s_installed = -1;
+   if (s_installed == -1)
+   {
+      s_installed = 0;
+      FilePath kpsewhichPath = module_context::findProgram("kpsewhich");
+      if (!kpsewhichPath.isEmpty())
+      {
+         core::system::ProcessResult result;
+         Error error = core::system::runProgram(
+            string_utils::utf8ToSystem(kpsewhichPath.getAbsolutePath()),
+            core::shell_utils::ShellArgs() << "mylatexformat.ltx",
+            "",
+            core::system::ProcessOptions(),
+            &result);
+         if (error)
+            LOG_ERROR(error);
+         else if (result.exitStatus == EXIT_SUCCESS)
+            s_installed = 1;
+      }
+   }
+   return s_installed == 1;
+}
+
+std::string readPreamble(const FilePath& texFilePath)
+{
+   std::vector<std::string> lines;
+   Error error = core::readStringVectorFromFile(texFilePath, &lines);
+   if (error)
+   {
+      LOG_ERROR(error);
+      return std::string();
+   }
+
+   std::string preamble;
+   for (const std::string& line : lines)
+   {
+      if (line.find("\\begin{document}") != std::string::npos)
+         return preamble;
+      preamble += line + "\n";
+   }
+
+   // no \begin{document} -- not a standalone document
+   return std::string();
+}
+
+shell_utils::ShellArgs precompiledPreambleArgs(const FilePath& texProgramPath,
+                                               const FilePath& texFilePath,
+                                               const PdfLatexOptions& options)
+{
+   shell_utils::ShellArgs noArgs;
+
+   // MiKTeX manages format files centrally rather than searching the
+   // working directory, so restrict this to TeX Live style distros
+   if (options.isMikTeX() || !mylatexformatInstalled())
+      return noArgs;
+
+   // extract the preamble (bail if there isn't one)
+   std::string preamble = readPreamble(texFilePath);
+   if (preamble.empty())
+      return noArgs;
+
+   // fingerprint the preamble against the program and version used to
+   // dump it (a format file is only valid for the engine that wrote it)
+   std::string fingerprint = hash::hash64Hash(
+            texProgramPath.getAbsolutePath() + "\n" +
+            options.versionInfo + "\n" +
+            preamble);
+
+   // determine format and fingerprint file paths
+   std::string formatName = texFilePath.getStem() + "-preamble";
+   FilePath formatPath = texFilePath.getParent().completeChildPath(
+                                                   formatName + ".fmt");
+   FilePath fingerprintPath = texFilePath.getParent().completeChildPath(
+                                                   formatName + ".hash");
+
+   // re-use the existing dump if it's still valid
+   std::string previousFingerprint;
+   if (formatPath.exists() && fingerprintPath.exists())
+   {
+      Error error = core::readStringFromFile(fingerprintPath,
+                                             &previousFingerprint);
+      if (error)
+         LOG_ERROR(error);
+   }
+
+   if (previousFingerprint != fingerprint)
+   {
+      // dump the preamble into a format file
+      shell_utils::ShellArgs dumpArgs;
+      dumpArgs << "-ini"
+               << "-interaction=batchmode"
+               << "-jobname=" + formatName
+               << "&" + texProgramPath.getStem()
+               << "mylatexformat.ltx";
+
+      core::system::ProcessResult result;
+      Error error = utils::runTexCompile(texProgramPath,
+                                         utils::rTexInputsEnvVars(),
+                                         dumpArgs,
+                                         texFilePath,
+                                         &result);
+      if (error)
+         LOG_ERROR(error);
+
+      if (error || result.exitStatus != EXIT_SUCCESS || !formatPath.exists())
+      {
+         // fall back to a full compile (and don't leave a stale
+         // fingerprint behind)
+         Error removeError = fingerprintPath.removeIfExists();
+         if (removeError)
+            LOG_ERROR(removeError);
+         return noArgs;
+      }
+
+      error = core::writeStringToFile(fingerprintPath, fingerprint);
+      if (error)
+      {
+         LOG_ERROR(error);
+         return noArgs;
+      }
+   }
+
+   shell_utils::ShellArgs args;
+   args << "-fmt=" + formatName;
+   return args;
+}
+
 } // anonymous namespace
 
 const char * const kFileLineErrorOption = "-file-line-error";
@@ -343,6 +481,22 @@ bool latexProgramForFile(const core::tex::TexMagicComments& magicComments,
    }
 }
 
+bool precompilePreambleEnabled(
+                     const core::tex::TexMagicComments& magicComments)
+{
+   for (const core::tex::TexMagicComment& mc : magicComments)
+   {
+      if (boost::algorithm::iequals(mc.scope(), "tex") &&
+          boost::algorithm::iequals(mc.variable(), "precompile-preamble"))
+      {
+         return boost::algorithm::iequals(mc.value(), "true") ||
+                boost::algorithm::iequals(mc.value(), "yes");
+      }
+   }
+
+   return false;
+}
+
 // this function provides an "emulated" version of texi2dvi for when the
 // user has texi2dvi disabled. For example to workaround this bug:
 //
@@ -375,10 +529,18 @@ core::Error texToPdf(const core::FilePath& texProgramPath,
    procOptions.environment = utils::rTexInputsEnvVars();
    procOptions.workingDir = texFilePath.getParent();
 
+   // compute latex args (optionally compiling against a precompiled
+   // preamble dump)
+   shell_utils::ShellArgs latexArgs = shellArgs(options);
+   if (options.precompilePreamble)
+      latexArgs << precompiledPreambleArgs(texProgramPath,
+                                           texFilePath,
+                                           options);
+
    // run the initial compile
    Error error = utils::runTexCompile(texProgramPath,
                                       utils::rTexInputsEnvVars(),
-                                      shellArgs(options),
+                                      latexArgs,
                                       texFilePath,
                                       pResult);
    if (error)
@@ -388,6 +550,13 @@ core::Error texToPdf(const core::FilePath& texProgramPath,
    int misses = countCitationMisses(logFilePath);
    int previousMisses = 0;
 
+   // if the first pass resolved everything (no citation misses, no
+   // index, and no rerun requested in the log) then we're done -- this
+   // is the common case when iterating on a document whose aux files
+   // are already up to date
+   if (misses == 0 && !idxFilePath.exists() && !logIncludesRerun(logFilePath))
+      return Success();
+
    // resolve citation misses and index
    for (int i=0; i<10; i++)
    {
@@ -426,7 +595,7 @@ core::Error texToPdf(const core::FilePath& texProgramPath,
       // re-run latex
       Error error = utils::runTexCompile(texProgramPath,
                                          utils::rTexInputsEnvVars(),
-                                         shellArgs(options),
+                                         latexArgs,
                                          texFilePath,
                                          pResult);
       if (error)
@@ -56,7 +56,8 @@ extern const char * const kSynctexOption;
 struct PdfLatexOptions
 {
    PdfLatexOptions()
-      : fileLineError(false), syncTex(false), shellEscape(false)
+      : fileLineError(false), syncTex(false), shellEscape(false),
+        precompilePreamble(false)
    {
    }
 
@@ -68,6 +69,7 @@ struct PdfLatexOptions
    bool fileLineError;
    bool syncTex;
    bool shellEscape;
+   bool precompilePreamble;
    std::string versionInfo;
 };
 
@@ -84,6 +86,9 @@ bool latexProgramForFile(const core::tex::TexMagicComments& magicComments,
                          core::FilePath* pTexProgramPath,
                          std::string* pUserErrMsg);
 
+bool precompilePreambleEnabled(
+                         const core::tex::TexMagicComments& magicComments);
+
 } // namespace pdflatex
 } // namespace tex
 } // namespace modules
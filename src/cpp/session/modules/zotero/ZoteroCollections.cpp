@@ -71,6 +71,19 @@ struct IndexedCollection
    std::string file;
 };
 
+// in-memory memo of the on-disk cache index, validated by write time
+// and size. a single citation operation consults the index several
+// times (once per collection spec plus once per collection read), and
+// each consult used to re-read and re-parse the INDEX file from disk
+struct MemoizedIndex
+{
+   std::time_t lastWriteTime;
+   uintmax_t size;
+   std::map<std::string,IndexedCollection> index;
+};
+
+std::map<std::string,MemoizedIndex> s_indexMemo;
+
 std::map<std::string,IndexedCollection> collectionsCacheIndex(const FilePath& cacheDir)
 {
    std::map<std::string,IndexedCollection> index;
@@ -78,6 +91,18 @@ std::map<std::string,IndexedCollection> collectionsCacheIndex(const FilePath& ca
    FilePath indexFile = cacheDir.completeChildPath(kIndexFile);
    if (indexFile.exists())
    {
+      // serve from the memo when the file on disk is unchanged
+      std::string memoKey = indexFile.getAbsolutePath();
+      std::time_t lastWriteTime = indexFile.getLastWriteTime();
+      uintmax_t size = indexFile.getSize();
+      std::map<std::string,MemoizedIndex>::const_iterator memoIt = s_indexMemo.find(memoKey);
+      if (memoIt != s_indexMemo.end() &&
+          memoIt->second.lastWriteTime == lastWriteTime &&
+          memoIt->second.size == size)
+      {
+         return memoIt->second.index;
+      }
+
       std::string indexContents;
       Error error = core::readStringFromFile(indexFile, &indexContents);
       if (!error)
@@ -94,6 +119,12 @@ std::map<std::string,IndexedCollection> collectionsCacheIndex(const FilePath& ca
                coll.file = entryJson[kFile].getString();
                index.insert(std::make_pair(member.getName(),coll));
             });
+
+            MemoizedIndex memo;
+            memo.lastWriteTime = lastWriteTime;
+            memo.size = size;
+            memo.index = index;
+            s_indexMemo[memoKey] = memo;
          }
       }
 
@@ -120,11 +151,46 @@ void updateCollectionsCacheIndex(const FilePath& cacheDir, const std::map<std::s
    FilePath indexFile = cacheDir.completeChildPath(kIndexFile);
    Error error = core::writeStringToFile(indexFile, indexJson.writeFormatted());
    if (error)
+   {
       LOG_ERROR(error);
+      return;
+   }
+
+   // refresh the memo to match what we just wrote
+   MemoizedIndex memo;
+   memo.lastWriteTime = indexFile.getLastWriteTime();
+   memo.size = indexFile.getSize();
+   memo.index = index;
+   s_indexMemo[indexFile.getAbsolutePath()] = memo;
 }
 
+// in-memory memo of parsed collection files, validated like the index
+// memo above. large libraries parse to multi-megabyte item arrays, so
+// re-parsing on every picker operation is what made 20k-item libraries
+// feel sluggish; copying the already parsed items is much cheaper
+struct MemoizedCollection
+{
+   std::time_t lastWriteTime;
+   uintmax_t size;
+   ZoteroCollection collection;
+};
+
+std::map<std::string,MemoizedCollection> s_collectionMemo;
+
 Error readCollection(const FilePath& filePath, ZoteroCollection* pCollection)
 {
+   std::string memoKey = filePath.getAbsolutePath();
+   std::time_t lastWriteTime = filePath.getLastWriteTime();
+   uintmax_t size = filePath.getSize();
+   std::map<std::string,MemoizedCollection>::const_iterator memoIt = s_collectionMemo.find(memoKey);
+   if (memoIt != s_collectionMemo.end() &&
+       memoIt->second.lastWriteTime == lastWriteTime &&
+       memoIt->second.size == size)
+   {
+      *pCollection = memoIt->second.collection;
+      return Success();
+   }
+
    std::string cacheContents;
    Error error = core::readStringFromFile(filePath, &cacheContents);
    if (error)
@@ -139,6 +205,16 @@ Error readCollection(const FilePath& filePath, ZoteroCollection* pCollection)
    pCollection->version = collectionJson[kVersion].getInt();
    pCollection->items = collectionJson[kItems].getArray();
 
+   // store in the memo (bound the number of entries; items arrays can
+   // be large and most users work against a handful of collections)
+   if (s_collectionMemo.size() >= 10)
+      s_collectionMemo.clear();
+   MemoizedCollection memo;
+   memo.lastWriteTime = lastWriteTime;
+   memo.size = size;
+   memo.collection = *pCollection;
+   s_collectionMemo[memoKey] = memo;
+
    return Success();
 }
 
@@ -75,10 +75,57 @@ bool prefsFileFilter(const core::FilePath& prefsFile, const core::FileInfo& file
 
 
 PrefLayer::PrefLayer(const std::string& layerName):
-   layerName_(layerName)
+   layerName_(layerName),
+   batchDepth_(0)
 {
 }
 
+void PrefLayer::beginBatch()
+{
+   RECURSIVE_LOCK_MUTEX(mutex_)
+   {
+      ++batchDepth_;
+   }
+   END_LOCK_MUTEX
+}
+
+Error PrefLayer::endBatch()
+{
+   std::set<std::string> changed;
+   RECURSIVE_LOCK_MUTEX(mutex_)
+   {
+      if (batchDepth_ == 0)
+      {
+         // Unbalanced endBatch; nothing to commit
+         return Success();
+      }
+
+      if (--batchDepth_ > 0)
+      {
+         // Still inside an enclosing batch; the outermost endBatch commits
+         return Success();
+      }
+
+      changed.swap(batchChanged_);
+   }
+   END_LOCK_MUTEX
+
+   if (changed.empty())
+      return Success();
+
+   // Commit all of the batched writes with a single serialization
+   // (writePrefs does its own mutex locking)
+   Error error = writePrefs(*cache_);
+
+   // Notify listeners of each value changed during the batch
+   for (const std::string& name: changed)
+   {
+      onChanged(name);
+   }
+
+   return error;
+}
+
 PrefLayer::~PrefLayer()
 {
    destroy();
@@ -64,6 +64,9 @@ core::Error Preferences::readLayers()
             LOG_ERROR(error);
          }
       }
+
+      // All layers were re-read, so any resolved values may be stale
+      invalidateCachedPrefs();
    }
    END_LOCK_MUTEX
    return Success();
@@ -186,6 +189,12 @@ core::Error Preferences::writeLayer(int layer, const core::json::Object& prefs)
 
       // Commit new prefs
       result = layers_[layer]->writePrefs(newPrefs);
+
+      // Drop cached resolved values for everything that changed
+      for (const auto& prefName: changed)
+      {
+         invalidateCachedPref(prefName);
+      }
    }
    END_LOCK_MUTEX;
 
@@ -275,6 +284,52 @@ core::Error Preferences::writeValue(const std::string& name, const core::json::V
    return result;
 }
 
+core::Error Preferences::writeValues(const core::json::Object& values,
+                                     std::set<std::string>* pChanged)
+{
+   Error result;
+   RECURSIVE_LOCK_MUTEX(mutex_)
+   {
+      auto layer = layers_[userLayer()];
+      if (!layer)
+      {
+         core::Error error(core::json::errc::ParamMissing, ERROR_LOCATION);
+         error.addProperty("description", "missing user layer for preference values");
+         return error;
+      }
+
+      // Apply all of the values inside a layer batch so they are serialized
+      // to disk once; the layer emits change notifications when the batch
+      // is committed
+      layer->beginBatch();
+      for (const auto pref: values)
+      {
+         // Skip values that already match
+         const auto val = layer->readValue(pref.getName());
+         if (val && *val == pref.getValue())
+            continue;
+
+         Error error = layer->writePref(pref.getName(), pref.getValue());
+         if (error)
+         {
+            if (!result)
+               result = error;
+            continue;
+         }
+
+         if (pChanged != nullptr)
+            pChanged->insert(pref.getName());
+      }
+
+      Error error = layer->endBatch();
+      if (error && !result)
+         result = error;
+   }
+   END_LOCK_MUTEX
+
+   return result;
+}
+
 core::json::Object Preferences::userPrefLayer()
 {
    core::json::Object layer;
@@ -292,6 +347,10 @@ Error Preferences::clearValue(const std::string &name)
    RECURSIVE_LOCK_MUTEX(mutex_)
    {
       result = layers_[userLayer()]->clearValue(name);
+
+      // The layer doesn't emit a change notification for cleared values,
+      // so drop the cached resolved value here
+      invalidateCachedPref(name);
    }
    END_LOCK_MUTEX
    return result;
@@ -326,9 +385,31 @@ json::Object Preferences::getLayer(const std::string& name)
 
 void Preferences::onPrefLayerChanged(const std::string& layerName, const std::string& prefName)
 {
+   // The pref changed in one of the layers, so the cached resolved value
+   // (if any) can no longer be trusted
+   invalidateCachedPref(prefName);
+
    onChanged(layerName, prefName);
 }
 
+void Preferences::invalidateCachedPref(const std::string& name)
+{
+   RECURSIVE_LOCK_MUTEX(mutex_)
+   {
+      prefCache_.erase(name);
+   }
+   END_LOCK_MUTEX
+}
+
+void Preferences::invalidateCachedPrefs()
+{
+   RECURSIVE_LOCK_MUTEX(mutex_)
+   {
+      prefCache_.clear();
+   }
+   END_LOCK_MUTEX
+}
+
 void Preferences::notifyClient(const std::string &layerName, const std::string &pref)
 {
    // No work to do unless there's a client event to emit
@@ -369,6 +450,47 @@ void Preferences::notifyClient(const std::string &layerName, const std::string &
    }
 }
 
+void Preferences::notifyClient(const std::string& layerName,
+                               const std::set<std::string>& prefs)
+{
+   // No work to do unless there's a client event to emit
+   int eventId = clientChangedEvent();
+   if (eventId < 1 || prefs.empty())
+      return;
+
+   // Collect the current values of all the named prefs from the layer
+   json::Object valueJson;
+   RECURSIVE_LOCK_MUTEX(mutex_)
+   {
+      for (auto layer: layers_)
+      {
+         if (layer->layerName() == layerName)
+         {
+            for (const std::string& pref: prefs)
+            {
+               auto val = layer->readValue(pref);
+               if (val)
+                  valueJson[pref] = *val;
+            }
+         }
+      }
+   }
+   END_LOCK_MUTEX
+
+   if (valueJson.isEmpty())
+   {
+      LOG_WARNING_MESSAGE("None of the changed prefs exist in layer '" + layerName + "'");
+      return;
+   }
+
+   // Emit a single event carrying all of the changed values
+   json::Object dataJson;
+   dataJson["name"] = layerName;
+   dataJson["values"] = valueJson;
+   ClientEvent event(eventId, dataJson);
+   module_context::enqueClientEvent(event);
+}
+
 } // namespace prefs
 } // namespace session
 } // namespace rstudio
@@ -1778,6 +1778,19 @@ core::Error UserPrefValues::setShowRmdRenderCommand(bool val)
    return writePref("show_rmd_render_command", val);
 }
 
+/**
+ * Whether to cache chunk output across R Markdown preview renders so that unchanged chunks are not re-executed.
+ */
+bool UserPrefValues::rmdPreviewRenderCache()
+{
+   return readPref<bool>("rmd_preview_render_cache");
+}
+
+core::Error UserPrefValues::setRmdPreviewRenderCache(bool val)
+{
+   return writePref("rmd_preview_render_cache", val);
+}
+
 /**
  * Whether to enable moving text on the editing surface by clicking and dragging it.
  */
@@ -2839,6 +2852,7 @@ std::vector<std::string> UserPrefValues::allKeys()
       kTerminalBellStyle,
       kTerminalRenderer,
       kShowRmdRenderCommand,
+      kRmdPreviewRenderCache,
       kEnableTextDrag,
       kShowHiddenFiles,
       kSortFileNamesNaturally,
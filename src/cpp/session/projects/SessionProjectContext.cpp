@@ -500,6 +500,11 @@ void ProjectContext::onDeferredInit(bool newSession)
       onDescriptionChanged();
 
    // kickoff file monitoring for this directory
+   startFileMonitor();
+}
+
+void ProjectContext::startFileMonitor()
+{
    using boost::bind;
    core::system::file_monitor::Callbacks cb;
    cb.onRegistered = bind(&ProjectContext::fileMonitorRegistered,
@@ -510,13 +515,15 @@ void ProjectContext::onDeferredInit(bool newSession)
                                this, _1);
    cb.onFilesChanged = bind(&ProjectContext::fileMonitorFilesChanged,
                             this, _1);
+   cb.onEventStorm = bind(&ProjectContext::fileMonitorEventStorm,
+                          this);
    cb.onUnregistered = bind(&ProjectContext::fileMonitorTermination,
                             this, Success());
 
    FileMonitorFilterContext context;
    context.ignoreObjectFiles = prefs::userPrefs().hideObjectFiles();
    context.ignoredComponents = fileMonitorIgnoredComponents();
-   
+
    core::system::file_monitor::registerMonitor(
          directory(),
          true,
@@ -530,6 +537,7 @@ void ProjectContext::fileMonitorRegistered(
 {
    // update state
    hasFileMonitor_ = true;
+   fileMonitorHandle_ = handle;
 
    // notify subscribers
    onMonitoringEnabled_(files);
@@ -548,6 +556,20 @@ void ProjectContext::fileMonitorFilesChanged(
    onFilesChanged_(events);
 }
 
+void ProjectContext::fileMonitorEventStorm()
+{
+   // a bulk operation (e.g. git checkout, archive extraction) generated more
+   // events than are worth processing individually. restart monitoring so
+   // that subscribers re-baseline from a single fresh scan of the project
+   // (the scan occurs on the monitoring thread; subscribers see a normal
+   // disable/enable cycle)
+   if (hasFileMonitor_)
+   {
+      core::system::file_monitor::unregisterMonitor(fileMonitorHandle_);
+      startFileMonitor();
+   }
+}
+
 void ProjectContext::fileMonitorTermination(const Error& error)
 {
    // always log error
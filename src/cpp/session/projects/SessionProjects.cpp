@@ -231,6 +231,7 @@ Error initializeProjectFromTemplate(const FilePath& projectFilePath,
 }
 
 Error createProject(const json::JsonRpcRequest& request,
+                    const module_context::PreemptibleRpcToken& token,
                     json::JsonRpcResponse* pResponse)
 {
    // read params
@@ -247,6 +248,8 @@ Error createProject(const json::JsonRpcRequest& request,
       return error;
    FilePath projectFilePath = module_context::resolveAliasedPath(projectFile);
 
+   token.reportProgress(1, 3);
+
    // Shiny application
    if (!newShinyAppJson.isNull())
    {
@@ -287,7 +290,9 @@ Error createProject(const json::JsonRpcRequest& request,
       
    }
    
-   // if we have a custom project template, call that first
+   // if we have a custom project template, call that first -- this is the
+   // long phase (the template's skeleton function materializes the whole
+   // project), so let the client show progress around it
    if (!projectTemplateOptions.isNull() &&
        json::isType<json::Object>(projectTemplateOptions))
    {
@@ -295,12 +300,16 @@ Error createProject(const json::JsonRpcRequest& request,
       if (error)
          return error;
    }
-   
+
+   token.reportProgress(2, 3);
+
    // default project scaffolding
    error = projectFilePath.getParent().ensureDirectory();
    if (error)
       return error;
 
+   token.reportProgress(3, 3);
+
    std::string existingProjectFilePath;
    if (!findProjectFile(projectFilePath.getParent().getAbsolutePath(), &existingProjectFilePath))
    {
@@ -994,7 +1003,7 @@ Error initialize()
       (bind(registerRpcMethod, "validate_project_path", validateProjectPath))
       (bind(registerRpcMethod, "get_new_project_context", getNewProjectContext))
       (bind(registerRpcMethod, "get_project_file_path", getProjectFilePath))
-      (bind(registerRpcMethod, "create_project", createProject))
+      (bind(registerPreemptibleRpcMethod, "create_project", createProject))
       (bind(registerRpcMethod, "create_project_file", createProjectFile))
       (bind(registerRpcMethod, "read_project_options", readProjectOptions))
       (bind(registerRpcMethod, "write_project_options", writeProjectOptions))
@@ -24,7 +24,11 @@
 #include <shared_core/FilePath.hpp>
 
 #include <algorithm>
+#include <atomic>
+#include <cstdlib>
 #include <fstream>
+#include <mutex>
+#include <thread>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -35,6 +39,7 @@
 
 #include <shared_core/system/Win32StringUtils.hpp>
 #else
+#include <fcntl.h>
 #include <sys/stat.h>
 #include <sys/unistd.h>
 
@@ -790,6 +795,295 @@ Error FilePath::copyDirectoryRecursive(const FilePath& in_targetPath, bool overw
    return getChildrenRecursive(boost::bind(copySingleItem, *this, in_targetPath, _2, overwrite));
 }
 
+namespace {
+
+// a single file payload queued for the parallel copy engine
+struct PendingFileCopy
+{
+   FilePath source;
+   FilePath target;
+};
+
+// shared state for the parallel copy engine's worker threads
+struct ParallelCopyState
+{
+   ParallelCopyState() : nextIndex(0), bytesCopied(0), totalBytes(0), failed(false) {}
+
+   std::vector<PendingFileCopy> files;
+   std::atomic<std::size_t> nextIndex;
+   std::atomic<std::uintmax_t> bytesCopied;
+   std::uintmax_t totalBytes;
+   bool overwrite;
+
+   std::mutex mutex;
+   std::atomic<bool> failed;
+   Error firstError;
+   FilePath::CopyProgressFunction progress;
+
+   void recordError(const Error& error)
+   {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!firstError)
+         firstError = error;
+      failed = true;
+   }
+
+   void recordProgress(std::uintmax_t bytes)
+   {
+      bytesCopied += bytes;
+      if (progress)
+      {
+         std::lock_guard<std::mutex> lock(mutex);
+         progress(bytesCopied, totalBytes);
+      }
+   }
+};
+
+#ifndef _WIN32
+
+// copy a single file's payload: copy_file_range first (which enables
+// reflinks and filesystem/server-side copy where supported), falling
+// back to a read/write loop with a large page-aligned buffer
+Error copyFilePayload(const FilePath& source,
+                      const FilePath& target,
+                      bool overwrite,
+                      ParallelCopyState* pState)
+{
+   static const std::size_t kBufferSize = 1 << 20; // 1MB
+
+   int srcFd = ::open(source.getAbsolutePathNative().c_str(), O_RDONLY);
+   if (srcFd == -1)
+   {
+      Error error = systemError(errno, ERROR_LOCATION);
+      error.addProperty("path", source.getAbsolutePath());
+      return error;
+   }
+
+   struct stat st;
+   if (::fstat(srcFd, &st) == -1)
+   {
+      Error error = systemError(errno, ERROR_LOCATION);
+      error.addProperty("path", source.getAbsolutePath());
+      ::close(srcFd);
+      return error;
+   }
+
+   int flags = O_WRONLY | O_CREAT | (overwrite ? O_TRUNC : O_EXCL);
+   int dstFd = ::open(target.getAbsolutePathNative().c_str(),
+                      flags,
+                      st.st_mode & 07777);
+   if (dstFd == -1)
+   {
+      Error error = systemError(errno, ERROR_LOCATION);
+      error.addProperty("path", target.getAbsolutePath());
+      ::close(srcFd);
+      return error;
+   }
+
+   Error error;
+
+#if defined(__linux__) && defined(__GLIBC__) && __GLIBC_PREREQ(2, 27)
+   bool copyRangeSupported = true;
+   while (copyRangeSupported)
+   {
+      ssize_t copied = ::copy_file_range(srcFd, nullptr, dstFd, nullptr,
+                                         kBufferSize * 8, 0);
+      if (copied == -1)
+      {
+         // not supported for this pair of files (e.g. cross-filesystem on
+         // older kernels) -- fall back to the buffered loop
+         if (errno == EINVAL || errno == EXDEV ||
+             errno == ENOSYS || errno == EOPNOTSUPP)
+         {
+            copyRangeSupported = false;
+            break;
+         }
+
+         error = systemError(errno, ERROR_LOCATION);
+         error.addProperty("path", source.getAbsolutePath());
+         error.addProperty("target-path", target.getAbsolutePath());
+         break;
+      }
+
+      if (copied == 0)
+      {
+         ::close(srcFd);
+         ::close(dstFd);
+         return Success();
+      }
+
+      pState->recordProgress(copied);
+   }
+
+   if (error)
+   {
+      ::close(srcFd);
+      ::close(dstFd);
+      return error;
+   }
+#endif
+
+   void* buffer = nullptr;
+   if (::posix_memalign(&buffer, 4096, kBufferSize) != 0)
+   {
+      ::close(srcFd);
+      ::close(dstFd);
+      return systemError(ENOMEM, ERROR_LOCATION);
+   }
+
+   while (true)
+   {
+      ssize_t bytesRead = ::read(srcFd, buffer, kBufferSize);
+      if (bytesRead == 0)
+         break;
+
+      if (bytesRead == -1)
+      {
+         if (errno == EINTR)
+            continue;
+         error = systemError(errno, ERROR_LOCATION);
+         error.addProperty("path", source.getAbsolutePath());
+         break;
+      }
+
+      char* pData = static_cast<char*>(buffer);
+      ssize_t bytesRemaining = bytesRead;
+      while (bytesRemaining > 0)
+      {
+         ssize_t bytesWritten = ::write(dstFd, pData, bytesRemaining);
+         if (bytesWritten == -1)
+         {
+            if (errno == EINTR)
+               continue;
+            error = systemError(errno, ERROR_LOCATION);
+            error.addProperty("target-path", target.getAbsolutePath());
+            break;
+         }
+         pData += bytesWritten;
+         bytesRemaining -= bytesWritten;
+      }
+
+      if (error)
+         break;
+
+      pState->recordProgress(bytesRead);
+   }
+
+   ::free(buffer);
+   ::close(srcFd);
+   ::close(dstFd);
+   return error;
+}
+
+#else
+
+Error copyFilePayload(const FilePath& source,
+                      const FilePath& target,
+                      bool overwrite,
+                      ParallelCopyState* pState)
+{
+   // no copy_file_range equivalent here -- workers still parallelize the
+   // per-file boost copies
+   Error error = source.copy(target, overwrite);
+   if (!error)
+      pState->recordProgress(source.getSize());
+   return error;
+}
+
+#endif
+
+void parallelCopyWorker(ParallelCopyState* pState)
+{
+   while (!pState->failed)
+   {
+      std::size_t index = pState->nextIndex++;
+      if (index >= pState->files.size())
+         return;
+
+      const PendingFileCopy& pending = pState->files[index];
+      Error error = copyFilePayload(pending.source,
+                                    pending.target,
+                                    pState->overwrite,
+                                    pState);
+      if (error)
+         pState->recordError(error);
+   }
+}
+
+} // anonymous namespace
+
+Error FilePath::copyRecursiveParallel(const FilePath& in_targetPath,
+                                      bool in_overwrite,
+                                      int in_maxWorkers,
+                                      const CopyProgressFunction& in_progress) const
+{
+   ParallelCopyState state;
+   state.overwrite = in_overwrite;
+   state.progress = in_progress;
+
+   if (!isDirectory())
+   {
+      // single file -- still benefits from the payload fast path
+      state.files.push_back(PendingFileCopy { *this, in_targetPath });
+      state.totalBytes = getSize();
+   }
+   else
+   {
+      Error error = in_targetPath.ensureDirectory();
+      if (error)
+         return error;
+
+      // replicate the directory structure up front and queue file
+      // payloads for the workers
+      error = getChildrenRecursive(
+         [&](int, const FilePath& path)
+         {
+            std::string relativePath = path.getRelativePath(*this);
+            FilePath target = in_targetPath.completePath(relativePath);
+
+            if (path.isDirectory())
+            {
+               Error error = target.ensureDirectory();
+               if (error)
+                  log::logError(error);
+            }
+            else
+            {
+               state.files.push_back(PendingFileCopy { path, target });
+               state.totalBytes += path.getSize();
+            }
+
+            return true;
+         });
+      if (error)
+         return error;
+   }
+
+   // run the payload copies on worker threads (the calling thread also
+   // participates, so small trees don't pay for thread creation)
+   std::size_t numWorkers = std::min(
+            static_cast<std::size_t>(std::max(in_maxWorkers, 1)),
+            state.files.size());
+
+   std::vector<std::thread> workers;
+   for (std::size_t i = 1; i < numWorkers; i++)
+      workers.push_back(std::thread(parallelCopyWorker, &state));
+
+   parallelCopyWorker(&state);
+
+   for (std::thread& worker : workers)
+      worker.join();
+
+   if (state.firstError)
+      return state.firstError;
+
+   // report final progress (e.g. when everything was empty)
+   if (in_progress)
+      in_progress(state.bytesCopied, state.totalBytes);
+
+   return Success();
+}
+
 Error FilePath::createDirectory(const std::string& in_filePath) const
 {
    try
@@ -24,7 +24,12 @@
 #include <shared_core/Logger.hpp>
 
 #include <cassert>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
 #include <sstream>
+#include <thread>
+#include <vector>
 
 #include <boost/noncopyable.hpp>
 #include <boost/optional.hpp>
@@ -102,7 +107,21 @@ std::string formatLogMessage(
       using namespace boost::posix_time;
       ptime time = microsec_clock::universal_time();
 
-      oss << system::date_time::format(time, "%d %b %Y %H:%M:%S")
+      // Formatting the timestamp dominates the cost of preformatting an entry, and the format has second resolution,
+      // so reuse the last formatted value until the clock ticks over to the next second.
+      ptime timeSecs(
+         time.date(),
+         time_duration(time.time_of_day().hours(), time.time_of_day().minutes(), time.time_of_day().seconds()));
+
+      thread_local ptime s_lastTime(not_a_date_time);
+      thread_local std::string s_lastTimestamp;
+      if (timeSecs != s_lastTime)
+      {
+         s_lastTimestamp = system::date_time::format(timeSecs, "%d %b %Y %H:%M:%S");
+         s_lastTime = timeSecs;
+      }
+
+      oss << s_lastTimestamp
           << " [" << in_programId << "] ";
    }
 
@@ -122,6 +141,119 @@ std::string formatLogMessage(
    return oss.str();
 }
 
+// Asynchronous Log Writer =============================================================================================
+/**
+ * @brief Class which writes queued log entries to their destinations on a dedicated thread.
+ *
+ * When asynchronous logging is enabled, logging threads enqueue preformatted entries instead of blocking on
+ * destination I/O. The queue is bounded: entries are dropped (and the drop is reported) rather than allowing a stalled
+ * destination to grow the queue without limit.
+ */
+class AsyncLogWriter : boost::noncopyable
+{
+public:
+   AsyncLogWriter() :
+      m_enabled(false),
+      m_running(false),
+      m_writing(false),
+      m_droppedEntries(0)
+   { };
+
+   /**
+    * @brief Enables or disables asynchronous logging. Disabling drains any queued entries before returning so that
+    *        subsequent synchronous writes cannot overtake them.
+    *
+    * @param in_enabled     Whether asynchronous logging should be enabled.
+    */
+   void setEnabled(bool in_enabled)
+   {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      if (m_enabled == in_enabled)
+         return;
+
+      m_enabled = in_enabled;
+      if (in_enabled)
+      {
+         // The writer thread is started once and intentionally never joined; the logger itself is leaked for the same
+         // reason (background threads may still be logging at shutdown).
+         if (!m_running)
+         {
+            m_running = true;
+            std::thread(&AsyncLogWriter::writerThreadMain, this).detach();
+         }
+      }
+      else
+      {
+         while (!m_entries.empty() || m_writing)
+            m_drained.wait(lock);
+      }
+   }
+
+   /**
+    * @brief Enqueues an entry for the writer thread.
+    *
+    * @param in_logLevel        The log level of the entry.
+    * @param in_message         The preformatted message.
+    * @param in_destinations    The destinations to which the entry should be written.
+    *
+    * @return True if asynchronous logging is enabled and the entry was consumed; false if the caller should write the
+    *         entry synchronously.
+    */
+   bool enqueue(LogLevel in_logLevel, const std::string& in_message, const LogMap& in_destinations)
+   {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      if (!m_enabled)
+         return false;
+
+      // Bounded-drop policy: when the writer can't keep up, drop the entry and account for it rather than blocking
+      // the logging thread or growing the queue without limit.
+      if (m_entries.size() >= s_maxPendingEntries)
+      {
+         ++m_droppedEntries;
+         return true;
+      }
+
+      Entry entry;
+      entry.Level = in_logLevel;
+      entry.Message = in_message;
+      for (const auto& dest: in_destinations)
+         entry.Destinations.push_back(dest.second);
+
+      m_entries.push_back(std::move(entry));
+      m_pending.notify_one();
+      return true;
+   }
+
+private:
+   struct Entry
+   {
+      LogLevel Level;
+      std::string Message;
+      std::vector<std::shared_ptr<ILogDestination> > Destinations;
+   };
+
+   void writerThreadMain();
+
+   // The maximum number of entries which may be queued before entries are dropped.
+   static constexpr size_t s_maxPendingEntries = 2000;
+
+   std::mutex m_mutex;
+   std::condition_variable m_pending;
+   std::condition_variable m_drained;
+   std::deque<Entry> m_entries;
+   bool m_enabled;
+   bool m_running;
+   bool m_writing;
+   uint64_t m_droppedEntries;
+};
+
+AsyncLogWriter& asyncLogWriter()
+{
+   // Intentionally leaked for the same reason as the logger itself.
+   static AsyncLogWriter* writer = new AsyncLogWriter();
+   return *writer;
+}
+
 } // anonymous namespace
 
 // Logger Object =======================================================================================================
@@ -182,6 +314,50 @@ Logger& logger()
    return *logger;
 }
 
+namespace {
+
+void AsyncLogWriter::writerThreadMain()
+{
+   std::unique_lock<std::mutex> lock(m_mutex);
+   for (;;)
+   {
+      while (m_entries.empty())
+         m_pending.wait(lock);
+
+      // Take the pending entries (and the drop count) and write them with the mutex released so logging threads are
+      // never blocked behind destination I/O.
+      std::deque<Entry> entries;
+      entries.swap(m_entries);
+      uint64_t dropped = m_droppedEntries;
+      m_droppedEntries = 0;
+      m_writing = true;
+      lock.unlock();
+
+      for (const Entry& entry: entries)
+      {
+         for (const std::shared_ptr<ILogDestination>& destination: entry.Destinations)
+            destination->writeLog(entry.Level, entry.Message);
+      }
+
+      if (dropped > 0)
+      {
+         std::string message = formatLogMessage(
+            LogLevel::WARN,
+            "Dropped " + std::to_string(dropped) + " log entries because the log writer could not keep up",
+            logger().ProgramId);
+         for (const std::shared_ptr<ILogDestination>& destination: entries.back().Destinations)
+            destination->writeLog(LogLevel::WARN, message);
+      }
+
+      lock.lock();
+      m_writing = false;
+      if (m_entries.empty())
+         m_drained.notify_all();
+   }
+}
+
+} // anonymous namespace
+
 void Logger::writeMessageToDestinations(
    LogLevel in_logLevel,
    const std::string& in_message,
@@ -207,6 +383,10 @@ void Logger::writeMessageToDestinations(
    // Preformat the message for non-syslog loggers.
    std::string formattedMessage = formatLogMessage(in_logLevel, in_message, ProgramId, in_loggedFrom);
 
+   // In asynchronous mode, hand the preformatted entry to the writer thread rather than blocking on destination I/O.
+   if (asyncLogWriter().enqueue(in_logLevel, formattedMessage, *logMap))
+      return;
+
    const auto destEnd = logMap->end();
    for (auto iter = logMap->begin(); iter != destEnd; ++iter)
    {
@@ -217,6 +397,11 @@ void Logger::writeMessageToDestinations(
 }
 
 // Logging functions
+void setAsyncLogging(bool in_enabled)
+{
+   asyncLogWriter().setEnabled(in_enabled);
+}
+
 void setProgramId(const std::string& in_programId)
 {
    WRITE_LOCK_BEGIN(logger().Mutex)
@@ -79,6 +79,17 @@ enum class LogLevel
  */
 std::string cleanDelimiters(const std::string& in_str);
 
+/**
+ * @brief Enables or disables asynchronous logging.
+ *
+ * When enabled, log entries are preformatted and queued for a dedicated writer thread instead of being written to the
+ * registered destinations on the logging thread. The queue is bounded: under sustained overload entries are dropped
+ * and the drop is reported, rather than blocking callers. Disabling drains any queued entries before returning.
+ *
+ * @param in_enabled     Whether asynchronous logging should be enabled.
+ */
+void setAsyncLogging(bool in_enabled);
+
 /**
  * @brief Sets the program ID for the logger.
  *
@@ -32,6 +32,7 @@
 #include <vector>
 
 #include <boost/optional.hpp>
+#include <boost/utility/string_view.hpp>
 
 #include <shared_core/Error.hpp>
 #include <shared_core/Logger.hpp>
@@ -376,6 +377,15 @@ public:
     */
    std::string getString() const;
 
+   /**
+    * @brief Gets the value as a string without copying. The returned view borrows this value's internal storage and
+    *        is valid only while this value (or a value sharing its underlying document, such as the containing object
+    *        or array) is alive. If the call to getType() does not return Type::STRING, this method is invalid.
+    *
+    * @return The value as a borrowed string view.
+    */
+   boost::string_view getStringView() const;
+
    /**
     * @brief Gets the type of this value.
     *
@@ -1671,6 +1681,8 @@ bool isType(const Value& in_value)
       return in_value.getType() == Type::ARRAY;
    else if (std::is_same<T, std::string>::value)
       return in_value.getType() == Type::STRING;
+   else if (std::is_same<T, boost::string_view>::value)
+      return in_value.getType() == Type::STRING;
    else if (std::is_same<T, bool>::value)
       return in_value.getType() == Type::BOOL;
    else if (std::is_same<T, int>::value)
@@ -2292,6 +2304,60 @@ Error readObject(
    return readObject(in_object, io_args...);
 }
 
+/**
+ * @brief Event handler interface for streaming (SAX-style) JSON parsing.
+ *
+ * Unlike Value::parse, saxParse never materializes a document: the handler receives one callback per JSON token as the
+ * input is scanned. Handlers interested in only part of a payload may ignore events between an onStartObject/onKey and
+ * the matching onEndObject (no intermediate values are allocated for ignored events), and may stop the parse entirely
+ * by returning false from any callback.
+ */
+class SaxHandler
+{
+public:
+   /**
+    * @brief Virtual destructor for inheritance.
+    */
+   virtual ~SaxHandler() = default;
+
+   /**
+    * @brief Invoked for each scalar token in the input.
+    *
+    * @return True to continue parsing; false to stop the parse.
+    */
+   virtual bool onNull() { return true; }
+   virtual bool onBool(bool) { return true; }
+   virtual bool onInt(int) { return true; }
+   virtual bool onUint(unsigned int) { return true; }
+   virtual bool onInt64(int64_t) { return true; }
+   virtual bool onUint64(uint64_t) { return true; }
+   virtual bool onDouble(double) { return true; }
+   virtual bool onString(const char* in_value, size_t in_length) { return true; }
+
+   /**
+    * @brief Invoked for object and array structure in the input. The count parameters report the number of members or
+    *        elements which were contained.
+    *
+    * @return True to continue parsing; false to stop the parse.
+    */
+   virtual bool onStartObject() { return true; }
+   virtual bool onKey(const char* in_name, size_t in_length) { return true; }
+   virtual bool onEndObject(size_t in_memberCount) { return true; }
+   virtual bool onStartArray() { return true; }
+   virtual bool onEndArray(size_t in_elementCount) { return true; }
+};
+
+/**
+ * @brief Parses a JSON string, streaming events to the supplied handler rather than building a document.
+ *
+ * @param in_jsonStr    The JSON string to parse.
+ * @param io_handler    The handler which will receive one callback per JSON token.
+ *
+ * @return Success if in_jsonStr was valid JSON or the handler stopped the parse; Error otherwise.
+ */
+Error saxParse(const char* in_jsonStr, SaxHandler& io_handler);
+Error saxParse(const std::string& in_jsonStr, SaxHandler& io_handler);
+
 } // namespace json
 } // namespace core
 } // namespace rstudio
@@ -23,6 +23,7 @@
 
 #include <shared_core/json/Json.hpp>
 
+#include <mutex>
 #include <sstream>
 
 #include <boost/algorithm/string.hpp>
@@ -32,6 +33,7 @@
 #include <shared_core/Error.hpp>
 
 #include "shared_core/json/rapidjson/document.h"
+#include "shared_core/json/rapidjson/reader.h"
 #include "shared_core/json/rapidjson/stringbuffer.h"
 #include "shared_core/json/rapidjson/prettywriter.h"
 #include "shared_core/json/rapidjson/writer.h"
@@ -148,6 +150,70 @@ namespace {
 
 rapidjson::CrtAllocator s_allocator;
 
+// Recycles the fixed-size JsonDocument nodes which back every Value. Building or walking an RPC-sized tree churns
+// through thousands of identical allocations which are freed as soon as the tree is serialized; spent nodes are
+// instead pushed onto a free list and handed straight back to the next Value. The list is bounded so that a burst of
+// large requests does not permanently grow the process.
+class DocumentPool
+{
+public:
+   static JsonDocument* acquire()
+   {
+      void* mem = popNode();
+      if (mem == nullptr)
+         mem = ::operator new(sizeof(JsonDocument));
+      return new (mem) JsonDocument(&s_allocator);
+   }
+
+   static void release(JsonDocument* in_pDocument)
+   {
+      in_pDocument->~JsonDocument();
+      if (!pushNode(in_pDocument))
+         ::operator delete(static_cast<void*>(in_pDocument));
+   }
+
+private:
+   // Spent nodes are large enough to hold a pointer, so the free list is threaded through the nodes themselves.
+   struct FreeNode
+   {
+      FreeNode* Next;
+   };
+
+   static void* popNode()
+   {
+      std::lock_guard<std::mutex> lock(s_mutex);
+      if (s_freeList == nullptr)
+         return nullptr;
+
+      FreeNode* pNode = s_freeList;
+      s_freeList = pNode->Next;
+      --s_freeCount;
+      return pNode;
+   }
+
+   static bool pushNode(void* in_pMem)
+   {
+      std::lock_guard<std::mutex> lock(s_mutex);
+      if (s_freeCount >= kMaxFreeNodes)
+         return false;
+
+      FreeNode* pNode = static_cast<FreeNode*>(in_pMem);
+      pNode->Next = s_freeList;
+      s_freeList = pNode;
+      ++s_freeCount;
+      return true;
+   }
+
+   static const size_t kMaxFreeNodes = 8192;
+   static std::mutex s_mutex;
+   static FreeNode* s_freeList;
+   static size_t s_freeCount;
+};
+
+std::mutex DocumentPool::s_mutex;
+DocumentPool::FreeNode* DocumentPool::s_freeList = nullptr;
+size_t DocumentPool::s_freeCount = 0;
+
 Object getSchemaDefaults(const Object& schema)
 {
    Object result;
@@ -204,7 +270,7 @@ Object getSchemaDefaults(const Object& schema)
 struct Value::Impl
 {
    Impl() :
-      Document(new JsonDocument(&s_allocator))
+      Document(DocumentPool::acquire(), DocumentPool::release)
    {
    }
 
@@ -499,6 +565,12 @@ std::string Value::getString() const
    return std::string(m_impl->Document->GetString(), m_impl->Document->GetStringLength());
 }
 
+boost::string_view Value::getStringView() const
+{
+   assert(isString());
+   return boost::string_view(m_impl->Document->GetString(), m_impl->Document->GetStringLength());
+}
+
 Type Value::getType() const
 {
    switch (m_impl->Document->GetType())
@@ -589,7 +661,10 @@ Object Value::getValue<Object>() const
 template<>
 const char* Value::getValue<const char*>() const
 {
-   return getString().c_str();
+   // NOTE: borrows the value's internal storage (getString() would
+   // return a pointer into a destroyed temporary)
+   assert(isString());
+   return m_impl->Document->GetString();
 }
 
 template<>
@@ -598,6 +673,12 @@ std::string Value::getValue<std::string>() const
    return getString();
 }
 
+template<>
+boost::string_view Value::getValue<boost::string_view>() const
+{
+   return getStringView();
+}
+
 template<>
 unsigned int Value::getValue<unsigned int>() const
 {
@@ -1737,6 +1818,73 @@ bool isMissingMemberError(const Error& in_error)
            (static_cast<JsonReadError>(in_error.getCode()) == JsonReadError::MISSING_MEMBER));
 }
 
+namespace {
+
+// Bridges rapidjson's SAX handler concept (compile-time duck typing) to the virtual SaxHandler interface.
+struct SaxHandlerAdapter
+{
+   explicit SaxHandlerAdapter(SaxHandler& io_handler) :
+      Handler(io_handler)
+   {
+   }
+
+   bool Null() { return Handler.onNull(); }
+   bool Bool(bool in_value) { return Handler.onBool(in_value); }
+   bool Int(int in_value) { return Handler.onInt(in_value); }
+   bool Uint(unsigned int in_value) { return Handler.onUint(in_value); }
+   bool Int64(int64_t in_value) { return Handler.onInt64(in_value); }
+   bool Uint64(uint64_t in_value) { return Handler.onUint64(in_value); }
+   bool Double(double in_value) { return Handler.onDouble(in_value); }
+
+   bool RawNumber(const char* in_value, rapidjson::SizeType in_length, bool)
+   {
+      return Handler.onString(in_value, in_length);
+   }
+
+   bool String(const char* in_value, rapidjson::SizeType in_length, bool)
+   {
+      return Handler.onString(in_value, in_length);
+   }
+
+   bool StartObject() { return Handler.onStartObject(); }
+
+   bool Key(const char* in_name, rapidjson::SizeType in_length, bool)
+   {
+      return Handler.onKey(in_name, in_length);
+   }
+
+   bool EndObject(rapidjson::SizeType in_memberCount) { return Handler.onEndObject(in_memberCount); }
+   bool StartArray() { return Handler.onStartArray(); }
+   bool EndArray(rapidjson::SizeType in_elementCount) { return Handler.onEndArray(in_elementCount); }
+
+   SaxHandler& Handler;
+};
+
+} // anonymous namespace
+
+Error saxParse(const char* in_jsonStr, SaxHandler& io_handler)
+{
+   rapidjson::Reader reader;
+   rapidjson::StringStream stream(in_jsonStr);
+   SaxHandlerAdapter adapter(io_handler);
+   rapidjson::ParseResult result = reader.Parse(stream, adapter);
+
+   // A handler which stops the parse early (by returning false from a callback) is not an error from the caller's
+   // perspective.
+   if (result.IsError() && (result.Code() != rapidjson::kParseErrorTermination))
+   {
+      std::string message = "An error occurred while parsing json. Offset: " + std::to_string(result.Offset());
+      return Error(result.Code(), message, ERROR_LOCATION);
+   }
+
+   return Success();
+}
+
+Error saxParse(const std::string& in_jsonStr, SaxHandler& io_handler)
+{
+   return saxParse(in_jsonStr.c_str(), io_handler);
+}
+
 } // namespace json
 } // namespace core
 } // namespace rstudio
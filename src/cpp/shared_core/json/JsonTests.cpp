@@ -236,6 +236,47 @@ TEST_CASE("Json")
       REQUIRE(innerObj["a"].getString() == "Inner hello");
    }
 
+   SECTION("Can stream parse with a SAX handler")
+   {
+      // collects keys and strings; stops the parse when it sees the "stop" key
+      struct CollectingHandler : json::SaxHandler
+      {
+         bool onKey(const char* in_name, size_t in_length) override
+         {
+            keys.push_back(std::string(in_name, in_length));
+            return keys.back() != "stop";
+         }
+
+         bool onString(const char* in_value, size_t in_length) override
+         {
+            strings.push_back(std::string(in_value, in_length));
+            return true;
+         }
+
+         std::vector<std::string> keys;
+         std::vector<std::string> strings;
+      };
+
+      std::string json = "{\"a\":\"Hello\",\"b\":{\"c\":\"world\"},\"d\":[1,2,3]}";
+
+      CollectingHandler handler;
+      REQUIRE(!json::saxParse(json, handler));
+      REQUIRE(handler.keys == std::vector<std::string>({ "a", "b", "c", "d" }));
+      REQUIRE(handler.strings == std::vector<std::string>({ "Hello", "world" }));
+
+      // a handler which stops the parse early should not report an error
+      std::string stoppable = "{\"a\":\"Hello\",\"stop\":\"here\",\"b\":\"world\"}";
+
+      CollectingHandler stoppingHandler;
+      REQUIRE(!json::saxParse(stoppable, stoppingHandler));
+      REQUIRE(stoppingHandler.keys == std::vector<std::string>({ "a", "stop" }));
+      REQUIRE(stoppingHandler.strings == std::vector<std::string>({ "Hello" }));
+
+      // invalid json should still surface a parse error
+      CollectingHandler errorHandler;
+      REQUIRE(json::saxParse("{\"a\":", errorHandler));
+   }
+
    SECTION("Can nest objects within arrays")
    {
       json::Array array;
@@ -0,0 +1,487 @@
+/*
+ * LoadGenMain.cpp
+ *
+ * Copyright (C) 2022 by RStudio, PBC
+ *
+ * Unless you have received this program directly from RStudio pursuant
+ * to the terms of a commercial license agreement with RStudio, then
+ * this program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ *
+ */
+
+// session JSON-RPC load generator (rserver-loadgen target)
+//
+// drives a configurable number of concurrent virtual users against a
+// running rserver (or directly against an rsession). each user performs
+// client_init, then issues a weighted mix of scripted RPC calls and
+// (optionally) interleaves event polling, recording per-method latency.
+// a percentile report is written to stdout as JSON when the run completes.
+//
+// authentication is injected rather than negotiated: pass a pre-acquired
+// auth cookie via --cookie (or arbitrary headers via --header) captured
+// from a signed-in browser session. this keeps the tool independent of
+// the server's sign-in encryption scheme.
+//
+// script file format (--script), a JSON array of call specs:
+//
+//   [ { "method": "list_files", "params": ["~"], "weight": 5 },
+//     { "method": "console_input", "params": ["1 + 1", "", 0] } ]
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <boost/asio/io_service.hpp>
+#include <boost/bind.hpp>
+#include <boost/enable_shared_from_this.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread.hpp>
+
+#include <shared_core/Error.hpp>
+#include <shared_core/FilePath.hpp>
+#include <shared_core/SafeConvert.hpp>
+#include <shared_core/json/Json.hpp>
+
+#include <core/FileSerializer.hpp>
+#include <core/Log.hpp>
+#include <core/ProgramOptions.hpp>
+#include <core/ProgramStatus.hpp>
+#include <core/StringUtils.hpp>
+#include <core/http/Request.hpp>
+#include <core/http/Response.hpp>
+#include <core/http/TcpIpAsyncClient.hpp>
+#include <core/system/System.hpp>
+
+using namespace rstudio;
+using namespace rstudio::core;
+
+namespace {
+
+// run configuration (parsed once, read-only afterwards)
+struct LoadGenOptions
+{
+   std::string host;
+   std::string port;
+   int concurrency;
+   int requestsPerUser;
+   bool pollEvents;
+   std::string scriptFile;
+   std::string cookie;
+   std::vector<std::string> headers;
+};
+
+LoadGenOptions s_options;
+
+// one entry in the scripted RPC mix
+struct RpcCall
+{
+   RpcCall() : weight(1.0) {}
+   std::string method;
+   json::Array paramsJson;
+   double weight;
+};
+
+std::vector<RpcCall> s_rpcMix;
+
+// latency samples (milliseconds) keyed by method, shared across users
+boost::mutex s_statsMutex;
+std::map<std::string, std::vector<double> > s_latencies;
+std::map<std::string, int> s_errors;
+
+std::chrono::steady_clock::time_point s_runStart;
+
+void recordLatency(const std::string& method, double milliseconds)
+{
+   boost::lock_guard<boost::mutex> lock(s_statsMutex);
+   s_latencies[method].push_back(milliseconds);
+}
+
+void recordError(const std::string& method)
+{
+   boost::lock_guard<boost::mutex> lock(s_statsMutex);
+   s_errors[method]++;
+}
+
+double percentile(const std::vector<double>& sorted, double p)
+{
+   if (sorted.empty())
+      return 0.0;
+   std::size_t index = static_cast<std::size_t>(p * (sorted.size() - 1));
+   return sorted[index];
+}
+
+// a single virtual user: performs client_init, then issues scripted RPC
+// calls (interleaved with event polls when enabled) until its request
+// budget is exhausted. each request uses a fresh connection, matching
+// the worst-case (no keepalive) path through the proxy.
+class VirtualUser : public boost::enable_shared_from_this<VirtualUser>
+{
+public:
+   VirtualUser(boost::asio::io_service& ioService, int index)
+      : ioService_(ioService),
+        clientId_(core::system::generateUuid()),
+        remaining_(s_options.requestsPerUser),
+        lastEventId_(-1),
+        rng_(static_cast<unsigned int>(index + 1)),
+        nextIsEventPoll_(false)
+   {
+   }
+
+   void start()
+   {
+      // client_init establishes the client id with the session before
+      // we start the scripted mix (mirrors what the IDE front end does)
+      sendRpc("client_init", json::Array(), "/rpc/client_init");
+   }
+
+private:
+   void sendRpc(const std::string& method,
+                const json::Array& paramsJson,
+                const std::string& uri)
+   {
+      json::Object bodyJson;
+      bodyJson["method"] = method;
+      bodyJson["params"] = paramsJson;
+      bodyJson["clientId"] = clientId_;
+      bodyJson["clientVersion"] = std::string();
+
+      boost::shared_ptr<http::TcpIpAsyncClient> pClient(
+               new http::TcpIpAsyncClient(ioService_,
+                                          s_options.host,
+                                          s_options.port));
+
+      http::Request& request = pClient->request();
+      request.setMethod("POST");
+      request.setUri(uri);
+      request.setHeader("Connection", "close");
+      request.setHeader("Content-Type", "application/json");
+      request.setHeader("Accept", "application/json");
+      if (!s_options.cookie.empty())
+         request.setHeader("Cookie", s_options.cookie);
+      for (const std::string& header : s_options.headers)
+      {
+         std::size_t colon = header.find(':');
+         if (colon != std::string::npos)
+         {
+            request.setHeader(
+                     header.substr(0, colon),
+                     string_utils::trimWhitespace(header.substr(colon + 1)));
+         }
+      }
+      request.setBody(bodyJson.write());
+
+      std::chrono::steady_clock::time_point started =
+            std::chrono::steady_clock::now();
+
+      pClient->execute(
+            boost::bind(&VirtualUser::onResponse,
+                        shared_from_this(),
+                        method,
+                        started,
+                        _1),
+            boost::bind(&VirtualUser::onError,
+                        shared_from_this(),
+                        method,
+                        _1));
+   }
+
+   void onResponse(const std::string& method,
+                   std::chrono::steady_clock::time_point started,
+                   const http::Response& response)
+   {
+      using namespace std::chrono;
+      double elapsedMs = duration_cast<duration<double, std::milli>>(
+               steady_clock::now() - started).count();
+
+      if (response.statusCode() == http::status::Ok)
+      {
+         recordLatency(method, elapsedMs);
+         if (method == "get_events")
+            updateLastEventId(response.body());
+      }
+      else
+      {
+         recordError(method);
+      }
+
+      continueOrFinish();
+   }
+
+   void onError(const std::string& method, const Error& error)
+   {
+      recordError(method);
+      LOG_ERROR(error);
+      continueOrFinish();
+   }
+
+   void updateLastEventId(const std::string& body)
+   {
+      json::Value responseJson;
+      if (responseJson.parse(body) || !responseJson.isObject())
+         return;
+      json::Object responseObj = responseJson.getObject();
+      json::Object::Iterator it = responseObj.find("result");
+      if (it == responseObj.end() || !(*it).getValue().isArray())
+         return;
+      json::Array eventsJson = (*it).getValue().getArray();
+      for (const json::Value& eventJson : eventsJson)
+      {
+         if (eventJson.isObject())
+         {
+            int id = -1;
+            Error error = json::readObject(eventJson.getObject(), "id", id);
+            if (!error && id > lastEventId_)
+               lastEventId_ = id;
+         }
+      }
+   }
+
+   void continueOrFinish()
+   {
+      // the run ends naturally: once every user's budget is exhausted no
+      // async operations remain and the io_service threads return
+      if (remaining_ <= 0)
+         return;
+      remaining_--;
+
+      // alternate event polls into the mix when enabled (the front end
+      // keeps a poll outstanding continuously; alternating approximates
+      // that ratio without needing a second in-flight connection)
+      if (s_options.pollEvents && nextIsEventPoll_)
+      {
+         nextIsEventPoll_ = false;
+         json::Array paramsJson;
+         paramsJson.push_back(lastEventId_);
+         sendRpc("get_events", paramsJson, "/events/get_events");
+         return;
+      }
+      nextIsEventPoll_ = true;
+
+      const RpcCall& call = pickScriptedCall();
+      sendRpc(call.method, call.paramsJson, "/rpc/" + call.method);
+   }
+
+   const RpcCall& pickScriptedCall()
+   {
+      if (s_rpcMix.size() == 1)
+         return s_rpcMix[0];
+
+      double totalWeight = 0.0;
+      for (const RpcCall& call : s_rpcMix)
+         totalWeight += call.weight;
+
+      std::uniform_real_distribution<double> dist(0.0, totalWeight);
+      double draw = dist(rng_);
+      for (const RpcCall& call : s_rpcMix)
+      {
+         draw -= call.weight;
+         if (draw <= 0.0)
+            return call;
+      }
+      return s_rpcMix.back();
+   }
+
+private:
+   boost::asio::io_service& ioService_;
+   std::string clientId_;
+   int remaining_;
+   int lastEventId_;
+   std::mt19937 rng_;
+   bool nextIsEventPoll_;
+};
+
+Error loadRpcMix(const std::string& scriptFile)
+{
+   if (scriptFile.empty())
+   {
+      // default mix: a cheap metadata RPC (exercises routing + dispatch
+      // without mutating session state)
+      RpcCall call;
+      call.method = "list_files";
+      call.paramsJson.push_back("~");
+      call.paramsJson.push_back(false);
+      s_rpcMix.push_back(call);
+      return Success();
+   }
+
+   std::string contents;
+   Error error = core::readStringFromFile(FilePath(scriptFile), &contents);
+   if (error)
+      return error;
+
+   json::Value scriptJson;
+   error = scriptJson.parse(contents);
+   if (error)
+      return error;
+   if (!scriptJson.isArray())
+      return systemError(boost::system::errc::invalid_argument,
+                         "script file must contain a JSON array",
+                         ERROR_LOCATION);
+
+   for (const json::Value& callJson : scriptJson.getArray())
+   {
+      if (!callJson.isObject())
+         continue;
+
+      RpcCall call;
+      json::Object callObj = callJson.getObject();
+      error = json::readObject(callObj, "method", call.method);
+      if (error)
+         return error;
+
+      json::Object::Iterator it = callObj.find("params");
+      if (it != callObj.end() && (*it).getValue().isArray())
+         call.paramsJson = (*it).getValue().getArray();
+
+      it = callObj.find("weight");
+      if (it != callObj.end() && json::isType<double>((*it).getValue()))
+         call.weight = (*it).getValue().getDouble();
+
+      s_rpcMix.push_back(call);
+   }
+
+   if (s_rpcMix.empty())
+      return systemError(boost::system::errc::invalid_argument,
+                         "script file contains no RPC calls",
+                         ERROR_LOCATION);
+
+   return Success();
+}
+
+json::Object statsAsJson()
+{
+   using namespace std::chrono;
+   double elapsedSeconds = duration_cast<duration<double>>(
+            steady_clock::now() - s_runStart).count();
+
+   boost::lock_guard<boost::mutex> lock(s_statsMutex);
+
+   std::size_t totalRequests = 0;
+   json::Array methodsJson;
+   for (std::map<std::string, std::vector<double> >::iterator
+           it = s_latencies.begin(); it != s_latencies.end(); ++it)
+   {
+      std::vector<double>& samples = it->second;
+      std::sort(samples.begin(), samples.end());
+      totalRequests += samples.size();
+
+      double sum = 0.0;
+      for (double sample : samples)
+         sum += sample;
+
+      json::Object methodJson;
+      methodJson["method"] = it->first;
+      methodJson["count"] = static_cast<int>(samples.size());
+      methodJson["errors"] = s_errors[it->first];
+      methodJson["mean_ms"] = samples.empty() ? 0.0 : sum / samples.size();
+      methodJson["min_ms"] = samples.empty() ? 0.0 : samples.front();
+      methodJson["p50_ms"] = percentile(samples, 0.50);
+      methodJson["p90_ms"] = percentile(samples, 0.90);
+      methodJson["p99_ms"] = percentile(samples, 0.99);
+      methodJson["max_ms"] = samples.empty() ? 0.0 : samples.back();
+      methodsJson.push_back(methodJson);
+   }
+
+   json::Object reportJson;
+   reportJson["host"] = s_options.host;
+   reportJson["port"] = s_options.port;
+   reportJson["concurrency"] = s_options.concurrency;
+   reportJson["elapsed_seconds"] = elapsedSeconds;
+   reportJson["total_requests"] = static_cast<int>(totalRequests);
+   reportJson["requests_per_second"] =
+         elapsedSeconds > 0.0 ? totalRequests / elapsedSeconds : 0.0;
+   reportJson["methods"] = methodsJson;
+   return reportJson;
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv)
+{
+   core::log::setProgramId("rserver-loadgen");
+   core::system::initializeStderrLog("rserver-loadgen",
+                                     core::log::LogLevel::WARN);
+
+   // ignore SIGPIPE (connections dropped under load are expected)
+   Error error = core::system::ignoreSignal(core::system::SigPipe);
+   if (error)
+      LOG_ERROR(error);
+
+   // read command line
+   using namespace boost::program_options;
+   options_description loadgen("loadgen");
+   loadgen.add_options()
+      ("host",
+       value<std::string>(&s_options.host)->default_value("localhost"),
+       "server host")
+      ("port",
+       value<std::string>(&s_options.port)->default_value("8787"),
+       "server port")
+      ("concurrency",
+       value<int>(&s_options.concurrency)->default_value(8),
+       "number of concurrent virtual users")
+      ("requests",
+       value<int>(&s_options.requestsPerUser)->default_value(100),
+       "requests issued per virtual user")
+      ("poll-events",
+       value<bool>(&s_options.pollEvents)->default_value(true),
+       "interleave event polling with the RPC mix")
+      ("script",
+       value<std::string>(&s_options.scriptFile)->default_value(""),
+       "JSON file describing the RPC mix")
+      ("cookie",
+       value<std::string>(&s_options.cookie)->default_value(""),
+       "Cookie header for authenticated requests")
+      ("header",
+       value<std::vector<std::string> >(&s_options.headers),
+       "additional request header (Name: Value), repeatable");
+
+   program_options::OptionsDescription optionsDescription("rserver-loadgen");
+   optionsDescription.commandLine.add(loadgen);
+   ProgramStatus status = program_options::read(optionsDescription,
+                                                argc,
+                                                argv);
+   if (status.exit())
+      return status.exitCode();
+
+   error = loadRpcMix(s_options.scriptFile);
+   if (error)
+   {
+      std::cerr << "error reading script: " << error.getSummary() << std::endl;
+      return EXIT_FAILURE;
+   }
+
+   // launch the virtual users on an io_service thread pool
+   boost::asio::io_service ioService;
+   s_runStart = std::chrono::steady_clock::now();
+
+   std::vector<boost::shared_ptr<VirtualUser> > users;
+   for (int i = 0; i < s_options.concurrency; i++)
+   {
+      boost::shared_ptr<VirtualUser> pUser(new VirtualUser(ioService, i));
+      users.push_back(pUser);
+      pUser->start();
+   }
+
+   int threads = std::min(s_options.concurrency, 8);
+   boost::thread_group threadGroup;
+   for (int i = 0; i < threads; i++)
+   {
+      threadGroup.create_thread(
+               boost::bind(&boost::asio::io_service::run, &ioService));
+   }
+   threadGroup.join_all();
+
+   // emit the latency report
+   std::cout << statsAsJson().writeFormatted() << std::endl;
+
+   return EXIT_SUCCESS;
+}
@@ -0,0 +1,39 @@
+/*
+ * DiffChunk.java
+ *
+ * Copyright (C) 2020 by RStudio, PBC
+ *
+ * Unless you have received this program directly from RStudio pursuant
+ * to the terms of a commercial license agreement with RStudio, then
+ * this program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ *
+ */
+package org.rstudio.core.client.patch;
+
+import com.google.gwt.core.client.JavaScriptObject;
+
+// a single replaced region produced by SubstringDiff: the text at
+// [offset, offset + length) in the original document (offsets in UTF-8
+// bytes) is replaced with the given replacement
+public class DiffChunk extends JavaScriptObject
+{
+   protected DiffChunk()
+   {
+   }
+
+   public final native String getReplacement() /*-{
+      return this.replacement;
+   }-*/;
+
+   public final native int getOffset() /*-{
+      return this.offset;
+   }-*/;
+
+   public final native int getLength() /*-{
+      return this.length;
+   }-*/;
+}
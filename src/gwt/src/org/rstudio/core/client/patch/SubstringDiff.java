@@ -19,6 +19,8 @@ import java.util.ArrayList;
 import org.rstudio.core.client.Debug;
 import org.rstudio.core.client.js.JsObject;
 
+import com.google.gwt.core.client.JsArray;
+
 public class SubstringDiff
 {
    public SubstringDiff(String origVal, String newVal)
@@ -28,37 +30,39 @@ public class SubstringDiff
       try
       {
          JsObject diff = diffImpl(origVal, newVal);
+         chunks_       = diff.getObject("chunks");
          replacement_  = diff.getString("replacement");
          offset_       = diff.getInteger("offset");
          length_       = diff.getInteger("length");
          valid_        = true;
-        
+
       }
       catch (Exception e)
       {
          Debug.logException(e);
-         
+
+         chunks_ = null;
          replacement_ = "";
          offset_ = 0;
          length_ = 0;
          valid_ = false;
       }
    }
-   
-   public TextChange[] asTextChanges() 
+
+   public TextChange[] asTextChanges()
    {
       ArrayList<TextChange> changes = new ArrayList<TextChange>();
       if (valid_)
       {
          if (offset_ > 0)
             changes.add(new TextChange(TextChange.Type.Equal, origVal_.substring(0, offset_)));
-         
+
          if (length_ > 0)
             changes.add(new TextChange(TextChange.Type.Delete, origVal_.substring(offset_, offset_ + length_)));
-         
+
          if (replacement_.length() > 0)
             changes.add(new TextChange(TextChange.Type.Insert, replacement_));
-         
+
          if (offset_ + length_ < origVal_.length())
             changes.add(new TextChange(TextChange.Type.Equal, origVal_.substring(offset_ + length_)));
       }
@@ -69,86 +73,206 @@ public class SubstringDiff
          if (newVal_.length() > 0)
             changes.add(new TextChange(TextChange.Type.Insert, newVal_));
       }
-      return changes.toArray(new TextChange[] {});      
+      return changes.toArray(new TextChange[] {});
    }
 
-   
+   // Computes the set of replaced regions which transform origVal into
+   // newVal, with offsets measured in UTF-8 bytes. The byte-wise common
+   // head and tail are trimmed first (as this diff has always done); the
+   // remaining changed region is then refined by searching for unchanged
+   // anchor blocks with a rolling hash, so scattered edits (e.g. changes
+   // at both the top and bottom of a large file) produce several small
+   // chunks rather than one spanning most of the file. Alongside the
+   // chunks, the single replacement spanning all of them is returned for
+   // callers which need the envelope view (see asTextChanges()).
    private static final native JsObject diffImpl(String origVal, String newVal)
    /*-{
-   
+
       // Convert to UTF-8 byte array.
       var o = new $wnd.TextEncoder("utf-8").encode(origVal);
       var n = new $wnd.TextEncoder("utf-8").encode(newVal);
-      
+      var decoder = new $wnd.TextDecoder();
+
       var olen = o.length;
       var nlen = n.length;
-      
-      // Figure out how many characters at the beginning of the two strings
-      // are identical.
-      var headLimit = Math.min(olen, nlen);
-      var head;
-      for (head = 0;
-           head < headLimit && o[head] === n[head];
-           head++)
+
+      // Refinement bounds: don't try to split regions smaller than a few
+      // anchors, and emit at most this many chunks.
+      var anchorLen = 64;
+      var maxChunks = 8;
+
+      // Collected chunks, in ascending offset order. Each entry keeps its
+      // range in both byte arrays until the result is built.
+      var chunks = [];
+
+      // Search for the anchor n[nPos, nPos + anchorLen) within
+      // o[oStart, oEnd) using a Rabin-Karp rolling hash (arithmetic is
+      // mod 2^32 via Math.imul). Returns the match position, or -1.
+      function findAnchor(oStart, oEnd, nPos)
       {
+         if (oEnd - oStart < anchorLen)
+            return -1;
+
+         var base = 257;
+         var target = 0;
+         var hash = 0;
+         var pow = 1;
+         var i;
+         for (i = 0; i < anchorLen; i++)
+         {
+            target = (Math.imul(target, base) + n[nPos + i]) >>> 0;
+            hash = (Math.imul(hash, base) + o[oStart + i]) >>> 0;
+            if (i > 0)
+               pow = Math.imul(pow, base) >>> 0;
+         }
+
+         for (i = oStart; ; i++)
+         {
+            if (hash === target)
+            {
+               // verify the match (the hash can collide)
+               var match = true;
+               for (var j = 0; j < anchorLen; j++)
+               {
+                  if (o[i + j] !== n[nPos + j])
+                  {
+                     match = false;
+                     break;
+                  }
+               }
+               if (match)
+                  return i;
+            }
+
+            if (i + anchorLen >= oEnd)
+               break;
+
+            hash = ((Math.imul(hash - Math.imul(o[i], pow), base) >>> 0) +
+                    o[i + anchorLen]) >>> 0;
+         }
+
+         return -1;
       }
 
-      // Figure out how many characters at the end of the two strings are
-      // identical, but don't go past the range we established in the above
-      // step (i.e., anything already in the head can't be part of the tail).
-      var tailDelta = nlen - olen;
-      var tailLimit = Math.max(head, head - tailDelta);
-      
-      var tail;
-      for (tail = olen;
-           tail > tailLimit && o[tail - 1] === n[tail + tailDelta - 1];
-           tail--)
+      // Record o[oStart, oEnd) -> n[nStart, nEnd) as a replaced region,
+      // widened so it starts and ends on UTF-8 character boundaries.
+      // UTF-8 continuation bytes match the byte sequence 10xxxxxx; that
+      // is, are values in the range [128, 192). Bytes adjacent to a
+      // chunk are equal in both arrays, so widening both ranges in
+      // lockstep preserves correctness.
+      function emit(oStart, oEnd, nStart, nEnd)
       {
+         while (oStart > 0)
+         {
+            var ch = o[oStart] || 0;
+            if (ch < 128 || ch >= 192)
+               break;
+            oStart--;
+            nStart--;
+         }
+
+         while (oEnd < olen)
+         {
+            var ch = o[oEnd] || 0;
+            if (ch < 128 || ch >= 192)
+               break;
+            oEnd++;
+            nEnd++;
+         }
+
+         chunks.push({
+            "oStart": oStart,
+            "oEnd": oEnd,
+            "nStart": nStart,
+            "nEnd": nEnd
+         });
       }
-      
-      // Early check for case with no diff.
-      if (olen === nlen && head === tail) {
+
+      // Diff o[oStart, oEnd) against n[nStart, nEnd), assuming the
+      // surrounding bytes are equal.
+      function refine(oStart, oEnd, nStart, nEnd, depth)
+      {
+         // trim the common head
+         while (oStart < oEnd && nStart < nEnd && o[oStart] === n[nStart])
+         {
+            oStart++;
+            nStart++;
+         }
+
+         // trim the common tail
+         while (oEnd > oStart && nEnd > nStart && o[oEnd - 1] === n[nEnd - 1])
+         {
+            oEnd--;
+            nEnd--;
+         }
+
+         // identical regions contribute nothing
+         if (oStart === oEnd && nStart === nEnd)
+            return;
+
+         // attempt to split on an unchanged anchor taken from the middle
+         // of the new region
+         if (depth > 0 &&
+             chunks.length < maxChunks - 1 &&
+             oEnd - oStart >= anchorLen * 4 &&
+             nEnd - nStart >= anchorLen * 4)
+         {
+            var mid = nStart + ((nEnd - nStart) >> 1);
+            var pos = findAnchor(oStart, oEnd, mid);
+            if (pos >= 0)
+            {
+               refine(oStart, pos, nStart, mid, depth - 1);
+               refine(pos + anchorLen, oEnd, mid + anchorLen, nEnd, depth - 1);
+               return;
+            }
+         }
+
+         emit(oStart, oEnd, nStart, nEnd);
+      }
+
+      refine(0, olen, 0, nlen, 6);
+
+      // early return for the case with no diff
+      if (chunks.length === 0)
+      {
          return {
+            "chunks": [],
             "replacement": "",
             "offset": 0,
             "length": 0
-         }
+         };
       }
-      
-      // Move head and tail to ensure we align on starts of UTF-8 characters.
-      // UTF-8 continuation bytes match the byte sequence 10xxxxxx;
-      // that is, are values in the range [128, 192). So we want to ensure
-      // head + tail land on bytes not containing those values.
-      while (head > 0)
-      {
-         var ch = o[head] || 0;
-         if (ch < 128 || ch >= 192)
-            break;
-         head--;
-      }
-      
-      while (tail < olen)
+
+      var result = [];
+      for (var i = 0; i < chunks.length; i++)
       {
-         var ch = o[tail] || 0;
-         if (ch < 128 || ch >= 192)
-            break;
-         tail++;
+         var chunk = chunks[i];
+         result.push({
+            "replacement": decoder.decode(n.subarray(chunk.nStart, chunk.nEnd)),
+            "offset": chunk.oStart,
+            "length": chunk.oEnd - chunk.oStart
+         });
       }
-      
-      // Extract the modified slice of data, and decode it back to a string.
-      // NOTE: Internet Explorer does not support slice on Uint8Array objects.
-      var slice = n.subarray(head, tail + tailDelta);
-      var replacement = new $wnd.TextDecoder().decode(slice);
-      
+
+      // envelope spanning all chunks (the single-range view of the diff)
+      var first = chunks[0];
+      var last = chunks[chunks.length - 1];
+
       return {
-         "replacement": replacement,
-         "offset": head,
-         "length": tail - head
+         "chunks": result,
+         "replacement": decoder.decode(n.subarray(first.nStart, last.nEnd)),
+         "offset": first.oStart,
+         "length": last.oEnd - first.oStart
       };
-      
-   
+
+
    }-*/;
 
+   public JsArray<DiffChunk> getChunks()
+   {
+      return chunks_;
+   }
+
    public String getReplacement()
    {
       return replacement_;
@@ -163,12 +287,12 @@ public class SubstringDiff
    {
       return length_;
    }
-   
+
    public boolean isEmpty()
    {
       return length_ == 0 && replacement_.length() == 0;
    }
-   
+
    public boolean isValid()
    {
       return valid_;
@@ -177,6 +301,7 @@ public class SubstringDiff
    private final String origVal_;
    private final String newVal_;
 
+   private JsArray<DiffChunk> chunks_;
    private int offset_;
    private int length_;
    private String replacement_;
@@ -139,7 +139,9 @@ import org.rstudio.studio.client.workbench.views.environment.model.EnvironmentCo
 import org.rstudio.studio.client.workbench.views.environment.model.RObject;
 import org.rstudio.studio.client.workbench.views.files.events.DirectoryNavigateEvent;
 import org.rstudio.studio.client.workbench.views.files.events.FileChangeEvent;
+import org.rstudio.studio.client.workbench.views.files.events.FileChangesetEvent;
 import org.rstudio.studio.client.workbench.views.files.model.FileChange;
+import org.rstudio.studio.client.workbench.views.files.model.FileChangeset;
 import org.rstudio.studio.client.workbench.views.help.events.ShowHelpEvent;
 import org.rstudio.studio.client.workbench.views.history.events.HistoryEntriesAddedEvent;
 import org.rstudio.studio.client.workbench.views.history.model.HistoryEntry;
@@ -285,6 +287,11 @@ public class ClientEventDispatcher
             FileChange fileChange = event.getData();
             eventBus_.dispatchEvent(new FileChangeEvent(fileChange));
          }
+         else if (type == ClientEvent.FileChangeset)
+         {
+            FileChangeset changeset = event.getData();
+            eventBus_.dispatchEvent(new FileChangesetEvent(changeset));
+         }
          else if (type == ClientEvent.WorkingDirChanged)
          {
             String path = event.getData();
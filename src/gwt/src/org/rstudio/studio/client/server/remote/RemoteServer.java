@@ -38,6 +38,7 @@ import org.rstudio.core.client.jsonrpc.RpcRequest;
 import org.rstudio.core.client.jsonrpc.RpcRequestCallback;
 import org.rstudio.core.client.jsonrpc.RpcResponse;
 import org.rstudio.core.client.jsonrpc.RpcResponseHandler;
+import org.rstudio.core.client.patch.DiffChunk;
 import org.rstudio.studio.client.application.ApplicationTutorialEvent;
 import org.rstudio.studio.client.application.Desktop;
 import org.rstudio.studio.client.application.events.*;
@@ -2118,9 +2119,7 @@ public class RemoteServer implements Server
                                 String encoding,
                                 String foldSpec,
                                 JsArray<ChunkDefinition> chunkDefs,
-                                String replacement,
-                                int offset,
-                                int length,
+                                JsArray<DiffChunk> chunks,
                                 boolean valid,
                                 String hash,
                                 ServerRequestCallback<String> requestCallback)
@@ -2134,11 +2133,9 @@ public class RemoteServer implements Server
       params.set(3, encoding == null ? JSONNull.getInstance() : new JSONString(encoding));
       params.set(4, new JSONString(StringUtil.notNull(foldSpec)));
       params.set(5, chunkDefs == null ? JSONNull.getInstance() : new JSONObject(chunkDefs));
-      params.set(6, new JSONString(replacement));
-      params.set(7, new JSONNumber(offset));
-      params.set(8, new JSONNumber(length));
-      params.set(9, JSONBoolean.getInstance(valid));
-      params.set(10, new JSONString(hash));
+      params.set(6, chunks == null ? JSONNull.getInstance() : new JSONArray(chunks));
+      params.set(7, JSONBoolean.getInstance(valid));
+      params.set(8, new JSONString(hash));
       sendRequest(RPC_SCOPE, SAVE_DOCUMENT_DIFF, params, requestCallback);
    }
 
@@ -3016,6 +3013,9 @@ public class RemoteServer implements Server
 
       JSONArray params = new JSONArray();
       params.set(0, new JSONNumber(lastEventId));
+      // advertise the longest long-poll hold we support; idle sessions
+      // extend their hold toward this so they cycle connections less often
+      params.set(1, new JSONNumber(MAX_EVENTS_WAIT_SECONDS));
       return sendRequest(EVENTS_SCOPE,
                          "get_events",
                          params,
@@ -6317,6 +6317,10 @@ public class RemoteServer implements Server
    private static final String FILE_SHOW = "file_show";
    protected static final String JOB_LAUNCHER_RPC_SCOPE = "job_launcher_rpc";
 
+   // longest get_events long-poll hold we support (the server extends
+   // idle-session holds toward this)
+   private static final int MAX_EVENTS_WAIT_SECONDS = 600;
+
    // session methods
    private static final String CLIENT_INIT = "client_init";
    private static final String SUSPEND_SESSION = "suspend_session";
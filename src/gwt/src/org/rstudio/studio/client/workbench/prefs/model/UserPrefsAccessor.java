@@ -1922,6 +1922,18 @@ public class UserPrefsAccessor extends Prefs
          false);
    }
 
+   /**
+    * Whether to cache chunk output across R Markdown preview renders so that unchanged chunks are not re-executed.
+    */
+   public PrefValue<Boolean> rmdPreviewRenderCache()
+   {
+      return bool(
+         "rmd_preview_render_cache",
+         "Cache chunk output across R Markdown previews", 
+         "Whether to cache chunk output across R Markdown preview renders so that unchanged chunks are not re-executed.", 
+         false);
+   }
+
    /**
     * Whether to enable moving text on the editing surface by clicking and dragging it.
     */
@@ -3227,6 +3239,8 @@ public class UserPrefsAccessor extends Prefs
          terminalRenderer().setValue(layer, source.getString("terminal_renderer"));
       if (source.hasKey("show_rmd_render_command"))
          showRmdRenderCommand().setValue(layer, source.getBool("show_rmd_render_command"));
+      if (source.hasKey("rmd_preview_render_cache"))
+         rmdPreviewRenderCache().setValue(layer, source.getBool("rmd_preview_render_cache"));
       if (source.hasKey("enable_text_drag"))
          enableTextDrag().setValue(layer, source.getBool("enable_text_drag"));
       if (source.hasKey("show_hidden_files"))
@@ -3508,6 +3522,7 @@ public class UserPrefsAccessor extends Prefs
       prefs.add(terminalBellStyle());
       prefs.add(terminalRenderer());
       prefs.add(showRmdRenderCommand());
+      prefs.add(rmdPreviewRenderCache());
       prefs.add(enableTextDrag());
       prefs.add(showHiddenFiles());
       prefs.add(sortFileNamesNaturally());
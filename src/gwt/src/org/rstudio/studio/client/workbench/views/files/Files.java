@@ -56,6 +56,7 @@ import org.rstudio.studio.client.workbench.views.environment.dataimport.DataImpo
 import org.rstudio.studio.client.workbench.views.files.events.*;
 import org.rstudio.studio.client.workbench.views.files.model.DirectoryListing;
 import org.rstudio.studio.client.workbench.views.files.model.FileChange;
+import org.rstudio.studio.client.workbench.views.files.model.FileChangeset;
 import org.rstudio.studio.client.workbench.views.files.model.FilesServerOperations;
 import org.rstudio.studio.client.workbench.views.files.model.PendingFileUpload;
 import org.rstudio.studio.client.workbench.views.source.events.SourcePathChangedEvent;
@@ -65,7 +66,8 @@ import java.util.ArrayList;
 
 public class Files
       extends BasePresenter
-      implements FileChangeHandler, 
+      implements FileChangeHandler,
+                 FileChangesetHandler,
                  OpenFileInBrowserHandler,
                  DirectoryNavigateHandler,
                  RenameSourceFileEvent.Handler
@@ -174,6 +176,7 @@ public class Files
 
       
       eventBus_.addHandler(FileChangeEvent.TYPE, this);
+      eventBus_.addHandler(FileChangesetEvent.TYPE, this);
       eventBus_.addHandler(RenameSourceFileEvent.TYPE, this);
 
       initSession();
@@ -616,6 +619,37 @@ public class Files
       view_.updateDirectoryListing(event.getFileChange());
    }
 
+   public void onFileChangeset(FileChangesetEvent event)
+   {
+      FileChangeset changeset = event.getChangeset();
+
+      // stale changesets for a directory we've already navigated away from
+      if (!changeset.getDirectory().equals(currentPath_.getPath()))
+         return;
+
+      if (changeset.getGeneration() <= listingGeneration_)
+      {
+         // already reflected in the listing we fetched
+         return;
+      }
+      else if (listingGeneration_ >= 0 &&
+               changeset.getGeneration() == listingGeneration_ + 1)
+      {
+         // next consecutive changeset -- apply the deltas in order
+         listingGeneration_ = changeset.getGeneration();
+         JsArray<FileChange> changes = changeset.getChanges();
+         for (int i = 0; i < changes.length(); i++)
+            view_.updateDirectoryListing(changes.get(i));
+      }
+      else
+      {
+         // we missed a changeset (or never saw the base listing) --
+         // resync with a full re-listing
+         listingGeneration_ = -1;
+         view_.listDirectory(currentPath_, currentPathFilesDS_);
+      }
+   }
+
    public void onOpenFileInBrowser(OpenFileInBrowserEvent event)
    {
       showFileInBrowser(event.getFile());
@@ -795,13 +829,30 @@ public class Files
       new ServerDataSource<DirectoryListing>()
       {
          public void requestData(
-               ServerRequestCallback<DirectoryListing> requestCallback)
+               final ServerRequestCallback<DirectoryListing> requestCallback)
          {
-            
-            server_.listFiles(currentPath_, 
+
+            server_.listFiles(currentPath_,
                   true, // pass true to enable monitoring for all calls to list_files
                   pPrefs_.get().showHiddenFiles().getValue(), // respect user pref for showing hidden
-                  requestCallback);
+                  new ServerRequestCallback<DirectoryListing>()
+                  {
+                     @Override
+                     public void onResponseReceived(DirectoryListing listing)
+                     {
+                        // record the generation of this listing so changeset
+                        // events can be reconciled against it
+                        listingGeneration_ = listing.getGeneration();
+                        requestCallback.onResponseReceived(listing);
+                     }
+
+                     @Override
+                     public void onError(ServerError error)
+                     {
+                        listingGeneration_ = -1;
+                        requestCallback.onError(error);
+                     }
+                  });
          }
       };
 
@@ -816,6 +867,7 @@ public class Files
    private final Session session_;
    private FileSystemItem currentPath_ = FileSystemItem.home();
    private boolean hasNavigatedToDirectory_ = false;
+   private int listingGeneration_ = -1;
    private final Provider<FilesCopy> pFilesCopy_;
    private final Provider<FilesUpload> pFilesUpload_;
    private final Provider<FileExport> pFileExport_;
@@ -0,0 +1,48 @@
+/*
+ * FileChangesetEvent.java
+ *
+ * Copyright (C) 2020 by RStudio, PBC
+ *
+ * Unless you have received this program directly from RStudio pursuant
+ * to the terms of a commercial license agreement with RStudio, then
+ * this program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ *
+ */
+package org.rstudio.studio.client.workbench.views.files.events;
+
+import com.google.gwt.event.shared.GwtEvent;
+import org.rstudio.studio.client.workbench.views.files.model.FileChangeset;
+
+public class FileChangesetEvent extends GwtEvent<FileChangesetHandler>
+{
+   public static final GwtEvent.Type<FileChangesetHandler> TYPE =
+      new GwtEvent.Type<FileChangesetHandler>();
+
+   public FileChangesetEvent(FileChangeset changeset)
+   {
+      changeset_ = changeset;
+   }
+
+   public FileChangeset getChangeset()
+   {
+      return changeset_;
+   }
+
+   @Override
+   protected void dispatch(FileChangesetHandler handler)
+   {
+      handler.onFileChangeset(this);
+   }
+
+   @Override
+   public GwtEvent.Type<FileChangesetHandler> getAssociatedType()
+   {
+      return TYPE;
+   }
+
+   private final FileChangeset changeset_;
+}
@@ -32,4 +32,10 @@ public class DirectoryListing extends JavaScriptObject
    public final native JsArray<FileSystemItem> getFiles() /*-{
       return this.files;
    }-*/;
+
+   // listing generation for changeset reconciliation (-1 when the
+   // listing isn't monitored and no changeset events will be sent)
+   public final native int getGeneration() /*-{
+      return this.generation;
+   }-*/;
 }
@@ -0,0 +1,40 @@
+/*
+ * FileChangeset.java
+ *
+ * Copyright (C) 2020 by RStudio, PBC
+ *
+ * Unless you have received this program directly from RStudio pursuant
+ * to the terms of a commercial license agreement with RStudio, then
+ * this program is licensed to you under the terms of version 3 of the
+ * GNU Affero General Public License. This program is distributed WITHOUT
+ * ANY EXPRESS OR IMPLIED WARRANTY, INCLUDING THOSE OF NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE. Please refer to the
+ * AGPL (http://www.gnu.org/licenses/agpl-3.0.txt) for more details.
+ *
+ */
+package org.rstudio.studio.client.workbench.views.files.model;
+
+import com.google.gwt.core.client.JavaScriptObject;
+import com.google.gwt.core.client.JsArray;
+
+// a batch of file changes for a monitored directory, stamped with the
+// listing generation it produces (generations are consecutive, so a gap
+// indicates a missed changeset and the listing must be refreshed)
+public class FileChangeset extends JavaScriptObject
+{
+   protected FileChangeset()
+   {
+   }
+
+   public final native String getDirectory() /*-{
+      return this.directory;
+   }-*/;
+
+   public final native int getGeneration() /*-{
+      return this.generation;
+   }-*/;
+
+   public final native JsArray<FileChange> getChanges() /*-{
+      return this.changes;
+   }-*/;
+}
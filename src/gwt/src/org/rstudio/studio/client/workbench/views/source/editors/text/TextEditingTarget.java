@@ -2573,6 +2573,11 @@ public class TextEditingTarget implements
       if (notebook_ != null)
          notebook_.onActivate();
 
+      // fetch contents the server deferred at client init (no-op in the
+      // common case where they were delivered inline)
+      if (docUpdateSentinel_ != null)
+         docUpdateSentinel_.fetchDeferredContents();
+
       view_.onActivate();
    }
 
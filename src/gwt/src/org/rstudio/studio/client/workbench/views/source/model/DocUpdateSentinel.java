@@ -512,9 +512,7 @@ public class DocUpdateSentinel
             encoding,
             foldSpec,
             newChunkDefs,
-            diff.getReplacement(),
-            diff.getOffset(),
-            diff.getLength(),
+            diff.getChunks(),
             diff.isValid(),
             hash,
             new ServerRequestCallback<String>()
@@ -874,6 +872,56 @@ public class DocUpdateSentinel
             new ReopenFileCallback());
    }
 
+   // fetch contents the server deferred at client init (no-op once they
+   // have been delivered)
+   public void fetchDeferredContents()
+   {
+      if (!sourceDoc_.isContentsDeferred() || fetchingDeferredContents_)
+         return;
+
+      // hold the buffer read-only while the fetch is in flight --
+      // keystrokes accepted now would be silently replaced when the
+      // contents arrive
+      fetchingDeferredContents_ = true;
+      docDisplay_.setReadOnly(true);
+
+      server_.getSourceDocument(
+            sourceDoc_.getId(),
+            new ServerRequestCallback<SourceDocument>()
+            {
+               @Override
+               public void onResponseReceived(SourceDocument response)
+               {
+                  fetchingDeferredContents_ = false;
+                  docDisplay_.setReadOnly(false);
+
+                  // defense in depth: if edits slipped in anyway (e.g.
+                  // something else toggled the read-only state while we
+                  // were in flight), never discard the user's changes
+                  if (dirtyState_.getValue())
+                  {
+                     Debug.logWarning("Dropped deferred contents for " +
+                                      "dirty document " + sourceDoc_.getId());
+                     return;
+                  }
+
+                  sourceDoc_ = response;
+                  docDisplay_.setCode(sourceDoc_.getContents(), true);
+                  dirtyState_.markClean();
+               }
+
+               @Override
+               public void onError(ServerError error)
+               {
+                  // restore editability; the fetch is retried on the
+                  // next activation
+                  fetchingDeferredContents_ = false;
+                  docDisplay_.setReadOnly(false);
+                  Debug.logError(error);
+               }
+            });
+   }
+
    public void ignoreExternalEdit()
    {
       // Warning: This leaves the sourceDoc_ with a stale LastModifiedDate
@@ -932,6 +980,7 @@ public class DocUpdateSentinel
    private final HashMap<String, ValueChangeHandlerManager<String>>
                  propertyChangeHandlers_;
    private boolean loggedAutosaveError_ = false;
+   private boolean fetchingDeferredContents_ = false;
 
    public final static String PROPERTY_TRUE = "true";
    public final static String PROPERTY_FALSE = "false";
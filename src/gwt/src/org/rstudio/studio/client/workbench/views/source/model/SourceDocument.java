@@ -79,6 +79,15 @@ public class SourceDocument extends JavaScriptObject
       this.contents = contents;
    }-*/;
 
+   /**
+    * True if the server omitted the contents from this document (large
+    * clean documents at client init); they can be fetched on demand with
+    * getSourceDocument.
+    */
+   public native final boolean isContentsDeferred() /*-{
+      return this.contents_deferred ? true : false;
+   }-*/;
+
    /**
     * True if changes have been saved to the ID that have not been persisted
     * to the file.
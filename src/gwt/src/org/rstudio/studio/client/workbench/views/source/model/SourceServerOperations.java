@@ -18,6 +18,7 @@ import com.google.gwt.core.client.JsArray;
 import com.google.gwt.core.client.JsArrayString;
 
 import org.rstudio.core.client.js.JsObject;
+import org.rstudio.core.client.patch.DiffChunk;
 import org.rstudio.studio.client.common.codetools.CodeToolsServerOperations;
 import org.rstudio.studio.client.common.crypto.CryptoServerOperations;
 import org.rstudio.studio.client.events.GetEditorContextEvent;
@@ -120,9 +121,7 @@ public interface SourceServerOperations extends FilesServerOperations,
                          String encoding,
                          String foldSpec,
                          JsArray<ChunkDefinition> chunkOutput,
-                         String replacement,
-                         int offset,
-                         int length,
+                         JsArray<DiffChunk> chunks,
                          boolean valid,
                          String hash,
                          ServerRequestCallback<String> requestCallback);